@@ -0,0 +1,88 @@
+/**
+ * \file vcblockchain/arena_allocator.h
+ *
+ * \brief Arena allocator for decoding multi-field messages.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_ARENA_ALLOCATOR_HEADER_GUARD
+#define VCBLOCKCHAIN_ARENA_ALLOCATOR_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/error_codes.h>
+#include <vpr/allocator.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The alignment of every arena allocation.
+ */
+#define ARENA_ALLOCATOR_ALIGNMENT 16
+
+/**
+ * \brief The minimum size of a block allocated from the backing allocator.
+ */
+#define ARENA_ALLOCATOR_MIN_BLOCK_SIZE 4096
+
+/**
+ * \brief allocator_control() key which resets the arena, as
+ * \ref arena_allocator_reset() does.  The value is ignored.
+ */
+#define ARENA_ALLOCATOR_CONTROL_KEY_RESET 0x00000001
+
+/**
+ * \brief Initialize an arena allocator.
+ *
+ * An arena serves allocations by bumping a pointer through a region, so an
+ * allocation costs a few instructions, and \ref release() is free.  Everything
+ * allocated from the arena is freed at once by \ref arena_allocator_reset(),
+ * typically after each decoded message, so error paths can't leak.  When the
+ * region fills, the arena grows by chaining blocks from the backing allocator.
+ *
+ * The region may be supplied by the caller, for instance a buffer embedded in
+ * a connection.  Otherwise, the arena keeps its largest block across resets,
+ * so a long-lived arena settles on a region big enough for its messages and
+ * stops calling the backing allocator.
+ *
+ * Releasing or reallocating the most recent allocation reclaims or grows it in
+ * place.  An arena is not thread-safe.  This instance is disposable and must
+ * be disposed by calling \ref dispose() when no longer needed, which frees
+ * every allocation.
+ *
+ * \param options           The allocator options to initialize.
+ * \param backing           The allocator for the arena's context and blocks.
+ * \param region            Optional caller-owned region, or NULL.
+ * \param region_size       The size of the region.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int arena_allocator_options_init(
+    allocator_options_t* options, allocator_options_t* backing, void* region,
+    size_t region_size);
+
+/**
+ * \brief Free every allocation made from an arena at once.
+ *
+ * \param options           The arena's allocator options.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int arena_allocator_reset(allocator_options_t* options);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_ARENA_ALLOCATOR_HEADER_GUARD*/
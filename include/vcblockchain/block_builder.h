@@ -0,0 +1,163 @@
+/**
+ * \file vcblockchain/block_builder.h
+ *
+ * \brief Block assembly with a single pre-sized buffer and streaming hash.
+ *
+ * The sizes of the transactions going into a block are known before it is
+ * assembled, so the builder reserves the exact size of the finished block
+ * up front, and appends each transaction certificate in place.  The block
+ * hash is updated as each field is written, so emitting the block only
+ * finalizes the hash, rather than hashing the whole block again.
+ *
+ * The block hash covers every byte before the signature field.  The
+ * signature itself covers the same bytes, as vccert requires, so signing
+ * still reads the whole block once.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_BLOCK_BUILDER_HEADER_GUARD
+#define VCBLOCKCHAIN_BLOCK_BUILDER_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vccrypt/suite.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/merkle_tree.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The size of a block or signer id.
+ */
+#define BLOCK_BUILDER_ID_SIZE 16
+
+/**
+ * \brief The largest certificate that fits in a short field.
+ */
+#define BLOCK_BUILDER_MAX_TRANSACTION_SIZE 0xFFFF
+
+/**
+ * \brief The certificate version written to each block.
+ */
+#define BLOCK_BUILDER_CERTIFICATE_VERSION 0x00010000
+
+/**
+ * \brief A block builder.
+ */
+typedef struct block_builder
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccrypt_suite_options_t* suite;
+    merkle_tree* tree;
+
+    /** \brief the block, sized exactly when the builder is initialized. */
+    uint8_t* buffer;
+    size_t capacity;
+    size_t offset;
+
+    /** \brief the space left for transactions, and how many may be added. */
+    size_t transaction_space;
+    size_t transactions_left;
+
+    /** \brief the running hash of every field written so far. */
+    vccrypt_hash_context_t hash;
+    uint8_t emitted;
+} block_builder;
+
+/**
+ * \brief Initialize a block builder, reserving room for the given
+ * transactions.
+ *
+ * The block header fields are written immediately: the certificate version,
+ * crypto suite and certificate type that every block certificate carries,
+ * followed by the block id, previous block id and height.  If a Merkle tree
+ * is given, each transaction is appended to it as it is added, and its root
+ * is written to the block, as a MERKLE_TREE_FIELD_TYPE_ROOT field just before
+ * the signer id, when the block is emitted.  This instance is disposable and
+ * must be disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param builder           The builder to initialize.
+ * \param alloc_opts        The allocator to use for this builder.
+ * \param suite             The crypto suite for the block hash and signature.
+ * \param block_id          The id of the new block.
+ * \param prev_block_id     The id of the previous block.
+ * \param height            The height of the new block.
+ * \param txn_sizes         The sizes of the transactions to be added.
+ * \param txn_count         The number of transactions to be added.
+ * \param tree              An empty Merkle tree on the same suite, which must
+ *                          outlive the builder, or NULL.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        a transaction is larger than BLOCK_BUILDER_MAX_TRANSACTION_SIZE, or
+ *        the Merkle tree is not empty.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_builder_init(
+    block_builder* builder, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, const uint8_t* block_id,
+    const uint8_t* prev_block_id, uint64_t height, const size_t* txn_sizes,
+    size_t txn_count, merkle_tree* tree);
+
+/**
+ * \brief Append a transaction certificate to the block.
+ *
+ * \param builder           The builder.
+ * \param txn               The transaction certificate.
+ * \param size              The size of the transaction certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_CAPACITY if the transaction does not
+ *        fit in the space reserved for transactions.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED if the block has already
+ *        been emitted.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash or Merkle tree could not
+ *        be updated.
+ */
+int block_builder_add_transaction(
+    block_builder* builder, const void* txn, size_t size);
+
+/**
+ * \brief Sign the block and emit it.
+ *
+ * The block remains owned by the builder, and is valid until the builder is
+ * disposed.
+ *
+ * \param builder           The builder.
+ * \param signer_id         The id of the signer.
+ * \param private_key       The signing key of the signer.
+ * \param block_hash        Buffer of the suite's hash size to receive the
+ *                          block hash.
+ * \param block             Pointer to receive the block.
+ * \param size              Pointer to receive the size of the block.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED if the block has already
+ *        been emitted.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error, or the hash or signature failed.
+ */
+int block_builder_emit(
+    block_builder* builder, const uint8_t* signer_id,
+    const vccrypt_buffer_t* private_key, uint8_t* block_hash,
+    const uint8_t** block, size_t* size);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_BLOCK_BUILDER_HEADER_GUARD*/
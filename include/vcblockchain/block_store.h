@@ -0,0 +1,457 @@
+/**
+ * \file vcblockchain/block_store.h
+ *
+ * \brief Persistent block and transaction store on LMDB.
+ *
+ * The store keeps five tables: blocks by block id, block ids by height,
+ * transactions by transaction id, the latest transaction id by artifact id,
+ * and every transaction id by artifact id and sequence.  Heights and
+ * sequences are stored big-endian, so keys sort numerically; blocks arriving
+ * in height order are appended to the end of the height table rather than
+ * inserted, and an artifact's history is one contiguous range of keys.
+ *
+ * Writes are made in batches.  Batches written at the same time from several
+ * threads are committed together, in one LMDB write transaction, by whichever
+ * writer gets there first; the others wait for that commit rather than making
+ * their own.  This keeps the number of commits, and so of syncs, down to what
+ * the disk can keep up with.
+ *
+ * Each thread reading from the store keeps one read transaction, which is
+ * reset after each read and renewed for the next, instead of beginning and
+ * ending a transaction per read.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_BLOCK_STORE_HEADER_GUARD
+#define VCBLOCKCHAIN_BLOCK_STORE_HEADER_GUARD
+
+#include <lmdb.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vccrypt/buffer.h>
+#include <vcblockchain/error_codes.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The size of a block, transaction, or artifact id.
+ */
+#define BLOCK_STORE_ID_SIZE 16
+
+/**
+ * \brief The map size used when none is given.
+ */
+#define BLOCK_STORE_DEFAULT_MAP_SIZE ((size_t)1 << 30)
+
+/**
+ * \brief The initial number of records a batch has room for.
+ */
+#define BLOCK_STORE_BATCH_INITIAL_CAPACITY 64
+
+/**
+ * \brief Opaque per-thread reader type.
+ */
+typedef struct block_store_reader block_store_reader;
+
+/**
+ * \brief Opaque queued write type.
+ */
+typedef struct block_store_commit block_store_commit;
+
+/**
+ * \brief A block store.
+ */
+typedef struct block_store
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    MDB_env* env;
+    MDB_dbi block_db;
+    MDB_dbi height_db;
+    MDB_dbi transaction_db;
+    MDB_dbi artifact_db;
+    MDB_dbi history_db;
+
+    /** \brief every thread's read transaction, so dispose can end them. */
+    pthread_key_t reader_key;
+    pthread_mutex_t reader_lock;
+    block_store_reader* readers;
+
+    /** \brief writers queue here; the first to arrive commits the queue. */
+    pthread_mutex_t write_lock;
+    pthread_cond_t written;
+    block_store_commit* queue_head;
+    block_store_commit* queue_tail;
+    uint8_t committing;
+
+    /** \brief the number of write transactions committed. */
+    size_t commits;
+} block_store;
+
+/**
+ * \brief A batch record holding a block.
+ */
+#define BLOCK_STORE_RECORD_BLOCK 0
+
+/**
+ * \brief A batch record holding a transaction.
+ */
+#define BLOCK_STORE_RECORD_TRANSACTION 1
+
+/**
+ * \brief A record to be written.  The record refers to the caller's data,
+ * rather than copying it.
+ */
+typedef struct block_store_record
+{
+    uint8_t type;
+    const uint8_t* id;
+    const uint8_t* artifact_id;
+    uint64_t height;
+    const void* data;
+    size_t size;
+} block_store_record;
+
+/**
+ * \brief A batch of blocks and transactions to write together.
+ */
+typedef struct block_store_batch
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    block_store_record* records;
+    size_t count;
+    size_t capacity;
+} block_store_batch;
+
+/**
+ * \brief Open a block store, creating it if it does not exist.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed.  No thread may be using the store when it is
+ * disposed, and no thread which has read from the store may exit while it is
+ * being disposed: each such thread must either have been joined already, or
+ * keep running until dispose returns.  A thread which exits first releases
+ * its own read transaction; dispose releases the rest.
+ *
+ * \param store         The store to initialize.
+ * \param alloc_opts    The allocator to use for this store.
+ * \param path          The directory holding the database.
+ * \param map_size      The largest size the database may grow to; 0 selects
+ *                      BLOCK_STORE_DEFAULT_MAP_SIZE.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the database could not be
+ *        opened.
+ */
+int block_store_init(
+    block_store* store, allocator_options_t* alloc_opts, const char* path,
+    size_t map_size);
+
+/**
+ * \brief Initialize an empty batch.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed.
+ *
+ * \param batch         The batch to initialize.
+ * \param alloc_opts    The allocator to use for this batch.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int block_store_batch_init(
+    block_store_batch* batch, allocator_options_t* alloc_opts);
+
+/**
+ * \brief Add a block to a batch.
+ *
+ * The id and block must remain valid until the batch is written or cleared.
+ *
+ * \param batch         The batch.
+ * \param block_id      The id of the block.
+ * \param height        The height of the block.
+ * \param block         The block certificate.
+ * \param size          The size of the block certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_batch_add_block(
+    block_store_batch* batch, const uint8_t* block_id, uint64_t height,
+    const void* block, size_t size);
+
+/**
+ * \brief Add a transaction to a batch, making it the latest transaction for
+ * its artifact, and appending it to the artifact's history.
+ *
+ * The ids and transaction must remain valid until the batch is written or
+ * cleared.
+ *
+ * \param batch         The batch.
+ * \param txn_id        The id of the transaction.
+ * \param artifact_id   The id of the artifact the transaction changes.
+ * \param txn           The transaction certificate.
+ * \param size          The size of the transaction certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_batch_add_transaction(
+    block_store_batch* batch, const uint8_t* txn_id,
+    const uint8_t* artifact_id, const void* txn, size_t size);
+
+/**
+ * \brief Remove every record from a batch, keeping its space for reuse.
+ *
+ * \param batch         The batch.
+ */
+void block_store_batch_clear(block_store_batch* batch);
+
+/**
+ * \brief Write a batch to the store, returning once it is committed.
+ *
+ * Records are written in batch order, and batches committed together are
+ * written in the order they arrived.  A record replaces any record already
+ * stored under its key.  If a group's transaction fails, each of its batches
+ * is retried in a transaction of its own, so a batch only fails if it fails
+ * alone, and a batch which fails writes none of its records.
+ *
+ * \param store         The store.
+ * \param batch         The batch.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the write failed.
+ */
+int block_store_write(block_store* store, const block_store_batch* batch);
+
+/**
+ * \brief Read a block by id.
+ *
+ * \param store         The store.
+ * \param block_id      The id of the block.
+ * \param block         Buffer to initialize with a copy of the block, which
+ *                      the caller must dispose.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such block.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_get_block(
+    block_store* store, const uint8_t* block_id, vccrypt_buffer_t* block);
+
+/**
+ * \brief Read the id of the block at a height.
+ *
+ * \param store         The store.
+ * \param height        The height.
+ * \param block_id      Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no block at the
+ *        height.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_block_id(
+    block_store* store, uint64_t height, uint8_t* block_id);
+
+/**
+ * \brief Read the greatest height with a block.
+ *
+ * \param store         The store.
+ * \param height        Pointer to receive the height.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the store has no blocks.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_max_height(block_store* store, uint64_t* height);
+
+/**
+ * \brief Read a transaction by id.
+ *
+ * \param store         The store.
+ * \param txn_id        The id of the transaction.
+ * \param txn           Buffer to initialize with a copy of the transaction,
+ *                      which the caller must dispose.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such
+ *        transaction.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_get_transaction(
+    block_store* store, const uint8_t* txn_id, vccrypt_buffer_t* txn);
+
+/**
+ * \brief Read the id of the latest transaction for an artifact.
+ *
+ * \param store         The store.
+ * \param artifact_id   The id of the artifact.
+ * \param txn_id        Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the artifact has no
+ *        transactions.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_artifact_latest(
+    block_store* store, const uint8_t* artifact_id, uint8_t* txn_id);
+
+/**
+ * \brief Read a page of an artifact's history.
+ *
+ * Each transaction added for an artifact is given the next sequence number
+ * for that artifact, starting from 0, in the order the transactions are
+ * committed.  This reads the ids of the transactions from the given sequence
+ * on, in sequence order, by scanning forward from that key; so a caller
+ * pages through a history by starting each page at the previous start plus
+ * the previous count, and has reached the end when a page comes back short.
+ *
+ * \param store         The store.
+ * \param artifact_id   The id of the artifact.
+ * \param start         The sequence of the first transaction to read.
+ * \param txn_ids       Buffer of max_count * BLOCK_STORE_ID_SIZE bytes to
+ *                      receive the transaction ids.
+ * \param max_count     The most transaction ids to read.
+ * \param count         Pointer to receive the number of ids read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when there are no
+ *        transactions from the given sequence on.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_artifact_history(
+    block_store* store, const uint8_t* artifact_id, uint64_t start,
+    uint8_t* txn_ids, size_t max_count, size_t* count);
+
+/**
+ * \brief Receive a block from a scan.
+ *
+ * \param context       The user context passed to the scan.
+ * \param height        The height of the block.
+ * \param block_id      The id of the block.
+ * \param block         The block certificate.  This points into the store's
+ *                      memory map, and is only valid for the duration of the
+ *                      callback.
+ * \param size          The size of the block certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS to continue the scan.
+ *      - a non-zero error code to stop the scan; this code is returned to the
+ *        caller of the scan.
+ */
+typedef int (*block_store_block_fn)(
+    void* context, uint64_t height, const uint8_t* block_id,
+    const void* block, size_t size);
+
+/**
+ * \brief Scan the blocks in a range of heights, in height order.
+ *
+ * The whole range is read from one snapshot of the store by walking a cursor
+ * over the height table, and each block is passed to the callback without
+ * being copied.  The callback must not read from the store itself, since the
+ * scan holds this thread's read transaction.  While the snapshot is held,
+ * pages freed by writers can't be reused, so a caller feeding a slow consumer
+ * should scan in bounded slices.
+ *
+ * \param store         The store.
+ * \param start         The lowest height to scan.
+ * \param end           The highest height to scan.
+ * \param onblock       The callback to receive each block.
+ * \param context       The user context to pass to the callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when there are no
+ *        blocks in the range.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - the non-zero status returned by the callback, if it stops the scan.
+ */
+int block_store_scan_blocks(
+    block_store* store, uint64_t start, uint64_t end,
+    block_store_block_fn onblock, void* context);
+
+/**
+ * \brief Receive an artifact from a scan.
+ *
+ * \param context       The user context passed to the scan.
+ * \param artifact_id   The id of the artifact.
+ * \param txn_id        The id of the artifact's latest transaction.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS to continue the scan.
+ *      - a non-zero error code to stop the scan; this code is returned to the
+ *        caller of the scan.
+ */
+typedef int (*block_store_artifact_fn)(
+    void* context, const uint8_t* artifact_id, const uint8_t* txn_id);
+
+/**
+ * \brief Scan the latest transaction of every artifact, in artifact id order,
+ * along with the tip of the chain.
+ *
+ * The artifacts and the tip are read from one snapshot of the store, so the
+ * artifacts are the state as of the tip, provided each block's transactions
+ * are written in the same batch as the block.  The callback must not read
+ * from the store itself, since the scan holds this thread's read transaction.
+ *
+ * \param store         The store.
+ * \param onartifact    The callback to receive each artifact.
+ * \param context       The user context to pass to the callback.
+ * \param height        Pointer to receive the greatest height with a block.
+ * \param block_id      Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id
+ *                      of the block at that height.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the store has no blocks.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - the non-zero status returned by the callback, if it stops the scan.
+ */
+int block_store_scan_artifacts(
+    block_store* store, block_store_artifact_fn onartifact, void* context,
+    uint64_t* height, uint8_t* block_id);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_BLOCK_STORE_HEADER_GUARD*/
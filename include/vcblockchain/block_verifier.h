@@ -0,0 +1,124 @@
+/**
+ * \file vcblockchain/block_verifier.h
+ *
+ * \brief Parallel block verification.
+ *
+ * A block certificate is parsed on the calling thread, and its wrapped
+ * transactions are verified in batches on a \ref thread_pool, each one parsed
+ * and attested by vccert.  The calling thread attests the block itself, then
+ * helps with the batches.
+ *
+ * With a \ref cert_cache, certificates which have already passed are skipped
+ * after one hash and one lookup, and certificates which pass are recorded.
+ *
+ * The verdict is deterministic: if any transactions fail, the one with the
+ * lowest index is reported, whatever order the batches ran in.  Once a
+ * transaction fails, transactions after it are skipped.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_BLOCK_VERIFIER_HEADER_GUARD
+#define VCBLOCKCHAIN_BLOCK_VERIFIER_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vccert/parser.h>
+#include <vcblockchain/cert_cache.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/thread_pool.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The failed index reported when the block certificate itself failed.
+ */
+#define BLOCK_VERIFIER_BLOCK_INDEX SIZE_MAX
+
+/**
+ * \brief The default number of transactions verified per task.
+ */
+#define BLOCK_VERIFIER_DEFAULT_BATCH_SIZE 8
+
+/**
+ * \brief A block verifier.
+ */
+typedef struct block_verifier
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccert_parser_options_t* parser_options;
+    thread_pool* pool;
+    cert_cache* cache;
+    size_t batch_size;
+    uint8_t verify_contracts;
+} block_verifier;
+
+/**
+ * \brief Initialize a block verifier.
+ *
+ * The parser options are shared by every worker, so their resolvers must be
+ * safe to call from several threads at once.  The parser options, pool, and
+ * cache must outlive the verifier.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param verifier          The verifier to initialize.
+ * \param alloc_opts        The allocator to use for this verifier.
+ * \param parser_options    The vccert parser options for attestation.
+ * \param pool              The pool to verify on, or NULL to verify on the
+ *                          calling thread.
+ * \param cache             The cache of verified certificates to consult
+ *                          and update, or NULL to attest every certificate.
+ *                          Only verifiers with the same parser options may
+ *                          share a cache; verdicts are keyed by height and
+ *                          contract setting.
+ * \param batch_size        The number of transactions per task; 0 selects
+ *                          BLOCK_VERIFIER_DEFAULT_BATCH_SIZE.
+ * \param verify_contracts  If non-zero, transactions are also checked against
+ *                          their contracts.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int block_verifier_init(
+    block_verifier* verifier, allocator_options_t* alloc_opts,
+    vccert_parser_options_t* parser_options, thread_pool* pool,
+    cert_cache* cache, size_t batch_size, uint8_t verify_contracts);
+
+/**
+ * \brief Verify a block and every transaction it wraps.
+ *
+ * \param verifier          The verifier.
+ * \param block             The block certificate.
+ * \param size              The size of the block certificate.
+ * \param failed_index      Pointer to receive, on failure, the index of the
+ *                          first failing transaction, or
+ *                          BLOCK_VERIFIER_BLOCK_INDEX if the block itself
+ *                          failed.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the block is valid.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_INVALID if the block certificate is
+ *        malformed or failed attestation.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_TRANSACTION_INVALID if a transaction is
+ *        malformed or failed attestation.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_verifier_verify(
+    block_verifier* verifier, const void* block, size_t size,
+    size_t* failed_index);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_BLOCK_VERIFIER_HEADER_GUARD*/
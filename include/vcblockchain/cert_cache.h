@@ -0,0 +1,141 @@
+/**
+ * \file vcblockchain/cert_cache.h
+ *
+ * \brief Bounded cache of certificates which have passed verification.
+ *
+ * A certificate is identified by its digest under the suite's hash, taken
+ * together with the context it was verified in.  Once a certificate passes
+ * signature and structure checks, its digest is recorded, so verifying the
+ * same certificate in the same context again costs one hash and one lookup.
+ *
+ * The cache is split into shards, each with its own lock, so lookups from
+ * several threads rarely contend.  When a shard is full, it evicts with the
+ * CLOCK policy: a hit marks an entry as referenced, and the clock hand skips
+ * and clears referenced entries until it finds one to evict.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_CERT_CACHE_HEADER_GUARD
+#define VCBLOCKCHAIN_CERT_CACHE_HEADER_GUARD
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vccrypt/suite.h>
+#include <vcblockchain/error_codes.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The number of shards in a cache.  Must be a power of two.
+ */
+#define CERT_CACHE_SHARDS 16
+
+/**
+ * \brief The largest digest a cache supports, so callers can keep digests on
+ * the stack.
+ */
+#define CERT_CACHE_MAX_DIGEST_SIZE 64
+
+/**
+ * \brief Opaque shard type.
+ */
+typedef struct cert_cache_shard cert_cache_shard;
+
+/**
+ * \brief A verified-certificate cache.
+ */
+typedef struct cert_cache
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccrypt_suite_options_t* suite;
+    size_t digest_size;
+    cert_cache_shard* shards;
+
+    /** \brief lookup counters, updated atomically. */
+    uint64_t hits;
+    uint64_t misses;
+} cert_cache;
+
+/**
+ * \brief Initialize a verified-certificate cache.
+ *
+ * The suite must outlive the cache.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param cache         The cache to initialize.
+ * \param alloc_opts    The allocator to use for this cache.
+ * \param suite         The crypto suite whose hash identifies certificates.
+ * \param capacity      The number of digests to hold, rounded up to a
+ *                      multiple of CERT_CACHE_SHARDS.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        the suite's hash is larger than CERT_CACHE_MAX_DIGEST_SIZE.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int cert_cache_init(
+    cert_cache* cache, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, size_t capacity);
+
+/**
+ * \brief Compute the digest identifying a certificate in the context it was
+ * verified in.
+ *
+ * A verdict which depends on more than the certificate, such as the height it
+ * was attested at, must be keyed by that context as well, so the verdict is
+ * only reused in the same context.  The context is hashed ahead of the
+ * certificate.
+ *
+ * \param cache         The cache.
+ * \param context       The verification context, or NULL if there is none.
+ * \param context_size  The size of the verification context.
+ * \param cert          The certificate.
+ * \param size          The size of the certificate.
+ * \param digest        Buffer of the suite's hash size to receive the digest.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int cert_cache_digest(
+    cert_cache* cache, const void* context, size_t context_size,
+    const void* cert, size_t size, uint8_t* digest);
+
+/**
+ * \brief Look up a digest, marking it as referenced if present.
+ *
+ * \param cache         The cache.
+ * \param digest        The digest to look up.
+ *
+ * \returns true if the certificate with this digest has passed verification,
+ *          and false otherwise.
+ */
+bool cert_cache_contains(cert_cache* cache, const uint8_t* digest);
+
+/**
+ * \brief Record the digest of a certificate which has passed verification,
+ * evicting another digest if its shard is full.
+ *
+ * \param cache         The cache.
+ * \param digest        The digest to record.
+ */
+void cert_cache_insert(cert_cache* cache, const uint8_t* digest);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_CERT_CACHE_HEADER_GUARD*/
@@ -0,0 +1,139 @@
+/**
+ * \file vcblockchain/checkpoint.h
+ *
+ * \brief Checkpoints of derived state, for fast node startup.
+ *
+ * A checkpoint records the state derived from the chain as of one block: the
+ * height and id of that block, and the latest transaction of every artifact.
+ * A starting node opens its latest checkpoint, then replays only the blocks
+ * above its height, for instance with \ref block_store_scan_blocks(), instead
+ * of scanning the whole chain.
+ *
+ * The file is a fixed-size header followed by one entry per artifact, sorted
+ * by artifact id, each the artifact id followed by the transaction id.  Every
+ * integer is big-endian.  The header ends with a digest, which is the suite's
+ * hash of the entries followed by the rest of the header.  The file is opened
+ * by mapping it into memory and checking the digest, and artifacts are then
+ * looked up by binary search over the map, without building anything.
+ *
+ * A checkpoint is written to a temporary file beside the path, synced, and
+ * renamed over the path, and the directory is then synced, so a crash leaves
+ * either the old checkpoint or the new one, and a successful write survives.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_CHECKPOINT_HEADER_GUARD
+#define VCBLOCKCHAIN_CHECKPOINT_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/block_store.h>
+#include <vcblockchain/error_codes.h>
+#include <vccrypt/suite.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The version of the checkpoint format.
+ */
+#define CHECKPOINT_VERSION 1
+
+/**
+ * \brief The largest hash a checkpoint digest can hold.
+ */
+#define CHECKPOINT_MAX_DIGEST_SIZE 64
+
+/**
+ * \brief The size of an entry: an artifact id, then a transaction id.
+ */
+#define CHECKPOINT_ENTRY_SIZE (2 * BLOCK_STORE_ID_SIZE)
+
+/**
+ * \brief An open checkpoint, mapped into memory.
+ */
+typedef struct checkpoint
+{
+    disposable_t hdr;
+    void* map;
+    size_t map_size;
+    uint64_t height;
+    uint8_t block_id[BLOCK_STORE_ID_SIZE];
+    uint64_t artifact_count;
+
+    /** \brief the entries, sorted by artifact id, inside the map. */
+    const uint8_t* entries;
+} checkpoint;
+
+/**
+ * \brief Write a checkpoint of a store's state as of its tip.
+ *
+ * The artifacts are streamed from the store to the file, so nothing the size
+ * of the state is held in memory.
+ *
+ * \param store         The store to checkpoint.
+ * \param suite         The crypto suite whose hash makes the digest.
+ * \param path          The path of the checkpoint.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the store has no blocks.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if reading the store failed.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_IO if writing the file failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int checkpoint_write(
+    block_store* store, vccrypt_suite_options_t* suite, const char* path);
+
+/**
+ * \brief Open a checkpoint, checking its digest.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed, which unmaps the file.
+ *
+ * \param cp            The checkpoint to initialize.
+ * \param suite         The crypto suite the checkpoint was written with.
+ * \param path          The path of the checkpoint.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_IO if the file could not be opened or
+ *        mapped.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID if the file is malformed, is
+ *        of another version or suite, or its digest does not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int checkpoint_open(
+    checkpoint* cp, vccrypt_suite_options_t* suite, const char* path);
+
+/**
+ * \brief Look up the latest transaction of an artifact in a checkpoint.
+ *
+ * \param cp            The checkpoint.
+ * \param artifact_id   The id of the artifact.
+ * \param txn_id        Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id
+ *                      of the artifact's latest transaction.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_NOT_FOUND if the checkpoint has no
+ *        entry for the artifact.
+ */
+int checkpoint_get_artifact_latest(
+    const checkpoint* cp, const uint8_t* artifact_id, uint8_t* txn_id);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_CHECKPOINT_HEADER_GUARD*/
@@ -0,0 +1,41 @@
+/**
+ * \file vcblockchain/crc32c.h
+ *
+ * \brief CRC32C (Castagnoli) checksum routines.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_CRC32C_HEADER_GUARD
+#define VCBLOCKCHAIN_CRC32C_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief Update a CRC32C checksum with the given data.
+ *
+ * Start with a crc of 0; the result of one call can be passed as the crc of
+ * the next call to checksum data incrementally.  The SSE4.2 or ARMv8 CRC32
+ * instructions are used when the CPU supports them, and a slicing-by-8 table
+ * implementation is used otherwise.  The result is the same either way.
+ *
+ * \param crc       The checksum of the preceding data, or 0.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated checksum.
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t size);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_CRC32C_HEADER_GUARD*/
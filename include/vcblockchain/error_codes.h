@@ -60,6 +60,140 @@ extern "C" {
  */
 #define VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE 0x5105
 
+/**
+ * \brief A compressed data packet read from the socket could not be
+ * decompressed.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS 0x5106
+
+/**
+ * \brief The checksum of a checksummed data packet read from the socket did not
+ * match its contents.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM 0x5107
+
+/**
+ * \brief A server could not create, bind, or listen on its listen sockets.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN 0x5108
+
+/**
+ * \brief A server could not start its reactor threads.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_SERVER_THREAD 0x5109
+
+/**
+ * \brief A prefetching ssock could not start its I/O thread.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_PREFETCH_THREAD 0x510A
+
+/**
+ * \brief A write queue stayed above its high watermark for too long to accept
+ * another frame.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL 0x510B
+
+/**
+ * \brief The peer of a write queue was shed as a slow consumer.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER 0x510C
+
+/**
+ * \brief The peer failed to prove its identity during a handshake.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH 0x510D
+
+/**
+ * \brief The peer presented an id which is not known to this host.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_UNKNOWN_PEER 0x510E
+
+/**
+ * \brief A crypto operation failed during a handshake.
+ */
+#define VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO 0x510F
+
+/**
+ * \brief A thread pool could not start its workers.
+ */
+#define VCBLOCKCHAIN_ERROR_THREAD_POOL_THREAD 0x5110
+
+/**
+ * \brief A block certificate is malformed or failed attestation.
+ */
+#define VCBLOCKCHAIN_ERROR_BLOCK_INVALID 0x5111
+
+/**
+ * \brief A transaction in a block is malformed or failed attestation.
+ */
+#define VCBLOCKCHAIN_ERROR_BLOCK_TRANSACTION_INVALID 0x5112
+
+/**
+ * \brief A certificate added to a signature batch has no usable signature.
+ */
+#define VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED 0x5113
+
+/**
+ * \brief A signature in a batch failed verification.
+ */
+#define VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_INVALID 0x5114
+
+/**
+ * \brief A transaction does not fit the space reserved for it in a block.
+ */
+#define VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_CAPACITY 0x5115
+
+/**
+ * \brief A block has already been signed and emitted.
+ */
+#define VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED 0x5116
+
+/**
+ * \brief A Merkle inclusion proof does not match the root.
+ */
+#define VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID 0x5117
+
+/**
+ * \brief The block store database reported an error.
+ */
+#define VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE 0x5118
+
+/**
+ * \brief The block store has no record under the given key.
+ */
+#define VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND 0x5119
+
+/**
+ * \brief A fast sync could not start its pipeline threads.
+ */
+#define VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD 0x511A
+
+/**
+ * \brief A peer sent a block outside of the requested range, or out of order.
+ */
+#define VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE 0x511B
+
+/**
+ * \brief A checkpoint file could not be read or written.
+ */
+#define VCBLOCKCHAIN_ERROR_CHECKPOINT_IO 0x511C
+
+/**
+ * \brief A checkpoint is malformed or failed its integrity check.
+ */
+#define VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID 0x511D
+
+/**
+ * \brief A checkpoint has no entry for the given artifact.
+ */
+#define VCBLOCKCHAIN_ERROR_CHECKPOINT_NOT_FOUND 0x511E
+
+/**
+ * \brief A peer sent a block whose certificate does not match the height or
+ * id it was sent under, or which does not link to the block before it.
+ */
+#define VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH 0x511F
+
 /**
  * @}
  */
@@ -0,0 +1,184 @@
+/**
+ * \file vcblockchain/merkle_tree.h
+ *
+ * \brief Incremental Merkle tree with inclusion proofs.
+ *
+ * Leaves are appended one at a time, and each pair of nodes is combined as
+ * soon as it is complete, so appending costs one leaf hash plus one node hash
+ * per level completed.  A level with an odd number of nodes promotes its last
+ * node unchanged, rather than pairing it with itself.
+ *
+ * Leaves and interior nodes are hashed with distinct prefixes, so a leaf can
+ * never be passed off as an interior node.  An inclusion proof is the list of
+ * sibling hashes from a leaf to the root, which for n leaves is at most
+ * ceil(log2(n)) hashes.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_MERKLE_TREE_HEADER_GUARD
+#define VCBLOCKCHAIN_MERKLE_TREE_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vccrypt/suite.h>
+#include <vcblockchain/error_codes.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The most levels a tree can have.
+ */
+#define MERKLE_TREE_MAX_LEVELS 64
+
+/**
+ * \brief The largest hash a tree supports.
+ */
+#define MERKLE_TREE_MAX_HASH_SIZE 64
+
+/**
+ * \brief The block field carrying the Merkle root of the block's
+ * transactions.
+ */
+#define MERKLE_TREE_FIELD_TYPE_ROOT 0x0400
+
+/**
+ * \brief The completed nodes of one level of the tree.
+ */
+typedef struct merkle_tree_level
+{
+    uint8_t* nodes;
+    size_t count;
+    size_t capacity;
+} merkle_tree_level;
+
+/**
+ * \brief An incremental Merkle tree.
+ */
+typedef struct merkle_tree
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccrypt_suite_options_t* suite;
+    size_t hash_size;
+    merkle_tree_level levels[MERKLE_TREE_MAX_LEVELS];
+} merkle_tree;
+
+/**
+ * \brief Initialize an empty Merkle tree.
+ *
+ * The suite must outlive the tree.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param tree          The tree to initialize.
+ * \param alloc_opts    The allocator to use for this tree.
+ * \param suite         The crypto suite whose hash builds the tree.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        the suite's hash is larger than MERKLE_TREE_MAX_HASH_SIZE.
+ */
+int merkle_tree_init(
+    merkle_tree* tree, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite);
+
+/**
+ * \brief Append a leaf to the tree.
+ *
+ * On failure, the tree is left as it was.
+ *
+ * \param tree          The tree.
+ * \param data          The leaf data, such as a transaction certificate.
+ * \param size          The size of the leaf data.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_append(merkle_tree* tree, const void* data, size_t size);
+
+/**
+ * \brief Get the number of leaves in the tree.
+ *
+ * \param tree          The tree.
+ *
+ * \returns the number of leaves.
+ */
+size_t merkle_tree_count(const merkle_tree* tree);
+
+/**
+ * \brief Compute the root of the tree.
+ *
+ * The root of an empty tree is the hash of the interior node prefix alone,
+ * which no leaf or pair of nodes can produce.
+ *
+ * \param tree          The tree.
+ * \param root          Buffer of the suite's hash size to receive the root.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_root(const merkle_tree* tree, uint8_t* root);
+
+/**
+ * \brief Generate the inclusion proof for a leaf.
+ *
+ * \param tree          The tree.
+ * \param index         The index of the leaf.
+ * \param proof         Buffer to receive the proof, which needs room for
+ *                      MERKLE_TREE_MAX_LEVELS hashes at most.
+ * \param proof_size    On input, the size of the proof buffer; on output, the
+ *                      size of the proof.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed,
+ *        the index is out of range, or the proof buffer is too small.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_prove(
+    const merkle_tree* tree, size_t index, uint8_t* proof, size_t* proof_size);
+
+/**
+ * \brief Verify an inclusion proof against a root, without the tree.
+ *
+ * \param suite         The crypto suite whose hash built the tree.
+ * \param data          The leaf data.
+ * \param size          The size of the leaf data.
+ * \param index         The index of the leaf.
+ * \param count         The number of leaves in the tree.
+ * \param proof         The proof.
+ * \param proof_size    The size of the proof.
+ * \param root          The root of the tree.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the leaf is in the tree.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID if the proof does not lead
+ *        from the leaf to the root.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_verify(
+    vccrypt_suite_options_t* suite, const void* data, size_t size,
+    size_t index, size_t count, const uint8_t* proof, size_t proof_size,
+    const uint8_t* root);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_MERKLE_TREE_HEADER_GUARD*/
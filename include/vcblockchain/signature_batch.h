@@ -0,0 +1,174 @@
+/**
+ * \file vcblockchain/signature_batch.h
+ *
+ * \brief Batch verification of certificate signatures.
+ *
+ * Signatures are collected from many certificates, then verified together in
+ * one call.  The batch is split into chunks which run on a \ref thread_pool,
+ * and each chunk sets up a signature context and scratch buffer once for all
+ * of its signatures, rather than once per certificate.  vccrypt has no batch
+ * verification primitive, so each signature is still checked on its own; the
+ * gain is in the setup saved and the cores used.
+ *
+ * A batch either passes as a whole, or reports the lowest index which failed,
+ * so the culprit is found without re-verifying the batch.  Signatures after a
+ * known failure are skipped.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SIGNATURE_BATCH_HEADER_GUARD
+#define VCBLOCKCHAIN_SIGNATURE_BATCH_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vccert/parser.h>
+#include <vccrypt/suite.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/thread_pool.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The initial number of entries a batch has room for.
+ */
+#define SIGNATURE_BATCH_INITIAL_CAPACITY 64
+
+/**
+ * \brief The default number of signatures verified per task.
+ */
+#define SIGNATURE_BATCH_DEFAULT_CHUNK_SIZE 16
+
+/**
+ * \brief One signature in a batch.  The message, signature, and public key are
+ * borrowed from the caller, and must remain valid until the batch is cleared.
+ */
+typedef struct signature_batch_entry
+{
+    const uint8_t* message;
+    size_t message_size;
+    const uint8_t* signature;
+    const vccrypt_buffer_t* public_key;
+} signature_batch_entry;
+
+/**
+ * \brief A batch of signatures.
+ */
+typedef struct signature_batch
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccrypt_suite_options_t* suite;
+    vccert_parser_options_t* parser_options;
+    thread_pool* pool;
+    size_t chunk_size;
+    signature_batch_entry* entries;
+    size_t count;
+    size_t capacity;
+} signature_batch;
+
+/**
+ * \brief Initialize a signature batch.
+ *
+ * The suite, parser options, and pool must outlive the batch.  This instance
+ * is disposable and must be disposed by calling \ref dispose() when no longer
+ * needed.
+ *
+ * \param batch             The batch to initialize.
+ * \param alloc_opts        The allocator to use for this batch.
+ * \param suite             The crypto suite the signatures were made with.
+ * \param parser_options    The vccert parser options for reading
+ *                          certificates.
+ * \param pool              The pool to verify on, or NULL to verify on the
+ *                          calling thread.
+ * \param chunk_size        The number of signatures per task; 0 selects
+ *                          SIGNATURE_BATCH_DEFAULT_CHUNK_SIZE.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_init(
+    signature_batch* batch, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, vccert_parser_options_t* parser_options,
+    thread_pool* pool, size_t chunk_size);
+
+/**
+ * \brief Add a signature over a message to the batch.
+ *
+ * \param batch             The batch.
+ * \param message           The signed message.
+ * \param message_size      The size of the signed message.
+ * \param signature         The signature, of the suite's signature size.
+ * \param public_key        The public key of the signer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_add(
+    signature_batch* batch, const uint8_t* message, size_t message_size,
+    const uint8_t* signature, const vccrypt_buffer_t* public_key);
+
+/**
+ * \brief Add the signature of a certificate to the batch.
+ *
+ * The signature is the certificate's signature field, which must be its last
+ * field, and it covers every byte of the certificate before that field.
+ *
+ * \param batch             The batch.
+ * \param cert              The certificate.
+ * \param size              The size of the certificate.
+ * \param public_key        The public key of the certificate's signer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED if the certificate does
+ *        not parse, or has no signature of the suite's signature size as its
+ *        last field.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_add_certificate(
+    signature_batch* batch, const void* cert, size_t size,
+    const vccrypt_buffer_t* public_key);
+
+/**
+ * \brief Verify every signature in the batch.
+ *
+ * \param batch             The batch.
+ * \param failed_index      Pointer to receive, on failure, the lowest index
+ *                          whose signature failed.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if every signature is valid.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_INVALID if a signature failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_verify(signature_batch* batch, size_t* failed_index);
+
+/**
+ * \brief Remove every signature from the batch, keeping its storage.
+ *
+ * \param batch             The batch.
+ */
+void signature_batch_clear(signature_batch* batch);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SIGNATURE_BATCH_HEADER_GUARD*/
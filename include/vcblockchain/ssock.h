@@ -26,7 +26,8 @@ extern "C" {
  * This instance takes over ownership of the socxet descriptor. This instance is
  * disposable and must be disposed by calling \ref dispose() when no longer
  * needed.  Note that \ref dispose() will close the underlying socket
- * descriptor.
+ * descriptor.  A write to a peer which has hung up fails instead of raising
+ * SIGPIPE.
  *
  * \param sock              The ssock instance to initialize.
  * \param sd                The socket descriptor to use for this instance.
@@ -38,6 +39,51 @@ extern "C" {
  */
 int ssock_init_from_posix(ssock* sock, int sd);
 
+/**
+ * \brief Set the read policy for a ssock instance.
+ *
+ * The read policy bounds the string and data packet sizes accepted from the
+ * peer, and selects whether payload buffers are allocated up front or grown as
+ * payload bytes arrive.  The policy is copied into the ssock instance.
+ *
+ * \param sock              The ssock instance to update.
+ * \param policy            The read policy for this instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int ssock_set_read_policy(ssock* sock, const ssock_read_policy* policy);
+
+/**
+ * \brief Negotiate data packet compression with the peer.
+ *
+ * Both peers must call this function at the same point in the conversation.
+ * Each peer sends the bitmask of codecs it supports and reads the bitmask of
+ * the peer; compression is enabled if both peers support a common codec.  Once
+ * enabled, \ref ssock_write_data() compresses payloads of at least the
+ * threshold size when this makes them smaller, and \ref ssock_read_data()
+ * decompresses them transparently.  Pass SSOCK_COMPRESSION_NONE to decline.
+ *
+ * \param sock              The ssock instance to negotiate on.
+ * \param alloc_opts        The allocator to use for compression scratch
+ *                          buffers; may be NULL if declining.
+ * \param codecs            The bitmask of supported SSOCK_COMPRESSION_* codecs.
+ * \param threshold         The smallest payload to compress; 0 selects the
+ *                          default of 512 bytes.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the peer did not
+ *        respond with a compression offer.
+ */
+int ssock_negotiate_compression(
+    ssock* sock, allocator_options_t* alloc_opts, uint8_t codecs,
+    uint32_t threshold);
+
 /**
  * \brief Read data from a ssock instance.
  *
@@ -70,11 +116,206 @@ int ssock_read(ssock* sock, void* buf, size_t* size);
  */
 int ssock_write(ssock* sock, const void* buf, size_t* size);
 
+/**
+ * \brief Write several buffers to a ssock instance as a single write.
+ *
+ * If the ssock instance supports gathered writes, such as a POSIX socket, then
+ * the buffers are written with a single system call.  Otherwise, each buffer
+ * is written in turn, stopping at the first short write.
+ *
+ * \param sock      The ssock instance to write to.
+ * \param iov       The array of buffers to write, in order.
+ * \param iovcnt    The number of buffers in this array.
+ * \param size      Pointer to receive the total number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - a non-zero error code on failure.
+ */
+int ssock_writev(
+    ssock* sock, const ssock_iovec* iov, size_t iovcnt, size_t* size);
+
+/**
+ * \brief Flush any data buffered by a ssock instance.
+ *
+ * For a filter chain, the flush is passed down to each layer in turn.  An
+ * ssock instance without buffering treats this as a no-op.
+ *
+ * \param sock      The ssock instance to flush.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - a non-zero error code on failure.
+ */
+int ssock_flush(ssock* sock);
+
+/**
+ * \brief Shut down reading and writing on a ssock instance.
+ *
+ * A read or write blocked on this instance, or made after this call, returns
+ * instead of waiting on the peer; a read reports end of stream.  For a filter
+ * chain, the shutdown is passed down to the innermost ssock.  An ssock
+ * instance which can't be woken treats this as a no-op.  The instance must
+ * still be disposed.
+ *
+ * \param sock      The ssock instance to shut down.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - a non-zero error code on failure.
+ */
+int ssock_shutdown(ssock* sock);
+
+/**
+ * \brief Initialize a pass-through filter ssock which wraps an inner ssock.
+ *
+ * The read, write, writev, flush, and shutdown methods of this instance
+ * forward to the inner ssock.  A filter implementation initializes its ssock
+ * with this function and then replaces the methods it needs to transform or
+ * observe, leaving the rest as pass-throughs.  A filter which replaces write should
+ * also replace writev or set it to NULL, so that gathered writes are routed
+ * through its write method.  The read policy, compression settings, and
+ * statistics of the inner ssock are copied to this instance.
+ *
+ * This instance takes ownership of the inner ssock.  When this instance is
+ * disposed, the inner ssock is disposed as well, so that a whole filter chain
+ * is torn down by disposing its outermost ssock.  A filter which fails after
+ * this call clears this instance again before returning, so that the caller
+ * keeps ownership of the inner ssock and has nothing to dispose.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int ssock_filter_init(ssock* sock, ssock* inner);
+
+/**
+ * \brief Initialize a buffering filter ssock which wraps an inner ssock.
+ *
+ * Small reads are served from a read buffer which is refilled from the inner
+ * ssock as needed, and each read is satisfied in full unless the inner ssock
+ * reaches end of stream.  Small writes are coalesced into a write buffer which
+ * is written to the inner ssock when it fills or when \ref ssock_flush() is
+ * called.  Reads or writes larger than the buffer bypass it.  A buffer size of
+ * zero disables buffering in that direction.
+ *
+ * Buffered writes that have not been flushed are discarded when this instance
+ * is disposed.  This instance takes ownership of the inner ssock.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param alloc_opts        The allocator to use for the buffers.
+ * \param read_buffer_size  The size of the read buffer.
+ * \param write_buffer_size The size of the write buffer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_buffered_filter_init(
+    ssock* sock, ssock* inner, allocator_options_t* alloc_opts,
+    size_t read_buffer_size, size_t write_buffer_size);
+
+/**
+ * \brief Initialize a hashing filter ssock which wraps an inner ssock.
+ *
+ * Every byte read from or written to the inner ssock is passed to the given
+ * running hash for that direction, so that a transcript hash can be computed
+ * without a second pass over the data.  Either hash may be NULL, in which case
+ * that direction is passed through unobserved.  The hash contexts are owned by
+ * the caller and must outlive this instance.  This instance takes ownership of
+ * the inner ssock.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param alloc_opts        The allocator to use for the filter context.
+ * \param read_hash         The running hash for bytes read, or NULL.
+ * \param write_hash        The running hash for bytes written, or NULL.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_hash_filter_init(
+    ssock* sock, ssock* inner, allocator_options_t* alloc_opts,
+    vccrypt_hash_context_t* read_hash, vccrypt_hash_context_t* write_hash);
+
+/**
+ * \brief Initialize a counting filter ssock which wraps an inner ssock.
+ *
+ * The byte and call counts of reads and writes on the inner ssock are added to
+ * the given \ref ssock_stats structure, which is owned by the caller and must
+ * outlive this instance.  Placing this filter below a buffering filter counts
+ * the calls which reach the network.  The stats are also attached to this
+ * instance, and inherited by filters layered above it, so that data packets
+ * written or read through the chain report their compression counters here.
+ * This instance takes ownership of the inner ssock.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param stats             The counters to update.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int ssock_stats_filter_init(ssock* sock, ssock* inner, ssock_stats* stats);
+
+/**
+ * \brief Initialize a prefetching filter ssock which wraps an inner ssock.
+ *
+ * A dedicated I/O thread reads ahead from the inner ssock into a ring of
+ * pooled slot buffers, while the caller decodes and processes the packets
+ * already received, so that network and CPU work overlap.  The I/O thread
+ * stops filling once every slot is full, which bounds memory use and lets the
+ * peer's flow control take over.  Reads are served from the ring and are
+ * satisfied in full unless the inner ssock reaches end of stream; a read error
+ * on the inner ssock is reported once the data before it has been consumed.
+ * Writes pass through to the inner ssock.
+ *
+ * Only one thread may read from this instance.  Since the I/O thread reads
+ * from the inner ssock while the caller writes to it, the inner ssock must
+ * support a read concurrent with a write, as a POSIX socket does.  This
+ * instance takes ownership of the inner ssock.  Disposing it stops and joins
+ * the I/O thread, shutting down the inner ssock with \ref ssock_shutdown() to
+ * wake a read blocked on it; an inner ssock which can't be shut down must not
+ * block a read indefinitely.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param alloc_opts        The allocator to use for the slot buffers.
+ * \param slots             The number of slot buffers; at least two.
+ * \param slot_size         The size of each slot buffer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_PREFETCH_THREAD if the I/O thread could not
+ *        be started.
+ */
+int ssock_prefetch_filter_init(
+    ssock* sock, ssock* inner, allocator_options_t* alloc_opts, size_t slots,
+    size_t slot_size);
+
 /**
  * \brief Write a data packet.
  *
  * On success, the data packet value will be written, along with type
- * information and size.
+ * information and size.  If compression was negotiated for this socket and the
+ * payload is at least the compression threshold, it is sent as a compressed
+ * data packet when this makes it smaller.
  *
  * \param sock          The \ref ssock socket to which data is written.
  * \param val           The data to write.
@@ -84,9 +325,77 @@ int ssock_write(ssock* sock, const void* buf, size_t* size);
  *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
  *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
  *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
  */
 int ssock_write_data(ssock* sock, const void* val, uint32_t size);
 
+/**
+ * \brief Write a checksummed data packet.
+ *
+ * The packet is a data packet followed by the CRC32C of its header and
+ * payload, which lets the peer detect corruption without the cost of an
+ * authenticated packet.  The header, payload, and checksum are written with a
+ * single gathered write.  This detects accidental corruption only; it offers
+ * no protection against tampering.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The data to write.
+ * \param size          The size of the data to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_crc(ssock* sock, const void* val, uint32_t size);
+
+/**
+ * \brief Begin writing a data stream packet of unknown length.
+ *
+ * A data stream packet consists of the data stream type, followed by any number
+ * of chunks written with \ref ssock_write_data_stream_chunk(), and terminated
+ * by \ref ssock_write_data_stream_end().  No other packets may be written to
+ * the socket until the stream is terminated.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_stream_begin(ssock* sock);
+
+/**
+ * \brief Write a chunk of a data stream packet.
+ *
+ * Each chunk is written with its size.  Writing an empty chunk is a no-op,
+ * since the empty chunk is reserved to terminate the stream.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The chunk data to write.
+ * \param size          The size of the chunk data to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_stream_chunk(ssock* sock, const void* val, uint32_t size);
+
+/**
+ * \brief Terminate a data stream packet.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_stream_end(ssock* sock);
+
 /**
  * \brief Write an authenticated data packet.
  *
@@ -159,6 +468,38 @@ int ssock_write_uint64(ssock* sock, uint64_t val);
  */
 int ssock_write_int64(ssock* sock, int64_t val);
 
+/**
+ * \brief Write a uint32_t value to the socket.
+ *
+ * On success, the value is written, along with type information and size.
+ * The packet is written to the socket using a single write call.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The value to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_uint32(ssock* sock, uint32_t val);
+
+/**
+ * \brief Write an int32_t value to the socket.
+ *
+ * On success, the value is written, along with type information and size.
+ * The packet is written to the socket using a single write call.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The value to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_int32(ssock* sock, int32_t val);
+
 /**
  * \brief Write a uint8_t value to the socket.
  *
@@ -194,7 +535,11 @@ int ssock_write_int8(ssock* sock, int8_t val);
  *
  * On success, a data buffer is allocated and read, along with type
  * information and size.  The caller owns this buffer and is responsible for
- * releasing it to the allocator when it is no longer in use.
+ * releasing it to the allocator when it is no longer in use.  The maximum size
+ * and allocation mode are set by the read policy of this socket.  If
+ * compression was negotiated for this socket, a compressed data packet is
+ * decompressed transparently, and the read policy applies to both its
+ * compressed and its decompressed size.
  *
  * \param sock          The \ref ssock socket from which data is read.
  * \param alloc_opts    The allocator options to use for this read.
@@ -208,12 +553,76 @@ int ssock_write_int8(ssock* sock, int8_t val);
  *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
  *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
  *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        exceeds the read policy of this socket.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if a compressed data packet
+ *        could not be decompressed.
  *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
  *        out-of-memory error.
  */
 int ssock_read_data(
     ssock* sock, allocator_options_t* alloc_opts, void** val, uint32_t* size);
 
+/**
+ * \brief Read a checksummed data packet from the socket.
+ *
+ * On success, a data buffer is allocated and read, along with type
+ * information and size, and the CRC32C checksum of the packet is verified.
+ * The caller owns this buffer and is responsible for releasing it to the
+ * allocator when it is no longer in use.  The maximum size and allocation mode
+ * are set by the read policy of this socket.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param alloc_opts    The allocator options to use for this read.
+ * \param val           Pointer to the pointer of the data buffer.
+ * \param size          Pointer to the variable to receive the size of this
+ *                      packet.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        exceeds the read policy of this socket.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM if the checksum did not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_data_crc(
+    ssock* sock, allocator_options_t* alloc_opts, void** val, uint32_t* size);
+
+/**
+ * \brief Read a data packet from the socket in bounded chunks.
+ *
+ * Either a data packet or a data stream packet is read from the socket.
+ * Instead of allocating a buffer for the whole payload, the payload is read
+ * into the caller's buffer as bytes arrive, and each chunk is passed to the
+ * given callback.  This allows large payloads to be hashed, written to disk, or
+ * parsed incrementally in constant memory.  Since nothing is allocated, the
+ * read policy of this socket does not apply.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param buf           The buffer to use for receiving chunks.
+ * \param buf_size      The size of this buffer, which bounds the chunk size.
+ * \param onchunk       The callback to receive each chunk.
+ * \param context       The user context to pass to the callback.
+ * \param size          Pointer to the variable to receive the total size of
+ *                      the payload.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - the non-zero status returned by the callback, if it aborts the read.
+ */
+int ssock_read_data_stream(
+    ssock* sock, void* buf, size_t buf_size, ssock_data_chunk_fn onchunk,
+    void* context, uint64_t* size);
+
 /**
  * \brief Read an authenticated data packet from the socket.
  *
@@ -256,6 +665,8 @@ int ssock_read_authed_data(
  * On success, a character string value is allocated and read, along with type
  * information and size.  The caller owns this character string and is
  * responsible for releasing it to the allocator it when it is no longer in use.
+ * The maximum size and allocation mode are set by the read policy of this
+ * socket.
  *
  * \param sock          The \ref ssock socket from which data is read.
  * \param alloc_opts    The allocator options to use for this read.
@@ -313,6 +724,46 @@ int ssock_read_uint64(ssock* sock, uint64_t* val);
  */
 int ssock_read_int64(ssock* sock, int64_t* val);
 
+/**
+ * \brief Read a uint32_t value from the socket.
+ *
+ * On success, the value is read, along with type information and size.  The
+ * packet is read from the socket using a single read call.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param val           Pointer to hold the value.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        read from the socket was unexpected.
+ */
+int ssock_read_uint32(ssock* sock, uint32_t* val);
+
+/**
+ * \brief Read an int32_t value from the socket.
+ *
+ * On success, the value is read, along with type information and size.  The
+ * packet is read from the socket using a single read call.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param val           Pointer to hold the value.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        read from the socket was unexpected.
+ */
+int ssock_read_int32(ssock* sock, int32_t* val);
+
 /**
  * \brief Read a uint8_t value from the socket.
  *
@@ -351,6 +802,45 @@ int ssock_read_uint8(ssock* sock, uint8_t* val);
  */
 int ssock_read_int8(ssock* sock, int8_t* val);
 
+/**
+ * \brief Read a packet of any type from the socket.
+ *
+ * The packet type is read first, and then the packet is decoded according to
+ * this type.  On success, the type, size, and value of the packet are stored
+ * in the given \ref ssock_value.  If the packet is a string or data packet,
+ * then the value is allocated using the given allocator, and the caller owns
+ * this value and is responsible for releasing it when it is no longer in use.
+ * The read policy of this socket applies as it does for \ref ssock_read_string()
+ * and \ref ssock_read_data().  A compressed data packet is decompressed, and a
+ * checksummed data packet is verified; both are reported as data packets.
+ *
+ * This method allows callers that handle streams with mixed packet types to
+ * decode the next packet without knowing its type in advance.  Authenticated
+ * data packets can't be decoded without the shared secret and IV, so these are
+ * rejected as an unexpected data type.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param alloc_opts    The allocator options to use for this read.
+ * \param val           Pointer to the tagged value to hold the packet.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if a compressed data packet
+ *        could not be decompressed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM if the checksum of a
+ *        checksummed data packet did not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_any(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val);
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
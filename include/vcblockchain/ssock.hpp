@@ -0,0 +1,677 @@
+/**
+ * \file vcblockchain/ssock.hpp
+ *
+ * \brief Typed C++ wrapper for the simple socket abstraction.
+ *
+ * This header provides templated read<T> / write<T> methods which are resolved
+ * at compile time, serialization of aggregate structs through a field
+ * descriptor trait, and RAII ownership of buffers allocated by the C API.
+ *
+ * Two kinds of backend are provided.  \ref ssock_stream forwards each value to
+ * the C API on an \ref ssock instance, so every value passes through that
+ * socket's function pointers.  \ref ssock_memory_writer and
+ * \ref ssock_memory_reader encode and decode values inline, in the same wire
+ * format, into and out of a contiguous buffer.  A message serialized with a
+ * memory writer is sent as a single data packet, and read back with a single
+ * data packet read, so only one socket call is made per message.
+ *
+ * To serialize a struct, specialize \ref ssock_fields for it:
+ *
+ * \code
+ * struct block_request { uint64_t offset; std::string id; };
+ *
+ * namespace vcblockchain {
+ * template <> struct ssock_fields<block_request> {
+ *     static auto get() {
+ *         return std::make_tuple(
+ *             &block_request::offset, &block_request::id); }
+ * };
+ * }
+ * \endcode
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_HPP_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_HPP_HEADER_GUARD
+
+#ifndef __cplusplus
+#error This header requires C++.
+#endif /*__cplusplus*/
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vcblockchain/ssock.h>
+#include <vector>
+
+namespace vcblockchain {
+
+/**
+ * \brief Field descriptor trait.
+ *
+ * Specialize this trait for an aggregate struct to make it serializable.  The
+ * specialization provides a static get() method returning a std::tuple of
+ * pointers to the members to serialize, in wire order.  Members may be any
+ * serializable type, including other described structs.
+ */
+template <typename T>
+struct ssock_fields;
+
+/**
+ * \brief Detect whether a field descriptor has been provided for T.
+ */
+template <typename T, typename Enable = void>
+struct ssock_has_fields : std::false_type
+{
+};
+
+template <typename T>
+struct ssock_has_fields<
+    T, typename std::enable_if<
+           0 <= std::tuple_size<
+                    decltype(ssock_fields<T>::get())>::value>::type>
+    : std::true_type
+{
+};
+
+/**
+ * \brief RAII owner of a buffer allocated by the C API.
+ *
+ * The buffer is released to its allocator when this instance is destroyed.
+ * Instances are movable but not copyable.
+ */
+class ssock_buffer
+{
+public:
+    ssock_buffer() noexcept
+        : alloc_opts_(nullptr), data_(nullptr), size_(0U)
+    {
+    }
+
+    ssock_buffer(
+        allocator_options_t* alloc_opts, void* data, uint32_t size) noexcept
+        : alloc_opts_(alloc_opts), data_(data), size_(size)
+    {
+    }
+
+    ssock_buffer(ssock_buffer&& other) noexcept
+        : alloc_opts_(other.alloc_opts_), data_(other.data_)
+        , size_(other.size_)
+    {
+        other.alloc_opts_ = nullptr;
+        other.data_ = nullptr;
+        other.size_ = 0U;
+    }
+
+    ssock_buffer& operator=(ssock_buffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            std::swap(alloc_opts_, other.alloc_opts_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+        }
+
+        return *this;
+    }
+
+    ssock_buffer(const ssock_buffer&) = delete;
+    ssock_buffer& operator=(const ssock_buffer&) = delete;
+
+    ~ssock_buffer()
+    {
+        reset();
+    }
+
+    /**
+     * \brief Release the owned buffer, if any.
+     */
+    void reset() noexcept
+    {
+        if (nullptr != data_)
+        {
+            release(alloc_opts_, data_);
+        }
+
+        alloc_opts_ = nullptr;
+        data_ = nullptr;
+        size_ = 0U;
+    }
+
+    const uint8_t* data() const noexcept
+    {
+        return (const uint8_t*)data_;
+    }
+
+    uint8_t* data() noexcept
+    {
+        return (uint8_t*)data_;
+    }
+
+    uint32_t size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    allocator_options_t* alloc_opts_;
+    void* data_;
+    uint32_t size_;
+};
+
+/**
+ * \brief Serialization front end shared by all backends.
+ *
+ * Derived must provide put() and get() overloads for each primitive type:
+ * the integer types, std::string, and std::vector<uint8_t> as a data packet.
+ * Aggregate structs with a \ref ssock_fields specialization are expanded here,
+ * at compile time, into a sequence of calls on their members.
+ */
+template <typename Derived>
+class ssock_serializer
+{
+public:
+    /**
+     * \brief Write a value.
+     *
+     * \returns a status code indicating success or failure.
+     *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+     *      - the status code of the first field which failed to write.
+     */
+    template <typename T>
+    int write(const T& val)
+    {
+        return write_dispatch(val, ssock_has_fields<T>());
+    }
+
+    /**
+     * \brief Read a value.
+     *
+     * \returns a status code indicating success or failure.
+     *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+     *      - the status code of the first field which failed to read.
+     */
+    template <typename T>
+    int read(T& val)
+    {
+        return read_dispatch(val, ssock_has_fields<T>());
+    }
+
+private:
+    Derived& self()
+    {
+        return *static_cast<Derived*>(this);
+    }
+
+    template <typename T>
+    int write_dispatch(const T& val, std::false_type)
+    {
+        return self().put(val);
+    }
+
+    template <typename T>
+    int read_dispatch(T& val, std::false_type)
+    {
+        return self().get(val);
+    }
+
+    template <typename T>
+    int write_dispatch(const T& val, std::true_type)
+    {
+        auto fields = ssock_fields<T>::get();
+
+        return write_fields(
+            val, fields,
+            std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+    }
+
+    template <typename T>
+    int read_dispatch(T& val, std::true_type)
+    {
+        auto fields = ssock_fields<T>::get();
+
+        return read_fields(
+            val, fields,
+            std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+    }
+
+    template <typename T, typename Fields, size_t... I>
+    int write_fields(const T& val, const Fields& fields, std::index_sequence<I...>)
+    {
+        int retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+        /* write each field in order, stopping at the first failure. */
+        int expand[] = { 0,
+            (retval = (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+                ? write(val.*std::get<I>(fields)) : retval, 0)... };
+        (void)expand;
+
+        return retval;
+    }
+
+    template <typename T, typename Fields, size_t... I>
+    int read_fields(T& val, const Fields& fields, std::index_sequence<I...>)
+    {
+        int retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+        /* read each field in order, stopping at the first failure. */
+        int expand[] = { 0,
+            (retval = (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+                ? read(val.*std::get<I>(fields)) : retval, 0)... };
+        (void)expand;
+
+        return retval;
+    }
+};
+
+/**
+ * \brief Backend which forwards each value to the C API on a socket.
+ *
+ * This backend does not own the socket.  Every value written or read passes
+ * through the socket's read / write functions, and so through any filters
+ * attached to it.
+ */
+class ssock_stream : public ssock_serializer<ssock_stream>
+{
+public:
+    ssock_stream(ssock* sock, allocator_options_t* alloc_opts) noexcept
+        : sock_(sock), alloc_opts_(alloc_opts)
+    {
+    }
+
+    ssock* sock() const noexcept
+    {
+        return sock_;
+    }
+
+    int put(uint8_t val) { return ssock_write_uint8(sock_, val); }
+    int put(int8_t val) { return ssock_write_int8(sock_, val); }
+    int put(uint32_t val) { return ssock_write_uint32(sock_, val); }
+    int put(int32_t val) { return ssock_write_int32(sock_, val); }
+    int put(uint64_t val) { return ssock_write_uint64(sock_, val); }
+    int put(int64_t val) { return ssock_write_int64(sock_, val); }
+
+    int put(const std::string& val)
+    {
+        if (val.size() > UINT32_MAX)
+        {
+            return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+        }
+
+        /* write by length, so a string holding a NUL is not cut short. */
+        uint32_t size = (uint32_t)val.size();
+        uint8_t hdr[SSOCK_PACKET_HEADER_SIZE] = {
+            SSOCK_DATA_TYPE_STRING, (uint8_t)(size >> 24),
+            (uint8_t)(size >> 16), (uint8_t)(size >> 8), (uint8_t)size };
+        ssock_iovec iov[2] = {
+            { hdr, sizeof(hdr) },
+            { val.data(), val.size() } };
+        size_t write_size = 0;
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_writev(sock_, iov, 2, &write_size) || sizeof(hdr) + val.size() != write_size)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        }
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    int put(const std::vector<uint8_t>& val)
+    {
+        return ssock_write_data(sock_, val.data(), (uint32_t)val.size());
+    }
+
+    int put(const ssock_buffer& val)
+    {
+        return ssock_write_data(sock_, val.data(), val.size());
+    }
+
+    int get(uint8_t& val) { return ssock_read_uint8(sock_, &val); }
+    int get(int8_t& val) { return ssock_read_int8(sock_, &val); }
+    int get(uint32_t& val) { return ssock_read_uint32(sock_, &val); }
+    int get(int32_t& val) { return ssock_read_int32(sock_, &val); }
+    int get(uint64_t& val) { return ssock_read_uint64(sock_, &val); }
+    int get(int64_t& val) { return ssock_read_int64(sock_, &val); }
+
+    int get(std::string& val)
+    {
+        char* str = nullptr;
+
+        int retval = ssock_read_string(sock_, alloc_opts_, &str);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        val.assign(str);
+        release(alloc_opts_, str);
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    int get(ssock_buffer& val)
+    {
+        void* data = nullptr;
+        uint32_t size = 0U;
+
+        int retval = ssock_read_data(sock_, alloc_opts_, &data, &size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        val = ssock_buffer(alloc_opts_, data, size);
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    int get(std::vector<uint8_t>& val)
+    {
+        ssock_buffer buf;
+
+        int retval = get(buf);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        val.assign(buf.data(), buf.data() + buf.size());
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+private:
+    ssock* sock_;
+    allocator_options_t* alloc_opts_;
+};
+
+/**
+ * \brief Backend which encodes values inline into a memory buffer.
+ *
+ * The encoding is identical to the C API, so a buffer built here can be sent
+ * as raw bytes with \ref ssock_write, or wrapped in a single data packet with
+ * send().
+ */
+class ssock_memory_writer : public ssock_serializer<ssock_memory_writer>
+{
+public:
+    const std::vector<uint8_t>& buffer() const noexcept
+    {
+        return buf_;
+    }
+
+    void clear() noexcept
+    {
+        buf_.clear();
+    }
+
+    /**
+     * \brief Send the encoded values as one data packet, then clear them.
+     *
+     * \returns the status of \ref ssock_write_data.
+     */
+    int send(ssock* sock)
+    {
+        int retval = ssock_write_data(sock, buf_.data(), (uint32_t)buf_.size());
+        buf_.clear();
+
+        return retval;
+    }
+
+    int put(uint8_t val) { return put_int(SSOCK_DATA_TYPE_UINT8, val); }
+    int put(int8_t val) { return put_int(SSOCK_DATA_TYPE_INT8, val); }
+    int put(uint32_t val) { return put_int(SSOCK_DATA_TYPE_UINT32, val); }
+    int put(int32_t val) { return put_int(SSOCK_DATA_TYPE_INT32, val); }
+    int put(uint64_t val) { return put_int(SSOCK_DATA_TYPE_UINT64, val); }
+    int put(int64_t val) { return put_int(SSOCK_DATA_TYPE_INT64, val); }
+
+    int put(const std::string& val)
+    {
+        return put_bytes(SSOCK_DATA_TYPE_STRING, val.data(), val.size());
+    }
+
+    int put(const std::vector<uint8_t>& val)
+    {
+        return put_bytes(SSOCK_DATA_TYPE_DATA_PACKET, val.data(), val.size());
+    }
+
+    int put(const ssock_buffer& val)
+    {
+        return put_bytes(SSOCK_DATA_TYPE_DATA_PACKET, val.data(), val.size());
+    }
+
+private:
+    void put_header(uint8_t type, uint32_t size)
+    {
+        uint8_t hdr[SSOCK_PACKET_HEADER_SIZE] = {
+            type, (uint8_t)(size >> 24), (uint8_t)(size >> 16),
+            (uint8_t)(size >> 8), (uint8_t)size };
+
+        buf_.insert(buf_.end(), hdr, hdr + sizeof(hdr));
+    }
+
+    template <typename T>
+    int put_int(uint8_t type, T val)
+    {
+        typedef typename std::make_unsigned<T>::type U;
+        U uval = (U)val;
+
+        put_header(type, sizeof(T));
+
+        /* encode in network byte order. */
+        for (size_t i = sizeof(T); i > 0; --i)
+        {
+            buf_.push_back((uint8_t)(uval >> (8 * (i - 1))));
+        }
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    int put_bytes(uint8_t type, const void* val, size_t size)
+    {
+        if (size > UINT32_MAX)
+        {
+            return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+        }
+
+        const uint8_t* in = (const uint8_t*)val;
+        put_header(type, (uint32_t)size);
+        buf_.insert(buf_.end(), in, in + size);
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    std::vector<uint8_t> buf_;
+};
+
+/**
+ * \brief Backend which decodes values inline from a memory buffer.
+ *
+ * The buffer is not owned, and must outlive this reader.  Type and size
+ * checks match the C API, and return the same status codes.
+ */
+class ssock_memory_reader : public ssock_serializer<ssock_memory_reader>
+{
+public:
+    ssock_memory_reader(const void* data, size_t size) noexcept
+        : pos_((const uint8_t*)data), end_((const uint8_t*)data + size)
+    {
+    }
+
+    explicit ssock_memory_reader(const ssock_buffer& buf) noexcept
+        : pos_(buf.data()), end_(buf.data() + buf.size())
+    {
+    }
+
+    /**
+     * \brief The number of bytes not yet decoded.
+     */
+    size_t remaining() const noexcept
+    {
+        return end_ - pos_;
+    }
+
+    int get(uint8_t& val) { return get_int(SSOCK_DATA_TYPE_UINT8, val); }
+    int get(int8_t& val) { return get_int(SSOCK_DATA_TYPE_INT8, val); }
+    int get(uint32_t& val) { return get_int(SSOCK_DATA_TYPE_UINT32, val); }
+    int get(int32_t& val) { return get_int(SSOCK_DATA_TYPE_INT32, val); }
+    int get(uint64_t& val) { return get_int(SSOCK_DATA_TYPE_UINT64, val); }
+    int get(int64_t& val) { return get_int(SSOCK_DATA_TYPE_INT64, val); }
+
+    int get(std::string& val)
+    {
+        uint32_t size = 0U;
+
+        int retval = get_header(SSOCK_DATA_TYPE_STRING, size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        val.assign((const char*)pos_, size);
+        pos_ += size;
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    int get(std::vector<uint8_t>& val)
+    {
+        uint32_t size = 0U;
+
+        int retval = get_header(SSOCK_DATA_TYPE_DATA_PACKET, size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        val.assign(pos_, pos_ + size);
+        pos_ += size;
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+private:
+    /**
+     * \brief Decode a header, verifying its type and that the payload fits in
+     * the remaining buffer.
+     */
+    int get_header(uint8_t type, uint32_t& size)
+    {
+        if (remaining() < SSOCK_PACKET_HEADER_SIZE)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+
+        if (type != pos_[0])
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+        }
+
+        size = ((uint32_t)pos_[1] << 24) | ((uint32_t)pos_[2] << 16)
+             | ((uint32_t)pos_[3] << 8) | (uint32_t)pos_[4];
+
+        if (size > remaining() - SSOCK_PACKET_HEADER_SIZE)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+
+        pos_ += SSOCK_PACKET_HEADER_SIZE;
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    template <typename T>
+    int get_int(uint8_t type, T& val)
+    {
+        typedef typename std::make_unsigned<T>::type U;
+        uint32_t size = 0U;
+        U uval = 0U;
+
+        int retval = get_header(type, size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        if (sizeof(T) != size)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+        }
+
+        /* decode from network byte order. */
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            uval = (U)((uval << 8) | pos_[i]);
+        }
+
+        pos_ += sizeof(T);
+        val = (T)uval;
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    const uint8_t* pos_;
+    const uint8_t* end_;
+};
+
+/**
+ * \brief Write a value as a single data packet.
+ *
+ * The value is encoded inline into memory, then sent with one call to
+ * \ref ssock_write_data, so it may be compressed or filtered as a unit.
+ */
+template <typename T>
+int ssock_write_message(ssock* sock, const T& val)
+{
+    ssock_memory_writer writer;
+
+    int retval = writer.write(val);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    return writer.send(sock);
+}
+
+/**
+ * \brief Read a value written by \ref ssock_write_message.
+ *
+ * The packet is read with one call to \ref ssock_read_data and decoded inline.
+ * The whole packet must be consumed by the value.
+ */
+template <typename T>
+int ssock_read_message(ssock* sock, allocator_options_t* alloc_opts, T& val)
+{
+    ssock_buffer buf;
+    ssock_stream stream(sock, alloc_opts);
+
+    int retval = stream.read(buf);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    ssock_memory_reader reader(buf);
+    retval = reader.read(val);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (0 != reader.remaining())
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+} /* namespace vcblockchain */
+
+#endif /*VCBLOCKCHAIN_SSOCK_HPP_HEADER_GUARD*/
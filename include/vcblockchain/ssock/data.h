@@ -10,6 +10,8 @@
 #define VCBLOCKCHAIN_SSOCK_DATA_HEADER_GUARD
 
 #include <stddef.h>
+#include <stdint.h>
+#include <vpr/allocator.h>
 #include <vpr/disposable.h>
 
 /* make this header C++ friendly. */
@@ -30,9 +32,29 @@ typedef struct ssock ssock;
 #define SSOCK_DATA_TYPE_INT64 0x0B
 #define SSOCK_DATA_TYPE_STRING 0x10
 #define SSOCK_DATA_TYPE_DATA_PACKET 0x20
+#define SSOCK_DATA_TYPE_DATA_STREAM 0x21
+#define SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET 0x22
+#define SSOCK_DATA_TYPE_CRC_DATA_PACKET 0x23
 #define SSOCK_DATA_TYPE_AUTHED_PACKET 0x30
 #define SSOCK_DATA_TYPE_EOM 0xFF
 
+/* size of the packet header: a one byte type and a four byte size. */
+#define SSOCK_PACKET_HEADER_SIZE 5
+
+/* size of the trailing checksum of a checksummed data packet. */
+#define SSOCK_CRC_SIZE 4
+
+/* default maximum string size: 10 MB. */
+#define SSOCK_DEFAULT_MAX_STRING_SIZE (10 * 1024 * 1024)
+
+/* read allocation modes. */
+#define SSOCK_READ_ALLOC_UPFRONT 0x00
+#define SSOCK_READ_ALLOC_GROW 0x01
+
+/* compression codecs, as a bitmask for negotiation. */
+#define SSOCK_COMPRESSION_NONE 0x00
+#define SSOCK_COMPRESSION_LZ 0x01
+
 /**
  * \brief Read method for ssock.
  *
@@ -63,6 +85,162 @@ typedef int (*ssock_read_fn)(ssock* sock, void* buf, size_t* size);
  */
 typedef int (*ssock_write_fn)(ssock* sock, const void* buf, size_t* size);
 
+/**
+ * \brief A buffer to be written as part of a gathered write.
+ */
+typedef struct ssock_iovec
+{
+    /** \brief the bytes to write. */
+    const void* base;
+
+    /** \brief the number of bytes to write. */
+    size_t size;
+} ssock_iovec;
+
+/**
+ * \brief Gathered write method for ssock.
+ *
+ * \param sock      The ssock instance to write to.
+ * \param iov       The array of buffers to write, in order.
+ * \param iovcnt    The number of buffers in this array.
+ * \param size      Pointer to receive the total number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef int (*ssock_writev_fn)(
+    ssock* sock, const ssock_iovec* iov, size_t iovcnt, size_t* size);
+
+/**
+ * \brief Flush method for ssock.
+ *
+ * \param sock      The ssock instance to flush.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef int (*ssock_flush_fn)(ssock* sock);
+
+/**
+ * \brief Shutdown method for ssock.
+ *
+ * \param sock      The ssock instance to shut down.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+typedef int (*ssock_shutdown_fn)(ssock* sock);
+
+/**
+ * \brief Chunk callback for streaming data reads.
+ *
+ * \param context   The user context passed to the streaming read.
+ * \param chunk     The bytes received in this chunk.  This buffer is only
+ *                  valid for the duration of the callback.
+ * \param size      The number of bytes in this chunk.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS to continue reading.
+ *      - a non-zero error code to abort the read; this code is returned to the
+ *        caller of the streaming read.
+ */
+typedef int (*ssock_data_chunk_fn)(
+    void* context, const void* chunk, size_t size);
+
+/**
+ * \brief Read policy for an ssock instance.
+ *
+ * The read policy bounds the payload sizes that a peer may send, and controls
+ * how payload buffers are allocated.  A zeroed policy selects the defaults for
+ * each field.
+ */
+typedef struct ssock_read_policy
+{
+    /** \brief maximum string size; 0 selects the default of 10 MB. */
+    uint32_t max_string_size;
+
+    /** \brief maximum data packet size; 0 selects no limit. */
+    uint32_t max_data_size;
+
+    /**
+     * \brief the allocation mode for payloads.
+     *
+     * With SSOCK_READ_ALLOC_UPFRONT, the whole payload size claimed by the peer
+     * is allocated before any payload bytes are read.  With
+     * SSOCK_READ_ALLOC_GROW, the buffer starts at \ref grow_initial_size and
+     * doubles as payload bytes arrive, so memory use tracks received data
+     * instead of claimed data.
+     */
+    uint8_t alloc_mode;
+
+    /** \brief initial buffer size in grow mode; 0 selects 64 KB. */
+    uint32_t grow_initial_size;
+} ssock_read_policy;
+
+/**
+ * \brief Byte, call, and compression counters, as maintained by
+ * \ref ssock_stats_filter_init().
+ *
+ * The compression ratio is compress_bytes_in / compress_bytes_out, and the
+ * compression cost is compress_nanoseconds per compress_bytes_in.
+ */
+typedef struct ssock_stats
+{
+    /** \brief the number of bytes read. */
+    uint64_t bytes_read;
+
+    /** \brief the number of bytes written. */
+    uint64_t bytes_written;
+
+    /** \brief the number of read calls made on the inner socket. */
+    uint64_t read_calls;
+
+    /** \brief the number of write calls made on the inner socket. */
+    uint64_t write_calls;
+
+    /** \brief the number of data packets sent compressed. */
+    uint64_t compressed_packets;
+
+    /** \brief the uncompressed size of data packets sent compressed. */
+    uint64_t compress_bytes_in;
+
+    /** \brief the compressed size of data packets sent compressed. */
+    uint64_t compress_bytes_out;
+
+    /** \brief time spent compressing, in nanoseconds. */
+    uint64_t compress_nanoseconds;
+
+    /** \brief the compressed size of compressed data packets received. */
+    uint64_t decompress_bytes_in;
+
+    /** \brief the decompressed size of compressed data packets received. */
+    uint64_t decompress_bytes_out;
+
+    /** \brief time spent decompressing, in nanoseconds. */
+    uint64_t decompress_nanoseconds;
+} ssock_stats;
+
+/**
+ * \brief Data packet compression settings for an ssock instance.
+ *
+ * These settings are filled in by \ref ssock_negotiate_compression().  A zeroed
+ * structure disables compression.
+ */
+typedef struct ssock_compression
+{
+    /** \brief the negotiated codec, or SSOCK_COMPRESSION_NONE. */
+    uint8_t codec;
+
+    /** \brief smallest data packet to compress; 0 selects 512 bytes. */
+    uint32_t threshold;
+
+    /** \brief allocator for compression scratch buffers. */
+    allocator_options_t* alloc_opts;
+} ssock_compression;
+
 /**
  * \brief The ssock abstraction provides a read and write method for reading
  * from or writing to a socket.
@@ -78,10 +256,66 @@ struct ssock
     /** \brief read method for ssock. */
     ssock_write_fn write;
 
+    /**
+     * \brief optional gathered write method for ssock; NULL to write each
+     * buffer in turn.
+     */
+    ssock_writev_fn writev;
+
+    /** \brief optional flush method for ssock; NULL if unbuffered. */
+    ssock_flush_fn flush;
+
+    /**
+     * \brief optional shutdown method for ssock; NULL if blocked calls can't
+     * be woken.
+     */
+    ssock_shutdown_fn shutdown;
+
     /** \brief context for ssock. */
     void* context;
+
+    /** \brief the wrapped ssock, if this ssock is a filter. */
+    ssock* inner;
+
+    /** \brief read policy for ssock. */
+    ssock_read_policy read_policy;
+
+    /** \brief data packet compression settings for ssock. */
+    ssock_compression compression;
+
+    /** \brief optional statistics for ssock; NULL if not collected. */
+    ssock_stats* stats;
 };
 
+/**
+ * \brief A tagged packet value, as read by \ref ssock_read_any().
+ *
+ * The \ref type field determines which member of \ref val is valid.  For
+ * string and data packets, the value is allocated using the allocator passed
+ * to \ref ssock_read_any() and must be released by the caller.
+ */
+typedef struct ssock_value
+{
+    /** \brief the packet type, as one of the SSOCK_DATA_TYPE_* values. */
+    uint8_t type;
+
+    /** \brief the size of the packet payload. */
+    uint32_t size;
+
+    /** \brief the packet payload. */
+    union
+    {
+        uint8_t uint8_val;
+        int8_t int8_val;
+        uint32_t uint32_val;
+        int32_t int32_val;
+        uint64_t uint64_val;
+        int64_t int64_val;
+        char* string_val;
+        void* data_val;
+    } val;
+} ssock_value;
+
 /* make this header C++ friendly. */
 #ifdef __cplusplus
 }
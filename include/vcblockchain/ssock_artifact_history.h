@@ -0,0 +1,114 @@
+/**
+ * \file vcblockchain/ssock_artifact_history.h
+ *
+ * \brief Artifact history queries over ssock.
+ *
+ * A client asks for the history of an artifact, from a given sequence and up
+ * to a given number of transactions.  The server pages through the history in
+ * the \ref block_store, and writes each page as a chunk of one data stream
+ * packet, followed by a status.  The client reassembles the transaction ids
+ * and hands them to a callback a page at a time, so neither side holds more
+ * than a page of the history in memory.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_ARTIFACT_HISTORY_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_ARTIFACT_HISTORY_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/block_store.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+#include <vpr/allocator.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The number of transaction ids in a page.
+ */
+#define SSOCK_ARTIFACT_HISTORY_PAGE_SIZE 256
+
+/**
+ * \brief Receive a page of an artifact's history.
+ *
+ * \param context       The user context passed to the query.
+ * \param txn_ids       The transaction ids in this page, in sequence order,
+ *                      each BLOCK_STORE_ID_SIZE bytes.  This buffer is only
+ *                      valid for the duration of the callback.
+ * \param count         The number of transaction ids in this page.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS to continue reading.
+ *      - a non-zero error code to abort the query; this code is returned to
+ *        the caller of the query.
+ */
+typedef int (*ssock_artifact_history_page_fn)(
+    void* context, const uint8_t* txn_ids, size_t count);
+
+/**
+ * \brief Query the history of an artifact.
+ *
+ * The request is written, then the response is read and passed to the
+ * callback a page at a time, with at most SSOCK_ARTIFACT_HISTORY_PAGE_SIZE
+ * ids per page.  If the callback aborts the query, the rest of the response
+ * is left unread, so the socket must be closed.
+ *
+ * \param sock          The socket connected to the server.
+ * \param artifact_id   The id of the artifact.
+ * \param start         The sequence of the first transaction to read.
+ * \param limit         The most transactions to read, or 0 for all of them.
+ * \param onpage        The callback to receive each page.
+ * \param context       The user context to pass to the callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the server sent
+ *        a malformed response.
+ *      - the non-zero status reported by the server, if its read failed.
+ *      - the non-zero status returned by the callback, if it aborts the query.
+ */
+int ssock_artifact_history_query(
+    ssock* sock, const uint8_t* artifact_id, uint64_t start, uint64_t limit,
+    ssock_artifact_history_page_fn onpage, void* context);
+
+/**
+ * \brief Serve one artifact history query.
+ *
+ * The request is read, then the history is read from the store a page at a
+ * time and written to the socket as it is read.  A failure reading the store
+ * ends the stream early, and is reported to the client in the status.
+ *
+ * \param sock          The socket connected to the client.
+ * \param alloc_opts    The allocator to use for reading the request.
+ * \param store         The store to read the history from.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when the failure
+ *        of a store read was reported to the client.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the client sent
+ *        a malformed request.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_artifact_history_serve(
+    ssock* sock, allocator_options_t* alloc_opts, block_store* store);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_ARTIFACT_HISTORY_HEADER_GUARD*/
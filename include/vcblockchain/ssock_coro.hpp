@@ -0,0 +1,858 @@
+/**
+ * \file vcblockchain/ssock_coro.hpp
+ *
+ * \brief C++20 coroutine awaitables for typed ssock reads and writes.
+ *
+ * This header provides a single-threaded epoll reactor, a lazy coroutine task
+ * type, and \ref ssock_async, a non-blocking socket whose typed read<T> and
+ * write<T> operations can be co_awaited.  Each session is a coroutine, so many
+ * thousands of sessions can run on one thread without callbacks.
+ *
+ * \code
+ * ssock_task<void> echo(ssock_reactor& reactor, int sd, allocator_options_t* a)
+ * {
+ *     ssock_async sock(reactor, sd, a);
+ *     std::string msg;
+ *     while (VCBLOCKCHAIN_STATUS_SUCCESS == co_await sock.read(msg))
+ *         co_await sock.write(msg);
+ * }
+ *
+ * reactor.spawn(echo(reactor, sd, &alloc_opts));
+ * reactor.run();
+ * \endcode
+ *
+ * Packets are framed asynchronously, then decoded by the C API, so the wire
+ * format, read policy, compression, and checksums all match \ref ssock.
+ *
+ * This header requires C++20 and Linux.  It is enabled in the meson build with
+ * the cpp20_coroutines option.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_CORO_HPP_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_CORO_HPP_HEADER_GUARD
+
+#if !defined(__cpp_impl_coroutine)
+#error This header requires C++20 coroutine support.
+#endif /*__cpp_impl_coroutine*/
+
+#include <cerrno>
+#include <coroutine>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vcblockchain/ssock.hpp>
+#include <vector>
+
+namespace vcblockchain {
+
+template <typename T = void>
+class ssock_task;
+
+namespace detail {
+
+/**
+ * \brief Promise state shared by all task types.
+ *
+ * Tasks start suspended, and resume their awaiter when they complete.
+ */
+struct ssock_task_promise_base
+{
+    struct final_awaiter
+    {
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<P> h) noexcept
+        {
+            std::coroutine_handle<> next = h.promise().continuation;
+
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept
+        {
+        }
+    };
+
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    final_awaiter final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        std::terminate();
+    }
+
+    std::coroutine_handle<> continuation;
+};
+
+template <typename T>
+struct ssock_task_promise : ssock_task_promise_base
+{
+    ssock_task<T> get_return_object() noexcept;
+
+    void return_value(T val) noexcept
+    {
+        value = std::move(val);
+    }
+
+    T value{};
+};
+
+template <>
+struct ssock_task_promise<void> : ssock_task_promise_base
+{
+    ssock_task<void> get_return_object() noexcept;
+
+    void return_void() noexcept
+    {
+    }
+};
+
+/**
+ * \brief Fire-and-forget coroutine used to run a spawned task.
+ */
+struct ssock_detached
+{
+    struct promise_type
+    {
+        ssock_detached get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+
+} /* namespace detail */
+
+/**
+ * \brief A lazily started coroutine which produces a T.
+ *
+ * A task runs when it is co_awaited, and resumes its awaiter when it
+ * completes.  Tasks are movable but not copyable.
+ */
+template <typename T>
+class ssock_task
+{
+public:
+    typedef detail::ssock_task_promise<T> promise_type;
+    typedef std::coroutine_handle<promise_type> handle_type;
+
+    explicit ssock_task(handle_type h) noexcept
+        : h_(h)
+    {
+    }
+
+    ssock_task(ssock_task&& other) noexcept
+        : h_(std::exchange(other.h_, nullptr))
+    {
+    }
+
+    ssock_task& operator=(ssock_task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (h_)
+            {
+                h_.destroy();
+            }
+
+            h_ = std::exchange(other.h_, nullptr);
+        }
+
+        return *this;
+    }
+
+    ssock_task(const ssock_task&) = delete;
+    ssock_task& operator=(const ssock_task&) = delete;
+
+    ~ssock_task()
+    {
+        if (h_)
+        {
+            h_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return !h_ || h_.done();
+    }
+
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> awaiter) noexcept
+    {
+        h_.promise().continuation = awaiter;
+
+        return h_;
+    }
+
+    T await_resume() noexcept
+    {
+        if constexpr (!std::is_void_v<T>)
+        {
+            return std::move(h_.promise().value);
+        }
+    }
+
+private:
+    handle_type h_;
+};
+
+template <typename T>
+ssock_task<T> detail::ssock_task_promise<T>::get_return_object() noexcept
+{
+    return ssock_task<T>(
+        std::coroutine_handle<ssock_task_promise<T>>::from_promise(*this));
+}
+
+inline ssock_task<void>
+detail::ssock_task_promise<void>::get_return_object() noexcept
+{
+    return ssock_task<void>(
+        std::coroutine_handle<ssock_task_promise<void>>::from_promise(*this));
+}
+
+/**
+ * \brief Single-threaded epoll reactor.
+ *
+ * Descriptors are registered once, edge-triggered, for both directions.  A
+ * coroutine attempts its I/O first, and only parks on the reactor when the
+ * descriptor would block, so no readiness change is ever missed.  All methods
+ * must be called from the thread running the reactor.
+ */
+class ssock_reactor
+{
+public:
+    ssock_reactor() noexcept
+        : epfd_(epoll_create1(EPOLL_CLOEXEC)), live_(0U), stopped_(false)
+    {
+    }
+
+    ssock_reactor(const ssock_reactor&) = delete;
+    ssock_reactor& operator=(const ssock_reactor&) = delete;
+
+    ~ssock_reactor()
+    {
+        if (epfd_ >= 0)
+        {
+            close(epfd_);
+        }
+    }
+
+    /**
+     * \brief Returns true if the epoll instance was created.
+     */
+    bool valid() const noexcept
+    {
+        return epfd_ >= 0;
+    }
+
+    /**
+     * \brief Register a non-blocking descriptor with this reactor.
+     *
+     * \returns VCBLOCKCHAIN_STATUS_SUCCESS on success, or
+     *          VCBLOCKCHAIN_ERROR_INVALID_ARG if it could not be registered.
+     */
+    int add(int fd) noexcept
+    {
+        epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+
+        if (0 != epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev))
+        {
+            return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+        }
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    /**
+     * \brief Remove a descriptor from this reactor.  No coroutine may be
+     * parked on it.
+     */
+    void remove(int fd) noexcept
+    {
+        epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+        waiters_.erase(fd);
+    }
+
+    /**
+     * \brief Awaitable which resumes when a descriptor may be ready.
+     */
+    struct io_awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            waiter_slot& slot = reactor->waiters_[fd];
+
+            (write ? slot.writer : slot.reader) = h;
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+
+        ssock_reactor* reactor;
+        int fd;
+        bool write;
+    };
+
+    io_awaiter readable(int fd) noexcept
+    {
+        return io_awaiter{ this, fd, false };
+    }
+
+    io_awaiter writable(int fd) noexcept
+    {
+        return io_awaiter{ this, fd, true };
+    }
+
+    /**
+     * \brief Start a task, which runs until its first suspension point.
+     *
+     * The reactor runs until every spawned task has completed.
+     */
+    void spawn(ssock_task<void> task)
+    {
+        ++live_;
+        run_detached(this, std::move(task));
+    }
+
+    /**
+     * \brief Run the event loop until all spawned tasks complete, or until
+     * \ref stop() is called.
+     *
+     * \returns VCBLOCKCHAIN_STATUS_SUCCESS on success, or
+     *          VCBLOCKCHAIN_ERROR_SSOCK_READ if waiting for events failed.
+     */
+    int run()
+    {
+        epoll_event events[64];
+
+        stopped_ = false;
+        while (!stopped_ && live_ > 0)
+        {
+            int count = epoll_wait(epfd_, events, 64, -1);
+            if (count < 0)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+
+                return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                int fd = events[i].data.fd;
+                uint32_t mask = events[i].events;
+                uint32_t err = EPOLLERR | EPOLLHUP;
+
+                /* resuming the reader may close the descriptor, so look up
+                 * the writer again afterward. */
+                if (mask & (EPOLLIN | EPOLLRDHUP | err))
+                {
+                    resume(fd, false);
+                }
+
+                if (mask & (EPOLLOUT | err))
+                {
+                    resume(fd, true);
+                }
+            }
+        }
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    /**
+     * \brief Stop the event loop after the current batch of events.
+     */
+    void stop() noexcept
+    {
+        stopped_ = true;
+    }
+
+private:
+    struct waiter_slot
+    {
+        std::coroutine_handle<> reader;
+        std::coroutine_handle<> writer;
+    };
+
+    void resume(int fd, bool write)
+    {
+        auto it = waiters_.find(fd);
+        if (waiters_.end() == it)
+        {
+            return;
+        }
+
+        std::coroutine_handle<>& slot =
+            write ? it->second.writer : it->second.reader;
+        std::coroutine_handle<> h = std::exchange(slot, nullptr);
+
+        if (h)
+        {
+            h.resume();
+        }
+    }
+
+    static detail::ssock_detached run_detached(
+        ssock_reactor* reactor, ssock_task<void> task)
+    {
+        co_await task;
+        --reactor->live_;
+    }
+
+    int epfd_;
+    size_t live_;
+    bool stopped_;
+    std::unordered_map<int, waiter_slot> waiters_;
+};
+
+/**
+ * \brief A non-blocking socket with co_await-able typed reads and writes.
+ *
+ * This instance takes over ownership of the socket descriptor, and closes it
+ * when destroyed.  Values are encoded by the C API into memory and sent
+ * asynchronously; packets are received asynchronously and decoded by the C
+ * API from memory.  The codec() socket carries the read policy and the
+ * negotiated compression used for this encoding and decoding.
+ *
+ * At most one read and one write may be outstanding at a time.
+ */
+class ssock_async
+{
+public:
+    ssock_async(
+        ssock_reactor& reactor, int fd, allocator_options_t* alloc_opts)
+        : reactor_(reactor), fd_(fd), alloc_opts_(alloc_opts), status_(0)
+        , rpos_(0U), in_pos_(0U), in_end_(0U)
+    {
+        memset(&codec_, 0, sizeof(codec_));
+        codec_.hdr.dispose = &codec_dispose;
+        codec_.read = &codec_read;
+        codec_.write = &codec_write;
+        codec_.context = this;
+
+        int flags = fcntl(fd_, F_GETFL, 0);
+        if (flags < 0 || 0 != fcntl(fd_, F_SETFL, flags | O_NONBLOCK))
+        {
+            status_ = VCBLOCKCHAIN_ERROR_INVALID_ARG;
+            return;
+        }
+
+        status_ = reactor_.add(fd_);
+        in_.resize(IN_BUFFER_SIZE);
+    }
+
+    ssock_async(const ssock_async&) = delete;
+    ssock_async& operator=(const ssock_async&) = delete;
+
+    ~ssock_async()
+    {
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status_)
+        {
+            reactor_.remove(fd_);
+        }
+
+        close(fd_);
+    }
+
+    /**
+     * \brief The status of construction; operations fail if it is not
+     * VCBLOCKCHAIN_STATUS_SUCCESS.
+     */
+    int status() const noexcept
+    {
+        return status_;
+    }
+
+    /**
+     * \brief The in-memory socket used for encoding and decoding.  Set its
+     * read_policy and compression fields to configure this socket.
+     */
+    ssock* codec() noexcept
+    {
+        return &codec_;
+    }
+
+    /**
+     * \brief Write a value, which may be any type supported by
+     * \ref ssock_stream, or a struct with a \ref ssock_fields descriptor.
+     */
+    template <typename T>
+    ssock_task<int> write(const T& val)
+    {
+        ssock_stream stream(&codec_, alloc_opts_);
+
+        wbuf_.clear();
+        int retval = stream.write(val);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            co_return retval;
+        }
+
+        co_return co_await write_bytes(wbuf_.data(), wbuf_.size());
+    }
+
+    /**
+     * \brief Read a value written by write() or by the matching C API.
+     */
+    template <typename T>
+    ssock_task<int> read(T& val)
+    {
+        if constexpr (ssock_has_fields<T>::value)
+        {
+            auto fields = ssock_fields<T>::get();
+
+            co_return co_await read_fields(
+                val, fields,
+                std::make_index_sequence<
+                    std::tuple_size<decltype(fields)>::value>());
+        }
+        else
+        {
+            int retval = co_await read_frame(rframe_);
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            {
+                co_return retval;
+            }
+
+            ssock_stream stream(&codec_, alloc_opts_);
+            rpos_ = 0U;
+
+            co_return stream.read(val);
+        }
+    }
+
+    /**
+     * \brief Write raw bytes, waiting while the socket would block.
+     */
+    ssock_task<int> write_bytes(const void* buf, size_t size)
+    {
+        const uint8_t* out = (const uint8_t*)buf;
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != status_)
+        {
+            co_return status_;
+        }
+
+        while (size > 0)
+        {
+            ssize_t sent = send(fd_, out, size, MSG_NOSIGNAL);
+            if (sent > 0)
+            {
+                out += sent;
+                size -= sent;
+            }
+            else if (sent < 0 && (EAGAIN == errno || EWOULDBLOCK == errno))
+            {
+                co_await reactor_.writable(fd_);
+            }
+            else if (sent < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            else
+            {
+                co_return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+            }
+        }
+
+        co_return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    /**
+     * \brief Read one complete packet, header included, into frame.
+     *
+     * The frame grows as bytes arrive, so a large claimed size does not
+     * allocate up front.  Sizes over the read policy are rejected before the
+     * payload is read.  Data streams are not supported.
+     */
+    ssock_task<int> read_frame(std::vector<uint8_t>& frame)
+    {
+        int retval;
+
+        frame.resize(SSOCK_PACKET_HEADER_SIZE);
+        retval = co_await read_exact(frame.data(), SSOCK_PACKET_HEADER_SIZE);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            co_return retval;
+        }
+
+        uint8_t type = frame[0];
+        uint64_t size =
+            ((uint32_t)frame[1] << 24) | ((uint32_t)frame[2] << 16)
+          | ((uint32_t)frame[3] << 8) | (uint32_t)frame[4];
+
+        retval = check_frame(type, size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            co_return retval;
+        }
+
+        /* a checksummed packet has a trailer after the payload. */
+        if (SSOCK_DATA_TYPE_CRC_DATA_PACKET == type)
+        {
+            size += SSOCK_CRC_SIZE;
+        }
+
+        /* grow the frame as the payload arrives. */
+        while (size > 0)
+        {
+            size_t chunk = size < IN_BUFFER_SIZE ? size : IN_BUFFER_SIZE;
+            size_t start = frame.size();
+
+            frame.resize(start + chunk);
+            retval = co_await read_exact(frame.data() + start, chunk);
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            {
+                co_return retval;
+            }
+
+            size -= chunk;
+        }
+
+        co_return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+private:
+    static constexpr size_t IN_BUFFER_SIZE = 16384U;
+
+    template <typename T, typename Fields, size_t... I>
+    ssock_task<int> read_fields(
+        T& val, const Fields& fields, std::index_sequence<I...>)
+    {
+        int retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+        /* read each field in order, stopping at the first failure. */
+        ((retval = (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+            ? co_await read(val.*std::get<I>(fields)) : retval), ...);
+
+        co_return retval;
+    }
+
+    /**
+     * \brief Reject sizes which could never decode or which the read policy
+     * does not allow, applying the same defaults as the C readers.
+     */
+    int check_frame(uint8_t type, uint64_t size) const noexcept
+    {
+        const ssock_read_policy& policy = codec_.read_policy;
+
+        switch (type)
+        {
+            case SSOCK_DATA_TYPE_UINT8:
+            case SSOCK_DATA_TYPE_INT8:
+            case SSOCK_DATA_TYPE_UINT32:
+            case SSOCK_DATA_TYPE_INT32:
+            case SSOCK_DATA_TYPE_UINT64:
+            case SSOCK_DATA_TYPE_INT64:
+                return size <= sizeof(uint64_t)
+                    ? VCBLOCKCHAIN_STATUS_SUCCESS
+                    : VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+
+            case SSOCK_DATA_TYPE_STRING:
+                return size <= (0 == policy.max_string_size
+                        ? SSOCK_DEFAULT_MAX_STRING_SIZE
+                        : policy.max_string_size)
+                    ? VCBLOCKCHAIN_STATUS_SUCCESS
+                    : VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+
+            case SSOCK_DATA_TYPE_DATA_PACKET:
+            case SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET:
+            case SSOCK_DATA_TYPE_CRC_DATA_PACKET:
+                return (0 == policy.max_data_size
+                        || size <= policy.max_data_size)
+                    ? VCBLOCKCHAIN_STATUS_SUCCESS
+                    : VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+
+            default:
+                return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+        }
+    }
+
+    /**
+     * \brief Read exactly size bytes, from the input buffer first, waiting
+     * while the socket would block.
+     */
+    ssock_task<int> read_exact(uint8_t* out, size_t size)
+    {
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != status_)
+        {
+            co_return status_;
+        }
+
+        while (size > 0)
+        {
+            /* drain buffered input. */
+            if (in_pos_ < in_end_)
+            {
+                size_t avail = in_end_ - in_pos_;
+                size_t n = avail < size ? avail : size;
+
+                memcpy(out, in_.data() + in_pos_, n);
+                in_pos_ += n;
+                out += n;
+                size -= n;
+                continue;
+            }
+
+            /* large reads bypass the input buffer. */
+            uint8_t* dest = size >= IN_BUFFER_SIZE ? out : in_.data();
+            size_t want = size >= IN_BUFFER_SIZE ? size : IN_BUFFER_SIZE;
+
+            ssize_t got = ::read(fd_, dest, want);
+            if (got > 0)
+            {
+                if (dest == out)
+                {
+                    out += got;
+                    size -= got;
+                }
+                else
+                {
+                    in_pos_ = 0U;
+                    in_end_ = got;
+                }
+            }
+            else if (got < 0 && (EAGAIN == errno || EWOULDBLOCK == errno))
+            {
+                co_await reactor_.readable(fd_);
+            }
+            else if (got < 0 && EINTR == errno)
+            {
+                continue;
+            }
+            else
+            {
+                co_return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+            }
+        }
+
+        co_return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    static void codec_dispose(void*)
+    {
+    }
+
+    static int codec_read(ssock* sock, void* buf, size_t* size)
+    {
+        ssock_async* self = (ssock_async*)sock->context;
+        size_t avail = self->rframe_.size() - self->rpos_;
+
+        if (*size > avail)
+        {
+            *size = avail;
+        }
+
+        memcpy(buf, self->rframe_.data() + self->rpos_, *size);
+        self->rpos_ += *size;
+
+        return *size > 0
+            ? VCBLOCKCHAIN_STATUS_SUCCESS : VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    static int codec_write(ssock* sock, const void* buf, size_t* size)
+    {
+        ssock_async* self = (ssock_async*)sock->context;
+        const uint8_t* in = (const uint8_t*)buf;
+
+        self->wbuf_.insert(self->wbuf_.end(), in, in + *size);
+
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    ssock_reactor& reactor_;
+    int fd_;
+    allocator_options_t* alloc_opts_;
+    int status_;
+    ssock codec_;
+    std::vector<uint8_t> wbuf_;
+    std::vector<uint8_t> rframe_;
+    size_t rpos_;
+    std::vector<uint8_t> in_;
+    size_t in_pos_;
+    size_t in_end_;
+};
+
+/**
+ * \brief Accept a connection on a non-blocking listen socket registered with
+ * the reactor.
+ *
+ * \returns VCBLOCKCHAIN_STATUS_SUCCESS with *client set on success, or
+ *          VCBLOCKCHAIN_ERROR_SSOCK_READ if accept failed.
+ */
+inline ssock_task<int> ssock_async_accept(
+    ssock_reactor& reactor, int listen_fd, int* client)
+{
+    for (;;)
+    {
+        int sd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (sd >= 0)
+        {
+            *client = sd;
+            co_return VCBLOCKCHAIN_STATUS_SUCCESS;
+        }
+        else if (EAGAIN == errno || EWOULDBLOCK == errno)
+        {
+            co_await reactor.readable(listen_fd);
+        }
+        else if (EINTR != errno && ECONNABORTED != errno)
+        {
+            co_return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+    }
+}
+
+} /* namespace vcblockchain */
+
+#endif /*VCBLOCKCHAIN_SSOCK_CORO_HPP_HEADER_GUARD*/
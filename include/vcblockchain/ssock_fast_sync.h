@@ -0,0 +1,154 @@
+/**
+ * \file vcblockchain/ssock_fast_sync.h
+ *
+ * \brief Bulk block sync over ssock, for bootstrapping a new node.
+ *
+ * A client asks for a range of heights, and the server streams every block in
+ * the range back to back, without waiting for the client between blocks.  The
+ * server walks a \ref block_store cursor over the range a slice at a time, and
+ * writes each block straight from the store's memory map with one gathered
+ * write.
+ *
+ * The client runs a pipeline of three stages: the calling thread reads blocks
+ * from the socket, a second thread verifies them, and a third writes every
+ * verified block it finds waiting to the store in one batch, along with the
+ * transactions each block wraps, so the synced store holds the transaction,
+ * artifact, and artifact history records of the chain too.  Reading,
+ * verification, and storage overlap, so the sync is bound by the slowest
+ * stage rather than by round trips.  Wrapping the client's socket in a
+ * prefetch filter overlaps the reads with parsing as well.
+ *
+ * Each block is sent as a SSOCK_FAST_SYNC_BLOCK marker, its height, its id as
+ * a data packet, and its certificate as a data packet.  The response ends
+ * with a SSOCK_FAST_SYNC_END marker and the status of the server's scan.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_FAST_SYNC_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_FAST_SYNC_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/block_store.h>
+#include <vcblockchain/block_verifier.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+#include <vpr/allocator.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The marker preceding each block in a response.
+ */
+#define SSOCK_FAST_SYNC_BLOCK 0x01
+
+/**
+ * \brief The marker preceding the status which ends a response.
+ */
+#define SSOCK_FAST_SYNC_END 0x02
+
+/**
+ * \brief The height of the first block of a chain, which a pull into an empty
+ * store starts from.
+ */
+#define SSOCK_FAST_SYNC_FIRST_HEIGHT 1
+
+/**
+ * \brief The most blocks a client holds between reading and storing them.
+ */
+#define SSOCK_FAST_SYNC_PIPELINE_DEPTH 64
+
+/**
+ * \brief The most heights a server reads from one snapshot of its store.
+ */
+#define SSOCK_FAST_SYNC_SCAN_SLICE 256
+
+/**
+ * \brief Pull a range of blocks from a server into a store.
+ *
+ * Blocks must arrive within the range at consecutive heights, starting at
+ * the height after the store's tip, or at SSOCK_FAST_SYNC_FIRST_HEIGHT if the
+ * store is empty, so the range should start there too.  Each block is
+ * verified before it is stored, and its own height and id fields must match
+ * the height and id it was sent under.  Its previous block id must match the
+ * block before it, which for the first block is the store's tip; only the
+ * first block of a chain, pulled into an empty store, has nothing to link
+ * to.  On failure, the blocks received and verified before it are still
+ * stored, so a sync can be resumed from the height after the last of them.
+ * If this fails before the server ends its response, the rest of the
+ * response is left unread, so the socket must be closed.
+ *
+ * Blocks are read as data packets, so the read policy of the socket bounds
+ * their size.
+ *
+ * \param sock          The socket connected to the server.
+ * \param alloc_opts    The allocator to use for the blocks in flight.
+ * \param store         The store to write the blocks to.
+ * \param verifier      The verifier to check each block with.
+ * \param start         The lowest height to pull.
+ * \param end           The highest height to pull, or UINT64_MAX to pull
+ *                      everything from start up.
+ * \param count         Pointer to receive the number of blocks stored.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the server sent
+ *        a malformed response.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE if the server sent a block
+ *        outside of the range, out of order, or after a gap, including a gap
+ *        after the store's tip.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH if the server sent a block
+ *        under a height or id other than its own, or a block which does not
+ *        link to the block before it.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD if the pipeline could not be
+ *        started.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_INVALID if a transaction in a block is
+ *        missing its certificate id or artifact id.
+ *      - a failure from \ref block_verifier_verify(),
+ *        \ref block_store_write(), or reading the store's tip.
+ *      - the non-zero status reported by the server, if its scan failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_fast_sync_pull(
+    ssock* sock, allocator_options_t* alloc_opts, block_store* store,
+    block_verifier* verifier, uint64_t start, uint64_t end, uint64_t* count);
+
+/**
+ * \brief Serve one fast sync request.
+ *
+ * The request is read, then every block in the range up to the current tip
+ * is written.  The range is read in slices of SSOCK_FAST_SYNC_SCAN_SLICE
+ * heights, each from its own snapshot of the store, so a slow client never
+ * holds one snapshot open for a whole bootstrap.  A failure reading the
+ * store ends the response early, and is reported to the client in the
+ * status.
+ *
+ * \param sock          The socket connected to the client.
+ * \param store         The store to read the blocks from.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when the failure
+ *        of a store read was reported to the client.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the client sent
+ *        a malformed request.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ */
+int ssock_fast_sync_serve(ssock* sock, block_store* store);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_FAST_SYNC_HEADER_GUARD*/
@@ -0,0 +1,270 @@
+/**
+ * \file vcblockchain/ssock_handshake.h
+ *
+ * \brief Mutual authentication handshake over ssock, with resumption tickets.
+ *
+ * Each peer has a 16-byte id and a long-term key agreement key pair.  A full
+ * handshake runs the suite's key agreement between the client's private key
+ * and the server's public key, and vice versa, mixed with a fresh nonce from
+ * each side; each peer then proves that it derived the same secret, so only
+ * holders of the expected private keys can complete it.
+ *
+ * The server also issues a resumption ticket.  A ticket is opaque to the
+ * client, and carries the resumption secret for the session sealed under a
+ * key known only to the server, so the server keeps no per-client state.  A
+ * reconnecting client presents its ticket, and both sides derive the new
+ * session secret from the resumption secret and fresh nonces, skipping the
+ * public-key operations.  If the ticket is rejected, the server falls back to
+ * a full handshake in the same round trip.
+ *
+ * The resulting shared secret is used with \ref ssock_write_authed_data() and
+ * \ref ssock_read_authed_data().
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_HANDSHAKE_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_HANDSHAKE_HEADER_GUARD
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+#include <vccrypt/suite.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The size of a peer id.
+ */
+#define SSOCK_HANDSHAKE_ID_SIZE 16
+
+/**
+ * \brief The size of the nonce each peer contributes to a handshake.
+ */
+#define SSOCK_HANDSHAKE_NONCE_SIZE 32
+
+/**
+ * \brief The largest handshake field a peer may send.  Fields are read before
+ * the peer is authenticated, so this bounds what an unauthenticated peer can
+ * make us allocate.
+ */
+#define SSOCK_HANDSHAKE_MAX_FIELD_SIZE 1024
+
+/**
+ * \brief A full handshake, using the key agreement.
+ */
+#define SSOCK_HANDSHAKE_MODE_FULL 0x01
+
+/**
+ * \brief A resumed handshake, using a ticket.
+ */
+#define SSOCK_HANDSHAKE_MODE_RESUME 0x02
+
+/**
+ * \brief Look up the public key of a client.
+ *
+ * This may be called from several threads at once.
+ *
+ * \param context       The user context from the server.
+ * \param client_id     The id the client presented.
+ * \param public_key    Pointer to receive the client's key agreement public
+ *                      key, which must remain valid until the handshake ends.
+ *
+ * \returns VCBLOCKCHAIN_STATUS_SUCCESS if the client is known, or any other
+ *          value to reject it.
+ */
+typedef int (*ssock_handshake_key_lookup_fn)(
+    void* context, const uint8_t* client_id,
+    const vccrypt_buffer_t** public_key);
+
+/**
+ * \brief The client side of the handshake.
+ *
+ * A client keeps the most recent ticket from its server, and uses it for the
+ * next handshake.  A client must not be used by two threads at once.
+ */
+typedef struct ssock_handshake_client
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccrypt_suite_options_t* suite;
+    uint8_t client_id[SSOCK_HANDSHAKE_ID_SIZE];
+    const vccrypt_buffer_t* client_private_key;
+    uint8_t server_id[SSOCK_HANDSHAKE_ID_SIZE];
+    const vccrypt_buffer_t* server_public_key;
+
+    /** \brief the current ticket and its resumption secret, if any. */
+    void* ticket;
+    uint32_t ticket_size;
+    vccrypt_buffer_t resumption_secret;
+
+    /** \brief set if the last handshake was resumed from a ticket. */
+    uint8_t resumed;
+} ssock_handshake_client;
+
+/**
+ * \brief The server side of the handshake.
+ *
+ * A server may accept handshakes on several threads at once.
+ */
+typedef struct ssock_handshake_server
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    vccrypt_suite_options_t* suite;
+    uint8_t server_id[SSOCK_HANDSHAKE_ID_SIZE];
+    const vccrypt_buffer_t* server_private_key;
+    ssock_handshake_key_lookup_fn lookup;
+    void* context;
+
+    /** \brief the key sealing tickets, and how long they last. */
+    vccrypt_buffer_t ticket_key;
+    uint32_t ticket_lifetime;
+
+    /** \brief nonce source, shared between threads. */
+    vccrypt_prng_context_t prng;
+    pthread_mutex_t prng_lock;
+
+    /** \brief handshake counters, updated atomically. */
+    uint64_t full_handshakes;
+    uint64_t resumed_handshakes;
+} ssock_handshake_server;
+
+/**
+ * \brief Initialize the client side of the handshake.
+ *
+ * The keys must outlive the client.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param client                The client to initialize.
+ * \param alloc_opts            The allocator to use for this client.
+ * \param suite                 The crypto suite to use.
+ * \param client_id             The id of this client.
+ * \param client_private_key    The key agreement private key of this client.
+ * \param server_id             The id of the expected server.
+ * \param server_public_key     The key agreement public key of the server.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_handshake_client_init(
+    ssock_handshake_client* client, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, const uint8_t* client_id,
+    const vccrypt_buffer_t* client_private_key, const uint8_t* server_id,
+    const vccrypt_buffer_t* server_public_key);
+
+/**
+ * \brief Initialize the server side of the handshake.
+ *
+ * Tickets are sealed with the given ticket key, so servers sharing a key can
+ * resume each other's sessions.  With a NULL ticket key, a random key is
+ * generated, and tickets are only good on this server.  A ticket lifetime of
+ * 0 disables tickets.  The private key must outlive the server.  This
+ * instance is disposable and must be disposed by calling \ref dispose() when
+ * no longer needed.
+ *
+ * \param server                The server to initialize.
+ * \param alloc_opts            The allocator to use for this server.
+ * \param suite                 The crypto suite to use.
+ * \param server_id             The id of this server.
+ * \param server_private_key    The key agreement private key of this server.
+ * \param lookup                The client public key lookup.
+ * \param context               The user context for the lookup.
+ * \param ticket_key            Optional ticket key of the suite's MAC key
+ *                              size, or NULL.
+ * \param ticket_lifetime       The lifetime of a ticket, in seconds.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO if a crypto operation
+ *        failed.
+ */
+int ssock_handshake_server_init(
+    ssock_handshake_server* server, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, const uint8_t* server_id,
+    const vccrypt_buffer_t* server_private_key,
+    ssock_handshake_key_lookup_fn lookup, void* context,
+    const vccrypt_buffer_t* ticket_key, uint32_t ticket_lifetime);
+
+/**
+ * \brief Run the client side of the handshake.
+ *
+ * If the client holds a ticket, it offers to resume; otherwise, or if the
+ * server rejects the ticket, a full handshake is run.  On success, the
+ * client's ticket is replaced by the one the server issued, and
+ * \ref ssock_handshake_client::resumed records which kind of handshake ran.
+ *
+ * \param client        The client side of the handshake.
+ * \param sock          The socket connected to the server.
+ * \param shared_secret Buffer to initialize with the shared secret for this
+ *                      session; the caller owns it on success.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the server sent
+ *        a malformed message.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH if the server failed to
+ *        authenticate.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO if a crypto operation
+ *        failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_handshake_connect(
+    ssock_handshake_client* client, ssock* sock,
+    vccrypt_buffer_t* shared_secret);
+
+/**
+ * \brief Run the server side of the handshake.
+ *
+ * \param server        The server side of the handshake.
+ * \param sock          The socket connected to the client.
+ * \param client_id     Buffer of SSOCK_HANDSHAKE_ID_SIZE bytes to receive the
+ *                      authenticated id of the client.
+ * \param shared_secret Buffer to initialize with the shared secret for this
+ *                      session; the caller owns it on success.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the client sent
+ *        a malformed message.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_UNKNOWN_PEER if the client id was
+ *        rejected by the lookup.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH if the client failed to
+ *        authenticate.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO if a crypto operation
+ *        failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_handshake_accept(
+    ssock_handshake_server* server, ssock* sock, uint8_t* client_id,
+    vccrypt_buffer_t* shared_secret);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_HANDSHAKE_HEADER_GUARD*/
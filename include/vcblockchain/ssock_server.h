@@ -0,0 +1,172 @@
+/**
+ * \file vcblockchain/ssock_server.h
+ *
+ * \brief Multi-threaded ssock server with one reactor per core.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_SERVER_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_SERVER_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief Each reactor has its own listen socket, and the kernel shards
+ * incoming connections across them with SO_REUSEPORT.
+ */
+#define SSOCK_SERVER_MODE_REUSEPORT 0x00
+
+/**
+ * \brief All reactors share one listen socket, and each connection wakes a
+ * single reactor to accept it.
+ */
+#define SSOCK_SERVER_MODE_SHARED_ACCEPT 0x01
+
+/**
+ * \brief Connection handler.
+ *
+ * The handler is called on a reactor thread to read and handle one request.
+ * The reactor buffers each connection's input without blocking, and the
+ * handler reads from that buffer, so a slow peer never stalls the reactor.  If
+ * the handler reads past the input received so far, its read fails, and the
+ * handler is called again for the same request once more input arrives.  So
+ * the handler should read its whole request before acting on it or writing a
+ * response.  Writes never block either: output the peer isn't ready for is
+ * queued on the connection, and sent as the peer drains its receive buffer.
+ * A connection whose queued output outgrows the max_output_size option is
+ * closed.
+ *
+ * Each connection stays on the reactor that accepted it, so the handler may
+ * keep per-reactor state, indexed by reactor, without locking.
+ *
+ * \param sock          The readable connection.
+ * \param reactor       The index of the reactor running this handler.
+ * \param context       The user context from the server options.
+ *
+ * \returns VCBLOCKCHAIN_STATUS_SUCCESS to keep the connection open, or any
+ *          other value to close it.
+ */
+typedef int (*ssock_server_handler_fn)(
+    ssock* sock, size_t reactor, void* context);
+
+/**
+ * \brief Server options.
+ */
+typedef struct ssock_server_options
+{
+    /** \brief The IPv4 address to bind, or NULL for all addresses. */
+    const char* bind_address;
+    /** \brief The port to bind, or zero for an ephemeral port. */
+    uint16_t port;
+    /** \brief The listen backlog, or zero for SOMAXCONN. */
+    int backlog;
+    /** \brief The number of reactors, or zero for one per online core. */
+    size_t reactors;
+    /** \brief How connections are distributed across reactors. */
+    uint8_t mode;
+    /** \brief If non-zero, pin each reactor thread to a core. */
+    uint8_t pin_threads;
+    /** \brief The connection handler. */
+    ssock_server_handler_fn handler;
+    /** \brief The user context passed to the handler. */
+    void* context;
+    /** \brief Close connections idle for this many milliseconds; zero never
+     * closes idle connections. */
+    uint32_t idle_timeout_ms;
+    /** \brief Close connections which send a request larger than this many
+     * bytes; zero selects 1 MB. */
+    uint32_t max_request_size;
+    /** \brief Close connections which leave more than this many bytes of
+     * output unsent; zero selects 1 MB. */
+    uint32_t max_output_size;
+} ssock_server_options;
+
+/* forward decl for a reactor. */
+typedef struct ssock_server_reactor ssock_server_reactor;
+
+/**
+ * \brief A multi-threaded ssock server.
+ */
+typedef struct ssock_server
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    ssock_server_options options;
+    uint16_t port;
+    size_t reactor_count;
+    ssock_server_reactor* reactors;
+    int shared_listen_fd;
+    int stop_fd;
+    uint8_t running;
+} ssock_server;
+
+/**
+ * \brief Initialize a server, creating and binding its listen sockets.
+ *
+ * No connections are accepted until \ref ssock_server_start() is called.  The
+ * bound port, which may be ephemeral, is available in the port field.  This
+ * instance is disposable and must be disposed by calling \ref dispose() when
+ * no longer needed.  Disposing a running server stops it first.
+ *
+ * \param server            The server instance to initialize.
+ * \param alloc_opts        The allocator to use for reactors and connections.
+ * \param options           The server options.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN if a listen socket could not
+ *        be created, bound, or put into the listening state.
+ */
+int ssock_server_init(
+    ssock_server* server, allocator_options_t* alloc_opts,
+    const ssock_server_options* options);
+
+/**
+ * \brief Start one reactor thread per reactor.
+ *
+ * \param server            The server to start.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        if the server is already running.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SERVER_THREAD if a reactor thread could not
+ *        be started or pinned to its core.
+ */
+int ssock_server_start(ssock_server* server);
+
+/**
+ * \brief Stop the server, waiting for each reactor thread to exit.
+ *
+ * Each reactor closes its open connections as it exits.  The listen sockets
+ * stay bound until the server is disposed.
+ *
+ * \param server            The server to stop.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        if the server is not running.
+ */
+int ssock_server_stop(ssock_server* server);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_SERVER_HEADER_GUARD*/
@@ -0,0 +1,262 @@
+/**
+ * \file vcblockchain/ssock_write_queue.h
+ *
+ * \brief Thread-safe write queue for sharing one ssock between producers.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_WRITE_QUEUE_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_WRITE_QUEUE_HEADER_GUARD
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The maximum number of frames gathered into one vectored write.
+ */
+#define SSOCK_WRITE_QUEUE_BATCH_MAX 64
+
+/**
+ * \brief Flow control events, reported through the event callback.
+ */
+#define SSOCK_WRITE_QUEUE_EVENT_UNWRITABLE 0x00
+#define SSOCK_WRITE_QUEUE_EVENT_WRITABLE 0x01
+#define SSOCK_WRITE_QUEUE_EVENT_SLOW_CONSUMER 0x02
+
+typedef struct ssock_write_queue ssock_write_queue;
+
+/**
+ * \brief Flow control event callback.
+ *
+ * The unwritable and slow consumer events are reported on a producer thread or
+ * the flusher, and the writable event on the flusher.  Callbacks must not
+ * enqueue on or flush the queue.
+ *
+ * \param queue             The write queue.
+ * \param event             The SSOCK_WRITE_QUEUE_EVENT_* event.
+ * \param context           The user context from the flow options.
+ */
+typedef void (*ssock_write_queue_event_fn)(
+    ssock_write_queue* queue, int event, void* context);
+
+/**
+ * \brief Flow control options for a write queue.
+ */
+typedef struct ssock_write_queue_flow_options
+{
+    /** \brief queued bytes at which the queue becomes unwritable; 0 is
+     * unbounded. */
+    size_t high_watermark;
+
+    /** \brief queued bytes at which the queue becomes writable again. */
+    size_t low_watermark;
+
+    /** \brief how long an enqueue on an unwritable queue waits for it to
+     * become writable; 0 fails at once. */
+    uint32_t block_timeout_ms;
+
+    /** \brief how long a queue may stay unwritable before its peer is shed as
+     * a slow consumer; 0 never sheds. */
+    uint32_t slow_consumer_ms;
+
+    /** \brief optional callback for flow control events. */
+    ssock_write_queue_event_fn on_event;
+
+    /** \brief user context passed to the callback. */
+    void* context;
+} ssock_write_queue_flow_options;
+
+/**
+ * \brief A queued frame.  The frame's bytes follow this header.
+ */
+typedef struct ssock_write_frame ssock_write_frame;
+
+struct ssock_write_frame
+{
+    /** \brief the next frame in the queue. */
+    ssock_write_frame* next;
+
+    /** \brief the number of frame bytes following this header. */
+    size_t size;
+};
+
+/**
+ * \brief A lock-free multi-producer, single-consumer write queue.
+ *
+ * Any number of threads may enqueue complete frames concurrently.  A single
+ * flusher thread drains the queue into the ssock with vectored writes.  Since
+ * every frame is enqueued whole, frames from different producers never
+ * interleave, and frames from one producer are written in order.
+ *
+ * By default the queue is unbounded.  With flow control enabled, the queued
+ * bytes are accounted against a high and a low watermark; see
+ * \ref ssock_write_queue_set_flow_control().
+ */
+struct ssock_write_queue
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    ssock* sock;
+
+    /** \brief the most recently enqueued frame; swapped by producers. */
+    ssock_write_frame* head;
+
+    /** \brief the next frame to write; only touched by the flusher. */
+    ssock_write_frame* tail;
+
+    /** \brief the sentinel frame that keeps the queue non-empty. */
+    ssock_write_frame stub;
+
+    /** \brief the flow control options. */
+    ssock_write_queue_flow_options flow;
+
+    /** \brief the number of frame bytes enqueued but not yet written. */
+    size_t queued_bytes;
+
+    /** \brief cleared above the high watermark until the low watermark. */
+    uint8_t writable;
+
+    /** \brief set once the peer has been shed as a slow consumer. */
+    uint8_t shed;
+
+    /** \brief the monotonic time at which the queue became unwritable. */
+    uint64_t unwritable_since;
+
+    /** \brief used only to park producers while the queue is unwritable. */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+/**
+ * \brief Initialize a write queue for the given ssock.
+ *
+ * The queue does not take ownership of the ssock.  Once a queue is in use,
+ * only its flusher may write to the ssock.  This instance is disposable and
+ * must be disposed by calling \ref dispose() when no longer needed.  Frames
+ * that have not been flushed are discarded when it is disposed.
+ *
+ * \param queue             The write queue to initialize.
+ * \param alloc_opts        The allocator to use for queued frames.
+ * \param sock              The ssock to which frames are written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the queue's synchronization
+ *        primitives could not be created.
+ */
+int ssock_write_queue_init(
+    ssock_write_queue* queue, allocator_options_t* alloc_opts, ssock* sock);
+
+/**
+ * \brief Enqueue a complete, already encoded frame.  Thread-safe.
+ *
+ * The bytes are copied, so the caller may reuse its buffer immediately.
+ *
+ * \param queue             The write queue.
+ * \param frame             The encoded frame.
+ * \param size              The size of the frame.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL if the queue stayed
+ *        unwritable for the flow control block timeout.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed as a
+ *        slow consumer.
+ */
+int ssock_write_queue_enqueue(
+    ssock_write_queue* queue, const void* frame, size_t size);
+
+/**
+ * \brief Enqueue a data packet.  Thread-safe.
+ *
+ * The packet header and payload are encoded into a single frame.  The packet is
+ * always sent uncompressed.
+ *
+ * \param queue             The write queue.
+ * \param val               The payload of the data packet.
+ * \param size              The size of the payload.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL if the queue stayed
+ *        unwritable for the flow control block timeout.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed as a
+ *        slow consumer.
+ */
+int ssock_write_queue_enqueue_data(
+    ssock_write_queue* queue, const void* val, uint32_t size);
+
+/**
+ * \brief Write every frame currently in the queue to the ssock.
+ *
+ * Only one thread may flush a queue.  Frames are gathered into vectored
+ * writes of up to \ref SSOCK_WRITE_QUEUE_BATCH_MAX frames, and the ssock is
+ * flushed once the queue is drained.  A frame whose producer is still linking
+ * it into the queue is left for the next flush.
+ *
+ * \param queue             The write queue.
+ * \param frames            Optional pointer to receive the number of frames
+ *                          written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing to the ssock failed.  The
+ *        frames of the failed batch are discarded.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed as a
+ *        slow consumer.  Queued frames are discarded, and the caller should
+ *        disconnect the peer.
+ */
+int ssock_write_queue_flush(ssock_write_queue* queue, size_t* frames);
+
+/**
+ * \brief Enable flow control on a write queue.
+ *
+ * Once the queued bytes reach the high watermark, the queue becomes
+ * unwritable, and stays so until the flusher drains it to the low watermark.
+ * While it is unwritable, an enqueue waits up to the block timeout for it to
+ * become writable, and otherwise fails, which pushes back on the producer
+ * instead of growing memory.  The watermark is soft: producers that were
+ * admitted before the queue became unwritable may overshoot it by one frame
+ * each.  If the queue stays unwritable for longer than the slow consumer
+ * timeout, the peer is shed: every later enqueue and flush fails, and the
+ * queued frames are discarded.  The slow consumer event is a good place to
+ * shut down the socket, so that a flush blocked on the peer returns.
+ *
+ * This must be called before the queue is shared between threads.
+ *
+ * \param queue             The write queue.
+ * \param options           The flow control options.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed,
+ *        including a low watermark above the high watermark.
+ */
+int ssock_write_queue_set_flow_control(
+    ssock_write_queue* queue, const ssock_write_queue_flow_options* options);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_WRITE_QUEUE_HEADER_GUARD*/
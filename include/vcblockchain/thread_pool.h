@@ -0,0 +1,291 @@
+/**
+ * \file vcblockchain/thread_pool.h
+ *
+ * \brief Work-stealing thread pool.
+ *
+ * Each worker owns a deque of tasks.  A worker runs its own tasks newest
+ * first, and when it runs out, steals the oldest task from another worker.
+ * Tasks submitted from outside the pool are spread across the workers, and
+ * tasks submitted from a task go to the worker running it.
+ *
+ * A caller waiting on a \ref thread_pool_latch helps run queued tasks instead
+ * of idling, so a caller which fans work out to the pool is never one core
+ * short.
+ *
+ * A \ref thread_pool_scan checks a range of items in chunks on the pool, and
+ * finds the lowest index which fails, whatever order the chunks ran in.  Once
+ * an item fails, items after it are skipped.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_THREAD_POOL_HEADER_GUARD
+#define VCBLOCKCHAIN_THREAD_POOL_HEADER_GUARD
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/error_codes.h>
+#include <vpr/allocator.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief A task.
+ *
+ * \param context       The user context passed to \ref thread_pool_submit().
+ */
+typedef void (*thread_pool_task_fn)(void* context);
+
+/**
+ * \brief A queued task.
+ */
+typedef struct thread_pool_task
+{
+    thread_pool_task_fn fn;
+    void* context;
+} thread_pool_task;
+
+/**
+ * \brief Opaque worker type.
+ */
+typedef struct thread_pool_worker thread_pool_worker;
+
+/**
+ * \brief A work-stealing thread pool.
+ */
+typedef struct thread_pool
+{
+    disposable_t hdr;
+    allocator_options_t* alloc_opts;
+    size_t worker_count;
+    thread_pool_worker* workers;
+
+    /** \brief the number of queued tasks, and the next worker to submit to. */
+    size_t queued;
+    size_t next;
+
+    /** \brief idle workers sleep here until a task is queued. */
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    uint8_t stopping;
+} thread_pool;
+
+/**
+ * \brief A countdown latch, which a caller waits on until the tasks it
+ * submitted are done.
+ */
+typedef struct thread_pool_latch
+{
+    size_t count;
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+} thread_pool_latch;
+
+/**
+ * \brief Opaque scan type.
+ */
+typedef struct thread_pool_scan thread_pool_scan;
+
+/**
+ * \brief A check of the items in one chunk of a scan.
+ *
+ * The check runs through the items from begin up to end, stopping at the
+ * first one for which \ref thread_pool_scan_skip() is true.  It reports the
+ * first item which fails with \ref thread_pool_scan_fail(), then stops.
+ *
+ * \param scan          The scan.
+ * \param begin         The index of the first item in the chunk.
+ * \param end           The index after the last item in the chunk.
+ */
+typedef void (*thread_pool_scan_fn)(
+    thread_pool_scan* scan, size_t begin, size_t end);
+
+/**
+ * \brief One chunk of a scan, checked by one task.
+ */
+typedef struct thread_pool_scan_chunk
+{
+    thread_pool_scan* scan;
+    size_t begin;
+    size_t end;
+} thread_pool_scan_chunk;
+
+/**
+ * \brief A search for the lowest failing index of a range of items.
+ */
+struct thread_pool_scan
+{
+    thread_pool* pool;
+    allocator_options_t* alloc_opts;
+    thread_pool_scan_fn fn;
+    void* context;
+    size_t count;
+
+    /** \brief the chunks on the pool, or NULL if the scan runs inline. */
+    thread_pool_scan_chunk* chunks;
+    thread_pool_latch latch;
+
+    /** \brief the lowest failing index so far, updated atomically. */
+    size_t first_failure;
+
+    /** \brief the reason the scan was cancelled, updated atomically. */
+    int status;
+};
+
+/**
+ * \brief Initialize a thread pool and start its workers.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed.  Disposing of the pool waits for running tasks, and
+ * discards tasks which have not started.
+ *
+ * \param pool          The pool to initialize.
+ * \param alloc_opts    The allocator to use for this pool.
+ * \param workers       The number of workers; 0 selects one per online core.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_THREAD_POOL_THREAD if a worker could not be
+ *        started.
+ */
+int thread_pool_init(
+    thread_pool* pool, allocator_options_t* alloc_opts, size_t workers);
+
+/**
+ * \brief Queue a task on the pool.
+ *
+ * \param pool          The pool.
+ * \param fn            The task.
+ * \param context       The user context for the task.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int thread_pool_submit(thread_pool* pool, thread_pool_task_fn fn, void* context);
+
+/**
+ * \brief Initialize a latch.
+ *
+ * This instance is disposed by calling \ref thread_pool_latch_dispose().
+ *
+ * \param latch         The latch to initialize.
+ * \param count         The number of count downs it waits for.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int thread_pool_latch_init(thread_pool_latch* latch, size_t count);
+
+/**
+ * \brief Dispose of a latch.
+ *
+ * \param latch         The latch to dispose.
+ */
+void thread_pool_latch_dispose(thread_pool_latch* latch);
+
+/**
+ * \brief Count a latch down by one, waking its waiter at zero.
+ *
+ * \param latch         The latch.
+ */
+void thread_pool_latch_count_down(thread_pool_latch* latch);
+
+/**
+ * \brief Wait for a latch to reach zero, running queued tasks meanwhile.
+ *
+ * \param pool          The pool to help, or NULL to just wait.
+ * \param latch         The latch.
+ */
+void thread_pool_wait(thread_pool* pool, thread_pool_latch* latch);
+
+/**
+ * \brief Start a scan of a range of items.
+ *
+ * The range is split into chunks, which are queued on the pool.  If there is
+ * no pool, or only one chunk, the scan runs on the calling thread in
+ * \ref thread_pool_scan_finish() instead.  Either way, the caller may do other
+ * work, or cancel the scan, before finishing it, and must always finish it.
+ *
+ * \param scan          The scan to start.
+ * \param pool          The pool to scan on, or NULL to scan on the calling
+ *                      thread.
+ * \param alloc_opts    The allocator to use for the chunks.
+ * \param count         The number of items.
+ * \param chunk_size    The number of items per chunk; must be non-zero.
+ * \param fn            The check of one chunk.
+ * \param context       The user context for the check.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int thread_pool_scan_start(
+    thread_pool_scan* scan, thread_pool* pool, allocator_options_t* alloc_opts,
+    size_t count, size_t chunk_size, thread_pool_scan_fn fn, void* context);
+
+/**
+ * \brief Finish a scan, running it here or helping the pool with it.
+ *
+ * On return, the scan's first_failure is the lowest failing index, or
+ * SIZE_MAX if no item failed.
+ *
+ * \param scan          The scan.
+ *
+ * \returns VCBLOCKCHAIN_STATUS_SUCCESS, or the status the scan was cancelled
+ *          with.
+ */
+int thread_pool_scan_finish(thread_pool_scan* scan);
+
+/**
+ * \brief Cancel a scan, so that its remaining items are skipped.
+ *
+ * If the scan is cancelled more than once, the first status is kept.
+ *
+ * \param scan          The scan.
+ * \param status        The non-zero status for \ref thread_pool_scan_finish()
+ *                      to return.
+ */
+void thread_pool_scan_cancel(thread_pool_scan* scan, int status);
+
+/**
+ * \brief Check whether an item of a scan can be skipped, because the scan was
+ * cancelled or a lower index has already failed.
+ *
+ * \param scan          The scan.
+ * \param index         The index of the item.
+ *
+ * \returns true if the item need not be checked.
+ */
+bool thread_pool_scan_skip(thread_pool_scan* scan, size_t index);
+
+/**
+ * \brief Report that an item of a scan failed.
+ *
+ * \param scan          The scan.
+ * \param index         The index of the failing item.
+ */
+void thread_pool_scan_fail(thread_pool_scan* scan, size_t index);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_THREAD_POOL_HEADER_GUARD*/
@@ -0,0 +1,219 @@
+/**
+ * \file vcblockchain/timer_wheel.h
+ *
+ * \brief Hierarchical timer wheel for connection deadlines and schedules.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_TIMER_WHEEL_HEADER_GUARD
+#define VCBLOCKCHAIN_TIMER_WHEEL_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vcblockchain/error_codes.h>
+#include <vpr/disposable.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The number of wheel levels.
+ */
+#define TIMER_WHEEL_LEVELS 4
+
+/**
+ * \brief The number of bits of the tick count resolved by each level.
+ */
+#define TIMER_WHEEL_SLOT_BITS 6
+
+/**
+ * \brief The number of slots in each level.
+ */
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+
+/**
+ * \brief Returned by \ref timer_wheel_next_timeout() when no timer is pending.
+ */
+#define TIMER_WHEEL_NO_TIMEOUT UINT64_MAX
+
+typedef struct timer_wheel timer_wheel;
+typedef struct timer_wheel_timer timer_wheel_timer;
+
+/**
+ * \brief Timer callback.
+ *
+ * The timer is no longer pending when its callback runs, so the callback may
+ * schedule it again, or release the memory that holds it.
+ *
+ * \param wheel         The wheel on which the timer expired.
+ * \param timer         The expired timer.
+ * \param context       The user context of the timer.
+ */
+typedef void (*timer_wheel_callback_fn)(
+    timer_wheel* wheel, timer_wheel_timer* timer, void* context);
+
+/**
+ * \brief A link in a wheel slot's circular list.
+ */
+typedef struct timer_wheel_link timer_wheel_link;
+
+struct timer_wheel_link
+{
+    timer_wheel_link* prev;
+    timer_wheel_link* next;
+};
+
+/**
+ * \brief A timer.  Timers are intrusive: the caller owns their memory, usually
+ * by embedding them in a connection, and the wheel never allocates.
+ */
+struct timer_wheel_timer
+{
+    /** \brief the slot link; must be the first member. */
+    timer_wheel_link link;
+
+    /** \brief the wheel on which this timer is pending, or NULL. */
+    timer_wheel* wheel;
+
+    /** \brief the tick at which this timer expires. */
+    uint64_t expiry;
+
+    timer_wheel_callback_fn callback;
+    void* context;
+};
+
+/**
+ * \brief A hierarchical timer wheel.
+ *
+ * Level 0 has one slot per tick.  Each higher level has one slot per full turn
+ * of the level below, and its timers cascade down a level as that slot comes
+ * due.  Scheduling and canceling a timer are O(1), and each timer cascades at
+ * most once per level.  Timers further out than the top level can reach wait
+ * in its furthest slot until they are in range.
+ */
+struct timer_wheel
+{
+    disposable_t hdr;
+    uint32_t tick_ms;
+    uint64_t start_ms;
+
+    /** \brief the number of ticks the wheel has advanced. */
+    uint64_t current;
+
+    /** \brief the number of pending timers. */
+    size_t count;
+
+    timer_wheel_link slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+};
+
+/**
+ * \brief Initialize a timer wheel.
+ *
+ * Timers are resolved to the tick; a timer never fires early, and fires within
+ * one tick of its deadline if the wheel is advanced promptly.  This instance is
+ * disposable and must be disposed by calling \ref dispose() when no longer
+ * needed.  Pending timers are canceled, without firing, when it is disposed.
+ *
+ * \param wheel             The wheel to initialize.
+ * \param tick_ms           The duration of a tick in milliseconds.
+ * \param now_ms            The current time in milliseconds, on the same
+ *                          monotonic clock later passed to
+ *                          \ref timer_wheel_advance().
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_init(timer_wheel* wheel, uint32_t tick_ms, uint64_t now_ms);
+
+/**
+ * \brief Initialize a timer.
+ *
+ * \param timer             The timer to initialize.
+ * \param callback          The callback to call when the timer expires.
+ * \param context           The user context passed to the callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_timer_init(
+    timer_wheel_timer* timer, timer_wheel_callback_fn callback, void* context);
+
+/**
+ * \brief Schedule a timer to expire after the given delay.
+ *
+ * The delay is measured from the wheel's current time, as of the last
+ * \ref timer_wheel_advance(), and rounded up to whole ticks, with a minimum of
+ * one tick.  A timer which is already pending is rescheduled, which makes this
+ * suitable for resetting an idle timeout on every request.  This is O(1).
+ *
+ * \param wheel             The wheel.
+ * \param timer             The timer to schedule.
+ * \param delay_ms          The delay in milliseconds.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_schedule(
+    timer_wheel* wheel, timer_wheel_timer* timer, uint64_t delay_ms);
+
+/**
+ * \brief Cancel a timer.  Canceling a timer which is not pending does nothing.
+ * This is O(1).
+ *
+ * \param timer             The timer to cancel.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_cancel(timer_wheel_timer* timer);
+
+/**
+ * \brief Advance the wheel to the given time, firing every timer which has
+ * expired.
+ *
+ * Timers fire in order of expiry tick.  An empty wheel jumps straight to the
+ * given time.
+ *
+ * \param wheel             The wheel.
+ * \param now_ms            The current time in milliseconds.
+ * \param fired             Optional pointer to receive the number of timers
+ *                          fired.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_advance(timer_wheel* wheel, uint64_t now_ms, size_t* fired);
+
+/**
+ * \brief Get the time until the wheel next needs to be advanced, for use as a
+ * poll timeout.
+ *
+ * The result is exact when the next timer is in level 0, and otherwise is the
+ * time until the next cascade, which is never later than the next expiry.
+ *
+ * \param wheel             The wheel.
+ * \param now_ms            The current time in milliseconds.
+ * \param timeout_ms        Pointer to receive the timeout in milliseconds, or
+ *                          \ref TIMER_WHEEL_NO_TIMEOUT if no timer is pending.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_next_timeout(
+    const timer_wheel* wheel, uint64_t now_ms, uint64_t* timeout_ms);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_TIMER_WHEEL_HEADER_GUARD*/
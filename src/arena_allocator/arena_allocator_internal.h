@@ -0,0 +1,69 @@
+/**
+ * \file src/arena_allocator/arena_allocator_internal.h
+ *
+ * \brief Internal types for the arena allocator.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_ARENA_ALLOCATOR_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_ARENA_ALLOCATOR_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/arena_allocator.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief A block from the backing allocator.  Its bytes follow this header,
+ * which is padded to the arena alignment.
+ */
+typedef struct arena_allocator_block arena_allocator_block;
+
+struct arena_allocator_block
+{
+    arena_allocator_block* next;
+    size_t size;
+    uint8_t pad[ARENA_ALLOCATOR_ALIGNMENT - sizeof(void*) - sizeof(size_t)];
+};
+
+/**
+ * \brief Arena allocator context.
+ */
+typedef struct arena_allocator_context
+{
+    allocator_options_t* backing;
+
+    /** \brief the caller's region, or NULL. */
+    uint8_t* region;
+    size_t region_size;
+
+    /** \brief blocks in use, newest first. */
+    arena_allocator_block* blocks;
+
+    /** \brief a block kept across resets when there is no caller region. */
+    arena_allocator_block* spare;
+
+    /** \brief the bump pointer and the end of the current region or block. */
+    uint8_t* cursor;
+    uint8_t* limit;
+
+    /** \brief the most recent allocation, which may shrink or grow in place. */
+    uint8_t* last;
+} arena_allocator_context;
+
+/**
+ * \brief Rewind an arena to its first region, releasing overflow blocks.
+ *
+ * \param ctx           The arena context.
+ */
+void arena_allocator_rewind(arena_allocator_context* ctx);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_ARENA_ALLOCATOR_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,314 @@
+/**
+ * \file src/arena_allocator/arena_allocator_options_init.c
+ *
+ * \brief Initialize an arena allocator.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "arena_allocator_internal.h"
+
+/* forward decls. */
+static void* arena_allocator_allocate(void* options, size_t size);
+static void arena_allocator_release(void* options, void* mem);
+static void* arena_allocator_reallocate(
+    void* options, void* mem, size_t old_size, size_t size);
+static int arena_allocator_control(void* options, uint32_t key, void* value);
+static void* arena_allocator_grow(arena_allocator_context* ctx, size_t size);
+static void arena_allocator_dispose(void* disposable);
+
+/**
+ * \brief Round a size up to the arena alignment.
+ */
+#define ARENA_ALLOCATOR_ROUND(size) \
+    (((size) + ARENA_ALLOCATOR_ALIGNMENT - 1) \
+        & ~((size_t)ARENA_ALLOCATOR_ALIGNMENT - 1))
+
+/**
+ * \brief Initialize an arena allocator.
+ *
+ * An arena serves allocations by bumping a pointer through a region, so an
+ * allocation costs a few instructions, and \ref release() is free.  Everything
+ * allocated from the arena is freed at once by \ref arena_allocator_reset(),
+ * typically after each decoded message, so error paths can't leak.  When the
+ * region fills, the arena grows by chaining blocks from the backing allocator.
+ *
+ * The region may be supplied by the caller, for instance a buffer embedded in
+ * a connection.  Otherwise, the arena keeps its largest block across resets,
+ * so a long-lived arena settles on a region big enough for its messages and
+ * stops calling the backing allocator.
+ *
+ * Releasing or reallocating the most recent allocation reclaims or grows it in
+ * place.  An arena is not thread-safe.  This instance is disposable and must
+ * be disposed by calling \ref dispose() when no longer needed, which frees
+ * every allocation.
+ *
+ * \param options           The allocator options to initialize.
+ * \param backing           The allocator for the arena's context and blocks.
+ * \param region            Optional caller-owned region, or NULL.
+ * \param region_size       The size of the region.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int arena_allocator_options_init(
+    allocator_options_t* options, allocator_options_t* backing, void* region,
+    size_t region_size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != options);
+    MODEL_ASSERT(NULL != backing);
+    MODEL_ASSERT(NULL != region || 0 == region_size);
+
+    /* runtime parameter checks. */
+    if (NULL == options || NULL == backing || (NULL == region && region_size > 0))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    arena_allocator_context* ctx = (arena_allocator_context*)
+        allocate(backing, sizeof(arena_allocator_context));
+    if (NULL == ctx)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    memset(ctx, 0, sizeof(arena_allocator_context));
+    ctx->backing = backing;
+
+    /* align the caller's region; a region too small to align is ignored. */
+    if (NULL != region)
+    {
+        uintptr_t start = (uintptr_t)region;
+        uintptr_t aligned = ARENA_ALLOCATOR_ROUND(start);
+        if (aligned - start < region_size)
+        {
+            ctx->region = (uint8_t*)aligned;
+            ctx->region_size = region_size - (aligned - start);
+        }
+    }
+
+    arena_allocator_rewind(ctx);
+
+    memset(options, 0, sizeof(allocator_options_t));
+    options->hdr.dispose = &arena_allocator_dispose;
+    options->allocator_allocate = &arena_allocator_allocate;
+    options->allocator_release = &arena_allocator_release;
+    options->allocator_reallocate = &arena_allocator_reallocate;
+    options->allocator_control = &arena_allocator_control;
+    options->context = ctx;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Allocate from the arena, growing it if the current region is full.
+ *
+ * \param options       The arena's allocator options.
+ * \param size          The number of bytes to allocate.
+ *
+ * \returns the allocation, or NULL on failure.
+ */
+static void* arena_allocator_allocate(void* options, size_t size)
+{
+    arena_allocator_context* ctx = (arena_allocator_context*)
+        ((allocator_options_t*)options)->context;
+    size_t rounded = ARENA_ALLOCATOR_ROUND(size > 0 ? size : 1);
+
+    /* guard against wrapping on absurd sizes. */
+    if (rounded < size)
+    {
+        return NULL;
+    }
+
+    if (NULL == ctx->cursor || (size_t)(ctx->limit - ctx->cursor) < rounded)
+    {
+        return arena_allocator_grow(ctx, rounded);
+    }
+
+    ctx->last = ctx->cursor;
+    ctx->cursor += rounded;
+
+    return ctx->last;
+}
+
+/**
+ * \brief Release an allocation.  Only the most recent allocation is reclaimed;
+ * everything else waits for the next reset.
+ *
+ * \param options       The arena's allocator options.
+ * \param mem           The allocation to release.
+ */
+static void arena_allocator_release(void* options, void* mem)
+{
+    arena_allocator_context* ctx = (arena_allocator_context*)
+        ((allocator_options_t*)options)->context;
+
+    if (NULL != mem && mem == ctx->last)
+    {
+        ctx->cursor = ctx->last;
+        ctx->last = NULL;
+    }
+}
+
+/**
+ * \brief Reallocate an allocation, in place if it is the most recent one and
+ * there is room.
+ *
+ * \param options       The arena's allocator options.
+ * \param mem           The allocation to resize.
+ * \param old_size      The current size of the allocation.
+ * \param size          The new size of the allocation.
+ *
+ * \returns the resized allocation, or NULL on failure.
+ */
+static void* arena_allocator_reallocate(
+    void* options, void* mem, size_t old_size, size_t size)
+{
+    arena_allocator_context* ctx = (arena_allocator_context*)
+        ((allocator_options_t*)options)->context;
+
+    if (NULL == mem)
+    {
+        return arena_allocator_allocate(options, size);
+    }
+
+    /* grow or shrink the most recent allocation in place. */
+    size_t rounded = ARENA_ALLOCATOR_ROUND(size > 0 ? size : 1);
+    if (mem == ctx->last && rounded >= size && (size_t)(ctx->limit - ctx->last) >= rounded)
+    {
+        ctx->cursor = ctx->last + rounded;
+        return mem;
+    }
+
+    /* anything else shrinks for free. */
+    if (size <= old_size)
+    {
+        return mem;
+    }
+
+    void* resized = arena_allocator_allocate(options, size);
+    if (NULL != resized)
+    {
+        memcpy(resized, mem, old_size);
+    }
+
+    return resized;
+}
+
+/**
+ * \brief Handle an allocator control request.
+ *
+ * \param options       The arena's allocator options.
+ * \param key           The control key.
+ * \param value         The control value.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int arena_allocator_control(void* options, uint32_t key, void* value)
+{
+    arena_allocator_context* ctx = (arena_allocator_context*)
+        ((allocator_options_t*)options)->context;
+
+    (void)value;
+
+    switch (key)
+    {
+        case ARENA_ALLOCATOR_CONTROL_KEY_RESET:
+            arena_allocator_rewind(ctx);
+            return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+        default:
+            return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+}
+
+/**
+ * \brief Chain a new block, at least twice the size of the last one, and
+ * allocate from it.
+ *
+ * \param ctx           The arena context.
+ * \param size          The rounded size of the allocation.
+ *
+ * \returns the allocation, or NULL on failure.
+ */
+static void* arena_allocator_grow(arena_allocator_context* ctx, size_t size)
+{
+    size_t block_size = ARENA_ALLOCATOR_MIN_BLOCK_SIZE;
+    size_t previous;
+
+    if (NULL != ctx->blocks)
+    {
+        previous = ctx->blocks->size;
+    }
+    else if (NULL != ctx->spare)
+    {
+        previous = ctx->spare->size;
+    }
+    else
+    {
+        previous = ctx->region_size;
+    }
+
+    if (previous <= SIZE_MAX / 2 && 2 * previous > block_size)
+    {
+        block_size = 2 * previous;
+    }
+
+    if (size > block_size)
+    {
+        block_size = size;
+    }
+
+    if (block_size > SIZE_MAX - sizeof(arena_allocator_block))
+    {
+        return NULL;
+    }
+
+    arena_allocator_block* block = (arena_allocator_block*)
+        allocate(ctx->backing, sizeof(arena_allocator_block) + block_size);
+    if (NULL == block)
+    {
+        return NULL;
+    }
+
+    block->size = block_size;
+    block->next = ctx->blocks;
+    ctx->blocks = block;
+
+    ctx->last = (uint8_t*)(block + 1);
+    ctx->cursor = ctx->last + size;
+    ctx->limit = ctx->last + block_size;
+
+    return ctx->last;
+}
+
+/**
+ * \brief Dispose of an arena, freeing every allocation and block.
+ *
+ * \param disposable    The arena's allocator options.
+ */
+static void arena_allocator_dispose(void* disposable)
+{
+    allocator_options_t* options = (allocator_options_t*)disposable;
+    arena_allocator_context* ctx = (arena_allocator_context*)options->context;
+    allocator_options_t* backing = ctx->backing;
+
+    /* drop every overflow block, then the spare. */
+    arena_allocator_rewind(ctx);
+    if (NULL != ctx->spare)
+    {
+        release(backing, ctx->spare);
+    }
+
+    release(backing, ctx);
+
+    memset(options, 0, sizeof(allocator_options_t));
+}
@@ -0,0 +1,35 @@
+/**
+ * \file src/arena_allocator/arena_allocator_reset.c
+ *
+ * \brief Free every allocation made from an arena at once.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "arena_allocator_internal.h"
+
+/**
+ * \brief Free every allocation made from an arena at once.
+ *
+ * \param options           The arena's allocator options.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int arena_allocator_reset(allocator_options_t* options)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != options);
+
+    /* runtime parameter checks. */
+    if (NULL == options || NULL == options->context)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    return
+        allocator_control(options, ARENA_ALLOCATOR_CONTROL_KEY_RESET, NULL);
+}
@@ -0,0 +1,62 @@
+/**
+ * \file src/arena_allocator/arena_allocator_rewind.c
+ *
+ * \brief Rewind an arena to its first region.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "arena_allocator_internal.h"
+
+/**
+ * \brief Rewind an arena to its first region, releasing overflow blocks.
+ *
+ * Without a caller region, the largest block seen is kept as the spare, and
+ * becomes the first region from now on.
+ *
+ * \param ctx           The arena context.
+ */
+void arena_allocator_rewind(arena_allocator_context* ctx)
+{
+    MODEL_ASSERT(NULL != ctx);
+
+    while (NULL != ctx->blocks)
+    {
+        arena_allocator_block* block = ctx->blocks;
+        ctx->blocks = block->next;
+
+        /* keep the largest block when there is no caller region. */
+        if (NULL == ctx->region && (NULL == ctx->spare || block->size > ctx->spare->size))
+        {
+            if (NULL != ctx->spare)
+            {
+                release(ctx->backing, ctx->spare);
+            }
+
+            ctx->spare = block;
+        }
+        else
+        {
+            release(ctx->backing, block);
+        }
+    }
+
+    ctx->last = NULL;
+
+    if (NULL != ctx->region)
+    {
+        ctx->cursor = ctx->region;
+        ctx->limit = ctx->region + ctx->region_size;
+    }
+    else if (NULL != ctx->spare)
+    {
+        ctx->cursor = (uint8_t*)(ctx->spare + 1);
+        ctx->limit = ctx->cursor + ctx->spare->size;
+    }
+    else
+    {
+        ctx->cursor = ctx->limit = NULL;
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * \file src/artifact_history/ssock_artifact_history_internal.h
+ *
+ * \brief Internal types and functions for artifact history queries.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_ARTIFACT_HISTORY_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_ARTIFACT_HISTORY_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/ssock_artifact_history.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The size of a page of transaction ids.
+ */
+#define SSOCK_ARTIFACT_HISTORY_PAGE_BYTES \
+    (SSOCK_ARTIFACT_HISTORY_PAGE_SIZE * BLOCK_STORE_ID_SIZE)
+
+/**
+ * \brief The state of a query reading its response.  Chunks arrive in
+ * whatever sizes the socket delivers, so ids are gathered into whole pages
+ * here before they are passed on.
+ */
+typedef struct ssock_artifact_history_reader
+{
+    ssock_artifact_history_page_fn onpage;
+    void* context;
+    size_t filled;
+    uint8_t page[SSOCK_ARTIFACT_HISTORY_PAGE_BYTES];
+} ssock_artifact_history_reader;
+
+/**
+ * \brief Gather a chunk of the response into pages.
+ *
+ * \param context       The \ref ssock_artifact_history_reader.
+ * \param chunk         The bytes received in this chunk.
+ * \param size          The number of bytes in this chunk.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_artifact_history_onchunk(
+    void* context, const void* chunk, size_t size);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_ARTIFACT_HISTORY_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,70 @@
+/**
+ * \file src/artifact_history/ssock_artifact_history_onchunk.c
+ *
+ * \brief Gather a chunk of an artifact history response into pages.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_artifact_history_internal.h"
+
+/**
+ * \brief Gather a chunk of the response into pages.
+ *
+ * Each full page is passed to the reader's callback, and the page buffer is
+ * reused for the next.  The last, partial page is passed on by the query once
+ * the stream ends.
+ *
+ * \param context       The \ref ssock_artifact_history_reader.
+ * \param chunk         The bytes received in this chunk.
+ * \param size          The number of bytes in this chunk.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - the non-zero status returned by the callback, if it aborts the query.
+ */
+int ssock_artifact_history_onchunk(
+    void* context, const void* chunk, size_t size)
+{
+    int retval;
+    ssock_artifact_history_reader* reader =
+        (ssock_artifact_history_reader*)context;
+    const uint8_t* bytes = (const uint8_t*)chunk;
+
+    MODEL_ASSERT(NULL != reader);
+    MODEL_ASSERT(NULL != bytes || 0 == size);
+
+    while (size > 0)
+    {
+        size_t copy = SSOCK_ARTIFACT_HISTORY_PAGE_BYTES - reader->filled;
+        if (copy > size)
+        {
+            copy = size;
+        }
+
+        memcpy(reader->page + reader->filled, bytes, copy);
+        reader->filled += copy;
+        bytes += copy;
+        size -= copy;
+
+        if (SSOCK_ARTIFACT_HISTORY_PAGE_BYTES == reader->filled)
+        {
+            retval =
+                reader->onpage(
+                    reader->context, reader->page,
+                    SSOCK_ARTIFACT_HISTORY_PAGE_SIZE);
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+
+            reader->filled = 0U;
+        }
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/**
+ * \file src/artifact_history/ssock_artifact_history_query.c
+ *
+ * \brief Query the history of an artifact.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_artifact_history_internal.h"
+
+/**
+ * \brief Query the history of an artifact.
+ *
+ * The request is written, then the response is read and passed to the
+ * callback a page at a time, with at most SSOCK_ARTIFACT_HISTORY_PAGE_SIZE
+ * ids per page.  If the callback aborts the query, the rest of the response
+ * is left unread, so the socket must be closed.
+ *
+ * \param sock          The socket connected to the server.
+ * \param artifact_id   The id of the artifact.
+ * \param start         The sequence of the first transaction to read.
+ * \param limit         The most transactions to read, or 0 for all of them.
+ * \param onpage        The callback to receive each page.
+ * \param context       The user context to pass to the callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the server sent
+ *        a malformed response.
+ *      - the non-zero status reported by the server, if its read failed.
+ *      - the non-zero status returned by the callback, if it aborts the query.
+ */
+int ssock_artifact_history_query(
+    ssock* sock, const uint8_t* artifact_id, uint64_t start, uint64_t limit,
+    ssock_artifact_history_page_fn onpage, void* context)
+{
+    int retval;
+    int32_t status;
+    uint64_t size;
+    ssock_artifact_history_reader reader;
+    uint8_t buf[SSOCK_ARTIFACT_HISTORY_PAGE_BYTES];
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != artifact_id);
+    MODEL_ASSERT(NULL != onpage);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == artifact_id || NULL == onpage)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* send the request. */
+    retval = ssock_write_data(sock, artifact_id, BLOCK_STORE_ID_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_write_uint64(sock, start);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_write_uint64(sock, limit);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_flush(sock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* read the ids, a page at a time. */
+    reader.onpage = onpage;
+    reader.context = context;
+    reader.filled = 0U;
+    retval =
+        ssock_read_data_stream(
+            sock, buf, sizeof(buf), &ssock_artifact_history_onchunk, &reader,
+            &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the response must hold whole ids. */
+    if (0 != reader.filled % BLOCK_STORE_ID_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    retval = ssock_read_int32(sock, &status);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* on a failure, the ids not yet passed on are dropped. */
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    if (reader.filled > 0)
+    {
+        return
+            onpage(
+                context, reader.page, reader.filled / BLOCK_STORE_ID_SIZE);
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
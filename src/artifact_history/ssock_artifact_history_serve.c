@@ -0,0 +1,164 @@
+/**
+ * \file src/artifact_history/ssock_artifact_history_serve.c
+ *
+ * \brief Serve one artifact history query.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_artifact_history_internal.h"
+
+/* forward decls. */
+static int ssock_artifact_history_read_id(
+    ssock* sock, allocator_options_t* alloc_opts, uint8_t* artifact_id);
+
+/**
+ * \brief Serve one artifact history query.
+ *
+ * The request is read, then the history is read from the store a page at a
+ * time and written to the socket as it is read.  A failure reading the store
+ * ends the stream early, and is reported to the client in the status.
+ *
+ * \param sock          The socket connected to the client.
+ * \param alloc_opts    The allocator to use for reading the request.
+ * \param store         The store to read the history from.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when the failure
+ *        of a store read was reported to the client.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the client sent
+ *        a malformed request.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_artifact_history_serve(
+    ssock* sock, allocator_options_t* alloc_opts, block_store* store)
+{
+    int retval, status = VCBLOCKCHAIN_STATUS_SUCCESS;
+    uint8_t artifact_id[BLOCK_STORE_ID_SIZE];
+    uint64_t start, limit;
+    uint8_t page[SSOCK_ARTIFACT_HISTORY_PAGE_BYTES];
+    size_t count;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != store);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == alloc_opts || NULL == store)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* read the request. */
+    retval = ssock_artifact_history_read_id(sock, alloc_opts, artifact_id);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_read_uint64(sock, &start);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_read_uint64(sock, &limit);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_write_data_stream_begin(sock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* write each page as it is read; a short page is the last. */
+    uint64_t remaining = 0 == limit ? UINT64_MAX : limit;
+    do
+    {
+        size_t max_count = SSOCK_ARTIFACT_HISTORY_PAGE_SIZE;
+        if (max_count > remaining)
+        {
+            max_count = (size_t)remaining;
+        }
+
+        status =
+            block_store_get_artifact_history(
+                store, artifact_id, start, page, max_count, &count);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != status)
+        {
+            break;
+        }
+
+        retval =
+            ssock_write_data_stream_chunk(
+                sock, page, (uint32_t)(count * BLOCK_STORE_ID_SIZE));
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        start += count;
+        remaining -= count;
+    } while (SSOCK_ARTIFACT_HISTORY_PAGE_SIZE == count && remaining > 0);
+
+    retval = ssock_write_data_stream_end(sock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_write_int32(sock, status);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    return ssock_flush(sock);
+}
+
+/**
+ * \brief Read the artifact id of a request.
+ *
+ * \param sock          The socket to read from.
+ * \param alloc_opts    The allocator for the read.
+ * \param artifact_id   The buffer to receive the artifact id.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_artifact_history_read_id(
+    ssock* sock, allocator_options_t* alloc_opts, uint8_t* artifact_id)
+{
+    void* val = NULL;
+    uint32_t size = 0U;
+
+    int retval = ssock_read_data(sock, alloc_opts, &val, &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (BLOCK_STORE_ID_SIZE != size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+    else
+    {
+        memcpy(artifact_id, val, BLOCK_STORE_ID_SIZE);
+    }
+
+    release(alloc_opts, val);
+
+    return retval;
+}
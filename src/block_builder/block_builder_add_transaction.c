@@ -0,0 +1,70 @@
+/**
+ * \file src/block_builder/block_builder_add_transaction.c
+ *
+ * \brief Append a transaction certificate to a block.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_builder_internal.h"
+
+/**
+ * \brief Append a transaction certificate to the block.
+ *
+ * \param builder           The builder.
+ * \param txn               The transaction certificate.
+ * \param size              The size of the transaction certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_CAPACITY if the transaction does not
+ *        fit in the space reserved for transactions.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED if the block has already
+ *        been emitted.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash or Merkle tree could not
+ *        be updated.
+ */
+int block_builder_add_transaction(
+    block_builder* builder, const void* txn, size_t size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != builder);
+    MODEL_ASSERT(NULL != txn);
+
+    /* runtime parameter checks. */
+    if (NULL == builder || NULL == txn)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (builder->emitted)
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED;
+    }
+
+    /* the buffer never grows; the transaction must fit what was reserved. */
+    if (0 == builder->transactions_left || size > BLOCK_BUILDER_MAX_TRANSACTION_SIZE || BLOCK_BUILDER_FIELD_HEADER_SIZE + size > builder->transaction_space)
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_CAPACITY;
+    }
+
+    if (NULL != builder->tree)
+    {
+        int retval = merkle_tree_append(builder->tree, txn, size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    builder->transaction_space -= BLOCK_BUILDER_FIELD_HEADER_SIZE + size;
+    --builder->transactions_left;
+
+    return
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE, txn, size,
+            true);
+}
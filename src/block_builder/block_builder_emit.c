@@ -0,0 +1,152 @@
+/**
+ * \file src/block_builder/block_builder_emit.c
+ *
+ * \brief Sign a block and emit it.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_builder_internal.h"
+
+/**
+ * \brief Sign the block and emit it.
+ *
+ * The block remains owned by the builder, and is valid until the builder is
+ * disposed.
+ *
+ * \param builder           The builder.
+ * \param signer_id         The id of the signer.
+ * \param private_key       The signing key of the signer.
+ * \param block_hash        Buffer of the suite's hash size to receive the
+ *                          block hash.
+ * \param block             Pointer to receive the block.
+ * \param size              Pointer to receive the size of the block.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED if the block has already
+ *        been emitted.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error, or the hash or signature failed.
+ */
+int block_builder_emit(
+    block_builder* builder, const uint8_t* signer_id,
+    const vccrypt_buffer_t* private_key, uint8_t* block_hash,
+    const uint8_t** block, size_t* size)
+{
+    int retval;
+    vccrypt_buffer_t hash_buffer, signature;
+    vccrypt_digital_signature_context_t sign;
+    uint8_t root[MERKLE_TREE_MAX_HASH_SIZE];
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != builder);
+    MODEL_ASSERT(NULL != signer_id);
+    MODEL_ASSERT(NULL != private_key);
+    MODEL_ASSERT(NULL != block_hash);
+    MODEL_ASSERT(NULL != block);
+    MODEL_ASSERT(NULL != size);
+
+    /* runtime parameter checks. */
+    if (NULL == builder || NULL == signer_id || NULL == private_key || NULL == block_hash || NULL == block || NULL == size)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (builder->emitted)
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED;
+    }
+
+    /* from here on, the block can't be reused whatever happens. */
+    builder->emitted = 1;
+
+    if (NULL != builder->tree)
+    {
+        retval = merkle_tree_root(builder->tree, root);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        retval =
+            block_builder_write_field(
+                builder, MERKLE_TREE_FIELD_TYPE_ROOT, root,
+                builder->tree->hash_size, true);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_SIGNER_ID, signer_id,
+            BLOCK_BUILDER_ID_SIZE, true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* every byte so far is already in the hash. */
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_hash(builder->suite, &hash_buffer))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_finalize(&builder->hash, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    memcpy(block_hash, hash_buffer.data, hash_buffer.size);
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_digital_signature_init(builder->suite, &sign))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_signature(builder->suite, &signature))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_sign;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_digital_signature_sign(&sign, &signature, private_key, builder->buffer, builder->offset))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_signature;
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_SIGNATURE, signature.data,
+            signature.size, false);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_signature;
+    }
+
+    *block = builder->buffer;
+    *size = builder->offset;
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_signature:
+    dispose((disposable_t*)&signature);
+
+dispose_sign:
+    dispose((disposable_t*)&sign);
+
+dispose_hash_buffer:
+    dispose((disposable_t*)&hash_buffer);
+
+    return retval;
+}
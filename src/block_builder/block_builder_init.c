@@ -0,0 +1,221 @@
+/**
+ * \file src/block_builder/block_builder_init.c
+ *
+ * \brief Initialize a block builder.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccert/certificate_types.h>
+
+#include "block_builder_internal.h"
+
+/* forward decls. */
+static void block_builder_dispose(void* disposable);
+
+/**
+ * \brief Initialize a block builder, reserving room for the given
+ * transactions.
+ *
+ * The block header fields are written immediately: the certificate version,
+ * crypto suite and certificate type that every block certificate carries,
+ * followed by the block id, previous block id and height.  If a Merkle tree
+ * is given, each transaction is appended to it as it is added, and its root
+ * is written to the block, as a MERKLE_TREE_FIELD_TYPE_ROOT field just before
+ * the signer id, when the block is emitted.  This instance is disposable and
+ * must be disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param builder           The builder to initialize.
+ * \param alloc_opts        The allocator to use for this builder.
+ * \param suite             The crypto suite for the block hash and signature.
+ * \param block_id          The id of the new block.
+ * \param prev_block_id     The id of the previous block.
+ * \param height            The height of the new block.
+ * \param txn_sizes         The sizes of the transactions to be added.
+ * \param txn_count         The number of transactions to be added.
+ * \param tree              An empty Merkle tree on the same suite, which must
+ *                          outlive the builder, or NULL.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        a transaction is larger than BLOCK_BUILDER_MAX_TRANSACTION_SIZE, or
+ *        the Merkle tree is not empty.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_builder_init(
+    block_builder* builder, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, const uint8_t* block_id,
+    const uint8_t* prev_block_id, uint64_t height, const size_t* txn_sizes,
+    size_t txn_count, merkle_tree* tree)
+{
+    int retval;
+    uint8_t version_field[sizeof(uint32_t)];
+    uint8_t suite_field[sizeof(uint16_t)];
+    uint8_t height_field[sizeof(uint64_t)];
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != builder);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != block_id);
+    MODEL_ASSERT(NULL != prev_block_id);
+    MODEL_ASSERT(NULL != txn_sizes || 0 == txn_count);
+
+    /* runtime parameter checks. */
+    if (NULL == builder || NULL == alloc_opts || NULL == suite || NULL == block_id || NULL == prev_block_id || (NULL == txn_sizes && 0 != txn_count) || (NULL != tree && 0 != merkle_tree_count(tree)))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* the transactions take exactly the sum of their fields. */
+    size_t transaction_space = 0U;
+    for (size_t i = 0; i < txn_count; ++i)
+    {
+        if (txn_sizes[i] > BLOCK_BUILDER_MAX_TRANSACTION_SIZE || transaction_space > SIZE_MAX / 2)
+        {
+            return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+        }
+
+        transaction_space += BLOCK_BUILDER_FIELD_HEADER_SIZE + txn_sizes[i];
+    }
+
+    memset(builder, 0, sizeof(block_builder));
+    builder->alloc_opts = alloc_opts;
+    builder->suite = suite;
+    builder->tree = tree;
+    builder->transaction_space = transaction_space;
+    builder->transactions_left = txn_count;
+
+    /* header fields, transactions, signer id, and signature. */
+    builder->capacity =
+        3 * BLOCK_BUILDER_FIELD_HEADER_SIZE + sizeof(version_field)
+      + sizeof(suite_field) + BLOCK_BUILDER_ID_SIZE
+      + 3 * BLOCK_BUILDER_FIELD_HEADER_SIZE + 2 * BLOCK_BUILDER_ID_SIZE
+      + sizeof(height_field)
+      + transaction_space
+      + 2 * BLOCK_BUILDER_FIELD_HEADER_SIZE + BLOCK_BUILDER_ID_SIZE
+      + suite->sign_opts.signature_size;
+
+    /* the Merkle root, if the block commits to one. */
+    if (NULL != tree)
+    {
+        builder->capacity +=
+            BLOCK_BUILDER_FIELD_HEADER_SIZE + tree->hash_size;
+    }
+
+    builder->buffer = (uint8_t*)allocate(alloc_opts, builder->capacity);
+    if (NULL == builder->buffer)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_hash_init(suite, &builder->hash))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto release_buffer;
+    }
+
+    /* integer fields are written big-endian, as vccert writes them. */
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        version_field[i] = (uint8_t)(BLOCK_BUILDER_CERTIFICATE_VERSION >> (8 * (sizeof(uint32_t) - 1 - i)));
+    }
+
+    for (size_t i = 0; i < sizeof(uint16_t); ++i)
+    {
+        suite_field[i] = (uint8_t)(suite->suite_id >> (8 * (sizeof(uint16_t) - 1 - i)));
+    }
+
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+        height_field[i] = (uint8_t)(height >> (8 * (sizeof(uint64_t) - 1 - i)));
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_CERTIFICATE_VERSION, version_field,
+            sizeof(version_field), true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_hash;
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_CERTIFICATE_CRYPTO_SUITE, suite_field,
+            sizeof(suite_field), true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_hash;
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_CERTIFICATE_TYPE,
+            vccert_certificate_type_uuid_txn_block, BLOCK_BUILDER_ID_SIZE,
+            true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_hash;
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_BLOCK_UUID, block_id,
+            BLOCK_BUILDER_ID_SIZE, true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_hash;
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_PREVIOUS_BLOCK_UUID, prev_block_id,
+            BLOCK_BUILDER_ID_SIZE, true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_hash;
+    }
+
+    retval =
+        block_builder_write_field(
+            builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, height_field,
+            sizeof(height_field), true);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_hash;
+    }
+
+    builder->hdr.dispose = &block_builder_dispose;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_hash:
+    dispose((disposable_t*)&builder->hash);
+
+release_buffer:
+    release(alloc_opts, builder->buffer);
+    memset(builder, 0, sizeof(block_builder));
+
+    return retval;
+}
+
+/**
+ * \brief Dispose of a block builder.
+ *
+ * \param disposable    The builder to dispose.
+ */
+static void block_builder_dispose(void* disposable)
+{
+    block_builder* builder = (block_builder*)disposable;
+
+    dispose((disposable_t*)&builder->hash);
+    release(builder->alloc_opts, builder->buffer);
+
+    memset(builder, 0, sizeof(block_builder));
+}
@@ -0,0 +1,48 @@
+/**
+ * \file src/block_builder/block_builder_internal.h
+ *
+ * \brief Internal types and functions for the block builder.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_BLOCK_BUILDER_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_BLOCK_BUILDER_INTERNAL_HEADER_GUARD
+
+#include <stdbool.h>
+#include <vccert/fields.h>
+#include <vcblockchain/block_builder.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The size of a field's type and size prefix.
+ */
+#define BLOCK_BUILDER_FIELD_HEADER_SIZE (FIELD_TYPE_SIZE + FIELD_SIZE_SIZE)
+
+/**
+ * \brief Write a field at the end of the block, which must have room for it.
+ *
+ * \param builder       The builder.
+ * \param type          The field type.
+ * \param value         The field value.
+ * \param size          The size of the field value.
+ * \param hashed        If true, the field is added to the block hash.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash could not be updated.
+ */
+int block_builder_write_field(
+    block_builder* builder, uint16_t type, const void* value, size_t size,
+    bool hashed);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_BLOCK_BUILDER_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,55 @@
+/**
+ * \file src/block_builder/block_builder_write_field.c
+ *
+ * \brief Write a field at the end of a block.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_builder_internal.h"
+
+/**
+ * \brief Write a field at the end of the block, which must have room for it.
+ *
+ * \param builder       The builder.
+ * \param type          The field type.
+ * \param value         The field value.
+ * \param size          The size of the field value.
+ * \param hashed        If true, the field is added to the block hash.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash could not be updated.
+ */
+int block_builder_write_field(
+    block_builder* builder, uint16_t type, const void* value, size_t size,
+    bool hashed)
+{
+    MODEL_ASSERT(NULL != builder);
+    MODEL_ASSERT(NULL != value);
+    MODEL_ASSERT(size <= BLOCK_BUILDER_MAX_TRANSACTION_SIZE);
+    MODEL_ASSERT(builder->offset + BLOCK_BUILDER_FIELD_HEADER_SIZE + size <= builder->capacity);
+
+    uint8_t* field = builder->buffer + builder->offset;
+
+    /* the type and size are big-endian. */
+    field[0] = (uint8_t)(type >> 8);
+    field[1] = (uint8_t)(type & 0xFF);
+    field[2] = (uint8_t)(size >> 8);
+    field[3] = (uint8_t)(size & 0xFF);
+    memcpy(field + BLOCK_BUILDER_FIELD_HEADER_SIZE, value, size);
+
+    builder->offset += BLOCK_BUILDER_FIELD_HEADER_SIZE + size;
+
+    /* the prefix and value are contiguous, so one update covers both. */
+    if (hashed && VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&builder->hash, field, BLOCK_BUILDER_FIELD_HEADER_SIZE + size))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
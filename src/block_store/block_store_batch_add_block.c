@@ -0,0 +1,55 @@
+/**
+ * \file src/block_store/block_store_batch_add_block.c
+ *
+ * \brief Add a block to a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Add a block to a batch.
+ *
+ * The id and block must remain valid until the batch is written or cleared.
+ *
+ * \param batch         The batch.
+ * \param block_id      The id of the block.
+ * \param height        The height of the block.
+ * \param block         The block certificate.
+ * \param size          The size of the block certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_batch_add_block(
+    block_store_batch* batch, const uint8_t* block_id, uint64_t height,
+    const void* block, size_t size)
+{
+    block_store_record record;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != block_id);
+    MODEL_ASSERT(NULL != block);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || NULL == block_id || NULL == block)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    record.type = BLOCK_STORE_RECORD_BLOCK;
+    record.id = block_id;
+    record.artifact_id = NULL;
+    record.height = height;
+    record.data = block;
+    record.size = size;
+
+    return block_store_batch_push(batch, &record);
+}
@@ -0,0 +1,58 @@
+/**
+ * \file src/block_store/block_store_batch_add_transaction.c
+ *
+ * \brief Add a transaction to a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Add a transaction to a batch, making it the latest transaction for
+ * its artifact, and appending it to the artifact's history.
+ *
+ * The ids and transaction must remain valid until the batch is written or
+ * cleared.
+ *
+ * \param batch         The batch.
+ * \param txn_id        The id of the transaction.
+ * \param artifact_id   The id of the artifact the transaction changes.
+ * \param txn           The transaction certificate.
+ * \param size          The size of the transaction certificate.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_batch_add_transaction(
+    block_store_batch* batch, const uint8_t* txn_id,
+    const uint8_t* artifact_id, const void* txn, size_t size)
+{
+    block_store_record record;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != txn_id);
+    MODEL_ASSERT(NULL != artifact_id);
+    MODEL_ASSERT(NULL != txn);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || NULL == txn_id || NULL == artifact_id || NULL == txn)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    record.type = BLOCK_STORE_RECORD_TRANSACTION;
+    record.id = txn_id;
+    record.artifact_id = artifact_id;
+    record.height = 0U;
+    record.data = txn;
+    record.size = size;
+
+    return block_store_batch_push(batch, &record);
+}
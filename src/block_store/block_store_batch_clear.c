@@ -0,0 +1,23 @@
+/**
+ * \file src/block_store/block_store_batch_clear.c
+ *
+ * \brief Remove every record from a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Remove every record from a batch, keeping its space for reuse.
+ *
+ * \param batch         The batch.
+ */
+void block_store_batch_clear(block_store_batch* batch)
+{
+    MODEL_ASSERT(NULL != batch);
+
+    batch->count = 0U;
+}
@@ -0,0 +1,67 @@
+/**
+ * \file src/block_store/block_store_batch_init.c
+ *
+ * \brief Initialize a block store batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/* forward decls. */
+static void block_store_batch_dispose(void* disposable);
+
+/**
+ * \brief Initialize an empty batch.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed.
+ *
+ * \param batch         The batch to initialize.
+ * \param alloc_opts    The allocator to use for this batch.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int block_store_batch_init(
+    block_store_batch* batch, allocator_options_t* alloc_opts)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != alloc_opts);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || NULL == alloc_opts)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* records are allocated on the first add. */
+    memset(batch, 0, sizeof(block_store_batch));
+    batch->hdr.dispose = &block_store_batch_dispose;
+    batch->alloc_opts = alloc_opts;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a batch.
+ *
+ * \param disposable    The batch to dispose.
+ */
+static void block_store_batch_dispose(void* disposable)
+{
+    block_store_batch* batch = (block_store_batch*)disposable;
+
+    if (NULL != batch->records)
+    {
+        release(batch->alloc_opts, batch->records);
+    }
+
+    memset(batch, 0, sizeof(block_store_batch));
+}
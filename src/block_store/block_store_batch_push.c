@@ -0,0 +1,57 @@
+/**
+ * \file src/block_store/block_store_batch_push.c
+ *
+ * \brief Append a record to a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Append a record to a batch, growing it if full.
+ *
+ * \param batch         The batch.
+ * \param record        The record.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_batch_push(
+    block_store_batch* batch, const block_store_record* record)
+{
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != record);
+
+    if (batch->count == batch->capacity)
+    {
+        size_t capacity =
+            0 == batch->capacity
+                ? BLOCK_STORE_BATCH_INITIAL_CAPACITY : 2 * batch->capacity;
+        block_store_record* records = (block_store_record*)
+            allocate(batch->alloc_opts, capacity * sizeof(block_store_record));
+        if (NULL == records)
+        {
+            return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        }
+
+        if (NULL != batch->records)
+        {
+            memcpy(records, batch->records, batch->count * sizeof(block_store_record));
+            release(batch->alloc_opts, batch->records);
+        }
+
+        batch->records = records;
+        batch->capacity = capacity;
+    }
+
+    batch->records[batch->count++] = *record;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,196 @@
+/**
+ * \file src/block_store/block_store_commit_group.c
+ *
+ * \brief Write a group of batches in one transaction.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/* forward decls. */
+static int block_store_put_record(
+    block_store* store, MDB_txn* txn, MDB_cursor* history,
+    const block_store_record* record);
+static int block_store_next_sequence(
+    MDB_cursor* history, const uint8_t* artifact_id, uint64_t* sequence);
+
+/**
+ * \brief Write every batch in a group of queued writes in one transaction.
+ *
+ * \param store         The store.
+ * \param group         The first queued write of the group.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the write failed.
+ */
+int block_store_commit_group(block_store* store, block_store_commit* group)
+{
+    MDB_txn* txn;
+    MDB_cursor* history;
+
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != group);
+
+    if (MDB_SUCCESS != mdb_txn_begin(store->env, NULL, 0, &txn))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    if (MDB_SUCCESS != mdb_cursor_open(txn, store->history_db, &history))
+    {
+        mdb_txn_abort(txn);
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    for (block_store_commit* commit = group; NULL != commit; commit = commit->next)
+    {
+        for (size_t i = 0; i < commit->batch->count; ++i)
+        {
+            if (MDB_SUCCESS != block_store_put_record(store, txn, history, &commit->batch->records[i]))
+            {
+                mdb_cursor_close(history);
+                mdb_txn_abort(txn);
+                return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+            }
+        }
+    }
+
+    mdb_cursor_close(history);
+
+    /* one commit, and one sync, for the whole group. */
+    if (MDB_SUCCESS != mdb_txn_commit(txn))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    ++store->commits;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write one record's rows.
+ *
+ * \param store         The store.
+ * \param txn           The write transaction.
+ * \param history       A cursor on the history table.
+ * \param record        The record.
+ *
+ * \returns an LMDB status code.
+ */
+static int block_store_put_record(
+    block_store* store, MDB_txn* txn, MDB_cursor* history,
+    const block_store_record* record)
+{
+    int retval;
+    uint8_t height_key[BLOCK_STORE_HEIGHT_KEY_SIZE];
+    uint8_t history_key[BLOCK_STORE_HISTORY_KEY_SIZE];
+    uint64_t sequence;
+    MDB_val key = { BLOCK_STORE_ID_SIZE, (void*)record->id };
+    MDB_val value = { record->size, (void*)record->data };
+
+    if (BLOCK_STORE_RECORD_TRANSACTION == record->type)
+    {
+        MDB_val artifact = { BLOCK_STORE_ID_SIZE, (void*)record->artifact_id };
+
+        retval = mdb_put(txn, store->transaction_db, &key, &value, 0);
+        if (MDB_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        retval = mdb_put(txn, store->artifact_db, &artifact, &key, 0);
+        if (MDB_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        retval = block_store_next_sequence(history, record->artifact_id, &sequence);
+        if (MDB_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        MDB_val entry = { sizeof(history_key), history_key };
+        block_store_history_key(record->artifact_id, sequence, history_key);
+        return mdb_put(txn, store->history_db, &entry, &key, 0);
+    }
+
+    retval = mdb_put(txn, store->block_db, &key, &value, 0);
+    if (MDB_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* heights usually arrive in order, so try appending first; this skips
+     * the search, and fills pages completely instead of splitting them. */
+    MDB_val height = { sizeof(height_key), height_key };
+    block_store_height_key(record->height, height_key);
+    retval = mdb_put(txn, store->height_db, &height, &key, MDB_APPEND);
+    if (MDB_KEYEXIST == retval)
+    {
+        retval = mdb_put(txn, store->height_db, &height, &key, 0);
+    }
+
+    return retval;
+}
+
+/**
+ * \brief Find the next sequence for an artifact, one past its last history
+ * entry.  This sees entries written earlier in the same transaction.
+ *
+ * \param history       A cursor on the history table.
+ * \param artifact_id   The id of the artifact.
+ * \param sequence      Pointer to receive the sequence.
+ *
+ * \returns an LMDB status code.
+ */
+static int block_store_next_sequence(
+    MDB_cursor* history, const uint8_t* artifact_id, uint64_t* sequence)
+{
+    int retval;
+    uint8_t last[BLOCK_STORE_HISTORY_KEY_SIZE];
+    MDB_val key = { sizeof(last), last };
+    MDB_val value;
+
+    /* seek past the artifact's last possible key, then step back. */
+    block_store_history_key(artifact_id, UINT64_MAX, last);
+    retval = mdb_cursor_get(history, &key, &value, MDB_SET_RANGE);
+    if (MDB_SUCCESS == retval)
+    {
+        retval = mdb_cursor_get(history, &key, &value, MDB_PREV);
+    }
+    else if (MDB_NOTFOUND == retval)
+    {
+        retval = mdb_cursor_get(history, &key, &value, MDB_LAST);
+    }
+
+    if (MDB_NOTFOUND == retval)
+    {
+        *sequence = 0U;
+        return MDB_SUCCESS;
+    }
+    else if (MDB_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the key found belongs to an earlier artifact if this one has none. */
+    if (BLOCK_STORE_HISTORY_KEY_SIZE != key.mv_size || 0 != memcmp(key.mv_data, artifact_id, BLOCK_STORE_ID_SIZE))
+    {
+        *sequence = 0U;
+        return MDB_SUCCESS;
+    }
+
+    *sequence =
+        block_store_height_from_key(
+            (const uint8_t*)key.mv_data + BLOCK_STORE_ID_SIZE) + 1;
+
+    return MDB_SUCCESS;
+}
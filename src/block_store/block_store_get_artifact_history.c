@@ -0,0 +1,120 @@
+/**
+ * \file src/block_store/block_store_get_artifact_history.c
+ *
+ * \brief Read a page of an artifact's history.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read a page of an artifact's history.
+ *
+ * Each transaction added for an artifact is given the next sequence number
+ * for that artifact, starting from 0, in the order the transactions are
+ * committed.  This reads the ids of the transactions from the given sequence
+ * on, in sequence order, by scanning forward from that key; so a caller
+ * pages through a history by starting each page at the previous start plus
+ * the previous count, and has reached the end when a page comes back short.
+ *
+ * \param store         The store.
+ * \param artifact_id   The id of the artifact.
+ * \param start         The sequence of the first transaction to read.
+ * \param txn_ids       Buffer of max_count * BLOCK_STORE_ID_SIZE bytes to
+ *                      receive the transaction ids.
+ * \param max_count     The most transaction ids to read.
+ * \param count         Pointer to receive the number of ids read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when there are no
+ *        transactions from the given sequence on.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_artifact_history(
+    block_store* store, const uint8_t* artifact_id, uint64_t start,
+    uint8_t* txn_ids, size_t max_count, size_t* count)
+{
+    int retval, mdb_retval;
+    MDB_txn* txn;
+    MDB_cursor* cursor;
+    uint8_t first[BLOCK_STORE_HISTORY_KEY_SIZE];
+    MDB_val key = { sizeof(first), first };
+    MDB_val value;
+    size_t found = 0U;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != artifact_id);
+    MODEL_ASSERT(NULL != txn_ids || 0 == max_count);
+    MODEL_ASSERT(NULL != count);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == artifact_id || (NULL == txn_ids && 0 != max_count) || NULL == count)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    *count = 0U;
+    if (0 == max_count)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    retval = block_store_read_begin(store, &txn);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (MDB_SUCCESS != mdb_cursor_open(txn, store->history_db, &cursor))
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto read_end;
+    }
+
+    /* the history is one run of keys; seek to the start, then walk it. */
+    block_store_history_key(artifact_id, start, first);
+    mdb_retval = mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE);
+    while (MDB_SUCCESS == mdb_retval && found < max_count)
+    {
+        if (BLOCK_STORE_HISTORY_KEY_SIZE != key.mv_size || 0 != memcmp(key.mv_data, artifact_id, BLOCK_STORE_ID_SIZE))
+        {
+            break;
+        }
+
+        if (BLOCK_STORE_ID_SIZE != value.mv_size)
+        {
+            retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+            goto close_cursor;
+        }
+
+        memcpy(txn_ids + found * BLOCK_STORE_ID_SIZE, value.mv_data, BLOCK_STORE_ID_SIZE);
+        ++found;
+
+        mdb_retval = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+    }
+
+    if (MDB_SUCCESS != mdb_retval && MDB_NOTFOUND != mdb_retval)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto close_cursor;
+    }
+
+    *count = found;
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+close_cursor:
+    mdb_cursor_close(cursor);
+
+read_end:
+    block_store_read_end(txn);
+
+    return retval;
+}
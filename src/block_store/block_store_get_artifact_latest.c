@@ -0,0 +1,45 @@
+/**
+ * \file src/block_store/block_store_get_artifact_latest.c
+ *
+ * \brief Read the id of the latest transaction for an artifact.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read the id of the latest transaction for an artifact.
+ *
+ * \param store         The store.
+ * \param artifact_id   The id of the artifact.
+ * \param txn_id        Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the artifact has no
+ *        transactions.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_artifact_latest(
+    block_store* store, const uint8_t* artifact_id, uint8_t* txn_id)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != artifact_id);
+    MODEL_ASSERT(NULL != txn_id);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == artifact_id || NULL == txn_id)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    return
+        block_store_read_id(
+            store, store->artifact_db, artifact_id, BLOCK_STORE_ID_SIZE,
+            txn_id);
+}
@@ -0,0 +1,46 @@
+/**
+ * \file src/block_store/block_store_get_block.c
+ *
+ * \brief Read a block by id.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read a block by id.
+ *
+ * \param store         The store.
+ * \param block_id      The id of the block.
+ * \param block         Buffer to initialize with a copy of the block, which
+ *                      the caller must dispose.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such block.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_get_block(
+    block_store* store, const uint8_t* block_id, vccrypt_buffer_t* block)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != block_id);
+    MODEL_ASSERT(NULL != block);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == block_id || NULL == block)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    return
+        block_store_read_buffer(
+            store, store->block_db, block_id, BLOCK_STORE_ID_SIZE, block);
+}
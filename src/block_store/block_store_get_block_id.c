@@ -0,0 +1,47 @@
+/**
+ * \file src/block_store/block_store_get_block_id.c
+ *
+ * \brief Read the id of the block at a height.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read the id of the block at a height.
+ *
+ * \param store         The store.
+ * \param height        The height.
+ * \param block_id      Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no block at the
+ *        height.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_block_id(
+    block_store* store, uint64_t height, uint8_t* block_id)
+{
+    uint8_t key[BLOCK_STORE_HEIGHT_KEY_SIZE];
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != block_id);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == block_id)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    block_store_height_key(height, key);
+
+    return
+        block_store_read_id(
+            store, store->height_db, key, sizeof(key), block_id);
+}
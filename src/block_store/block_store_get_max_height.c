@@ -0,0 +1,74 @@
+/**
+ * \file src/block_store/block_store_get_max_height.c
+ *
+ * \brief Read the greatest height with a block.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read the greatest height with a block.
+ *
+ * \param store         The store.
+ * \param height        Pointer to receive the height.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the store has no blocks.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ */
+int block_store_get_max_height(block_store* store, uint64_t* height)
+{
+    int retval;
+    MDB_txn* txn;
+    MDB_cursor* cursor;
+    MDB_val key, value;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != height);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == height)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    retval = block_store_read_begin(store, &txn);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (MDB_SUCCESS != mdb_cursor_open(txn, store->height_db, &cursor))
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto read_end;
+    }
+
+    /* height keys sort by height, so the last key is the greatest. */
+    retval = block_store_status(mdb_cursor_get(cursor, &key, &value, MDB_LAST));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        if (BLOCK_STORE_HEIGHT_KEY_SIZE == key.mv_size)
+        {
+            *height = block_store_height_from_key((const uint8_t*)key.mv_data);
+        }
+        else
+        {
+            retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        }
+    }
+
+    mdb_cursor_close(cursor);
+
+read_end:
+    block_store_read_end(txn);
+
+    return retval;
+}
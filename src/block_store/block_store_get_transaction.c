@@ -0,0 +1,47 @@
+/**
+ * \file src/block_store/block_store_get_transaction.c
+ *
+ * \brief Read a transaction by id.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read a transaction by id.
+ *
+ * \param store         The store.
+ * \param txn_id        The id of the transaction.
+ * \param txn           Buffer to initialize with a copy of the transaction,
+ *                      which the caller must dispose.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such
+ *        transaction.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_get_transaction(
+    block_store* store, const uint8_t* txn_id, vccrypt_buffer_t* txn)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != txn_id);
+    MODEL_ASSERT(NULL != txn);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == txn_id || NULL == txn)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    return
+        block_store_read_buffer(
+            store, store->transaction_db, txn_id, BLOCK_STORE_ID_SIZE, txn);
+}
@@ -0,0 +1,186 @@
+/**
+ * \file src/block_store/block_store_init.c
+ *
+ * \brief Open a block store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/* forward decls. */
+static void block_store_dispose(void* disposable);
+static int block_store_open_tables(block_store* store);
+
+/**
+ * \brief Open a block store, creating it if it does not exist.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed.  No thread may be using the store when it is
+ * disposed, and no thread which has read from the store may exit while it is
+ * being disposed: each such thread must either have been joined already, or
+ * keep running until dispose returns.  A thread which exits first releases
+ * its own read transaction; dispose releases the rest.
+ *
+ * \param store         The store to initialize.
+ * \param alloc_opts    The allocator to use for this store.
+ * \param path          The directory holding the database.
+ * \param map_size      The largest size the database may grow to; 0 selects
+ *                      BLOCK_STORE_DEFAULT_MAP_SIZE.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the database could not be
+ *        opened.
+ */
+int block_store_init(
+    block_store* store, allocator_options_t* alloc_opts, const char* path,
+    size_t map_size)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != path);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == alloc_opts || NULL == path)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(store, 0, sizeof(block_store));
+    store->alloc_opts = alloc_opts;
+
+    if (MDB_SUCCESS != mdb_env_create(&store->env))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (MDB_SUCCESS != mdb_env_set_maxdbs(store->env, 5) || MDB_SUCCESS != mdb_env_set_mapsize(store->env, 0 == map_size ? BLOCK_STORE_DEFAULT_MAP_SIZE : map_size) || MDB_SUCCESS != mdb_env_open(store->env, path, 0, 0600))
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto close_env;
+    }
+
+    retval = block_store_open_tables(store);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto close_env;
+    }
+
+    if (0 != pthread_key_create(&store->reader_key, &block_store_reader_release))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto close_env;
+    }
+
+    if (0 != pthread_mutex_init(&store->reader_lock, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto delete_key;
+    }
+
+    if (0 != pthread_mutex_init(&store->write_lock, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto destroy_reader_lock;
+    }
+
+    if (0 != pthread_cond_init(&store->written, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto destroy_write_lock;
+    }
+
+    store->hdr.dispose = &block_store_dispose;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+destroy_write_lock:
+    pthread_mutex_destroy(&store->write_lock);
+
+destroy_reader_lock:
+    pthread_mutex_destroy(&store->reader_lock);
+
+delete_key:
+    pthread_key_delete(store->reader_key);
+
+close_env:
+    mdb_env_close(store->env);
+    memset(store, 0, sizeof(block_store));
+
+    return retval;
+}
+
+/**
+ * \brief Open the store's tables, creating any which are missing.
+ *
+ * \param store         The store.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int block_store_open_tables(block_store* store)
+{
+    MDB_txn* txn;
+
+    if (MDB_SUCCESS != mdb_txn_begin(store->env, NULL, 0, &txn))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    if (MDB_SUCCESS != mdb_dbi_open(txn, "block", MDB_CREATE, &store->block_db) || MDB_SUCCESS != mdb_dbi_open(txn, "block_height", MDB_CREATE, &store->height_db) || MDB_SUCCESS != mdb_dbi_open(txn, "transaction", MDB_CREATE, &store->transaction_db) || MDB_SUCCESS != mdb_dbi_open(txn, "artifact", MDB_CREATE, &store->artifact_db) || MDB_SUCCESS != mdb_dbi_open(txn, "artifact_history", MDB_CREATE, &store->history_db))
+    {
+        mdb_txn_abort(txn);
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    if (MDB_SUCCESS != mdb_txn_commit(txn))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a block store, ending every thread's read transaction.
+ *
+ * \param disposable    The store to dispose.
+ */
+static void block_store_dispose(void* disposable)
+{
+    block_store* store = (block_store*)disposable;
+
+    /* no destructor runs once the key is deleted.  No reader thread is
+     * allowed to exit during dispose, so none is still running either, and
+     * every reader left in the list belongs to a live, idle thread. */
+    pthread_key_delete(store->reader_key);
+
+    pthread_mutex_lock(&store->reader_lock);
+    while (NULL != store->readers)
+    {
+        block_store_reader* reader = store->readers;
+        store->readers = reader->next;
+
+        mdb_txn_abort(reader->txn);
+        release(store->alloc_opts, reader);
+    }
+    pthread_mutex_unlock(&store->reader_lock);
+
+    pthread_cond_destroy(&store->written);
+    pthread_mutex_destroy(&store->write_lock);
+    pthread_mutex_destroy(&store->reader_lock);
+    mdb_env_close(store->env);
+
+    memset(store, 0, sizeof(block_store));
+}
@@ -0,0 +1,207 @@
+/**
+ * \file src/block_store/block_store_internal.h
+ *
+ * \brief Internal types and functions for the block store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_BLOCK_STORE_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_BLOCK_STORE_INTERNAL_HEADER_GUARD
+
+#include <string.h>
+#include <vcblockchain/block_store.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The size of a height key.
+ */
+#define BLOCK_STORE_HEIGHT_KEY_SIZE 8
+
+/**
+ * \brief The size of a history key: an artifact id, then a sequence.
+ */
+#define BLOCK_STORE_HISTORY_KEY_SIZE (BLOCK_STORE_ID_SIZE + 8)
+
+/**
+ * \brief One thread's read transaction, kept between reads.
+ */
+struct block_store_reader
+{
+    block_store* store;
+    MDB_txn* txn;
+    block_store_reader* prev;
+    block_store_reader* next;
+};
+
+/**
+ * \brief A batch waiting to be committed.  This lives on the writer's stack
+ * until the commit which includes it is done.
+ */
+struct block_store_commit
+{
+    const block_store_batch* batch;
+    int status;
+    uint8_t done;
+    block_store_commit* next;
+};
+
+/**
+ * \brief Begin a read on this thread, renewing its read transaction.
+ *
+ * \param store         The store.
+ * \param txn           Pointer to receive the read transaction, which must be
+ *                      passed to \ref block_store_read_end() when done.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the transaction could not
+ *        be begun.
+ */
+int block_store_read_begin(block_store* store, MDB_txn** txn);
+
+/**
+ * \brief End a read, resetting the read transaction for the next read.
+ *
+ * \param txn           The read transaction.
+ */
+void block_store_read_end(MDB_txn* txn);
+
+/**
+ * \brief End a thread's read transaction and forget it.  This is the
+ * destructor of the store's thread key, so it also runs on thread exit.
+ *
+ * \param reader        The reader.
+ */
+void block_store_reader_release(void* reader);
+
+/**
+ * \brief Write every batch in a group of queued writes in one transaction.
+ *
+ * \param store         The store.
+ * \param group         The first queued write of the group.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the write failed.
+ */
+int block_store_commit_group(block_store* store, block_store_commit* group);
+
+/**
+ * \brief Read a fixed-size value stored under a key.
+ *
+ * \param store         The store.
+ * \param dbi           The table.
+ * \param key           The key.
+ * \param key_size      The size of the key.
+ * \param value         Buffer of BLOCK_STORE_ID_SIZE bytes for the value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such key.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed, or the
+ *        value is not an id.
+ */
+int block_store_read_id(
+    block_store* store, MDB_dbi dbi, const void* key, size_t key_size,
+    uint8_t* value);
+
+/**
+ * \brief Read a value stored under a key into a new buffer.
+ *
+ * \param store         The store.
+ * \param dbi           The table.
+ * \param key           The key.
+ * \param key_size      The size of the key.
+ * \param value         Buffer to initialize with a copy of the value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such key.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_read_buffer(
+    block_store* store, MDB_dbi dbi, const void* key, size_t key_size,
+    vccrypt_buffer_t* value);
+
+/**
+ * \brief Append a record to a batch, growing it if full.
+ *
+ * \param batch         The batch.
+ * \param record        The record.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_batch_push(
+    block_store_batch* batch, const block_store_record* record);
+
+/**
+ * \brief Encode a height as a big-endian key, so keys sort by height.
+ */
+static inline void block_store_height_key(uint64_t height, uint8_t* key)
+{
+    for (size_t i = 0; i < BLOCK_STORE_HEIGHT_KEY_SIZE; ++i)
+    {
+        key[i] = (uint8_t)(height >> (8 * (BLOCK_STORE_HEIGHT_KEY_SIZE - 1 - i)));
+    }
+}
+
+/**
+ * \brief Decode a big-endian height key.
+ */
+static inline uint64_t block_store_height_from_key(const uint8_t* key)
+{
+    uint64_t height = 0;
+    for (size_t i = 0; i < BLOCK_STORE_HEIGHT_KEY_SIZE; ++i)
+    {
+        height = (height << 8) | key[i];
+    }
+
+    return height;
+}
+
+/**
+ * \brief Encode an artifact id and sequence as a history key.
+ */
+static inline void block_store_history_key(
+    const uint8_t* artifact_id, uint64_t sequence, uint8_t* key)
+{
+    memcpy(key, artifact_id, BLOCK_STORE_ID_SIZE);
+    block_store_height_key(sequence, key + BLOCK_STORE_ID_SIZE);
+}
+
+/**
+ * \brief Map an LMDB read status to a block store status.
+ */
+static inline int block_store_status(int mdb_status)
+{
+    switch (mdb_status)
+    {
+        case MDB_SUCCESS:
+            return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+        case MDB_NOTFOUND:
+            return VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND;
+
+        default:
+            return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+}
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_BLOCK_STORE_INTERNAL_HEADER_GUARD*/
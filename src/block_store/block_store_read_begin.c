@@ -0,0 +1,82 @@
+/**
+ * \file src/block_store/block_store_read_begin.c
+ *
+ * \brief Begin a read on this thread.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Begin a read on this thread, renewing its read transaction.
+ *
+ * \param store         The store.
+ * \param txn           Pointer to receive the read transaction, which must be
+ *                      passed to \ref block_store_read_end() when done.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the transaction could not
+ *        be begun.
+ */
+int block_store_read_begin(block_store* store, MDB_txn** txn)
+{
+    block_store_reader* reader;
+
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != txn);
+
+    /* renewing a reset transaction skips most of the work of beginning one. */
+    reader = (block_store_reader*)pthread_getspecific(store->reader_key);
+    if (NULL != reader)
+    {
+        if (MDB_SUCCESS != mdb_txn_renew(reader->txn))
+        {
+            return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        }
+
+        *txn = reader->txn;
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    reader = (block_store_reader*)
+        allocate(store->alloc_opts, sizeof(block_store_reader));
+    if (NULL == reader)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    reader->store = store;
+    reader->prev = NULL;
+    if (MDB_SUCCESS != mdb_txn_begin(store->env, NULL, MDB_RDONLY, &reader->txn))
+    {
+        release(store->alloc_opts, reader);
+        return VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+    }
+
+    if (0 != pthread_setspecific(store->reader_key, reader))
+    {
+        mdb_txn_abort(reader->txn);
+        release(store->alloc_opts, reader);
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    pthread_mutex_lock(&store->reader_lock);
+    reader->next = store->readers;
+    if (NULL != reader->next)
+    {
+        reader->next->prev = reader;
+    }
+    store->readers = reader;
+    pthread_mutex_unlock(&store->reader_lock);
+
+    *txn = reader->txn;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,71 @@
+/**
+ * \file src/block_store/block_store_read_buffer.c
+ *
+ * \brief Read a value stored under a key into a new buffer.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read a value stored under a key into a new buffer.
+ *
+ * \param store         The store.
+ * \param dbi           The table.
+ * \param key           The key.
+ * \param key_size      The size of the key.
+ * \param value         Buffer to initialize with a copy of the value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such key.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_store_read_buffer(
+    block_store* store, MDB_dbi dbi, const void* key, size_t key_size,
+    vccrypt_buffer_t* value)
+{
+    int retval;
+    MDB_txn* txn;
+    MDB_val mkey = { key_size, (void*)key };
+    MDB_val mvalue;
+
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != key);
+    MODEL_ASSERT(NULL != value);
+
+    retval = block_store_read_begin(store, &txn);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = block_store_status(mdb_get(txn, dbi, &mkey, &mvalue));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto read_end;
+    }
+
+    /* the value lives in the map only while the transaction is open. */
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_buffer_init(value, store->alloc_opts, mvalue.mv_size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto read_end;
+    }
+
+    memcpy(value->data, mvalue.mv_data, mvalue.mv_size);
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+read_end:
+    block_store_read_end(txn);
+
+    return retval;
+}
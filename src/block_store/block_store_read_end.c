@@ -0,0 +1,24 @@
+/**
+ * \file src/block_store/block_store_read_end.c
+ *
+ * \brief End a read on this thread.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief End a read, resetting the read transaction for the next read.
+ *
+ * \param txn           The read transaction.
+ */
+void block_store_read_end(MDB_txn* txn)
+{
+    MODEL_ASSERT(NULL != txn);
+
+    /* release the snapshot, so writers can reuse its pages. */
+    mdb_txn_reset(txn);
+}
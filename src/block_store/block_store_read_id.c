@@ -0,0 +1,64 @@
+/**
+ * \file src/block_store/block_store_read_id.c
+ *
+ * \brief Read an id stored under a key.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Read a fixed-size value stored under a key.
+ *
+ * \param store         The store.
+ * \param dbi           The table.
+ * \param key           The key.
+ * \param key_size      The size of the key.
+ * \param value         Buffer of BLOCK_STORE_ID_SIZE bytes for the value.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if there is no such key.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed, or the
+ *        value is not an id.
+ */
+int block_store_read_id(
+    block_store* store, MDB_dbi dbi, const void* key, size_t key_size,
+    uint8_t* value)
+{
+    int retval;
+    MDB_txn* txn;
+    MDB_val mkey = { key_size, (void*)key };
+    MDB_val mvalue;
+
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != key);
+    MODEL_ASSERT(NULL != value);
+
+    retval = block_store_read_begin(store, &txn);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = block_store_status(mdb_get(txn, dbi, &mkey, &mvalue));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        if (BLOCK_STORE_ID_SIZE == mvalue.mv_size)
+        {
+            memcpy(value, mvalue.mv_data, BLOCK_STORE_ID_SIZE);
+        }
+        else
+        {
+            retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        }
+    }
+
+    block_store_read_end(txn);
+
+    return retval;
+}
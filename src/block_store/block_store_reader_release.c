@@ -0,0 +1,48 @@
+/**
+ * \file src/block_store/block_store_reader_release.c
+ *
+ * \brief End a thread's read transaction.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief End a thread's read transaction and forget it.  This is the
+ * destructor of the store's thread key, so it also runs on thread exit.
+ *
+ * \param reader        The reader.
+ */
+void block_store_reader_release(void* reader)
+{
+    block_store_reader* r = (block_store_reader*)reader;
+    block_store* store = r->store;
+
+    MODEL_ASSERT(NULL != r);
+
+    /* the store may not be disposed while a reader thread exits, so it is
+     * still open.  The reader is released under the lock, so dispose never
+     * sees it half released. */
+    pthread_mutex_lock(&store->reader_lock);
+    MODEL_ASSERT(NULL != store->env);
+    if (NULL != r->prev)
+    {
+        r->prev->next = r->next;
+    }
+    else
+    {
+        store->readers = r->next;
+    }
+
+    if (NULL != r->next)
+    {
+        r->next->prev = r->prev;
+    }
+
+    mdb_txn_abort(r->txn);
+    release(store->alloc_opts, r);
+    pthread_mutex_unlock(&store->reader_lock);
+}
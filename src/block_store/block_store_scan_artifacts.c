@@ -0,0 +1,131 @@
+/**
+ * \file src/block_store/block_store_scan_artifacts.c
+ *
+ * \brief Scan the latest transaction of every artifact.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Scan the latest transaction of every artifact, in artifact id order,
+ * along with the tip of the chain.
+ *
+ * The artifacts and the tip are read from one snapshot of the store, so the
+ * artifacts are the state as of the tip, provided each block's transactions
+ * are written in the same batch as the block.  The callback must not read
+ * from the store itself, since the scan holds this thread's read transaction.
+ *
+ * \param store         The store.
+ * \param onartifact    The callback to receive each artifact.
+ * \param context       The user context to pass to the callback.
+ * \param height        Pointer to receive the greatest height with a block.
+ * \param block_id      Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id
+ *                      of the block at that height.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the store has no blocks.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - the non-zero status returned by the callback, if it stops the scan.
+ */
+int block_store_scan_artifacts(
+    block_store* store, block_store_artifact_fn onartifact, void* context,
+    uint64_t* height, uint8_t* block_id)
+{
+    int retval, mdb_retval;
+    MDB_txn* txn;
+    MDB_cursor* cursor;
+    MDB_val key, value;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != onartifact);
+    MODEL_ASSERT(NULL != height);
+    MODEL_ASSERT(NULL != block_id);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == onartifact || NULL == height || NULL == block_id)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    retval = block_store_read_begin(store, &txn);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the tip is the last height key. */
+    if (MDB_SUCCESS != mdb_cursor_open(txn, store->height_db, &cursor))
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto read_end;
+    }
+
+    retval = block_store_status(mdb_cursor_get(cursor, &key, &value, MDB_LAST));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto close_cursor;
+    }
+
+    if (BLOCK_STORE_HEIGHT_KEY_SIZE != key.mv_size || BLOCK_STORE_ID_SIZE != value.mv_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto close_cursor;
+    }
+
+    *height = block_store_height_from_key((const uint8_t*)key.mv_data);
+    memcpy(block_id, value.mv_data, BLOCK_STORE_ID_SIZE);
+    mdb_cursor_close(cursor);
+
+    /* then every artifact, in key order. */
+    if (MDB_SUCCESS != mdb_cursor_open(txn, store->artifact_db, &cursor))
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto read_end;
+    }
+
+    mdb_retval = mdb_cursor_get(cursor, &key, &value, MDB_FIRST);
+    while (MDB_SUCCESS == mdb_retval)
+    {
+        if (BLOCK_STORE_ID_SIZE != key.mv_size || BLOCK_STORE_ID_SIZE != value.mv_size)
+        {
+            retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+            goto close_cursor;
+        }
+
+        retval =
+            onartifact(
+                context, (const uint8_t*)key.mv_data,
+                (const uint8_t*)value.mv_data);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto close_cursor;
+        }
+
+        mdb_retval = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+    }
+
+    if (MDB_NOTFOUND != mdb_retval)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto close_cursor;
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+close_cursor:
+    mdb_cursor_close(cursor);
+
+read_end:
+    block_store_read_end(txn);
+
+    return retval;
+}
@@ -0,0 +1,120 @@
+/**
+ * \file src/block_store/block_store_scan_blocks.c
+ *
+ * \brief Scan the blocks in a range of heights.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/**
+ * \brief Scan the blocks in a range of heights, in height order.
+ *
+ * The whole range is read from one snapshot of the store by walking a cursor
+ * over the height table, and each block is passed to the callback without
+ * being copied.  The callback must not read from the store itself, since the
+ * scan holds this thread's read transaction.  While the snapshot is held,
+ * pages freed by writers can't be reused, so a caller feeding a slow consumer
+ * should scan in bounded slices.
+ *
+ * \param store         The store.
+ * \param start         The lowest height to scan.
+ * \param end           The highest height to scan.
+ * \param onblock       The callback to receive each block.
+ * \param context       The user context to pass to the callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when there are no
+ *        blocks in the range.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the read failed.
+ *      - the non-zero status returned by the callback, if it stops the scan.
+ */
+int block_store_scan_blocks(
+    block_store* store, uint64_t start, uint64_t end,
+    block_store_block_fn onblock, void* context)
+{
+    int retval, mdb_retval;
+    MDB_txn* txn;
+    MDB_cursor* cursor;
+    uint8_t first[BLOCK_STORE_HEIGHT_KEY_SIZE];
+    MDB_val key = { sizeof(first), first };
+    MDB_val id, block;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != onblock);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == onblock)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    retval = block_store_read_begin(store, &txn);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (MDB_SUCCESS != mdb_cursor_open(txn, store->height_db, &cursor))
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto read_end;
+    }
+
+    block_store_height_key(start, first);
+    mdb_retval = mdb_cursor_get(cursor, &key, &id, MDB_SET_RANGE);
+    while (MDB_SUCCESS == mdb_retval)
+    {
+        if (BLOCK_STORE_HEIGHT_KEY_SIZE != key.mv_size || BLOCK_STORE_ID_SIZE != id.mv_size)
+        {
+            retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+            goto close_cursor;
+        }
+
+        uint64_t height = block_store_height_from_key((const uint8_t*)key.mv_data);
+        if (height > end)
+        {
+            break;
+        }
+
+        /* every height maps to a stored block. */
+        if (MDB_SUCCESS != mdb_get(txn, store->block_db, &id, &block))
+        {
+            retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+            goto close_cursor;
+        }
+
+        retval =
+            onblock(
+                context, height, (const uint8_t*)id.mv_data, block.mv_data,
+                block.mv_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto close_cursor;
+        }
+
+        mdb_retval = mdb_cursor_get(cursor, &key, &id, MDB_NEXT);
+    }
+
+    if (MDB_SUCCESS != mdb_retval && MDB_NOTFOUND != mdb_retval)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE;
+        goto close_cursor;
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+close_cursor:
+    mdb_cursor_close(cursor);
+
+read_end:
+    block_store_read_end(txn);
+
+    return retval;
+}
@@ -0,0 +1,135 @@
+/**
+ * \file src/block_store/block_store_write.c
+ *
+ * \brief Write a batch to a block store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_store_internal.h"
+
+/* forward decls. */
+static void block_store_commit_statuses(
+    block_store* store, block_store_commit* group);
+
+/**
+ * \brief Write a batch to the store, returning once it is committed.
+ *
+ * Records are written in batch order, and batches committed together are
+ * written in the order they arrived.  A record replaces any record already
+ * stored under its key.  If a group's transaction fails, each of its batches
+ * is retried in a transaction of its own, so a batch only fails if it fails
+ * alone, and a batch which fails writes none of its records.
+ *
+ * \param store         The store.
+ * \param batch         The batch.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if the write failed.
+ */
+int block_store_write(block_store* store, const block_store_batch* batch)
+{
+    block_store_commit commit;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != batch);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == batch)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    commit.batch = batch;
+    commit.status = VCBLOCKCHAIN_STATUS_SUCCESS;
+    commit.done = 0;
+    commit.next = NULL;
+
+    pthread_mutex_lock(&store->write_lock);
+
+    if (NULL == store->queue_tail)
+    {
+        store->queue_head = &commit;
+    }
+    else
+    {
+        store->queue_tail->next = &commit;
+    }
+    store->queue_tail = &commit;
+
+    while (!commit.done)
+    {
+        /* while a commit is running, later writers queue up behind it. */
+        if (store->committing)
+        {
+            pthread_cond_wait(&store->written, &store->write_lock);
+            continue;
+        }
+
+        /* otherwise, this writer commits everything queued so far. */
+        block_store_commit* group = store->queue_head;
+        store->queue_head = store->queue_tail = NULL;
+        store->committing = 1;
+        pthread_mutex_unlock(&store->write_lock);
+
+        block_store_commit_statuses(store, group);
+
+        pthread_mutex_lock(&store->write_lock);
+        while (NULL != group)
+        {
+            /* the waiter may return as soon as it sees done. */
+            block_store_commit* next = group->next;
+            group->done = 1;
+            group = next;
+        }
+
+        store->committing = 0;
+        pthread_cond_broadcast(&store->written);
+    }
+
+    pthread_mutex_unlock(&store->write_lock);
+
+    return commit.status;
+}
+
+/**
+ * \brief Commit a group, and set the status of each of its writes.
+ *
+ * If the group fails as a whole, each write is retried on its own, so one
+ * bad batch doesn't fail the unrelated batches grouped with it.
+ *
+ * \param store         The store.
+ * \param group         The first queued write of the group.
+ */
+static void block_store_commit_statuses(
+    block_store* store, block_store_commit* group)
+{
+    block_store_commit* commit;
+    block_store_commit* next;
+
+    int status = block_store_commit_group(store, group);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == status || NULL == group->next)
+    {
+        for (commit = group; NULL != commit; commit = commit->next)
+        {
+            commit->status = status;
+        }
+
+        return;
+    }
+
+    /* no waiter returns before it is marked done, so the group can be split
+     * for the retries. */
+    for (commit = group; NULL != commit; commit = next)
+    {
+        next = commit->next;
+        commit->next = NULL;
+        commit->status = block_store_commit_group(store, commit);
+        commit->next = next;
+    }
+}
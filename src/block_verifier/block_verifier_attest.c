@@ -0,0 +1,72 @@
+/**
+ * \file src/block_verifier/block_verifier_attest.c
+ *
+ * \brief Parse and attest one certificate.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_verifier_internal.h"
+
+/**
+ * \brief Parse and attest one certificate.
+ *
+ * If the verifier has a cache, a certificate found there passes without being
+ * parsed, and a certificate which passes is added to it.  Attestation depends
+ * on the height and the contract setting, so both are part of the key.
+ *
+ * \param verifier      The verifier.
+ * \param cert          The certificate.
+ * \param size          The size of the certificate.
+ * \param height        The block height to attest at.
+ *
+ * \returns VCCERT_STATUS_SUCCESS if the certificate is valid, or a vccert
+ *          error code.
+ */
+int block_verifier_attest(
+    block_verifier* verifier, const uint8_t* cert, size_t size,
+    uint64_t height)
+{
+    vccert_parser_context_t parser;
+    uint8_t digest[CERT_CACHE_MAX_DIGEST_SIZE];
+    uint8_t context[sizeof(uint64_t) + 1];
+    bool have_digest = false;
+
+    MODEL_ASSERT(NULL != verifier);
+    MODEL_ASSERT(NULL != cert);
+
+    /* a certificate which has passed before costs one hash and one lookup. */
+    if (NULL != verifier->cache)
+    {
+        for (size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            context[i] = (uint8_t)(height >> (8 * (sizeof(uint64_t) - 1 - i)));
+        }
+
+        context[sizeof(uint64_t)] = 0 != verifier->verify_contracts;
+
+        have_digest = VCBLOCKCHAIN_STATUS_SUCCESS == cert_cache_digest(verifier->cache, context, sizeof(context), cert, size, digest);
+        if (have_digest && cert_cache_contains(verifier->cache, digest))
+        {
+            return VCCERT_STATUS_SUCCESS;
+        }
+    }
+
+    int retval = vccert_parser_init(verifier->parser_options, &parser, cert, size);
+    if (VCCERT_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = vccert_parser_attest(&parser, height, 0 != verifier->verify_contracts);
+    if (VCCERT_STATUS_SUCCESS == retval && have_digest)
+    {
+        cert_cache_insert(verifier->cache, digest);
+    }
+
+    dispose((disposable_t*)&parser);
+
+    return retval;
+}
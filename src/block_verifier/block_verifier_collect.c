@@ -0,0 +1,79 @@
+/**
+ * \file src/block_verifier/block_verifier_collect.c
+ *
+ * \brief Find the height and the wrapped transactions of a block.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vccert/fields.h>
+
+#include "block_verifier_internal.h"
+
+/**
+ * \brief Find the height and the wrapped transactions of a block.
+ *
+ * \param job           The job to fill in; the transaction arrays are
+ *                      allocated, and owned by the caller.
+ * \param parser        A parser for the block.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int block_verifier_collect(
+    block_verifier_job* job, vccert_parser_context_t* parser)
+{
+    const uint8_t* value;
+    size_t value_size;
+    allocator_options_t* alloc_opts = job->verifier->alloc_opts;
+
+    MODEL_ASSERT(NULL != job);
+    MODEL_ASSERT(NULL != parser);
+
+    /* the height is a big-endian 64-bit value. */
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(parser, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, &value, &value_size) || sizeof(uint64_t) != value_size)
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+    }
+
+    job->height = 0U;
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+        job->height = (job->height << 8) | value[i];
+    }
+
+    /* count the transactions, then record each one. */
+    job->count = 0U;
+    int retval = vccert_parser_find_short(parser, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE, &value, &value_size);
+    while (VCCERT_STATUS_SUCCESS == retval)
+    {
+        ++job->count;
+        retval = vccert_parser_find_next(parser, &value, &value_size);
+    }
+
+    if (0 == job->count)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    job->txns = (const uint8_t**)
+        allocate(alloc_opts, job->count * sizeof(const uint8_t*));
+    job->sizes = (size_t*)allocate(alloc_opts, job->count * sizeof(size_t));
+    if (NULL == job->txns || NULL == job->sizes)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    size_t i = 0;
+    retval = vccert_parser_find_short(parser, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE, &value, &value_size);
+    while (VCCERT_STATUS_SUCCESS == retval && i < job->count)
+    {
+        job->txns[i] = value;
+        job->sizes[i] = value_size;
+        ++i;
+        retval = vccert_parser_find_next(parser, &value, &value_size);
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/**
+ * \file src/block_verifier/block_verifier_init.c
+ *
+ * \brief Initialize a block verifier.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_verifier_internal.h"
+
+/* forward decls. */
+static void block_verifier_dispose(void* disposable);
+
+/**
+ * \brief Initialize a block verifier.
+ *
+ * The parser options are shared by every worker, so their resolvers must be
+ * safe to call from several threads at once.  The parser options, pool, and
+ * cache must outlive the verifier.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param verifier          The verifier to initialize.
+ * \param alloc_opts        The allocator to use for this verifier.
+ * \param parser_options    The vccert parser options for attestation.
+ * \param pool              The pool to verify on, or NULL to verify on the
+ *                          calling thread.
+ * \param cache             The cache of verified certificates to consult
+ *                          and update, or NULL to attest every certificate.
+ *                          Only verifiers with the same parser options may
+ *                          share a cache; verdicts are keyed by height and
+ *                          contract setting.
+ * \param batch_size        The number of transactions per task; 0 selects
+ *                          BLOCK_VERIFIER_DEFAULT_BATCH_SIZE.
+ * \param verify_contracts  If non-zero, transactions are also checked against
+ *                          their contracts.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int block_verifier_init(
+    block_verifier* verifier, allocator_options_t* alloc_opts,
+    vccert_parser_options_t* parser_options, thread_pool* pool,
+    cert_cache* cache, size_t batch_size, uint8_t verify_contracts)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != verifier);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != parser_options);
+
+    /* runtime parameter checks. */
+    if (NULL == verifier || NULL == alloc_opts || NULL == parser_options)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(verifier, 0, sizeof(block_verifier));
+    verifier->hdr.dispose = &block_verifier_dispose;
+    verifier->alloc_opts = alloc_opts;
+    verifier->parser_options = parser_options;
+    verifier->pool = pool;
+    verifier->cache = cache;
+    verifier->batch_size =
+        batch_size > 0 ? batch_size : BLOCK_VERIFIER_DEFAULT_BATCH_SIZE;
+    verifier->verify_contracts = verify_contracts;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a block verifier.
+ *
+ * \param disposable    The verifier to dispose.
+ */
+static void block_verifier_dispose(void* disposable)
+{
+    memset(disposable, 0, sizeof(block_verifier));
+}
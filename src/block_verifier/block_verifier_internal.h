@@ -0,0 +1,76 @@
+/**
+ * \file src/block_verifier/block_verifier_internal.h
+ *
+ * \brief Internal types and functions for the block verifier.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_BLOCK_VERIFIER_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_BLOCK_VERIFIER_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/block_verifier.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The verification of one block, shared by the chunks of its scan.
+ */
+typedef struct block_verifier_job
+{
+    block_verifier* verifier;
+    uint64_t height;
+    size_t count;
+    const uint8_t** txns;
+    size_t* sizes;
+} block_verifier_job;
+
+/**
+ * \brief Find the height and the wrapped transactions of a block.
+ *
+ * \param job           The job to fill in; the transaction arrays are
+ *                      allocated, and owned by the caller.
+ * \param parser        A parser for the block.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int block_verifier_collect(
+    block_verifier_job* job, vccert_parser_context_t* parser);
+
+/**
+ * \brief Parse and attest one certificate.
+ *
+ * If the verifier has a cache, a certificate found there passes without being
+ * parsed, and a certificate which passes is added to it.
+ *
+ * \param verifier      The verifier.
+ * \param cert          The certificate.
+ * \param size          The size of the certificate.
+ * \param height        The block height to attest at.
+ *
+ * \returns VCCERT_STATUS_SUCCESS if the certificate is valid, or a vccert
+ *          error code.
+ */
+int block_verifier_attest(
+    block_verifier* verifier, const uint8_t* cert, size_t size,
+    uint64_t height);
+
+/**
+ * \brief Verify a batch of a block's transactions, reporting the first which
+ * fails to the scan.
+ *
+ * \param scan          The scan, whose context is the \ref block_verifier_job.
+ * \param begin         The index of the first transaction in the batch.
+ * \param end           The index after the last transaction in the batch.
+ */
+void block_verifier_run_batch(thread_pool_scan* scan, size_t begin, size_t end);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_BLOCK_VERIFIER_INTERNAL_HEADER_GUARD*/
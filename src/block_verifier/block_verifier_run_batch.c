@@ -0,0 +1,35 @@
+/**
+ * \file src/block_verifier/block_verifier_run_batch.c
+ *
+ * \brief Verify a batch of transactions.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "block_verifier_internal.h"
+
+/**
+ * \brief Verify a batch of a block's transactions, reporting the first which
+ * fails to the scan.
+ *
+ * \param scan          The scan, whose context is the \ref block_verifier_job.
+ * \param begin         The index of the first transaction in the batch.
+ * \param end           The index after the last transaction in the batch.
+ */
+void block_verifier_run_batch(thread_pool_scan* scan, size_t begin, size_t end)
+{
+    block_verifier_job* job = (block_verifier_job*)scan->context;
+
+    MODEL_ASSERT(NULL != job);
+
+    for (size_t i = begin; i < end && !thread_pool_scan_skip(scan, i); ++i)
+    {
+        if (VCCERT_STATUS_SUCCESS != block_verifier_attest(job->verifier, job->txns[i], job->sizes[i], job->height))
+        {
+            thread_pool_scan_fail(scan, i);
+            break;
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * \file src/block_verifier/block_verifier_verify.c
+ *
+ * \brief Verify a block and every transaction it wraps.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "block_verifier_internal.h"
+
+/**
+ * \brief Verify a block and every transaction it wraps.
+ *
+ * \param verifier          The verifier.
+ * \param block             The block certificate.
+ * \param size              The size of the block certificate.
+ * \param failed_index      Pointer to receive, on failure, the index of the
+ *                          first failing transaction, or
+ *                          BLOCK_VERIFIER_BLOCK_INDEX if the block itself
+ *                          failed.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the block is valid.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_INVALID if the block certificate is
+ *        malformed or failed attestation.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_TRANSACTION_INVALID if a transaction is
+ *        malformed or failed attestation.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int block_verifier_verify(
+    block_verifier* verifier, const void* block, size_t size,
+    size_t* failed_index)
+{
+    int retval;
+    vccert_parser_context_t parser;
+    block_verifier_job job;
+    thread_pool_scan scan;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != verifier);
+    MODEL_ASSERT(NULL != block);
+    MODEL_ASSERT(NULL != failed_index);
+
+    /* runtime parameter checks. */
+    if (NULL == verifier || NULL == block || NULL == failed_index)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    *failed_index = BLOCK_VERIFIER_BLOCK_INDEX;
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_init(verifier->parser_options, &parser, block, size))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.verifier = verifier;
+
+    retval = block_verifier_collect(&job, &parser);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    retval =
+        thread_pool_scan_start(
+            &scan, verifier->pool, verifier->alloc_opts, job.count,
+            verifier->batch_size, &block_verifier_run_batch, &job);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto cleanup;
+    }
+
+    /* attest the block while the batches run, then help with them. */
+    if (VCCERT_STATUS_SUCCESS != block_verifier_attest(verifier, block, size, job.height))
+    {
+        thread_pool_scan_cancel(&scan, VCBLOCKCHAIN_ERROR_BLOCK_INVALID);
+    }
+
+    retval = thread_pool_scan_finish(&scan);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval && SIZE_MAX != scan.first_failure)
+    {
+        *failed_index = scan.first_failure;
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_TRANSACTION_INVALID;
+    }
+
+cleanup:
+    if (NULL != job.txns)
+    {
+        release(verifier->alloc_opts, job.txns);
+    }
+
+    if (NULL != job.sizes)
+    {
+        release(verifier->alloc_opts, job.sizes);
+    }
+
+    dispose((disposable_t*)&parser);
+
+    return retval;
+}
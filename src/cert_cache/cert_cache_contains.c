@@ -0,0 +1,53 @@
+/**
+ * \file src/cert_cache/cert_cache_contains.c
+ *
+ * \brief Look up a digest in the cache.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "cert_cache_internal.h"
+
+/**
+ * \brief Look up a digest, marking it as referenced if present.
+ *
+ * \param cache         The cache.
+ * \param digest        The digest to look up.
+ *
+ * \returns true if the certificate with this digest has passed verification,
+ *          and false otherwise.
+ */
+bool cert_cache_contains(cert_cache* cache, const uint8_t* digest)
+{
+    MODEL_ASSERT(NULL != cache);
+    MODEL_ASSERT(NULL != digest);
+
+    uint64_t key = cert_cache_key(cache, digest);
+    cert_cache_shard* shard = cert_cache_shard_for(cache, key);
+
+    pthread_mutex_lock(&shard->lock);
+
+    uint32_t slot =
+        cert_cache_shard_find(
+            cache, shard, cert_cache_bucket(shard, key), digest);
+    if (CERT_CACHE_NONE != slot)
+    {
+        /* give this entry a second chance when the hand comes around. */
+        shard->referenced[slot] = 1;
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    if (CERT_CACHE_NONE != slot)
+    {
+        __atomic_add_fetch(&cache->hits, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+    else
+    {
+        __atomic_add_fetch(&cache->misses, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * \file src/cert_cache/cert_cache_digest.c
+ *
+ * \brief Compute the digest identifying a certificate.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "cert_cache_internal.h"
+
+/**
+ * \brief Compute the digest identifying a certificate in the context it was
+ * verified in.
+ *
+ * A verdict which depends on more than the certificate, such as the height it
+ * was attested at, must be keyed by that context as well, so the verdict is
+ * only reused in the same context.  The context is hashed ahead of the
+ * certificate.
+ *
+ * \param cache         The cache.
+ * \param context       The verification context, or NULL if there is none.
+ * \param context_size  The size of the verification context.
+ * \param cert          The certificate.
+ * \param size          The size of the certificate.
+ * \param digest        Buffer of the suite's hash size to receive the digest.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int cert_cache_digest(
+    cert_cache* cache, const void* context, size_t context_size,
+    const void* cert, size_t size, uint8_t* digest)
+{
+    int retval;
+    vccrypt_hash_context_t hash;
+    vccrypt_buffer_t hash_buffer;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != cache);
+    MODEL_ASSERT(NULL != context || 0 == context_size);
+    MODEL_ASSERT(NULL != cert);
+    MODEL_ASSERT(NULL != digest);
+
+    /* runtime parameter checks. */
+    if (NULL == cache || (NULL == context && 0 != context_size) || NULL == cert || NULL == digest)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_hash_init(cache->suite, &hash))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_hash(cache->suite, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash;
+    }
+
+    if ((0 != context_size && VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, (const uint8_t*)context, context_size)) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, (const uint8_t*)cert, size) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_finalize(&hash, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    memcpy(digest, hash_buffer.data, cache->digest_size);
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_hash_buffer:
+    dispose((disposable_t*)&hash_buffer);
+
+dispose_hash:
+    dispose((disposable_t*)&hash);
+
+    return retval;
+}
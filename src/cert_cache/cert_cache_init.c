@@ -0,0 +1,203 @@
+/**
+ * \file src/cert_cache/cert_cache_init.c
+ *
+ * \brief Initialize a verified-certificate cache.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "cert_cache_internal.h"
+
+/* forward decls. */
+static void cert_cache_dispose(void* disposable);
+static int cert_cache_shard_init(
+    cert_cache* cache, cert_cache_shard* shard, size_t capacity);
+static void cert_cache_shard_dispose(
+    cert_cache* cache, cert_cache_shard* shard);
+
+/**
+ * \brief Initialize a verified-certificate cache.
+ *
+ * The suite must outlive the cache.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param cache         The cache to initialize.
+ * \param alloc_opts    The allocator to use for this cache.
+ * \param suite         The crypto suite whose hash identifies certificates.
+ * \param capacity      The number of digests to hold, rounded up to a
+ *                      multiple of CERT_CACHE_SHARDS.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        the suite's hash is larger than CERT_CACHE_MAX_DIGEST_SIZE.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int cert_cache_init(
+    cert_cache* cache, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, size_t capacity)
+{
+    int retval;
+    size_t i;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != cache);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != suite);
+
+    /* runtime parameter checks. */
+    if (NULL == cache || NULL == alloc_opts || NULL == suite || 0 == capacity || capacity >= CERT_CACHE_NONE)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (suite->hash_opts.hash_size > CERT_CACHE_MAX_DIGEST_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(cache, 0, sizeof(cert_cache));
+    cache->alloc_opts = alloc_opts;
+    cache->suite = suite;
+    cache->digest_size = suite->hash_opts.hash_size;
+
+    cache->shards = (cert_cache_shard*)
+        allocate(alloc_opts, CERT_CACHE_SHARDS * sizeof(cert_cache_shard));
+    if (NULL == cache->shards)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    memset(cache->shards, 0, CERT_CACHE_SHARDS * sizeof(cert_cache_shard));
+
+    size_t per_shard = (capacity + CERT_CACHE_SHARDS - 1) / CERT_CACHE_SHARDS;
+    for (i = 0; i < CERT_CACHE_SHARDS; ++i)
+    {
+        retval = cert_cache_shard_init(cache, &cache->shards[i], per_shard);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto dispose_shards;
+        }
+    }
+
+    cache->hdr.dispose = &cert_cache_dispose;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_shards:
+    while (i-- > 0)
+    {
+        pthread_mutex_destroy(&cache->shards[i].lock);
+        cert_cache_shard_dispose(cache, &cache->shards[i]);
+    }
+
+    release(alloc_opts, cache->shards);
+    cache->shards = NULL;
+
+    return retval;
+}
+
+/**
+ * \brief Initialize one shard.
+ *
+ * \param cache         The cache.
+ * \param shard         The shard to initialize.
+ * \param capacity      The number of digests the shard holds.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int cert_cache_shard_init(
+    cert_cache* cache, cert_cache_shard* shard, size_t capacity)
+{
+    /* keep chains short with at least one bucket per slot. */
+    size_t buckets = 1;
+    while (buckets < capacity)
+    {
+        buckets <<= 1;
+    }
+
+    shard->capacity = capacity;
+    shard->bucket_mask = buckets - 1;
+    shard->digests = (uint8_t*)
+        allocate(cache->alloc_opts, capacity * cache->digest_size);
+    shard->referenced = (uint8_t*)allocate(cache->alloc_opts, capacity);
+    shard->next = (uint32_t*)
+        allocate(cache->alloc_opts, capacity * sizeof(uint32_t));
+    shard->buckets = (uint32_t*)
+        allocate(cache->alloc_opts, buckets * sizeof(uint32_t));
+    if (NULL == shard->digests || NULL == shard->referenced || NULL == shard->next || NULL == shard->buckets)
+    {
+        goto dispose_shard;
+    }
+
+    memset(shard->buckets, 0xFF, buckets * sizeof(uint32_t));
+
+    if (0 != pthread_mutex_init(&shard->lock, NULL))
+    {
+        goto dispose_shard;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_shard:
+    cert_cache_shard_dispose(cache, shard);
+
+    return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+}
+
+/**
+ * \brief Release the memory of one shard.
+ *
+ * \param cache         The cache.
+ * \param shard         The shard to dispose.
+ */
+static void cert_cache_shard_dispose(
+    cert_cache* cache, cert_cache_shard* shard)
+{
+    if (NULL != shard->digests)
+    {
+        release(cache->alloc_opts, shard->digests);
+    }
+
+    if (NULL != shard->referenced)
+    {
+        release(cache->alloc_opts, shard->referenced);
+    }
+
+    if (NULL != shard->next)
+    {
+        release(cache->alloc_opts, shard->next);
+    }
+
+    if (NULL != shard->buckets)
+    {
+        release(cache->alloc_opts, shard->buckets);
+    }
+
+    memset(shard, 0, sizeof(cert_cache_shard));
+}
+
+/**
+ * \brief Dispose of a verified-certificate cache.
+ *
+ * \param disposable    The cache to dispose.
+ */
+static void cert_cache_dispose(void* disposable)
+{
+    cert_cache* cache = (cert_cache*)disposable;
+
+    for (size_t i = 0; i < CERT_CACHE_SHARDS; ++i)
+    {
+        pthread_mutex_destroy(&cache->shards[i].lock);
+        cert_cache_shard_dispose(cache, &cache->shards[i]);
+    }
+
+    release(cache->alloc_opts, cache->shards);
+
+    memset(cache, 0, sizeof(cert_cache));
+}
@@ -0,0 +1,94 @@
+/**
+ * \file src/cert_cache/cert_cache_insert.c
+ *
+ * \brief Record the digest of a verified certificate.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "cert_cache_internal.h"
+
+/* forward decls. */
+static uint32_t cert_cache_shard_evict(
+    const cert_cache* cache, cert_cache_shard* shard);
+
+/**
+ * \brief Record the digest of a certificate which has passed verification,
+ * evicting another digest if its shard is full.
+ *
+ * \param cache         The cache.
+ * \param digest        The digest to record.
+ */
+void cert_cache_insert(cert_cache* cache, const uint8_t* digest)
+{
+    uint32_t slot;
+
+    MODEL_ASSERT(NULL != cache);
+    MODEL_ASSERT(NULL != digest);
+
+    uint64_t key = cert_cache_key(cache, digest);
+    cert_cache_shard* shard = cert_cache_shard_for(cache, key);
+    size_t bucket = cert_cache_bucket(shard, key);
+
+    pthread_mutex_lock(&shard->lock);
+
+    /* another thread may have verified the same certificate. */
+    if (CERT_CACHE_NONE != cert_cache_shard_find(cache, shard, bucket, digest))
+    {
+        goto unlock;
+    }
+
+    if (shard->count < shard->capacity)
+    {
+        slot = (uint32_t)shard->count++;
+    }
+    else
+    {
+        slot = cert_cache_shard_evict(cache, shard);
+    }
+
+    memcpy(shard->digests + slot * cache->digest_size, digest, cache->digest_size);
+    shard->referenced[slot] = 0;
+    shard->next[slot] = shard->buckets[bucket];
+    shard->buckets[bucket] = slot;
+
+unlock:
+    pthread_mutex_unlock(&shard->lock);
+}
+
+/**
+ * \brief Advance the clock hand to an unreferenced slot, and unlink it.
+ *
+ * \param cache         The cache.
+ * \param shard         The full shard.
+ *
+ * \returns the freed slot.
+ */
+static uint32_t cert_cache_shard_evict(
+    const cert_cache* cache, cert_cache_shard* shard)
+{
+    /* clear reference bits until an unreferenced slot comes up. */
+    while (shard->referenced[shard->hand])
+    {
+        shard->referenced[shard->hand] = 0;
+        shard->hand = (shard->hand + 1) % shard->capacity;
+    }
+
+    uint32_t slot = (uint32_t)shard->hand;
+    shard->hand = (shard->hand + 1) % shard->capacity;
+
+    /* unlink the victim from its chain. */
+    uint64_t key =
+        cert_cache_key(cache, shard->digests + slot * cache->digest_size);
+    uint32_t* link = &shard->buckets[cert_cache_bucket(shard, key)];
+    while (*link != slot)
+    {
+        link = &shard->next[*link];
+    }
+
+    *link = shard->next[slot];
+
+    return slot;
+}
@@ -0,0 +1,94 @@
+/**
+ * \file src/cert_cache/cert_cache_internal.h
+ *
+ * \brief Internal types and functions for the verified-certificate cache.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_CERT_CACHE_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_CERT_CACHE_INTERNAL_HEADER_GUARD
+
+#include <pthread.h>
+#include <string.h>
+#include <vcblockchain/cert_cache.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief Marks an empty bucket or the end of a chain.
+ */
+#define CERT_CACHE_NONE UINT32_MAX
+
+/**
+ * \brief One shard of the cache.
+ *
+ * Slots fill in order and are then reused by the clock hand, so slots below
+ * count are always occupied.  Each bucket chains the slots whose key hashes to
+ * it.
+ */
+struct cert_cache_shard
+{
+    pthread_mutex_t lock;
+    size_t capacity;
+    size_t count;
+    size_t hand;
+    uint8_t* digests;
+    uint8_t* referenced;
+    uint32_t* next;
+    uint32_t* buckets;
+    size_t bucket_mask;
+};
+
+/**
+ * \brief Find the slot holding a digest.  The shard lock must be held.
+ *
+ * \param cache         The cache.
+ * \param shard         The shard.
+ * \param bucket        The bucket for the digest.
+ * \param digest        The digest.
+ *
+ * \returns the slot, or CERT_CACHE_NONE if the digest is not present.
+ */
+uint32_t cert_cache_shard_find(
+    const cert_cache* cache, const cert_cache_shard* shard, size_t bucket,
+    const uint8_t* digest);
+
+/**
+ * \brief Derive the hash key of a digest.  Digests are uniform, so their
+ * leading bytes serve directly.
+ */
+static inline uint64_t cert_cache_key(const cert_cache* cache, const uint8_t* digest)
+{
+    uint64_t key = 0U;
+    memcpy(&key, digest, cache->digest_size < sizeof(key) ? cache->digest_size : sizeof(key));
+
+    return key;
+}
+
+/**
+ * \brief Get the shard for a key.
+ */
+static inline cert_cache_shard* cert_cache_shard_for(const cert_cache* cache, uint64_t key)
+{
+    return &cache->shards[key & (CERT_CACHE_SHARDS - 1)];
+}
+
+/**
+ * \brief Get the bucket for a key within its shard.  The low bits chose the
+ * shard, so the bucket uses the bits above them.
+ */
+static inline size_t cert_cache_bucket(const cert_cache_shard* shard, uint64_t key)
+{
+    return (size_t)(key >> 16) & shard->bucket_mask;
+}
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_CERT_CACHE_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,40 @@
+/**
+ * \file src/cert_cache/cert_cache_shard_find.c
+ *
+ * \brief Find the slot holding a digest.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "cert_cache_internal.h"
+
+/**
+ * \brief Find the slot holding a digest.  The shard lock must be held.
+ *
+ * \param cache         The cache.
+ * \param shard         The shard.
+ * \param bucket        The bucket for the digest.
+ * \param digest        The digest.
+ *
+ * \returns the slot, or CERT_CACHE_NONE if the digest is not present.
+ */
+uint32_t cert_cache_shard_find(
+    const cert_cache* cache, const cert_cache_shard* shard, size_t bucket,
+    const uint8_t* digest)
+{
+    MODEL_ASSERT(NULL != cache);
+    MODEL_ASSERT(NULL != shard);
+    MODEL_ASSERT(NULL != digest);
+
+    for (uint32_t slot = shard->buckets[bucket]; CERT_CACHE_NONE != slot; slot = shard->next[slot])
+    {
+        if (0 == memcmp(shard->digests + slot * cache->digest_size, digest, cache->digest_size))
+        {
+            return slot;
+        }
+    }
+
+    return CERT_CACHE_NONE;
+}
@@ -0,0 +1,66 @@
+/**
+ * \file src/checkpoint/checkpoint_get_artifact_latest.c
+ *
+ * \brief Look up the latest transaction of an artifact in a checkpoint.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "checkpoint_internal.h"
+
+/**
+ * \brief Look up the latest transaction of an artifact in a checkpoint.
+ *
+ * \param cp            The checkpoint.
+ * \param artifact_id   The id of the artifact.
+ * \param txn_id        Buffer of BLOCK_STORE_ID_SIZE bytes to receive the id
+ *                      of the artifact's latest transaction.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_NOT_FOUND if the checkpoint has no
+ *        entry for the artifact.
+ */
+int checkpoint_get_artifact_latest(
+    const checkpoint* cp, const uint8_t* artifact_id, uint8_t* txn_id)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != cp);
+    MODEL_ASSERT(NULL != artifact_id);
+    MODEL_ASSERT(NULL != txn_id);
+
+    /* runtime parameter checks. */
+    if (NULL == cp || NULL == artifact_id || NULL == txn_id)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* the entries are sorted by artifact id. */
+    uint64_t lo = 0, hi = cp->artifact_count;
+    while (lo < hi)
+    {
+        uint64_t mid = lo + (hi - lo) / 2;
+        const uint8_t* entry = cp->entries + mid * CHECKPOINT_ENTRY_SIZE;
+
+        int cmp = memcmp(entry, artifact_id, BLOCK_STORE_ID_SIZE);
+        if (0 == cmp)
+        {
+            memcpy(txn_id, entry + BLOCK_STORE_ID_SIZE, BLOCK_STORE_ID_SIZE);
+            return VCBLOCKCHAIN_STATUS_SUCCESS;
+        }
+        else if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return VCBLOCKCHAIN_ERROR_CHECKPOINT_NOT_FOUND;
+}
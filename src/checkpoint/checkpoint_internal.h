@@ -0,0 +1,89 @@
+/**
+ * \file src/checkpoint/checkpoint_internal.h
+ *
+ * \brief Internal types and functions for checkpoints.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_CHECKPOINT_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_CHECKPOINT_INTERNAL_HEADER_GUARD
+
+#include <stdio.h>
+#include <vcblockchain/checkpoint.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The magic number which starts a checkpoint.
+ */
+#define CHECKPOINT_MAGIC "VCBCKPT"
+#define CHECKPOINT_MAGIC_SIZE 8
+
+/**
+ * \brief The header of a checkpoint.  It holds only bytes, so it has no
+ * padding, and is read in place from the map.
+ */
+typedef struct checkpoint_header
+{
+    uint8_t magic[CHECKPOINT_MAGIC_SIZE];
+    uint8_t version[4];
+    uint8_t digest_size[4];
+    uint8_t height[8];
+    uint8_t block_id[BLOCK_STORE_ID_SIZE];
+    uint8_t artifact_count[8];
+
+    /** \brief the digest covers the entries, then the header up to here. */
+    uint8_t digest[CHECKPOINT_MAX_DIGEST_SIZE];
+} checkpoint_header;
+
+/**
+ * \brief The size of the part of the header covered by the digest.
+ */
+#define CHECKPOINT_HEADER_DIGESTED_SIZE offsetof(checkpoint_header, digest)
+
+/**
+ * \brief The state of a checkpoint being written.
+ */
+typedef struct checkpoint_writer
+{
+    FILE* file;
+    vccrypt_hash_context_t* hash;
+    uint64_t count;
+} checkpoint_writer;
+
+/**
+ * \brief Encode a big-endian integer of the given size.
+ */
+static inline void checkpoint_encode(uint64_t val, uint8_t* out, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        out[i] = (uint8_t)(val >> (8 * (size - 1 - i)));
+    }
+}
+
+/**
+ * \brief Decode a big-endian integer of the given size.
+ */
+static inline uint64_t checkpoint_decode(const uint8_t* in, size_t size)
+{
+    uint64_t val = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        val = (val << 8) | in[i];
+    }
+
+    return val;
+}
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_CHECKPOINT_INTERNAL_HEADER_GUARD*/
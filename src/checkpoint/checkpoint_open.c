@@ -0,0 +1,188 @@
+/**
+ * \file src/checkpoint/checkpoint_open.c
+ *
+ * \brief Open a checkpoint.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint_internal.h"
+
+/* forward decls. */
+static void checkpoint_dispose(void* disposable);
+static int checkpoint_check(
+    vccrypt_suite_options_t* suite, const uint8_t* map, size_t map_size);
+
+/**
+ * \brief Open a checkpoint, checking its digest.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed, which unmaps the file.
+ *
+ * \param cp            The checkpoint to initialize.
+ * \param suite         The crypto suite the checkpoint was written with.
+ * \param path          The path of the checkpoint.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_IO if the file could not be opened or
+ *        mapped.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID if the file is malformed, is
+ *        of another version or suite, or its digest does not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int checkpoint_open(
+    checkpoint* cp, vccrypt_suite_options_t* suite, const char* path)
+{
+    int retval, fd;
+    struct stat st;
+    void* map;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != cp);
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != path);
+
+    /* runtime parameter checks. */
+    if (NULL == cp || NULL == suite || NULL == path)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    if (0 != fstat(fd, &st))
+    {
+        close(fd);
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    if ((size_t)st.st_size < sizeof(checkpoint_header))
+    {
+        close(fd);
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID;
+    }
+
+    /* the mapping outlives the descriptor. */
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+    {
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    retval = checkpoint_check(suite, (const uint8_t*)map, (size_t)st.st_size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        munmap(map, (size_t)st.st_size);
+        return retval;
+    }
+
+    const checkpoint_header* header = (const checkpoint_header*)map;
+
+    memset(cp, 0, sizeof(checkpoint));
+    cp->hdr.dispose = &checkpoint_dispose;
+    cp->map = map;
+    cp->map_size = (size_t)st.st_size;
+    cp->height = checkpoint_decode(header->height, sizeof(header->height));
+    memcpy(cp->block_id, header->block_id, BLOCK_STORE_ID_SIZE);
+    cp->artifact_count =
+        checkpoint_decode(
+            header->artifact_count, sizeof(header->artifact_count));
+    cp->entries = (const uint8_t*)map + sizeof(checkpoint_header);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Check the header and digest of a mapped checkpoint.
+ *
+ * \param suite         The crypto suite the checkpoint was written with.
+ * \param map           The mapped file.
+ * \param map_size      The size of the mapped file.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int checkpoint_check(
+    vccrypt_suite_options_t* suite, const uint8_t* map, size_t map_size)
+{
+    int retval;
+    const checkpoint_header* header = (const checkpoint_header*)map;
+    size_t entries_size = map_size - sizeof(checkpoint_header);
+    vccrypt_hash_context_t hash;
+    vccrypt_buffer_t hash_buffer;
+
+    uint64_t version = checkpoint_decode(header->version, sizeof(header->version));
+    uint64_t digest_size = checkpoint_decode(header->digest_size, sizeof(header->digest_size));
+    uint64_t count = checkpoint_decode(header->artifact_count, sizeof(header->artifact_count));
+
+    /* the count must account for the rest of the file exactly. */
+    if (0 != memcmp(header->magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) || CHECKPOINT_VERSION != version || suite->hash_opts.hash_size != digest_size || 0 != entries_size % CHECKPOINT_ENTRY_SIZE || entries_size / CHECKPOINT_ENTRY_SIZE != count)
+    {
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_hash_init(suite, &hash))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_hash(suite, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash;
+    }
+
+    /* the digest covers the entries, then the header. */
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, map + sizeof(checkpoint_header), entries_size) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, map, CHECKPOINT_HEADER_DIGESTED_SIZE) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_finalize(&hash, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    if (0 != memcmp(header->digest, hash_buffer.data, hash_buffer.size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID;
+        goto dispose_hash_buffer;
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_hash_buffer:
+    dispose((disposable_t*)&hash_buffer);
+
+dispose_hash:
+    dispose((disposable_t*)&hash);
+
+    return retval;
+}
+
+/**
+ * \brief Dispose of a checkpoint, unmapping its file.
+ *
+ * \param disposable    The checkpoint to dispose.
+ */
+static void checkpoint_dispose(void* disposable)
+{
+    checkpoint* cp = (checkpoint*)disposable;
+
+    MODEL_ASSERT(NULL != cp);
+
+    munmap(cp->map, cp->map_size);
+    memset(cp, 0, sizeof(checkpoint));
+}
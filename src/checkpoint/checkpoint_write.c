@@ -0,0 +1,265 @@
+/**
+ * \file src/checkpoint/checkpoint_write.c
+ *
+ * \brief Write a checkpoint of a store's state.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "checkpoint_internal.h"
+
+/* forward decls. */
+static int checkpoint_write_file(
+    block_store* store, vccrypt_suite_options_t* suite,
+    vccrypt_hash_context_t* hash, vccrypt_buffer_t* hash_buffer,
+    const char* path);
+static int checkpoint_write_entry(
+    void* context, const uint8_t* artifact_id, const uint8_t* txn_id);
+static int checkpoint_sync_dir(const char* path);
+
+/**
+ * \brief Write a checkpoint of a store's state as of its tip.
+ *
+ * The artifacts are streamed from the store to the file, so nothing the size
+ * of the state is held in memory.
+ *
+ * \param store         The store to checkpoint.
+ * \param suite         The crypto suite whose hash makes the digest.
+ * \param path          The path of the checkpoint.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND if the store has no blocks.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE if reading the store failed.
+ *      - VCBLOCKCHAIN_ERROR_CHECKPOINT_IO if writing the file failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int checkpoint_write(
+    block_store* store, vccrypt_suite_options_t* suite, const char* path)
+{
+    int retval;
+    char tmp_path[PATH_MAX];
+    vccrypt_hash_context_t hash;
+    vccrypt_buffer_t hash_buffer;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != path);
+
+    /* runtime parameter checks. */
+    if (NULL == store || NULL == suite || NULL == path || suite->hash_opts.hash_size > CHECKPOINT_MAX_DIGEST_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_hash_init(suite, &hash))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_hash(suite, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash;
+    }
+
+    retval =
+        checkpoint_write_file(store, suite, &hash, &hash_buffer, tmp_path);
+
+    /* replace the old checkpoint in one step. */
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval && 0 != rename(tmp_path, path))
+    {
+        retval = VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    /* the rename is only durable once the directory is synced. */
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        retval = checkpoint_sync_dir(path);
+    }
+
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        unlink(tmp_path);
+    }
+
+    dispose((disposable_t*)&hash_buffer);
+
+dispose_hash:
+    dispose((disposable_t*)&hash);
+
+    return retval;
+}
+
+/**
+ * \brief Write and sync the checkpoint file.
+ *
+ * \param store         The store to checkpoint.
+ * \param suite         The crypto suite whose hash makes the digest.
+ * \param hash          The hash context for the digest.
+ * \param hash_buffer   The buffer to receive the digest.
+ * \param path          The path of the file to write.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int checkpoint_write_file(
+    block_store* store, vccrypt_suite_options_t* suite,
+    vccrypt_hash_context_t* hash, vccrypt_buffer_t* hash_buffer,
+    const char* path)
+{
+    int retval;
+    checkpoint_header header;
+    checkpoint_writer writer;
+    uint64_t height;
+
+    writer.file = fopen(path, "wb");
+    if (NULL == writer.file)
+    {
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    /* reserve the header, which is written once the entries are counted. */
+    memset(&header, 0, sizeof(header));
+    if (1 != fwrite(&header, sizeof(header), 1, writer.file))
+    {
+        retval = VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+        goto close_file;
+    }
+
+    writer.hash = hash;
+    writer.count = 0U;
+    retval =
+        block_store_scan_artifacts(
+            store, &checkpoint_write_entry, &writer, &height,
+            header.block_id);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto close_file;
+    }
+
+    memcpy(header.magic, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+    checkpoint_encode(CHECKPOINT_VERSION, header.version, sizeof(header.version));
+    checkpoint_encode(suite->hash_opts.hash_size, header.digest_size, sizeof(header.digest_size));
+    checkpoint_encode(height, header.height, sizeof(header.height));
+    checkpoint_encode(writer.count, header.artifact_count, sizeof(header.artifact_count));
+
+    /* the digest covers the entries, then the header. */
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(hash, (const uint8_t*)&header, CHECKPOINT_HEADER_DIGESTED_SIZE) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_finalize(hash, hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto close_file;
+    }
+
+    memcpy(header.digest, hash_buffer->data, hash_buffer->size);
+
+    if (0 != fseek(writer.file, 0, SEEK_SET) || 1 != fwrite(&header, sizeof(header), 1, writer.file) || 0 != fflush(writer.file) || 0 != fsync(fileno(writer.file)))
+    {
+        retval = VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+        goto close_file;
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+close_file:
+    if (0 != fclose(writer.file) && VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        retval = VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    return retval;
+}
+
+/**
+ * \brief Write and hash one entry.
+ *
+ * \param context       The \ref checkpoint_writer.
+ * \param artifact_id   The id of the artifact.
+ * \param txn_id        The id of the artifact's latest transaction.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int checkpoint_write_entry(
+    void* context, const uint8_t* artifact_id, const uint8_t* txn_id)
+{
+    checkpoint_writer* writer = (checkpoint_writer*)context;
+
+    MODEL_ASSERT(NULL != writer);
+
+    if (1 != fwrite(artifact_id, BLOCK_STORE_ID_SIZE, 1, writer->file) || 1 != fwrite(txn_id, BLOCK_STORE_ID_SIZE, 1, writer->file))
+    {
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(writer->hash, artifact_id, BLOCK_STORE_ID_SIZE) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(writer->hash, txn_id, BLOCK_STORE_ID_SIZE))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    ++writer->count;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Sync the directory holding a path, so that a rename to the path is
+ * durable.
+ *
+ * \param path          The path whose directory is synced.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int checkpoint_sync_dir(const char* path)
+{
+    int retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+    char dir[PATH_MAX];
+    int fd;
+
+    /* the path fits, since the temporary path beside it did. */
+    strcpy(dir, path);
+
+    char* slash = strrchr(dir, '/');
+    if (NULL == slash)
+    {
+        strcpy(dir, ".");
+    }
+    else if (slash == dir)
+    {
+        dir[1] = 0;
+    }
+    else
+    {
+        *slash = 0;
+    }
+
+    fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+    {
+        return VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    if (0 != fsync(fd))
+    {
+        retval = VCBLOCKCHAIN_ERROR_CHECKPOINT_IO;
+    }
+
+    close(fd);
+
+    return retval;
+}
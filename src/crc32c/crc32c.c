@@ -0,0 +1,44 @@
+/**
+ * \file crc32c/crc32c.c
+ *
+ * \brief Update a CRC32C checksum with the given data.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/crc32c.h>
+
+#include "crc32c_internal.h"
+
+/**
+ * \brief Update a CRC32C checksum with the given data.
+ *
+ * Start with a crc of 0; the result of one call can be passed as the crc of
+ * the next call to checksum data incrementally.  The SSE4.2 or ARMv8 CRC32
+ * instructions are used when the CPU supports them, and a slicing-by-8 table
+ * implementation is used otherwise.  The result is the same either way.
+ *
+ * \param crc       The checksum of the preceding data, or 0.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated checksum.
+ */
+uint32_t crc32c(uint32_t crc, const void* data, size_t size)
+{
+    MODEL_ASSERT(NULL != data || 0 == size);
+
+    uint32_t state = ~crc;
+
+    if (crc32c_hw_available())
+    {
+        state = crc32c_hw(state, (const uint8_t*)data, size);
+    }
+    else
+    {
+        state = crc32c_sw(state, (const uint8_t*)data, size);
+    }
+
+    return ~state;
+}
@@ -0,0 +1,174 @@
+/**
+ * \file crc32c/crc32c_hw.c
+ *
+ * \brief CRC32C implementation using SSE4.2 or ARMv8 CRC32 instructions.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <string.h>
+
+#include "crc32c_internal.h"
+
+#if defined(VCBLOCKCHAIN_CRC32C_HW_SSE42)
+
+#include <nmmintrin.h>
+
+/**
+ * \brief Check whether the CPU supports the CRC32C instructions.
+ *
+ * \returns non-zero if \ref crc32c_hw() may be called.
+ */
+int crc32c_hw_available(void)
+{
+#if defined(__SSE4_2__)
+    return 1;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+/**
+ * \brief Update the raw (pre-inverted) CRC32C state using SSE4.2.
+ *
+ * \param state     The raw CRC state.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated raw CRC state.
+ */
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hw(uint32_t state, const uint8_t* data, size_t size)
+{
+    uint64_t state64;
+    uint64_t word;
+
+    /* align the data for the eight byte loop. */
+    while (size > 0 && ((uintptr_t)data & 7))
+    {
+        state = _mm_crc32_u8(state, *data++);
+        --size;
+    }
+
+    /* process eight bytes at a time. */
+    state64 = state;
+    while (size >= 8)
+    {
+        memcpy(&word, data, sizeof(word));
+        state64 = _mm_crc32_u64(state64, word);
+        data += 8;
+        size -= 8;
+    }
+    state = (uint32_t)state64;
+
+    /* process the remaining bytes. */
+    while (size-- > 0)
+    {
+        state = _mm_crc32_u8(state, *data++);
+    }
+
+    return state;
+}
+
+#elif defined(VCBLOCKCHAIN_CRC32C_HW_ARMV8)
+
+#include <arm_acle.h>
+#include <sys/auxv.h>
+
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+
+/**
+ * \brief Check whether the CPU supports the CRC32C instructions.
+ *
+ * The answer is cached after the first call; racing first calls store the
+ * same value.
+ *
+ * \returns non-zero if \ref crc32c_hw() may be called.
+ */
+int crc32c_hw_available(void)
+{
+#if defined(__ARM_FEATURE_CRC32)
+    return 1;
+#else
+    static int available = -1;
+
+    int val = __atomic_load_n(&available, __ATOMIC_RELAXED);
+    if (val < 0)
+    {
+        val = (getauxval(AT_HWCAP) & HWCAP_CRC32) ? 1 : 0;
+        __atomic_store_n(&available, val, __ATOMIC_RELAXED);
+    }
+
+    return val;
+#endif
+}
+
+/**
+ * \brief Update the raw (pre-inverted) CRC32C state using ARMv8 CRC32.
+ *
+ * \param state     The raw CRC state.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated raw CRC state.
+ */
+__attribute__((target("+crc")))
+uint32_t crc32c_hw(uint32_t state, const uint8_t* data, size_t size)
+{
+    uint64_t word;
+
+    /* align the data for the eight byte loop. */
+    while (size > 0 && ((uintptr_t)data & 7))
+    {
+        state = __crc32cb(state, *data++);
+        --size;
+    }
+
+    /* process eight bytes at a time. */
+    while (size >= 8)
+    {
+        memcpy(&word, data, sizeof(word));
+        state = __crc32cd(state, word);
+        data += 8;
+        size -= 8;
+    }
+
+    /* process the remaining bytes. */
+    while (size-- > 0)
+    {
+        state = __crc32cb(state, *data++);
+    }
+
+    return state;
+}
+
+#else
+
+/**
+ * \brief Check whether the CPU supports the CRC32C instructions.
+ *
+ * \returns 0, since no hardware implementation is built for this target.
+ */
+int crc32c_hw_available(void)
+{
+    return 0;
+}
+
+/**
+ * \brief No hardware implementation is built for this target; fall back to
+ * the software implementation.
+ *
+ * \param state     The raw CRC state.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated raw CRC state.
+ */
+uint32_t crc32c_hw(uint32_t state, const uint8_t* data, size_t size)
+{
+    return crc32c_sw(state, data, size);
+}
+
+#endif
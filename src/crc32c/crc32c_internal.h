@@ -0,0 +1,69 @@
+/**
+ * \file crc32c/crc32c_internal.h
+ *
+ * \brief Internal CRC32C implementations.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_CRC32C_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_CRC32C_INTERNAL_HEADER_GUARD
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* hardware implementations are available on these targets. */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define VCBLOCKCHAIN_CRC32C_HW_SSE42
+#endif
+#if defined(__aarch64__) && defined(__GNUC__) && defined(__linux__)
+#define VCBLOCKCHAIN_CRC32C_HW_ARMV8
+#endif
+
+/**
+ * \brief Slicing-by-8 lookup tables.
+ */
+extern const uint32_t crc32c_table[8][256];
+
+/**
+ * \brief Update the raw (pre-inverted) CRC32C state using slicing-by-8.
+ *
+ * \param state     The raw CRC state.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated raw CRC state.
+ */
+uint32_t crc32c_sw(uint32_t state, const uint8_t* data, size_t size);
+
+/**
+ * \brief Update the raw (pre-inverted) CRC32C state using CPU instructions.
+ *
+ * This must only be called if \ref crc32c_hw_available() returns non-zero.
+ *
+ * \param state     The raw CRC state.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated raw CRC state.
+ */
+uint32_t crc32c_hw(uint32_t state, const uint8_t* data, size_t size);
+
+/**
+ * \brief Check whether the CPU supports the CRC32C instructions.
+ *
+ * \returns non-zero if \ref crc32c_hw() may be called.
+ */
+int crc32c_hw_available(void);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_CRC32C_INTERNAL_HEADER_GUARD*/
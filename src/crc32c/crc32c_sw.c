@@ -0,0 +1,54 @@
+/**
+ * \file crc32c/crc32c_sw.c
+ *
+ * \brief Slicing-by-8 software CRC32C implementation.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include "crc32c_internal.h"
+
+/**
+ * \brief Update the raw (pre-inverted) CRC32C state using slicing-by-8.
+ *
+ * Eight bytes are folded into the state per step with eight independent table
+ * lookups, instead of eight dependent lookups with a byte-at-a-time table.
+ *
+ * \param state     The raw CRC state.
+ * \param data      The data to checksum.
+ * \param size      The size of the data.
+ *
+ * \returns the updated raw CRC state.
+ */
+uint32_t crc32c_sw(uint32_t state, const uint8_t* data, size_t size)
+{
+    /* process eight bytes at a time. */
+    while (size >= 8)
+    {
+        uint32_t lo =
+            state
+          ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8)
+             | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+
+        state =
+            crc32c_table[7][lo & 0xFF]
+          ^ crc32c_table[6][(lo >> 8) & 0xFF]
+          ^ crc32c_table[5][(lo >> 16) & 0xFF]
+          ^ crc32c_table[4][lo >> 24]
+          ^ crc32c_table[3][data[4]]
+          ^ crc32c_table[2][data[5]]
+          ^ crc32c_table[1][data[6]]
+          ^ crc32c_table[0][data[7]];
+
+        data += 8;
+        size -= 8;
+    }
+
+    /* process the remaining bytes one at a time. */
+    while (size-- > 0)
+    {
+        state = crc32c_table[0][(state ^ *data++) & 0xFF] ^ (state >> 8);
+    }
+
+    return state;
+}
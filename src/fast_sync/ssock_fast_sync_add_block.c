@@ -0,0 +1,131 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_add_block.c
+ *
+ * \brief Add a verified block and its transactions to the pipeline's batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vccert/fields.h>
+
+#include "ssock_fast_sync_internal.h"
+
+/* forward decls. */
+static int ssock_fast_sync_add_transaction(
+    ssock_fast_sync_pipeline* pipeline, const uint8_t* txn, size_t size);
+
+/**
+ * \brief Add a verified block, and every transaction it wraps, to the
+ * pipeline's batch.
+ *
+ * Each transaction is added under its certificate id, as the latest
+ * transaction of its artifact, so a synced store answers transaction and
+ * artifact queries just as the store it was synced from does.  The records
+ * refer to the block's slot, which is kept until the batch is written.
+ *
+ * \param pipeline      The pipeline.
+ * \param slot          The verified block.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_INVALID if a transaction is missing its
+ *        certificate id or artifact id.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_fast_sync_add_block(
+    ssock_fast_sync_pipeline* pipeline, const ssock_fast_sync_slot* slot)
+{
+    int retval;
+    vccert_parser_context_t parser;
+    const uint8_t* value;
+    size_t value_size;
+
+    MODEL_ASSERT(NULL != pipeline);
+    MODEL_ASSERT(NULL != slot);
+
+    retval =
+        block_store_batch_add_block(
+            &pipeline->batch, slot->id, slot->height, slot->data, slot->size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_init(pipeline->verifier->parser_options, &parser, slot->data, slot->size))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+    }
+
+    /* the transactions are added in block order. */
+    int found =
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE, &value,
+            &value_size);
+    while (VCCERT_STATUS_SUCCESS == found)
+    {
+        retval =
+            ssock_fast_sync_add_transaction(pipeline, value, value_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto dispose_parser;
+        }
+
+        found = vccert_parser_find_next(&parser, &value, &value_size);
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_parser:
+    dispose((disposable_t*)&parser);
+
+    return retval;
+}
+
+/**
+ * \brief Add a transaction to the pipeline's batch, under its own certificate
+ * id and artifact id.
+ *
+ * \param pipeline      The pipeline.
+ * \param txn           The transaction certificate.
+ * \param size          The size of the transaction certificate.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_fast_sync_add_transaction(
+    ssock_fast_sync_pipeline* pipeline, const uint8_t* txn, size_t size)
+{
+    int retval;
+    vccert_parser_context_t parser;
+    const uint8_t* txn_id;
+    const uint8_t* artifact_id;
+    size_t value_size;
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_init(pipeline->verifier->parser_options, &parser, txn, size))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+    }
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(&parser, VCCERT_FIELD_TYPE_CERTIFICATE_ID, &txn_id, &value_size) || BLOCK_STORE_ID_SIZE != value_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+        goto dispose_parser;
+    }
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(&parser, VCCERT_FIELD_TYPE_ARTIFACT_ID, &artifact_id, &value_size) || BLOCK_STORE_ID_SIZE != value_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+        goto dispose_parser;
+    }
+
+    retval =
+        block_store_batch_add_transaction(
+            &pipeline->batch, txn_id, artifact_id, txn, size);
+
+dispose_parser:
+    dispose((disposable_t*)&parser);
+
+    return retval;
+}
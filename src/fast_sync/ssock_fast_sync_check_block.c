@@ -0,0 +1,103 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_check_block.c
+ *
+ * \brief Check a verified block against its place in the chain.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vccert/fields.h>
+
+#include "ssock_fast_sync_internal.h"
+
+/**
+ * \brief Check that a verified block is the block it was sent as, and that it
+ * links to the block before it.
+ *
+ * The height and id the server sent are only trusted once they match the
+ * certificate's own height and id fields.  The certificate's previous block
+ * id must match the block before it in this pull, or for the first block,
+ * the store's tip, unless the store was empty.
+ *
+ * \param pipeline      The pipeline.
+ * \param slot          The verified block.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the block belongs at its height.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_INVALID if the block is missing a field.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH if the block is not the block
+ *        it was sent as, or does not link to the block before it.
+ */
+int ssock_fast_sync_check_block(
+    ssock_fast_sync_pipeline* pipeline, const ssock_fast_sync_slot* slot)
+{
+    int retval;
+    vccert_parser_context_t parser;
+    const uint8_t* value;
+    size_t value_size;
+    uint64_t height = 0U;
+
+    MODEL_ASSERT(NULL != pipeline);
+    MODEL_ASSERT(NULL != slot);
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_init(pipeline->verifier->parser_options, &parser, slot->data, slot->size))
+    {
+        return VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+    }
+
+    /* the height is a big-endian 64-bit value. */
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(&parser, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, &value, &value_size) || sizeof(uint64_t) != value_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+        goto dispose_parser;
+    }
+
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+        height = (height << 8) | value[i];
+    }
+
+    if (height != slot->height)
+    {
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH;
+        goto dispose_parser;
+    }
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(&parser, VCCERT_FIELD_TYPE_BLOCK_UUID, &value, &value_size) || BLOCK_STORE_ID_SIZE != value_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+        goto dispose_parser;
+    }
+
+    if (0 != memcmp(value, slot->id, BLOCK_STORE_ID_SIZE))
+    {
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH;
+        goto dispose_parser;
+    }
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(&parser, VCCERT_FIELD_TYPE_PREVIOUS_BLOCK_UUID, &value, &value_size) || BLOCK_STORE_ID_SIZE != value_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_BLOCK_INVALID;
+        goto dispose_parser;
+    }
+
+    /* every block links to the block before it, bar the first of a chain. */
+    if (pipeline->have_previous && 0 != memcmp(value, pipeline->previous_id, BLOCK_STORE_ID_SIZE))
+    {
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH;
+        goto dispose_parser;
+    }
+
+    memcpy(pipeline->previous_id, slot->id, BLOCK_STORE_ID_SIZE);
+    pipeline->have_previous = 1U;
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_parser:
+    dispose((disposable_t*)&parser);
+
+    return retval;
+}
@@ -0,0 +1,123 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_internal.h
+ *
+ * \brief Internal types and functions for fast sync.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_FAST_SYNC_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_FAST_SYNC_INTERNAL_HEADER_GUARD
+
+#include <pthread.h>
+#include <vcblockchain/ssock_fast_sync.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief A block in flight through the pipeline.
+ */
+typedef struct ssock_fast_sync_slot
+{
+    uint64_t height;
+    uint8_t id[BLOCK_STORE_ID_SIZE];
+    void* data;
+    uint32_t size;
+} ssock_fast_sync_slot;
+
+/**
+ * \brief The state shared by the pipeline stages.
+ *
+ * The slots form a ring, and each stage owns the slots between the count of
+ * the stage before it and its own count: blocks are received, then verified,
+ * then stored.  The counts only grow, and the slot of a block is its count
+ * modulo the depth.  Every change is made under the lock and broadcast.
+ *
+ * A failure to verify or store sets the status and stops every stage, while
+ * a failure to receive only stops the receiver, so the blocks already
+ * received are still verified and stored.
+ *
+ * The id of the block before the next one to check starts as the id of the
+ * store's tip, and is then owned by the verification stage, which links each
+ * block to it.  Only a pull into an empty store starts without one.
+ */
+typedef struct ssock_fast_sync_pipeline
+{
+    allocator_options_t* alloc_opts;
+    block_store* store;
+    block_verifier* verifier;
+    block_store_batch batch;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    size_t received;
+    size_t verified;
+    size_t stored;
+    uint8_t receive_done;
+    uint8_t verify_done;
+    int receive_status;
+    int status;
+    uint8_t have_previous;
+    uint8_t previous_id[BLOCK_STORE_ID_SIZE];
+    ssock_fast_sync_slot slots[SSOCK_FAST_SYNC_PIPELINE_DEPTH];
+} ssock_fast_sync_pipeline;
+
+/**
+ * \brief The state of a server writing blocks from a scan.
+ */
+typedef struct ssock_fast_sync_sender
+{
+    ssock* sock;
+    int write_status;
+} ssock_fast_sync_sender;
+
+/**
+ * \brief Check that a verified block is the block it was sent as, and that it
+ * links to the block before it.
+ *
+ * \param pipeline      The pipeline.
+ * \param slot          The verified block.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_fast_sync_check_block(
+    ssock_fast_sync_pipeline* pipeline, const ssock_fast_sync_slot* slot);
+
+/**
+ * \brief Add a verified block, and every transaction it wraps, to the
+ * pipeline's batch.
+ *
+ * \param pipeline      The pipeline.
+ * \param slot          The verified block.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_fast_sync_add_block(
+    ssock_fast_sync_pipeline* pipeline, const ssock_fast_sync_slot* slot);
+
+/**
+ * \brief Verify received blocks until the receiver is done or a stage fails.
+ *
+ * \param context       The \ref ssock_fast_sync_pipeline.
+ *
+ * \returns NULL.
+ */
+void* ssock_fast_sync_verify_stage(void* context);
+
+/**
+ * \brief Store verified blocks until the verifier is done or a stage fails.
+ *
+ * \param context       The \ref ssock_fast_sync_pipeline.
+ *
+ * \returns NULL.
+ */
+void* ssock_fast_sync_store_stage(void* context);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_FAST_SYNC_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,383 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_pull.c
+ *
+ * \brief Pull a range of blocks from a server into a store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_fast_sync_internal.h"
+
+/* forward decls. */
+static int ssock_fast_sync_receive(
+    ssock_fast_sync_pipeline* pipeline, ssock* sock, uint64_t start,
+    uint64_t end, uint64_t tip);
+static int ssock_fast_sync_read_id(
+    ssock* sock, allocator_options_t* alloc_opts, uint8_t* id);
+static void ssock_fast_sync_receive_done(
+    ssock_fast_sync_pipeline* pipeline, int status);
+
+/**
+ * \brief Pull a range of blocks from a server into a store.
+ *
+ * Blocks must arrive within the range at consecutive heights, starting at
+ * the height after the store's tip, or at SSOCK_FAST_SYNC_FIRST_HEIGHT if the
+ * store is empty, so the range should start there too.  Each block is
+ * verified before it is stored, and its own height and id fields must match
+ * the height and id it was sent under.  Its previous block id must match the
+ * block before it, which for the first block is the store's tip; only the
+ * first block of a chain, pulled into an empty store, has nothing to link
+ * to.  On failure, the blocks received and verified before it are still
+ * stored, so a sync can be resumed from the height after the last of them.
+ * If this fails before the server ends its response, the rest of the
+ * response is left unread, so the socket must be closed.
+ *
+ * Blocks are read as data packets, so the read policy of the socket bounds
+ * their size.
+ *
+ * \param sock          The socket connected to the server.
+ * \param alloc_opts    The allocator to use for the blocks in flight.
+ * \param store         The store to write the blocks to.
+ * \param verifier      The verifier to check each block with.
+ * \param start         The lowest height to pull.
+ * \param end           The highest height to pull, or UINT64_MAX to pull
+ *                      everything from start up.
+ * \param count         Pointer to receive the number of blocks stored.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the server sent
+ *        a malformed response.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE if the server sent a block
+ *        outside of the range, out of order, or after a gap, including a gap
+ *        after the store's tip.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH if the server sent a block
+ *        under a height or id other than its own, or a block which does not
+ *        link to the block before it.
+ *      - VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD if the pipeline could not be
+ *        started.
+ *      - VCBLOCKCHAIN_ERROR_BLOCK_INVALID if a transaction in a block is
+ *        missing its certificate id or artifact id.
+ *      - a failure from \ref block_verifier_verify(),
+ *        \ref block_store_write(), or reading the store's tip.
+ *      - the non-zero status reported by the server, if its scan failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_fast_sync_pull(
+    ssock* sock, allocator_options_t* alloc_opts, block_store* store,
+    block_verifier* verifier, uint64_t start, uint64_t end, uint64_t* count)
+{
+    int retval;
+    ssock_fast_sync_pipeline* pipeline;
+    pthread_t verify_thread, store_thread;
+    uint64_t tip;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != store);
+    MODEL_ASSERT(NULL != verifier);
+    MODEL_ASSERT(start <= end);
+    MODEL_ASSERT(NULL != count);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == alloc_opts || NULL == store || NULL == verifier || start > end || NULL == count)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    *count = 0U;
+
+    /* the ring is too large for the stack. */
+    pipeline =
+        (ssock_fast_sync_pipeline*)
+            allocate(alloc_opts, sizeof(ssock_fast_sync_pipeline));
+    if (NULL == pipeline)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    memset(pipeline, 0, sizeof(ssock_fast_sync_pipeline));
+    pipeline->alloc_opts = alloc_opts;
+    pipeline->store = store;
+    pipeline->verifier = verifier;
+
+    /* the first block follows on from the store's tip, and links to it. */
+    retval = block_store_get_max_height(store, &tip);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        retval = block_store_get_block_id(store, tip, pipeline->previous_id);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto release_pipeline;
+        }
+
+        pipeline->have_previous = 1U;
+    }
+    else if (VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND == retval)
+    {
+        tip = SSOCK_FAST_SYNC_FIRST_HEIGHT - 1;
+    }
+    else
+    {
+        goto release_pipeline;
+    }
+
+    retval = block_store_batch_init(&pipeline->batch, alloc_opts);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto release_pipeline;
+    }
+
+    if (0 != pthread_mutex_init(&pipeline->lock, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD;
+        goto dispose_batch;
+    }
+
+    if (0 != pthread_cond_init(&pipeline->changed, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD;
+        goto destroy_lock;
+    }
+
+    /* send the request. */
+    retval = ssock_write_uint64(sock, start);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto destroy_cond;
+    }
+
+    retval = ssock_write_uint64(sock, end);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto destroy_cond;
+    }
+
+    retval = ssock_flush(sock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto destroy_cond;
+    }
+
+    /* start the pipeline. */
+    if (0 != pthread_create(&verify_thread, NULL, &ssock_fast_sync_verify_stage, pipeline))
+    {
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD;
+        goto destroy_cond;
+    }
+
+    if (0 != pthread_create(&store_thread, NULL, &ssock_fast_sync_store_stage, pipeline))
+    {
+        ssock_fast_sync_receive_done(
+            pipeline, VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD);
+        pthread_join(verify_thread, NULL);
+        retval = VCBLOCKCHAIN_ERROR_FAST_SYNC_THREAD;
+        goto destroy_cond;
+    }
+
+    /* receive on this thread, then let the other stages drain. */
+    retval = ssock_fast_sync_receive(pipeline, sock, start, end, tip);
+    ssock_fast_sync_receive_done(pipeline, retval);
+    pthread_join(verify_thread, NULL);
+    pthread_join(store_thread, NULL);
+
+    *count = pipeline->stored;
+    retval =
+        VCBLOCKCHAIN_STATUS_SUCCESS != pipeline->status
+            ? pipeline->status : pipeline->receive_status;
+
+destroy_cond:
+    /* release the blocks which were not stored. */
+    for (size_t i = pipeline->stored; i < pipeline->received; ++i)
+    {
+        release(
+            alloc_opts,
+            pipeline->slots[i % SSOCK_FAST_SYNC_PIPELINE_DEPTH].data);
+    }
+
+    pthread_cond_destroy(&pipeline->changed);
+
+destroy_lock:
+    pthread_mutex_destroy(&pipeline->lock);
+
+dispose_batch:
+    dispose((disposable_t*)&pipeline->batch);
+
+release_pipeline:
+    release(alloc_opts, pipeline);
+
+    return retval;
+}
+
+/**
+ * \brief Read blocks from the socket into the pipeline until the server ends
+ * its response or a stage fails.
+ *
+ * \param pipeline      The pipeline.
+ * \param sock          The socket connected to the server.
+ * \param start         The lowest height requested.
+ * \param end           The highest height requested.
+ * \param tip           The height of the store's tip, which the first block
+ *                      must follow on from.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_fast_sync_receive(
+    ssock_fast_sync_pipeline* pipeline, ssock* sock, uint64_t start,
+    uint64_t end, uint64_t tip)
+{
+    int retval;
+    uint8_t marker;
+    int32_t status;
+    uint64_t height;
+    uint8_t id[BLOCK_STORE_ID_SIZE];
+    void* data;
+    uint32_t size;
+    uint64_t next = tip + 1;
+    uint8_t past_top = UINT64_MAX == tip;
+
+    for (;;)
+    {
+        retval = ssock_read_uint8(sock, &marker);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        if (SSOCK_FAST_SYNC_END == marker)
+        {
+            retval = ssock_read_int32(sock, &status);
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+
+            return status;
+        }
+        else if (SSOCK_FAST_SYNC_BLOCK != marker)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+        }
+
+        retval = ssock_read_uint64(sock, &height);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        /* heights follow on from the tip without gaps, and nothing may
+         * follow the highest one. */
+        if (past_top || height != next || height < start || height > end)
+        {
+            return VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE;
+        }
+
+        if (UINT64_MAX == height)
+        {
+            past_top = 1U;
+        }
+        else
+        {
+            next = height + 1;
+        }
+
+        retval = ssock_fast_sync_read_id(sock, pipeline->alloc_opts, id);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        retval = ssock_read_data(sock, pipeline->alloc_opts, &data, &size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        /* wait for a free slot. */
+        pthread_mutex_lock(&pipeline->lock);
+        while (SSOCK_FAST_SYNC_PIPELINE_DEPTH == pipeline->received - pipeline->stored && VCBLOCKCHAIN_STATUS_SUCCESS == pipeline->status)
+        {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+
+        /* another stage failed, so stop reading. */
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != pipeline->status)
+        {
+            pthread_mutex_unlock(&pipeline->lock);
+            release(pipeline->alloc_opts, data);
+            return pipeline->status;
+        }
+
+        ssock_fast_sync_slot* slot =
+            &pipeline->slots[
+                pipeline->received % SSOCK_FAST_SYNC_PIPELINE_DEPTH];
+        slot->height = height;
+        memcpy(slot->id, id, BLOCK_STORE_ID_SIZE);
+        slot->data = data;
+        slot->size = size;
+
+        ++pipeline->received;
+        pthread_cond_broadcast(&pipeline->changed);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+}
+
+/**
+ * \brief Read the id of a block.
+ *
+ * \param sock          The socket to read from.
+ * \param alloc_opts    The allocator for the read.
+ * \param id            The buffer to receive the id.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_fast_sync_read_id(
+    ssock* sock, allocator_options_t* alloc_opts, uint8_t* id)
+{
+    void* val = NULL;
+    uint32_t size = 0U;
+
+    int retval = ssock_read_data(sock, alloc_opts, &val, &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (BLOCK_STORE_ID_SIZE != size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+    else
+    {
+        memcpy(id, val, BLOCK_STORE_ID_SIZE);
+    }
+
+    release(alloc_opts, val);
+
+    return retval;
+}
+
+/**
+ * \brief Mark the receiver done, recording its status.
+ *
+ * \param pipeline      The pipeline.
+ * \param status        The status of the receiver.
+ */
+static void ssock_fast_sync_receive_done(
+    ssock_fast_sync_pipeline* pipeline, int status)
+{
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->receive_status = status;
+    pipeline->receive_done = 1U;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->lock);
+}
@@ -0,0 +1,212 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_serve.c
+ *
+ * \brief Serve one fast sync request.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_fast_sync_internal.h"
+
+/* forward decls. */
+static int ssock_fast_sync_send_range(
+    ssock_fast_sync_sender* sender, block_store* store, uint64_t start,
+    uint64_t end);
+static int ssock_fast_sync_send_block(
+    void* context, uint64_t height, const uint8_t* block_id,
+    const void* block, size_t size);
+
+/**
+ * \brief Serve one fast sync request.
+ *
+ * The request is read, then every block in the range up to the current tip
+ * is written.  The range is read in slices of SSOCK_FAST_SYNC_SCAN_SLICE
+ * heights, each from its own snapshot of the store, so a slow client never
+ * holds one snapshot open for a whole bootstrap.  A failure reading the
+ * store ends the response early, and is reported to the client in the
+ * status.
+ *
+ * \param sock          The socket connected to the client.
+ * \param store         The store to read the blocks from.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, including when the failure
+ *        of a store read was reported to the client.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the client sent
+ *        a malformed request.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ */
+int ssock_fast_sync_serve(ssock* sock, block_store* store)
+{
+    int retval, status;
+    uint64_t start, end;
+    ssock_fast_sync_sender sender;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != store);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == store)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* read the request. */
+    retval = ssock_read_uint64(sock, &start);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_read_uint64(sock, &end);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* write every block in the range, without waiting for the client. */
+    sender.sock = sock;
+    sender.write_status = VCBLOCKCHAIN_STATUS_SUCCESS;
+    status = ssock_fast_sync_send_range(&sender, store, start, end);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != sender.write_status)
+    {
+        return sender.write_status;
+    }
+
+    retval = ssock_write_uint8(sock, SSOCK_FAST_SYNC_END);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_write_int32(sock, status);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    return ssock_flush(sock);
+}
+
+/**
+ * \brief Write every block in a range up to the tip, a slice at a time.
+ *
+ * Each slice is its own scan, so no read transaction outlives its slice
+ * while the client falls behind.
+ *
+ * \param sender        The sender.
+ * \param store         The store to read the blocks from.
+ * \param start         The lowest height to write.
+ * \param end           The highest height to write.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_fast_sync_send_range(
+    ssock_fast_sync_sender* sender, block_store* store, uint64_t start,
+    uint64_t end)
+{
+    uint64_t top, slice_end;
+
+    /* nothing above the tip is scanned, and an empty store has no range. */
+    int retval = block_store_get_max_height(store, &top);
+    if (VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND == retval)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+    else if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (top < end)
+    {
+        end = top;
+    }
+
+    while (start <= end)
+    {
+        slice_end =
+            end - start < SSOCK_FAST_SYNC_SCAN_SLICE
+                ? end : start + SSOCK_FAST_SYNC_SCAN_SLICE - 1;
+
+        retval =
+            block_store_scan_blocks(
+                store, start, slice_end, &ssock_fast_sync_send_block, sender);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval || slice_end == end)
+        {
+            return retval;
+        }
+
+        start = slice_end + 1;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write one block of the scan to the client.
+ *
+ * The block is written from the store's memory map, so it is not copied
+ * before it reaches the socket.
+ *
+ * \param context       The \ref ssock_fast_sync_sender.
+ * \param height        The height of the block.
+ * \param block_id      The id of the block.
+ * \param block         The block certificate.
+ * \param size          The size of the block certificate.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_fast_sync_send_block(
+    void* context, uint64_t height, const uint8_t* block_id,
+    const void* block, size_t size)
+{
+    ssock_fast_sync_sender* sender = (ssock_fast_sync_sender*)context;
+    int retval;
+
+    MODEL_ASSERT(NULL != sender);
+
+    if (size > UINT32_MAX)
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        goto fail;
+    }
+
+    retval = ssock_write_uint8(sender->sock, SSOCK_FAST_SYNC_BLOCK);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto fail;
+    }
+
+    retval = ssock_write_uint64(sender->sock, height);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto fail;
+    }
+
+    retval = ssock_write_data(sender->sock, block_id, BLOCK_STORE_ID_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto fail;
+    }
+
+    retval = ssock_write_data(sender->sock, block, (uint32_t)size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto fail;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+fail:
+    sender->write_status = retval;
+
+    return retval;
+}
@@ -0,0 +1,94 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_store_stage.c
+ *
+ * \brief The storage stage of the fast sync pipeline.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_fast_sync_internal.h"
+
+/**
+ * \brief Store verified blocks until the verifier is done or a stage fails.
+ *
+ * Every verified block waiting when the stage wakes is written in one batch,
+ * along with the transactions it wraps, so the commits grow as the store
+ * falls behind, and the slots are freed for the receiver.  Blocks verified
+ * before a failure elsewhere are still stored.
+ *
+ * \param context       The \ref ssock_fast_sync_pipeline.
+ *
+ * \returns NULL.
+ */
+void* ssock_fast_sync_store_stage(void* context)
+{
+    ssock_fast_sync_pipeline* pipeline = (ssock_fast_sync_pipeline*)context;
+    int status = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+    MODEL_ASSERT(NULL != pipeline);
+
+    pthread_mutex_lock(&pipeline->lock);
+    for (;;)
+    {
+        while (pipeline->stored == pipeline->verified && !pipeline->verify_done)
+        {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+
+        if (pipeline->stored == pipeline->verified)
+        {
+            break;
+        }
+
+        size_t first = pipeline->stored;
+        size_t last = pipeline->verified;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        block_store_batch_clear(&pipeline->batch);
+        for (size_t i = first; VCBLOCKCHAIN_STATUS_SUCCESS == status && i < last; ++i)
+        {
+            ssock_fast_sync_slot* slot =
+                &pipeline->slots[i % SSOCK_FAST_SYNC_PIPELINE_DEPTH];
+            status = ssock_fast_sync_add_block(pipeline, slot);
+        }
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status)
+        {
+            status = block_store_write(pipeline->store, &pipeline->batch);
+        }
+
+        /* on failure, the blocks are left for the caller to release. */
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                ssock_fast_sync_slot* slot =
+                    &pipeline->slots[i % SSOCK_FAST_SYNC_PIPELINE_DEPTH];
+                release(pipeline->alloc_opts, slot->data);
+                slot->data = NULL;
+            }
+        }
+
+        pthread_mutex_lock(&pipeline->lock);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != status)
+        {
+            if (VCBLOCKCHAIN_STATUS_SUCCESS == pipeline->status)
+            {
+                pipeline->status = status;
+            }
+
+            break;
+        }
+
+        pipeline->stored = last;
+        pthread_cond_broadcast(&pipeline->changed);
+    }
+
+    /* wake a receiver waiting for a slot. */
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    return NULL;
+}
@@ -0,0 +1,79 @@
+/**
+ * \file src/fast_sync/ssock_fast_sync_verify_stage.c
+ *
+ * \brief The verification stage of the fast sync pipeline.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_fast_sync_internal.h"
+
+/**
+ * \brief Verify received blocks until the receiver is done or a stage fails.
+ *
+ * Blocks are verified one at a time, in order, outside of the lock; the
+ * verifier spreads each block's transactions over its own pool.  Each
+ * verified block is then checked against the height and id it was sent
+ * under, and against the block before it.
+ *
+ * \param context       The \ref ssock_fast_sync_pipeline.
+ *
+ * \returns NULL.
+ */
+void* ssock_fast_sync_verify_stage(void* context)
+{
+    ssock_fast_sync_pipeline* pipeline = (ssock_fast_sync_pipeline*)context;
+    size_t failed_index;
+
+    MODEL_ASSERT(NULL != pipeline);
+
+    pthread_mutex_lock(&pipeline->lock);
+    for (;;)
+    {
+        while (pipeline->verified == pipeline->received && !pipeline->receive_done && VCBLOCKCHAIN_STATUS_SUCCESS == pipeline->status)
+        {
+            pthread_cond_wait(&pipeline->changed, &pipeline->lock);
+        }
+
+        /* stop on a failure, or once every received block is verified. */
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != pipeline->status || pipeline->verified == pipeline->received)
+        {
+            break;
+        }
+
+        ssock_fast_sync_slot* slot =
+            &pipeline->slots[
+                pipeline->verified % SSOCK_FAST_SYNC_PIPELINE_DEPTH];
+        pthread_mutex_unlock(&pipeline->lock);
+
+        int status =
+            block_verifier_verify(
+                pipeline->verifier, slot->data, slot->size, &failed_index);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status)
+        {
+            status = ssock_fast_sync_check_block(pipeline, slot);
+        }
+
+        pthread_mutex_lock(&pipeline->lock);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != status)
+        {
+            if (VCBLOCKCHAIN_STATUS_SUCCESS == pipeline->status)
+            {
+                pipeline->status = status;
+            }
+
+            break;
+        }
+
+        ++pipeline->verified;
+        pthread_cond_broadcast(&pipeline->changed);
+    }
+
+    pipeline->verify_done = 1U;
+    pthread_cond_broadcast(&pipeline->changed);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    return NULL;
+}
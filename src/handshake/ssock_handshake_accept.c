@@ -0,0 +1,313 @@
+/**
+ * \file src/handshake/ssock_handshake_accept.c
+ *
+ * \brief Run the server side of the handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/* forward decls. */
+static int ssock_handshake_accept_reply(
+    ssock_handshake_server* server, ssock* sock,
+    const ssock_handshake_transcript* transcript,
+    const vccrypt_buffer_t* session_key);
+
+/**
+ * \brief Run the server side of the handshake.
+ *
+ * \param server        The server side of the handshake.
+ * \param sock          The socket connected to the client.
+ * \param client_id     Buffer of SSOCK_HANDSHAKE_ID_SIZE bytes to receive the
+ *                      authenticated id of the client.
+ * \param shared_secret Buffer to initialize with the shared secret for this
+ *                      session; the caller owns it on success.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the client sent
+ *        a malformed message.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_UNKNOWN_PEER if the client id was
+ *        rejected by the lookup.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH if the client failed to
+ *        authenticate.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO if a crypto operation
+ *        failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_handshake_accept(
+    ssock_handshake_server* server, ssock* sock, uint8_t* client_id,
+    vccrypt_buffer_t* shared_secret)
+{
+    int retval;
+    ssock_handshake_transcript transcript;
+    uint8_t offer = 0U;
+    void* ticket = NULL;
+    uint32_t ticket_size = 0U;
+    void* client_proof = NULL;
+    uint32_t client_proof_size = 0U;
+    const vccrypt_buffer_t* public_key = NULL;
+    vccrypt_buffer_t resumption_secret, session_key, proof;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != server);
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != client_id);
+    MODEL_ASSERT(NULL != shared_secret);
+
+    /* runtime parameter checks. */
+    if (NULL == server || NULL == sock || NULL == client_id || NULL == shared_secret)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    allocator_options_t* alloc_opts = server->alloc_opts;
+    vccrypt_suite_options_t* suite = server->suite;
+
+    memset(&transcript, 0, sizeof(transcript));
+    memcpy(transcript.server_id, server->server_id, SSOCK_HANDSHAKE_ID_SIZE);
+
+    /* read the client hello. */
+    retval = ssock_read_uint8(sock, &offer);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (SSOCK_HANDSHAKE_MODE_FULL != offer && SSOCK_HANDSHAKE_MODE_RESUME != offer)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    retval =
+        ssock_handshake_read_fixed(
+            sock, alloc_opts, transcript.client_id, SSOCK_HANDSHAKE_ID_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval =
+        ssock_handshake_read_fixed(
+            sock, alloc_opts, transcript.client_nonce,
+            SSOCK_HANDSHAKE_NONCE_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (SSOCK_HANDSHAKE_MODE_RESUME == offer)
+    {
+        retval =
+            ssock_handshake_read_field(sock, alloc_opts, &ticket, &ticket_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    /* the lookup also vets resuming clients, so revocation is immediate. */
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != server->lookup(server->context, transcript.client_id, &public_key) || NULL == public_key || suite->key_cipher_opts.public_key_size != public_key->size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_UNKNOWN_PEER;
+        goto release_ticket;
+    }
+
+    /* resume if the ticket opens; otherwise, fall back to a full handshake. */
+    transcript.mode = SSOCK_HANDSHAKE_MODE_FULL;
+    if (NULL != ticket && server->ticket_lifetime > 0 && VCBLOCKCHAIN_STATUS_SUCCESS == ssock_handshake_ticket_open(server, transcript.client_id, ticket, ticket_size, &resumption_secret))
+    {
+        transcript.mode = SSOCK_HANDSHAKE_MODE_RESUME;
+    }
+
+    pthread_mutex_lock(&server->prng_lock);
+    retval =
+        ssock_handshake_random(
+            &server->prng, suite, transcript.server_nonce,
+            SSOCK_HANDSHAKE_NONCE_SIZE);
+    pthread_mutex_unlock(&server->prng_lock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_resumption_secret;
+    }
+
+    retval =
+        ssock_handshake_session_key(
+            suite, &transcript, server->server_private_key, public_key,
+            &resumption_secret, &session_key);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_resumption_secret;
+    }
+
+    retval =
+        ssock_handshake_accept_reply(server, sock, &transcript, &session_key);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_session_key;
+    }
+
+    /* the client proves that it derived the same key. */
+    retval =
+        ssock_handshake_read_field(
+            sock, alloc_opts, &client_proof, &client_proof_size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_session_key;
+    }
+
+    retval =
+        ssock_handshake_mac(
+            suite, &session_key, SSOCK_HANDSHAKE_LABEL_CLIENT_PROOF,
+            &transcript, sizeof(transcript), &proof);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto release_client_proof;
+    }
+
+    if (proof.size != client_proof_size || 0 != crypto_memcmp(proof.data, client_proof, proof.size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH;
+        goto dispose_proof;
+    }
+
+    retval =
+        ssock_handshake_mac(
+            suite, &session_key, SSOCK_HANDSHAKE_LABEL_TRAFFIC, &transcript,
+            sizeof(transcript), shared_secret);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_proof;
+    }
+
+    memcpy(client_id, transcript.client_id, SSOCK_HANDSHAKE_ID_SIZE);
+
+    if (SSOCK_HANDSHAKE_MODE_RESUME == transcript.mode)
+    {
+        __atomic_fetch_add(&server->resumed_handshakes, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_add(&server->full_handshakes, 1, __ATOMIC_RELAXED);
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_proof:
+    dispose((disposable_t*)&proof);
+
+release_client_proof:
+    release(alloc_opts, client_proof);
+
+dispose_session_key:
+    memset(session_key.data, 0, session_key.size);
+    dispose((disposable_t*)&session_key);
+
+dispose_resumption_secret:
+    if (SSOCK_HANDSHAKE_MODE_RESUME == transcript.mode)
+    {
+        memset(resumption_secret.data, 0, resumption_secret.size);
+        dispose((disposable_t*)&resumption_secret);
+    }
+
+release_ticket:
+    if (NULL != ticket)
+    {
+        release(alloc_opts, ticket);
+    }
+
+    return retval;
+}
+
+/**
+ * \brief Send the server reply: the chosen mode, our id and nonce, our proof,
+ * and a fresh ticket when tickets are enabled.
+ *
+ * \param server        The server side of the handshake.
+ * \param sock          The socket connected to the client.
+ * \param transcript    The transcript.
+ * \param session_key   The session key.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_handshake_accept_reply(
+    ssock_handshake_server* server, ssock* sock,
+    const ssock_handshake_transcript* transcript,
+    const vccrypt_buffer_t* session_key)
+{
+    int retval;
+    vccrypt_buffer_t proof, resumption_secret;
+    void* ticket = NULL;
+    uint32_t ticket_size = 0U;
+
+    retval =
+        ssock_handshake_mac(
+            server->suite, session_key, SSOCK_HANDSHAKE_LABEL_SERVER_PROOF,
+            transcript, sizeof(ssock_handshake_transcript), &proof);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* seal the next resumption secret into a ticket. */
+    if (server->ticket_lifetime > 0)
+    {
+        retval =
+            ssock_handshake_mac(
+                server->suite, session_key, SSOCK_HANDSHAKE_LABEL_RESUMPTION,
+                transcript, sizeof(ssock_handshake_transcript),
+                &resumption_secret);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto dispose_proof;
+        }
+
+        retval =
+            ssock_handshake_ticket_seal(
+                server, transcript->client_id, &resumption_secret, &ticket,
+                &ticket_size);
+        memset(resumption_secret.data, 0, resumption_secret.size);
+        dispose((disposable_t*)&resumption_secret);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto dispose_proof;
+        }
+    }
+
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != (retval = ssock_write_uint8(sock, transcript->mode)) || VCBLOCKCHAIN_STATUS_SUCCESS != (retval = ssock_write_data(sock, transcript->server_id, SSOCK_HANDSHAKE_ID_SIZE)) || VCBLOCKCHAIN_STATUS_SUCCESS != (retval = ssock_write_data(sock, transcript->server_nonce, SSOCK_HANDSHAKE_NONCE_SIZE)) || VCBLOCKCHAIN_STATUS_SUCCESS != (retval = ssock_write_data(sock, proof.data, proof.size)) || VCBLOCKCHAIN_STATUS_SUCCESS != (retval = ssock_write_uint8(sock, NULL != ticket)))
+    {
+        goto release_ticket;
+    }
+
+    if (NULL != ticket)
+    {
+        retval = ssock_write_data(sock, ticket, ticket_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto release_ticket;
+        }
+    }
+
+    retval = ssock_flush(sock);
+
+release_ticket:
+    if (NULL != ticket)
+    {
+        release(server->alloc_opts, ticket);
+    }
+
+dispose_proof:
+    dispose((disposable_t*)&proof);
+
+    return retval;
+}
@@ -0,0 +1,93 @@
+/**
+ * \file src/handshake/ssock_handshake_client_init.c
+ *
+ * \brief Initialize the client side of the handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/* forward decls. */
+static void ssock_handshake_client_dispose(void* disposable);
+
+/**
+ * \brief Initialize the client side of the handshake.
+ *
+ * The keys must outlive the client.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param client                The client to initialize.
+ * \param alloc_opts            The allocator to use for this client.
+ * \param suite                 The crypto suite to use.
+ * \param client_id             The id of this client.
+ * \param client_private_key    The key agreement private key of this client.
+ * \param server_id             The id of the expected server.
+ * \param server_public_key     The key agreement public key of the server.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_handshake_client_init(
+    ssock_handshake_client* client, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, const uint8_t* client_id,
+    const vccrypt_buffer_t* client_private_key, const uint8_t* server_id,
+    const vccrypt_buffer_t* server_public_key)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != client);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != client_id);
+    MODEL_ASSERT(NULL != client_private_key);
+    MODEL_ASSERT(NULL != server_id);
+    MODEL_ASSERT(NULL != server_public_key);
+
+    /* runtime parameter checks. */
+    if (NULL == client || NULL == alloc_opts || NULL == suite || NULL == client_id || NULL == client_private_key || NULL == server_id || NULL == server_public_key)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (suite->key_cipher_opts.private_key_size != client_private_key->size || suite->key_cipher_opts.public_key_size != server_public_key->size || suite->key_cipher_opts.minimum_nonce_size > SSOCK_HANDSHAKE_NONCE_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(client, 0, sizeof(ssock_handshake_client));
+    client->hdr.dispose = &ssock_handshake_client_dispose;
+    client->alloc_opts = alloc_opts;
+    client->suite = suite;
+    memcpy(client->client_id, client_id, SSOCK_HANDSHAKE_ID_SIZE);
+    client->client_private_key = client_private_key;
+    memcpy(client->server_id, server_id, SSOCK_HANDSHAKE_ID_SIZE);
+    client->server_public_key = server_public_key;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of the client side of the handshake, dropping its ticket.
+ *
+ * \param disposable    The client to dispose.
+ */
+static void ssock_handshake_client_dispose(void* disposable)
+{
+    ssock_handshake_client* client = (ssock_handshake_client*)disposable;
+
+    if (NULL != client->ticket)
+    {
+        release(client->alloc_opts, client->ticket);
+        memset(client->resumption_secret.data, 0, client->resumption_secret.size);
+        dispose((disposable_t*)&client->resumption_secret);
+    }
+
+    memset(client, 0, sizeof(ssock_handshake_client));
+}
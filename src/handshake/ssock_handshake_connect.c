@@ -0,0 +1,337 @@
+/**
+ * \file src/handshake/ssock_handshake_connect.c
+ *
+ * \brief Run the client side of the handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/* forward decls. */
+static int ssock_handshake_connect_hello(
+    ssock_handshake_client* client, ssock* sock,
+    const ssock_handshake_transcript* transcript, uint8_t offer);
+static void ssock_handshake_client_drop_ticket(ssock_handshake_client* client);
+
+/**
+ * \brief Run the client side of the handshake.
+ *
+ * If the client holds a ticket, it offers to resume; otherwise, or if the
+ * server rejects the ticket, a full handshake is run.  On success, the
+ * client's ticket is replaced by the one the server issued, and
+ * \ref ssock_handshake_client::resumed records which kind of handshake ran.
+ *
+ * \param client        The client side of the handshake.
+ * \param sock          The socket connected to the server.
+ * \param shared_secret Buffer to initialize with the shared secret for this
+ *                      session; the caller owns it on success.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE or
+ *        VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the server sent
+ *        a malformed message.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH if the server failed to
+ *        authenticate.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO if a crypto operation
+ *        failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_handshake_connect(
+    ssock_handshake_client* client, ssock* sock,
+    vccrypt_buffer_t* shared_secret)
+{
+    int retval;
+    ssock_handshake_transcript transcript;
+    uint8_t server_id[SSOCK_HANDSHAKE_ID_SIZE];
+    uint8_t mode = 0U, has_ticket = 0U;
+    void* server_proof = NULL;
+    uint32_t server_proof_size = 0U;
+    void* ticket = NULL;
+    uint32_t ticket_size = 0U;
+    vccrypt_buffer_t session_key, proof, resumption_secret;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != client);
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != shared_secret);
+
+    /* runtime parameter checks. */
+    if (NULL == client || NULL == sock || NULL == shared_secret)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    allocator_options_t* alloc_opts = client->alloc_opts;
+    vccrypt_suite_options_t* suite = client->suite;
+    uint8_t offer =
+        NULL != client->ticket
+            ? SSOCK_HANDSHAKE_MODE_RESUME : SSOCK_HANDSHAKE_MODE_FULL;
+
+    memset(&transcript, 0, sizeof(transcript));
+    memcpy(transcript.client_id, client->client_id, SSOCK_HANDSHAKE_ID_SIZE);
+    memcpy(transcript.server_id, client->server_id, SSOCK_HANDSHAKE_ID_SIZE);
+
+    retval =
+        ssock_handshake_random(
+            NULL, suite, transcript.client_nonce, SSOCK_HANDSHAKE_NONCE_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_handshake_connect_hello(client, sock, &transcript, offer);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the server may only resume if we offered to. */
+    retval = ssock_read_uint8(sock, &mode);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (SSOCK_HANDSHAKE_MODE_FULL != mode && (SSOCK_HANDSHAKE_MODE_RESUME != mode || SSOCK_HANDSHAKE_MODE_RESUME != offer))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    transcript.mode = mode;
+
+    retval = ssock_handshake_read_fixed(sock, alloc_opts, server_id, sizeof(server_id));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (0 != memcmp(server_id, client->server_id, SSOCK_HANDSHAKE_ID_SIZE))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH;
+    }
+
+    retval =
+        ssock_handshake_read_fixed(
+            sock, alloc_opts, transcript.server_nonce,
+            SSOCK_HANDSHAKE_NONCE_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval =
+        ssock_handshake_read_field(
+            sock, alloc_opts, &server_proof, &server_proof_size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_read_uint8(sock, &has_ticket);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto release_fields;
+    }
+
+    if (has_ticket)
+    {
+        retval =
+            ssock_handshake_read_field(sock, alloc_opts, &ticket, &ticket_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto release_fields;
+        }
+    }
+
+    /* the server proves that it derived the same key. */
+    retval =
+        ssock_handshake_session_key(
+            suite, &transcript, client->client_private_key,
+            client->server_public_key, &client->resumption_secret,
+            &session_key);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto release_fields;
+    }
+
+    retval =
+        ssock_handshake_mac(
+            suite, &session_key, SSOCK_HANDSHAKE_LABEL_SERVER_PROOF,
+            &transcript, sizeof(transcript), &proof);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_session_key;
+    }
+
+    if (proof.size != server_proof_size || 0 != crypto_memcmp(proof.data, server_proof, proof.size))
+    {
+        dispose((disposable_t*)&proof);
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH;
+        goto dispose_session_key;
+    }
+
+    dispose((disposable_t*)&proof);
+
+    /* then we prove the same to the server. */
+    retval =
+        ssock_handshake_mac(
+            suite, &session_key, SSOCK_HANDSHAKE_LABEL_CLIENT_PROOF,
+            &transcript, sizeof(transcript), &proof);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_session_key;
+    }
+
+    retval = ssock_write_data(sock, proof.data, proof.size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        retval = ssock_flush(sock);
+    }
+
+    dispose((disposable_t*)&proof);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto dispose_session_key;
+    }
+
+    if (NULL != ticket)
+    {
+        retval =
+            ssock_handshake_mac(
+                suite, &session_key, SSOCK_HANDSHAKE_LABEL_RESUMPTION,
+                &transcript, sizeof(transcript), &resumption_secret);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto dispose_session_key;
+        }
+    }
+
+    retval =
+        ssock_handshake_mac(
+            suite, &session_key, SSOCK_HANDSHAKE_LABEL_TRAFFIC, &transcript,
+            sizeof(transcript), shared_secret);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        if (NULL != ticket)
+        {
+            dispose((disposable_t*)&resumption_secret);
+        }
+
+        goto dispose_session_key;
+    }
+
+    /* replace our ticket with the new one, if any. */
+    ssock_handshake_client_drop_ticket(client);
+    if (NULL != ticket)
+    {
+        client->ticket = ticket;
+        client->ticket_size = ticket_size;
+        client->resumption_secret = resumption_secret;
+        ticket = NULL;
+    }
+
+    client->resumed = SSOCK_HANDSHAKE_MODE_RESUME == mode;
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_session_key:
+    memset(session_key.data, 0, session_key.size);
+    dispose((disposable_t*)&session_key);
+
+release_fields:
+    /* a ticket which failed to authenticate is not offered again. */
+    if (VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH == retval && SSOCK_HANDSHAKE_MODE_RESUME == mode)
+    {
+        ssock_handshake_client_drop_ticket(client);
+    }
+
+    if (NULL != ticket)
+    {
+        release(alloc_opts, ticket);
+    }
+
+    release(alloc_opts, server_proof);
+
+    return retval;
+}
+
+/**
+ * \brief Send the client hello: the offered mode, our id and nonce, and our
+ * ticket when offering to resume.
+ *
+ * \param client        The client side of the handshake.
+ * \param sock          The socket connected to the server.
+ * \param transcript    The transcript so far.
+ * \param offer         The offered SSOCK_HANDSHAKE_MODE_*.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_handshake_connect_hello(
+    ssock_handshake_client* client, ssock* sock,
+    const ssock_handshake_transcript* transcript, uint8_t offer)
+{
+    int retval;
+
+    retval = ssock_write_uint8(sock, offer);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval =
+        ssock_write_data(
+            sock, transcript->client_id, SSOCK_HANDSHAKE_ID_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval =
+        ssock_write_data(
+            sock, transcript->client_nonce, SSOCK_HANDSHAKE_NONCE_SIZE);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (SSOCK_HANDSHAKE_MODE_RESUME == offer)
+    {
+        retval = ssock_write_data(sock, client->ticket, client->ticket_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    return ssock_flush(sock);
+}
+
+/**
+ * \brief Drop the client's ticket, if any.
+ *
+ * \param client        The client side of the handshake.
+ */
+static void ssock_handshake_client_drop_ticket(ssock_handshake_client* client)
+{
+    if (NULL == client->ticket)
+    {
+        return;
+    }
+
+    release(client->alloc_opts, client->ticket);
+    client->ticket = NULL;
+    client->ticket_size = 0U;
+
+    memset(client->resumption_secret.data, 0, client->resumption_secret.size);
+    dispose((disposable_t*)&client->resumption_secret);
+}
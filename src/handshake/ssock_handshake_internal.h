@@ -0,0 +1,176 @@
+/**
+ * \file src/handshake/ssock_handshake_internal.h
+ *
+ * \brief Internal types and functions for the ssock handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_HANDSHAKE_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_HANDSHAKE_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/ssock_handshake.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief Labels separating the values derived from one key.
+ */
+#define SSOCK_HANDSHAKE_LABEL_SERVER_PROOF 0x01
+#define SSOCK_HANDSHAKE_LABEL_CLIENT_PROOF 0x02
+#define SSOCK_HANDSHAKE_LABEL_RESUMPTION 0x03
+#define SSOCK_HANDSHAKE_LABEL_TRAFFIC 0x04
+#define SSOCK_HANDSHAKE_LABEL_RESUME_KEY 0x05
+#define SSOCK_HANDSHAKE_LABEL_TICKET_PAD 0x06
+#define SSOCK_HANDSHAKE_LABEL_TICKET_TAG 0x07
+
+/**
+ * \brief The version of the ticket format.
+ */
+#define SSOCK_HANDSHAKE_TICKET_VERSION 0x01
+
+/**
+ * \brief The handshake transcript, which every derived value is bound to.
+ * It holds only bytes, so it has no padding and is hashed as is.
+ */
+typedef struct ssock_handshake_transcript
+{
+    uint8_t mode;
+    uint8_t client_id[SSOCK_HANDSHAKE_ID_SIZE];
+    uint8_t server_id[SSOCK_HANDSHAKE_ID_SIZE];
+    uint8_t client_nonce[SSOCK_HANDSHAKE_NONCE_SIZE];
+    uint8_t server_nonce[SSOCK_HANDSHAKE_NONCE_SIZE];
+} ssock_handshake_transcript;
+
+/**
+ * \brief The clear part of a ticket, which is followed by the sealed
+ * resumption secret and a tag, each of the suite's MAC size.
+ */
+typedef struct ssock_handshake_ticket_header
+{
+    uint8_t version;
+    uint8_t client_id[SSOCK_HANDSHAKE_ID_SIZE];
+    uint8_t expiry[8];
+    uint8_t nonce[16];
+} ssock_handshake_ticket_header;
+
+/**
+ * \brief MAC a labeled message with the suite's short MAC.
+ *
+ * \param suite         The crypto suite.
+ * \param key           The MAC key.
+ * \param label         The SSOCK_HANDSHAKE_LABEL_* of this value.
+ * \param data          The message.
+ * \param size          The size of the message.
+ * \param out           Buffer to initialize with the MAC.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_mac(
+    vccrypt_suite_options_t* suite, const vccrypt_buffer_t* key, uint8_t label,
+    const void* data, size_t size, vccrypt_buffer_t* out);
+
+/**
+ * \brief Derive the session key of a handshake.
+ *
+ * A full handshake runs the key agreement between our private key and the
+ * peer's public key, mixed with both nonces.  A resumed handshake derives the
+ * key from the resumption secret and the transcript.
+ *
+ * \param suite             The crypto suite.
+ * \param transcript        The transcript, whose mode selects the derivation.
+ * \param private_key       Our private key, for a full handshake.
+ * \param public_key        The peer's public key, for a full handshake.
+ * \param resumption_secret The resumption secret, for a resumed handshake.
+ * \param session_key       Buffer to initialize with the session key.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_session_key(
+    vccrypt_suite_options_t* suite,
+    const ssock_handshake_transcript* transcript,
+    const vccrypt_buffer_t* private_key, const vccrypt_buffer_t* public_key,
+    const vccrypt_buffer_t* resumption_secret, vccrypt_buffer_t* session_key);
+
+/**
+ * \brief Read a bounded data packet during a handshake.
+ *
+ * \param sock          The socket to read from.
+ * \param alloc_opts    The allocator for the field.
+ * \param val           Pointer to receive the field, owned by the caller.
+ * \param size          Pointer to receive the size of the field.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_read_field(
+    ssock* sock, allocator_options_t* alloc_opts, void** val, uint32_t* size);
+
+/**
+ * \brief Read a data packet of an exact size during a handshake.
+ *
+ * \param sock          The socket to read from.
+ * \param alloc_opts    The allocator for the read.
+ * \param buf           The buffer to receive the field.
+ * \param size          The expected size of the field.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_read_fixed(
+    ssock* sock, allocator_options_t* alloc_opts, void* buf, uint32_t size);
+
+/**
+ * \brief Read random bytes from the suite's prng.
+ *
+ * \param prng          The prng to read, or NULL to use a fresh one.
+ * \param suite         The crypto suite.
+ * \param buf           The buffer to fill.
+ * \param size          The number of bytes to read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_random(
+    vccrypt_prng_context_t* prng, vccrypt_suite_options_t* suite, void* buf,
+    size_t size);
+
+/**
+ * \brief Seal a resumption secret into a ticket for a client.
+ *
+ * \param server            The server issuing the ticket.
+ * \param client_id         The client the ticket is for.
+ * \param resumption_secret The resumption secret to seal.
+ * \param ticket            Pointer to receive the ticket, owned by the caller.
+ * \param size              Pointer to receive the size of the ticket.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_ticket_seal(
+    ssock_handshake_server* server, const uint8_t* client_id,
+    const vccrypt_buffer_t* resumption_secret, void** ticket, uint32_t* size);
+
+/**
+ * \brief Open a ticket presented by a client.
+ *
+ * \param server            The server which issued the ticket.
+ * \param client_id         The id the client presented.
+ * \param ticket            The ticket.
+ * \param size              The size of the ticket.
+ * \param resumption_secret Buffer to initialize with the resumption secret.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH if the ticket is forged,
+ *        expired, or for another client.
+ */
+int ssock_handshake_ticket_open(
+    ssock_handshake_server* server, const uint8_t* client_id,
+    const void* ticket, uint32_t size, vccrypt_buffer_t* resumption_secret);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_HANDSHAKE_INTERNAL_HEADER_GUARD*/
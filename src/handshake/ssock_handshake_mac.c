@@ -0,0 +1,66 @@
+/**
+ * \file src/handshake/ssock_handshake_mac.c
+ *
+ * \brief MAC a labeled handshake message.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief MAC a labeled message with the suite's short MAC.
+ *
+ * \param suite         The crypto suite.
+ * \param key           The MAC key.
+ * \param label         The SSOCK_HANDSHAKE_LABEL_* of this value.
+ * \param data          The message.
+ * \param size          The size of the message.
+ * \param out           Buffer to initialize with the MAC.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_mac(
+    vccrypt_suite_options_t* suite, const vccrypt_buffer_t* key, uint8_t label,
+    const void* data, size_t size, vccrypt_buffer_t* out)
+{
+    int retval;
+    vccrypt_mac_context_t mac;
+
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != key);
+    MODEL_ASSERT(NULL != data);
+    MODEL_ASSERT(NULL != out);
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_mac_authentication_code(suite, out, true))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_mac_short_init(suite, &mac, (vccrypt_buffer_t*)key))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+        goto dispose_out;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_mac_digest(&mac, &label, sizeof(label)) || VCCRYPT_STATUS_SUCCESS != vccrypt_mac_digest(&mac, (const uint8_t*)data, size) || VCCRYPT_STATUS_SUCCESS != vccrypt_mac_finalize(&mac, out))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+        goto dispose_mac;
+    }
+
+    dispose((disposable_t*)&mac);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_mac:
+    dispose((disposable_t*)&mac);
+
+dispose_out:
+    dispose((disposable_t*)out);
+
+    return retval;
+}
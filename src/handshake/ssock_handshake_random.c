@@ -0,0 +1,67 @@
+/**
+ * \file src/handshake/ssock_handshake_random.c
+ *
+ * \brief Read random bytes for a handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief Read random bytes from the suite's prng.
+ *
+ * \param prng          The prng to read, or NULL to use a fresh one.
+ * \param suite         The crypto suite.
+ * \param buf           The buffer to fill.
+ * \param size          The number of bytes to read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_random(
+    vccrypt_prng_context_t* prng, vccrypt_suite_options_t* suite, void* buf,
+    size_t size)
+{
+    int retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+    vccrypt_prng_context_t local;
+    vccrypt_buffer_t bytes;
+
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != buf);
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_buffer_init(&bytes, suite->alloc_opts, size))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (NULL == prng)
+    {
+        if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_prng_init(suite, &local))
+        {
+            retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+            goto dispose_bytes;
+        }
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_prng_read(NULL != prng ? prng : &local, &bytes, size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+    }
+    else
+    {
+        memcpy(buf, bytes.data, size);
+    }
+
+    if (NULL == prng)
+    {
+        dispose((disposable_t*)&local);
+    }
+
+dispose_bytes:
+    dispose((disposable_t*)&bytes);
+
+    return retval;
+}
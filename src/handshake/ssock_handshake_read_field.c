@@ -0,0 +1,45 @@
+/**
+ * \file src/handshake/ssock_handshake_read_field.c
+ *
+ * \brief Read a bounded data packet during a handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief Read a bounded data packet during a handshake.
+ *
+ * The peer is not authenticated yet, so the read policy of the socket is
+ * tightened to SSOCK_HANDSHAKE_MAX_FIELD_SIZE for this read.
+ *
+ * \param sock          The socket to read from.
+ * \param alloc_opts    The allocator for the field.
+ * \param val           Pointer to receive the field, owned by the caller.
+ * \param size          Pointer to receive the size of the field.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_read_field(
+    ssock* sock, allocator_options_t* alloc_opts, void** val, uint32_t* size)
+{
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != val);
+    MODEL_ASSERT(NULL != size);
+
+    ssock_read_policy saved = sock->read_policy;
+    if (0 == sock->read_policy.max_data_size || sock->read_policy.max_data_size > SSOCK_HANDSHAKE_MAX_FIELD_SIZE)
+    {
+        sock->read_policy.max_data_size = SSOCK_HANDSHAKE_MAX_FIELD_SIZE;
+    }
+
+    int retval = ssock_read_data(sock, alloc_opts, val, size);
+
+    sock->read_policy = saved;
+
+    return retval;
+}
@@ -0,0 +1,50 @@
+/**
+ * \file src/handshake/ssock_handshake_read_fixed.c
+ *
+ * \brief Read a data packet of an exact size during a handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief Read a data packet of an exact size during a handshake.
+ *
+ * \param sock          The socket to read from.
+ * \param alloc_opts    The allocator for the read.
+ * \param buf           The buffer to receive the field.
+ * \param size          The expected size of the field.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_read_fixed(
+    ssock* sock, allocator_options_t* alloc_opts, void* buf, uint32_t size)
+{
+    void* val = NULL;
+    uint32_t val_size = 0U;
+
+    MODEL_ASSERT(NULL != buf);
+
+    int retval = ssock_handshake_read_field(sock, alloc_opts, &val, &val_size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (size != val_size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+    else
+    {
+        memcpy(buf, val, size);
+    }
+
+    release(alloc_opts, val);
+
+    return retval;
+}
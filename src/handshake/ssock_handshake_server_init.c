@@ -0,0 +1,146 @@
+/**
+ * \file src/handshake/ssock_handshake_server_init.c
+ *
+ * \brief Initialize the server side of the handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/* forward decls. */
+static void ssock_handshake_server_dispose(void* disposable);
+
+/**
+ * \brief Initialize the server side of the handshake.
+ *
+ * Tickets are sealed with the given ticket key, so servers sharing a key can
+ * resume each other's sessions.  With a NULL ticket key, a random key is
+ * generated, and tickets are only good on this server.  A ticket lifetime of
+ * 0 disables tickets.  The private key must outlive the server.  This
+ * instance is disposable and must be disposed by calling \ref dispose() when
+ * no longer needed.
+ *
+ * \param server                The server to initialize.
+ * \param alloc_opts            The allocator to use for this server.
+ * \param suite                 The crypto suite to use.
+ * \param server_id             The id of this server.
+ * \param server_private_key    The key agreement private key of this server.
+ * \param lookup                The client public key lookup.
+ * \param context               The user context for the lookup.
+ * \param ticket_key            Optional ticket key of the suite's MAC key
+ *                              size, or NULL.
+ * \param ticket_lifetime       The lifetime of a ticket, in seconds.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO if a crypto operation
+ *        failed.
+ */
+int ssock_handshake_server_init(
+    ssock_handshake_server* server, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, const uint8_t* server_id,
+    const vccrypt_buffer_t* server_private_key,
+    ssock_handshake_key_lookup_fn lookup, void* context,
+    const vccrypt_buffer_t* ticket_key, uint32_t ticket_lifetime)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != server);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != server_id);
+    MODEL_ASSERT(NULL != server_private_key);
+    MODEL_ASSERT(NULL != lookup);
+
+    /* runtime parameter checks. */
+    if (NULL == server || NULL == alloc_opts || NULL == suite || NULL == server_id || NULL == server_private_key || NULL == lookup)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    size_t key_size = suite->mac_short_opts.key_size;
+    if (suite->key_cipher_opts.private_key_size != server_private_key->size || suite->key_cipher_opts.minimum_nonce_size > SSOCK_HANDSHAKE_NONCE_SIZE || (NULL != ticket_key && key_size != ticket_key->size))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(server, 0, sizeof(ssock_handshake_server));
+    server->alloc_opts = alloc_opts;
+    server->suite = suite;
+    memcpy(server->server_id, server_id, SSOCK_HANDSHAKE_ID_SIZE);
+    server->server_private_key = server_private_key;
+    server->lookup = lookup;
+    server->context = context;
+    server->ticket_lifetime = ticket_lifetime;
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_prng_init(suite, &server->prng))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_buffer_init(&server->ticket_key, alloc_opts, key_size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_prng;
+    }
+
+    /* use the shared ticket key, or make one up. */
+    if (NULL != ticket_key)
+    {
+        memcpy(server->ticket_key.data, ticket_key->data, key_size);
+    }
+    else
+    {
+        retval =
+            ssock_handshake_random(
+                &server->prng, suite, server->ticket_key.data, key_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto dispose_ticket_key;
+        }
+    }
+
+    if (0 != pthread_mutex_init(&server->prng_lock, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_ticket_key;
+    }
+
+    server->hdr.dispose = &ssock_handshake_server_dispose;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_ticket_key:
+    dispose((disposable_t*)&server->ticket_key);
+
+dispose_prng:
+    dispose((disposable_t*)&server->prng);
+
+    return retval;
+}
+
+/**
+ * \brief Dispose of the server side of the handshake.
+ *
+ * \param disposable    The server to dispose.
+ */
+static void ssock_handshake_server_dispose(void* disposable)
+{
+    ssock_handshake_server* server = (ssock_handshake_server*)disposable;
+
+    memset(server->ticket_key.data, 0, server->ticket_key.size);
+    dispose((disposable_t*)&server->ticket_key);
+    dispose((disposable_t*)&server->prng);
+    pthread_mutex_destroy(&server->prng_lock);
+
+    memset(server, 0, sizeof(ssock_handshake_server));
+}
@@ -0,0 +1,108 @@
+/**
+ * \file src/handshake/ssock_handshake_session_key.c
+ *
+ * \brief Derive the session key of a handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief Derive the session key of a handshake.
+ *
+ * A full handshake runs the key agreement between our private key and the
+ * peer's public key, mixed with both nonces.  A resumed handshake derives the
+ * key from the resumption secret and the transcript.
+ *
+ * \param suite             The crypto suite.
+ * \param transcript        The transcript, whose mode selects the derivation.
+ * \param private_key       Our private key, for a full handshake.
+ * \param public_key        The peer's public key, for a full handshake.
+ * \param resumption_secret The resumption secret, for a resumed handshake.
+ * \param session_key       Buffer to initialize with the session key.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_session_key(
+    vccrypt_suite_options_t* suite,
+    const ssock_handshake_transcript* transcript,
+    const vccrypt_buffer_t* private_key, const vccrypt_buffer_t* public_key,
+    const vccrypt_buffer_t* resumption_secret, vccrypt_buffer_t* session_key)
+{
+    int retval;
+    vccrypt_key_agreement_context_t agreement;
+    vccrypt_buffer_t server_nonce, client_nonce;
+
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != transcript);
+    MODEL_ASSERT(NULL != session_key);
+
+    /* a resumed session skips the public-key operations. */
+    if (SSOCK_HANDSHAKE_MODE_RESUME == transcript->mode)
+    {
+        MODEL_ASSERT(NULL != resumption_secret);
+
+        return
+            ssock_handshake_mac(
+                suite, resumption_secret, SSOCK_HANDSHAKE_LABEL_RESUME_KEY,
+                transcript, sizeof(ssock_handshake_transcript), session_key);
+    }
+
+    MODEL_ASSERT(NULL != private_key);
+    MODEL_ASSERT(NULL != public_key);
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_buffer_init(&server_nonce, suite->alloc_opts, SSOCK_HANDSHAKE_NONCE_SIZE))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_buffer_init(&client_nonce, suite->alloc_opts, SSOCK_HANDSHAKE_NONCE_SIZE))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_server_nonce;
+    }
+
+    memcpy(server_nonce.data, transcript->server_nonce, SSOCK_HANDSHAKE_NONCE_SIZE);
+    memcpy(client_nonce.data, transcript->client_nonce, SSOCK_HANDSHAKE_NONCE_SIZE);
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_cipher_key_agreement_shared_secret(suite, session_key))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_client_nonce;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_cipher_key_agreement_init(suite, &agreement))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+        goto dispose_session_key;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_key_agreement_short_term_secret_create(&agreement, private_key, public_key, &server_nonce, &client_nonce, session_key))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_CRYPTO;
+        goto dispose_agreement;
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+    dispose((disposable_t*)&agreement);
+    goto dispose_client_nonce;
+
+dispose_agreement:
+    dispose((disposable_t*)&agreement);
+
+dispose_session_key:
+    dispose((disposable_t*)session_key);
+
+dispose_client_nonce:
+    dispose((disposable_t*)&client_nonce);
+
+dispose_server_nonce:
+    dispose((disposable_t*)&server_nonce);
+
+    return retval;
+}
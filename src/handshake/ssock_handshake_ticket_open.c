@@ -0,0 +1,111 @@
+/**
+ * \file src/handshake/ssock_handshake_ticket_open.c
+ *
+ * \brief Open a ticket presented by a client.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief Open a ticket presented by a client.
+ *
+ * \param server            The server which issued the ticket.
+ * \param client_id         The id the client presented.
+ * \param ticket            The ticket.
+ * \param size              The size of the ticket.
+ * \param resumption_secret Buffer to initialize with the resumption secret.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH if the ticket is forged,
+ *        expired, or for another client.
+ */
+int ssock_handshake_ticket_open(
+    ssock_handshake_server* server, const uint8_t* client_id,
+    const void* ticket, uint32_t size, vccrypt_buffer_t* resumption_secret)
+{
+    int retval;
+    ssock_handshake_ticket_header hdr;
+    vccrypt_buffer_t pad, tag;
+
+    MODEL_ASSERT(NULL != server);
+    MODEL_ASSERT(NULL != client_id);
+    MODEL_ASSERT(NULL != ticket);
+    MODEL_ASSERT(NULL != resumption_secret);
+
+    size_t mac_size = server->suite->mac_short_opts.mac_size;
+    const uint8_t* buf = (const uint8_t*)ticket;
+
+    if (sizeof(hdr) + 2 * mac_size != size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH;
+    }
+
+    /* check the tag before trusting anything in the ticket. */
+    retval =
+        ssock_handshake_mac(
+            server->suite, &server->ticket_key,
+            SSOCK_HANDSHAKE_LABEL_TICKET_TAG, buf, sizeof(hdr) + mac_size,
+            &tag);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    int forged = crypto_memcmp(tag.data, buf + sizeof(hdr) + mac_size, mac_size);
+    dispose((disposable_t*)&tag);
+    if (0 != forged)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH;
+    }
+
+    memcpy(&hdr, buf, sizeof(hdr));
+
+    uint64_t expiry = 0U;
+    for (size_t i = 0; i < sizeof(hdr.expiry); ++i)
+    {
+        expiry = (expiry << 8) | hdr.expiry[i];
+    }
+
+    if (SSOCK_HANDSHAKE_TICKET_VERSION != hdr.version || 0 != memcmp(hdr.client_id, client_id, SSOCK_HANDSHAKE_ID_SIZE) || expiry <= (uint64_t)time(NULL))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH;
+    }
+
+    /* unmask the secret. */
+    retval =
+        ssock_handshake_mac(
+            server->suite, &server->ticket_key,
+            SSOCK_HANDSHAKE_LABEL_TICKET_PAD, &hdr, sizeof(hdr), &pad);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_mac_authentication_code(server->suite, resumption_secret, true))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_pad;
+    }
+
+    uint8_t* secret = (uint8_t*)resumption_secret->data;
+    const uint8_t* mask = (const uint8_t*)pad.data;
+    for (size_t i = 0; i < mac_size; ++i)
+    {
+        secret[i] = buf[sizeof(hdr) + i] ^ mask[i];
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_pad:
+    dispose((disposable_t*)&pad);
+
+    return retval;
+}
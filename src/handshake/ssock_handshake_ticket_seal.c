@@ -0,0 +1,119 @@
+/**
+ * \file src/handshake/ssock_handshake_ticket_seal.c
+ *
+ * \brief Seal a resumption secret into a ticket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <time.h>
+
+#include "ssock_handshake_internal.h"
+
+/**
+ * \brief Seal a resumption secret into a ticket for a client.
+ *
+ * The secret is masked with a pad derived from the ticket key and the clear
+ * header, which carries a fresh nonce, and the whole ticket is tagged with the
+ * ticket key.
+ *
+ * \param server            The server issuing the ticket.
+ * \param client_id         The client the ticket is for.
+ * \param resumption_secret The resumption secret to seal.
+ * \param ticket            Pointer to receive the ticket, owned by the caller.
+ * \param size              Pointer to receive the size of the ticket.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int ssock_handshake_ticket_seal(
+    ssock_handshake_server* server, const uint8_t* client_id,
+    const vccrypt_buffer_t* resumption_secret, void** ticket, uint32_t* size)
+{
+    int retval;
+    ssock_handshake_ticket_header hdr;
+    vccrypt_buffer_t pad, tag;
+
+    MODEL_ASSERT(NULL != server);
+    MODEL_ASSERT(NULL != client_id);
+    MODEL_ASSERT(NULL != resumption_secret);
+    MODEL_ASSERT(NULL != ticket);
+    MODEL_ASSERT(NULL != size);
+
+    size_t mac_size = server->suite->mac_short_opts.mac_size;
+    if (resumption_secret->size != mac_size)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* build the clear header. */
+    uint64_t expiry = (uint64_t)time(NULL) + server->ticket_lifetime;
+    hdr.version = SSOCK_HANDSHAKE_TICKET_VERSION;
+    memcpy(hdr.client_id, client_id, SSOCK_HANDSHAKE_ID_SIZE);
+    for (size_t i = 0; i < sizeof(hdr.expiry); ++i)
+    {
+        hdr.expiry[i] = (uint8_t)(expiry >> (8 * (sizeof(hdr.expiry) - 1 - i)));
+    }
+
+    pthread_mutex_lock(&server->prng_lock);
+    retval =
+        ssock_handshake_random(
+            &server->prng, server->suite, hdr.nonce, sizeof(hdr.nonce));
+    pthread_mutex_unlock(&server->prng_lock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval =
+        ssock_handshake_mac(
+            server->suite, &server->ticket_key,
+            SSOCK_HANDSHAKE_LABEL_TICKET_PAD, &hdr, sizeof(hdr), &pad);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    *size = (uint32_t)(sizeof(hdr) + 2 * mac_size);
+    uint8_t* buf = (uint8_t*)allocate(server->alloc_opts, *size);
+    if (NULL == buf)
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_pad;
+    }
+
+    /* header, then the masked secret. */
+    memcpy(buf, &hdr, sizeof(hdr));
+    const uint8_t* secret = (const uint8_t*)resumption_secret->data;
+    const uint8_t* mask = (const uint8_t*)pad.data;
+    for (size_t i = 0; i < mac_size; ++i)
+    {
+        buf[sizeof(hdr) + i] = secret[i] ^ mask[i];
+    }
+
+    /* then the tag over both. */
+    retval =
+        ssock_handshake_mac(
+            server->suite, &server->ticket_key,
+            SSOCK_HANDSHAKE_LABEL_TICKET_TAG, buf, sizeof(hdr) + mac_size,
+            &tag);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        release(server->alloc_opts, buf);
+        goto dispose_pad;
+    }
+
+    memcpy(buf + sizeof(hdr) + mac_size, tag.data, mac_size);
+    dispose((disposable_t*)&tag);
+
+    *ticket = buf;
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_pad:
+    dispose((disposable_t*)&pad);
+
+    return retval;
+}
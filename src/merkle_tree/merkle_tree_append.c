@@ -0,0 +1,90 @@
+/**
+ * \file src/merkle_tree/merkle_tree_append.c
+ *
+ * \brief Append a leaf to a Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Append a leaf to the tree.
+ *
+ * On failure, the tree is left as it was.
+ *
+ * \param tree          The tree.
+ * \param data          The leaf data, such as a transaction certificate.
+ * \param size          The size of the leaf data.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_append(merkle_tree* tree, const void* data, size_t size)
+{
+    int retval;
+    uint8_t nodes[MERKLE_TREE_MAX_LEVELS][MERKLE_TREE_MAX_HASH_SIZE];
+    size_t k;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != tree);
+    MODEL_ASSERT(NULL != data || 0 == size);
+
+    /* runtime parameter checks. */
+    if (NULL == tree || (NULL == data && 0 != size))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    retval =
+        merkle_tree_hash(
+            tree->suite, MERKLE_TREE_LEAF_PREFIX, data, size, NULL, 0,
+            nodes[0]);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* while a level has a node waiting for its pair, this node completes it;
+     * hash every parent before changing the tree. */
+    for (k = 0; k + 1 < MERKLE_TREE_MAX_LEVELS && 1 == tree->levels[k].count % 2; ++k)
+    {
+        const merkle_tree_level* level = &tree->levels[k];
+        const uint8_t* left =
+            level->nodes + (level->count - 1) * tree->hash_size;
+
+        retval =
+            merkle_tree_hash(
+                tree->suite, MERKLE_TREE_NODE_PREFIX, left, tree->hash_size,
+                nodes[k], tree->hash_size, nodes[k + 1]);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    for (size_t i = 0; i <= k; ++i)
+    {
+        retval = merkle_tree_level_reserve(tree, &tree->levels[i]);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    for (size_t i = 0; i <= k; ++i)
+    {
+        merkle_tree_level* level = &tree->levels[i];
+        memcpy(level->nodes + level->count * tree->hash_size, nodes[i], tree->hash_size);
+        ++level->count;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,25 @@
+/**
+ * \file src/merkle_tree/merkle_tree_count.c
+ *
+ * \brief Get the number of leaves in a Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Get the number of leaves in the tree.
+ *
+ * \param tree          The tree.
+ *
+ * \returns the number of leaves.
+ */
+size_t merkle_tree_count(const merkle_tree* tree)
+{
+    MODEL_ASSERT(NULL != tree);
+
+    return tree->levels[0].count;
+}
@@ -0,0 +1,82 @@
+/**
+ * \file src/merkle_tree/merkle_tree_hash.c
+ *
+ * \brief Hash a leaf or a pair of nodes.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Hash a prefix byte followed by up to two runs of data.
+ *
+ * \param suite         The crypto suite.
+ * \param prefix        The prefix byte.
+ * \param first         The first run.
+ * \param first_size    The size of the first run.
+ * \param second        The second run, or NULL.
+ * \param second_size   The size of the second run.
+ * \param out           Buffer of the suite's hash size to receive the hash.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash failed.
+ */
+int merkle_tree_hash(
+    vccrypt_suite_options_t* suite, uint8_t prefix, const void* first,
+    size_t first_size, const void* second, size_t second_size, uint8_t* out)
+{
+    int retval;
+    vccrypt_hash_context_t hash;
+    vccrypt_buffer_t hash_buffer;
+
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != first || 0 == first_size);
+    MODEL_ASSERT(NULL != out);
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_hash_init(suite, &hash))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_hash(suite, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, &prefix, sizeof(prefix)) || VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, (const uint8_t*)first, first_size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    if (NULL != second && VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(&hash, (const uint8_t*)second, second_size))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_finalize(&hash, &hash_buffer))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto dispose_hash_buffer;
+    }
+
+    memcpy(out, hash_buffer.data, hash_buffer.size);
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+dispose_hash_buffer:
+    dispose((disposable_t*)&hash_buffer);
+
+dispose_hash:
+    dispose((disposable_t*)&hash);
+
+    return retval;
+}
@@ -0,0 +1,75 @@
+/**
+ * \file src/merkle_tree/merkle_tree_init.c
+ *
+ * \brief Initialize a Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/* forward decls. */
+static void merkle_tree_dispose(void* disposable);
+
+/**
+ * \brief Initialize an empty Merkle tree.
+ *
+ * The suite must outlive the tree.  This instance is disposable and must be
+ * disposed by calling \ref dispose() when no longer needed.
+ *
+ * \param tree          The tree to initialize.
+ * \param alloc_opts    The allocator to use for this tree.
+ * \param suite         The crypto suite whose hash builds the tree.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        the suite's hash is larger than MERKLE_TREE_MAX_HASH_SIZE.
+ */
+int merkle_tree_init(
+    merkle_tree* tree, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != tree);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != suite);
+
+    /* runtime parameter checks. */
+    if (NULL == tree || NULL == alloc_opts || NULL == suite || suite->hash_opts.hash_size > MERKLE_TREE_MAX_HASH_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(tree, 0, sizeof(merkle_tree));
+    tree->hdr.dispose = &merkle_tree_dispose;
+    tree->alloc_opts = alloc_opts;
+    tree->suite = suite;
+    tree->hash_size = suite->hash_opts.hash_size;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a Merkle tree.
+ *
+ * \param disposable    The tree to dispose.
+ */
+static void merkle_tree_dispose(void* disposable)
+{
+    merkle_tree* tree = (merkle_tree*)disposable;
+
+    for (size_t i = 0; i < MERKLE_TREE_MAX_LEVELS; ++i)
+    {
+        if (NULL != tree->levels[i].nodes)
+        {
+            release(tree->alloc_opts, tree->levels[i].nodes);
+        }
+    }
+
+    memset(tree, 0, sizeof(merkle_tree));
+}
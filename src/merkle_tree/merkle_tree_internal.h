@@ -0,0 +1,117 @@
+/**
+ * \file src/merkle_tree/merkle_tree_internal.h
+ *
+ * \brief Internal functions for the Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_MERKLE_TREE_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_MERKLE_TREE_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/merkle_tree.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The prefix hashed before a leaf.
+ */
+#define MERKLE_TREE_LEAF_PREFIX 0x00
+
+/**
+ * \brief The prefix hashed before a pair of child nodes.
+ */
+#define MERKLE_TREE_NODE_PREFIX 0x01
+
+/**
+ * \brief The initial number of nodes a level has room for.
+ */
+#define MERKLE_TREE_LEVEL_INITIAL_CAPACITY 16
+
+/**
+ * \brief Hash a prefix byte followed by up to two runs of data.
+ *
+ * \param suite         The crypto suite.
+ * \param prefix        The prefix byte.
+ * \param first         The first run.
+ * \param first_size    The size of the first run.
+ * \param second        The second run, or NULL.
+ * \param second_size   The size of the second run.
+ * \param out           Buffer of the suite's hash size to receive the hash.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash failed.
+ */
+int merkle_tree_hash(
+    vccrypt_suite_options_t* suite, uint8_t prefix, const void* first,
+    size_t first_size, const void* second, size_t second_size, uint8_t* out);
+
+/**
+ * \brief Make room for one more node in a level.
+ *
+ * \param tree          The tree.
+ * \param level         The level.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_level_reserve(merkle_tree* tree, merkle_tree_level* level);
+
+/**
+ * \brief The size of a right edge buffer.
+ */
+#define MERKLE_TREE_EDGE_SIZE \
+    (MERKLE_TREE_MAX_LEVELS * MERKLE_TREE_MAX_HASH_SIZE)
+
+/**
+ * \brief Compute the last node of every level which is not yet complete.
+ *
+ * Completed nodes are stored as they are formed, but the last node of a level
+ * may depend on leaves still to come.  This computes those nodes for the tree
+ * as it stands, bottom up, in one hash per level at most.
+ *
+ * \param tree          The tree.
+ * \param edge          Buffer of MERKLE_TREE_EDGE_SIZE bytes to receive the
+ *                      node for each level, at level * hash_size.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash failed.
+ */
+int merkle_tree_right_edge(const merkle_tree* tree, uint8_t* edge);
+
+/**
+ * \brief Get the number of nodes in the level above one with the given
+ * number of nodes.
+ */
+static inline size_t merkle_tree_parent_count(size_t count)
+{
+    return count / 2 + count % 2;
+}
+
+/**
+ * \brief Get a node, either completed or on the right edge.
+ */
+static inline const uint8_t* merkle_tree_node(
+    const merkle_tree* tree, const uint8_t* edge, size_t level, size_t index)
+{
+    if (index < tree->levels[level].count)
+    {
+        return tree->levels[level].nodes + index * tree->hash_size;
+    }
+
+    return edge + level * tree->hash_size;
+}
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_MERKLE_TREE_INTERNAL_HEADER_GUARD*/
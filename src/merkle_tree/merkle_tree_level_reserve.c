@@ -0,0 +1,56 @@
+/**
+ * \file src/merkle_tree/merkle_tree_level_reserve.c
+ *
+ * \brief Make room for one more node in a level.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Make room for one more node in a level.
+ *
+ * \param tree          The tree.
+ * \param level         The level.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_level_reserve(merkle_tree* tree, merkle_tree_level* level)
+{
+    MODEL_ASSERT(NULL != tree);
+    MODEL_ASSERT(NULL != level);
+
+    if (level->count < level->capacity)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    size_t capacity =
+        0 == level->capacity
+            ? MERKLE_TREE_LEVEL_INITIAL_CAPACITY : 2 * level->capacity;
+    uint8_t* nodes = (uint8_t*)
+        allocate(tree->alloc_opts, capacity * tree->hash_size);
+    if (NULL == nodes)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (NULL != level->nodes)
+    {
+        memcpy(nodes, level->nodes, level->count * tree->hash_size);
+        release(tree->alloc_opts, level->nodes);
+    }
+
+    level->nodes = nodes;
+    level->capacity = capacity;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,81 @@
+/**
+ * \file src/merkle_tree/merkle_tree_prove.c
+ *
+ * \brief Generate an inclusion proof from a Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Generate the inclusion proof for a leaf.
+ *
+ * \param tree          The tree.
+ * \param index         The index of the leaf.
+ * \param proof         Buffer to receive the proof, which needs room for
+ *                      MERKLE_TREE_MAX_LEVELS hashes at most.
+ * \param proof_size    On input, the size of the proof buffer; on output, the
+ *                      size of the proof.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed,
+ *        the index is out of range, or the proof buffer is too small.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_prove(
+    const merkle_tree* tree, size_t index, uint8_t* proof, size_t* proof_size)
+{
+    int retval;
+    uint8_t edge[MERKLE_TREE_EDGE_SIZE];
+    size_t count, level, size = 0;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != tree);
+    MODEL_ASSERT(NULL != proof);
+    MODEL_ASSERT(NULL != proof_size);
+
+    /* runtime parameter checks. */
+    if (NULL == tree || NULL == proof || NULL == proof_size || index >= tree->levels[0].count)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    retval = merkle_tree_right_edge(tree, edge);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* collect the sibling at each level, skipping promoted nodes. */
+    for (count = tree->levels[0].count, level = 0; count > 1; ++level)
+    {
+        size_t sibling = index ^ 1;
+
+        if (sibling < count)
+        {
+            if (size + tree->hash_size > *proof_size)
+            {
+                return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+            }
+
+            memcpy(
+                proof + size, merkle_tree_node(tree, edge, level, sibling),
+                tree->hash_size);
+            size += tree->hash_size;
+        }
+
+        index /= 2;
+        count = merkle_tree_parent_count(count);
+    }
+
+    *proof_size = size;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
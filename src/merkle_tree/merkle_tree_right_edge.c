@@ -0,0 +1,73 @@
+/**
+ * \file src/merkle_tree/merkle_tree_right_edge.c
+ *
+ * \brief Compute the incomplete right edge of a Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Compute the last node of every level which is not yet complete.
+ *
+ * Completed nodes are stored as they are formed, but the last node of a level
+ * may depend on leaves still to come.  This computes those nodes for the tree
+ * as it stands, bottom up, in one hash per level at most.
+ *
+ * \param tree          The tree.
+ * \param edge          Buffer of MERKLE_TREE_EDGE_SIZE bytes to receive the
+ *                      node for each level, at level * hash_size.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the hash failed.
+ */
+int merkle_tree_right_edge(const merkle_tree* tree, uint8_t* edge)
+{
+    int retval;
+    size_t child_count = tree->levels[0].count;
+
+    MODEL_ASSERT(NULL != tree);
+    MODEL_ASSERT(NULL != edge);
+
+    for (size_t k = 1; child_count > 1 && k < MERKLE_TREE_MAX_LEVELS; ++k)
+    {
+        size_t count = merkle_tree_parent_count(child_count);
+        size_t last = count - 1;
+
+        /* only the last node of a level can be incomplete. */
+        if (last >= tree->levels[k].count)
+        {
+            const uint8_t* left = merkle_tree_node(tree, edge, k - 1, 2 * last);
+            uint8_t* out = edge + k * tree->hash_size;
+
+            if (2 * last + 1 < child_count)
+            {
+                retval =
+                    merkle_tree_hash(
+                        tree->suite, MERKLE_TREE_NODE_PREFIX, left,
+                        tree->hash_size,
+                        merkle_tree_node(tree, edge, k - 1, 2 * last + 1),
+                        tree->hash_size, out);
+                if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+                {
+                    return retval;
+                }
+            }
+            else
+            {
+                /* an unpaired node is promoted unchanged. */
+                memcpy(out, left, tree->hash_size);
+            }
+        }
+
+        child_count = count;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
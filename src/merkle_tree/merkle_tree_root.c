@@ -0,0 +1,68 @@
+/**
+ * \file src/merkle_tree/merkle_tree_root.c
+ *
+ * \brief Compute the root of a Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Compute the root of the tree.
+ *
+ * The root of an empty tree is the hash of the interior node prefix alone,
+ * which no leaf or pair of nodes can produce.
+ *
+ * \param tree          The tree.
+ * \param root          Buffer of the suite's hash size to receive the root.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_root(const merkle_tree* tree, uint8_t* root)
+{
+    int retval;
+    uint8_t edge[MERKLE_TREE_EDGE_SIZE];
+    size_t count, level;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != tree);
+    MODEL_ASSERT(NULL != root);
+
+    /* runtime parameter checks. */
+    if (NULL == tree || NULL == root)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (0 == tree->levels[0].count)
+    {
+        return
+            merkle_tree_hash(
+                tree->suite, MERKLE_TREE_NODE_PREFIX, NULL, 0, NULL, 0, root);
+    }
+
+    retval = merkle_tree_right_edge(tree, edge);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the root is the only node of the first level with one node. */
+    for (count = tree->levels[0].count, level = 0; count > 1; ++level)
+    {
+        count = merkle_tree_parent_count(count);
+    }
+
+    memcpy(root, merkle_tree_node(tree, edge, level, 0), tree->hash_size);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
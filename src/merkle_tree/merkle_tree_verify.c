@@ -0,0 +1,108 @@
+/**
+ * \file src/merkle_tree/merkle_tree_verify.c
+ *
+ * \brief Verify a Merkle inclusion proof.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "merkle_tree_internal.h"
+
+/**
+ * \brief Verify an inclusion proof against a root, without the tree.
+ *
+ * \param suite         The crypto suite whose hash built the tree.
+ * \param data          The leaf data.
+ * \param size          The size of the leaf data.
+ * \param index         The index of the leaf.
+ * \param count         The number of leaves in the tree.
+ * \param proof         The proof.
+ * \param proof_size    The size of the proof.
+ * \param root          The root of the tree.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the leaf is in the tree.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID if the proof does not lead
+ *        from the leaf to the root.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int merkle_tree_verify(
+    vccrypt_suite_options_t* suite, const void* data, size_t size,
+    size_t index, size_t count, const uint8_t* proof, size_t proof_size,
+    const uint8_t* root)
+{
+    int retval;
+    uint8_t node[MERKLE_TREE_MAX_HASH_SIZE];
+    size_t hash_size, offset = 0;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != data || 0 == size);
+    MODEL_ASSERT(NULL != proof || 0 == proof_size);
+    MODEL_ASSERT(NULL != root);
+
+    /* runtime parameter checks. */
+    if (NULL == suite || (NULL == data && 0 != size) || (NULL == proof && 0 != proof_size) || NULL == root || suite->hash_opts.hash_size > MERKLE_TREE_MAX_HASH_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (index >= count)
+    {
+        return VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID;
+    }
+
+    hash_size = suite->hash_opts.hash_size;
+
+    retval =
+        merkle_tree_hash(
+            suite, MERKLE_TREE_LEAF_PREFIX, data, size, NULL, 0, node);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* combine with each sibling the tree had, in the tree's order. */
+    while (count > 1)
+    {
+        if ((index ^ 1) < count)
+        {
+            if (offset + hash_size > proof_size)
+            {
+                return VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID;
+            }
+
+            const uint8_t* sibling = proof + offset;
+            offset += hash_size;
+
+            retval =
+                (index & 1)
+                    ? merkle_tree_hash(
+                        suite, MERKLE_TREE_NODE_PREFIX, sibling, hash_size,
+                        node, hash_size, node)
+                    : merkle_tree_hash(
+                        suite, MERKLE_TREE_NODE_PREFIX, node, hash_size,
+                        sibling, hash_size, node);
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            {
+                return retval;
+            }
+        }
+
+        index /= 2;
+        count = merkle_tree_parent_count(count);
+    }
+
+    if (offset != proof_size || 0 != memcmp(node, root, hash_size))
+    {
+        return VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,102 @@
+/**
+ * \file src/server/ssock_server_connection_fill.c
+ *
+ * \brief Read the input a peer has sent so far into its connection's buffer.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "ssock_server_internal.h"
+
+/**
+ * \brief Read everything the peer has sent so far into a connection's input
+ * buffer, without blocking.
+ *
+ * Consumed input is discarded first, and the buffer grows as needed up to the
+ * given limit.  The hangup flag is set once the peer closes its end.
+ *
+ * \param conn          The connection to fill.
+ * \param max_size      The most input which may be buffered.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed, or if
+ *        the buffered input would exceed the limit.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_server_connection_fill(
+    ssock_server_connection* conn, size_t max_size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != conn);
+
+    /* discard the input which the handler has consumed. */
+    if (conn->input_offset > 0)
+    {
+        memmove(
+            conn->input, conn->input + conn->input_offset,
+            conn->input_size - conn->input_offset);
+        conn->input_size -= conn->input_offset;
+        conn->input_offset = 0;
+    }
+
+    while (!conn->hangup)
+    {
+        /* grow a full buffer, up to the request limit. */
+        if (conn->input_size == conn->input_capacity)
+        {
+            if (conn->input_capacity >= max_size)
+            {
+                return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+            }
+
+            size_t capacity = conn->input_capacity * 2;
+            if (capacity > max_size)
+            {
+                capacity = max_size;
+            }
+
+            uint8_t* input = (uint8_t*)
+                reallocate(
+                    conn->alloc_opts, conn->input, conn->input_capacity,
+                    capacity);
+            if (NULL == input)
+            {
+                return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+            }
+
+            conn->input = input;
+            conn->input_capacity = capacity;
+        }
+
+        ssize_t bytes_read =
+            recv(
+                conn->sd, conn->input + conn->input_size,
+                conn->input_capacity - conn->input_size, 0);
+        if (bytes_read > 0)
+        {
+            conn->input_size += (size_t)bytes_read;
+        }
+        else if (0 == bytes_read)
+        {
+            conn->hangup = 1;
+        }
+        else if (EAGAIN == errno || EWOULDBLOCK == errno)
+        {
+            break;
+        }
+        else if (EINTR != errno)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/**
+ * \file src/server/ssock_server_connection_flush.c
+ *
+ * \brief Send the output queued on a connection.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "ssock_server_internal.h"
+
+/**
+ * \brief Send as much of a connection's queued output as the socket takes,
+ * without blocking.
+ *
+ * \param conn          The connection to flush.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, whether or not output is
+ *        still queued.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ */
+int ssock_server_connection_flush(ssock_server_connection* conn)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != conn);
+
+    while (conn->output_offset < conn->output_size)
+    {
+        ssize_t bytes_written =
+            send(
+                conn->sd, conn->output + conn->output_offset,
+                conn->output_size - conn->output_offset, MSG_NOSIGNAL);
+        if (bytes_written >= 0)
+        {
+            conn->output_offset += (size_t)bytes_written;
+        }
+        else if (EAGAIN == errno || EWOULDBLOCK == errno)
+        {
+            break;
+        }
+        else if (EINTR != errno)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        }
+    }
+
+    /* an empty queue starts over at the front of the buffer. */
+    if (conn->output_offset == conn->output_size)
+    {
+        conn->output_offset = 0;
+        conn->output_size = 0;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
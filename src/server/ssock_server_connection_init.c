@@ -0,0 +1,255 @@
+/**
+ * \file src/server/ssock_server_connection_init.c
+ *
+ * \brief Initialize a connection around an accepted non-blocking socket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ssock_server_internal.h"
+
+/* forward decls. */
+static int ssock_server_connection_read(ssock*, void*, size_t*);
+static int ssock_server_connection_write(ssock*, const void*, size_t*);
+static int ssock_server_connection_queue(
+    ssock_server_connection*, const uint8_t*, size_t);
+static void ssock_server_connection_dispose(void*);
+
+/**
+ * \brief Initialize a connection around an accepted non-blocking socket.
+ *
+ * On success, the connection owns the socket, and disposing its \ref sock
+ * closes the socket and releases the input and output buffers.
+ *
+ * \param conn          The connection to initialize.
+ * \param sd            The accepted socket.
+ * \param alloc_opts    The allocator to use for the input and output buffers.
+ * \param max_output_size   The most unsent output which may be queued.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_server_connection_init(
+    ssock_server_connection* conn, int sd, allocator_options_t* alloc_opts,
+    size_t max_output_size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != conn);
+    MODEL_ASSERT(sd >= 0);
+    MODEL_ASSERT(NULL != alloc_opts);
+
+    memset(conn, 0, sizeof(ssock_server_connection));
+
+    conn->input = (uint8_t*)allocate(alloc_opts, SSOCK_SERVER_INPUT_INITIAL_SIZE);
+    if (NULL == conn->input)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    conn->alloc_opts = alloc_opts;
+    conn->sd = sd;
+    conn->input_capacity = SSOCK_SERVER_INPUT_INITIAL_SIZE;
+    conn->max_output_size = max_output_size;
+
+    /* the handler sees an ssock which reads from the input buffer.  Gathered
+     * writes fall back to this write method. */
+    conn->sock.hdr.dispose = &ssock_server_connection_dispose;
+    conn->sock.read = &ssock_server_connection_read;
+    conn->sock.write = &ssock_server_connection_write;
+    conn->sock.context = conn;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read from a connection's input buffer.
+ *
+ * A read is served in full or not at all, unless the peer has hung up, in
+ * which case the rest of the input is served, followed by end of stream.  A
+ * read which can't be served in full marks the connection as starved.
+ *
+ * \param sock      The connection socket.
+ * \param buf       The buffer to read into.
+ * \param size      On input, the number of bytes to read; on output, the number
+ *                  of bytes read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_server_connection_read(ssock* sock, void* buf, size_t* size)
+{
+    ssock_server_connection* conn = (ssock_server_connection*)sock->context;
+    size_t avail = conn->input_size - conn->input_offset;
+
+    if (avail < *size)
+    {
+        /* wait for the rest of this request. */
+        if (!conn->hangup)
+        {
+            conn->starved = 1;
+            *size = 0;
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+
+        *size = avail;
+    }
+
+    memcpy(buf, conn->input + conn->input_offset, *size);
+    conn->input_offset += *size;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write to a connection without blocking.
+ *
+ * What the socket takes is sent straight away, and the rest is queued for the
+ * reactor to send once the peer drains its receive buffer.  If output is
+ * already queued, everything is queued behind it, to keep the output in order.
+ *
+ * \param sock      The connection socket.
+ * \param buf       The buffer to write from.
+ * \param size      On input, the number of bytes to write; on output, the
+ *                  number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_server_connection_write(
+    ssock* sock, const void* buf, size_t* size)
+{
+    ssock_server_connection* conn = (ssock_server_connection*)sock->context;
+    const uint8_t* in = (const uint8_t*)buf;
+    size_t total = 0;
+
+    if (conn->output_offset == conn->output_size)
+    {
+        while (total < *size)
+        {
+            ssize_t bytes_written = send(conn->sd, in + total, *size - total, MSG_NOSIGNAL);
+            if (bytes_written >= 0)
+            {
+                total += (size_t)bytes_written;
+                continue;
+            }
+
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            if (EAGAIN != errno && EWOULDBLOCK != errno)
+            {
+                return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+            }
+
+            /* the socket buffer is full; queue the rest. */
+            break;
+        }
+    }
+
+    if (total < *size)
+    {
+        return ssock_server_connection_queue(conn, in + total, *size - total);
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Append output to a connection's output queue.
+ *
+ * \param conn      The connection.
+ * \param buf       The output to queue.
+ * \param size      The size of the output to queue.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if the queue would outgrow its limit.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+static int ssock_server_connection_queue(
+    ssock_server_connection* conn, const uint8_t* buf, size_t size)
+{
+    size_t queued = conn->output_size - conn->output_offset;
+
+    /* a peer which doesn't read its responses is dropped. */
+    if (size > conn->max_output_size - queued)
+    {
+        conn->overflow = 1;
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* discard the output which has been sent. */
+    if (conn->output_offset > 0)
+    {
+        memmove(conn->output, conn->output + conn->output_offset, queued);
+        conn->output_size = queued;
+        conn->output_offset = 0;
+    }
+
+    /* grow the buffer, up to the output limit. */
+    if (conn->output_size + size > conn->output_capacity)
+    {
+        size_t capacity = 0 == conn->output_capacity ? SSOCK_SERVER_INPUT_INITIAL_SIZE : conn->output_capacity;
+        while (capacity < conn->output_size + size)
+        {
+            capacity *= 2;
+        }
+
+        if (capacity > conn->max_output_size)
+        {
+            capacity = conn->max_output_size;
+        }
+
+        uint8_t* output =
+            NULL == conn->output
+                ? (uint8_t*)allocate(conn->alloc_opts, capacity)
+                : (uint8_t*)reallocate(
+                    conn->alloc_opts, conn->output, conn->output_capacity,
+                    capacity);
+        if (NULL == output)
+        {
+            return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        }
+
+        conn->output = output;
+        conn->output_capacity = capacity;
+    }
+
+    memcpy(conn->output + conn->output_size, buf, size);
+    conn->output_size += size;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a connection socket, closing it and releasing its input
+ * and output buffers.
+ *
+ * \param disposable    The connection socket to dispose.
+ */
+static void ssock_server_connection_dispose(void* disposable)
+{
+    ssock* sock = (ssock*)disposable;
+    ssock_server_connection* conn = (ssock_server_connection*)sock->context;
+
+    /* closing the socket removes it from epoll. */
+    close(conn->sd);
+    release(conn->alloc_opts, conn->input);
+    if (NULL != conn->output)
+    {
+        release(conn->alloc_opts, conn->output);
+    }
+}
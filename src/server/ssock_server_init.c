@@ -0,0 +1,307 @@
+/**
+ * \file src/server/ssock_server_init.c
+ *
+ * \brief Initialize a multi-threaded ssock server.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <arpa/inet.h>
+#include <cbmc/model_assert.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ssock_server_internal.h"
+
+/* forward decls. */
+static int ssock_server_listen(
+    const ssock_server_options* options, uint16_t port, uint8_t reuseport,
+    int* fd);
+static int ssock_server_reactor_init(
+    ssock_server* server, ssock_server_reactor* reactor, size_t index);
+static void ssock_server_dispose(void* disposable);
+
+/**
+ * \brief Initialize a server, creating and binding its listen sockets.
+ *
+ * No connections are accepted until \ref ssock_server_start() is called.  The
+ * bound port, which may be ephemeral, is available in the port field.  This
+ * instance is disposable and must be disposed by calling \ref dispose() when
+ * no longer needed.  Disposing a running server stops it first.
+ *
+ * \param server            The server instance to initialize.
+ * \param alloc_opts        The allocator to use for reactors and connections.
+ * \param options           The server options.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN if a listen socket could not
+ *        be created, bound, or put into the listening state.
+ */
+int ssock_server_init(
+    ssock_server* server, allocator_options_t* alloc_opts,
+    const ssock_server_options* options)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != server);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != options);
+
+    /* runtime parameter checks. */
+    if (NULL == server || NULL == alloc_opts || NULL == options || NULL == options->handler)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (SSOCK_SERVER_MODE_REUSEPORT != options->mode && SSOCK_SERVER_MODE_SHARED_ACCEPT != options->mode)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(server, 0, sizeof(ssock_server));
+    server->hdr.dispose = &ssock_server_dispose;
+    server->alloc_opts = alloc_opts;
+    server->options = *options;
+    server->shared_listen_fd = -1;
+
+    /* default to one reactor per online core. */
+    server->reactor_count = options->reactors;
+    if (0 == server->reactor_count)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        server->reactor_count = cores > 0 ? (size_t)cores : 1U;
+    }
+
+    /* the stop event wakes every reactor. */
+    server->stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (server->stop_fd < 0)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+    }
+
+    server->reactors = (ssock_server_reactor*)
+        allocate(alloc_opts, server->reactor_count * sizeof(ssock_server_reactor));
+    if (NULL == server->reactors)
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto close_stop_fd;
+    }
+
+    memset(server->reactors, 0, server->reactor_count * sizeof(ssock_server_reactor));
+    for (size_t i = 0; i < server->reactor_count; ++i)
+    {
+        server->reactors[i].epoll_fd = -1;
+        server->reactors[i].listen_fd = -1;
+    }
+
+    /* in shared accept mode, every reactor waits on one listen socket. */
+    if (SSOCK_SERVER_MODE_SHARED_ACCEPT == options->mode)
+    {
+        retval =
+            ssock_server_listen(
+                options, options->port, 0, &server->shared_listen_fd);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto cleanup;
+        }
+    }
+
+    for (size_t i = 0; i < server->reactor_count; ++i)
+    {
+        retval = ssock_server_reactor_init(server, &server->reactors[i], i);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            goto cleanup;
+        }
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+cleanup:
+    ssock_server_dispose(server);
+    return retval;
+
+close_stop_fd:
+    close(server->stop_fd);
+    return retval;
+}
+
+/**
+ * \brief Create a listen socket, bind it, and start listening.
+ *
+ * \param options       The server options.
+ * \param port          The port to bind.
+ * \param reuseport     If non-zero, allow other sockets to share this port.
+ * \param fd            Pointer to receive the listen socket.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_server_listen(
+    const ssock_server_options* options, uint16_t port, uint8_t reuseport,
+    int* fd)
+{
+    struct sockaddr_in addr;
+    int one = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (NULL != options->bind_address && 1 != inet_pton(AF_INET, options->bind_address, &addr.sin_addr))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    *fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (*fd < 0)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+    }
+
+    if (0 != setsockopt(*fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) || (reuseport && 0 != setsockopt(*fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one))))
+    {
+        goto fail;
+    }
+
+    if (0 != bind(*fd, (struct sockaddr*)&addr, sizeof(addr)) || 0 != listen(*fd, options->backlog > 0 ? options->backlog : SOMAXCONN))
+    {
+        goto fail;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+fail:
+    close(*fd);
+    *fd = -1;
+    return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+}
+
+/**
+ * \brief Initialize a reactor, creating its epoll instance and, in reuseport
+ * mode, its own listen socket.
+ *
+ * \param server        The server which owns this reactor.
+ * \param reactor       The reactor to initialize.
+ * \param index         The index of this reactor.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_server_reactor_init(
+    ssock_server* server, ssock_server_reactor* reactor, size_t index)
+{
+    int retval;
+    struct epoll_event ev;
+    struct sockaddr_in addr;
+    socklen_t addr_size = sizeof(addr);
+
+    reactor->server = server;
+    reactor->index = index;
+
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor->epoll_fd < 0)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+    }
+
+    /* each reactor shards the same port; the first binds it. */
+    if (SSOCK_SERVER_MODE_REUSEPORT == server->options.mode)
+    {
+        retval =
+            ssock_server_listen(
+                &server->options, 0 == index ? server->options.port : server->port, 1,
+                &reactor->listen_fd);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    }
+
+    /* learn the bound port, which may be ephemeral. */
+    int listen_fd = SSOCK_SERVER_MODE_REUSEPORT == server->options.mode ? reactor->listen_fd : server->shared_listen_fd;
+    if (0 == index)
+    {
+        if (0 != getsockname(listen_fd, (struct sockaddr*)&addr, &addr_size))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+        }
+
+        server->port = ntohs(addr.sin_port);
+    }
+
+    /* a shared listen socket wakes only one reactor per connection. */
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    if (SSOCK_SERVER_MODE_SHARED_ACCEPT == server->options.mode)
+    {
+        ev.events |= EPOLLEXCLUSIVE;
+    }
+    ev.data.ptr = reactor;
+    if (0 != epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+    }
+
+    /* the stop event stays readable once signaled, waking every reactor. */
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (0 != epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, server->stop_fd, &ev))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_LISTEN;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a server, stopping it if it is running.
+ *
+ * \param disposable    The server to dispose.
+ */
+static void ssock_server_dispose(void* disposable)
+{
+    ssock_server* server = (ssock_server*)disposable;
+
+    if (server->running)
+    {
+        ssock_server_stop(server);
+    }
+
+    for (size_t i = 0; i < server->reactor_count; ++i)
+    {
+        ssock_server_reactor* reactor = &server->reactors[i];
+
+        ssock_server_reactor_close_all(reactor);
+
+        if (reactor->listen_fd >= 0)
+        {
+            close(reactor->listen_fd);
+        }
+
+        if (reactor->epoll_fd >= 0)
+        {
+            close(reactor->epoll_fd);
+        }
+    }
+
+    if (server->shared_listen_fd >= 0)
+    {
+        close(server->shared_listen_fd);
+    }
+
+    close(server->stop_fd);
+    release(server->alloc_opts, server->reactors);
+}
@@ -0,0 +1,191 @@
+/**
+ * \file src/server/ssock_server_internal.h
+ *
+ * \brief Internal types and functions for the ssock server.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_SERVER_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_SERVER_INTERNAL_HEADER_GUARD
+
+#include <pthread.h>
+#include <time.h>
+#include <vcblockchain/ssock_server.h>
+#include <vcblockchain/timer_wheel.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The maximum number of events handled per epoll_wait call.
+ */
+#define SSOCK_SERVER_MAX_EVENTS 64
+
+/**
+ * \brief The resolution of each reactor's timer wheel, in milliseconds.
+ */
+#define SSOCK_SERVER_TIMER_TICK_MS 10
+
+/**
+ * \brief The initial size of a connection's input buffer.
+ */
+#define SSOCK_SERVER_INPUT_INITIAL_SIZE 4096
+
+/**
+ * \brief The default for the max_request_size option: 1 MB.
+ */
+#define SSOCK_SERVER_DEFAULT_MAX_REQUEST_SIZE (1024 * 1024)
+
+/**
+ * \brief The default for the max_output_size option: 1 MB.
+ */
+#define SSOCK_SERVER_DEFAULT_MAX_OUTPUT_SIZE (1024 * 1024)
+
+/**
+ * \brief A connection owned by a reactor.
+ *
+ * The socket is non-blocking.  The reactor buffers input as it arrives, and
+ * the handler reads from that buffer through \ref sock.  A read which asks for
+ * more than is buffered marks the connection as starved, and the reactor
+ * rewinds the buffer to the start of the request and calls the handler again
+ * once more input arrives.
+ *
+ * Writes send what the socket takes straight away, and queue the rest in the
+ * output buffer.  While output is queued, later writes are queued behind it,
+ * and the reactor waits for the socket to become writable to send it.  A write
+ * which would queue more than the output limit fails, and marks the
+ * connection as overflowed.
+ */
+typedef struct ssock_server_connection ssock_server_connection;
+
+struct ssock_server_connection
+{
+    ssock sock;
+    ssock_server_connection* prev;
+    ssock_server_connection* next;
+    timer_wheel_timer idle;
+    allocator_options_t* alloc_opts;
+    int sd;
+    uint8_t* input;
+    size_t input_capacity;
+    size_t input_size;
+    size_t input_offset;
+    uint8_t* output;
+    size_t output_capacity;
+    size_t output_size;
+    size_t output_offset;
+    size_t max_output_size;
+    uint32_t events;
+    uint8_t starved;
+    uint8_t hangup;
+    uint8_t overflow;
+};
+
+/**
+ * \brief A reactor, which owns one thread, one epoll instance, and every
+ * connection it accepts.
+ */
+struct ssock_server_reactor
+{
+    ssock_server* server;
+    size_t index;
+    int epoll_fd;
+    int listen_fd;
+    pthread_t thread;
+    uint8_t started;
+    ssock_server_connection* connections;
+    timer_wheel timers;
+};
+
+/**
+ * \brief Read the monotonic clock, for reactor timers.
+ *
+ * \returns the monotonic clock in milliseconds.
+ */
+static inline uint64_t ssock_server_clock_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+/**
+ * \brief Initialize a connection around an accepted non-blocking socket.
+ *
+ * On success, the connection owns the socket, and disposing its \ref sock
+ * closes the socket and releases the input and output buffers.
+ *
+ * \param conn          The connection to initialize.
+ * \param sd            The accepted socket.
+ * \param alloc_opts    The allocator to use for the input and output buffers.
+ * \param max_output_size   The most unsent output which may be queued.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_server_connection_init(
+    ssock_server_connection* conn, int sd, allocator_options_t* alloc_opts,
+    size_t max_output_size);
+
+/**
+ * \brief Read everything the peer has sent so far into a connection's input
+ * buffer, without blocking.
+ *
+ * Consumed input is discarded first, and the buffer grows as needed up to the
+ * given limit.  The hangup flag is set once the peer closes its end.
+ *
+ * \param conn          The connection to fill.
+ * \param max_size      The most input which may be buffered.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed, or if
+ *        the buffered input would exceed the limit.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_server_connection_fill(
+    ssock_server_connection* conn, size_t max_size);
+
+/**
+ * \brief Send as much of a connection's queued output as the socket takes,
+ * without blocking.
+ *
+ * \param conn          The connection to flush.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success, whether or not output is
+ *        still queued.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ */
+int ssock_server_connection_flush(ssock_server_connection* conn);
+
+/**
+ * \brief Run a reactor's event loop until the server is stopped.
+ *
+ * \param arg           The \ref ssock_server_reactor to run.
+ *
+ * \returns NULL.
+ */
+void* ssock_server_reactor_run(void* arg);
+
+/**
+ * \brief Close and release every connection owned by a reactor.
+ *
+ * \param reactor       The reactor whose connections are closed.
+ */
+void ssock_server_reactor_close_all(ssock_server_reactor* reactor);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_SERVER_INTERNAL_HEADER_GUARD*/
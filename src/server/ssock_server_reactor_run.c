@@ -0,0 +1,436 @@
+/**
+ * \file src/server/ssock_server_reactor_run.c
+ *
+ * \brief Run a server reactor's event loop.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <stddef.h>
+#include <netinet/tcp.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ssock_server_internal.h"
+
+/* forward decls. */
+static void ssock_server_reactor_accept(ssock_server_reactor* reactor);
+static void ssock_server_reactor_readable(
+    ssock_server_reactor* reactor, ssock_server_connection* conn);
+static bool ssock_server_reactor_writable(
+    ssock_server_reactor* reactor, ssock_server_connection* conn);
+static bool ssock_server_reactor_update(
+    ssock_server_reactor* reactor, ssock_server_connection* conn);
+static void ssock_server_reactor_close(
+    ssock_server_reactor* reactor, ssock_server_connection* conn);
+static int ssock_server_reactor_poll_timeout(ssock_server_reactor* reactor);
+static void ssock_server_reactor_touch(
+    ssock_server_reactor* reactor, ssock_server_connection* conn);
+static void ssock_server_reactor_idle_expired(
+    timer_wheel* wheel, timer_wheel_timer* timer, void* context);
+
+/**
+ * \brief Run a reactor's event loop until the server is stopped.
+ *
+ * The reactor accepts connections from its listen socket, buffers the input of
+ * each readable connection without blocking, and calls the handler for each
+ * complete request buffered.  Connections never move between reactors.  If
+ * an idle timeout is set, each connection's idle timer lives on the reactor's
+ * timer wheel, and is reset by every request.  On exit, every connection is
+ * closed.
+ *
+ * \param arg           The \ref ssock_server_reactor to run.
+ *
+ * \returns NULL.
+ */
+void* ssock_server_reactor_run(void* arg)
+{
+    ssock_server_reactor* reactor = (ssock_server_reactor*)arg;
+    struct epoll_event events[SSOCK_SERVER_MAX_EVENTS];
+
+    /* the wheel belongs to this thread. */
+    timer_wheel_init(
+        &reactor->timers, SSOCK_SERVER_TIMER_TICK_MS, ssock_server_clock_ms());
+
+    for (;;)
+    {
+        int count =
+            epoll_wait(
+                reactor->epoll_fd, events, SSOCK_SERVER_MAX_EVENTS,
+                ssock_server_reactor_poll_timeout(reactor));
+        if (count < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            void* tag = events[i].data.ptr;
+            uint32_t mask = events[i].events;
+
+            /* the stop event. */
+            if (NULL == tag)
+            {
+                goto done;
+            }
+
+            /* the listen socket. */
+            if (tag == reactor)
+            {
+                ssock_server_reactor_accept(reactor);
+                continue;
+            }
+
+            /* a connection; send its queued output, then handle the
+             * requests it has sent. */
+            ssock_server_connection* conn = (ssock_server_connection*)tag;
+            if ((mask & EPOLLOUT) && !ssock_server_reactor_writable(reactor, conn))
+            {
+                continue;
+            }
+
+            if (mask & (EPOLLIN | EPOLLRDHUP))
+            {
+                ssock_server_reactor_readable(reactor, conn);
+            }
+            else if (mask & (EPOLLERR | EPOLLHUP))
+            {
+                ssock_server_reactor_close(reactor, conn);
+            }
+        }
+
+        /* expire idle connections once no event refers to them. */
+        timer_wheel_advance(&reactor->timers, ssock_server_clock_ms(), NULL);
+    }
+
+done:
+    ssock_server_reactor_close_all(reactor);
+    dispose((disposable_t*)&reactor->timers);
+
+    return NULL;
+}
+
+/**
+ * \brief Close and release every connection owned by a reactor.
+ *
+ * \param reactor       The reactor whose connections are closed.
+ */
+void ssock_server_reactor_close_all(ssock_server_reactor* reactor)
+{
+    while (NULL != reactor->connections)
+    {
+        ssock_server_reactor_close(reactor, reactor->connections);
+    }
+}
+
+/**
+ * \brief Accept every pending connection on the reactor's listen socket.
+ *
+ * \param reactor       The reactor accepting connections.
+ */
+static void ssock_server_reactor_accept(ssock_server_reactor* reactor)
+{
+    ssock_server* server = reactor->server;
+    size_t max_output_size = 0 == server->options.max_output_size ? SSOCK_SERVER_DEFAULT_MAX_OUTPUT_SIZE : server->options.max_output_size;
+    int listen_fd = reactor->listen_fd >= 0 ? reactor->listen_fd : server->shared_listen_fd;
+    struct epoll_event ev;
+    int one = 1;
+
+    for (;;)
+    {
+        /* accepted sockets never block the reactor. */
+        int sd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (sd < 0)
+        {
+            /* stop on EAGAIN, or if another reactor won the race. */
+            if (EINTR == errno || ECONNABORTED == errno)
+            {
+                continue;
+            }
+
+            return;
+        }
+
+        setsockopt(sd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        ssock_server_connection* conn = (ssock_server_connection*)
+            allocate(server->alloc_opts, sizeof(ssock_server_connection));
+        if (NULL == conn)
+        {
+            close(sd);
+            continue;
+        }
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_server_connection_init(conn, sd, server->alloc_opts, max_output_size))
+        {
+            close(sd);
+            release(server->alloc_opts, conn);
+            continue;
+        }
+
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = conn;
+        conn->events = ev.events;
+        if (0 != epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, sd, &ev))
+        {
+            dispose((disposable_t*)&conn->sock);
+            release(server->alloc_opts, conn);
+            continue;
+        }
+
+        timer_wheel_timer_init(
+            &conn->idle, &ssock_server_reactor_idle_expired, reactor);
+        ssock_server_reactor_touch(reactor, conn);
+
+        /* link this connection into the reactor's list. */
+        conn->prev = NULL;
+        conn->next = reactor->connections;
+        if (NULL != conn->next)
+        {
+            conn->next->prev = conn;
+        }
+        reactor->connections = conn;
+    }
+}
+
+/**
+ * \brief Buffer the input of a readable connection, and call the handler for
+ * each complete request.
+ *
+ * The handler is called at the start of each request.  If it reads past the
+ * buffered input, the input is rewound to the start of the request, and the
+ * handler is called again once more input arrives.  The connection is closed
+ * if the handler fails, if a request outgrows the max_request_size option, or
+ * once the peer hangs up and its queued output has been sent.
+ *
+ * \param reactor       The reactor which owns the connection.
+ * \param conn          The readable connection.
+ */
+static void ssock_server_reactor_readable(
+    ssock_server_reactor* reactor, ssock_server_connection* conn)
+{
+    ssock_server_options* options = &reactor->server->options;
+    size_t max_size = 0 == options->max_request_size ? SSOCK_SERVER_DEFAULT_MAX_REQUEST_SIZE : options->max_request_size;
+
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_server_connection_fill(conn, max_size))
+    {
+        ssock_server_reactor_close(reactor, conn);
+        return;
+    }
+
+    while (conn->input_offset < conn->input_size)
+    {
+        size_t start = conn->input_offset;
+
+        conn->starved = 0;
+        int retval = options->handler(&conn->sock, reactor->index, options->context);
+
+        /* wait for the rest of this request. */
+        if (conn->starved)
+        {
+            conn->input_offset = start;
+            break;
+        }
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            ssock_server_reactor_close(reactor, conn);
+            return;
+        }
+
+        ssock_server_reactor_touch(reactor, conn);
+
+        /* a handler which reads nothing would be called forever. */
+        if (conn->input_offset == start)
+        {
+            break;
+        }
+    }
+
+    ssock_server_reactor_update(reactor, conn);
+}
+
+/**
+ * \brief Send the queued output of a writable connection.
+ *
+ * \param reactor       The reactor which owns the connection.
+ * \param conn          The writable connection.
+ *
+ * \returns true if the connection is still open, or false if it was closed.
+ */
+static bool ssock_server_reactor_writable(
+    ssock_server_reactor* reactor, ssock_server_connection* conn)
+{
+    size_t queued = conn->output_size - conn->output_offset;
+
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_server_connection_flush(conn))
+    {
+        ssock_server_reactor_close(reactor, conn);
+        return false;
+    }
+
+    /* a peer which is reading its output is not idle. */
+    if (conn->output_size - conn->output_offset < queued)
+    {
+        ssock_server_reactor_touch(reactor, conn);
+    }
+
+    return ssock_server_reactor_update(reactor, conn);
+}
+
+/**
+ * \brief Match a connection's epoll interest to its state.
+ *
+ * The reactor waits for input until the peer hangs up, and waits for the
+ * socket to become writable while output is queued.  The connection is closed
+ * if its output overflowed, or if the peer has hung up and nothing is left to
+ * send.
+ *
+ * \param reactor       The reactor which owns the connection.
+ * \param conn          The connection.
+ *
+ * \returns true if the connection is still open, or false if it was closed.
+ */
+static bool ssock_server_reactor_update(
+    ssock_server_reactor* reactor, ssock_server_connection* conn)
+{
+    bool queued = conn->output_offset < conn->output_size;
+    struct epoll_event ev;
+
+    /* a peer which hangs up can't complete a request. */
+    if (conn->overflow || (conn->hangup && !queued))
+    {
+        ssock_server_reactor_close(reactor, conn);
+        return false;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = (conn->hangup ? 0 : EPOLLIN | EPOLLRDHUP) | (queued ? EPOLLOUT : 0);
+    ev.data.ptr = conn;
+    if (ev.events == conn->events)
+    {
+        return true;
+    }
+
+    if (0 != epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, conn->sd, &ev))
+    {
+        ssock_server_reactor_close(reactor, conn);
+        return false;
+    }
+
+    conn->events = ev.events;
+
+    return true;
+}
+
+/**
+ * \brief Close a connection and release it.
+ *
+ * \param reactor       The reactor which owns the connection.
+ * \param conn          The connection to close.
+ */
+static void ssock_server_reactor_close(
+    ssock_server_reactor* reactor, ssock_server_connection* conn)
+{
+    /* unlink this connection. */
+    if (NULL != conn->prev)
+    {
+        conn->prev->next = conn->next;
+    }
+    else
+    {
+        reactor->connections = conn->next;
+    }
+
+    if (NULL != conn->next)
+    {
+        conn->next->prev = conn->prev;
+    }
+
+    timer_wheel_cancel(&conn->idle);
+
+    /* disposing the socket closes it, which removes it from epoll. */
+    dispose((disposable_t*)&conn->sock);
+    release(reactor->server->alloc_opts, conn);
+}
+
+/**
+ * \brief Get the epoll timeout for the reactor's next timer.
+ *
+ * \param reactor       The reactor.
+ *
+ * \returns the timeout in milliseconds, or -1 to wait indefinitely.
+ */
+static int ssock_server_reactor_poll_timeout(ssock_server_reactor* reactor)
+{
+    uint64_t timeout_ms;
+
+    timer_wheel_next_timeout(
+        &reactor->timers, ssock_server_clock_ms(), &timeout_ms);
+    if (TIMER_WHEEL_NO_TIMEOUT == timeout_ms)
+    {
+        return -1;
+    }
+
+    return timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+}
+
+/**
+ * \brief Reset a connection's idle timer.
+ *
+ * The wheel only moves when it is advanced, so the time since its last advance
+ * is added to the delay.
+ *
+ * \param reactor       The reactor which owns the connection.
+ * \param conn          The connection.
+ */
+static void ssock_server_reactor_touch(
+    ssock_server_reactor* reactor, ssock_server_connection* conn)
+{
+    uint32_t idle_timeout_ms = reactor->server->options.idle_timeout_ms;
+    timer_wheel* wheel = &reactor->timers;
+
+    if (0 == idle_timeout_ms)
+    {
+        return;
+    }
+
+    uint64_t wheel_ms = wheel->start_ms + wheel->current * wheel->tick_ms;
+    uint64_t now_ms = ssock_server_clock_ms();
+    uint64_t lag_ms = now_ms > wheel_ms ? now_ms - wheel_ms : 0;
+
+    timer_wheel_schedule(wheel, &conn->idle, idle_timeout_ms + lag_ms);
+}
+
+/**
+ * \brief Close a connection whose idle timer expired.
+ *
+ * \param wheel         The reactor's timer wheel.
+ * \param timer         The connection's idle timer.
+ * \param context       The reactor.
+ */
+static void ssock_server_reactor_idle_expired(
+    timer_wheel* wheel, timer_wheel_timer* timer, void* context)
+{
+    ssock_server_reactor* reactor = (ssock_server_reactor*)context;
+    ssock_server_connection* conn = (ssock_server_connection*)
+        ((uint8_t*)timer - offsetof(ssock_server_connection, idle));
+
+    (void)wheel;
+
+    ssock_server_reactor_close(reactor, conn);
+}
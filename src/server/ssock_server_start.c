@@ -0,0 +1,100 @@
+/**
+ * \file src/server/ssock_server_start.c
+ *
+ * \brief Start a server's reactor threads.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include <cbmc/model_assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "ssock_server_internal.h"
+
+/**
+ * \brief Start one reactor thread per reactor.
+ *
+ * If the pin_threads option is set, reactor N is pinned to online core N,
+ * wrapping around if there are more reactors than cores.
+ *
+ * \param server            The server to start.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        if the server is already running.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SERVER_THREAD if a reactor thread could not
+ *        be started or pinned to its core.
+ */
+int ssock_server_start(ssock_server* server)
+{
+    pthread_attr_t attr;
+    uint64_t drain;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != server);
+
+    /* runtime parameter checks. */
+    if (NULL == server || server->running)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* clear the stop event left over from a previous run. */
+    while (read(server->stop_fd, &drain, sizeof(drain)) > 0)
+        ;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores < 1)
+    {
+        cores = 1;
+    }
+
+    for (size_t i = 0; i < server->reactor_count; ++i)
+    {
+        ssock_server_reactor* reactor = &server->reactors[i];
+
+        if (0 != pthread_attr_init(&attr))
+        {
+            goto fail;
+        }
+
+        /* pin this reactor to its core. */
+        if (server->options.pin_threads)
+        {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(i % (size_t)cores, &cpus);
+            if (0 != pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus))
+            {
+                pthread_attr_destroy(&attr);
+                goto fail;
+            }
+        }
+
+        int result = pthread_create(&reactor->thread, &attr, &ssock_server_reactor_run, reactor);
+        pthread_attr_destroy(&attr);
+        if (0 != result)
+        {
+            goto fail;
+        }
+
+        reactor->started = 1;
+    }
+
+    server->running = 1;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+fail:
+    /* stop the reactors which did start. */
+    server->running = 1;
+    ssock_server_stop(server);
+    return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_THREAD;
+}
@@ -0,0 +1,63 @@
+/**
+ * \file src/server/ssock_server_stop.c
+ *
+ * \brief Stop a server's reactor threads.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "ssock_server_internal.h"
+
+/**
+ * \brief Stop the server, waiting for each reactor thread to exit.
+ *
+ * Each reactor closes its open connections as it exits.  The listen sockets
+ * stay bound until the server is disposed.
+ *
+ * \param server            The server to stop.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed, or
+ *        if the server is not running.
+ */
+int ssock_server_stop(ssock_server* server)
+{
+    uint64_t one = 1;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != server);
+
+    /* runtime parameter checks. */
+    if (NULL == server || !server->running)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* signal the stop event, which wakes every reactor. */
+    if ((ssize_t)sizeof(one) != write(server->stop_fd, &one, sizeof(one)))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_SERVER_THREAD;
+    }
+
+    for (size_t i = 0; i < server->reactor_count; ++i)
+    {
+        ssock_server_reactor* reactor = &server->reactors[i];
+
+        if (reactor->started)
+        {
+            pthread_join(reactor->thread, NULL);
+            reactor->started = 0;
+        }
+    }
+
+    server->running = 0;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
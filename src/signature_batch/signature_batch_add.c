@@ -0,0 +1,69 @@
+/**
+ * \file src/signature_batch/signature_batch_add.c
+ *
+ * \brief Add a signature over a message to a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "signature_batch_internal.h"
+
+/**
+ * \brief Add a signature over a message to the batch.
+ *
+ * \param batch             The batch.
+ * \param message           The signed message.
+ * \param message_size      The size of the signed message.
+ * \param signature         The signature, of the suite's signature size.
+ * \param public_key        The public key of the signer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_add(
+    signature_batch* batch, const uint8_t* message, size_t message_size,
+    const uint8_t* signature, const vccrypt_buffer_t* public_key)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != message || 0 == message_size);
+    MODEL_ASSERT(NULL != signature);
+    MODEL_ASSERT(NULL != public_key);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || (NULL == message && 0 != message_size) || NULL == signature || NULL == public_key)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (batch->count == batch->capacity)
+    {
+        size_t capacity = 2 * batch->capacity;
+        signature_batch_entry* entries = (signature_batch_entry*)
+            allocate(batch->alloc_opts, capacity * sizeof(signature_batch_entry));
+        if (NULL == entries)
+        {
+            return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        }
+
+        memcpy(entries, batch->entries, batch->count * sizeof(signature_batch_entry));
+        release(batch->alloc_opts, batch->entries);
+        batch->entries = entries;
+        batch->capacity = capacity;
+    }
+
+    signature_batch_entry* entry = &batch->entries[batch->count++];
+    entry->message = message;
+    entry->message_size = message_size;
+    entry->signature = signature;
+    entry->public_key = public_key;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,79 @@
+/**
+ * \file src/signature_batch/signature_batch_add_certificate.c
+ *
+ * \brief Add the signature of a certificate to a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vccert/fields.h>
+
+#include "signature_batch_internal.h"
+
+/**
+ * \brief Add the signature of a certificate to the batch.
+ *
+ * The signature is the certificate's signature field, which must be its last
+ * field, and it covers every byte of the certificate before that field.
+ *
+ * \param batch             The batch.
+ * \param cert              The certificate.
+ * \param size              The size of the certificate.
+ * \param public_key        The public key of the certificate's signer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED if the certificate does
+ *        not parse, or has no signature of the suite's signature size as its
+ *        last field.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_add_certificate(
+    signature_batch* batch, const void* cert, size_t size,
+    const vccrypt_buffer_t* public_key)
+{
+    int retval;
+    vccert_parser_context_t parser;
+    const uint8_t* signature;
+    size_t signature_size;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != cert);
+    MODEL_ASSERT(NULL != public_key);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || NULL == cert || NULL == public_key)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_init(batch->parser_options, &parser, cert, size))
+    {
+        return VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED;
+    }
+
+    /* the signature must be the last field, or the fields after it would
+     * pass unsigned. */
+    if (VCCERT_STATUS_SUCCESS != vccert_parser_find_short(&parser, VCCERT_FIELD_TYPE_SIGNATURE, &signature, &signature_size) || batch->suite->sign_opts.signature_size != signature_size || signature + signature_size != (const uint8_t*)cert + size)
+    {
+        retval = VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED;
+        goto dispose_parser;
+    }
+
+    /* the signed bytes end at the signature field's type and size. */
+    const uint8_t* start = (const uint8_t*)cert;
+    size_t message_size =
+        (size_t)(signature - start) - FIELD_TYPE_SIZE - FIELD_SIZE_SIZE;
+
+    retval =
+        signature_batch_add(batch, start, message_size, signature, public_key);
+
+dispose_parser:
+    dispose((disposable_t*)&parser);
+
+    return retval;
+}
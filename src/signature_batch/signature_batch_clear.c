@@ -0,0 +1,23 @@
+/**
+ * \file src/signature_batch/signature_batch_clear.c
+ *
+ * \brief Remove every signature from a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "signature_batch_internal.h"
+
+/**
+ * \brief Remove every signature from the batch, keeping its storage.
+ *
+ * \param batch             The batch.
+ */
+void signature_batch_clear(signature_batch* batch)
+{
+    MODEL_ASSERT(NULL != batch);
+
+    batch->count = 0U;
+}
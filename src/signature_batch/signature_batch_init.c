@@ -0,0 +1,92 @@
+/**
+ * \file src/signature_batch/signature_batch_init.c
+ *
+ * \brief Initialize a signature batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "signature_batch_internal.h"
+
+/* forward decls. */
+static void signature_batch_dispose(void* disposable);
+
+/**
+ * \brief Initialize a signature batch.
+ *
+ * The suite, parser options, and pool must outlive the batch.  This instance
+ * is disposable and must be disposed by calling \ref dispose() when no longer
+ * needed.
+ *
+ * \param batch             The batch to initialize.
+ * \param alloc_opts        The allocator to use for this batch.
+ * \param suite             The crypto suite the signatures were made with.
+ * \param parser_options    The vccert parser options for reading
+ *                          certificates.
+ * \param pool              The pool to verify on, or NULL to verify on the
+ *                          calling thread.
+ * \param chunk_size        The number of signatures per task; 0 selects
+ *                          SIGNATURE_BATCH_DEFAULT_CHUNK_SIZE.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_init(
+    signature_batch* batch, allocator_options_t* alloc_opts,
+    vccrypt_suite_options_t* suite, vccert_parser_options_t* parser_options,
+    thread_pool* pool, size_t chunk_size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != suite);
+    MODEL_ASSERT(NULL != parser_options);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || NULL == alloc_opts || NULL == suite || NULL == parser_options)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(batch, 0, sizeof(signature_batch));
+    batch->entries = (signature_batch_entry*)
+        allocate(
+            alloc_opts,
+            SIGNATURE_BATCH_INITIAL_CAPACITY * sizeof(signature_batch_entry));
+    if (NULL == batch->entries)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    batch->hdr.dispose = &signature_batch_dispose;
+    batch->alloc_opts = alloc_opts;
+    batch->suite = suite;
+    batch->parser_options = parser_options;
+    batch->pool = pool;
+    batch->chunk_size =
+        chunk_size > 0 ? chunk_size : SIGNATURE_BATCH_DEFAULT_CHUNK_SIZE;
+    batch->capacity = SIGNATURE_BATCH_INITIAL_CAPACITY;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a signature batch.
+ *
+ * \param disposable    The batch to dispose.
+ */
+static void signature_batch_dispose(void* disposable)
+{
+    signature_batch* batch = (signature_batch*)disposable;
+
+    release(batch->alloc_opts, batch->entries);
+
+    memset(batch, 0, sizeof(signature_batch));
+}
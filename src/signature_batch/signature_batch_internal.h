@@ -0,0 +1,35 @@
+/**
+ * \file src/signature_batch/signature_batch_internal.h
+ *
+ * \brief Internal types and functions for signature batches.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SIGNATURE_BATCH_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SIGNATURE_BATCH_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/signature_batch.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief Verify a chunk of a batch's signatures, reporting the first which
+ * fails to the scan.
+ *
+ * \param scan          The scan, whose context is the \ref signature_batch.
+ * \param begin         The index of the first signature in the chunk.
+ * \param end           The index after the last signature in the chunk.
+ */
+void signature_batch_verify_chunk(
+    thread_pool_scan* scan, size_t begin, size_t end);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SIGNATURE_BATCH_INTERNAL_HEADER_GUARD*/
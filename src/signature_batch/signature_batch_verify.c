@@ -0,0 +1,60 @@
+/**
+ * \file src/signature_batch/signature_batch_verify.c
+ *
+ * \brief Verify every signature in a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "signature_batch_internal.h"
+
+/**
+ * \brief Verify every signature in the batch.
+ *
+ * \param batch             The batch.
+ * \param failed_index      Pointer to receive, on failure, the lowest index
+ *                          whose signature failed.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if every signature is valid.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_INVALID if a signature failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int signature_batch_verify(signature_batch* batch, size_t* failed_index)
+{
+    int retval;
+    thread_pool_scan scan;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != batch);
+    MODEL_ASSERT(NULL != failed_index);
+
+    /* runtime parameter checks. */
+    if (NULL == batch || NULL == failed_index)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    retval =
+        thread_pool_scan_start(
+            &scan, batch->pool, batch->alloc_opts, batch->count,
+            batch->chunk_size, &signature_batch_verify_chunk, batch);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* a chunk which couldn't run may hide a lower failure. */
+    retval = thread_pool_scan_finish(&scan);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval && SIZE_MAX != scan.first_failure)
+    {
+        *failed_index = scan.first_failure;
+        retval = VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_INVALID;
+    }
+
+    return retval;
+}
@@ -0,0 +1,60 @@
+/**
+ * \file src/signature_batch/signature_batch_verify_chunk.c
+ *
+ * \brief Verify the signatures in one chunk of a batch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "signature_batch_internal.h"
+
+/**
+ * \brief Verify a chunk of a batch's signatures, reporting the first which
+ * fails to the scan.
+ *
+ * \param scan          The scan, whose context is the \ref signature_batch.
+ * \param begin         The index of the first signature in the chunk.
+ * \param end           The index after the last signature in the chunk.
+ */
+void signature_batch_verify_chunk(
+    thread_pool_scan* scan, size_t begin, size_t end)
+{
+    signature_batch* batch = (signature_batch*)scan->context;
+    vccrypt_digital_signature_context_t sign;
+    vccrypt_buffer_t signature;
+
+    MODEL_ASSERT(NULL != batch);
+
+    /* one context and scratch buffer serve the whole chunk. */
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_digital_signature_init(batch->suite, &sign))
+    {
+        thread_pool_scan_cancel(scan, VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY);
+        return;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_suite_buffer_init_for_signature(batch->suite, &signature))
+    {
+        thread_pool_scan_cancel(scan, VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY);
+        goto dispose_sign;
+    }
+
+    for (size_t i = begin; i < end && !thread_pool_scan_skip(scan, i); ++i)
+    {
+        const signature_batch_entry* entry = &batch->entries[i];
+        memcpy(signature.data, entry->signature, signature.size);
+
+        if (VCCRYPT_STATUS_SUCCESS != vccrypt_digital_signature_verify(&sign, &signature, entry->public_key, entry->message, entry->message_size))
+        {
+            thread_pool_scan_fail(scan, i);
+            break;
+        }
+    }
+
+    dispose((disposable_t*)&signature);
+
+dispose_sign:
+    dispose((disposable_t*)&sign);
+}
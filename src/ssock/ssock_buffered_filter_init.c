@@ -0,0 +1,315 @@
+/**
+ * \file src/ssock/ssock_buffered_filter_init.c
+ *
+ * \brief Initialize a buffering filter ssock which wraps an inner ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Buffered filter context.
+ *
+ * The read and write buffers follow this structure in the same allocation.
+ */
+typedef struct ssock_buffered_filter_context
+{
+    allocator_options_t* alloc_opts;
+    uint8_t* read_buf;
+    size_t read_capacity;
+    size_t read_offset;
+    size_t read_size;
+    uint8_t* write_buf;
+    size_t write_capacity;
+    size_t write_size;
+} ssock_buffered_filter_context;
+
+/* forward decls. */
+static int ssock_buffered_filter_read(ssock*, void*, size_t*);
+static int ssock_buffered_filter_write(ssock*, const void*, size_t*);
+static int ssock_buffered_filter_flush(ssock*);
+static int ssock_buffered_filter_write_all(
+    ssock* inner, const uint8_t* buf, size_t size);
+static void ssock_buffered_filter_dispose(void*);
+
+/**
+ * \brief Initialize a buffering filter ssock which wraps an inner ssock.
+ *
+ * Small reads are served from a read buffer which is refilled from the inner
+ * ssock as needed, and each read is satisfied in full unless the inner ssock
+ * reaches end of stream.  Small writes are coalesced into a write buffer which
+ * is written to the inner ssock when it fills or when \ref ssock_flush() is
+ * called.  Reads or writes larger than the buffer bypass it.  A buffer size of
+ * zero disables buffering in that direction.
+ *
+ * Buffered writes that have not been flushed are discarded when this instance
+ * is disposed.  This instance takes ownership of the inner ssock.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param alloc_opts        The allocator to use for the buffers.
+ * \param read_buffer_size  The size of the read buffer.
+ * \param write_buffer_size The size of the write buffer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_buffered_filter_init(
+    ssock* sock, ssock* inner, allocator_options_t* alloc_opts,
+    size_t read_buffer_size, size_t write_buffer_size)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != inner);
+    MODEL_ASSERT(NULL != alloc_opts);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == inner || NULL == alloc_opts)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* start with a pass-through filter. */
+    retval = ssock_filter_init(sock, inner);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* allocate the filter context and both buffers at once. */
+    ssock_buffered_filter_context* ctx = (ssock_buffered_filter_context*)
+        allocate(
+            alloc_opts,
+            sizeof(ssock_buffered_filter_context) + read_buffer_size
+                + write_buffer_size);
+    if (NULL == ctx)
+    {
+        /* the caller keeps the inner socket. */
+        memset(sock, 0, sizeof(ssock));
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    memset(ctx, 0, sizeof(ssock_buffered_filter_context));
+    ctx->alloc_opts = alloc_opts;
+    ctx->read_buf = (uint8_t*)(ctx + 1);
+    ctx->read_capacity = read_buffer_size;
+    ctx->write_buf = ctx->read_buf + read_buffer_size;
+    ctx->write_capacity = write_buffer_size;
+
+    /* only buffer the directions which have a buffer. */
+    if (read_buffer_size > 0)
+    {
+        sock->read = &ssock_buffered_filter_read;
+    }
+
+    if (write_buffer_size > 0)
+    {
+        sock->write = &ssock_buffered_filter_write;
+        sock->writev = NULL;
+        sock->flush = &ssock_buffered_filter_flush;
+    }
+
+    sock->hdr.dispose = &ssock_buffered_filter_dispose;
+    sock->context = ctx;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read from the read buffer, refilling it from the inner socket.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to read into.
+ * \param size      On input, the number of bytes to read; on output, the number
+ *                  of bytes read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_buffered_filter_read(ssock* sock, void* buf, size_t* size)
+{
+    ssock_buffered_filter_context* ctx =
+        (ssock_buffered_filter_context*)sock->context;
+    uint8_t* out = (uint8_t*)buf;
+    size_t total = 0;
+
+    while (total < *size)
+    {
+        size_t remaining = *size - total;
+        size_t avail = ctx->read_size - ctx->read_offset;
+
+        /* serve as much as possible from the buffer. */
+        if (avail > 0)
+        {
+            size_t n = avail < remaining ? avail : remaining;
+            memcpy(out + total, ctx->read_buf + ctx->read_offset, n);
+            ctx->read_offset += n;
+            total += n;
+            continue;
+        }
+
+        /* large reads bypass the buffer. */
+        uint8_t* dest = out + total;
+        size_t read_size = remaining;
+        if (remaining < ctx->read_capacity)
+        {
+            dest = ctx->read_buf;
+            read_size = ctx->read_capacity;
+        }
+
+        int retval = sock->inner->read(sock->inner, dest, &read_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        /* stop at the end of the stream. */
+        if (0 == read_size)
+        {
+            break;
+        }
+
+        if (dest == ctx->read_buf)
+        {
+            ctx->read_offset = 0;
+            ctx->read_size = read_size;
+        }
+        else
+        {
+            total += read_size;
+        }
+    }
+
+    *size = total;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write to the write buffer, flushing it to the inner socket as needed.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to write from.
+ * \param size      On input, the number of bytes to write; on output, the
+ *                  number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_buffered_filter_write(ssock* sock, const void* buf, size_t* size)
+{
+    int retval;
+    ssock_buffered_filter_context* ctx =
+        (ssock_buffered_filter_context*)sock->context;
+
+    /* if this write does not fit, write out the buffer first. */
+    if (*size > ctx->write_capacity - ctx->write_size)
+    {
+        retval =
+            ssock_buffered_filter_write_all(
+                sock->inner, ctx->write_buf, ctx->write_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        ctx->write_size = 0;
+    }
+
+    /* large writes bypass the buffer. */
+    if (*size >= ctx->write_capacity)
+    {
+        return
+            ssock_buffered_filter_write_all(
+                sock->inner, (const uint8_t*)buf, *size);
+    }
+
+    /* coalesce this write into the buffer. */
+    memcpy(ctx->write_buf + ctx->write_size, buf, *size);
+    ctx->write_size += *size;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write out the write buffer, and then flush the inner socket.
+ *
+ * \param sock      The filter socket.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_buffered_filter_flush(ssock* sock)
+{
+    ssock_buffered_filter_context* ctx =
+        (ssock_buffered_filter_context*)sock->context;
+
+    int retval =
+        ssock_buffered_filter_write_all(
+            sock->inner, ctx->write_buf, ctx->write_size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    ctx->write_size = 0;
+
+    return ssock_flush(sock->inner);
+}
+
+/**
+ * \brief Write the whole buffer to the inner socket, tolerating short writes.
+ *
+ * \param inner     The socket to write to.
+ * \param buf       The buffer to write from.
+ * \param size      The number of bytes to write.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_buffered_filter_write_all(
+    ssock* inner, const uint8_t* buf, size_t size)
+{
+    while (size > 0)
+    {
+        size_t write_size = size;
+        int retval = inner->write(inner, buf, &write_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        if (0 == write_size || write_size > size)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        }
+
+        buf += write_size;
+        size -= write_size;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a buffered filter socket, along with the inner socket.
+ *
+ * \param disposable    The filter socket to dispose.
+ */
+static void ssock_buffered_filter_dispose(void* disposable)
+{
+    ssock* sock = (ssock*)disposable;
+    ssock_buffered_filter_context* ctx =
+        (ssock_buffered_filter_context*)sock->context;
+
+    /* release the filter context and buffers. */
+    release(ctx->alloc_opts, ctx);
+
+    /* dispose the inner socket. */
+    dispose((disposable_t*)sock->inner);
+}
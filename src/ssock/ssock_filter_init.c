@@ -0,0 +1,158 @@
+/**
+ * \file src/ssock/ssock_filter_init.c
+ *
+ * \brief Initialize a pass-through filter ssock which wraps an inner ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/ssock.h>
+
+/* forward decls. */
+static int ssock_filter_read(ssock*, void*, size_t*);
+static int ssock_filter_write(ssock*, const void*, size_t*);
+static int ssock_filter_writev(ssock*, const ssock_iovec*, size_t, size_t*);
+static int ssock_filter_flush(ssock*);
+static int ssock_filter_shutdown(ssock*);
+static void ssock_filter_dispose(void*);
+
+/**
+ * \brief Initialize a pass-through filter ssock which wraps an inner ssock.
+ *
+ * The read, write, writev, flush, and shutdown methods of this instance
+ * forward to the inner ssock.  A filter implementation initializes its ssock
+ * with this function and then replaces the methods it needs to transform or
+ * observe, leaving the rest as pass-throughs.  A filter which replaces write should
+ * also replace writev or set it to NULL, so that gathered writes are routed
+ * through its write method.  The read policy, compression settings, and
+ * statistics of the inner ssock are copied to this instance.
+ *
+ * This instance takes ownership of the inner ssock.  When this instance is
+ * disposed, the inner ssock is disposed as well, so that a whole filter chain
+ * is torn down by disposing its outermost ssock.  A filter which fails after
+ * this call clears this instance again before returning, so that the caller
+ * keeps ownership of the inner ssock and has nothing to dispose.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int ssock_filter_init(ssock* sock, ssock* inner)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != inner);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == inner || sock == inner)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* configure ssock instance. */
+    memset(sock, 0, sizeof(ssock));
+    sock->hdr.dispose = &ssock_filter_dispose;
+    sock->read = &ssock_filter_read;
+    sock->write = &ssock_filter_write;
+    sock->writev = &ssock_filter_writev;
+    sock->flush = &ssock_filter_flush;
+    sock->shutdown = &ssock_filter_shutdown;
+    sock->inner = inner;
+    memcpy(&sock->read_policy, &inner->read_policy, sizeof(ssock_read_policy));
+    memcpy(&sock->compression, &inner->compression, sizeof(ssock_compression));
+    sock->stats = inner->stats;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Pass a read through to the inner socket.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to read into.
+ * \param size      On input, the number of bytes to read; on output, the number
+ *                  of bytes read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_filter_read(ssock* sock, void* buf, size_t* size)
+{
+    return sock->inner->read(sock->inner, buf, size);
+}
+
+/**
+ * \brief Pass a write through to the inner socket.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to write from.
+ * \param size      On input, the number of bytes to write; on output, the
+ *                  number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_filter_write(ssock* sock, const void* buf, size_t* size)
+{
+    return sock->inner->write(sock->inner, buf, size);
+}
+
+/**
+ * \brief Pass a gathered write through to the inner socket.
+ *
+ * \param sock      The filter socket.
+ * \param iov       The buffers to write.
+ * \param iovcnt    The number of buffers.
+ * \param size      On output, the number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_filter_writev(
+    ssock* sock, const ssock_iovec* iov, size_t iovcnt, size_t* size)
+{
+    return ssock_writev(sock->inner, iov, iovcnt, size);
+}
+
+/**
+ * \brief Pass a flush through to the inner socket.
+ *
+ * \param sock      The filter socket.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_filter_flush(ssock* sock)
+{
+    return ssock_flush(sock->inner);
+}
+
+/**
+ * \brief Pass a shutdown through to the inner socket.
+ *
+ * \param sock      The filter socket.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_filter_shutdown(ssock* sock)
+{
+    return ssock_shutdown(sock->inner);
+}
+
+/**
+ * \brief Dispose of a filter socket, along with the inner socket.
+ *
+ * \param disposable    The filter socket to dispose.
+ */
+static void ssock_filter_dispose(void* disposable)
+{
+    ssock* sock = (ssock*)disposable;
+
+    /* parameter sanity check. */
+    MODEL_ASSERT(NULL != sock);
+
+    /* dispose the inner socket. */
+    dispose((disposable_t*)sock->inner);
+}
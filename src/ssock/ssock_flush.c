@@ -0,0 +1,38 @@
+/**
+ * \file src/ssock/ssock_flush.c
+ *
+ * \brief Flush any data buffered by a ssock instance.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Flush any data buffered by a ssock instance.
+ *
+ * For a filter chain, the flush is passed down to each layer in turn.  An
+ * ssock instance without buffering treats this as a no-op.
+ *
+ * \param sock      The ssock instance to flush.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - a non-zero error code on failure.
+ */
+int ssock_flush(ssock* sock)
+{
+    MODEL_ASSERT(NULL != sock);
+
+    /* runtime sanity check on parameters. */
+    if (NULL == sock)
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+
+    /* an unbuffered socket has nothing to flush. */
+    if (NULL == sock->flush)
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+    return sock->flush(sock);
+}
@@ -0,0 +1,187 @@
+/**
+ * \file src/ssock/ssock_hash_filter_init.c
+ *
+ * \brief Initialize a hashing filter ssock which wraps an inner ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Hash filter context.
+ */
+typedef struct ssock_hash_filter_context
+{
+    allocator_options_t* alloc_opts;
+    vccrypt_hash_context_t* read_hash;
+    vccrypt_hash_context_t* write_hash;
+} ssock_hash_filter_context;
+
+/* forward decls. */
+static int ssock_hash_filter_read(ssock*, void*, size_t*);
+static int ssock_hash_filter_write(ssock*, const void*, size_t*);
+static void ssock_hash_filter_dispose(void*);
+
+/**
+ * \brief Initialize a hashing filter ssock which wraps an inner ssock.
+ *
+ * Every byte read from or written to the inner ssock is passed to the given
+ * running hash for that direction, so that a transcript hash can be computed
+ * without a second pass over the data.  Either hash may be NULL, in which case
+ * that direction is passed through unobserved.  The hash contexts are owned by
+ * the caller and must outlive this instance.  This instance takes ownership of
+ * the inner ssock.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param alloc_opts        The allocator to use for the filter context.
+ * \param read_hash         The running hash for bytes read, or NULL.
+ * \param write_hash        The running hash for bytes written, or NULL.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_hash_filter_init(
+    ssock* sock, ssock* inner, allocator_options_t* alloc_opts,
+    vccrypt_hash_context_t* read_hash, vccrypt_hash_context_t* write_hash)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != inner);
+    MODEL_ASSERT(NULL != alloc_opts);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == inner || NULL == alloc_opts)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* start with a pass-through filter. */
+    retval = ssock_filter_init(sock, inner);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* allocate the filter context. */
+    ssock_hash_filter_context* ctx = (ssock_hash_filter_context*)
+        allocate(alloc_opts, sizeof(ssock_hash_filter_context));
+    if (NULL == ctx)
+    {
+        /* the caller keeps the inner socket. */
+        memset(sock, 0, sizeof(ssock));
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    ctx->alloc_opts = alloc_opts;
+    ctx->read_hash = read_hash;
+    ctx->write_hash = write_hash;
+
+    /* only observe the directions which are hashed. */
+    if (NULL != read_hash)
+    {
+        sock->read = &ssock_hash_filter_read;
+    }
+
+    if (NULL != write_hash)
+    {
+        sock->write = &ssock_hash_filter_write;
+        sock->writev = NULL;
+    }
+
+    sock->hdr.dispose = &ssock_hash_filter_dispose;
+    sock->context = ctx;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read from the inner socket, hashing the bytes read.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to read into.
+ * \param size      On input, the number of bytes to read; on output, the number
+ *                  of bytes read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if the bytes read could not be hashed.
+ *      - an error from the inner socket if its read failed.
+ */
+static int ssock_hash_filter_read(ssock* sock, void* buf, size_t* size)
+{
+    ssock_hash_filter_context* ctx = (ssock_hash_filter_context*)sock->context;
+
+    int retval = sock->inner->read(sock->inner, buf, size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(ctx->read_hash, (const uint8_t*)buf, *size))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Write to the inner socket, hashing the bytes written.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to write from.
+ * \param size      On input, the number of bytes to write; on output, the
+ *                  number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if the bytes written could not be
+ *        hashed.
+ *      - an error from the inner socket if its write failed.
+ */
+static int ssock_hash_filter_write(ssock* sock, const void* buf, size_t* size)
+{
+    ssock_hash_filter_context* ctx = (ssock_hash_filter_context*)sock->context;
+
+    int retval = sock->inner->write(sock->inner, buf, size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (VCCRYPT_STATUS_SUCCESS != vccrypt_hash_digest(ctx->write_hash, (const uint8_t*)buf, *size))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a hash filter socket, along with the inner socket.
+ *
+ * \param disposable    The filter socket to dispose.
+ */
+static void ssock_hash_filter_dispose(void* disposable)
+{
+    ssock* sock = (ssock*)disposable;
+    ssock_hash_filter_context* ctx = (ssock_hash_filter_context*)sock->context;
+
+    /* release the filter context. */
+    release(ctx->alloc_opts, ctx);
+
+    /* dispose the inner socket. */
+    dispose((disposable_t*)sock->inner);
+}
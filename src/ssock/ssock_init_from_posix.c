@@ -7,13 +7,18 @@
  */
 
 #include <cbmc/model_assert.h>
+#include <errno.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <vcblockchain/ssock.h>
 
 /* forward decls. */
 static int ssock_posix_read(ssock*, void*, size_t*);
 static int ssock_posix_write(ssock*, const void*, size_t*);
+static int ssock_posix_writev(ssock*, const ssock_iovec*, size_t, size_t*);
+static int ssock_posix_shutdown(ssock*);
 static void ssock_posix_dispose(void*);
 
 /**
@@ -22,7 +27,8 @@ static void ssock_posix_dispose(void*);
  * This instance takes over ownership of the socxet descriptor. This instance is
  * disposable and must be disposed by calling \ref dispose() when no longer
  * needed.  Note that \ref dispose() will close the underlying socket
- * descriptor.
+ * descriptor.  A write to a peer which has hung up fails instead of raising
+ * SIGPIPE.
  *
  * \param sock              The ssock instance to initialize.
  * \param sd                The socket descriptor to use for this instance.
@@ -48,6 +54,8 @@ int ssock_init_from_posix(ssock* sock, int sd)
     sock->hdr.dispose = &ssock_posix_dispose;
     sock->read = &ssock_posix_read;
     sock->write = &ssock_posix_write;
+    sock->writev = &ssock_posix_writev;
+    sock->shutdown = &ssock_posix_shutdown;
     sock->context = (void*)((long)sd);
 
     /* success. */
@@ -116,8 +124,15 @@ static int ssock_posix_write(ssock* sock, const void* buf, size_t* size)
     /* get the socket descriptor from the context pointer. */
     sd = (int)((long)sock->context);
 
-    /* attempt to write bytes to the socket. */
-    ssize_t bytes_written = write(sd, buf, *size);
+    /* attempt to write bytes to the socket; a peer which has hung up fails
+     * the write instead of raising SIGPIPE.  Descriptors which are not
+     * sockets are written to directly. */
+    ssize_t bytes_written = send(sd, buf, *size, MSG_NOSIGNAL);
+    if (bytes_written < 0 && ENOTSOCK == errno)
+    {
+        bytes_written = write(sd, buf, *size);
+    }
+
     if (bytes_written < 0)
     {
         return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
@@ -130,6 +145,110 @@ static int ssock_posix_write(ssock* sock, const void* buf, size_t* size)
     return VCBLOCKCHAIN_STATUS_SUCCESS;
 }
 
+/* the most buffers passed to a single gathered write. */
+#define SSOCK_POSIX_WRITEV_MAX 16
+
+/**
+ * \brief Write several buffers to a POSIX socket with a single system call.
+ *
+ * \param sock      The socket to write to.
+ * \param iov       The buffers to write.
+ * \param iovcnt    The number of buffers.
+ * \param size      On output, the number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ *          - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *          - a non-zero error code on failure.
+ */
+static int ssock_posix_writev(
+    ssock* sock, const ssock_iovec* iov, size_t iovcnt, size_t* size)
+{
+    struct iovec vec[SSOCK_POSIX_WRITEV_MAX];
+    struct msghdr msg;
+    int sd = -1;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != iov || 0 == iovcnt);
+    MODEL_ASSERT(NULL != size);
+
+    /* get the socket descriptor from the context pointer. */
+    sd = (int)((long)sock->context);
+
+    *size = 0;
+    while (iovcnt > 0)
+    {
+        size_t count = iovcnt < SSOCK_POSIX_WRITEV_MAX ? iovcnt : SSOCK_POSIX_WRITEV_MAX;
+        size_t expected = 0;
+
+        /* copy the next group of buffers into a POSIX iovec array. */
+        for (size_t i = 0; i < count; ++i)
+        {
+            vec[i].iov_base = (void*)iov[i].base;
+            vec[i].iov_len = iov[i].size;
+            expected += iov[i].size;
+        }
+
+        /* attempt to write bytes to the socket, as for a single write. */
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = vec;
+        msg.msg_iovlen = count;
+        ssize_t bytes_written = sendmsg(sd, &msg, MSG_NOSIGNAL);
+        if (bytes_written < 0 && ENOTSOCK == errno)
+        {
+            bytes_written = writev(sd, vec, (int)count);
+        }
+
+        if (bytes_written < 0)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        }
+
+        /* save the number of bytes written to size. */
+        *size += bytes_written;
+
+        /* stop at a short write. */
+        if ((size_t)bytes_written != expected)
+        {
+            break;
+        }
+
+        iov += count;
+        iovcnt -= count;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Shut down both directions of a POSIX socket, waking blocked calls.
+ *
+ * \param sock      The socket to shut down.
+ *
+ * \returns a status code indicating success or failure.
+ *          - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *          - a non-zero error code on failure.
+ */
+static int ssock_posix_shutdown(ssock* sock)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+
+    /* get the socket descriptor from the context pointer. */
+    int sd = (int)((long)sock->context);
+
+    /* a socket which the peer has already disconnected is already shut down;
+     * a descriptor which is not a socket can't be woken. */
+    if (0 != shutdown(sd, SHUT_RDWR) && ENOTCONN != errno && ENOTSOCK != errno)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
 /**
  * \brief Dispose of a ssock instance.
  *
@@ -0,0 +1,227 @@
+/**
+ * \file ssock/ssock_internal.h
+ *
+ * \brief Internal helpers for the ssock packet functions.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_INTERNAL_HEADER_GUARD
+
+#include <stdint.h>
+#include <time.h>
+#include <vcblockchain/ssock.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* default initial buffer size in grow mode: 64 KB. */
+#define SSOCK_DEFAULT_GROW_INITIAL_SIZE (64 * 1024)
+
+/* default smallest data packet to compress: 512 bytes. */
+#define SSOCK_DEFAULT_COMPRESSION_THRESHOLD 512
+
+/* the LZ codec can expand at most 255 bytes of output per byte of input. */
+#define SSOCK_LZ_MAX_EXPANSION 255
+
+/**
+ * \brief Get the maximum string size allowed by the read policy.
+ *
+ * \param sock          The socket to query.
+ *
+ * \returns the maximum string size.
+ */
+static inline uint32_t ssock_policy_max_string_size(const ssock* sock)
+{
+    return 0 == sock->read_policy.max_string_size
+        ? SSOCK_DEFAULT_MAX_STRING_SIZE
+        : sock->read_policy.max_string_size;
+}
+
+/**
+ * \brief Get the maximum data packet size allowed by the read policy.
+ *
+ * \param sock          The socket to query.
+ *
+ * \returns the maximum data packet size.
+ */
+static inline uint32_t ssock_policy_max_data_size(const ssock* sock)
+{
+    return 0 == sock->read_policy.max_data_size
+        ? UINT32_MAX
+        : sock->read_policy.max_data_size;
+}
+
+/**
+ * \brief Get the smallest data packet size which is compressed.
+ *
+ * \param sock          The socket to query.
+ *
+ * \returns the compression threshold.
+ */
+static inline uint32_t ssock_compression_threshold(const ssock* sock)
+{
+    return 0 == sock->compression.threshold
+        ? SSOCK_DEFAULT_COMPRESSION_THRESHOLD
+        : sock->compression.threshold;
+}
+
+/**
+ * \brief Read the monotonic clock, for statistics and deadlines.
+ *
+ * On targets without a monotonic clock, such as the Cortex-M builds, this
+ * reads zero, so timing statistics stay at zero.
+ *
+ * \returns the monotonic clock in nanoseconds.
+ */
+static inline uint64_t ssock_clock_nanoseconds(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * \brief Compress a buffer with the LZ codec.
+ *
+ * The output is in the LZ4 block format.  Compression fails if the output does
+ * not fit in the given output buffer, which lets the caller bound the output
+ * to the size at which compression stops being worthwhile.
+ *
+ * \param in            The buffer to compress.
+ * \param in_size       The size of the buffer to compress.
+ * \param out           The output buffer.
+ * \param out_size      The size of the output buffer.
+ *
+ * \returns the size of the compressed output, or 0 if it did not fit.
+ */
+size_t ssock_lz_compress(
+    const uint8_t* in, size_t in_size, uint8_t* out, size_t out_size);
+
+/**
+ * \brief Decompress a buffer compressed with the LZ codec.
+ *
+ * Every length and offset in the input is checked against the input and output
+ * bounds, so malformed input from a peer can't overrun either buffer.
+ *
+ * \param in            The compressed buffer.
+ * \param in_size       The size of the compressed buffer.
+ * \param out           The output buffer.
+ * \param out_size      The exact size of the decompressed output.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if the input is malformed or
+ *        does not decompress to exactly out_size bytes.
+ */
+int ssock_lz_decompress(
+    const uint8_t* in, size_t in_size, uint8_t* out, size_t out_size);
+
+/**
+ * \brief Attempt to write a data packet as a compressed data packet.
+ *
+ * The packet is only written if compression makes it smaller.
+ *
+ * \param sock          The socket to which the packet is written.
+ * \param val           The payload to write.
+ * \param size          The size of the payload.
+ * \param written       Set to 1 if the packet was written, or 0 if the caller
+ *                      should write it uncompressed instead.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_write_compressed_data(
+    ssock* sock, const void* val, uint32_t size, int* written);
+
+/**
+ * \brief Read and decompress the body of a compressed data packet, after its
+ * type and size have been read.
+ *
+ * \param sock          The socket from which the packet body is read.
+ * \param alloc_opts    The allocator to use for the payload buffer.
+ * \param packet_size   The packet size read from the header.
+ * \param val           Pointer to receive the decompressed payload; set to
+ *                      NULL on failure.
+ * \param size          Pointer to receive the decompressed size.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if compression was
+ *        not negotiated for this socket.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if either size
+ *        exceeds the read policy or is inconsistent.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if the payload could not be
+ *        decompressed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_compressed_payload(
+    ssock* sock, allocator_options_t* alloc_opts, uint32_t packet_size,
+    void** val, uint32_t* size);
+
+/**
+ * \brief Read and verify the body of a checksummed data packet, after its type
+ * and size have been read.
+ *
+ * \param sock          The socket from which the packet body is read.
+ * \param alloc_opts    The allocator to use for the payload buffer.
+ * \param size          The payload size read from the header.
+ * \param val           Pointer to receive the payload.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the size exceeds
+ *        the read policy.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM if the checksum did not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_crc_payload(
+    ssock* sock, allocator_options_t* alloc_opts, uint32_t size, void** val);
+
+/**
+ * \brief Allocate a payload buffer and read the payload into it, following the
+ * read policy of the socket.
+ *
+ * In grow mode, the buffer starts small and doubles as payload bytes arrive,
+ * so that a peer which claims a large payload but does not send it can't pin
+ * memory.  Short reads are tolerated; an empty read is treated as a failure.
+ *
+ * \param sock          The socket from which the payload is read.
+ * \param alloc_opts    The allocator to use for the payload buffer.
+ * \param size          The payload size claimed by the peer.
+ * \param extra         The number of extra bytes to allocate past the end of
+ *                      the payload (e.g. for an ASCIIZ terminator).
+ * \param val           Pointer to receive the payload buffer on success.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_payload(
+    ssock* sock, allocator_options_t* alloc_opts, uint32_t size, size_t extra,
+    void** val);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,223 @@
+/**
+ * \file ssock/ssock_lz_compress.c
+ *
+ * \brief Compress a buffer with the LZ codec.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_internal.h"
+
+/* matches are at least this long. */
+#define SSOCK_LZ_MIN_MATCH 4
+
+/* the last match must start at least this many bytes before the end. */
+#define SSOCK_LZ_MATCH_FIND_LIMIT 12
+
+/* the last bytes of the input are always emitted as literals. */
+#define SSOCK_LZ_LAST_LITERALS 5
+
+/* the largest offset which fits in a match. */
+#define SSOCK_LZ_MAX_OFFSET 65535
+
+/* size of the match finder hash table, as a power of two. */
+#define SSOCK_LZ_HASH_LOG 12
+
+/* misses before the match finder starts skipping ahead. */
+#define SSOCK_LZ_SKIP_TRIGGER 6
+
+/* forward decls. */
+static uint32_t ssock_lz_read32(const uint8_t* p);
+static uint32_t ssock_lz_hash(uint32_t seq);
+static uint8_t* ssock_lz_emit_length(uint8_t* op, size_t length);
+static uint8_t* ssock_lz_emit_sequence(
+    uint8_t* op, const uint8_t* oend, const uint8_t* literals,
+    size_t literal_length, size_t offset, size_t match_length);
+
+/**
+ * \brief Compress a buffer with the LZ codec.
+ *
+ * The output is in the LZ4 block format.  Compression fails if the output does
+ * not fit in the given output buffer, which lets the caller bound the output
+ * to the size at which compression stops being worthwhile.
+ *
+ * \param in            The buffer to compress.
+ * \param in_size       The size of the buffer to compress.
+ * \param out           The output buffer.
+ * \param out_size      The size of the output buffer.
+ *
+ * \returns the size of the compressed output, or 0 if it did not fit.
+ */
+size_t ssock_lz_compress(
+    const uint8_t* in, size_t in_size, uint8_t* out, size_t out_size)
+{
+    uint32_t table[1 << SSOCK_LZ_HASH_LOG];
+    const uint8_t* ip = in;
+    const uint8_t* anchor = in;
+    const uint8_t* iend = in + in_size;
+    uint8_t* op = out;
+    const uint8_t* oend = out + out_size;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != in);
+    MODEL_ASSERT(NULL != out);
+
+    /* only search for matches if the input is long enough to hold one. */
+    if (in_size > SSOCK_LZ_MATCH_FIND_LIMIT)
+    {
+        const uint8_t* mflimit = iend - SSOCK_LZ_MATCH_FIND_LIMIT;
+        const uint8_t* matchlimit = iend - SSOCK_LZ_LAST_LITERALS;
+        uint32_t misses = 0;
+
+        memset(table, 0, sizeof(table));
+
+        while (ip < mflimit)
+        {
+            /* look up the last position with the same four bytes. */
+            uint32_t seq = ssock_lz_read32(ip);
+            uint32_t h = ssock_lz_hash(seq);
+            const uint8_t* ref = in + table[h];
+            table[h] = (uint32_t)(ip - in);
+
+            if (ref >= ip || (size_t)(ip - ref) > SSOCK_LZ_MAX_OFFSET || ssock_lz_read32(ref) != seq)
+            {
+                /* skip ahead faster through incompressible data. */
+                ip += 1 + (misses++ >> SSOCK_LZ_SKIP_TRIGGER);
+                continue;
+            }
+
+            /* extend the match forward. */
+            const uint8_t* mp = ip + SSOCK_LZ_MIN_MATCH;
+            const uint8_t* rp = ref + SSOCK_LZ_MIN_MATCH;
+            while (mp < matchlimit && *mp == *rp)
+            {
+                ++mp;
+                ++rp;
+            }
+
+            /* emit the pending literals and this match. */
+            op =
+                ssock_lz_emit_sequence(
+                    op, oend, anchor, (size_t)(ip - anchor),
+                    (size_t)(ip - ref), (size_t)(mp - ip));
+            if (NULL == op)
+            {
+                return 0;
+            }
+
+            ip = mp;
+            anchor = ip;
+            misses = 0;
+        }
+    }
+
+    /* emit the remaining literals. */
+    op = ssock_lz_emit_sequence(op, oend, anchor, (size_t)(iend - anchor), 0, 0);
+    if (NULL == op)
+    {
+        return 0;
+    }
+
+    return (size_t)(op - out);
+}
+
+/**
+ * \brief Read four bytes from an unaligned pointer.
+ */
+static uint32_t ssock_lz_read32(const uint8_t* p)
+{
+    uint32_t val;
+
+    memcpy(&val, p, sizeof(val));
+
+    return val;
+}
+
+/**
+ * \brief Hash four bytes into the match finder table.
+ */
+static uint32_t ssock_lz_hash(uint32_t seq)
+{
+    return (seq * 2654435761U) >> (32 - SSOCK_LZ_HASH_LOG);
+}
+
+/**
+ * \brief Emit the extension bytes of a length which did not fit in the token.
+ */
+static uint8_t* ssock_lz_emit_length(uint8_t* op, size_t length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+
+    *op++ = (uint8_t)length;
+
+    return op;
+}
+
+/**
+ * \brief Emit a sequence of literals, optionally followed by a match.
+ *
+ * A match length of zero emits a final literal-only sequence.
+ *
+ * \returns the new output pointer, or NULL if the sequence did not fit.
+ */
+static uint8_t* ssock_lz_emit_sequence(
+    uint8_t* op, const uint8_t* oend, const uint8_t* literals,
+    size_t literal_length, size_t offset, size_t match_length)
+{
+    /* worst case size: token, lengths, literals, and offset. */
+    size_t needed =
+        1 + (literal_length / 255 + 1) + literal_length + 2
+      + (match_length / 255 + 1);
+    if (needed > (size_t)(oend - op))
+    {
+        return NULL;
+    }
+
+    uint8_t* token = op++;
+    size_t match_code = match_length > 0 ? match_length - SSOCK_LZ_MIN_MATCH : 0;
+
+    /* encode the literal length. */
+    if (literal_length >= 15)
+    {
+        *token = 15 << 4;
+        op = ssock_lz_emit_length(op, literal_length - 15);
+    }
+    else
+    {
+        *token = (uint8_t)(literal_length << 4);
+    }
+
+    /* copy the literals. */
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    /* a final sequence has no match. */
+    if (0 == match_length)
+    {
+        return op;
+    }
+
+    /* encode the offset in little endian order. */
+    *op++ = (uint8_t)(offset & 0xFF);
+    *op++ = (uint8_t)(offset >> 8);
+
+    /* encode the match length. */
+    if (match_code >= 15)
+    {
+        *token |= 15;
+        op = ssock_lz_emit_length(op, match_code - 15);
+    }
+    else
+    {
+        *token |= (uint8_t)match_code;
+    }
+
+    return op;
+}
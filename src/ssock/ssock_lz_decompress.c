@@ -0,0 +1,152 @@
+/**
+ * \file ssock/ssock_lz_decompress.c
+ *
+ * \brief Decompress a buffer compressed with the LZ codec.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/error_codes.h>
+
+#include "ssock_internal.h"
+
+/* forward decls. */
+static int ssock_lz_read_length(
+    const uint8_t** ip, const uint8_t* iend, size_t* length);
+
+/**
+ * \brief Decompress a buffer compressed with the LZ codec.
+ *
+ * Every length and offset in the input is checked against the input and output
+ * bounds, so malformed input from a peer can't overrun either buffer.
+ *
+ * \param in            The compressed buffer.
+ * \param in_size       The size of the compressed buffer.
+ * \param out           The output buffer.
+ * \param out_size      The exact size of the decompressed output.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if the input is malformed or
+ *        does not decompress to exactly out_size bytes.
+ */
+int ssock_lz_decompress(
+    const uint8_t* in, size_t in_size, uint8_t* out, size_t out_size)
+{
+    const uint8_t* ip = in;
+    const uint8_t* iend = in + in_size;
+    uint8_t* op = out;
+    uint8_t* oend = out + out_size;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != in);
+    MODEL_ASSERT(NULL != out);
+
+    while (ip < iend)
+    {
+        uint8_t token = *ip++;
+
+        /* decode the literal length. */
+        size_t literal_length = token >> 4;
+        if (15 == literal_length && VCBLOCKCHAIN_STATUS_SUCCESS != ssock_lz_read_length(&ip, iend, &literal_length))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        /* copy the literals. */
+        if (literal_length > (size_t)(iend - ip) || literal_length > (size_t)(oend - op))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        /* the final sequence has no match. */
+        if (ip == iend)
+        {
+            break;
+        }
+
+        /* decode the offset. */
+        if (iend - ip < 2)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+
+        if (0 == offset || offset > (size_t)(op - out))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        /* decode the match length. */
+        size_t match_length = token & 15;
+        if (15 == match_length && VCBLOCKCHAIN_STATUS_SUCCESS != ssock_lz_read_length(&ip, iend, &match_length))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        match_length += 4;
+        if (match_length > (size_t)(oend - op))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        /* copy the match, which may overlap its own output. */
+        const uint8_t* ref = op - offset;
+        if (offset >= match_length)
+        {
+            memcpy(op, ref, match_length);
+            op += match_length;
+        }
+        else
+        {
+            while (match_length-- > 0)
+            {
+                *op++ = *ref++;
+            }
+        }
+    }
+
+    /* the output must be filled exactly. */
+    if (op != oend)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read the extension bytes of a length, adding them to the length.
+ *
+ * \param ip            Pointer to the input pointer, which is advanced.
+ * \param iend          The end of the input.
+ * \param length        The length to extend.
+ *
+ * \returns A status code indicating success or failure.
+ */
+static int ssock_lz_read_length(
+    const uint8_t** ip, const uint8_t* iend, size_t* length)
+{
+    uint8_t b;
+
+    do
+    {
+        if (*ip >= iend)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS;
+        }
+
+        b = *(*ip)++;
+        *length += b;
+    } while (255 == b);
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
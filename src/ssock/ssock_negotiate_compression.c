@@ -0,0 +1,89 @@
+/**
+ * \file ssock/ssock_negotiate_compression.c
+ *
+ * \brief Negotiate data packet compression with the peer.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Negotiate data packet compression with the peer.
+ *
+ * Both peers must call this function at the same point in the conversation.
+ * Each peer sends the bitmask of codecs it supports and reads the bitmask of
+ * the peer; compression is enabled if both peers support a common codec.  Once
+ * enabled, \ref ssock_write_data() compresses payloads of at least the
+ * threshold size when this makes them smaller, and \ref ssock_read_data()
+ * decompresses them transparently.  Pass SSOCK_COMPRESSION_NONE to decline.
+ *
+ * \param sock              The ssock instance to negotiate on.
+ * \param alloc_opts        The allocator to use for compression scratch
+ *                          buffers; may be NULL if declining.
+ * \param codecs            The bitmask of supported SSOCK_COMPRESSION_* codecs.
+ * \param threshold         The smallest payload to compress; 0 selects the
+ *                          default of 512 bytes.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the peer did not
+ *        respond with a compression offer.
+ */
+int ssock_negotiate_compression(
+    ssock* sock, allocator_options_t* alloc_opts, uint8_t codecs,
+    uint32_t threshold)
+{
+    int retval;
+    uint8_t peer_codecs = SSOCK_COMPRESSION_NONE;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(SSOCK_COMPRESSION_NONE == codecs || NULL != alloc_opts);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || (SSOCK_COMPRESSION_NONE != codecs && NULL == alloc_opts))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* only offer the codecs this library supports. */
+    codecs &= SSOCK_COMPRESSION_LZ;
+
+    /* send our offer, making sure it is not held in a buffer. */
+    retval = ssock_write_uint8(sock, codecs);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    retval = ssock_flush(sock);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* read the peer's offer. */
+    retval = ssock_read_uint8(sock, &peer_codecs);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* enable compression if both peers support it. */
+    memset(&sock->compression, 0, sizeof(ssock_compression));
+    if (codecs & peer_codecs & SSOCK_COMPRESSION_LZ)
+    {
+        sock->compression.codec = SSOCK_COMPRESSION_LZ;
+        sock->compression.threshold = threshold;
+        sock->compression.alloc_opts = alloc_opts;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
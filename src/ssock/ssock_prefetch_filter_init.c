@@ -0,0 +1,345 @@
+/**
+ * \file src/ssock/ssock_prefetch_filter_init.c
+ *
+ * \brief Initialize a prefetching filter ssock which wraps an inner ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <string.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief A pooled slot buffer, filled by the I/O thread.
+ */
+typedef struct ssock_prefetch_slot
+{
+    uint8_t* buf;
+    size_t size;
+    size_t offset;
+    int status;
+} ssock_prefetch_slot;
+
+/**
+ * \brief Prefetch filter context.
+ *
+ * The slots and their buffers follow this structure in the same allocation.
+ * The slots form a single-producer, single-consumer ring: the I/O thread owns
+ * the producer index and the reader owns the consumer index, and each slot is
+ * handed between them with the filled and free semaphores, so neither side
+ * takes a lock.
+ */
+typedef struct ssock_prefetch_filter_context
+{
+    allocator_options_t* alloc_opts;
+    ssock* inner;
+    ssock_prefetch_slot* slots;
+    size_t slot_count;
+    size_t slot_size;
+    sem_t filled;
+    sem_t free;
+    pthread_t thread;
+
+    /* set by dispose to stop the I/O thread. */
+    uint8_t stopping;
+
+    /* owned by the I/O thread. */
+    size_t producer;
+
+    /* owned by the reader. */
+    size_t consumer;
+    ssock_prefetch_slot* current;
+    uint8_t ended;
+    int end_status;
+} ssock_prefetch_filter_context;
+
+/* forward decls. */
+static int ssock_prefetch_filter_read(ssock*, void*, size_t*);
+static void* ssock_prefetch_filter_thread(void*);
+static void ssock_prefetch_filter_sem_wait(sem_t* sem);
+static void ssock_prefetch_filter_dispose(void*);
+
+/**
+ * \brief Initialize a prefetching filter ssock which wraps an inner ssock.
+ *
+ * A dedicated I/O thread reads ahead from the inner ssock into a ring of
+ * pooled slot buffers, while the caller decodes and processes the packets
+ * already received, so that network and CPU work overlap.  The I/O thread
+ * stops filling once every slot is full, which bounds memory use and lets the
+ * peer's flow control take over.  Reads are served from the ring and are
+ * satisfied in full unless the inner ssock reaches end of stream; a read error
+ * on the inner ssock is reported once the data before it has been consumed.
+ * Writes pass through to the inner ssock.
+ *
+ * Only one thread may read from this instance.  Since the I/O thread reads
+ * from the inner ssock while the caller writes to it, the inner ssock must
+ * support a read concurrent with a write, as a POSIX socket does.  This
+ * instance takes ownership of the inner ssock.  Disposing it stops and joins
+ * the I/O thread, shutting down the inner ssock with \ref ssock_shutdown() to
+ * wake a read blocked on it; an inner ssock which can't be shut down must not
+ * block a read indefinitely.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param alloc_opts        The allocator to use for the slot buffers.
+ * \param slots             The number of slot buffers; at least two.
+ * \param slot_size         The size of each slot buffer.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_PREFETCH_THREAD if the I/O thread could not
+ *        be started.
+ */
+int ssock_prefetch_filter_init(
+    ssock* sock, ssock* inner, allocator_options_t* alloc_opts, size_t slots,
+    size_t slot_size)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != inner);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(slots >= 2);
+    MODEL_ASSERT(slot_size > 0);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == inner || NULL == alloc_opts || slots < 2 || 0 == slot_size)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* start with a pass-through filter. */
+    retval = ssock_filter_init(sock, inner);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* allocate the filter context, the slots, and their buffers at once. */
+    ssock_prefetch_filter_context* ctx = (ssock_prefetch_filter_context*)
+        allocate(
+            alloc_opts,
+            sizeof(ssock_prefetch_filter_context)
+                + slots * (sizeof(ssock_prefetch_slot) + slot_size));
+    if (NULL == ctx)
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto clear_sock;
+    }
+
+    memset(ctx, 0, sizeof(ssock_prefetch_filter_context));
+    ctx->alloc_opts = alloc_opts;
+    ctx->inner = inner;
+    ctx->slots = (ssock_prefetch_slot*)(ctx + 1);
+    ctx->slot_count = slots;
+    ctx->slot_size = slot_size;
+
+    uint8_t* buf = (uint8_t*)(ctx->slots + slots);
+    for (size_t i = 0; i < slots; ++i)
+    {
+        memset(&ctx->slots[i], 0, sizeof(ssock_prefetch_slot));
+        ctx->slots[i].buf = buf + i * slot_size;
+    }
+
+    /* every slot starts out free. */
+    if (0 != sem_init(&ctx->filled, 0, 0))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_PREFETCH_THREAD;
+        goto release_ctx;
+    }
+
+    if (0 != sem_init(&ctx->free, 0, slots))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_PREFETCH_THREAD;
+        goto destroy_filled;
+    }
+
+    /* start reading ahead. */
+    if (0 != pthread_create(&ctx->thread, NULL, &ssock_prefetch_filter_thread, ctx))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_PREFETCH_THREAD;
+        goto destroy_free;
+    }
+
+    sock->read = &ssock_prefetch_filter_read;
+    sock->hdr.dispose = &ssock_prefetch_filter_dispose;
+    sock->context = ctx;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+destroy_free:
+    sem_destroy(&ctx->free);
+
+destroy_filled:
+    sem_destroy(&ctx->filled);
+
+release_ctx:
+    release(alloc_opts, ctx);
+
+clear_sock:
+    /* the caller keeps the inner socket. */
+    memset(sock, 0, sizeof(ssock));
+
+    return retval;
+}
+
+/**
+ * \brief Read from the ring, waiting for the I/O thread as needed.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to read into.
+ * \param size      On input, the number of bytes to read; on output, the number
+ *                  of bytes read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_prefetch_filter_read(ssock* sock, void* buf, size_t* size)
+{
+    ssock_prefetch_filter_context* ctx =
+        (ssock_prefetch_filter_context*)sock->context;
+    uint8_t* out = (uint8_t*)buf;
+    size_t total = 0;
+
+    while (total < *size)
+    {
+        ssock_prefetch_slot* slot = ctx->current;
+
+        /* serve as much as possible from the current slot. */
+        if (NULL != slot && slot->offset < slot->size)
+        {
+            size_t avail = slot->size - slot->offset;
+            size_t n = avail < *size - total ? avail : *size - total;
+            memcpy(out + total, slot->buf + slot->offset, n);
+            slot->offset += n;
+            total += n;
+            continue;
+        }
+
+        /* the I/O thread has stopped. */
+        if (ctx->ended)
+        {
+            break;
+        }
+
+        /* hand the drained slot back to the I/O thread. */
+        if (NULL != slot)
+        {
+            ctx->current = NULL;
+            ++ctx->consumer;
+            sem_post(&ctx->free);
+        }
+
+        /* wait for the next slot. */
+        ssock_prefetch_filter_sem_wait(&ctx->filled);
+        slot = ctx->current = &ctx->slots[ctx->consumer % ctx->slot_count];
+
+        /* an empty or failed slot is the last one the I/O thread fills. */
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != slot->status || 0 == slot->size)
+        {
+            ctx->ended = 1;
+            ctx->end_status = slot->status;
+        }
+    }
+
+    *size = total;
+
+    /* report an error only once the data before it has been consumed. */
+    if (0 == total && ctx->ended)
+    {
+        return ctx->end_status;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Fill free slots from the inner socket until it ends or fails.
+ *
+ * \param context   The filter context.
+ *
+ * \returns NULL.
+ */
+static void* ssock_prefetch_filter_thread(void* context)
+{
+    ssock_prefetch_filter_context* ctx =
+        (ssock_prefetch_filter_context*)context;
+    size_t read_size;
+
+    do
+    {
+        ssock_prefetch_filter_sem_wait(&ctx->free);
+
+        /* dispose posts a free slot to wake this thread when stopping. */
+        if (__atomic_load_n(&ctx->stopping, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        ssock_prefetch_slot* slot =
+            &ctx->slots[ctx->producer % ctx->slot_count];
+        slot->size = ctx->slot_size;
+        slot->offset = 0;
+        slot->status =
+            ctx->inner->read(ctx->inner, slot->buf, &slot->size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != slot->status)
+        {
+            slot->size = 0;
+        }
+
+        /* the slot belongs to the reader once it is posted. */
+        read_size = slot->size;
+        ++ctx->producer;
+        sem_post(&ctx->filled);
+
+    } while (0 != read_size && !__atomic_load_n(&ctx->stopping, __ATOMIC_ACQUIRE));
+
+    return NULL;
+}
+
+/**
+ * \brief Wait on a semaphore, retrying when interrupted by a signal.
+ *
+ * \param sem       The semaphore to wait on.
+ */
+static void ssock_prefetch_filter_sem_wait(sem_t* sem)
+{
+    while (0 != sem_wait(sem) && EINTR == errno)
+        ;
+}
+
+/**
+ * \brief Dispose of a prefetch filter socket, along with the inner socket.
+ *
+ * \param disposable    The filter socket to dispose.
+ */
+static void ssock_prefetch_filter_dispose(void* disposable)
+{
+    ssock* sock = (ssock*)disposable;
+    ssock_prefetch_filter_context* ctx =
+        (ssock_prefetch_filter_context*)sock->context;
+
+    /* the I/O thread may be blocked on the inner socket or a free slot, so
+     * wake both before waiting for it to stop. */
+    __atomic_store_n(&ctx->stopping, 1, __ATOMIC_RELEASE);
+    ssock_shutdown(ctx->inner);
+    sem_post(&ctx->free);
+    pthread_join(ctx->thread, NULL);
+
+    sem_destroy(&ctx->free);
+    sem_destroy(&ctx->filled);
+
+    /* release the filter context and slots. */
+    release(ctx->alloc_opts, ctx);
+
+    /* dispose the inner socket. */
+    dispose((disposable_t*)sock->inner);
+}
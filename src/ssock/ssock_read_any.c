@@ -0,0 +1,445 @@
+/**
+ * \file ssock/ssock_read_any.c
+ *
+ * \brief Read a packet of any type from a socket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+
+#include "ssock_internal.h"
+
+/**
+ * \brief Decoder for the body of a packet, after the type has been read.
+ */
+typedef int (*ssock_read_any_decoder_fn)(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val);
+
+/* forward decls. */
+static int ssock_read_any_fixed(
+    ssock* sock, uint8_t* buf, uint32_t expected_size);
+static int ssock_read_any_size(ssock* sock, uint32_t* size);
+static int ssock_read_any_uint8(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_int8(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_uint32(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_int32(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_uint64(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_int64(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_string(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_data(ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_compressed_data(
+    ssock*, allocator_options_t*, ssock_value*);
+static int ssock_read_any_crc_data(ssock*, allocator_options_t*, ssock_value*);
+
+/**
+ * \brief Jump table of body decoders, indexed by packet type.
+ *
+ * Packet types without a decoder are rejected as unexpected.
+ */
+static const ssock_read_any_decoder_fn ssock_read_any_decoders[256] = {
+    [SSOCK_DATA_TYPE_UINT8] = &ssock_read_any_uint8,
+    [SSOCK_DATA_TYPE_UINT32] = &ssock_read_any_uint32,
+    [SSOCK_DATA_TYPE_UINT64] = &ssock_read_any_uint64,
+    [SSOCK_DATA_TYPE_INT8] = &ssock_read_any_int8,
+    [SSOCK_DATA_TYPE_INT32] = &ssock_read_any_int32,
+    [SSOCK_DATA_TYPE_INT64] = &ssock_read_any_int64,
+    [SSOCK_DATA_TYPE_STRING] = &ssock_read_any_string,
+    [SSOCK_DATA_TYPE_DATA_PACKET] = &ssock_read_any_data,
+    [SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET] = &ssock_read_any_compressed_data,
+    [SSOCK_DATA_TYPE_CRC_DATA_PACKET] = &ssock_read_any_crc_data,
+};
+
+/**
+ * \brief Read a packet of any type from the socket.
+ *
+ * The packet type is read first, and then the packet is decoded according to
+ * this type.  On success, the type, size, and value of the packet are stored
+ * in the given \ref ssock_value.  If the packet is a string or data packet,
+ * then the value is allocated using the given allocator, and the caller owns
+ * this value and is responsible for releasing it when it is no longer in use.
+ * The read policy of this socket applies as it does for \ref ssock_read_string()
+ * and \ref ssock_read_data().  A compressed data packet is decompressed, and a
+ * checksummed data packet is verified; both are reported as data packets.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param alloc_opts    The allocator options to use for this read.
+ * \param val           Pointer to the tagged value to hold the packet.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if a compressed data packet
+ *        could not be decompressed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM if the checksum of a
+ *        checksummed data packet did not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_any(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t type = 0U;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != val);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == alloc_opts || NULL == val)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* attempt to read the type info. */
+    size_t type_size = sizeof(type);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, &type, &type_size) || sizeof(type) != type_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    /* look up the decoder for this type. */
+    ssock_read_any_decoder_fn decoder = ssock_read_any_decoders[type];
+    if (NULL == decoder)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    /* decode the rest of the packet. */
+    memset(val, 0, sizeof(ssock_value));
+    val->type = type;
+    return decoder(sock, alloc_opts, val);
+}
+
+/**
+ * \brief Read the size and value of a fixed size packet in a single read.
+ *
+ * \param sock          The socket from which the packet body is read.
+ * \param buf           Buffer large enough to hold the size and the value.
+ * \param expected_size The expected size of the value.
+ *
+ * \returns A status code indicating success or failure.
+ */
+static int ssock_read_any_fixed(
+    ssock* sock, uint8_t* buf, uint32_t expected_size)
+{
+    uint32_t nsize = 0U;
+
+    /* attempt to read the size and value. */
+    size_t buf_size = sizeof(nsize) + expected_size;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, buf, &buf_size) || sizeof(nsize) + expected_size != buf_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    /* verify the size. */
+    memcpy(&nsize, buf, sizeof(nsize));
+    if (expected_size != (uint32_t)ntohl(nsize))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read the size of a variable size packet.
+ *
+ * \param sock          The socket from which the size is read.
+ * \param size          Pointer to receive the size in host byte order.
+ *
+ * \returns A status code indicating success or failure.
+ */
+static int ssock_read_any_size(ssock* sock, uint32_t* size)
+{
+    uint32_t nsize = 0U;
+
+    /* attempt to read the size. */
+    size_t nsize_size = sizeof(nsize);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, &nsize, &nsize_size) || sizeof(nsize) != nsize_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    /* convert the size to host byte order. */
+    *size = ntohl(nsize);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a uint8 packet.
+ */
+static int ssock_read_any_uint8(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t buf[sizeof(uint32_t) + sizeof(uint8_t)];
+    (void)alloc_opts;
+
+    int retval = ssock_read_any_fixed(sock, buf, sizeof(uint8_t));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    val->size = sizeof(uint8_t);
+    val->val.uint8_val = buf[sizeof(uint32_t)];
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of an int8 packet.
+ */
+static int ssock_read_any_int8(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t buf[sizeof(uint32_t) + sizeof(int8_t)];
+    (void)alloc_opts;
+
+    int retval = ssock_read_any_fixed(sock, buf, sizeof(int8_t));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    val->size = sizeof(int8_t);
+    val->val.int8_val = (int8_t)buf[sizeof(uint32_t)];
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a uint32 packet.
+ */
+static int ssock_read_any_uint32(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t buf[sizeof(uint32_t) + sizeof(uint32_t)];
+    uint32_t nval = 0U;
+    (void)alloc_opts;
+
+    int retval = ssock_read_any_fixed(sock, buf, sizeof(uint32_t));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    memcpy(&nval, buf + sizeof(uint32_t), sizeof(nval));
+    val->size = sizeof(uint32_t);
+    val->val.uint32_val = ntohl(nval);
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of an int32 packet.
+ */
+static int ssock_read_any_int32(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t buf[sizeof(uint32_t) + sizeof(int32_t)];
+    int32_t nval = 0;
+    (void)alloc_opts;
+
+    int retval = ssock_read_any_fixed(sock, buf, sizeof(int32_t));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    memcpy(&nval, buf + sizeof(uint32_t), sizeof(nval));
+    val->size = sizeof(int32_t);
+    val->val.int32_val = ntohl(nval);
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a uint64 packet.
+ */
+static int ssock_read_any_uint64(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t buf[sizeof(uint32_t) + sizeof(uint64_t)];
+    uint64_t nval = 0U;
+    (void)alloc_opts;
+
+    int retval = ssock_read_any_fixed(sock, buf, sizeof(uint64_t));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    memcpy(&nval, buf + sizeof(uint32_t), sizeof(nval));
+    val->size = sizeof(uint64_t);
+    val->val.uint64_val = ntohll(nval);
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of an int64 packet.
+ */
+static int ssock_read_any_int64(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint8_t buf[sizeof(uint32_t) + sizeof(int64_t)];
+    int64_t nval = 0;
+    (void)alloc_opts;
+
+    int retval = ssock_read_any_fixed(sock, buf, sizeof(int64_t));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    memcpy(&nval, buf + sizeof(uint32_t), sizeof(nval));
+    val->size = sizeof(int64_t);
+    val->val.int64_val = ntohll(nval);
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a string packet.
+ */
+static int ssock_read_any_string(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint32_t size = 0U;
+
+    int retval = ssock_read_any_size(sock, &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* cap the maximum string size according to the read policy. */
+    if (size > ssock_policy_max_string_size(sock))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    /* attempt to allocate memory for and read the string. */
+    char* str = NULL;
+    retval = ssock_read_payload(sock, alloc_opts, size, 1, (void**)&str);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* set the asciiz. */
+    str[size] = 0;
+
+    val->size = size;
+    val->val.string_val = str;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a data packet.
+ */
+static int ssock_read_any_data(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint32_t size = 0U;
+
+    int retval = ssock_read_any_size(sock, &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* enforce the maximum data size before allocating anything. */
+    if (size > ssock_policy_max_data_size(sock))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    /* attempt to allocate memory for and read the data. */
+    void* data = NULL;
+    retval = ssock_read_payload(sock, alloc_opts, size, 0, &data);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    val->size = size;
+    val->val.data_val = data;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a compressed data packet.
+ */
+static int ssock_read_any_compressed_data(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint32_t packet_size = 0U;
+
+    int retval = ssock_read_any_size(sock, &packet_size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* decompress the payload. */
+    retval =
+        ssock_read_compressed_payload(
+            sock, alloc_opts, packet_size, &val->val.data_val, &val->size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        val->val.data_val = NULL;
+        return retval;
+    }
+
+    /* the caller sees the decompressed data packet. */
+    val->type = SSOCK_DATA_TYPE_DATA_PACKET;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Decode the body of a checksummed data packet.
+ */
+static int ssock_read_any_crc_data(
+    ssock* sock, allocator_options_t* alloc_opts, ssock_value* val)
+{
+    uint32_t size = 0U;
+
+    int retval = ssock_read_any_size(sock, &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* read and verify the payload. */
+    void* data = NULL;
+    retval = ssock_read_crc_payload(sock, alloc_opts, size, &data);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the caller sees the verified data packet. */
+    val->type = SSOCK_DATA_TYPE_DATA_PACKET;
+    val->size = size;
+    val->val.data_val = data;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
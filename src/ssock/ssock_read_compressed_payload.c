@@ -0,0 +1,132 @@
+/**
+ * \file ssock/ssock_read_compressed_payload.c
+ *
+ * \brief Read and decompress the body of a compressed data packet.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/error_codes.h>
+
+#include "ssock_internal.h"
+
+/**
+ * \brief Read and decompress the body of a compressed data packet, after its
+ * type and size have been read.
+ *
+ * \param sock          The socket from which the packet body is read.
+ * \param alloc_opts    The allocator to use for the payload buffer.
+ * \param packet_size   The packet size read from the header.
+ * \param val           Pointer to receive the decompressed payload; set to
+ *                      NULL on failure.
+ * \param size          Pointer to receive the decompressed size.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if compression was
+ *        not negotiated for this socket.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if either size
+ *        exceeds the read policy or is inconsistent.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if the payload could not be
+ *        decompressed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_compressed_payload(
+    ssock* sock, allocator_options_t* alloc_opts, uint32_t packet_size,
+    void** val, uint32_t* size)
+{
+    int retval;
+    uint32_t nsize = 0U;
+    void* compressed = NULL;
+    uint64_t start = 0;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != val);
+    MODEL_ASSERT(NULL != size);
+
+    /* the caller never sees a buffer from a failed read. */
+    *val = NULL;
+
+    /* a peer may only send compressed packets once this is negotiated. */
+    if (SSOCK_COMPRESSION_NONE == sock->compression.codec)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    /* the packet holds the decompressed size and a non-empty payload. */
+    uint32_t max_size = ssock_policy_max_data_size(sock);
+    if (packet_size <= sizeof(nsize) || packet_size - sizeof(nsize) > max_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    uint32_t compressed_size = packet_size - sizeof(nsize);
+
+    /* attempt to read the decompressed size. */
+    size_t nsize_size = sizeof(nsize);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, &nsize, &nsize_size) || sizeof(nsize) != nsize_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    *size = ntohl(nsize);
+
+    /* bound the decompressed size by the policy and by the codec. */
+    if (0 == *size || *size > max_size || *size > (uint64_t)compressed_size * SSOCK_LZ_MAX_EXPANSION)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    /* read the compressed payload before allocating for the output, so that
+     * memory use tracks bytes actually received. */
+    retval = ssock_read_payload(sock, alloc_opts, compressed_size, 0, &compressed);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* attempt to allocate memory for the decompressed payload. */
+    *val = allocate(alloc_opts, *size);
+    if (NULL == *val)
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto cleanup_compressed;
+    }
+
+    if (NULL != sock->stats)
+    {
+        start = ssock_clock_nanoseconds();
+    }
+
+    /* attempt to decompress the payload. */
+    retval =
+        ssock_lz_decompress(
+            (const uint8_t*)compressed, compressed_size, (uint8_t*)*val, *size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        release(alloc_opts, *val);
+        *val = NULL;
+        goto cleanup_compressed;
+    }
+
+    if (NULL != sock->stats)
+    {
+        sock->stats->decompress_nanoseconds += ssock_clock_nanoseconds() - start;
+        sock->stats->decompress_bytes_in += compressed_size;
+        sock->stats->decompress_bytes_out += *size;
+    }
+
+    /* success. */
+    retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+cleanup_compressed:
+    release(alloc_opts, compressed);
+
+    return retval;
+}
@@ -0,0 +1,79 @@
+/**
+ * \file ssock/ssock_read_crc_payload.c
+ *
+ * \brief Read and verify the body of a checksummed data packet.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/crc32c.h>
+#include <vcblockchain/error_codes.h>
+
+#include "ssock_internal.h"
+
+/**
+ * \brief Read and verify the body of a checksummed data packet, after its type
+ * and size have been read.
+ *
+ * \param sock          The socket from which the packet body is read.
+ * \param alloc_opts    The allocator to use for the payload buffer.
+ * \param size          The payload size read from the header.
+ * \param val           Pointer to receive the payload.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the size exceeds
+ *        the read policy.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM if the checksum did not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_crc_payload(
+    ssock* sock, allocator_options_t* alloc_opts, uint32_t size, void** val)
+{
+    uint8_t header[SSOCK_PACKET_HEADER_SIZE];
+    uint32_t ncrc = 0U;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != val);
+
+    /* enforce the maximum data size before allocating anything. */
+    if (size > ssock_policy_max_data_size(sock) || size > UINT32_MAX - SSOCK_CRC_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    /* read the payload and the trailing checksum together. */
+    uint8_t* buf = NULL;
+    int retval =
+        ssock_read_payload(sock, alloc_opts, size + SSOCK_CRC_SIZE, 0, (void**)&buf);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* rebuild the header, which is covered by the checksum. */
+    uint32_t hlen = htonl(size);
+    header[0] = SSOCK_DATA_TYPE_CRC_DATA_PACKET;
+    memcpy(header + 1, &hlen, sizeof(hlen));
+
+    /* verify the checksum. */
+    uint32_t crc = crc32c(0, header, sizeof(header));
+    crc = crc32c(crc, buf, size);
+    memcpy(&ncrc, buf + size, sizeof(ncrc));
+    if (crc != (uint32_t)ntohl(ncrc))
+    {
+        release(alloc_opts, buf);
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM;
+    }
+
+    /* success. */
+    *val = buf;
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
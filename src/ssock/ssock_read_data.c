@@ -11,12 +11,18 @@
 #include <vcblockchain/error_codes.h>
 #include <vcblockchain/ssock.h>
 
+#include "ssock_internal.h"
+
 /**
  * \brief Read a data packet from the socket.
  *
  * On success, a data buffer is allocated and read, along with type
  * information and size.  The caller owns this buffer and is responsible for
- * releasing it to the allocator when it is no longer in use.
+ * releasing it to the allocator when it is no longer in use.  The maximum size
+ * and allocation mode are set by the read policy of this socket.  If
+ * compression was negotiated for this socket, a compressed data packet is
+ * decompressed transparently, and the read policy applies to both its
+ * compressed and its decompressed size.
  *
  * \param sock          The \ref ssock socket from which data is read.
  * \param alloc_opts    The allocator options to use for this read.
@@ -30,6 +36,10 @@
  *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
  *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
  *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        exceeds the read policy of this socket.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS if a compressed data packet
+ *        could not be decompressed.
  *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
  *        out-of-memory error.
  */
@@ -59,7 +69,7 @@ int ssock_read_data(
     }
 
     /* verify that the type is IPC_DATA_TYPE_DATA_PACKET. */
-    if (SSOCK_DATA_TYPE_DATA_PACKET != type)
+    if (SSOCK_DATA_TYPE_DATA_PACKET != type && SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET != type)
     {
         return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
     }
@@ -74,20 +84,24 @@ int ssock_read_data(
     /* convert the size to host byte order. */
     *size = ntohl(nsize);
 
-    /* attempt to allocate memory for this data. */
-    *val = allocate(alloc_opts, *size);
-    if (NULL == *val)
+    /* decompress a compressed data packet. */
+    if (SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET == type)
     {
-        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        return ssock_read_compressed_payload(sock, alloc_opts, *size, val, size);
     }
 
-    /* attempt to read the data. */
-    size_t read_size = *size;
-    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, *val, &read_size) || *size != read_size)
+    /* enforce the maximum data size before allocating anything. */
+    if (*size > ssock_policy_max_data_size(sock))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    /* attempt to allocate memory for and read the data. */
+    int retval = ssock_read_payload(sock, alloc_opts, *size, 0, val);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
     {
-        release(alloc_opts, *val);
         *val = NULL;
-        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        return retval;
     }
 
     /* success. */
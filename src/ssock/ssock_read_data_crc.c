@@ -0,0 +1,94 @@
+/**
+ * \file ssock/ssock_read_data_crc.c
+ *
+ * \brief Read a checksummed data packet from a socket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+
+#include "ssock_internal.h"
+
+/**
+ * \brief Read a checksummed data packet from the socket.
+ *
+ * On success, a data buffer is allocated and read, along with type
+ * information and size, and the CRC32C checksum of the packet is verified.
+ * The caller owns this buffer and is responsible for releasing it to the
+ * allocator when it is no longer in use.  The maximum size and allocation mode
+ * are set by the read policy of this socket.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param alloc_opts    The allocator options to use for this read.
+ * \param val           Pointer to the pointer of the data buffer.
+ * \param size          Pointer to the variable to receive the size of this
+ *                      packet.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if the data size
+ *        exceeds the read policy of this socket.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM if the checksum did not match.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_data_crc(
+    ssock* sock, allocator_options_t* alloc_opts, void** val, uint32_t* size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != val);
+    MODEL_ASSERT(NULL != size);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == alloc_opts || NULL == val || NULL == size)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    uint8_t type = 0U;
+    uint32_t nsize = 0U;
+
+    /* attempt to read the type info. */
+    size_t type_size = sizeof(type);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, &type, &type_size) || sizeof(type) != type_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    /* verify that the type is SSOCK_DATA_TYPE_CRC_DATA_PACKET. */
+    if (SSOCK_DATA_TYPE_CRC_DATA_PACKET != type)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    /* attempt to read the size. */
+    size_t nsize_size = sizeof(nsize);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, &nsize, &nsize_size) || sizeof(nsize) != nsize_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+    }
+
+    /* convert the size to host byte order. */
+    *size = ntohl(nsize);
+
+    /* attempt to read and verify the payload. */
+    int retval = ssock_read_crc_payload(sock, alloc_opts, *size, val);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        *val = NULL;
+        return retval;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
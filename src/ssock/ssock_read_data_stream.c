@@ -0,0 +1,184 @@
+/**
+ * \file ssock/ssock_read_data_stream.c
+ *
+ * \brief Read a data packet from a socket in bounded chunks.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/error_codes.h>
+#include <vcblockchain/ssock.h>
+
+/* forward decls. */
+static int ssock_read_data_stream_exact(ssock* sock, void* buf, size_t size);
+static int ssock_read_data_stream_payload(
+    ssock* sock, void* buf, size_t buf_size, uint32_t payload_size,
+    ssock_data_chunk_fn onchunk, void* context, uint64_t* size);
+
+/**
+ * \brief Read a data packet from the socket in bounded chunks.
+ *
+ * Either a data packet or a data stream packet is read from the socket.
+ * Instead of allocating a buffer for the whole payload, the payload is read
+ * into the caller's buffer as bytes arrive, and each chunk is passed to the
+ * given callback.  This allows large payloads to be hashed, written to disk, or
+ * parsed incrementally in constant memory.
+ *
+ * \param sock          The \ref ssock socket from which data is read.
+ * \param buf           The buffer to use for receiving chunks.
+ * \param buf_size      The size of this buffer, which bounds the chunk size.
+ * \param onchunk       The callback to receive each chunk.
+ * \param context       The user context to pass to the callback.
+ * \param size          Pointer to the variable to receive the total size of
+ *                      the payload.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if the data type
+ *        read from the socket was unexpected.
+ *      - the non-zero status returned by the callback, if it aborts the read.
+ */
+int ssock_read_data_stream(
+    ssock* sock, void* buf, size_t buf_size, ssock_data_chunk_fn onchunk,
+    void* context, uint64_t* size)
+{
+    int retval;
+    uint8_t type = 0U;
+    uint32_t nsize = 0U;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != buf);
+    MODEL_ASSERT(buf_size > 0);
+    MODEL_ASSERT(NULL != onchunk);
+    MODEL_ASSERT(NULL != size);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == buf || 0 == buf_size || NULL == onchunk || NULL == size)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    *size = 0U;
+
+    /* attempt to read the type info. */
+    retval = ssock_read_data_stream_exact(sock, &type, sizeof(type));
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* verify that the type is a data packet or a data stream packet. */
+    if (SSOCK_DATA_TYPE_DATA_PACKET != type && SSOCK_DATA_TYPE_DATA_STREAM != type)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    /* a data packet has a single payload; a stream has a sequence of chunks
+     * terminated by an empty chunk. */
+    do
+    {
+        /* attempt to read the size of the payload or chunk. */
+        retval = ssock_read_data_stream_exact(sock, &nsize, sizeof(nsize));
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        /* convert the size to host byte order. */
+        uint32_t payload_size = ntohl(nsize);
+
+        /* the empty chunk terminates a stream. */
+        if (SSOCK_DATA_TYPE_DATA_STREAM == type && 0 == payload_size)
+        {
+            break;
+        }
+
+        /* pass the payload to the callback as it arrives. */
+        retval = ssock_read_data_stream_payload(
+            sock, buf, buf_size, payload_size, onchunk, context, size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+    } while (SSOCK_DATA_TYPE_DATA_STREAM == type);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read exactly the given number of bytes, tolerating short reads.
+ *
+ * \param sock          The socket from which data is read.
+ * \param buf           The buffer to read into.
+ * \param size          The number of bytes to read.
+ *
+ * \returns A status code indicating success or failure.
+ */
+static int ssock_read_data_stream_exact(ssock* sock, void* buf, size_t size)
+{
+    uint8_t* out = (uint8_t*)buf;
+
+    while (size > 0)
+    {
+        size_t read_size = size;
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, out, &read_size) || 0 == read_size || read_size > size)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+
+        out += read_size;
+        size -= read_size;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read a payload of the given size, passing each chunk to the callback.
+ *
+ * \param sock          The socket from which data is read.
+ * \param buf           The chunk buffer.
+ * \param buf_size      The size of the chunk buffer.
+ * \param payload_size  The size of the payload to read.
+ * \param onchunk       The chunk callback.
+ * \param context       The user context for the callback.
+ * \param size          The running total of payload bytes read.
+ *
+ * \returns A status code indicating success or failure.
+ */
+static int ssock_read_data_stream_payload(
+    ssock* sock, void* buf, size_t buf_size, uint32_t payload_size,
+    ssock_data_chunk_fn onchunk, void* context, uint64_t* size)
+{
+    int retval;
+    size_t remaining = payload_size;
+
+    while (remaining > 0)
+    {
+        /* read as much as has arrived, up to the size of the buffer. */
+        size_t read_size = remaining < buf_size ? remaining : buf_size;
+        size_t want_size = read_size;
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, buf, &read_size) || 0 == read_size || read_size > want_size)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+
+        /* hand this chunk to the callback. */
+        retval = onchunk(context, buf, read_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        remaining -= read_size;
+        *size += read_size;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
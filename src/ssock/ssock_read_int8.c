@@ -52,7 +52,7 @@ int ssock_read_int8(ssock* sock, int8_t* val)
         return VCBLOCKCHAIN_ERROR_SSOCK_READ;
     }
 
-    /* verify that the type is SSOCK_DATA_TYPE_UINT8. */
+    /* verify that the type is SSOCK_DATA_TYPE_INT8. */
     if (SSOCK_DATA_TYPE_INT8 != type)
     {
         return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
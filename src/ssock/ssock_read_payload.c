@@ -0,0 +1,108 @@
+/**
+ * \file ssock/ssock_read_payload.c
+ *
+ * \brief Allocate and read a packet payload according to the read policy.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/error_codes.h>
+
+#include "ssock_internal.h"
+
+/**
+ * \brief Allocate a payload buffer and read the payload into it, following the
+ * read policy of the socket.
+ *
+ * In grow mode, the buffer starts small and doubles as payload bytes arrive,
+ * so that a peer which claims a large payload but does not send it can't pin
+ * memory.  Short reads are tolerated; an empty read is treated as a failure.
+ *
+ * \param sock          The socket from which the payload is read.
+ * \param alloc_opts    The allocator to use for the payload buffer.
+ * \param size          The payload size claimed by the peer.
+ * \param extra         The number of extra bytes to allocate past the end of
+ *                      the payload (e.g. for an ASCIIZ terminator).
+ * \param val           Pointer to receive the payload buffer on success.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_READ if a read on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_read_payload(
+    ssock* sock, allocator_options_t* alloc_opts, uint32_t size, size_t extra,
+    void** val)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != val);
+
+    /* by default, allocate the whole payload up front. */
+    size_t capacity = size;
+
+    /* in grow mode, start with the initial size. */
+    if (SSOCK_READ_ALLOC_GROW == sock->read_policy.alloc_mode)
+    {
+        size_t initial =
+            0 == sock->read_policy.grow_initial_size
+                ? SSOCK_DEFAULT_GROW_INITIAL_SIZE
+                : sock->read_policy.grow_initial_size;
+
+        if (capacity > initial)
+        {
+            capacity = initial;
+        }
+    }
+
+    /* attempt to allocate memory for this payload. */
+    uint8_t* buf = (uint8_t*)allocate(alloc_opts, capacity + extra);
+    if (NULL == buf)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    size_t offset = 0;
+    while (offset < size)
+    {
+        /* grow the buffer once the bytes received so far have filled it. */
+        if (offset == capacity)
+        {
+            size_t new_capacity = capacity * 2;
+            if (new_capacity > size)
+            {
+                new_capacity = size;
+            }
+
+            uint8_t* new_buf = (uint8_t*)
+                reallocate(
+                    alloc_opts, buf, capacity + extra, new_capacity + extra);
+            if (NULL == new_buf)
+            {
+                release(alloc_opts, buf);
+                return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+            }
+
+            buf = new_buf;
+            capacity = new_capacity;
+        }
+
+        /* attempt to read the next part of the payload. */
+        size_t read_size = capacity - offset;
+        size_t want_size = read_size;
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, buf + offset, &read_size) || 0 == read_size || read_size > want_size)
+        {
+            release(alloc_opts, buf);
+            return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        }
+
+        offset += read_size;
+    }
+
+    /* success. */
+    *val = buf;
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -11,12 +11,16 @@
 #include <vcblockchain/error_codes.h>
 #include <vcblockchain/ssock.h>
 
+#include "ssock_internal.h"
+
 /**
  * \brief Read a character string from the socket.
  *
  * On success, a character string value is allocated and read, along with type
  * information and size.  The caller owns this character string and is
  * responsible for releasing it to the allocator it when it is no longer in use.
+ * The maximum size and allocation mode are set by the read policy of this
+ * socket.
  *
  * \param sock          The \ref ssock socket from which data is read.
  * \param alloc_opts    The allocator options to use for this read.
@@ -74,26 +78,18 @@ int ssock_read_string(ssock* sock, allocator_options_t* alloc_opts, char** val)
     /* convert the size to host byte order. */
     size = ntohl(nsize);
 
-    /* cap the maximum string size at 10 MB. */
-    if (size > (10 * 1024 * 1024))
+    /* cap the maximum string size according to the read policy. */
+    if (size > ssock_policy_max_string_size(sock))
     {
         return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
     }
 
-    /* attempt to allocate memory for this string. */
-    *val = (char*)allocate(alloc_opts, size + 1);
-    if (NULL == *val)
+    /* attempt to allocate memory for and read the string. */
+    int retval = ssock_read_payload(sock, alloc_opts, size, 1, (void**)val);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
     {
-        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
-    }
-
-    /* attempt to read the string. */
-    size_t size_size = size;
-    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read(sock, *val, &size_size) || size != size_size)
-    {
-        release(alloc_opts, *val);
         *val = NULL;
-        return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+        return retval;
     }
 
     /* set the asciiz. */
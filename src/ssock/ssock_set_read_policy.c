@@ -0,0 +1,50 @@
+/**
+ * \file ssock/ssock_set_read_policy.c
+ *
+ * \brief Set the read policy for a ssock instance.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Set the read policy for a ssock instance.
+ *
+ * The read policy bounds the string and data packet sizes accepted from the
+ * peer, and selects whether payload buffers are allocated up front or grown as
+ * payload bytes arrive.  The policy is copied into the ssock instance.
+ *
+ * \param sock              The ssock instance to update.
+ * \param policy            The read policy for this instance.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int ssock_set_read_policy(ssock* sock, const ssock_read_policy* policy)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != policy);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == policy)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* verify the allocation mode. */
+    if (SSOCK_READ_ALLOC_UPFRONT != policy->alloc_mode && SSOCK_READ_ALLOC_GROW != policy->alloc_mode)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* copy the policy. */
+    memcpy(&sock->read_policy, policy, sizeof(ssock_read_policy));
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,41 @@
+/**
+ * \file src/ssock/ssock_shutdown.c
+ *
+ * \brief Shut down reading and writing on a ssock instance.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Shut down reading and writing on a ssock instance.
+ *
+ * A read or write blocked on this instance, or made after this call, returns
+ * instead of waiting on the peer; a read reports end of stream.  For a filter
+ * chain, the shutdown is passed down to the innermost ssock.  An ssock
+ * instance which can't be woken treats this as a no-op.  The instance must
+ * still be disposed.
+ *
+ * \param sock      The ssock instance to shut down.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - a non-zero error code on failure.
+ */
+int ssock_shutdown(ssock* sock)
+{
+    MODEL_ASSERT(NULL != sock);
+
+    /* runtime sanity check on parameters. */
+    if (NULL == sock)
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+
+    /* a socket which can't be woken has nothing to shut down. */
+    if (NULL == sock->shutdown)
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+    return sock->shutdown(sock);
+}
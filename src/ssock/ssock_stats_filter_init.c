@@ -0,0 +1,144 @@
+/**
+ * \file src/ssock/ssock_stats_filter_init.c
+ *
+ * \brief Initialize a counting filter ssock which wraps an inner ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/ssock.h>
+
+/* forward decls. */
+static int ssock_stats_filter_read(ssock*, void*, size_t*);
+static int ssock_stats_filter_write(ssock*, const void*, size_t*);
+static int ssock_stats_filter_writev(
+    ssock*, const ssock_iovec*, size_t, size_t*);
+
+/**
+ * \brief Initialize a counting filter ssock which wraps an inner ssock.
+ *
+ * The byte and call counts of reads and writes on the inner ssock are added to
+ * the given \ref ssock_stats structure, which is owned by the caller and must
+ * outlive this instance.  Placing this filter below a buffering filter counts
+ * the calls which reach the network.  The stats are also attached to this
+ * instance, and inherited by filters layered above it, so that data packets
+ * written or read through the chain report their compression counters here.
+ * This instance takes ownership of the inner ssock.
+ *
+ * \param sock              The ssock instance to initialize.
+ * \param inner             The ssock instance to wrap.
+ * \param stats             The counters to update.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int ssock_stats_filter_init(ssock* sock, ssock* inner, ssock_stats* stats)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != inner);
+    MODEL_ASSERT(NULL != stats);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == inner || NULL == stats)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* start with a pass-through filter. */
+    retval = ssock_filter_init(sock, inner);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* observe reads and writes. */
+    sock->read = &ssock_stats_filter_read;
+    sock->write = &ssock_stats_filter_write;
+    sock->writev = &ssock_stats_filter_writev;
+    sock->context = stats;
+    sock->stats = stats;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read from the inner socket, counting the bytes read.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to read into.
+ * \param size      On input, the number of bytes to read; on output, the number
+ *                  of bytes read.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_stats_filter_read(ssock* sock, void* buf, size_t* size)
+{
+    ssock_stats* stats = (ssock_stats*)sock->context;
+
+    int retval = sock->inner->read(sock->inner, buf, size);
+
+    ++stats->read_calls;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        stats->bytes_read += *size;
+    }
+
+    return retval;
+}
+
+/**
+ * \brief Write to the inner socket, counting the bytes written.
+ *
+ * \param sock      The filter socket.
+ * \param buf       The buffer to write from.
+ * \param size      On input, the number of bytes to write; on output, the
+ *                  number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_stats_filter_write(ssock* sock, const void* buf, size_t* size)
+{
+    ssock_stats* stats = (ssock_stats*)sock->context;
+
+    int retval = sock->inner->write(sock->inner, buf, size);
+
+    ++stats->write_calls;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        stats->bytes_written += *size;
+    }
+
+    return retval;
+}
+
+/**
+ * \brief Write several buffers to the inner socket, counting them as one call.
+ *
+ * \param sock      The filter socket.
+ * \param iov       The buffers to write.
+ * \param iovcnt    The number of buffers.
+ * \param size      On output, the number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ */
+static int ssock_stats_filter_writev(
+    ssock* sock, const ssock_iovec* iov, size_t iovcnt, size_t* size)
+{
+    ssock_stats* stats = (ssock_stats*)sock->context;
+
+    int retval = ssock_writev(sock->inner, iov, iovcnt, size);
+
+    ++stats->write_calls;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+    {
+        stats->bytes_written += *size;
+    }
+
+    return retval;
+}
@@ -0,0 +1,117 @@
+/**
+ * \file ssock/ssock_write_compressed_data.c
+ *
+ * \brief Attempt to write a data packet as a compressed data packet.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/error_codes.h>
+
+#include "ssock_internal.h"
+
+/* the compressed packet header: type, size, and decompressed size. */
+#define SSOCK_COMPRESSED_HEADER_SIZE (SSOCK_PACKET_HEADER_SIZE + 4)
+
+/**
+ * \brief Attempt to write a data packet as a compressed data packet.
+ *
+ * The packet is only written if compression makes it smaller.
+ *
+ * \param sock          The socket to which the packet is written.
+ * \param val           The payload to write.
+ * \param size          The size of the payload.
+ * \param written       Set to 1 if the packet was written, or 0 if the caller
+ *                      should write it uncompressed instead.
+ *
+ * \returns A status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if a write on the socket failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int ssock_write_compressed_data(
+    ssock* sock, const void* val, uint32_t size, int* written)
+{
+    uint64_t start = 0;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != sock->compression.alloc_opts);
+    MODEL_ASSERT(NULL != val);
+    MODEL_ASSERT(NULL != written);
+
+    *written = 0;
+
+    /* compression is only worthwhile if the packet gets smaller. */
+    if (size <= SSOCK_COMPRESSED_HEADER_SIZE)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    size_t max_compressed_size = size - SSOCK_COMPRESSED_HEADER_SIZE;
+
+    /* allocate the packet buffer, so that the packet is a single write. */
+    uint8_t* packet = (uint8_t*)
+        allocate(
+            sock->compression.alloc_opts,
+            SSOCK_COMPRESSED_HEADER_SIZE + max_compressed_size);
+    if (NULL == packet)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (NULL != sock->stats)
+    {
+        start = ssock_clock_nanoseconds();
+    }
+
+    /* attempt to compress the payload. */
+    size_t compressed_size =
+        ssock_lz_compress(
+            (const uint8_t*)val, size, packet + SSOCK_COMPRESSED_HEADER_SIZE,
+            max_compressed_size);
+
+    if (NULL != sock->stats)
+    {
+        sock->stats->compress_nanoseconds += ssock_clock_nanoseconds() - start;
+    }
+
+    /* fall back to an uncompressed packet if this did not help. */
+    if (0 == compressed_size)
+    {
+        release(sock->compression.alloc_opts, packet);
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    /* write the header. */
+    uint32_t packet_size = htonl((uint32_t)(sizeof(uint32_t) + compressed_size));
+    uint32_t decompressed_size = htonl(size);
+    packet[0] = SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET;
+    memcpy(packet + 1, &packet_size, sizeof(packet_size));
+    memcpy(packet + SSOCK_PACKET_HEADER_SIZE, &decompressed_size, sizeof(decompressed_size));
+
+    /* attempt to write the packet. */
+    size_t write_size = SSOCK_COMPRESSED_HEADER_SIZE + compressed_size;
+    size_t expected_size = write_size;
+    int retval = ssock_write(sock, packet, &write_size);
+    release(sock->compression.alloc_opts, packet);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval || expected_size != write_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    if (NULL != sock->stats)
+    {
+        sock->stats->compressed_packets += 1;
+        sock->stats->compress_bytes_in += size;
+        sock->stats->compress_bytes_out += compressed_size;
+    }
+
+    /* success. */
+    *written = 1;
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
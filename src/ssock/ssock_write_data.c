@@ -10,11 +10,15 @@
 #include <vcblockchain/byteswap.h>
 #include <vcblockchain/ssock.h>
 
+#include "ssock_internal.h"
+
 /**
  * \brief Write a data packet.
  *
  * On success, the data packet value will be written, along with type
- * information and size.
+ * information and size.  If compression was negotiated for this socket and the
+ * payload is at least the compression threshold, it is sent as a compressed
+ * data packet when this makes it smaller.
  *
  * \param sock          The \ref ssock socket to which data is written.
  * \param val           The data to write.
@@ -24,6 +28,8 @@
  *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
  *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
  *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
  */
 int ssock_write_data(ssock* sock, const void* val, uint32_t size)
 {
@@ -37,27 +43,27 @@ int ssock_write_data(ssock* sock, const void* val, uint32_t size)
         return VCBLOCKCHAIN_ERROR_INVALID_ARG;
     }
 
-    uint8_t typeval = SSOCK_DATA_TYPE_DATA_PACKET;
-
-    /* attempt to write the type to the socket. */
-    size_t type_size = sizeof(typeval);
-    if (VCBLOCKCHAIN_STATUS_SUCCESS !=
-        ssock_write(sock, &typeval, &type_size))
+    /* compress the payload if this was negotiated and is worthwhile. */
+    if (SSOCK_COMPRESSION_NONE != sock->compression.codec && size >= ssock_compression_threshold(sock))
     {
-        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        int written = 0;
+        int retval = ssock_write_compressed_data(sock, val, size, &written);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval || written)
+        {
+            return retval;
+        }
     }
 
-    /* attempt to write the length of this data packet to the socket. */
+    uint8_t typeval = SSOCK_DATA_TYPE_DATA_PACKET;
     uint32_t hlen = htonl(size);
-    size_t hlen_size = sizeof(hlen);
-    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_write(sock, &hlen, &hlen_size))
-    {
-        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
-    }
 
-    /* attempt to write the data to the socket. */
-    size_t write_size = size;
-    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_write(sock, val, &write_size))
+    /* write the type, length, and data as a single gathered write. */
+    ssock_iovec iov[3] = {
+        { &typeval, sizeof(typeval) },
+        { &hlen, sizeof(hlen) },
+        { val, size } };
+    size_t write_size = 0;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_writev(sock, iov, 3, &write_size) || sizeof(typeval) + sizeof(hlen) + size != write_size)
     {
         return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
     }
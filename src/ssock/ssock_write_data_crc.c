@@ -0,0 +1,69 @@
+/**
+ * \file ssock/ssock_write_data_crc.c
+ *
+ * \brief Write a checksummed data packet to a socket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/crc32c.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Write a checksummed data packet.
+ *
+ * The packet is a data packet followed by the CRC32C of its header and
+ * payload, which lets the peer detect corruption without the cost of an
+ * authenticated packet.  The header, payload, and checksum are written with a
+ * single gathered write.  This detects accidental corruption only; it offers
+ * no protection against tampering.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The data to write.
+ * \param size          The size of the data to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_crc(ssock* sock, const void* val, uint32_t size)
+{
+    uint8_t header[SSOCK_PACKET_HEADER_SIZE];
+
+    /* parameter sanity check. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != val);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == val)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* build the header. */
+    uint32_t hlen = htonl(size);
+    header[0] = SSOCK_DATA_TYPE_CRC_DATA_PACKET;
+    memcpy(header + 1, &hlen, sizeof(hlen));
+
+    /* checksum the header and the payload. */
+    uint32_t crc = crc32c(0, header, sizeof(header));
+    crc = htonl(crc32c(crc, val, size));
+
+    /* write the header, payload, and checksum as a single gathered write. */
+    ssock_iovec iov[3] = {
+        { header, sizeof(header) },
+        { val, size },
+        { &crc, sizeof(crc) } };
+    size_t write_size = 0;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_writev(sock, iov, 3, &write_size) || sizeof(header) + size + sizeof(crc) != write_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
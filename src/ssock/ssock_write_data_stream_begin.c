@@ -0,0 +1,51 @@
+/**
+ * \file ssock/ssock_write_data_stream_begin.c
+ *
+ * \brief Begin writing a data stream packet to a socket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Begin writing a data stream packet of unknown length.
+ *
+ * A data stream packet consists of the data stream type, followed by any number
+ * of chunks written with \ref ssock_write_data_stream_chunk(), and terminated
+ * by \ref ssock_write_data_stream_end().  No other packets may be written to
+ * the socket until the stream is terminated.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_stream_begin(ssock* sock)
+{
+    /* parameter sanity check. */
+    MODEL_ASSERT(NULL != sock);
+
+    /* runtime parameter checks. */
+    if (NULL == sock)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    uint8_t typeval = SSOCK_DATA_TYPE_DATA_STREAM;
+
+    /* attempt to write the type to the socket. */
+    size_t type_size = sizeof(typeval);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS !=
+            ssock_write(sock, &typeval, &type_size) ||
+        sizeof(typeval) != type_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
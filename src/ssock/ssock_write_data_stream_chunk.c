@@ -0,0 +1,63 @@
+/**
+ * \file ssock/ssock_write_data_stream_chunk.c
+ *
+ * \brief Write a chunk of a data stream packet to a socket.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Write a chunk of a data stream packet.
+ *
+ * Each chunk is written with its size.  Writing an empty chunk is a no-op,
+ * since the empty chunk is reserved to terminate the stream.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The chunk data to write.
+ * \param size          The size of the chunk data to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_stream_chunk(ssock* sock, const void* val, uint32_t size)
+{
+    /* parameter sanity check. */
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != val);
+
+    /* runtime parameter checks. */
+    if (NULL == sock || NULL == val)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* an empty chunk would terminate the stream, so skip it. */
+    if (0 == size)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    /* attempt to write the length of this chunk to the socket. */
+    uint32_t hlen = htonl(size);
+    size_t hlen_size = sizeof(hlen);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_write(sock, &hlen, &hlen_size) || sizeof(hlen) != hlen_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* attempt to write the chunk to the socket. */
+    size_t write_size = size;
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_write(sock, val, &write_size) || size != write_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,43 @@
+/**
+ * \file ssock/ssock_write_data_stream_end.c
+ *
+ * \brief Terminate a data stream packet.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Terminate a data stream packet.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_data_stream_end(ssock* sock)
+{
+    /* parameter sanity check. */
+    MODEL_ASSERT(NULL != sock);
+
+    /* runtime parameter checks. */
+    if (NULL == sock)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* the stream is terminated by an empty chunk. */
+    uint32_t hlen = 0U;
+    size_t hlen_size = sizeof(hlen);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_write(sock, &hlen, &hlen_size) || sizeof(hlen) != hlen_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -34,7 +34,7 @@ int ssock_write_int8(ssock* sock, int8_t val)
         return VCBLOCKCHAIN_ERROR_INVALID_ARG;
     }
 
-    uint8_t typeval = SSOCK_DATA_TYPE_UINT8;
+    uint8_t typeval = SSOCK_DATA_TYPE_INT8;
 
     /* attempt to write the type to the socket. */
     size_t typeval_size = sizeof(typeval);
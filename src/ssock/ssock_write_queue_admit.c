@@ -0,0 +1,93 @@
+/**
+ * \file ssock/ssock_write_queue_admit.c
+ *
+ * \brief Admit a producer to a write queue, applying flow control.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Admit a producer to a write queue, applying flow control.
+ *
+ * If the queue is unwritable, this waits up to the block timeout for it to
+ * become writable, and sheds the peer once the slow consumer timeout passes.
+ *
+ * \param queue         The write queue.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the producer may enqueue.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL if the queue stayed
+ *        unwritable for the block timeout.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed.
+ */
+int ssock_write_queue_admit(ssock_write_queue* queue)
+{
+    uint64_t deadline = 0;
+
+    MODEL_ASSERT(NULL != queue);
+
+    /* an unbounded queue admits everyone. */
+    if (0 == queue->flow.high_watermark)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    for (;;)
+    {
+        if (__atomic_load_n(&queue->shed, __ATOMIC_ACQUIRE))
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER;
+        }
+
+        if (__atomic_load_n(&queue->writable, __ATOMIC_ACQUIRE))
+        {
+            return VCBLOCKCHAIN_STATUS_SUCCESS;
+        }
+
+        uint64_t now = ssock_clock_nanoseconds();
+        if (ssock_write_queue_is_slow(queue, now))
+        {
+            ssock_write_queue_shed(queue);
+            continue;
+        }
+
+        if (0 == deadline)
+        {
+            deadline = now + (uint64_t)queue->flow.block_timeout_ms * 1000000ULL;
+        }
+
+        if (now >= deadline)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL;
+        }
+
+        /* wake up in time to shed a slow consumer. */
+        uint64_t wake = deadline;
+        if (0 != queue->flow.slow_consumer_ms)
+        {
+            uint64_t slow =
+                __atomic_load_n(&queue->unwritable_since, __ATOMIC_ACQUIRE)
+                    + (uint64_t)queue->flow.slow_consumer_ms * 1000000ULL;
+            if (slow < wake)
+            {
+                wake = slow;
+            }
+        }
+
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wake / 1000000000ULL);
+        ts.tv_nsec = (long)(wake % 1000000000ULL);
+
+        /* the flusher and the shedder broadcast under the lock. */
+        pthread_mutex_lock(&queue->lock);
+        if (!__atomic_load_n(&queue->writable, __ATOMIC_ACQUIRE) && !__atomic_load_n(&queue->shed, __ATOMIC_ACQUIRE))
+        {
+            pthread_cond_timedwait(&queue->cond, &queue->lock, &ts);
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+}
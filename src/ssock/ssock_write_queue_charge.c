@@ -0,0 +1,43 @@
+/**
+ * \file ssock/ssock_write_queue_charge.c
+ *
+ * \brief Account for frame bytes added to a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Account for frame bytes added to a write queue, making it
+ * unwritable if they reach the high watermark.
+ *
+ * \param queue         The write queue.
+ * \param size          The number of frame bytes added.
+ */
+void ssock_write_queue_charge(ssock_write_queue* queue, size_t size)
+{
+    MODEL_ASSERT(NULL != queue);
+
+    size_t queued =
+        __atomic_add_fetch(&queue->queued_bytes, size, __ATOMIC_ACQ_REL);
+
+    if (0 == queue->flow.high_watermark || queued < queue->flow.high_watermark || !__atomic_load_n(&queue->writable, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    /* the clock is published before the flag, so readers never see a stale
+     * clock for an unwritable queue. */
+    __atomic_store_n(
+        &queue->unwritable_since, ssock_clock_nanoseconds(), __ATOMIC_RELEASE);
+
+    uint8_t expected = 1;
+    if (__atomic_compare_exchange_n(&queue->writable, &expected, 0, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) && NULL != queue->flow.on_event)
+    {
+        queue->flow.on_event(
+            queue, SSOCK_WRITE_QUEUE_EVENT_UNWRITABLE, queue->flow.context);
+    }
+}
@@ -0,0 +1,49 @@
+/**
+ * \file ssock/ssock_write_queue_credit.c
+ *
+ * \brief Account for frame bytes removed from a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Account for frame bytes removed from a write queue, making it
+ * writable if they fall to the low watermark.  Flusher only.
+ *
+ * \param queue         The write queue.
+ * \param size          The number of frame bytes removed.
+ */
+void ssock_write_queue_credit(ssock_write_queue* queue, size_t size)
+{
+    MODEL_ASSERT(NULL != queue);
+
+    size_t queued =
+        __atomic_sub_fetch(&queue->queued_bytes, size, __ATOMIC_ACQ_REL);
+
+    if (0 == queue->flow.high_watermark || queued > queue->flow.low_watermark || __atomic_load_n(&queue->writable, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    /* a shed queue never becomes writable again. */
+    if (__atomic_load_n(&queue->shed, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    /* only the flusher makes a queue writable, so this can't race. */
+    pthread_mutex_lock(&queue->lock);
+    __atomic_store_n(&queue->writable, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+
+    if (NULL != queue->flow.on_event)
+    {
+        queue->flow.on_event(
+            queue, SSOCK_WRITE_QUEUE_EVENT_WRITABLE, queue->flow.context);
+    }
+}
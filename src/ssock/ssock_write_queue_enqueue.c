@@ -0,0 +1,69 @@
+/**
+ * \file ssock/ssock_write_queue_enqueue.c
+ *
+ * \brief Enqueue a complete frame on a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Enqueue a complete, already encoded frame.  Thread-safe.
+ *
+ * The bytes are copied, so the caller may reuse its buffer immediately.
+ *
+ * \param queue             The write queue.
+ * \param frame             The encoded frame.
+ * \param size              The size of the frame.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL if the queue stayed
+ *        unwritable for the flow control block timeout.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed as a
+ *        slow consumer.
+ */
+int ssock_write_queue_enqueue(
+    ssock_write_queue* queue, const void* frame, size_t size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != queue);
+    MODEL_ASSERT(NULL != frame || 0 == size);
+
+    /* runtime parameter checks. */
+    if (NULL == queue || (NULL == frame && size > 0) || 0 == size)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* apply backpressure before allocating anything. */
+    int retval = ssock_write_queue_admit(queue);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* the frame bytes follow the node header in one allocation. */
+    ssock_write_frame* node = (ssock_write_frame*)
+        allocate(queue->alloc_opts, sizeof(ssock_write_frame) + size);
+    if (NULL == node)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    node->size = size;
+    memcpy(node + 1, frame, size);
+
+    ssock_write_queue_charge(queue, size);
+    ssock_write_queue_push(queue, node);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
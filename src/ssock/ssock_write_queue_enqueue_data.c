@@ -0,0 +1,80 @@
+/**
+ * \file ssock/ssock_write_queue_enqueue_data.c
+ *
+ * \brief Enqueue a data packet on a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/byteswap.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Enqueue a data packet.  Thread-safe.
+ *
+ * The packet header and payload are encoded into a single frame.  The packet is
+ * always sent uncompressed.
+ *
+ * \param queue             The write queue.
+ * \param val               The payload of the data packet.
+ * \param size              The size of the payload.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL if the queue stayed
+ *        unwritable for the flow control block timeout.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed as a
+ *        slow consumer.
+ */
+int ssock_write_queue_enqueue_data(
+    ssock_write_queue* queue, const void* val, uint32_t size)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != queue);
+    MODEL_ASSERT(NULL != val || 0 == size);
+
+    /* runtime parameter checks. */
+    if (NULL == queue || (NULL == val && size > 0))
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* apply backpressure before allocating anything. */
+    int retval = ssock_write_queue_admit(queue);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    /* encode the packet directly into the node. */
+    size_t frame_size = SSOCK_PACKET_HEADER_SIZE + (size_t)size;
+    ssock_write_frame* node = (ssock_write_frame*)
+        allocate(queue->alloc_opts, sizeof(ssock_write_frame) + frame_size);
+    if (NULL == node)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint8_t* buf = (uint8_t*)(node + 1);
+    uint32_t hlen = htonl(size);
+    buf[0] = SSOCK_DATA_TYPE_DATA_PACKET;
+    memcpy(buf + 1, &hlen, sizeof(hlen));
+    if (size > 0)
+    {
+        memcpy(buf + SSOCK_PACKET_HEADER_SIZE, val, size);
+    }
+
+    node->size = frame_size;
+
+    ssock_write_queue_charge(queue, frame_size);
+    ssock_write_queue_push(queue, node);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/**
+ * \file ssock/ssock_write_queue_flush.c
+ *
+ * \brief Write every queued frame to the ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/* forward decls. */
+static int ssock_write_queue_write_batch(
+    ssock* sock, ssock_iovec* iov, size_t iovcnt);
+static void ssock_write_queue_discard(ssock_write_queue* queue);
+
+/**
+ * \brief Write every frame currently in the queue to the ssock.
+ *
+ * Only one thread may flush a queue.  Frames are gathered into vectored
+ * writes of up to \ref SSOCK_WRITE_QUEUE_BATCH_MAX frames, and the ssock is
+ * flushed once the queue is drained.  A frame whose producer is still linking
+ * it into the queue is left for the next flush.
+ *
+ * \param queue             The write queue.
+ * \param frames            Optional pointer to receive the number of frames
+ *                          written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing to the ssock failed.  The
+ *        frames of the failed batch are discarded.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed as a
+ *        slow consumer.  Queued frames are discarded, and the caller should
+ *        disconnect the peer.
+ */
+int ssock_write_queue_flush(ssock_write_queue* queue, size_t* frames)
+{
+    ssock_write_frame* batch[SSOCK_WRITE_QUEUE_BATCH_MAX];
+    ssock_iovec iov[SSOCK_WRITE_QUEUE_BATCH_MAX];
+    size_t written = 0;
+    int retval = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != queue);
+
+    /* runtime parameter checks. */
+    if (NULL == queue)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    for (;;)
+    {
+        /* a slow consumer gets nothing more. */
+        if (ssock_write_queue_is_slow(queue, ssock_clock_nanoseconds()))
+        {
+            ssock_write_queue_shed(queue);
+        }
+
+        if (__atomic_load_n(&queue->shed, __ATOMIC_ACQUIRE))
+        {
+            ssock_write_queue_discard(queue);
+            retval = VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER;
+            goto done;
+        }
+
+        /* gather the next batch of frames. */
+        size_t count = 0;
+        size_t bytes = 0;
+        while (count < SSOCK_WRITE_QUEUE_BATCH_MAX)
+        {
+            ssock_write_frame* frame = ssock_write_queue_pop(queue);
+            if (NULL == frame)
+                break;
+
+            batch[count] = frame;
+            iov[count].base = frame + 1;
+            iov[count].size = frame->size;
+            bytes += frame->size;
+            ++count;
+        }
+
+        if (0 == count)
+            break;
+
+        retval = ssock_write_queue_write_batch(queue->sock, iov, count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            release(queue->alloc_opts, batch[i]);
+        }
+
+        ssock_write_queue_credit(queue, bytes);
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            goto done;
+
+        written += count;
+    }
+
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_flush(queue->sock))
+    {
+        retval = VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        goto done;
+    }
+
+done:
+    if (NULL != frames)
+    {
+        *frames = written;
+    }
+
+    return retval;
+}
+
+/**
+ * \brief Write a batch of frames, resuming after short writes.
+ *
+ * \param sock          The ssock to write to.
+ * \param iov           The frames to write; adjusted in place as bytes are
+ *                      written.
+ * \param iovcnt        The number of frames.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if the ssock failed or stalled.
+ */
+static int ssock_write_queue_write_batch(
+    ssock* sock, ssock_iovec* iov, size_t iovcnt)
+{
+    size_t index = 0;
+
+    while (index < iovcnt)
+    {
+        size_t write_size = 0;
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_writev(sock, iov + index, iovcnt - index, &write_size) || 0 == write_size)
+        {
+            return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+        }
+
+        /* skip the frames that were written in full. */
+        while (index < iovcnt && write_size >= iov[index].size)
+        {
+            write_size -= iov[index].size;
+            ++index;
+        }
+
+        /* resume a partially written frame. */
+        if (write_size > 0)
+        {
+            iov[index].base = (const uint8_t*)iov[index].base + write_size;
+            iov[index].size -= write_size;
+        }
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Release every frame in the queue without writing it.
+ *
+ * \param queue         The write queue.
+ */
+static void ssock_write_queue_discard(ssock_write_queue* queue)
+{
+    ssock_write_frame* frame;
+
+    while (NULL != (frame = ssock_write_queue_pop(queue)))
+    {
+        ssock_write_queue_credit(queue, frame->size);
+        release(queue->alloc_opts, frame);
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * \file ssock/ssock_write_queue_init.c
+ *
+ * \brief Initialize a write queue for sharing one ssock between producers.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_write_queue_internal.h"
+
+/* forward decls. */
+static void ssock_write_queue_dispose(void* disposable);
+
+/**
+ * \brief Initialize a write queue for the given ssock.
+ *
+ * The queue does not take ownership of the ssock.  Once a queue is in use,
+ * only its flusher may write to the ssock.  This instance is disposable and
+ * must be disposed by calling \ref dispose() when no longer needed.  Frames
+ * that have not been flushed are discarded when it is disposed.
+ *
+ * \param queue             The write queue to initialize.
+ * \param alloc_opts        The allocator to use for queued frames.
+ * \param sock              The ssock to which frames are written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the queue's synchronization
+ *        primitives could not be created.
+ */
+int ssock_write_queue_init(
+    ssock_write_queue* queue, allocator_options_t* alloc_opts, ssock* sock)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != queue);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(NULL != sock);
+
+    /* runtime parameter checks. */
+    if (NULL == queue || NULL == alloc_opts || NULL == sock)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(queue, 0, sizeof(ssock_write_queue));
+    queue->hdr.dispose = &ssock_write_queue_dispose;
+    queue->alloc_opts = alloc_opts;
+    queue->sock = sock;
+
+    /* an empty queue holds only the stub. */
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
+
+    /* flow control is off until it is configured. */
+    queue->writable = 1;
+
+    /* producers park on the monotonic clock. */
+    pthread_condattr_t attr;
+    if (0 != pthread_condattr_init(&attr))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int cond_status = pthread_cond_init(&queue->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (0 != cond_status)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (0 != pthread_mutex_init(&queue->lock, NULL))
+    {
+        pthread_cond_destroy(&queue->cond);
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a write queue, releasing any unsent frames.
+ *
+ * \param disposable        The write queue to dispose.
+ */
+static void ssock_write_queue_dispose(void* disposable)
+{
+    ssock_write_queue* queue = (ssock_write_queue*)disposable;
+    ssock_write_frame* frame;
+
+    MODEL_ASSERT(NULL != queue);
+
+    while (NULL != (frame = ssock_write_queue_pop(queue)))
+    {
+        release(queue->alloc_opts, frame);
+    }
+
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->cond);
+
+    memset(queue, 0, sizeof(ssock_write_queue));
+}
@@ -0,0 +1,109 @@
+/**
+ * \file ssock/ssock_write_queue_internal.h
+ *
+ * \brief Internal helpers for the ssock write queue.
+ *
+ * These are kept apart from the other ssock helpers, since the write queue
+ * needs POSIX threads and is only built for the host.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_SSOCK_WRITE_QUEUE_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_SSOCK_WRITE_QUEUE_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/ssock_write_queue.h>
+
+#include "ssock_internal.h"
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief Link a frame onto the head of a write queue.  Thread-safe.
+ *
+ * \param queue         The write queue.
+ * \param frame         The frame to link.
+ */
+void ssock_write_queue_push(ssock_write_queue* queue, ssock_write_frame* frame);
+
+/**
+ * \brief Unlink the oldest frame from a write queue.  Flusher only.
+ *
+ * \param queue         The write queue.
+ *
+ * \returns the oldest frame, or NULL if the queue is empty or its oldest frame
+ * is still being linked by a producer.
+ */
+ssock_write_frame* ssock_write_queue_pop(ssock_write_queue* queue);
+
+/**
+ * \brief Admit a producer to a write queue, applying flow control.
+ *
+ * If the queue is unwritable, this waits up to the block timeout for it to
+ * become writable, and sheds the peer once the slow consumer timeout passes.
+ *
+ * \param queue         The write queue.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS if the producer may enqueue.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL if the queue stayed
+ *        unwritable for the block timeout.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER if the peer has been shed.
+ */
+int ssock_write_queue_admit(ssock_write_queue* queue);
+
+/**
+ * \brief Account for frame bytes added to a write queue, making it
+ * unwritable if they reach the high watermark.
+ *
+ * \param queue         The write queue.
+ * \param size          The number of frame bytes added.
+ */
+void ssock_write_queue_charge(ssock_write_queue* queue, size_t size);
+
+/**
+ * \brief Account for frame bytes removed from a write queue, making it
+ * writable if they fall to the low watermark.  Flusher only.
+ *
+ * \param queue         The write queue.
+ * \param size          The number of frame bytes removed.
+ */
+void ssock_write_queue_credit(ssock_write_queue* queue, size_t size);
+
+/**
+ * \brief Shed the peer of a write queue as a slow consumer, waking any
+ * producers waiting on it.
+ *
+ * \param queue         The write queue.
+ */
+void ssock_write_queue_shed(ssock_write_queue* queue);
+
+/**
+ * \brief Determine whether a write queue has been unwritable for longer than
+ * its slow consumer timeout.
+ *
+ * \param queue         The write queue.
+ * \param now           The monotonic clock in nanoseconds.
+ *
+ * \returns true if the peer should be shed, false otherwise.
+ */
+static inline int ssock_write_queue_is_slow(
+    ssock_write_queue* queue, uint64_t now)
+{
+    if (0 == queue->flow.slow_consumer_ms || __atomic_load_n(&queue->writable, __ATOMIC_ACQUIRE))
+        return 0;
+
+    uint64_t since = __atomic_load_n(&queue->unwritable_since, __ATOMIC_ACQUIRE);
+
+    return now - since >= (uint64_t)queue->flow.slow_consumer_ms * 1000000ULL;
+}
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_SSOCK_WRITE_QUEUE_INTERNAL_HEADER_GUARD*/
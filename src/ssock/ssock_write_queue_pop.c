@@ -0,0 +1,69 @@
+/**
+ * \file ssock/ssock_write_queue_pop.c
+ *
+ * \brief Unlink the oldest frame from a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Unlink the oldest frame from a write queue.  Flusher only.
+ *
+ * The stub frame keeps the queue from ever becoming empty, so that the last
+ * real frame can be unlinked without racing a producer for the head.  When the
+ * last frame is reached, the stub is pushed behind it before it is returned.
+ *
+ * \param queue         The write queue.
+ *
+ * \returns the oldest frame, or NULL if the queue is empty or its oldest frame
+ * is still being linked by a producer.
+ */
+ssock_write_frame* ssock_write_queue_pop(ssock_write_queue* queue)
+{
+    MODEL_ASSERT(NULL != queue);
+
+    ssock_write_frame* tail = queue->tail;
+    ssock_write_frame* next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+    /* skip over the stub. */
+    if (&queue->stub == tail)
+    {
+        if (NULL == next)
+        {
+            return NULL;
+        }
+
+        queue->tail = tail = next;
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+
+    /* the common case: the tail has a successor. */
+    if (NULL != next)
+    {
+        queue->tail = next;
+        return tail;
+    }
+
+    /* a producer has swapped the head but not linked it yet. */
+    if (tail != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    /* the tail is the last frame; put the stub behind it. */
+    ssock_write_queue_push(queue, &queue->stub);
+
+    next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    if (NULL != next)
+    {
+        queue->tail = next;
+        return tail;
+    }
+
+    /* a producer slipped in ahead of the stub; try again next time. */
+    return NULL;
+}
@@ -0,0 +1,35 @@
+/**
+ * \file ssock/ssock_write_queue_push.c
+ *
+ * \brief Link a frame onto the head of a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Link a frame onto the head of a write queue.  Thread-safe.
+ *
+ * The head is swapped first and the previous head linked to the frame second,
+ * so a push never waits on another producer.  Between the two steps the frame
+ * is unreachable from the tail, which the flusher sees as a momentarily empty
+ * queue.
+ *
+ * \param queue         The write queue.
+ * \param frame         The frame to link.
+ */
+void ssock_write_queue_push(ssock_write_queue* queue, ssock_write_frame* frame)
+{
+    MODEL_ASSERT(NULL != queue);
+    MODEL_ASSERT(NULL != frame);
+
+    __atomic_store_n(&frame->next, NULL, __ATOMIC_RELAXED);
+
+    ssock_write_frame* prev =
+        __atomic_exchange_n(&queue->head, frame, __ATOMIC_ACQ_REL);
+
+    __atomic_store_n(&prev->next, frame, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,55 @@
+/**
+ * \file ssock/ssock_write_queue_set_flow_control.c
+ *
+ * \brief Enable flow control on a write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Enable flow control on a write queue.
+ *
+ * Once the queued bytes reach the high watermark, the queue becomes
+ * unwritable, and stays so until the flusher drains it to the low watermark.
+ * While it is unwritable, an enqueue waits up to the block timeout for it to
+ * become writable, and otherwise fails, which pushes back on the producer
+ * instead of growing memory.  The watermark is soft: producers that were
+ * admitted before the queue became unwritable may overshoot it by one frame
+ * each.  If the queue stays unwritable for longer than the slow consumer
+ * timeout, the peer is shed: every later enqueue and flush fails, and the
+ * queued frames are discarded.  The slow consumer event is a good place to
+ * shut down the socket, so that a flush blocked on the peer returns.
+ *
+ * This must be called before the queue is shared between threads.
+ *
+ * \param queue             The write queue.
+ * \param options           The flow control options.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed,
+ *        including a low watermark above the high watermark.
+ */
+int ssock_write_queue_set_flow_control(
+    ssock_write_queue* queue, const ssock_write_queue_flow_options* options)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != queue);
+    MODEL_ASSERT(NULL != options);
+
+    /* runtime parameter checks. */
+    if (NULL == queue || NULL == options || options->low_watermark > options->high_watermark)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memcpy(&queue->flow, options, sizeof(ssock_write_queue_flow_options));
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,40 @@
+/**
+ * \file ssock/ssock_write_queue_shed.c
+ *
+ * \brief Shed the peer of a write queue as a slow consumer.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "ssock_write_queue_internal.h"
+
+/**
+ * \brief Shed the peer of a write queue as a slow consumer, waking any
+ * producers waiting on it.
+ *
+ * The slow consumer event is reported once, by whichever thread sheds first.
+ *
+ * \param queue         The write queue.
+ */
+void ssock_write_queue_shed(ssock_write_queue* queue)
+{
+    uint8_t expected = 0;
+
+    MODEL_ASSERT(NULL != queue);
+
+    pthread_mutex_lock(&queue->lock);
+    uint8_t first =
+        __atomic_compare_exchange_n(
+            &queue->shed, &expected, 1, 0, __ATOMIC_ACQ_REL,
+            __ATOMIC_ACQUIRE);
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+
+    if (first && NULL != queue->flow.on_event)
+    {
+        queue->flow.on_event(
+            queue, SSOCK_WRITE_QUEUE_EVENT_SLOW_CONSUMER, queue->flow.context);
+    }
+}
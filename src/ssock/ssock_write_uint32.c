@@ -0,0 +1,58 @@
+/**
+ * \file ssock/ssock_write_uint32.c
+ *
+ * \brief Write a uint32 value packet to a socket
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <vcblockchain/byteswap.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Write a uint32_t value to the socket.
+ *
+ * On success, the value is written, along with type information and size.
+ *
+ * \param sock          The \ref ssock socket to which data is written.
+ * \param val           The value to write.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_SSOCK_WRITE if writing data failed.
+ */
+int ssock_write_uint32(ssock* sock, uint32_t val)
+{
+    uint8_t packet[SSOCK_PACKET_HEADER_SIZE + sizeof(uint32_t)];
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != sock);
+
+    /* runtime parameter checks. */
+    if (NULL == sock)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* build the type, length, and value in a single packet buffer. */
+    uint32_t hlen = htonl(sizeof(val));
+    uint32_t oval = htonl(val);
+    packet[0] = SSOCK_DATA_TYPE_UINT32;
+    memcpy(packet + 1, &hlen, sizeof(hlen));
+    memcpy(packet + SSOCK_PACKET_HEADER_SIZE, &oval, sizeof(oval));
+
+    /* attempt to write the packet to the socket in one call. */
+    size_t packet_size = sizeof(packet);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS !=
+            ssock_write(sock, packet, &packet_size) ||
+        sizeof(packet) != packet_size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_WRITE;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
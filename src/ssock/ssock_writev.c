@@ -0,0 +1,61 @@
+/**
+ * \file src/ssock/ssock_writev.c
+ *
+ * \brief Write several buffers to a ssock instance as a single write.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <vcblockchain/ssock.h>
+
+/**
+ * \brief Write several buffers to a ssock instance as a single write.
+ *
+ * If the ssock instance supports gathered writes, such as a POSIX socket, then
+ * the buffers are written with a single system call.  Otherwise, each buffer
+ * is written in turn, stopping at the first short write.
+ *
+ * \param sock      The ssock instance to write to.
+ * \param iov       The array of buffers to write, in order.
+ * \param iovcnt    The number of buffers in this array.
+ * \param size      Pointer to receive the total number of bytes written.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - a non-zero error code on failure.
+ */
+int ssock_writev(
+    ssock* sock, const ssock_iovec* iov, size_t iovcnt, size_t* size)
+{
+    MODEL_ASSERT(NULL != sock);
+    MODEL_ASSERT(NULL != iov || 0 == iovcnt);
+    MODEL_ASSERT(NULL != size);
+
+    /* runtime sanity check on parameters. */
+    if (NULL == sock || (NULL == iov && iovcnt > 0) || NULL == size)
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+
+    /* use the gathered write method if there is one. */
+    if (NULL != sock->writev)
+        return sock->writev(sock, iov, iovcnt, size);
+
+    /* otherwise, write each buffer in turn. */
+    *size = 0;
+    for (size_t i = 0; i < iovcnt; ++i)
+    {
+        size_t write_size = iov[i].size;
+        int retval = sock->write(sock, iov[i].base, &write_size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+            return retval;
+
+        *size += write_size;
+
+        /* stop at a short write. */
+        if (iov[i].size != write_size)
+            break;
+    }
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/**
+ * \file src/thread_pool/thread_pool_init.c
+ *
+ * \brief Initialize a thread pool and start its workers.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "thread_pool_internal.h"
+
+/* forward decls. */
+static void thread_pool_dispose(void* disposable);
+
+/**
+ * \brief Initialize a thread pool and start its workers.
+ *
+ * This instance is disposable and must be disposed by calling \ref dispose()
+ * when no longer needed.  Disposing of the pool waits for running tasks, and
+ * discards tasks which have not started.
+ *
+ * \param pool          The pool to initialize.
+ * \param alloc_opts    The allocator to use for this pool.
+ * \param workers       The number of workers; 0 selects one per online core.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ *      - VCBLOCKCHAIN_ERROR_THREAD_POOL_THREAD if a worker could not be
+ *        started.
+ */
+int thread_pool_init(
+    thread_pool* pool, allocator_options_t* alloc_opts, size_t workers)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != pool);
+    MODEL_ASSERT(NULL != alloc_opts);
+
+    /* runtime parameter checks. */
+    if (NULL == pool || NULL == alloc_opts)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(pool, 0, sizeof(thread_pool));
+    pool->hdr.dispose = &thread_pool_dispose;
+    pool->alloc_opts = alloc_opts;
+
+    /* default to one worker per online core. */
+    pool->worker_count = workers;
+    if (0 == pool->worker_count)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        pool->worker_count = cores > 0 ? (size_t)cores : 1U;
+    }
+
+    if (0 != pthread_mutex_init(&pool->lock, NULL))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (0 != pthread_cond_init(&pool->wake, NULL))
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto destroy_lock;
+    }
+
+    pool->workers = (thread_pool_worker*)
+        allocate(alloc_opts, pool->worker_count * sizeof(thread_pool_worker));
+    if (NULL == pool->workers)
+    {
+        retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        goto destroy_wake;
+    }
+
+    memset(pool->workers, 0, pool->worker_count * sizeof(thread_pool_worker));
+
+    /* set up every deque before any worker can steal from it. */
+    for (size_t i = 0; i < pool->worker_count; ++i)
+    {
+        thread_pool_worker* worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        worker->capacity = THREAD_POOL_DEQUE_INITIAL_CAPACITY;
+        worker->tasks = (thread_pool_task*)
+            allocate(alloc_opts, worker->capacity * sizeof(thread_pool_task));
+        if (NULL == worker->tasks || 0 != pthread_mutex_init(&worker->lock, NULL))
+        {
+            retval = VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+            goto cleanup;
+        }
+    }
+
+    for (size_t i = 0; i < pool->worker_count; ++i)
+    {
+        thread_pool_worker* worker = &pool->workers[i];
+        if (0 != pthread_create(&worker->thread, NULL, &thread_pool_worker_run, worker))
+        {
+            retval = VCBLOCKCHAIN_ERROR_THREAD_POOL_THREAD;
+            goto cleanup;
+        }
+
+        worker->started = 1;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+cleanup:
+    thread_pool_dispose(pool);
+    return retval;
+
+destroy_wake:
+    pthread_cond_destroy(&pool->wake);
+
+destroy_lock:
+    pthread_mutex_destroy(&pool->lock);
+
+    return retval;
+}
+
+/**
+ * \brief Dispose of a thread pool, stopping its workers.
+ *
+ * \param disposable    The pool to dispose.
+ */
+static void thread_pool_dispose(void* disposable)
+{
+    thread_pool* pool = (thread_pool*)disposable;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->worker_count; ++i)
+    {
+        if (pool->workers[i].started)
+        {
+            pthread_join(pool->workers[i].thread, NULL);
+        }
+    }
+
+    for (size_t i = 0; i < pool->worker_count; ++i)
+    {
+        if (NULL != pool->workers[i].tasks)
+        {
+            pthread_mutex_destroy(&pool->workers[i].lock);
+            release(pool->alloc_opts, pool->workers[i].tasks);
+        }
+    }
+
+    release(pool->alloc_opts, pool->workers);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+
+    memset(pool, 0, sizeof(thread_pool));
+}
@@ -0,0 +1,108 @@
+/**
+ * \file src/thread_pool/thread_pool_internal.h
+ *
+ * \brief Internal types and functions for the thread pool.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_THREAD_POOL_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_THREAD_POOL_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/thread_pool.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The initial capacity of a worker's deque.
+ */
+#define THREAD_POOL_DEQUE_INITIAL_CAPACITY 64
+
+/**
+ * \brief A worker, which owns one thread and one deque of tasks.  The deque
+ * is a ring buffer; the owner works at the back, and thieves at the front.
+ * The count is stored atomically, so thieves can skip an empty deque without
+ * taking its lock.
+ */
+struct thread_pool_worker
+{
+    thread_pool* pool;
+    size_t index;
+    pthread_t thread;
+    uint8_t started;
+
+    pthread_mutex_t lock;
+    thread_pool_task* tasks;
+    size_t capacity;
+    size_t head;
+    size_t count;
+};
+
+/**
+ * \brief The worker running on this thread, if any.
+ */
+extern __thread thread_pool_worker* thread_pool_current_worker;
+
+/**
+ * \brief Push a task onto the back of a worker's deque, growing it if full.
+ *
+ * \param worker        The worker.
+ * \param task          The task.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int thread_pool_worker_push(
+    thread_pool_worker* worker, const thread_pool_task* task);
+
+/**
+ * \brief Pop the newest task from the back of a worker's deque.
+ *
+ * \param worker        The worker.
+ * \param task          Pointer to receive the task.
+ *
+ * \returns 1 if a task was popped, or 0 if the deque was empty.
+ */
+uint8_t thread_pool_worker_pop(thread_pool_worker* worker, thread_pool_task* task);
+
+/**
+ * \brief Steal the oldest task from the front of a worker's deque.
+ *
+ * \param worker        The worker to steal from.
+ * \param task          Pointer to receive the task.
+ *
+ * \returns 1 if a task was stolen, or 0 if the deque was empty.
+ */
+uint8_t thread_pool_worker_steal(
+    thread_pool_worker* worker, thread_pool_task* task);
+
+/**
+ * \brief Take a task: our own newest first, then the oldest of another
+ * worker's.
+ *
+ * \param pool          The pool.
+ * \param self          The worker taking the task, or NULL for a helper.
+ * \param task          Pointer to receive the task.
+ *
+ * \returns 1 if a task was taken, or 0 if the pool has nothing queued.
+ */
+uint8_t thread_pool_take(
+    thread_pool* pool, thread_pool_worker* self, thread_pool_task* task);
+
+/**
+ * \brief Worker thread: run tasks, and sleep when there are none.
+ *
+ * \param context       The worker.
+ *
+ * \returns NULL.
+ */
+void* thread_pool_worker_run(void* context);
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_THREAD_POOL_INTERNAL_HEADER_GUARD*/
@@ -0,0 +1,30 @@
+/**
+ * \file src/thread_pool/thread_pool_latch_count_down.c
+ *
+ * \brief Count a latch down by one.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Count a latch down by one, waking its waiter at zero.
+ *
+ * \param latch         The latch.
+ */
+void thread_pool_latch_count_down(thread_pool_latch* latch)
+{
+    MODEL_ASSERT(NULL != latch);
+
+    /* count down under the lock, so the waiter can't see zero, return, and
+     * dispose of the latch before the broadcast is done with it. */
+    pthread_mutex_lock(&latch->lock);
+    if (0 == __atomic_sub_fetch(&latch->count, 1, __ATOMIC_ACQ_REL))
+    {
+        pthread_cond_broadcast(&latch->done);
+    }
+    pthread_mutex_unlock(&latch->lock);
+}
@@ -0,0 +1,24 @@
+/**
+ * \file src/thread_pool/thread_pool_latch_dispose.c
+ *
+ * \brief Dispose of a latch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Dispose of a latch.
+ *
+ * \param latch         The latch to dispose.
+ */
+void thread_pool_latch_dispose(thread_pool_latch* latch)
+{
+    MODEL_ASSERT(NULL != latch);
+
+    pthread_cond_destroy(&latch->done);
+    pthread_mutex_destroy(&latch->lock);
+}
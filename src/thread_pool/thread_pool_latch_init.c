@@ -0,0 +1,53 @@
+/**
+ * \file src/thread_pool/thread_pool_latch_init.c
+ *
+ * \brief Initialize a latch.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Initialize a latch.
+ *
+ * This instance is disposed by calling \ref thread_pool_latch_dispose().
+ *
+ * \param latch         The latch to initialize.
+ * \param count         The number of count downs it waits for.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int thread_pool_latch_init(thread_pool_latch* latch, size_t count)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != latch);
+
+    /* runtime parameter checks. */
+    if (NULL == latch)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    latch->count = count;
+
+    if (0 != pthread_mutex_init(&latch->lock, NULL))
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (0 != pthread_cond_init(&latch->done, NULL))
+    {
+        pthread_mutex_destroy(&latch->lock);
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,33 @@
+/**
+ * \file src/thread_pool/thread_pool_scan_cancel.c
+ *
+ * \brief Cancel a scan.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Cancel a scan, so that its remaining items are skipped.
+ *
+ * If the scan is cancelled more than once, the first status is kept.
+ *
+ * \param scan          The scan.
+ * \param status        The non-zero status for \ref thread_pool_scan_finish()
+ *                      to return.
+ */
+void thread_pool_scan_cancel(thread_pool_scan* scan, int status)
+{
+    int expected = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+    MODEL_ASSERT(NULL != scan);
+    MODEL_ASSERT(VCBLOCKCHAIN_STATUS_SUCCESS != status);
+
+    __atomic_compare_exchange_n(
+        &scan->status, &expected, status, false, __ATOMIC_ACQ_REL,
+        __ATOMIC_ACQUIRE);
+}
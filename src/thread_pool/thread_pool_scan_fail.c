@@ -0,0 +1,29 @@
+/**
+ * \file src/thread_pool/thread_pool_scan_fail.c
+ *
+ * \brief Report that an item of a scan failed.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <stdbool.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Report that an item of a scan failed.
+ *
+ * \param scan          The scan.
+ * \param index         The index of the failing item.
+ */
+void thread_pool_scan_fail(thread_pool_scan* scan, size_t index)
+{
+    MODEL_ASSERT(NULL != scan);
+
+    /* lower the first failure to this index, unless already lower. */
+    size_t current = __atomic_load_n(&scan->first_failure, __ATOMIC_ACQUIRE);
+    while (index < current && !__atomic_compare_exchange_n(&scan->first_failure, &current, index, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ * \file src/thread_pool/thread_pool_scan_finish.c
+ *
+ * \brief Finish a scan.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Finish a scan, running it here or helping the pool with it.
+ *
+ * On return, the scan's first_failure is the lowest failing index, or
+ * SIZE_MAX if no item failed.
+ *
+ * \param scan          The scan.
+ *
+ * \returns VCBLOCKCHAIN_STATUS_SUCCESS, or the status the scan was cancelled
+ *          with.
+ */
+int thread_pool_scan_finish(thread_pool_scan* scan)
+{
+    MODEL_ASSERT(NULL != scan);
+
+    if (NULL == scan->chunks)
+    {
+        scan->fn(scan, 0, scan->count);
+    }
+    else
+    {
+        thread_pool_wait(scan->pool, &scan->latch);
+        thread_pool_latch_dispose(&scan->latch);
+
+        release(scan->alloc_opts, scan->chunks);
+        scan->chunks = NULL;
+    }
+
+    return scan->status;
+}
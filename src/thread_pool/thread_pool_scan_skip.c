@@ -0,0 +1,28 @@
+/**
+ * \file src/thread_pool/thread_pool_scan_skip.c
+ *
+ * \brief Check whether an item of a scan can be skipped.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Check whether an item of a scan can be skipped, because the scan was
+ * cancelled or a lower index has already failed.
+ *
+ * \param scan          The scan.
+ * \param index         The index of the item.
+ *
+ * \returns true if the item need not be checked.
+ */
+bool thread_pool_scan_skip(thread_pool_scan* scan, size_t index)
+{
+    MODEL_ASSERT(NULL != scan);
+
+    /* once a lower index has failed, this one can't be reported. */
+    return index > __atomic_load_n(&scan->first_failure, __ATOMIC_ACQUIRE) || VCBLOCKCHAIN_STATUS_SUCCESS != __atomic_load_n(&scan->status, __ATOMIC_ACQUIRE);
+}
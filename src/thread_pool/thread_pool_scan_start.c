@@ -0,0 +1,131 @@
+/**
+ * \file src/thread_pool/thread_pool_scan_start.c
+ *
+ * \brief Start a scan of a range of items.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "thread_pool_internal.h"
+
+/* forward decls. */
+static void thread_pool_scan_run_chunk(void* context);
+
+/**
+ * \brief Start a scan of a range of items.
+ *
+ * The range is split into chunks, which are queued on the pool.  If there is
+ * no pool, or only one chunk, the scan runs on the calling thread in
+ * \ref thread_pool_scan_finish() instead.  Either way, the caller may do other
+ * work, or cancel the scan, before finishing it, and must always finish it.
+ *
+ * \param scan          The scan to start.
+ * \param pool          The pool to scan on, or NULL to scan on the calling
+ *                      thread.
+ * \param alloc_opts    The allocator to use for the chunks.
+ * \param count         The number of items.
+ * \param chunk_size    The number of items per chunk; must be non-zero.
+ * \param fn            The check of one chunk.
+ * \param context       The user context for the check.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int thread_pool_scan_start(
+    thread_pool_scan* scan, thread_pool* pool, allocator_options_t* alloc_opts,
+    size_t count, size_t chunk_size, thread_pool_scan_fn fn, void* context)
+{
+    int retval;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != scan);
+    MODEL_ASSERT(NULL != alloc_opts);
+    MODEL_ASSERT(chunk_size > 0);
+    MODEL_ASSERT(NULL != fn);
+
+    /* runtime parameter checks. */
+    if (NULL == scan || NULL == alloc_opts || 0 == chunk_size || NULL == fn)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(scan, 0, sizeof(thread_pool_scan));
+    scan->pool = pool;
+    scan->alloc_opts = alloc_opts;
+    scan->fn = fn;
+    scan->context = context;
+    scan->count = count;
+    scan->first_failure = SIZE_MAX;
+    scan->status = VCBLOCKCHAIN_STATUS_SUCCESS;
+
+    size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+
+    /* small scans, or a scan without a pool, run when finished. */
+    if (NULL == pool || chunk_count <= 1)
+    {
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    scan->chunks = (thread_pool_scan_chunk*)
+        allocate(alloc_opts, chunk_count * sizeof(thread_pool_scan_chunk));
+    if (NULL == scan->chunks)
+    {
+        return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+    }
+
+    retval = thread_pool_latch_init(&scan->latch, chunk_count);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        goto release_chunks;
+    }
+
+    /* fan the chunks out; a chunk which can't be queued runs here. */
+    for (size_t i = 0; i < chunk_count; ++i)
+    {
+        thread_pool_scan_chunk* chunk = &scan->chunks[i];
+
+        chunk->scan = scan;
+        chunk->begin = i * chunk_size;
+        chunk->end = chunk->begin + chunk_size;
+        if (chunk->end > count)
+        {
+            chunk->end = count;
+        }
+
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != thread_pool_submit(pool, &thread_pool_scan_run_chunk, chunk))
+        {
+            thread_pool_scan_run_chunk(chunk);
+        }
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+
+release_chunks:
+    release(alloc_opts, scan->chunks);
+    scan->chunks = NULL;
+
+    return retval;
+}
+
+/**
+ * \brief Task which checks one chunk of a scan, then counts the scan's latch
+ * down.
+ *
+ * \param context       The \ref thread_pool_scan_chunk.
+ */
+static void thread_pool_scan_run_chunk(void* context)
+{
+    thread_pool_scan_chunk* chunk = (thread_pool_scan_chunk*)context;
+    thread_pool_scan* scan = chunk->scan;
+
+    scan->fn(scan, chunk->begin, chunk->end);
+
+    thread_pool_latch_count_down(&scan->latch);
+}
@@ -0,0 +1,69 @@
+/**
+ * \file src/thread_pool/thread_pool_submit.c
+ *
+ * \brief Queue a task on the pool.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Queue a task on the pool.
+ *
+ * \param pool          The pool.
+ * \param fn            The task.
+ * \param context       The user context for the task.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if this operation encountered an
+ *        out-of-memory error.
+ */
+int thread_pool_submit(thread_pool* pool, thread_pool_task_fn fn, void* context)
+{
+    thread_pool_worker* worker;
+    thread_pool_task task;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != pool);
+    MODEL_ASSERT(NULL != fn);
+
+    /* runtime parameter checks. */
+    if (NULL == pool || NULL == fn)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* a task spawned by a task stays with its worker; others are spread. */
+    worker = thread_pool_current_worker;
+    if (NULL == worker || worker->pool != pool)
+    {
+        size_t next = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+        worker = &pool->workers[next % pool->worker_count];
+    }
+
+    task.fn = fn;
+    task.context = context;
+
+    /* count the task before publishing it, so a thief which takes it at once
+     * can't count it out first and wrap the count. */
+    __atomic_fetch_add(&pool->queued, 1, __ATOMIC_ACQ_REL);
+
+    int retval = thread_pool_worker_push(worker, &task);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        __atomic_fetch_sub(&pool->queued, 1, __ATOMIC_ACQ_REL);
+        return retval;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
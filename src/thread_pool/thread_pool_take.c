@@ -0,0 +1,54 @@
+/**
+ * \file src/thread_pool/thread_pool_take.c
+ *
+ * \brief Take a task from the pool.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Take a task: our own newest first, then the oldest of another
+ * worker's.
+ *
+ * \param pool          The pool.
+ * \param self          The worker taking the task, or NULL for a helper.
+ * \param task          Pointer to receive the task.
+ *
+ * \returns 1 if a task was taken, or 0 if the pool has nothing queued.
+ */
+uint8_t thread_pool_take(
+    thread_pool* pool, thread_pool_worker* self, thread_pool_task* task)
+{
+    MODEL_ASSERT(NULL != pool);
+    MODEL_ASSERT(NULL != task);
+
+    if (0 == __atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE))
+    {
+        return 0;
+    }
+
+    uint8_t taken = NULL != self && thread_pool_worker_pop(self, task);
+
+    /* steal round the ring, starting after our own deque. */
+    size_t start = NULL != self ? self->index + 1 : 0;
+    for (size_t i = 0; !taken && i < pool->worker_count; ++i)
+    {
+        thread_pool_worker* victim =
+            &pool->workers[(start + i) % pool->worker_count];
+        if (victim != self)
+        {
+            taken = thread_pool_worker_steal(victim, task);
+        }
+    }
+
+    if (taken)
+    {
+        __atomic_fetch_sub(&pool->queued, 1, __ATOMIC_ACQ_REL);
+    }
+
+    return taken;
+}
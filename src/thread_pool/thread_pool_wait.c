@@ -0,0 +1,51 @@
+/**
+ * \file src/thread_pool/thread_pool_wait.c
+ *
+ * \brief Wait for a latch, helping the pool meanwhile.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Wait for a latch to reach zero, running queued tasks meanwhile.
+ *
+ * \param pool          The pool to help, or NULL to just wait.
+ * \param latch         The latch.
+ */
+void thread_pool_wait(thread_pool* pool, thread_pool_latch* latch)
+{
+    thread_pool_task task;
+
+    MODEL_ASSERT(NULL != latch);
+
+    /* help until nothing is left to take. */
+    while (NULL != pool && 0 != __atomic_load_n(&latch->count, __ATOMIC_ACQUIRE))
+    {
+        thread_pool_worker* self = thread_pool_current_worker;
+        if (NULL != self && self->pool != pool)
+        {
+            self = NULL;
+        }
+
+        if (!thread_pool_take(pool, self, &task))
+        {
+            break;
+        }
+
+        task.fn(task.context);
+    }
+
+    /* the rest are running; sleep until the last one counts down.  The count
+     * is only final once it is seen as zero under the lock, after the last
+     * count down has released it. */
+    pthread_mutex_lock(&latch->lock);
+    while (0 != latch->count)
+    {
+        pthread_cond_wait(&latch->done, &latch->lock);
+    }
+    pthread_mutex_unlock(&latch->lock);
+}
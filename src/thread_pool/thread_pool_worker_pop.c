@@ -0,0 +1,41 @@
+/**
+ * \file src/thread_pool/thread_pool_worker_pop.c
+ *
+ * \brief Pop the newest task from a worker's deque.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Pop the newest task from the back of a worker's deque.
+ *
+ * \param worker        The worker.
+ * \param task          Pointer to receive the task.
+ *
+ * \returns 1 if a task was popped, or 0 if the deque was empty.
+ */
+uint8_t thread_pool_worker_pop(thread_pool_worker* worker, thread_pool_task* task)
+{
+    uint8_t popped = 0;
+
+    MODEL_ASSERT(NULL != worker);
+    MODEL_ASSERT(NULL != task);
+
+    pthread_mutex_lock(&worker->lock);
+
+    if (worker->count > 0)
+    {
+        size_t last = worker->count - 1;
+        *task = worker->tasks[(worker->head + last) % worker->capacity];
+        __atomic_store_n(&worker->count, last, __ATOMIC_RELAXED);
+        popped = 1;
+    }
+
+    pthread_mutex_unlock(&worker->lock);
+
+    return popped;
+}
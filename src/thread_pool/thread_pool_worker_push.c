@@ -0,0 +1,59 @@
+/**
+ * \file src/thread_pool/thread_pool_worker_push.c
+ *
+ * \brief Push a task onto a worker's deque.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Push a task onto the back of a worker's deque, growing it if full.
+ *
+ * \param worker        The worker.
+ * \param task          The task.
+ *
+ * \returns a status code indicating success or failure.
+ */
+int thread_pool_worker_push(
+    thread_pool_worker* worker, const thread_pool_task* task)
+{
+    MODEL_ASSERT(NULL != worker);
+    MODEL_ASSERT(NULL != task);
+
+    pthread_mutex_lock(&worker->lock);
+
+    if (worker->count == worker->capacity)
+    {
+        size_t capacity = 2 * worker->capacity;
+        thread_pool_task* tasks = (thread_pool_task*)
+            allocate(worker->pool->alloc_opts, capacity * sizeof(thread_pool_task));
+        if (NULL == tasks)
+        {
+            pthread_mutex_unlock(&worker->lock);
+            return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+        }
+
+        /* unwrap the ring into the new buffer. */
+        for (size_t i = 0; i < worker->count; ++i)
+        {
+            tasks[i] = worker->tasks[(worker->head + i) % worker->capacity];
+        }
+
+        release(worker->pool->alloc_opts, worker->tasks);
+        worker->tasks = tasks;
+        worker->capacity = capacity;
+        worker->head = 0;
+    }
+
+    worker->tasks[(worker->head + worker->count) % worker->capacity] = *task;
+    __atomic_store_n(&worker->count, worker->count + 1, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&worker->lock);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/**
+ * \file src/thread_pool/thread_pool_worker_run.c
+ *
+ * \brief Worker thread for the thread pool.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+__thread thread_pool_worker* thread_pool_current_worker = NULL;
+
+/**
+ * \brief Worker thread: run tasks, and sleep when there are none.
+ *
+ * \param context       The worker.
+ *
+ * \returns NULL.
+ */
+void* thread_pool_worker_run(void* context)
+{
+    thread_pool_worker* worker = (thread_pool_worker*)context;
+    thread_pool* pool = worker->pool;
+    thread_pool_task task;
+
+    MODEL_ASSERT(NULL != worker);
+
+    thread_pool_current_worker = worker;
+
+    for (;;)
+    {
+        if (thread_pool_take(pool, worker, &task))
+        {
+            task.fn(task.context);
+            continue;
+        }
+
+        /* sleep until a task is queued, checking under the lock that
+         * submitters signal under, so no wakeup is lost. */
+        pthread_mutex_lock(&pool->lock);
+        while (0 == __atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE) && !pool->stopping)
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        uint8_t stopping = pool->stopping;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (stopping)
+        {
+            break;
+        }
+    }
+
+    thread_pool_current_worker = NULL;
+
+    return NULL;
+}
@@ -0,0 +1,48 @@
+/**
+ * \file src/thread_pool/thread_pool_worker_steal.c
+ *
+ * \brief Steal the oldest task from a worker's deque.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "thread_pool_internal.h"
+
+/**
+ * \brief Steal the oldest task from the front of a worker's deque.
+ *
+ * \param worker        The worker to steal from.
+ * \param task          Pointer to receive the task.
+ *
+ * \returns 1 if a task was stolen, or 0 if the deque was empty.
+ */
+uint8_t thread_pool_worker_steal(
+    thread_pool_worker* worker, thread_pool_task* task)
+{
+    uint8_t stolen = 0;
+
+    MODEL_ASSERT(NULL != worker);
+    MODEL_ASSERT(NULL != task);
+
+    /* don't queue up behind the owner for an empty deque. */
+    if (0 == __atomic_load_n(&worker->count, __ATOMIC_RELAXED))
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+
+    if (worker->count > 0)
+    {
+        *task = worker->tasks[worker->head];
+        worker->head = (worker->head + 1) % worker->capacity;
+        __atomic_store_n(&worker->count, worker->count - 1, __ATOMIC_RELAXED);
+        stolen = 1;
+    }
+
+    pthread_mutex_unlock(&worker->lock);
+
+    return stolen;
+}
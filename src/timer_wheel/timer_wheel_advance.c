@@ -0,0 +1,149 @@
+/**
+ * \file src/timer_wheel/timer_wheel_advance.c
+ *
+ * \brief Advance a timer wheel, firing expired timers.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "timer_wheel_internal.h"
+
+/* forward decls. */
+static void timer_wheel_cascade(timer_wheel* wheel);
+static size_t timer_wheel_fire_slot(timer_wheel* wheel, timer_wheel_link* head);
+
+/**
+ * \brief Advance the wheel to the given time, firing every timer which has
+ * expired.
+ *
+ * Timers fire in order of expiry tick.  An empty wheel jumps straight to the
+ * given time.
+ *
+ * \param wheel             The wheel.
+ * \param now_ms            The current time in milliseconds.
+ * \param fired             Optional pointer to receive the number of timers
+ *                          fired.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_advance(timer_wheel* wheel, uint64_t now_ms, size_t* fired)
+{
+    size_t total = 0;
+
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != wheel);
+
+    /* runtime parameter checks. */
+    if (NULL == wheel)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* time before the wheel started, or a clock step backwards, is ignored. */
+    uint64_t target = 0;
+    if (now_ms > wheel->start_ms)
+    {
+        target = (now_ms - wheel->start_ms) / wheel->tick_ms;
+    }
+
+    while (wheel->current < target)
+    {
+        /* nothing can fire on an empty wheel. */
+        if (0 == wheel->count)
+        {
+            wheel->current = target;
+            break;
+        }
+
+        ++wheel->current;
+        timer_wheel_cascade(wheel);
+
+        total +=
+            timer_wheel_fire_slot(
+                wheel,
+                &wheel->slots[0][wheel->current & TIMER_WHEEL_SLOT_MASK]);
+    }
+
+    if (NULL != fired)
+    {
+        *fired = total;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Move the timers of every higher-level slot that has come due down to
+ * the levels below.
+ *
+ * A level's slot comes due when every level beneath it wraps to zero.
+ *
+ * \param wheel         The wheel, whose current tick has just advanced.
+ */
+static void timer_wheel_cascade(timer_wheel* wheel)
+{
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        uint64_t below = wheel->current >> (TIMER_WHEEL_SLOT_BITS * (level - 1));
+        if (0 != (below & TIMER_WHEEL_SLOT_MASK))
+        {
+            break;
+        }
+
+        size_t index =
+            (wheel->current >> (TIMER_WHEEL_SLOT_BITS * level))
+                & TIMER_WHEEL_SLOT_MASK;
+        timer_wheel_link* head = &wheel->slots[level][index];
+        if (timer_wheel_slot_empty(head))
+        {
+            continue;
+        }
+
+        /* detach the slot's list, then place each timer again. */
+        timer_wheel_link* link = head->next;
+        head->prev->next = NULL;
+        head->prev = head->next = head;
+
+        while (NULL != link)
+        {
+            timer_wheel_timer* timer = (timer_wheel_timer*)link;
+            link = link->next;
+            timer_wheel_place(wheel, timer);
+        }
+    }
+}
+
+/**
+ * \brief Fire every timer in a level 0 slot.
+ *
+ * Each timer is unlinked before its callback runs, so callbacks may schedule
+ * or cancel any timer, including the one firing.
+ *
+ * \param wheel         The wheel.
+ * \param head          The slot to fire.
+ *
+ * \returns the number of timers fired.
+ */
+static size_t timer_wheel_fire_slot(timer_wheel* wheel, timer_wheel_link* head)
+{
+    size_t count = 0;
+
+    while (!timer_wheel_slot_empty(head))
+    {
+        timer_wheel_timer* timer = (timer_wheel_timer*)head->next;
+
+        timer_wheel_unlink(timer);
+        timer->wheel = NULL;
+        --wheel->count;
+        ++count;
+
+        timer->callback(wheel, timer, timer->context);
+    }
+
+    return count;
+}
@@ -0,0 +1,43 @@
+/**
+ * \file src/timer_wheel/timer_wheel_cancel.c
+ *
+ * \brief Cancel a timer.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "timer_wheel_internal.h"
+
+/**
+ * \brief Cancel a timer.  Canceling a timer which is not pending does nothing.
+ * This is O(1).
+ *
+ * \param timer             The timer to cancel.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_cancel(timer_wheel_timer* timer)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != timer);
+
+    /* runtime parameter checks. */
+    if (NULL == timer)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (NULL != timer->wheel)
+    {
+        timer_wheel_unlink(timer);
+        --timer->wheel->count;
+        timer->wheel = NULL;
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,92 @@
+/**
+ * \file src/timer_wheel/timer_wheel_init.c
+ *
+ * \brief Initialize a timer wheel.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "timer_wheel_internal.h"
+
+/* forward decls. */
+static void timer_wheel_dispose(void* disposable);
+
+/**
+ * \brief Initialize a timer wheel.
+ *
+ * Timers are resolved to the tick; a timer never fires early, and fires within
+ * one tick of its deadline if the wheel is advanced promptly.  This instance is
+ * disposable and must be disposed by calling \ref dispose() when no longer
+ * needed.  Pending timers are canceled, without firing, when it is disposed.
+ *
+ * \param wheel             The wheel to initialize.
+ * \param tick_ms           The duration of a tick in milliseconds.
+ * \param now_ms            The current time in milliseconds, on the same
+ *                          monotonic clock later passed to
+ *                          \ref timer_wheel_advance().
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_init(timer_wheel* wheel, uint32_t tick_ms, uint64_t now_ms)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != wheel);
+    MODEL_ASSERT(tick_ms > 0);
+
+    /* runtime parameter checks. */
+    if (NULL == wheel || 0 == tick_ms)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(wheel, 0, sizeof(timer_wheel));
+    wheel->hdr.dispose = &timer_wheel_dispose;
+    wheel->tick_ms = tick_ms;
+    wheel->start_ms = now_ms;
+
+    /* every slot starts as an empty circular list. */
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot)
+        {
+            timer_wheel_link* head = &wheel->slots[level][slot];
+            head->prev = head->next = head;
+        }
+    }
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Dispose of a timer wheel, canceling every pending timer.
+ *
+ * \param disposable        The wheel to dispose.
+ */
+static void timer_wheel_dispose(void* disposable)
+{
+    timer_wheel* wheel = (timer_wheel*)disposable;
+
+    MODEL_ASSERT(NULL != wheel);
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; ++slot)
+        {
+            timer_wheel_link* head = &wheel->slots[level][slot];
+            while (!timer_wheel_slot_empty(head))
+            {
+                timer_wheel_timer* timer = (timer_wheel_timer*)head->next;
+                timer_wheel_unlink(timer);
+                timer->wheel = NULL;
+            }
+        }
+    }
+
+    memset(wheel, 0, sizeof(timer_wheel));
+}
@@ -0,0 +1,62 @@
+/**
+ * \file src/timer_wheel/timer_wheel_internal.h
+ *
+ * \brief Internal helpers for the timer wheel.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef VCBLOCKCHAIN_TIMER_WHEEL_INTERNAL_HEADER_GUARD
+#define VCBLOCKCHAIN_TIMER_WHEEL_INTERNAL_HEADER_GUARD
+
+#include <vcblockchain/timer_wheel.h>
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * \brief The slot index mask for one level.
+ */
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+/**
+ * \brief Link a timer into the slot for its expiry, relative to the wheel's
+ * current tick.
+ *
+ * \param wheel         The wheel.
+ * \param timer         The timer, whose expiry is set.
+ */
+void timer_wheel_place(timer_wheel* wheel, timer_wheel_timer* timer);
+
+/**
+ * \brief Determine whether a slot is empty.
+ *
+ * \param slot          The slot.
+ *
+ * \returns true if the slot is empty, false otherwise.
+ */
+static inline int timer_wheel_slot_empty(const timer_wheel_link* slot)
+{
+    return slot->next == slot;
+}
+
+/**
+ * \brief Unlink a timer from its slot.
+ *
+ * \param timer         The timer.
+ */
+static inline void timer_wheel_unlink(timer_wheel_timer* timer)
+{
+    timer->link.prev->next = timer->link.next;
+    timer->link.next->prev = timer->link.prev;
+    timer->link.prev = timer->link.next = &timer->link;
+}
+
+/* make this header C++ friendly. */
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*VCBLOCKCHAIN_TIMER_WHEEL_INTERNAL_HEADER_GUARD*/
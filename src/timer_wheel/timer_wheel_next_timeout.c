@@ -0,0 +1,63 @@
+/**
+ * \file src/timer_wheel/timer_wheel_next_timeout.c
+ *
+ * \brief Get the time until a timer wheel next needs to be advanced.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "timer_wheel_internal.h"
+
+/**
+ * \brief Get the time until the wheel next needs to be advanced, for use as a
+ * poll timeout.
+ *
+ * The result is exact when the next timer is in level 0, and otherwise is the
+ * time until the next cascade, which is never later than the next expiry.
+ *
+ * \param wheel             The wheel.
+ * \param now_ms            The current time in milliseconds.
+ * \param timeout_ms        Pointer to receive the timeout in milliseconds, or
+ *                          \ref TIMER_WHEEL_NO_TIMEOUT if no timer is pending.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_next_timeout(
+    const timer_wheel* wheel, uint64_t now_ms, uint64_t* timeout_ms)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != wheel);
+    MODEL_ASSERT(NULL != timeout_ms);
+
+    /* runtime parameter checks. */
+    if (NULL == wheel || NULL == timeout_ms)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    if (0 == wheel->count)
+    {
+        *timeout_ms = TIMER_WHEEL_NO_TIMEOUT;
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    /* find the next occupied level 0 slot before level 0 wraps. */
+    uint64_t next = wheel->current + 1;
+    uint64_t wrap =
+        (wheel->current | TIMER_WHEEL_SLOT_MASK) + 1;
+    while (next < wrap && timer_wheel_slot_empty(&wheel->slots[0][next & TIMER_WHEEL_SLOT_MASK]))
+    {
+        ++next;
+    }
+
+    /* otherwise, the next cascade may bring a timer down to level 0. */
+    uint64_t due_ms = wheel->start_ms + next * wheel->tick_ms;
+    *timeout_ms = due_ms > now_ms ? due_ms - now_ms : 0;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,56 @@
+/**
+ * \file src/timer_wheel/timer_wheel_place.c
+ *
+ * \brief Link a timer into the slot for its expiry.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "timer_wheel_internal.h"
+
+/**
+ * \brief Link a timer into the slot for its expiry, relative to the wheel's
+ * current tick.
+ *
+ * The level is chosen by how far away the expiry is, and the slot within the
+ * level by the expiry's digit at that level, so that a slot comes due exactly
+ * when the wheel reaches its range.  Expiries beyond the top level wait in its
+ * furthest slot, and are placed again when it cascades.
+ *
+ * \param wheel         The wheel.
+ * \param timer         The timer, whose expiry is set.
+ */
+void timer_wheel_place(timer_wheel* wheel, timer_wheel_timer* timer)
+{
+    MODEL_ASSERT(NULL != wheel);
+    MODEL_ASSERT(NULL != timer);
+    MODEL_ASSERT(timer->expiry >= wheel->current);
+
+    uint64_t expiry = timer->expiry;
+    uint64_t delta = expiry - wheel->current;
+    int level = 0;
+
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1ULL << (TIMER_WHEEL_SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    /* clamp a far expiry to the furthest slot of the top level. */
+    uint64_t top_range = 1ULL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS);
+    if (delta >= top_range)
+    {
+        expiry = wheel->current + top_range - 1;
+    }
+
+    size_t index =
+        (expiry >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    timer_wheel_link* head = &wheel->slots[level][index];
+
+    /* append, so that timers in a slot fire in the order they were placed. */
+    timer->link.prev = head->prev;
+    timer->link.next = head;
+    head->prev->next = &timer->link;
+    head->prev = &timer->link;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file src/timer_wheel/timer_wheel_schedule.c
+ *
+ * \brief Schedule a timer to expire after the given delay.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+
+#include "timer_wheel_internal.h"
+
+/**
+ * \brief Schedule a timer to expire after the given delay.
+ *
+ * The delay is measured from the wheel's current time, as of the last
+ * \ref timer_wheel_advance(), and rounded up to whole ticks, with a minimum of
+ * one tick.  A timer which is already pending is rescheduled, which makes this
+ * suitable for resetting an idle timeout on every request.  This is O(1).
+ *
+ * \param wheel             The wheel.
+ * \param timer             The timer to schedule.
+ * \param delay_ms          The delay in milliseconds.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_schedule(
+    timer_wheel* wheel, timer_wheel_timer* timer, uint64_t delay_ms)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != wheel);
+    MODEL_ASSERT(NULL != timer);
+
+    /* runtime parameter checks. */
+    if (NULL == wheel || NULL == timer || NULL == timer->callback)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    /* reschedule a pending timer. */
+    timer_wheel_cancel(timer);
+
+    uint64_t ticks = delay_ms / wheel->tick_ms;
+    if (0 != delay_ms % wheel->tick_ms || 0 == ticks)
+    {
+        ++ticks;
+    }
+
+    /* saturate rather than wrap for absurd delays. */
+    if (ticks > UINT64_MAX - wheel->current)
+    {
+        ticks = UINT64_MAX - wheel->current;
+    }
+
+    timer->expiry = wheel->current + ticks;
+    timer->wheel = wheel;
+    ++wheel->count;
+
+    timer_wheel_place(wheel, timer);
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
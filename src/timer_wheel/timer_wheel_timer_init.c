@@ -0,0 +1,45 @@
+/**
+ * \file src/timer_wheel/timer_wheel_timer_init.c
+ *
+ * \brief Initialize a timer.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cbmc/model_assert.h>
+#include <string.h>
+
+#include "timer_wheel_internal.h"
+
+/**
+ * \brief Initialize a timer.
+ *
+ * \param timer             The timer to initialize.
+ * \param callback          The callback to call when the timer expires.
+ * \param context           The user context passed to the callback.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check failed.
+ */
+int timer_wheel_timer_init(
+    timer_wheel_timer* timer, timer_wheel_callback_fn callback, void* context)
+{
+    /* parameter sanity checks. */
+    MODEL_ASSERT(NULL != timer);
+    MODEL_ASSERT(NULL != callback);
+
+    /* runtime parameter checks. */
+    if (NULL == timer || NULL == callback)
+    {
+        return VCBLOCKCHAIN_ERROR_INVALID_ARG;
+    }
+
+    memset(timer, 0, sizeof(timer_wheel_timer));
+    timer->link.prev = timer->link.next = &timer->link;
+    timer->callback = callback;
+    timer->context = context;
+
+    /* success. */
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
@@ -0,0 +1,335 @@
+/**
+ * \file test/arena_allocator/test_arena_allocator.cpp
+ *
+ * Unit tests for the arena allocator.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vcblockchain/arena_allocator.h>
+#include <vcblockchain/ssock.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "../ssock/dummy_ssock.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * \brief A backing allocator which counts allocations and releases.
+ */
+struct counting_backing
+{
+    allocator_options_t opts;
+    allocator_options_t* inner;
+    int allocations;
+    int releases;
+};
+
+void* counting_allocate(void* options, size_t size)
+{
+    counting_backing* b = (counting_backing*)((allocator_options_t*)options)->context;
+    ++b->allocations;
+    return allocate(b->inner, size);
+}
+
+void counting_release(void* options, void* mem)
+{
+    counting_backing* b = (counting_backing*)((allocator_options_t*)options)->context;
+    ++b->releases;
+    release(b->inner, mem);
+}
+
+}
+
+class test_arena_allocator : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+
+        memset(&backing, 0, sizeof(backing));
+        backing.inner = &alloc_opts;
+        backing.opts.allocator_allocate = &counting_allocate;
+        backing.opts.allocator_release = &counting_release;
+        backing.opts.context = &backing;
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+    counting_backing backing;
+};
+
+/**
+ * Test that init and reset check their parameters.
+ */
+TEST_F(test_arena_allocator, parameter_checks)
+{
+    allocator_options_t arena;
+    uint8_t region[64];
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        arena_allocator_options_init(nullptr, &backing.opts, nullptr, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        arena_allocator_options_init(&arena, nullptr, region, sizeof(region)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        arena_allocator_options_init(&arena, &backing.opts, nullptr, 64));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, arena_allocator_reset(nullptr));
+}
+
+/**
+ * Test that allocations are aligned and grow past the first block.
+ */
+TEST_F(test_arena_allocator, alignment_and_growth)
+{
+    allocator_options_t arena;
+    vector<uint8_t*> ptrs;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        arena_allocator_options_init(&arena, &backing.opts, nullptr, 0));
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        size_t size = 1 + i % 37;
+        uint8_t* p = (uint8_t*)allocate(&arena, size);
+        ASSERT_NE(nullptr, p);
+        EXPECT_EQ(0U, (uintptr_t)p % ARENA_ALLOCATOR_ALIGNMENT);
+        memset(p, (int)i, size);
+        ptrs.push_back(p);
+    }
+
+    /* earlier allocations survive growth. */
+    for (size_t i = 0; i < ptrs.size(); ++i)
+    {
+        EXPECT_EQ((uint8_t)i, ptrs[i][0]);
+    }
+
+    /* blocks double, so growth takes few backing allocations. */
+    EXPECT_LT(backing.allocations, 8);
+
+    /* a single allocation larger than any block still succeeds. */
+    EXPECT_NE(nullptr, allocate(&arena, 1024 * 1024));
+
+    dispose((disposable_t*)&arena);
+    EXPECT_EQ(backing.allocations, backing.releases);
+}
+
+/**
+ * Test that an arena settles on a block big enough for its working set, and
+ * then stops calling the backing allocator.
+ */
+TEST_F(test_arena_allocator, reset_reuses_block)
+{
+    allocator_options_t arena;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        arena_allocator_options_init(&arena, &backing.opts, nullptr, 0));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(nullptr, allocate(&arena, 200));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, arena_allocator_reset(&arena));
+
+    /* only the largest block is kept. */
+    EXPECT_EQ(backing.allocations - 2, backing.releases);
+
+    /* blocks double, so the working set fits in the spare within a few
+     * rounds. */
+    for (int round = 0; round < 4; ++round)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_NE(nullptr, allocate(&arena, 200));
+        }
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, arena_allocator_reset(&arena));
+    }
+
+    int allocations = backing.allocations;
+    void* first = allocate(&arena, 200);
+    ASSERT_NE(nullptr, first);
+
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 99; ++i)
+        {
+            ASSERT_NE(nullptr, allocate(&arena, 200));
+        }
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, arena_allocator_reset(&arena));
+        EXPECT_EQ(first, allocate(&arena, 200));
+    }
+
+    EXPECT_EQ(allocations, backing.allocations);
+
+    dispose((disposable_t*)&arena);
+    EXPECT_EQ(backing.allocations, backing.releases);
+}
+
+/**
+ * Test that the most recent allocation is released and reallocated in place.
+ */
+TEST_F(test_arena_allocator, last_allocation_in_place)
+{
+    allocator_options_t arena;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        arena_allocator_options_init(&arena, &backing.opts, nullptr, 0));
+
+    uint8_t* a = (uint8_t*)allocate(&arena, 32);
+    uint8_t* b = (uint8_t*)allocate(&arena, 32);
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+
+    /* releasing the last allocation hands its space back. */
+    release(&arena, b);
+    EXPECT_EQ(b, allocate(&arena, 32));
+
+    /* growing the last allocation keeps its address and contents. */
+    memset(b, 0x5A, 32);
+    uint8_t* grown = (uint8_t*)reallocate(&arena, b, 32, 512);
+    ASSERT_EQ(b, grown);
+    EXPECT_EQ(0x5A, grown[31]);
+
+    /* growing an older allocation copies it. */
+    memset(a, 0xA5, 32);
+    uint8_t* moved = (uint8_t*)reallocate(&arena, a, 32, 64);
+    ASSERT_NE(nullptr, moved);
+    EXPECT_NE(a, moved);
+    EXPECT_EQ(0xA5, moved[0]);
+    EXPECT_EQ(0xA5, moved[31]);
+
+    /* releasing an older allocation is a no-op. */
+    release(&arena, a);
+    uint8_t* c = (uint8_t*)allocate(&arena, 16);
+    EXPECT_NE(a, c);
+
+    dispose((disposable_t*)&arena);
+}
+
+/**
+ * Test that the arena can be reset through allocator_control().
+ */
+TEST_F(test_arena_allocator, control_key)
+{
+    allocator_options_t arena;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        arena_allocator_options_init(&arena, &backing.opts, nullptr, 0));
+
+    void* first = allocate(&arena, 100);
+    ASSERT_NE(nullptr, allocate(&arena, 100));
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        allocator_control(&arena, ARENA_ALLOCATOR_CONTROL_KEY_RESET, nullptr));
+    EXPECT_EQ(first, allocate(&arena, 100));
+
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS,
+        allocator_control(&arena, 0xFFFF, nullptr));
+
+    dispose((disposable_t*)&arena);
+}
+
+/**
+ * Test that a caller region is used first, and that nothing is kept from the
+ * backing allocator across resets.
+ */
+TEST_F(test_arena_allocator, caller_region)
+{
+    allocator_options_t arena;
+    alignas(16) uint8_t region[256];
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        arena_allocator_options_init(
+            &arena, &backing.opts, region, sizeof(region)));
+
+    /* only the context comes from the backing allocator. */
+    EXPECT_EQ(1, backing.allocations);
+
+    uint8_t* p = (uint8_t*)allocate(&arena, 100);
+    EXPECT_EQ(region, p);
+    ASSERT_NE(nullptr, allocate(&arena, 100));
+    EXPECT_EQ(1, backing.allocations);
+
+    /* overflow goes to the backing allocator. */
+    uint8_t* q = (uint8_t*)allocate(&arena, 100);
+    ASSERT_NE(nullptr, q);
+    EXPECT_TRUE(q < region || q >= region + sizeof(region));
+    EXPECT_EQ(2, backing.allocations);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, arena_allocator_reset(&arena));
+    EXPECT_EQ(1, backing.releases);
+    EXPECT_EQ(region, allocate(&arena, 100));
+
+    dispose((disposable_t*)&arena);
+    EXPECT_EQ(backing.allocations, backing.releases);
+}
+
+/**
+ * Test that a multi-field message is decoded into an arena and freed with a
+ * single reset.
+ */
+TEST_F(test_arena_allocator, decode_message)
+{
+    allocator_options_t arena;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    ssock sock;
+    const char* names[] = { "alpha", "beta", "gamma", "delta" };
+    uint8_t payload[300];
+
+    for (size_t i = 0; i < sizeof(payload); ++i)
+        payload[i] = (uint8_t)i;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&sock, stream, offset));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        arena_allocator_options_init(&arena, &backing.opts, nullptr, 0));
+
+    for (int message = 0; message < 20; ++message)
+    {
+        for (const char* name : names)
+        {
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                ssock_write_string(&sock, name));
+        }
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_data(&sock, payload, sizeof(payload)));
+    }
+
+    for (int message = 0; message < 20; ++message)
+    {
+        for (const char* name : names)
+        {
+            char* str = nullptr;
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                ssock_read_string(&sock, &arena, &str));
+            EXPECT_STREQ(name, str);
+        }
+
+        void* data = nullptr;
+        uint32_t size = 0;
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_data(&sock, &arena, &data, &size));
+        ASSERT_EQ(sizeof(payload), size);
+        EXPECT_EQ(0, memcmp(payload, data, size));
+
+        /* every field is freed at once. */
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, arena_allocator_reset(&arena));
+    }
+
+    /* the arena settled on one block for all messages. */
+    EXPECT_EQ(2, backing.allocations);
+
+    dispose((disposable_t*)&arena);
+    dispose((disposable_t*)&sock);
+    EXPECT_EQ(backing.allocations, backing.releases);
+}
@@ -0,0 +1,240 @@
+/**
+ * \file test/artifact_history/test_ssock_artifact_history.cpp
+ *
+ * Unit tests for artifact history queries over ssock.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vcblockchain/ssock_artifact_history.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "../block_store/block_store_test_util.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * \brief The pages received by a query.
+ */
+struct pages
+{
+    vector<size_t> sizes;
+    vector<uint8_t> ids;
+    size_t abort_after;
+};
+
+int onpage(void* context, const uint8_t* txn_ids, size_t count)
+{
+    pages* p = (pages*)context;
+
+    p->sizes.push_back(count);
+    p->ids.insert(p->ids.end(), txn_ids, txn_ids + count * BLOCK_STORE_ID_SIZE);
+
+    return p->sizes.size() == p->abort_after ? -1 : 0;
+}
+
+}
+
+class test_ssock_artifact_history : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        path = make_store_dir("test_ssock_artifact_history");
+        ASSERT_FALSE(path.empty());
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&store);
+        remove_store_dir(path);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Write a history of the given length for an artifact.
+     */
+    void write_history(const vector<uint8_t>& artifact_id, uint32_t length)
+    {
+        block_store_batch batch;
+        uint8_t txn[4] = { 1, 2, 3, 4 };
+        vector<vector<uint8_t>> txn_ids;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_init(&batch, &alloc_opts));
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            txn_ids.push_back(make_store_id(0x20, i));
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_batch_add_transaction(
+                    &batch, txn_ids.back().data(), artifact_id.data(), txn,
+                    sizeof(txn)));
+        }
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_write(&store, &batch));
+        dispose((disposable_t*)&batch);
+    }
+
+    /**
+     * \brief Run a query against a server over a socket pair.
+     */
+    int query(
+        const vector<uint8_t>& artifact_id, uint64_t start, uint64_t limit,
+        pages* result, int* server_status)
+    {
+        int sv[2];
+        int sndbuf = 4096;
+        EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+        /* a small send buffer makes the server wait on the client, as it
+         * would over a network. */
+        EXPECT_EQ(0,
+            setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)));
+
+        thread server_thread([&]() {
+            ssock sock;
+
+            ssock_init_from_posix(&sock, sv[0]);
+            *server_status =
+                ssock_artifact_history_serve(&sock, &alloc_opts, &store);
+            dispose((disposable_t*)&sock);
+        });
+
+        ssock sock;
+
+        ssock_init_from_posix(&sock, sv[1]);
+        int status =
+            ssock_artifact_history_query(
+                &sock, artifact_id.data(), start, limit, &onpage, result);
+
+        /* an aborted client hangs up, so the server does not wait. */
+        dispose((disposable_t*)&sock);
+        server_thread.join();
+
+        return status;
+    }
+
+    /**
+     * \brief Check that a result holds the given run of the history.
+     */
+    static void expect_ids(const pages& result, uint32_t start, uint32_t count)
+    {
+        ASSERT_EQ(count * BLOCK_STORE_ID_SIZE, result.ids.size());
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto txn_id = make_store_id(0x20, start + i);
+            EXPECT_EQ(0,
+                memcmp(txn_id.data(),
+                    result.ids.data() + i * BLOCK_STORE_ID_SIZE,
+                    BLOCK_STORE_ID_SIZE));
+        }
+    }
+
+    allocator_options_t alloc_opts;
+    string path;
+    block_store store;
+};
+
+/**
+ * Test that the query functions check their parameters.
+ */
+TEST_F(test_ssock_artifact_history, parameter_checks)
+{
+    ssock sock;
+    uint8_t id[BLOCK_STORE_ID_SIZE] = { 0 };
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_artifact_history_query(nullptr, id, 0, 0, &onpage, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_artifact_history_query(&sock, nullptr, 0, 0, &onpage, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_artifact_history_query(&sock, id, 0, 0, nullptr, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_artifact_history_serve(nullptr, &alloc_opts, &store));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_artifact_history_serve(&sock, nullptr, &store));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_artifact_history_serve(&sock, &alloc_opts, nullptr));
+}
+
+/**
+ * Test that a whole history arrives in full pages, then a short one.
+ */
+TEST_F(test_ssock_artifact_history, full_history)
+{
+    const uint32_t LENGTH = 2 * SSOCK_ARTIFACT_HISTORY_PAGE_SIZE + 88;
+    auto artifact_id = make_store_id(0x10, 0);
+    pages result = { {}, {}, 0 };
+    int server_status = -1;
+
+    write_history(artifact_id, LENGTH);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        query(artifact_id, 0, 0, &result, &server_status));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, server_status);
+    ASSERT_EQ(3U, result.sizes.size());
+    EXPECT_EQ((size_t)SSOCK_ARTIFACT_HISTORY_PAGE_SIZE, result.sizes[0]);
+    EXPECT_EQ((size_t)SSOCK_ARTIFACT_HISTORY_PAGE_SIZE, result.sizes[1]);
+    EXPECT_EQ(88U, result.sizes[2]);
+    expect_ids(result, 0, LENGTH);
+}
+
+/**
+ * Test that the start and limit select a run of the history.
+ */
+TEST_F(test_ssock_artifact_history, start_and_limit)
+{
+    auto artifact_id = make_store_id(0x10, 0);
+    int server_status = -1;
+
+    write_history(artifact_id, 1000);
+
+    pages run = { {}, {}, 0 };
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        query(artifact_id, 100, 300, &run, &server_status));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, server_status);
+    expect_ids(run, 100, 300);
+
+    /* a limit past the end stops at the end. */
+    pages tail = { {}, {}, 0 };
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        query(artifact_id, 990, 300, &tail, &server_status));
+    expect_ids(tail, 990, 10);
+
+    /* no pages for an unknown artifact, or a start past the end. */
+    pages none = { {}, {}, 0 };
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        query(make_store_id(0x10, 1), 0, 0, &none, &server_status));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        query(artifact_id, 1000, 0, &none, &server_status));
+    EXPECT_TRUE(none.sizes.empty());
+}
+
+/**
+ * Test that a callback can abort a query, and that the server sees the client
+ * hang up as a failed write.
+ */
+TEST_F(test_ssock_artifact_history, abort)
+{
+    auto artifact_id = make_store_id(0x10, 0);
+    pages result = { {}, {}, 1 };
+    int server_status = 0;
+
+    /* far more than the send buffer holds. */
+    write_history(artifact_id, 32 * SSOCK_ARTIFACT_HISTORY_PAGE_SIZE);
+
+    EXPECT_EQ(-1, query(artifact_id, 0, 0, &result, &server_status));
+    EXPECT_EQ(1U, result.sizes.size());
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_WRITE, server_status);
+}
@@ -0,0 +1,499 @@
+/**
+ * \file test/block_builder/test_block_builder.cpp
+ *
+ * Unit tests for the block builder.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vcblockchain/block_builder.h>
+#include <vcblockchain/block_verifier.h>
+#include <vcblockchain/merkle_tree.h>
+#include <vcblockchain/signature_batch.h>
+#include <vccert/builder.h>
+#include <vccert/certificate_types.h>
+#include <vccert/fields.h>
+#include <vccert/parser.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+static const uint8_t BLOCK_ID[16] = {
+    0x22, 0x6f, 0x0c, 0x91, 0x4d, 0x1e, 0x47, 0x3a,
+    0x95, 0x08, 0xe1, 0x2c, 0x7b, 0x40, 0xd6, 0x13 };
+static const uint8_t PREV_BLOCK_ID[16] = {
+    0x5b, 0x03, 0x9e, 0x7d, 0x18, 0x64, 0x4f, 0xc2,
+    0x81, 0x2a, 0x3f, 0x9b, 0x06, 0xee, 0x71, 0x58 };
+static const uint8_t SIGNER_ID[16] = {
+    0x0f, 0x84, 0x3d, 0x62, 0xa7, 0x15, 0x49, 0x9c,
+    0xb3, 0x50, 0x2e, 0x08, 0xd1, 0x6a, 0x97, 0x44 };
+
+class test_block_builder : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_digital_signature_init(&suite, &sign));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature_private_key(
+                &suite, &private_key));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature_public_key(
+                &suite, &public_key));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_digital_signature_keypair_create(
+                &sign, &private_key, &public_key));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_parser_options_simple_init(
+                &parser_opts, &alloc_opts, &suite));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&parser_opts);
+        dispose((disposable_t*)&public_key);
+        dispose((disposable_t*)&private_key);
+        dispose((disposable_t*)&sign);
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Make stand-in transaction certificates of varying sizes.
+     */
+    vector<vector<uint8_t>> make_transactions(size_t count)
+    {
+        vector<vector<uint8_t>> txns;
+        for (size_t i = 0; i < count; ++i)
+        {
+            txns.emplace_back(20 + (i * 37) % 300, (uint8_t)i);
+        }
+
+        return txns;
+    }
+
+    vector<size_t> sizes_of(const vector<vector<uint8_t>>& txns)
+    {
+        vector<size_t> sizes;
+        for (const auto& txn : txns)
+        {
+            sizes.push_back(txn.size());
+        }
+
+        return sizes;
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    vccrypt_digital_signature_context_t sign;
+    vccrypt_buffer_t private_key;
+    vccrypt_buffer_t public_key;
+    vccert_parser_options_t parser_opts;
+};
+
+/**
+ * Test that the builder functions check their parameters.
+ */
+TEST_F(test_block_builder, parameter_checks)
+{
+    block_builder builder;
+    size_t sizes[2] = { 10, BLOCK_BUILDER_MAX_TRANSACTION_SIZE + 1 };
+    uint8_t hash[64];
+    const uint8_t* block;
+    size_t size;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            nullptr, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 1, sizes,
+            1, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &builder, nullptr, &suite, BLOCK_ID, PREV_BLOCK_ID, 1, sizes, 1,
+            nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &builder, &alloc_opts, nullptr, BLOCK_ID, PREV_BLOCK_ID, 1, sizes,
+            1, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, nullptr, PREV_BLOCK_ID, 1, sizes,
+            1, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, nullptr, 1, sizes, 1,
+            nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 1, nullptr,
+            1, nullptr));
+
+    /* a transaction too large for a short field. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 1, sizes,
+            2, nullptr));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 1, sizes,
+            1, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_add_transaction(nullptr, hash, 10));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_add_transaction(&builder, nullptr, 10));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_emit(
+            nullptr, SIGNER_ID, &private_key, hash, &block, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_emit(
+            &builder, nullptr, &private_key, hash, &block, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_emit(&builder, SIGNER_ID, nullptr, hash, &block, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, nullptr, &block, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash, nullptr, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash, &block, nullptr));
+
+    dispose((disposable_t*)&builder);
+}
+
+/**
+ * Test that a full block fills its buffer exactly, carries every field, and
+ * is signed over everything before the signature.
+ */
+TEST_F(test_block_builder, build_block)
+{
+    block_builder builder;
+    auto txns = make_transactions(50);
+    auto sizes = sizes_of(txns);
+    vector<uint8_t> hash(suite.hash_opts.hash_size);
+    const uint8_t* block;
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 99,
+            sizes.data(), sizes.size(), nullptr));
+
+    uint8_t* buffer = builder.buffer;
+    for (const auto& txn : txns)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_builder_add_transaction(&builder, txn.data(), txn.size()));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash.data(), &block, &size));
+
+    /* the buffer never moved, and is exactly full. */
+    EXPECT_EQ(buffer, block);
+    EXPECT_EQ(builder.capacity, size);
+
+    /* the fields read back in order. */
+    vccert_parser_context_t parser;
+    const uint8_t* value;
+    size_t value_size;
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_init(&parser_opts, &parser, block, size));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_CERTIFICATE_VERSION, &value,
+            &value_size));
+    ASSERT_EQ(4U, value_size);
+    EXPECT_EQ(0x00, value[0]);
+    EXPECT_EQ(0x01, value[1]);
+    EXPECT_EQ(0x00, value[2]);
+    EXPECT_EQ(0x00, value[3]);
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_CERTIFICATE_CRYPTO_SUITE, &value,
+            &value_size));
+    ASSERT_EQ(2U, value_size);
+    EXPECT_EQ(suite.suite_id, (uint32_t)((value[0] << 8) | value[1]));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_CERTIFICATE_TYPE, &value,
+            &value_size));
+    ASSERT_EQ(16U, value_size);
+    EXPECT_EQ(0,
+        memcmp(vccert_certificate_type_uuid_txn_block, value, value_size));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_BLOCK_UUID, &value, &value_size));
+    EXPECT_EQ(0, memcmp(BLOCK_ID, value, sizeof(BLOCK_ID)));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, &value, &value_size));
+    ASSERT_EQ(8U, value_size);
+    EXPECT_EQ(99, value[7]);
+
+    size_t i = 0;
+    int retval =
+        vccert_parser_find_short(
+            &parser, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE, &value,
+            &value_size);
+    while (VCCERT_STATUS_SUCCESS == retval)
+    {
+        ASSERT_LT(i, txns.size());
+        ASSERT_EQ(txns[i].size(), value_size);
+        EXPECT_EQ(0, memcmp(txns[i].data(), value, value_size));
+        ++i;
+        retval = vccert_parser_find_next(&parser, &value, &value_size);
+    }
+    EXPECT_EQ(txns.size(), i);
+    dispose((disposable_t*)&parser);
+
+    /* the streamed hash matches a hash of the signed bytes. */
+    size_t signed_size = size - 4 - suite.sign_opts.signature_size;
+    vccrypt_hash_context_t hash_ctx;
+    vccrypt_buffer_t expected;
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_hash_init(&suite, &hash_ctx));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_buffer_init_for_hash(&suite, &expected));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_hash_digest(&hash_ctx, block, signed_size));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_hash_finalize(&hash_ctx, &expected));
+    EXPECT_EQ(0, memcmp(expected.data, hash.data(), hash.size()));
+    dispose((disposable_t*)&expected);
+    dispose((disposable_t*)&hash_ctx);
+
+    /* the signature verifies. */
+    signature_batch batch;
+    size_t failed_index;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_init(
+            &batch, &alloc_opts, &suite, &parser_opts, nullptr, 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_add_certificate(&batch, block, size, &public_key));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_verify(&batch, &failed_index));
+    dispose((disposable_t*)&batch);
+
+    dispose((disposable_t*)&builder);
+}
+
+/**
+ * Test that transactions beyond the reservation are refused, and that an
+ * emitted block is closed.
+ */
+TEST_F(test_block_builder, capacity_and_emitted)
+{
+    block_builder builder;
+    auto txns = make_transactions(3);
+    auto sizes = sizes_of(txns);
+    vector<uint8_t> hash(suite.hash_opts.hash_size);
+    vector<uint8_t> big(txns[1].size() + 1);
+    const uint8_t* block;
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 5,
+            sizes.data(), 2, nullptr));
+
+    /* the two smallest reserved fit; anything past the reservation doesn't. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_add_transaction(&builder, txns[0].data(), txns[0].size()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_CAPACITY,
+        block_builder_add_transaction(&builder, big.data(), big.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_add_transaction(&builder, txns[1].data(), txns[1].size()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_CAPACITY,
+        block_builder_add_transaction(&builder, txns[2].data(), 0));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash.data(), &block, &size));
+    EXPECT_EQ(builder.capacity, size);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED,
+        block_builder_add_transaction(&builder, txns[2].data(), 1));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_BUILDER_EMITTED,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash.data(), &block, &size));
+
+    dispose((disposable_t*)&builder);
+}
+
+/**
+ * Test that a block with fewer transactions than reserved is emitted at its
+ * actual size.
+ */
+TEST_F(test_block_builder, partial_block)
+{
+    block_builder builder;
+    auto txns = make_transactions(4);
+    auto sizes = sizes_of(txns);
+    vector<uint8_t> hash(suite.hash_opts.hash_size);
+    const uint8_t* block;
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 5,
+            sizes.data(), sizes.size(), nullptr));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_add_transaction(&builder, txns[0].data(), txns[0].size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash.data(), &block, &size));
+
+    EXPECT_EQ(builder.capacity - (txns[1].size() + txns[2].size()
+            + txns[3].size() + 3 * 4), size);
+
+    dispose((disposable_t*)&builder);
+}
+
+/**
+ * Test that a block built with a Merkle tree commits to the tree's root, and
+ * that each transaction can be proven against the root in the block.
+ */
+TEST_F(test_block_builder, merkle_root)
+{
+    block_builder builder;
+    merkle_tree tree;
+    auto txns = make_transactions(13);
+    auto sizes = sizes_of(txns);
+    vector<uint8_t> hash(suite.hash_opts.hash_size);
+    vector<uint8_t> root(suite.hash_opts.hash_size);
+    const uint8_t* block;
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_init(&tree, &alloc_opts, &suite));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 7,
+            sizes.data(), sizes.size(), &tree));
+    for (const auto& txn : txns)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_builder_add_transaction(&builder, txn.data(), txn.size()));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash.data(), &block, &size));
+    EXPECT_EQ(builder.capacity, size);
+    EXPECT_EQ(txns.size(), merkle_tree_count(&tree));
+
+    /* a tree which already has leaves can't be used for a new block. */
+    block_builder other;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_builder_init(
+            &other, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 8,
+            sizes.data(), sizes.size(), &tree));
+
+    /* the root field matches the tree. */
+    vccert_parser_context_t parser;
+    const uint8_t* value;
+    size_t value_size;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_root(&tree, root.data()));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_init(&parser_opts, &parser, block, size));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_parser_find_short(
+            &parser, MERKLE_TREE_FIELD_TYPE_ROOT, &value, &value_size));
+    ASSERT_EQ(root.size(), value_size);
+    EXPECT_EQ(0, memcmp(root.data(), value, value_size));
+
+    /* every transaction is proven against the root in the block. */
+    vector<uint8_t> proof(MERKLE_TREE_MAX_LEVELS * suite.hash_opts.hash_size);
+    for (size_t i = 0; i < txns.size(); ++i)
+    {
+        size_t proof_size = proof.size();
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            merkle_tree_prove(&tree, i, proof.data(), &proof_size));
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            merkle_tree_verify(
+                &suite, txns[i].data(), txns[i].size(), i, txns.size(),
+                proof.data(), proof_size, value));
+    }
+
+    dispose((disposable_t*)&parser);
+    dispose((disposable_t*)&builder);
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * Test that a built block of signed transactions passes the block verifier.
+ */
+TEST_F(test_block_builder, verifier_round_trip)
+{
+    vccert_builder_options_t builder_opts;
+    vector<vector<uint8_t>> txns;
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_builder_options_init(&builder_opts, &alloc_opts, &suite));
+    for (uint64_t i = 0; i < 20; ++i)
+    {
+        vccert_builder_context_t txn_builder;
+        size_t txn_size;
+
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_init(&builder_opts, &txn_builder, 1024));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_uint64(
+                &txn_builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, i));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_sign(&txn_builder, SIGNER_ID, &private_key));
+
+        const uint8_t* cert = vccert_builder_emit(&txn_builder, &txn_size);
+        txns.emplace_back(cert, cert + txn_size);
+        dispose((disposable_t*)&txn_builder);
+    }
+
+    block_builder builder;
+    auto sizes = sizes_of(txns);
+    vector<uint8_t> hash(suite.hash_opts.hash_size);
+    const uint8_t* block;
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_init(
+            &builder, &alloc_opts, &suite, BLOCK_ID, PREV_BLOCK_ID, 12,
+            sizes.data(), sizes.size(), nullptr));
+    for (const auto& txn : txns)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_builder_add_transaction(&builder, txn.data(), txn.size()));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_builder_emit(
+            &builder, SIGNER_ID, &private_key, hash.data(), &block, &size));
+
+    thread_pool pool;
+    block_verifier verifier;
+    size_t failed_index;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_init(&pool, &alloc_opts, 4));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &verifier, &alloc_opts, &parser_opts, &pool, nullptr, 0, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(&verifier, block, size, &failed_index));
+
+    dispose((disposable_t*)&verifier);
+    dispose((disposable_t*)&pool);
+    dispose((disposable_t*)&builder);
+    dispose((disposable_t*)&builder_opts);
+}
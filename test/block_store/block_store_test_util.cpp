@@ -0,0 +1,62 @@
+/**
+ * \file test/block_store/block_store_test_util.cpp
+ *
+ * Helpers shared by the tests which use a block store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "block_store_test_util.h"
+
+using namespace std;
+
+/**
+ * \brief Create a temporary directory to hold a block store.
+ *
+ * \param name      The name of the test, used as the directory prefix.
+ *
+ * \returns the path of the new directory, or an empty string on failure.
+ */
+string make_store_dir(const char* name)
+{
+    string dir = string("/tmp/") + name + ".XXXXXX";
+
+    if (nullptr == mkdtemp(&dir[0]))
+    {
+        return string();
+    }
+
+    return dir;
+}
+
+/**
+ * \brief Remove a temporary block store directory and its database files.
+ *
+ * \param path      The path of the directory to remove.
+ */
+void remove_store_dir(const string& path)
+{
+    unlink((path + "/data.mdb").c_str());
+    unlink((path + "/lock.mdb").c_str());
+    rmdir(path.c_str());
+}
+
+/**
+ * \brief Make a block store id from a tag and a number.
+ *
+ * \param tag       The byte with which to fill the id.
+ * \param n         The number to write at offset 4 of the id.
+ *
+ * \returns the id.
+ */
+vector<uint8_t> make_store_id(uint8_t tag, uint32_t n)
+{
+    vector<uint8_t> id(BLOCK_STORE_ID_SIZE, tag);
+    memcpy(id.data() + 4, &n, sizeof(n));
+
+    return id;
+}
@@ -0,0 +1,47 @@
+/**
+ * \file test/block_store/block_store_test_util.h
+ *
+ * Helpers shared by the tests which use a block store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#ifndef TEST_BLOCK_STORE_BLOCK_STORE_TEST_UTIL_HEADER_GUARD
+#define TEST_BLOCK_STORE_BLOCK_STORE_TEST_UTIL_HEADER_GUARD
+
+#ifndef __cplusplus
+#error This is a C++ only header.
+#endif /*__cplusplus*/
+
+#include <cstdint>
+#include <string>
+#include <vcblockchain/block_store.h>
+#include <vector>
+
+/**
+ * \brief Create a temporary directory to hold a block store.
+ *
+ * \param name      The name of the test, used as the directory prefix.
+ *
+ * \returns the path of the new directory, or an empty string on failure.
+ */
+std::string make_store_dir(const char* name);
+
+/**
+ * \brief Remove a temporary block store directory and its database files.
+ *
+ * \param path      The path of the directory to remove.
+ */
+void remove_store_dir(const std::string& path);
+
+/**
+ * \brief Make a block store id from a tag and a number.
+ *
+ * \param tag       The byte with which to fill the id.
+ * \param n         The number to write at offset 4 of the id.
+ *
+ * \returns the id.
+ */
+std::vector<uint8_t> make_store_id(uint8_t tag, uint32_t n);
+
+#endif /*TEST_BLOCK_STORE_BLOCK_STORE_TEST_UTIL_HEADER_GUARD*/
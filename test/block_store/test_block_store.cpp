@@ -0,0 +1,655 @@
+/**
+ * \file test/block_store/test_block_store.cpp
+ *
+ * Unit tests for the block store.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vcblockchain/block_store.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "block_store_test_util.h"
+
+using namespace std;
+
+class test_block_store : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        path = make_store_dir("test_block_store");
+        ASSERT_FALSE(path.empty());
+    }
+
+    void TearDown() override
+    {
+        remove_store_dir(path);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+    string path;
+};
+
+/**
+ * Test that the store functions check their parameters.
+ */
+TEST_F(test_block_store, parameter_checks)
+{
+    block_store store;
+    block_store_batch batch;
+    vccrypt_buffer_t buffer;
+    uint8_t id[BLOCK_STORE_ID_SIZE] = { 0 };
+    uint64_t height;
+    size_t count;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_init(nullptr, &alloc_opts, path.c_str(), 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_init(&store, nullptr, path.c_str(), 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_init(&store, &alloc_opts, nullptr, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_init(nullptr, &alloc_opts));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_init(&batch, nullptr));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_block(nullptr, id, 1, id, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_block(&batch, nullptr, 1, id, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_block(&batch, id, 1, nullptr, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_transaction(nullptr, id, id, id, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_transaction(&batch, nullptr, id, id, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_transaction(&batch, id, nullptr, id, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_batch_add_transaction(&batch, id, id, nullptr, sizeof(id)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, block_store_write(nullptr, &batch));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, block_store_write(&store, nullptr));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_block(nullptr, id, &buffer));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_block(&store, nullptr, &buffer));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_block(&store, id, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_transaction(nullptr, id, &buffer));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_transaction(&store, nullptr, &buffer));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_transaction(&store, id, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_block_id(nullptr, 1, id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_block_id(&store, 1, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_latest(nullptr, id, id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_latest(&store, nullptr, id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_latest(&store, id, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_max_height(nullptr, &height));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_max_height(&store, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_history(nullptr, id, 0, id, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_history(&store, nullptr, 0, id, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_history(&store, id, 0, nullptr, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_get_artifact_history(&store, id, 0, id, 1, nullptr));
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that a batch of blocks and transactions is written in one commit, and
+ * can be read back through every table.
+ */
+TEST_F(test_block_store, write_and_read)
+{
+    block_store store;
+    block_store_batch batch;
+    vccrypt_buffer_t buffer;
+    uint8_t id[BLOCK_STORE_ID_SIZE];
+    uint64_t height;
+    auto artifact = make_store_id(0xA0, 1);
+    vector<vector<uint8_t>> block_ids, txn_ids, blocks, txns;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+
+    /* nothing has been written yet. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_max_height(&store, &height));
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        block_ids.push_back(make_store_id(0xB0, i));
+        blocks.push_back(vector<uint8_t>(100 + i, (uint8_t)i));
+        txn_ids.push_back(make_store_id(0xC0, i));
+        txns.push_back(vector<uint8_t>(10 + i, (uint8_t)~i));
+    }
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_add_transaction(
+                &batch, txn_ids[i].data(), artifact.data(), txns[i].data(),
+                txns[i].size()));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_add_block(
+                &batch, block_ids[i].data(), i + 1, blocks[i].data(),
+                blocks[i].size()));
+    }
+
+    size_t commits = store.commits;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+    EXPECT_EQ(commits + 1, store.commits);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_block(&store, block_ids[i].data(), &buffer));
+        ASSERT_EQ(blocks[i].size(), buffer.size);
+        EXPECT_EQ(0, memcmp(blocks[i].data(), buffer.data, buffer.size));
+        dispose((disposable_t*)&buffer);
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_transaction(&store, txn_ids[i].data(), &buffer));
+        ASSERT_EQ(txns[i].size(), buffer.size);
+        EXPECT_EQ(0, memcmp(txns[i].data(), buffer.data, buffer.size));
+        dispose((disposable_t*)&buffer);
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_block_id(&store, i + 1, id));
+        EXPECT_EQ(0, memcmp(block_ids[i].data(), id, sizeof(id)));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&store, &height));
+    EXPECT_EQ(100U, height);
+
+    /* the last transaction for the artifact is its latest. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_artifact_latest(&store, artifact.data(), id));
+    EXPECT_EQ(0, memcmp(txn_ids[99].data(), id, sizeof(id)));
+
+    /* unknown keys are not found. */
+    auto missing = make_store_id(0xEE, 0);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_block(&store, missing.data(), &buffer));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_transaction(&store, missing.data(), &buffer));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_artifact_latest(&store, missing.data(), id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_block_id(&store, 101, id));
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that heights written out of order are still found, and that the
+ * store's contents survive reopening it.
+ */
+TEST_F(test_block_store, out_of_order_and_reopen)
+{
+    block_store store;
+    block_store_batch batch;
+    uint8_t id[BLOCK_STORE_ID_SIZE];
+    uint64_t height;
+    uint8_t block[32] = { 0 };
+    auto high = make_store_id(0xB1, 10);
+    auto low = make_store_id(0xB1, 5);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_block(
+            &batch, high.data(), 10, block, sizeof(block)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+
+    block_store_batch_clear(&batch);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_block(
+            &batch, low.data(), 5, block, sizeof(block)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+
+    dispose((disposable_t*)&store);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_block_id(&store, 5, id));
+    EXPECT_EQ(0, memcmp(low.data(), id, sizeof(id)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_block_id(&store, 10, id));
+    EXPECT_EQ(0, memcmp(high.data(), id, sizeof(id)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&store, &height));
+    EXPECT_EQ(10U, height);
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that batches written from several threads at once are all committed,
+ * in no more commits than writes, and that each thread reads its own writes.
+ */
+TEST_F(test_block_store, concurrent_writers)
+{
+    block_store store;
+    const uint32_t THREADS = 8;
+    const uint32_t WRITES = 50;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+
+    vector<thread> threads;
+    for (uint32_t t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            block_store_batch batch;
+            vccrypt_buffer_t buffer;
+            auto artifact = make_store_id(0xA1, t);
+            uint8_t id[BLOCK_STORE_ID_SIZE];
+
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_batch_init(&batch, &alloc_opts));
+
+            for (uint32_t w = 0; w < WRITES; ++w)
+            {
+                auto txn_id = make_store_id(0xC1, t * WRITES + w);
+                auto txn = vector<uint8_t>(16 + w, (uint8_t)t);
+
+                block_store_batch_clear(&batch);
+                ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    block_store_batch_add_transaction(
+                        &batch, txn_id.data(), artifact.data(), txn.data(),
+                        txn.size()));
+                ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    block_store_write(&store, &batch));
+
+                ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    block_store_get_transaction(&store, txn_id.data(), &buffer));
+                EXPECT_EQ(txn.size(), buffer.size);
+                dispose((disposable_t*)&buffer);
+                ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    block_store_get_artifact_latest(
+                        &store, artifact.data(), id));
+                EXPECT_EQ(0, memcmp(txn_id.data(), id, sizeof(id)));
+            }
+
+            dispose((disposable_t*)&batch);
+        });
+    }
+
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+
+    EXPECT_GE((size_t)(THREADS * WRITES), store.commits);
+    EXPECT_LT(0U, store.commits);
+
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that a batch which can't be written fails alone, even when it is
+ * committed in a group with other writers' batches.
+ */
+TEST_F(test_block_store, failed_batch_isolated)
+{
+    block_store store;
+    const uint32_t THREADS = 8;
+    const uint32_t WRITES = 50;
+    const size_t MAP_SIZE = 1024 * 1024;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), MAP_SIZE));
+
+    vector<thread> threads;
+    for (uint32_t t = 0; t <= THREADS; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            block_store_batch batch;
+            auto artifact = make_store_id(0xA2, t);
+            vector<uint8_t> txn(THREADS == t ? 2 * MAP_SIZE : 16, (uint8_t)t);
+
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_batch_init(&batch, &alloc_opts));
+
+            /* the last thread's batch is larger than the whole map. */
+            for (uint32_t w = 0; w < WRITES; ++w)
+            {
+                auto txn_id = make_store_id(0xC2, t * WRITES + w);
+
+                block_store_batch_clear(&batch);
+                ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    block_store_batch_add_transaction(
+                        &batch, txn_id.data(), artifact.data(), txn.data(),
+                        txn.size()));
+                EXPECT_EQ(
+                    THREADS == t
+                        ? VCBLOCKCHAIN_ERROR_BLOCK_STORE_DATABASE
+                        : VCBLOCKCHAIN_STATUS_SUCCESS,
+                    block_store_write(&store, &batch));
+            }
+
+            dispose((disposable_t*)&batch);
+        });
+    }
+
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+
+    /* every good batch was written, and nothing of the bad one. */
+    vccrypt_buffer_t buffer;
+    for (uint32_t i = 0; i < THREADS * WRITES; ++i)
+    {
+        auto txn_id = make_store_id(0xC2, i);
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_transaction(&store, txn_id.data(), &buffer));
+        dispose((disposable_t*)&buffer);
+    }
+
+    auto bad_id = make_store_id(0xC2, THREADS * WRITES);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_transaction(&store, bad_id.data(), &buffer));
+
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that each artifact's history is kept in commit order, whichever
+ * batches its transactions arrive in, and can be read a page at a time.
+ */
+TEST_F(test_block_store, artifact_history)
+{
+    block_store store;
+    block_store_batch batch;
+    const uint32_t ARTIFACTS = 3;
+    const uint32_t TRANSACTIONS = 50;
+    uint8_t txn[4] = { 1, 2, 3, 4 };
+    uint8_t page[7 * BLOCK_STORE_ID_SIZE];
+    size_t count;
+    vector<vector<uint8_t>> ids;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+
+    for (uint32_t a = 0; a < ARTIFACTS; ++a)
+    {
+        ids.push_back(make_store_id(0x10, a));
+    }
+
+    /* interleave the artifacts, a few transactions to a batch. */
+    for (uint32_t i = 0; i < TRANSACTIONS; ++i)
+    {
+        for (uint32_t a = 0; a < ARTIFACTS; ++a)
+        {
+            ids.push_back(make_store_id(0x20 + a, i));
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_batch_add_transaction(
+                    &batch, ids.back().data(), ids[a].data(), txn,
+                    sizeof(txn)));
+        }
+
+        if (0 == i % 4)
+        {
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_write(&store, &batch));
+            block_store_batch_clear(&batch);
+        }
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+
+    /* page through each history. */
+    for (uint32_t a = 0; a < ARTIFACTS; ++a)
+    {
+        auto artifact_id = make_store_id(0x10, a);
+        uint64_t start = 0;
+
+        do
+        {
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_get_artifact_history(
+                    &store, artifact_id.data(), start, page, 7, &count));
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto txn_id = make_store_id(0x20 + a, (uint32_t)(start + i));
+                EXPECT_EQ(0,
+                    memcmp(txn_id.data(), page + i * BLOCK_STORE_ID_SIZE,
+                        BLOCK_STORE_ID_SIZE));
+            }
+
+            start += count;
+        } while (7 == count);
+
+        EXPECT_EQ(TRANSACTIONS, start);
+    }
+
+    /* past the end, and unknown artifacts, give empty pages. */
+    auto artifact_id = make_store_id(0x10, 0);
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_artifact_history(
+            &store, artifact_id.data(), TRANSACTIONS, page, 7, &count));
+    EXPECT_EQ(0U, count);
+    auto unknown = make_store_id(0x10, ARTIFACTS);
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_artifact_history(
+            &store, unknown.data(), 0, page, 7, &count));
+    EXPECT_EQ(0U, count);
+
+    /* histories continue across a reopen. */
+    dispose((disposable_t*)&store);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    block_store_batch_clear(&batch);
+    auto late = make_store_id(0x30, 0);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_transaction(
+            &batch, late.data(), artifact_id.data(), txn, sizeof(txn)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_artifact_history(
+            &store, artifact_id.data(), TRANSACTIONS - 1, page, 7, &count));
+    ASSERT_EQ(2U, count);
+    EXPECT_EQ(0,
+        memcmp(late.data(), page + BLOCK_STORE_ID_SIZE, BLOCK_STORE_ID_SIZE));
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that a scan walks a range of heights in order, and can be stopped.
+ */
+TEST_F(test_block_store, scan_blocks)
+{
+    block_store store;
+    block_store_batch batch;
+    vector<vector<uint8_t>> ids;
+    vector<uint64_t> heights;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+
+    /* every other height, so the scan skips the gaps. */
+    for (uint32_t i = 1; i <= 20; ++i)
+    {
+        ids.push_back(make_store_id(0x40, 2 * i));
+    }
+
+    for (uint32_t i = 1; i <= 20; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_add_block(
+                &batch, ids[i - 1].data(), 2 * i, ids[i - 1].data(),
+                BLOCK_STORE_ID_SIZE));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+
+    auto record =
+        [](void* context, uint64_t height, const uint8_t* block_id,
+            const void* block, size_t size)
+        {
+            EXPECT_EQ((size_t)BLOCK_STORE_ID_SIZE, size);
+            EXPECT_EQ(0, memcmp(block_id, block, BLOCK_STORE_ID_SIZE));
+            vector<uint64_t>* heights = (vector<uint64_t>*)context;
+            heights->push_back(height);
+
+            return 10 == heights->size() ? -1 : 0;
+        };
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_scan_blocks(nullptr, 0, 1, record, &heights));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_scan_blocks(&store, 0, 1, nullptr, &heights));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_scan_blocks(&store, 5, 12, record, &heights));
+    EXPECT_EQ(vector<uint64_t>({ 6, 8, 10, 12 }), heights);
+
+    /* an empty range, and a range past the top. */
+    heights.clear();
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_scan_blocks(&store, 13, 13, record, &heights));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_scan_blocks(&store, 41, UINT64_MAX, record, &heights));
+    EXPECT_TRUE(heights.empty());
+
+    /* the callback stops the scan. */
+    EXPECT_EQ(-1,
+        block_store_scan_blocks(&store, 0, UINT64_MAX, record, &heights));
+    EXPECT_EQ(10U, heights.size());
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&store);
+}
+
+/**
+ * Test that an artifact scan sees the latest transaction of each artifact, in
+ * id order, with the tip of the chain.
+ */
+TEST_F(test_block_store, scan_artifacts)
+{
+    block_store store;
+    block_store_batch batch;
+    vector<vector<uint8_t>> ids;
+    vector<pair<vector<uint8_t>, vector<uint8_t>>> artifacts;
+    uint8_t txn[4] = { 1, 2, 3, 4 };
+    uint8_t block_id[BLOCK_STORE_ID_SIZE];
+    uint64_t height = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+
+    auto record =
+        [](void* context, const uint8_t* artifact_id, const uint8_t* txn_id)
+        {
+            auto artifacts =
+                (vector<pair<vector<uint8_t>, vector<uint8_t>>>*)context;
+            artifacts->push_back(make_pair(
+                vector<uint8_t>(artifact_id, artifact_id + BLOCK_STORE_ID_SIZE),
+                vector<uint8_t>(txn_id, txn_id + BLOCK_STORE_ID_SIZE)));
+
+            return 2 == artifacts->size() ? -1 : 0;
+        };
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_scan_artifacts(
+            nullptr, record, &artifacts, &height, block_id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_scan_artifacts(
+            &store, nullptr, &artifacts, &height, block_id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_scan_artifacts(
+            &store, record, &artifacts, nullptr, block_id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_store_scan_artifacts(
+            &store, record, &artifacts, &height, nullptr));
+
+    /* an empty store has no tip. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_scan_artifacts(
+            &store, record, &artifacts, &height, block_id));
+
+    /* two blocks; the second updates artifact 1. */
+    for (uint32_t i = 1; i <= 2; ++i)
+    {
+        ids.push_back(make_store_id(0x40, i));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_add_block(
+                &batch, ids.back().data(), i, txn, sizeof(txn)));
+    }
+
+    ids.push_back(make_store_id(0x10, 1));
+    ids.push_back(make_store_id(0x10, 0));
+    ids.push_back(make_store_id(0x20, 0));
+    ids.push_back(make_store_id(0x20, 1));
+    ids.push_back(make_store_id(0x20, 2));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_transaction(
+            &batch, ids[4].data(), ids[2].data(), txn, sizeof(txn)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_transaction(
+            &batch, ids[5].data(), ids[3].data(), txn, sizeof(txn)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_transaction(
+            &batch, ids[6].data(), ids[2].data(), txn, sizeof(txn)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, block_store_write(&store, &batch));
+
+    /* the callback stops the scan. */
+    EXPECT_EQ(-1,
+        block_store_scan_artifacts(
+            &store, record, &artifacts, &height, block_id));
+    EXPECT_EQ(2U, height);
+    EXPECT_EQ(0, memcmp(ids[1].data(), block_id, BLOCK_STORE_ID_SIZE));
+    ASSERT_EQ(2U, artifacts.size());
+    EXPECT_EQ(ids[3], artifacts[0].first);
+    EXPECT_EQ(ids[5], artifacts[0].second);
+    EXPECT_EQ(ids[2], artifacts[1].first);
+    EXPECT_EQ(ids[6], artifacts[1].second);
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&store);
+}
@@ -0,0 +1,360 @@
+/**
+ * \file test/block_verifier/test_block_verifier.cpp
+ *
+ * Unit tests for the parallel block verifier.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vcblockchain/block_verifier.h>
+#include <vccert/builder.h>
+#include <vccert/fields.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+static const uint8_t SIGNER_ID[16] = {
+    0x41, 0x00, 0x4e, 0x0d, 0x5c, 0x21, 0x4b, 0x6e,
+    0x8a, 0x37, 0x12, 0x44, 0x0b, 0x9e, 0x52, 0x7f };
+
+class test_block_verifier : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature_private_key(
+                &suite, &private_key));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_options_init(&builder_opts, &alloc_opts, &suite));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_parser_options_simple_init(
+                &parser_opts, &alloc_opts, &suite));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            thread_pool_init(&pool, &alloc_opts, 4));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&pool);
+        dispose((disposable_t*)&parser_opts);
+        dispose((disposable_t*)&builder_opts);
+        dispose((disposable_t*)&private_key);
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Build a signed transaction carrying the given sequence number.
+     */
+    vector<uint8_t> make_transaction(uint64_t sequence)
+    {
+        vccert_builder_context_t builder;
+        size_t size;
+
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_init(&builder_opts, &builder, 1024));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_uint64(
+                &builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, sequence));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_sign(&builder, SIGNER_ID, &private_key));
+
+        const uint8_t* cert = vccert_builder_emit(&builder, &size);
+        vector<uint8_t> txn(cert, cert + size);
+        dispose((disposable_t*)&builder);
+
+        return txn;
+    }
+
+    /**
+     * \brief Build a signed block wrapping the given transactions.
+     */
+    vector<uint8_t> make_block(
+        const vector<vector<uint8_t>>& txns, bool with_height = true,
+        uint64_t height = 17)
+    {
+        vccert_builder_context_t builder;
+        size_t size;
+
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_init(&builder_opts, &builder, 128 * 1024));
+        if (with_height)
+        {
+            EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+                vccert_builder_add_short_uint64(
+                    &builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, height));
+        }
+
+        for (const auto& txn : txns)
+        {
+            EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+                vccert_builder_add_short_buffer(
+                    &builder, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE,
+                    txn.data(), txn.size()));
+        }
+
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_sign(&builder, SIGNER_ID, &private_key));
+
+        const uint8_t* cert = vccert_builder_emit(&builder, &size);
+        vector<uint8_t> block(cert, cert + size);
+        dispose((disposable_t*)&builder);
+
+        return block;
+    }
+
+    vector<vector<uint8_t>> make_transactions(size_t count)
+    {
+        vector<vector<uint8_t>> txns;
+        for (size_t i = 0; i < count; ++i)
+        {
+            txns.push_back(make_transaction(i));
+        }
+
+        return txns;
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    vccrypt_buffer_t private_key;
+    vccert_builder_options_t builder_opts;
+    vccert_parser_options_t parser_opts;
+    thread_pool pool;
+};
+
+/**
+ * Test that init and verify check their parameters.
+ */
+TEST_F(test_block_verifier, parameter_checks)
+{
+    block_verifier verifier;
+    size_t failed_index;
+    uint8_t block[4] = { 0 };
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_verifier_init(
+            nullptr, &alloc_opts, &parser_opts, &pool, nullptr, 0, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_verifier_init(
+            &verifier, nullptr, &parser_opts, &pool, nullptr, 0, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_verifier_init(
+            &verifier, &alloc_opts, nullptr, &pool, nullptr, 0, 0));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &verifier, &alloc_opts, &parser_opts, &pool, nullptr, 0, 0));
+    EXPECT_EQ((size_t)BLOCK_VERIFIER_DEFAULT_BATCH_SIZE, verifier.batch_size);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_verifier_verify(nullptr, block, sizeof(block), &failed_index));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_verifier_verify(&verifier, nullptr, 0, &failed_index));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        block_verifier_verify(&verifier, block, sizeof(block), nullptr));
+
+    dispose((disposable_t*)&verifier);
+}
+
+/**
+ * Test that a valid block verifies, with and without a pool.
+ */
+TEST_F(test_block_verifier, valid_block)
+{
+    block_verifier pooled, inline_verifier;
+    size_t failed_index = 0;
+    auto block = make_block(make_transactions(100));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &pooled, &alloc_opts, &parser_opts, &pool, nullptr, 4, 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &inline_verifier, &alloc_opts, &parser_opts, nullptr, nullptr, 0,
+            0));
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &pooled, block.data(), block.size(), &failed_index));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &inline_verifier, block.data(), block.size(), &failed_index));
+
+    /* a block without transactions is valid too. */
+    auto empty = make_block(vector<vector<uint8_t>>());
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &pooled, empty.data(), empty.size(), &failed_index));
+
+    dispose((disposable_t*)&inline_verifier);
+    dispose((disposable_t*)&pooled);
+}
+
+/**
+ * Test that the lowest failing transaction is reported, however the batches
+ * are scheduled.
+ */
+TEST_F(test_block_verifier, lowest_failure_reported)
+{
+    block_verifier verifier;
+    auto txns = make_transactions(200);
+
+    /* corrupt the signatures of several transactions. */
+    for (size_t bad : { 190, 73, 150, 74 })
+    {
+        txns[bad][txns[bad].size() - 1] ^= 0xFF;
+    }
+
+    auto block = make_block(txns);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &verifier, &alloc_opts, &parser_opts, &pool, nullptr, 3, 0));
+
+    for (int round = 0; round < 20; ++round)
+    {
+        size_t failed_index = 0;
+        EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_TRANSACTION_INVALID,
+            block_verifier_verify(
+                &verifier, block.data(), block.size(), &failed_index));
+        EXPECT_EQ(73U, failed_index);
+    }
+
+    dispose((disposable_t*)&verifier);
+}
+
+/**
+ * Test that a block failing attestation, or missing its height, is reported
+ * as a block failure.
+ */
+TEST_F(test_block_verifier, invalid_block)
+{
+    block_verifier verifier;
+    size_t failed_index = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &verifier, &alloc_opts, &parser_opts, &pool, nullptr, 2, 0));
+
+    auto block = make_block(make_transactions(20));
+    block[block.size() - 1] ^= 0xFF;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_INVALID,
+        block_verifier_verify(
+            &verifier, block.data(), block.size(), &failed_index));
+    EXPECT_EQ((size_t)BLOCK_VERIFIER_BLOCK_INDEX, failed_index);
+
+    auto no_height = make_block(make_transactions(4), false);
+    failed_index = 0;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_INVALID,
+        block_verifier_verify(
+            &verifier, no_height.data(), no_height.size(), &failed_index));
+    EXPECT_EQ((size_t)BLOCK_VERIFIER_BLOCK_INDEX, failed_index);
+
+    /* a truncated block doesn't parse. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_INVALID,
+        block_verifier_verify(&verifier, block.data(), 3, &failed_index));
+
+    dispose((disposable_t*)&verifier);
+}
+
+/**
+ * Test that certificates seen before are answered by the cache, and that
+ * failing certificates are never cached.
+ */
+TEST_F(test_block_verifier, cache_skips_repeat_attestation)
+{
+    block_verifier verifier;
+    cert_cache cache;
+    size_t failed_index = 0;
+    auto txns = make_transactions(40);
+    auto block = make_block(txns);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_init(&cache, &alloc_opts, &suite, 1024));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &verifier, &alloc_opts, &parser_opts, &pool, &cache, 4, 0));
+
+    /* the first pass attests the block and every transaction. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &verifier, block.data(), block.size(), &failed_index));
+    EXPECT_EQ(0U, cache.hits);
+    EXPECT_EQ(41U, cache.misses);
+
+    /* the second pass is answered by the cache. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &verifier, block.data(), block.size(), &failed_index));
+    EXPECT_EQ(41U, cache.hits);
+
+    /* a new block reusing the transactions only attests the block. */
+    txns[7][txns[7].size() - 1] ^= 0xFF;
+    auto tampered = make_block(txns);
+    for (int round = 0; round < 2; ++round)
+    {
+        EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_TRANSACTION_INVALID,
+            block_verifier_verify(
+                &verifier, tampered.data(), tampered.size(), &failed_index));
+        EXPECT_EQ(7U, failed_index);
+    }
+
+    dispose((disposable_t*)&verifier);
+    dispose((disposable_t*)&cache);
+}
+
+/**
+ * Test that a verdict is only reused at the same height, with the same
+ * contract setting.
+ */
+TEST_F(test_block_verifier, cache_keyed_by_context)
+{
+    block_verifier verifier, contracts;
+    cert_cache cache;
+    size_t failed_index = 0;
+    auto txns = make_transactions(10);
+    auto block = make_block(txns);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_init(&cache, &alloc_opts, &suite, 1024));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &verifier, &alloc_opts, &parser_opts, nullptr, &cache, 0, 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_init(
+            &contracts, &alloc_opts, &parser_opts, nullptr, &cache, 0, 1));
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &verifier, block.data(), block.size(), &failed_index));
+    EXPECT_EQ(0U, cache.hits);
+    EXPECT_EQ(11U, cache.misses);
+
+    /* the same transactions in a block at another height are attested. */
+    auto higher = make_block(txns, true, 18);
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &verifier, higher.data(), higher.size(), &failed_index));
+    EXPECT_EQ(0U, cache.hits);
+    EXPECT_EQ(22U, cache.misses);
+
+    /* and so is the same block with contracts checked. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_verifier_verify(
+            &contracts, block.data(), block.size(), &failed_index));
+    EXPECT_EQ(0U, cache.hits);
+    EXPECT_EQ(33U, cache.misses);
+
+    dispose((disposable_t*)&contracts);
+    dispose((disposable_t*)&verifier);
+    dispose((disposable_t*)&cache);
+}
@@ -0,0 +1,227 @@
+/**
+ * \file test/cert_cache/test_cert_cache.cpp
+ *
+ * Unit tests for the verified-certificate cache.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vcblockchain/cert_cache.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+class test_cert_cache : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Compute the digest of a small certificate standing in for the
+     * given number.
+     */
+    vector<uint8_t> digest_of(cert_cache* cache, uint32_t n)
+    {
+        vector<uint8_t> digest(cache->digest_size);
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            cert_cache_digest(
+                cache, nullptr, 0, &n, sizeof(n), digest.data()));
+
+        return digest;
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+};
+
+/**
+ * Test that init and digest check their parameters.
+ */
+TEST_F(test_cert_cache, parameter_checks)
+{
+    cert_cache cache;
+    uint8_t digest[CERT_CACHE_MAX_DIGEST_SIZE];
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_init(nullptr, &alloc_opts, &suite, 16));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_init(&cache, nullptr, &suite, 16));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_init(&cache, &alloc_opts, nullptr, 16));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_init(&cache, &alloc_opts, &suite, 0));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_init(&cache, &alloc_opts, &suite, 16));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_digest(nullptr, nullptr, 0, digest, 1, digest));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_digest(&cache, nullptr, 1, digest, 1, digest));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_digest(&cache, nullptr, 0, nullptr, 1, digest));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        cert_cache_digest(&cache, nullptr, 0, digest, 1, nullptr));
+
+    /* the same certificate in another context has another digest. */
+    uint8_t other[CERT_CACHE_MAX_DIGEST_SIZE];
+    uint8_t context = 1;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_digest(&cache, nullptr, 0, &context, 1, digest));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_digest(&cache, &context, 1, &context, 1, other));
+    EXPECT_NE(0, memcmp(digest, other, cache.digest_size));
+
+    dispose((disposable_t*)&cache);
+}
+
+/**
+ * Test that inserted digests are found, and others are not.
+ */
+TEST_F(test_cert_cache, insert_and_lookup)
+{
+    cert_cache cache;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_init(&cache, &alloc_opts, &suite, 1024));
+
+    for (uint32_t i = 0; i < 500; ++i)
+    {
+        auto digest = digest_of(&cache, i);
+        EXPECT_FALSE(cert_cache_contains(&cache, digest.data()));
+        cert_cache_insert(&cache, digest.data());
+
+        /* inserting twice keeps one entry. */
+        cert_cache_insert(&cache, digest.data());
+    }
+
+    for (uint32_t i = 0; i < 500; ++i)
+    {
+        EXPECT_TRUE(cert_cache_contains(&cache, digest_of(&cache, i).data()));
+        EXPECT_FALSE(
+            cert_cache_contains(&cache, digest_of(&cache, 1000 + i).data()));
+    }
+
+    EXPECT_EQ(500U, cache.hits);
+    EXPECT_EQ(1000U, cache.misses);
+
+    dispose((disposable_t*)&cache);
+}
+
+/**
+ * Test that a full cache stays bounded, and that CLOCK eviction keeps the
+ * entries which are hit.
+ */
+TEST_F(test_cert_cache, clock_eviction)
+{
+    cert_cache cache;
+    const uint32_t CAPACITY = 16 * CERT_CACHE_SHARDS;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_init(&cache, &alloc_opts, &suite, CAPACITY));
+
+    /* a hot set, hit between every insert of a stream of cold digests. */
+    vector<vector<uint8_t>> hot;
+    for (uint32_t i = 0; i < CAPACITY / 4; ++i)
+    {
+        hot.push_back(digest_of(&cache, i));
+        cert_cache_insert(&cache, hot.back().data());
+    }
+
+    for (uint32_t i = 0; i < 8 * CAPACITY; ++i)
+    {
+        cert_cache_insert(&cache, digest_of(&cache, 100000 + i).data());
+        if (0 == i % 8)
+        {
+            for (const auto& digest : hot)
+            {
+                cert_cache_contains(&cache, digest.data());
+            }
+        }
+    }
+
+    size_t hot_kept = 0;
+    for (const auto& digest : hot)
+    {
+        hot_kept += cert_cache_contains(&cache, digest.data()) ? 1 : 0;
+    }
+
+    size_t cold_kept = 0;
+    for (uint32_t i = 0; i < 8 * CAPACITY; ++i)
+    {
+        cold_kept +=
+            cert_cache_contains(&cache, digest_of(&cache, 100000 + i).data())
+                ? 1 : 0;
+    }
+
+    EXPECT_EQ(hot.size(), hot_kept);
+    EXPECT_GE(CAPACITY - hot.size(), cold_kept);
+
+    dispose((disposable_t*)&cache);
+}
+
+/**
+ * Test that the cache can be used from several threads at once.
+ */
+TEST_F(test_cert_cache, concurrent_use)
+{
+    cert_cache cache;
+    vector<thread> threads;
+    vector<vector<uint8_t>> digests;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        cert_cache_init(&cache, &alloc_opts, &suite, 256));
+
+    for (uint32_t i = 0; i < 1024; ++i)
+    {
+        digests.push_back(digest_of(&cache, i));
+    }
+
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int round = 0; round < 20; ++round)
+            {
+                for (size_t i = t; i < digests.size(); i += 3)
+                {
+                    if (!cert_cache_contains(&cache, digests[i].data()))
+                    {
+                        cert_cache_insert(&cache, digests[i].data());
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+
+    size_t kept = 0;
+    for (const auto& digest : digests)
+    {
+        kept += cert_cache_contains(&cache, digest.data()) ? 1 : 0;
+    }
+
+    EXPECT_LT(0U, kept);
+    EXPECT_GE(256U, kept);
+
+    dispose((disposable_t*)&cache);
+}
@@ -0,0 +1,266 @@
+/**
+ * \file test/checkpoint/test_checkpoint.cpp
+ *
+ * Unit tests for checkpoints.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vcblockchain/checkpoint.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "../block_store/block_store_test_util.h"
+
+using namespace std;
+
+class test_checkpoint : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+        path = make_store_dir("test_checkpoint");
+        ASSERT_FALSE(path.empty());
+        checkpoint_path = path + "/checkpoint";
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_init(&store, &alloc_opts, path.c_str(), 0));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&store);
+        unlink(checkpoint_path.c_str());
+        remove_store_dir(path);
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Write a block, and a transaction for each of the given
+     * artifacts, in one batch.
+     */
+    void write_block(uint64_t height, const vector<uint32_t>& artifacts)
+    {
+        block_store_batch batch;
+        uint8_t data[4] = { 1, 2, 3, 4 };
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_init(&batch, &alloc_opts));
+
+        ids.push_back(make_store_id(0x60, (uint32_t)height));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_add_block(
+                &batch, ids.back().data(), height, data, sizeof(data)));
+        for (uint32_t artifact : artifacts)
+        {
+            ids.push_back(make_store_id(0x70, artifact));
+            ids.push_back(
+                make_store_id(0x80, (uint32_t)(height << 16 | artifact)));
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_batch_add_transaction(
+                    &batch, ids.back().data(), ids[ids.size() - 2].data(),
+                    data, sizeof(data)));
+        }
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_write(&store, &batch));
+        dispose((disposable_t*)&batch);
+    }
+
+    /**
+     * \brief Flip one byte of the checkpoint file.
+     */
+    void corrupt(size_t offset)
+    {
+        fstream file(checkpoint_path, ios::in | ios::out | ios::binary);
+        char c;
+
+        file.seekg(offset);
+        file.get(c);
+        file.seekp(offset);
+        file.put(c ^ 0x01);
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    string path, checkpoint_path;
+    block_store store;
+    vector<vector<uint8_t>> ids;
+};
+
+/**
+ * Test that the checkpoint functions check their parameters.
+ */
+TEST_F(test_checkpoint, parameter_checks)
+{
+    checkpoint cp;
+    uint8_t id[BLOCK_STORE_ID_SIZE] = { 0 };
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_write(nullptr, &suite, checkpoint_path.c_str()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_write(&store, nullptr, checkpoint_path.c_str()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_write(&store, &suite, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_open(nullptr, &suite, checkpoint_path.c_str()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_open(&cp, nullptr, checkpoint_path.c_str()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_open(&cp, &suite, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_get_artifact_latest(nullptr, id, id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_get_artifact_latest(&cp, nullptr, id));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        checkpoint_get_artifact_latest(&cp, id, nullptr));
+}
+
+/**
+ * Test that a checkpoint records the tip and the latest transaction of every
+ * artifact, and that only later blocks are left to replay.
+ */
+TEST_F(test_checkpoint, write_and_open)
+{
+    checkpoint cp;
+    uint8_t txn_id[BLOCK_STORE_ID_SIZE];
+    const uint32_t ARTIFACTS = 300;
+
+    /* each block changes a different subset of the artifacts. */
+    for (uint64_t height = 1; height <= 10; ++height)
+    {
+        vector<uint32_t> artifacts;
+        for (uint32_t a = 0; a < ARTIFACTS; ++a)
+        {
+            if (0 == a % height)
+            {
+                artifacts.push_back(a);
+            }
+        }
+
+        write_block(height, artifacts);
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        checkpoint_write(&store, &suite, checkpoint_path.c_str()));
+
+    /* blocks after the checkpoint are left for replay. */
+    write_block(11, { 0 });
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+    EXPECT_EQ(10U, cp.height);
+    EXPECT_EQ(0, memcmp(make_store_id(0x60, 10).data(), cp.block_id, BLOCK_STORE_ID_SIZE));
+    EXPECT_EQ(ARTIFACTS, cp.artifact_count);
+
+    for (uint32_t a = 0; a < ARTIFACTS; ++a)
+    {
+        uint64_t latest = 1;
+        for (uint64_t height = 1; height <= 10; ++height)
+        {
+            if (0 == a % height)
+            {
+                latest = height;
+            }
+        }
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            checkpoint_get_artifact_latest(
+                &cp, make_store_id(0x70, a).data(), txn_id));
+        EXPECT_EQ(0,
+            memcmp(make_store_id(0x80, (uint32_t)(latest << 16 | a)).data(), txn_id,
+                BLOCK_STORE_ID_SIZE));
+    }
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_CHECKPOINT_NOT_FOUND,
+        checkpoint_get_artifact_latest(
+            &cp, make_store_id(0x70, ARTIFACTS).data(), txn_id));
+
+    vector<uint64_t> replayed;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_scan_blocks(
+            &store, cp.height + 1, UINT64_MAX,
+            [](void* context, uint64_t height, const uint8_t*, const void*, size_t) {
+                ((vector<uint64_t>*)context)->push_back(height);
+                return 0;
+            },
+            &replayed));
+    EXPECT_EQ(vector<uint64_t>({ 11 }), replayed);
+
+    dispose((disposable_t*)&cp);
+
+    /* a new checkpoint replaces the old one. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        checkpoint_write(&store, &suite, checkpoint_path.c_str()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+    EXPECT_EQ(11U, cp.height);
+    EXPECT_NE(0, access((checkpoint_path + ".tmp").c_str(), F_OK));
+    dispose((disposable_t*)&cp);
+}
+
+/**
+ * Test that an empty store has nothing to checkpoint.
+ */
+TEST_F(test_checkpoint, empty_store)
+{
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        checkpoint_write(&store, &suite, checkpoint_path.c_str()));
+    EXPECT_NE(0, access(checkpoint_path.c_str(), F_OK));
+    EXPECT_NE(0, access((checkpoint_path + ".tmp").c_str(), F_OK));
+}
+
+/**
+ * Test that missing, damaged, and truncated checkpoints are rejected.
+ */
+TEST_F(test_checkpoint, rejects_damage)
+{
+    checkpoint cp;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_CHECKPOINT_IO,
+        checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+
+    write_block(1, { 1, 2, 3 });
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        checkpoint_write(&store, &suite, checkpoint_path.c_str()));
+
+    /* read the file back, to damage copies of it. */
+    ifstream in(checkpoint_path, ios::binary);
+    vector<char> original(
+        (istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    size_t entries = original.size() - 3 * CHECKPOINT_ENTRY_SIZE;
+
+    /* the magic, the height, an entry, and the digest are all covered. */
+    for (size_t offset : { (size_t)0, (size_t)16, entries + 40, entries - 1 })
+    {
+        corrupt(offset);
+        EXPECT_EQ(VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID,
+            checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+        corrupt(offset);
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+    dispose((disposable_t*)&cp);
+
+    /* a truncated file doesn't match its count. */
+    ASSERT_EQ(0,
+        truncate(checkpoint_path.c_str(), original.size() - CHECKPOINT_ENTRY_SIZE));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID,
+        checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+    ASSERT_EQ(0, truncate(checkpoint_path.c_str(), 10));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_CHECKPOINT_INVALID,
+        checkpoint_open(&cp, &suite, checkpoint_path.c_str()));
+}
@@ -0,0 +1,85 @@
+/**
+ * \file test/crc32c/test_crc32c.cpp
+ *
+ * Unit tests for crc32c.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <vcblockchain/crc32c.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * \brief Bit-at-a-time reference implementation of CRC32C.
+ */
+static uint32_t reference_crc32c(const uint8_t* data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+    }
+
+    return ~crc;
+}
+
+/**
+ * Test the standard check value and the empty input.
+ */
+TEST(test_crc32c, check_value)
+{
+    EXPECT_EQ(0xE3069283U, crc32c(0, "123456789", 9));
+    EXPECT_EQ(0U, crc32c(0, "", 0));
+}
+
+/**
+ * Test that crc32c matches the reference at every length and alignment.
+ */
+TEST(test_crc32c, matches_reference)
+{
+    vector<uint8_t> buf(1100);
+    uint32_t x = 1;
+
+    for (auto& b : buf)
+    {
+        x = x * 1103515245 + 12345;
+        b = (uint8_t)(x >> 24);
+    }
+
+    for (size_t offset = 0; offset < 8; ++offset)
+    {
+        for (size_t size = 0; size < 1050; size += (size < 64 ? 1 : 61))
+        {
+            EXPECT_EQ(
+                reference_crc32c(buf.data() + offset, size),
+                crc32c(0, buf.data() + offset, size));
+        }
+    }
+}
+
+/**
+ * Test that a checksum can be computed incrementally.
+ */
+TEST(test_crc32c, incremental)
+{
+    vector<uint8_t> buf(500);
+
+    for (size_t i = 0; i < buf.size(); ++i)
+        buf[i] = (uint8_t)(i * 31);
+
+    uint32_t whole = crc32c(0, buf.data(), buf.size());
+
+    for (size_t split = 0; split <= buf.size(); split += 37)
+    {
+        uint32_t crc = crc32c(0, buf.data(), split);
+        crc = crc32c(crc, buf.data() + split, buf.size() - split);
+
+        EXPECT_EQ(whole, crc);
+    }
+}
@@ -0,0 +1,641 @@
+/**
+ * \file test/fast_sync/test_ssock_fast_sync.cpp
+ *
+ * Unit tests for fast sync.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <functional>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <vcblockchain/ssock_fast_sync.h>
+#include <vccert/builder.h>
+#include <vccert/fields.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "../block_store/block_store_test_util.h"
+
+using namespace std;
+
+static const uint8_t SIGNER_ID[16] = {
+    0x41, 0x00, 0x4e, 0x0d, 0x5c, 0x21, 0x4b, 0x6e,
+    0x8a, 0x37, 0x12, 0x44, 0x0b, 0x9e, 0x52, 0x7f };
+
+class test_ssock_fast_sync : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature_private_key(
+                &suite, &private_key));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_options_init(&builder_opts, &alloc_opts, &suite));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_parser_options_simple_init(
+                &parser_opts, &alloc_opts, &suite));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_verifier_init(
+                &verifier, &alloc_opts, &parser_opts, nullptr, nullptr, 0,
+                0));
+
+        server_path = make_store_dir("test_ssock_fast_sync");
+        ASSERT_FALSE(server_path.empty());
+        client_path = make_store_dir("test_ssock_fast_sync");
+        ASSERT_FALSE(client_path.empty());
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_init(
+                &server_store, &alloc_opts, server_path.c_str(), 0));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_init(
+                &client_store, &alloc_opts, client_path.c_str(), 0));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&client_store);
+        dispose((disposable_t*)&server_store);
+        remove_store_dir(client_path);
+        remove_store_dir(server_path);
+        dispose((disposable_t*)&verifier);
+        dispose((disposable_t*)&parser_opts);
+        dispose((disposable_t*)&builder_opts);
+        dispose((disposable_t*)&private_key);
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Build a signed transaction for an artifact.
+     */
+    vector<uint8_t> make_transaction(
+        const vector<uint8_t>& txn_id, const vector<uint8_t>& artifact_id)
+    {
+        vccert_builder_context_t builder;
+        size_t size;
+
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_init(&builder_opts, &builder, 1024));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_buffer(
+                &builder, VCCERT_FIELD_TYPE_CERTIFICATE_ID, txn_id.data(),
+                txn_id.size()));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_buffer(
+                &builder, VCCERT_FIELD_TYPE_ARTIFACT_ID, artifact_id.data(),
+                artifact_id.size()));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_sign(&builder, SIGNER_ID, &private_key));
+
+        const uint8_t* cert = vccert_builder_emit(&builder, &size);
+        vector<uint8_t> txn(cert, cert + size);
+        dispose((disposable_t*)&builder);
+
+        return txn;
+    }
+
+    /**
+     * \brief Build a signed block at the given height, linked to the block
+     * below it, and wrapping the given transactions.
+     */
+    vector<uint8_t> make_block(
+        uint64_t height, uint32_t id_tag = 0x50, uint32_t previous_tag = 0x50,
+        const vector<vector<uint8_t>>& txns = {})
+    {
+        vccert_builder_context_t builder;
+        size_t size;
+        auto id = make_store_id(id_tag, (uint32_t)height);
+        auto previous_id = make_store_id(previous_tag, (uint32_t)(height - 1));
+
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_init(&builder_opts, &builder, 1024));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_buffer(
+                &builder, VCCERT_FIELD_TYPE_BLOCK_UUID, id.data(), id.size()));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_buffer(
+                &builder, VCCERT_FIELD_TYPE_PREVIOUS_BLOCK_UUID,
+                previous_id.data(), previous_id.size()));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_uint64(
+                &builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, height));
+        for (const auto& txn : txns)
+        {
+            EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+                vccert_builder_add_short_buffer(
+                    &builder, VCCERT_FIELD_TYPE_WRAPPED_TRANSACTION_TUPLE,
+                    txn.data(), txn.size()));
+        }
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_sign(&builder, SIGNER_ID, &private_key));
+
+        const uint8_t* cert = vccert_builder_emit(&builder, &size);
+        vector<uint8_t> block(cert, cert + size);
+        dispose((disposable_t*)&builder);
+
+        return block;
+    }
+
+    /**
+     * \brief Write blocks at the given heights to the server's store.
+     */
+    void write_blocks(const vector<uint64_t>& heights)
+    {
+        block_store_batch batch;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_init(&batch, &alloc_opts));
+        for (uint64_t height : heights)
+        {
+            ids.push_back(make_store_id(0x50, (uint32_t)height));
+            blocks.push_back(make_block(height));
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                block_store_batch_add_block(
+                    &batch, ids.back().data(), height, blocks.back().data(),
+                    blocks.back().size()));
+        }
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_write(&server_store, &batch));
+        dispose((disposable_t*)&batch);
+    }
+
+    /**
+     * \brief Pull a range from a server over a socket pair.
+     */
+    int pull(
+        function<int(ssock*)> server, uint64_t start, uint64_t end,
+        uint64_t* count)
+    {
+        int sv[2];
+        int server_status = -1;
+        EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+        thread server_thread([&]() {
+            ssock sock;
+
+            ssock_init_from_posix(&sock, sv[0]);
+            server_status = server(&sock);
+            dispose((disposable_t*)&sock);
+        });
+
+        ssock sock;
+
+        ssock_init_from_posix(&sock, sv[1]);
+        int status =
+            ssock_fast_sync_pull(
+                &sock, &alloc_opts, &client_store, &verifier, start, end,
+                count);
+
+        /* a failed client hangs up, so the server does not wait; only a
+         * server whose response was read whole must have succeeded. */
+        dispose((disposable_t*)&sock);
+        server_thread.join();
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status)
+        {
+            EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, server_status);
+        }
+
+        return status;
+    }
+
+    int pull(uint64_t start, uint64_t end, uint64_t* count)
+    {
+        return
+            pull(
+                [&](ssock* sock) {
+                    return ssock_fast_sync_serve(sock, &server_store);
+                },
+                start, end, count);
+    }
+
+    /**
+     * \brief Check that the client's store holds the server's block at a
+     * height.
+     */
+    void expect_block(uint64_t height)
+    {
+        uint8_t server_id[BLOCK_STORE_ID_SIZE], client_id[BLOCK_STORE_ID_SIZE];
+        vccrypt_buffer_t server_block, client_block;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_block_id(&server_store, height, server_id));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_block_id(&client_store, height, client_id));
+        EXPECT_EQ(0, memcmp(server_id, client_id, BLOCK_STORE_ID_SIZE));
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_block(&server_store, server_id, &server_block));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_get_block(&client_store, client_id, &client_block));
+        ASSERT_EQ(server_block.size, client_block.size);
+        EXPECT_EQ(0,
+            memcmp(server_block.data, client_block.data, client_block.size));
+
+        dispose((disposable_t*)&client_block);
+        dispose((disposable_t*)&server_block);
+    }
+
+    /**
+     * \brief Send a block as a server would, under the given height and the
+     * block's id for that height.
+     */
+    static void send(ssock* sock, uint64_t height, const vector<uint8_t>& block)
+    {
+        auto id = make_store_id(0x50, (uint32_t)height);
+
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_uint8(sock, SSOCK_FAST_SYNC_BLOCK));
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_uint64(sock, height));
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_data(sock, id.data(), id.size()));
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_data(sock, block.data(), block.size()));
+    }
+
+    /**
+     * \brief Read a request as a server would.
+     */
+    static void read_request(ssock* sock)
+    {
+        uint64_t start, end;
+
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint64(sock, &start));
+        EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint64(sock, &end));
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    vccrypt_buffer_t private_key;
+    vccert_builder_options_t builder_opts;
+    vccert_parser_options_t parser_opts;
+    block_verifier verifier;
+    string server_path, client_path;
+    block_store server_store, client_store;
+    vector<vector<uint8_t>> ids, blocks;
+};
+
+/**
+ * Test that the fast sync functions check their parameters.
+ */
+TEST_F(test_ssock_fast_sync, parameter_checks)
+{
+    ssock sock;
+    uint64_t count;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_pull(
+            nullptr, &alloc_opts, &client_store, &verifier, 0, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_pull(
+            &sock, nullptr, &client_store, &verifier, 0, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_pull(
+            &sock, &alloc_opts, nullptr, &verifier, 0, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_pull(
+            &sock, &alloc_opts, &client_store, nullptr, 0, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_pull(
+            &sock, &alloc_opts, &client_store, &verifier, 2, 1, &count));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_pull(
+            &sock, &alloc_opts, &client_store, &verifier, 0, 1, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_serve(nullptr, &server_store));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_fast_sync_serve(&sock, nullptr));
+}
+
+/**
+ * Test that a chain longer than the pipeline and a scan slice is copied
+ * whole, and that a range copies only its part.
+ */
+TEST_F(test_ssock_fast_sync, full_chain_and_range)
+{
+    const uint64_t HEIGHT =
+        SSOCK_FAST_SYNC_SCAN_SLICE + 3 * SSOCK_FAST_SYNC_PIPELINE_DEPTH + 5;
+    vector<uint64_t> heights;
+    uint64_t count = 0, max_height = 0;
+
+    for (uint64_t height = 1; height <= HEIGHT; ++height)
+    {
+        heights.push_back(height);
+    }
+
+    write_blocks(heights);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, pull(1, 20, &count));
+    EXPECT_EQ(20U, count);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&client_store, &max_height));
+    EXPECT_EQ(20U, max_height);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        pull(21, UINT64_MAX, &count));
+    EXPECT_EQ(HEIGHT - 20, count);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&client_store, &max_height));
+    EXPECT_EQ(HEIGHT, max_height);
+
+    for (uint64_t height = 1; height <= HEIGHT; ++height)
+    {
+        expect_block(height);
+    }
+
+    /* nothing past the tip. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        pull(HEIGHT + 1, UINT64_MAX, &count));
+    EXPECT_EQ(0U, count);
+}
+
+/**
+ * Test that blocks are verified, and that the blocks before a failing one are
+ * still stored.
+ */
+TEST_F(test_ssock_fast_sync, verified)
+{
+    vector<uint64_t> heights;
+    uint64_t count = 0, max_height = 0;
+
+    for (uint64_t height = 1; height <= 100; ++height)
+    {
+        heights.push_back(height);
+    }
+
+    write_blocks(heights);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, pull(1, 50, &count));
+    EXPECT_EQ(50U, count);
+
+    /* a block tampered with on the server fails, and stops the sync. */
+    block_store_batch batch;
+    vector<uint8_t> tampered = blocks[69];
+    tampered[tampered.size() - 1] ^= 0xFF;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_add_block(
+            &batch, ids[69].data(), 70, tampered.data(), tampered.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_write(&server_store, &batch));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_INVALID,
+        pull(51, UINT64_MAX, &count));
+    EXPECT_EQ(19U, count);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&client_store, &max_height));
+    EXPECT_EQ(69U, max_height);
+
+    dispose((disposable_t*)&batch);
+}
+
+/**
+ * Test that blocks out of order, after a gap, or outside of the range, are
+ * rejected.
+ */
+TEST_F(test_ssock_fast_sync, out_of_sequence)
+{
+    uint64_t count = 0;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 1, make_block(1));
+                send(sock, 1, make_block(1));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            1, 10, &count));
+    EXPECT_EQ(1U, count);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 2, make_block(2));
+                send(sock, 4, make_block(4));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            2, 10, &count));
+    EXPECT_EQ(1U, count);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 3, make_block(3));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            1, 2, &count));
+    EXPECT_EQ(0U, count);
+}
+
+/**
+ * Test that the first block must follow on from the store's tip, or be the
+ * first block of the chain if the store is empty.
+ */
+TEST_F(test_ssock_fast_sync, follows_tip)
+{
+    uint64_t count = 0, max_height = 0;
+
+    /* an empty store starts from the first block of the chain. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 2, make_block(2));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            2, 10, &count));
+    EXPECT_EQ(0U, count);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_STORE_NOT_FOUND,
+        block_store_get_max_height(&client_store, &max_height));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 1, make_block(1));
+                send(sock, 2, make_block(2));
+                EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    ssock_write_uint8(sock, SSOCK_FAST_SYNC_END));
+                return ssock_write_int32(sock, VCBLOCKCHAIN_STATUS_SUCCESS);
+            },
+            1, 10, &count));
+    EXPECT_EQ(2U, count);
+
+    /* a block above the tip would leave a gap. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 4, make_block(4));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            3, 10, &count));
+    EXPECT_EQ(0U, count);
+
+    /* ... and a block at or below the tip is already stored. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_SEQUENCE,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 2, make_block(2));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            1, 10, &count));
+    EXPECT_EQ(0U, count);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&client_store, &max_height));
+    EXPECT_EQ(2U, max_height);
+}
+
+/**
+ * Test that a block is only stored under its own height and id, and only if
+ * it links to the block before it.
+ */
+TEST_F(test_ssock_fast_sync, mismatch)
+{
+    uint64_t count = 0, max_height = 0;
+
+    /* a validly signed block, announced under another height. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 1, make_block(3));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            1, 10, &count));
+    EXPECT_EQ(0U, count);
+
+    /* ... or under another id. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 1, make_block(1, 0x51));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            1, 10, &count));
+    EXPECT_EQ(0U, count);
+
+    /* a block which doesn't link to the block before it in the pull. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 1, make_block(1));
+                send(sock, 2, make_block(2));
+                send(sock, 3, make_block(3, 0x50, 0x51));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            1, 10, &count));
+    EXPECT_EQ(2U, count);
+
+    /* the first block must link to the store's tip. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_FAST_SYNC_MISMATCH,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 3, make_block(3, 0x50, 0x51));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            3, 10, &count));
+    EXPECT_EQ(0U, count);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        pull(
+            [&](ssock* sock) {
+                read_request(sock);
+                send(sock, 3, make_block(3));
+                EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    ssock_write_uint8(sock, SSOCK_FAST_SYNC_END));
+                return ssock_write_int32(sock, VCBLOCKCHAIN_STATUS_SUCCESS);
+            },
+            3, 10, &count));
+    EXPECT_EQ(1U, count);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_max_height(&client_store, &max_height));
+    EXPECT_EQ(3U, max_height);
+}
+
+/**
+ * Test that the transactions wrapped in synced blocks are stored, so that the
+ * synced store answers transaction and artifact queries.
+ */
+TEST_F(test_ssock_fast_sync, transactions)
+{
+    auto artifact_id = make_store_id(0xA0, 1);
+    vector<vector<uint8_t>> txns;
+    block_store_batch batch;
+    uint64_t count = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_batch_init(&batch, &alloc_opts));
+    for (uint64_t height = 1; height <= 3; ++height)
+    {
+        txns.push_back(
+            make_transaction(
+                make_store_id(0x70, (uint32_t)height), artifact_id));
+        ids.push_back(make_store_id(0x50, (uint32_t)height));
+        blocks.push_back(make_block(height, 0x50, 0x50, { txns.back() }));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            block_store_batch_add_block(
+                &batch, ids.back().data(), height, blocks.back().data(),
+                blocks.back().size()));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_write(&server_store, &batch));
+    dispose((disposable_t*)&batch);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, pull(1, UINT64_MAX, &count));
+    EXPECT_EQ(3U, count);
+
+    /* the latest transaction is the one in the highest block. */
+    uint8_t txn_id[BLOCK_STORE_ID_SIZE];
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_artifact_latest(
+            &client_store, artifact_id.data(), txn_id));
+    EXPECT_EQ(0,
+        memcmp(make_store_id(0x70, 3).data(), txn_id, sizeof(txn_id)));
+
+    /* the history holds every transaction, in chain order. */
+    uint8_t history[8 * BLOCK_STORE_ID_SIZE];
+    size_t history_count = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_artifact_history(
+            &client_store, artifact_id.data(), 0, history, 8,
+            &history_count));
+    ASSERT_EQ(3U, history_count);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(0,
+            memcmp(
+                make_store_id(0x70, i + 1).data(),
+                history + i * BLOCK_STORE_ID_SIZE, BLOCK_STORE_ID_SIZE));
+    }
+
+    /* each transaction reads back whole. */
+    vccrypt_buffer_t txn;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        block_store_get_transaction(
+            &client_store, make_store_id(0x70, 2).data(), &txn));
+    ASSERT_EQ(txns[1].size(), txn.size);
+    EXPECT_EQ(0, memcmp(txns[1].data(), txn.data, txn.size));
+    dispose((disposable_t*)&txn);
+}
@@ -0,0 +1,427 @@
+/**
+ * \file test/handshake/test_ssock_handshake.cpp
+ *
+ * Unit tests for the mutual authentication handshake.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vcblockchain/ssock_handshake.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+namespace {
+
+const uint8_t CLIENT_ID[SSOCK_HANDSHAKE_ID_SIZE] = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10 };
+
+const uint8_t SERVER_ID[SSOCK_HANDSHAKE_ID_SIZE] = {
+    0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+    0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF, 0xF0 };
+
+/**
+ * \brief The result of one side of a handshake.
+ */
+struct side_result
+{
+    int status = -1;
+    vector<uint8_t> secret;
+    uint8_t client_id[SSOCK_HANDSHAKE_ID_SIZE] = { 0 };
+};
+
+}
+
+class test_ssock_handshake : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+
+        make_keypair(&client_priv, &client_pub);
+        make_keypair(&server_priv, &server_pub);
+        make_keypair(&other_priv, &other_pub);
+        known = true;
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&client_priv);
+        dispose((disposable_t*)&client_pub);
+        dispose((disposable_t*)&server_priv);
+        dispose((disposable_t*)&server_pub);
+        dispose((disposable_t*)&other_priv);
+        dispose((disposable_t*)&other_pub);
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    void make_keypair(vccrypt_buffer_t* priv, vccrypt_buffer_t* pub)
+    {
+        vccrypt_key_agreement_context_t agreement;
+
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_cipher_key_agreement_init(&suite, &agreement));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_cipher_key_agreement_private_key(
+                &suite, priv));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_cipher_key_agreement_public_key(
+                &suite, pub));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_key_agreement_keypair_create(&agreement, priv, pub));
+
+        dispose((disposable_t*)&agreement);
+    }
+
+    /**
+     * \brief Client key lookup, which knows a single client.
+     */
+    static int lookup(
+        void* context, const uint8_t* client_id,
+        const vccrypt_buffer_t** public_key)
+    {
+        test_ssock_handshake* self = (test_ssock_handshake*)context;
+
+        if (!self->known || 0 != memcmp(CLIENT_ID, client_id, sizeof(CLIENT_ID)))
+        {
+            return -1;
+        }
+
+        *public_key = &self->client_pub;
+        return VCBLOCKCHAIN_STATUS_SUCCESS;
+    }
+
+    void server_init(
+        ssock_handshake_server* server, const vccrypt_buffer_t* ticket_key,
+        uint32_t lifetime)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_handshake_server_init(
+                server, &alloc_opts, &suite, SERVER_ID, &server_priv,
+                &lookup, this, ticket_key, lifetime));
+    }
+
+    void client_init(
+        ssock_handshake_client* client, const vccrypt_buffer_t* expected_pub)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_handshake_client_init(
+                client, &alloc_opts, &suite, CLIENT_ID, &client_priv,
+                SERVER_ID, expected_pub));
+    }
+
+    static vector<uint8_t> take(vccrypt_buffer_t* secret)
+    {
+        const uint8_t* in = (const uint8_t*)secret->data;
+        vector<uint8_t> out(in, in + secret->size);
+        dispose((disposable_t*)secret);
+
+        return out;
+    }
+
+    /**
+     * \brief Run both sides of a handshake over a socket pair.
+     */
+    void run(
+        ssock_handshake_server* server, ssock_handshake_client* client,
+        side_result* server_result, side_result* client_result)
+    {
+        int sv[2];
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+
+        thread server_thread([&]() {
+            ssock sock;
+            vccrypt_buffer_t secret;
+
+            ssock_init_from_posix(&sock, sv[0]);
+            server_result->status =
+                ssock_handshake_accept(
+                    server, &sock, server_result->client_id, &secret);
+            if (VCBLOCKCHAIN_STATUS_SUCCESS == server_result->status)
+            {
+                server_result->secret = take(&secret);
+            }
+
+            dispose((disposable_t*)&sock);
+        });
+
+        ssock sock;
+        vccrypt_buffer_t secret;
+
+        ssock_init_from_posix(&sock, sv[1]);
+        client_result->status =
+            ssock_handshake_connect(client, &sock, &secret);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == client_result->status)
+        {
+            client_result->secret = take(&secret);
+        }
+
+        /* a failed client hangs up, so the server does not wait. */
+        dispose((disposable_t*)&sock);
+        server_thread.join();
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    vccrypt_buffer_t client_priv, client_pub;
+    vccrypt_buffer_t server_priv, server_pub;
+    vccrypt_buffer_t other_priv, other_pub;
+    bool known;
+};
+
+/**
+ * Test that init, connect, and accept do runtime parameter checks.
+ */
+TEST_F(test_ssock_handshake, parameter_checks)
+{
+    ssock_handshake_client client;
+    ssock_handshake_server server;
+    ssock sock;
+    vccrypt_buffer_t secret;
+    uint8_t id[SSOCK_HANDSHAKE_ID_SIZE];
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_client_init(
+            nullptr, &alloc_opts, &suite, CLIENT_ID, &client_priv, SERVER_ID,
+            &server_pub));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_client_init(
+            &client, &alloc_opts, &suite, CLIENT_ID, nullptr, SERVER_ID,
+            &server_pub));
+
+    /* keys must match the suite. */
+    vccrypt_buffer_t short_key;
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_buffer_init(&short_key, &alloc_opts, 7));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_client_init(
+            &client, &alloc_opts, &suite, CLIENT_ID, &client_priv, SERVER_ID,
+            &short_key));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_server_init(
+            &server, &alloc_opts, &suite, SERVER_ID, &server_priv, nullptr,
+            this, nullptr, 60));
+
+    /* a shared ticket key must be of the MAC key size. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_server_init(
+            &server, &alloc_opts, &suite, SERVER_ID, &server_priv, &lookup,
+            this, &short_key, 60));
+    dispose((disposable_t*)&short_key);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_connect(nullptr, &sock, &secret));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_handshake_accept(nullptr, &sock, id, &secret));
+}
+
+/**
+ * Test that a full handshake is followed by a resumed one, and that both
+ * sides agree on distinct secrets.
+ */
+TEST_F(test_ssock_handshake, full_then_resumed)
+{
+    ssock_handshake_server server;
+    ssock_handshake_client client;
+    side_result s1, c1, s2, c2;
+
+    server_init(&server, nullptr, 60);
+    client_init(&client, &server_pub);
+
+    run(&server, &client, &s1, &c1);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s1.status);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c1.status);
+    EXPECT_EQ(s1.secret, c1.secret);
+    EXPECT_EQ(0, memcmp(CLIENT_ID, s1.client_id, sizeof(CLIENT_ID)));
+    EXPECT_EQ(0U, client.resumed);
+    EXPECT_NE(nullptr, client.ticket);
+
+    run(&server, &client, &s2, &c2);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s2.status);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c2.status);
+    EXPECT_EQ(s2.secret, c2.secret);
+    EXPECT_NE(s1.secret, s2.secret);
+    EXPECT_EQ(1U, client.resumed);
+
+    EXPECT_EQ(1U, server.full_handshakes);
+    EXPECT_EQ(1U, server.resumed_handshakes);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that an unknown client is rejected.
+ */
+TEST_F(test_ssock_handshake, unknown_client)
+{
+    ssock_handshake_server server;
+    ssock_handshake_client client;
+    side_result s, c;
+
+    known = false;
+    server_init(&server, nullptr, 60);
+    client_init(&client, &server_pub);
+
+    run(&server, &client, &s, &c);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_UNKNOWN_PEER, s.status);
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, c.status);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a server without the expected private key fails to authenticate.
+ */
+TEST_F(test_ssock_handshake, wrong_server_key)
+{
+    ssock_handshake_server server;
+    ssock_handshake_client client;
+    side_result s, c;
+
+    server_init(&server, nullptr, 60);
+    client_init(&client, &other_pub);
+
+    run(&server, &client, &s, &c);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH, c.status);
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, s.status);
+    EXPECT_EQ(nullptr, client.ticket);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a client without the expected private key fails to authenticate.
+ */
+TEST_F(test_ssock_handshake, wrong_client_key)
+{
+    ssock_handshake_server server;
+    ssock_handshake_client client;
+    side_result s, c;
+
+    server_init(&server, nullptr, 60);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_handshake_client_init(
+            &client, &alloc_opts, &suite, CLIENT_ID, &other_priv, SERVER_ID,
+            &server_pub));
+
+    run(&server, &client, &s, &c);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_HANDSHAKE_AUTH, c.status);
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, s.status);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a tampered ticket falls back to a full handshake.
+ */
+TEST_F(test_ssock_handshake, tampered_ticket_falls_back)
+{
+    ssock_handshake_server server;
+    ssock_handshake_client client;
+    side_result s1, c1, s2, c2;
+
+    server_init(&server, nullptr, 60);
+    client_init(&client, &server_pub);
+
+    run(&server, &client, &s1, &c1);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c1.status);
+    ASSERT_NE(nullptr, client.ticket);
+
+    ((uint8_t*)client.ticket)[client.ticket_size / 2] ^= 0x01;
+
+    run(&server, &client, &s2, &c2);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s2.status);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c2.status);
+    EXPECT_EQ(s2.secret, c2.secret);
+    EXPECT_EQ(0U, client.resumed);
+    EXPECT_EQ(2U, server.full_handshakes);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that servers sharing a ticket key resume each other's sessions, and
+ * that a server with another key falls back to a full handshake.
+ */
+TEST_F(test_ssock_handshake, shared_ticket_key)
+{
+    ssock_handshake_server first, second, third;
+    ssock_handshake_client client;
+    vccrypt_buffer_t ticket_key;
+    side_result s1, c1, s2, c2, s3, c3;
+
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_buffer_init(
+            &ticket_key, &alloc_opts, suite.mac_short_opts.key_size));
+    memset(ticket_key.data, 0x42, ticket_key.size);
+
+    server_init(&first, &ticket_key, 60);
+    server_init(&second, &ticket_key, 60);
+    server_init(&third, nullptr, 60);
+    client_init(&client, &server_pub);
+
+    run(&first, &client, &s1, &c1);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c1.status);
+
+    run(&second, &client, &s2, &c2);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c2.status);
+    EXPECT_EQ(s2.secret, c2.secret);
+    EXPECT_EQ(1U, client.resumed);
+
+    run(&third, &client, &s3, &c3);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c3.status);
+    EXPECT_EQ(s3.secret, c3.secret);
+    EXPECT_EQ(0U, client.resumed);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&first);
+    dispose((disposable_t*)&second);
+    dispose((disposable_t*)&third);
+    dispose((disposable_t*)&ticket_key);
+}
+
+/**
+ * Test that a zero ticket lifetime disables tickets.
+ */
+TEST_F(test_ssock_handshake, tickets_disabled)
+{
+    ssock_handshake_server server;
+    ssock_handshake_client client;
+    side_result s1, c1, s2, c2;
+
+    server_init(&server, nullptr, 0);
+    client_init(&client, &server_pub);
+
+    run(&server, &client, &s1, &c1);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c1.status);
+    EXPECT_EQ(nullptr, client.ticket);
+
+    run(&server, &client, &s2, &c2);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, c2.status);
+    EXPECT_EQ(s2.secret, c2.secret);
+    EXPECT_EQ(0U, client.resumed);
+    EXPECT_EQ(2U, server.full_handshakes);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
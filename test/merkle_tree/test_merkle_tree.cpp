@@ -0,0 +1,320 @@
+/**
+ * \file test/merkle_tree/test_merkle_tree.cpp
+ *
+ * Unit tests for the incremental Merkle tree.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vcblockchain/merkle_tree.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+class test_merkle_tree : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+
+        hash_size = suite.hash_opts.hash_size;
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Hash a prefix byte followed by the given data.
+     */
+    vector<uint8_t> hash(uint8_t prefix, const vector<uint8_t>& data)
+    {
+        vccrypt_hash_context_t ctx;
+        vccrypt_buffer_t out;
+        vector<uint8_t> digest(hash_size);
+
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS, vccrypt_suite_hash_init(&suite, &ctx));
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_hash(&suite, &out));
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS, vccrypt_hash_digest(&ctx, &prefix, 1));
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_hash_digest(&ctx, data.data(), data.size()));
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS, vccrypt_hash_finalize(&ctx, &out));
+        memcpy(digest.data(), out.data, hash_size);
+        dispose((disposable_t*)&out);
+        dispose((disposable_t*)&ctx);
+
+        return digest;
+    }
+
+    /**
+     * \brief Compute a root level by level, as a reference for the tree.
+     */
+    vector<uint8_t> reference_root(const vector<vector<uint8_t>>& leaves)
+    {
+        vector<vector<uint8_t>> level;
+        for (const auto& leaf : leaves)
+        {
+            level.push_back(hash(0x00, leaf));
+        }
+
+        while (level.size() > 1)
+        {
+            vector<vector<uint8_t>> parents;
+            for (size_t i = 0; i < level.size(); i += 2)
+            {
+                if (i + 1 < level.size())
+                {
+                    vector<uint8_t> pair(level[i]);
+                    pair.insert(pair.end(), level[i + 1].begin(),
+                        level[i + 1].end());
+                    parents.push_back(hash(0x01, pair));
+                }
+                else
+                {
+                    parents.push_back(level[i]);
+                }
+            }
+
+            level.swap(parents);
+        }
+
+        return level[0];
+    }
+
+    vector<uint8_t> make_leaf(size_t i)
+    {
+        return vector<uint8_t>(1 + i % 23, (uint8_t)(i * 7));
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    size_t hash_size;
+};
+
+/**
+ * Test that the tree functions check their parameters.
+ */
+TEST_F(test_merkle_tree, parameter_checks)
+{
+    merkle_tree tree;
+    uint8_t leaf[4] = { 0 };
+    vector<uint8_t> root(hash_size);
+    vector<uint8_t> proof(hash_size);
+    size_t proof_size = proof.size();
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_init(nullptr, &alloc_opts, &suite));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_init(&tree, nullptr, &suite));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_init(&tree, &alloc_opts, nullptr));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_init(&tree, &alloc_opts, &suite));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_append(nullptr, leaf, sizeof(leaf)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_append(&tree, nullptr, sizeof(leaf)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_root(nullptr, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, merkle_tree_root(&tree, nullptr));
+
+    /* there is no leaf to prove yet. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_prove(&tree, 0, proof.data(), &proof_size));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_append(&tree, leaf, sizeof(leaf)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_prove(nullptr, 0, proof.data(), &proof_size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_prove(&tree, 0, nullptr, &proof_size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_prove(&tree, 0, proof.data(), nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_prove(&tree, 1, proof.data(), &proof_size));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_verify(
+            nullptr, leaf, sizeof(leaf), 0, 1, nullptr, 0, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_verify(
+            &suite, nullptr, sizeof(leaf), 0, 1, nullptr, 0, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_verify(
+            &suite, leaf, sizeof(leaf), 0, 1, nullptr, hash_size,
+            root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_verify(
+            &suite, leaf, sizeof(leaf), 0, 1, nullptr, 0, nullptr));
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * Test that the root of an empty tree is fixed, and differs from the root of
+ * a tree with an empty leaf.
+ */
+TEST_F(test_merkle_tree, empty_root)
+{
+    merkle_tree tree;
+    vector<uint8_t> root(hash_size);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_init(&tree, &alloc_opts, &suite));
+    EXPECT_EQ(0U, merkle_tree_count(&tree));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_root(&tree, root.data()));
+    EXPECT_EQ(hash(0x01, vector<uint8_t>()), root);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_append(&tree, nullptr, 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_root(&tree, root.data()));
+    EXPECT_EQ(hash(0x00, vector<uint8_t>()), root);
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * Test that, as leaves are appended, the root matches a level by level
+ * computation, and every leaf's proof verifies and is no longer than
+ * ceil(log2(n)) hashes.
+ */
+TEST_F(test_merkle_tree, proofs_for_every_leaf)
+{
+    merkle_tree tree;
+    vector<vector<uint8_t>> leaves;
+    vector<uint8_t> root(hash_size);
+    vector<uint8_t> proof(MERKLE_TREE_MAX_LEVELS * hash_size);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_init(&tree, &alloc_opts, &suite));
+
+    for (size_t n = 1; n <= 40; ++n)
+    {
+        leaves.push_back(make_leaf(n - 1));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            merkle_tree_append(
+                &tree, leaves.back().data(), leaves.back().size()));
+        ASSERT_EQ(n, merkle_tree_count(&tree));
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            merkle_tree_root(&tree, root.data()));
+        ASSERT_EQ(reference_root(leaves), root) << "n = " << n;
+
+        size_t max_hashes = 0;
+        while (((size_t)1 << max_hashes) < n)
+        {
+            ++max_hashes;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t proof_size = proof.size();
+            ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                merkle_tree_prove(&tree, i, proof.data(), &proof_size));
+            EXPECT_GE(max_hashes * hash_size, proof_size);
+            EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                merkle_tree_verify(
+                    &suite, leaves[i].data(), leaves[i].size(), i, n,
+                    proof.data(), proof_size, root.data()))
+                << "n = " << n << ", i = " << i;
+        }
+    }
+
+    dispose((disposable_t*)&tree);
+}
+
+/**
+ * Test that a proof fails for the wrong leaf, index, count, or root, or if
+ * it is altered, truncated, or extended, and that a short buffer is refused.
+ */
+TEST_F(test_merkle_tree, tampered_proofs)
+{
+    merkle_tree tree;
+    vector<vector<uint8_t>> leaves;
+    vector<uint8_t> root(hash_size);
+    vector<uint8_t> proof((MERKLE_TREE_MAX_LEVELS + 1) * hash_size);
+    const size_t N = 21;
+    const size_t I = 12;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_init(&tree, &alloc_opts, &suite));
+    for (size_t i = 0; i < N; ++i)
+    {
+        leaves.push_back(make_leaf(i));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            merkle_tree_append(&tree, leaves[i].data(), leaves[i].size()));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_root(&tree, root.data()));
+
+    size_t proof_size = proof.size();
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_prove(&tree, I, proof.data(), &proof_size));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I, N, proof.data(),
+            proof_size, root.data()));
+
+    /* the wrong leaf, index, or a count giving the tree another shape. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I + 1].data(), leaves[I + 1].size(), I, N,
+            proof.data(), proof_size, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I + 1, N,
+            proof.data(), proof_size, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I, 2 * N,
+            proof.data(), proof_size, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), N, N, proof.data(),
+            proof_size, root.data()));
+
+    /* an altered, truncated, or extended proof. */
+    proof[hash_size + 3] ^= 0x10;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I, N, proof.data(),
+            proof_size, root.data()));
+    proof[hash_size + 3] ^= 0x10;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I, N, proof.data(),
+            proof_size - hash_size, root.data()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I, N, proof.data(),
+            proof_size + hash_size, root.data()));
+
+    /* the wrong root. */
+    root[0] ^= 0x01;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_MERKLE_PROOF_INVALID,
+        merkle_tree_verify(
+            &suite, leaves[I].data(), leaves[I].size(), I, N, proof.data(),
+            proof_size, root.data()));
+
+    /* a buffer one hash short. */
+    size_t short_size = proof_size - hash_size;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        merkle_tree_prove(&tree, I, proof.data(), &short_size));
+
+    dispose((disposable_t*)&tree);
+}
@@ -0,0 +1,200 @@
+/**
+ * \file test/schema/test_ssock_schemagen.cpp
+ *
+ * Unit tests for code generated by ssock_schemagen.py.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <vcblockchain/ssock.hpp>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "../ssock/dummy_ssock.h"
+#include "test_schema.h"
+
+using namespace std;
+
+class test_ssock_schemagen : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        memset(&stats, 0, sizeof(stats));
+        offset = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            dummy_stream_ssock_init(&inner, stream, offset));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_stats_filter_init(&sock, &inner, &stats));
+
+        id = "artifact-0001";
+        payload = { 0x00, 0x01, 0xFE, 0xFF, 0x7F };
+
+        memset(&msg, 0, sizeof(msg));
+        msg.header.version = 2;
+        msg.header.flags = -9;
+        msg.offset = 0x0102030405060708ULL;
+        msg.delta = -4000000000LL;
+        msg.count = 0xCAFEBABE;
+        msg.sign = -3;
+        msg.artifact_id = id.data();
+        msg.artifact_id_size = id.size();
+        msg.payload = payload.data();
+        msg.payload_size = payload.size();
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&sock);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    void expect_equal(const test_schema_request& out)
+    {
+        EXPECT_EQ(msg.header.version, out.header.version);
+        EXPECT_EQ(msg.header.flags, out.header.flags);
+        EXPECT_EQ(msg.offset, out.offset);
+        EXPECT_EQ(msg.delta, out.delta);
+        EXPECT_EQ(msg.count, out.count);
+        EXPECT_EQ(msg.sign, out.sign);
+        EXPECT_EQ(id, string(out.artifact_id, out.artifact_id_size));
+        ASSERT_EQ(payload.size(), out.payload_size);
+        EXPECT_EQ(0, memcmp(payload.data(), out.payload, out.payload_size));
+    }
+
+    allocator_options_t alloc_opts;
+    ssock inner, sock;
+    ssock_stats stats;
+    vector<uint8_t> stream;
+    size_t offset;
+    string id;
+    vector<uint8_t> payload;
+    test_schema_request msg;
+};
+
+/**
+ * Test that the encoded size is exact, and matches hand-written writes.
+ */
+TEST_F(test_ssock_schemagen, encoded_size)
+{
+    vector<uint8_t> buf(test_schema_request_encoded_size(&msg));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_encode(&msg, buf.data(), buf.size()));
+
+    /* a smaller buffer is rejected. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        test_schema_request_encode(&msg, buf.data(), buf.size() - 1));
+
+    /* the encoding matches the field-at-a-time C API. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint8(&inner, 2));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_int32(&inner, -9));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_uint64(&inner, msg.offset));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_int64(&inner, msg.delta));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_uint32(&inner, msg.count));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_int8(&inner, msg.sign));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_string(&inner, id.c_str()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&inner, payload.data(), payload.size()));
+
+    EXPECT_EQ(stream, buf);
+}
+
+/**
+ * Test that a message is written with one write call and read back.
+ */
+TEST_F(test_ssock_schemagen, round_trip)
+{
+    test_schema_request out;
+    void* frame = nullptr;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_write(&sock, &alloc_opts, &msg));
+    EXPECT_EQ(1U, stats.write_calls);
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, stream[0]);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_read(&sock, &alloc_opts, &out, &frame));
+    expect_equal(out);
+
+    release(&alloc_opts, frame);
+}
+
+/**
+ * Test that a message larger than the stack frame is written and read back.
+ */
+TEST_F(test_ssock_schemagen, large_round_trip)
+{
+    test_schema_request out;
+    void* frame = nullptr;
+
+    payload.resize(100000, 0x42);
+    msg.payload = payload.data();
+    msg.payload_size = payload.size();
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_write(&sock, &alloc_opts, &msg));
+    EXPECT_EQ(1U, stats.write_calls);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_read(&sock, &alloc_opts, &out, &frame));
+    expect_equal(out);
+
+    release(&alloc_opts, frame);
+}
+
+/**
+ * Test that decoding rejects truncated, trailing, and mistyped frames.
+ */
+TEST_F(test_ssock_schemagen, decode_errors)
+{
+    test_schema_request out;
+    vector<uint8_t> buf(test_schema_request_encoded_size(&msg) + 1);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_encode(&msg, buf.data(), buf.size()));
+
+    /* every truncation is rejected. */
+    for (size_t size = 0; size < buf.size() - 1; ++size)
+    {
+        EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS,
+            test_schema_request_decode(&out, buf.data(), size));
+    }
+
+    /* trailing bytes are rejected. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        test_schema_request_decode(&out, buf.data(), buf.size()));
+
+    /* the exact frame is accepted. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_request_decode(&out, buf.data(), buf.size() - 1));
+    expect_equal(out);
+
+    /* a mistyped field is rejected. */
+    buf[0] = SSOCK_DATA_TYPE_INT8;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        test_schema_request_decode(&out, buf.data(), buf.size() - 1));
+}
+
+/**
+ * Test that the generated encoding matches the C++ field descriptor encoding.
+ */
+TEST_F(test_ssock_schemagen, matches_memory_writer)
+{
+    vcblockchain::ssock_memory_writer writer;
+    vector<uint8_t> buf(test_schema_header_encoded_size(&msg.header));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        test_schema_header_encode(&msg.header, buf.data(), buf.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write(msg.header.version));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write(msg.header.flags));
+
+    EXPECT_EQ(writer.buffer(), buf);
+}
@@ -0,0 +1,561 @@
+/**
+ * \file test/server/test_ssock_server.cpp
+ *
+ * Unit tests for the multi-threaded ssock server.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vcblockchain/ssock_server.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+class test_ssock_server : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+
+        memset(&options, 0, sizeof(options));
+        options.bind_address = "127.0.0.1";
+        options.reactors = 4;
+        options.handler = &echo_handler;
+        options.context = this;
+
+        for (auto& c : requests)
+            c = 0;
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Read a uint32 and reply with its successor.
+     */
+    static int echo_handler(ssock* sock, size_t reactor, void* context)
+    {
+        test_ssock_server* self = (test_ssock_server*)context;
+        uint32_t val = 0;
+
+        int retval = ssock_read_uint32(sock, &val);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        /* per-reactor state needs no locking; the counter is only atomic
+         * so that the test thread can read it. */
+        self->requests[reactor] += 1;
+
+        return ssock_write_uint32(sock, val + 1);
+    }
+
+    /**
+     * \brief Read a data packet and reply with its size.
+     */
+    static int size_handler(ssock* sock, size_t reactor, void* context)
+    {
+        test_ssock_server* self = (test_ssock_server*)context;
+        void* val = nullptr;
+        uint32_t size = 0;
+
+        int retval = ssock_read_data(sock, &self->alloc_opts, &val, &size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        release(&self->alloc_opts, val);
+        self->requests[reactor] += 1;
+
+        return ssock_write_uint32(sock, size);
+    }
+
+    /**
+     * \brief Read a uint32 size and reply with a data packet of that size.
+     */
+    static int bulk_handler(ssock* sock, size_t reactor, void* context)
+    {
+        test_ssock_server* self = (test_ssock_server*)context;
+        uint32_t size = 0;
+
+        int retval = ssock_read_uint32(sock, &size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+        {
+            return retval;
+        }
+
+        self->requests[reactor] += 1;
+
+        /* small requests are answered like echo_handler. */
+        if (size < 16)
+        {
+            return ssock_write_uint32(sock, size + 1);
+        }
+
+        vector<uint8_t> response(size, (uint8_t)size);
+
+        return ssock_write_data(sock, response.data(), response.size());
+    }
+
+    /**
+     * \brief Connect a blocking client ssock to the server.
+     */
+    static int connect_client(ssock* client, uint16_t port)
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int sd = socket(AF_INET, SOCK_STREAM, 0);
+        if (sd < 0 || 0 != connect(sd, (struct sockaddr*)&addr, sizeof(addr)))
+        {
+            return -1;
+        }
+
+        return ssock_init_from_posix(client, sd);
+    }
+
+    /**
+     * \brief Run several clients in parallel, each making a few requests.
+     */
+    void run_clients(uint16_t port, int clients, int rounds)
+    {
+        vector<thread> threads;
+        atomic<int> ok(0);
+
+        for (int c = 0; c < clients; ++c)
+        {
+            threads.emplace_back([&, c]() {
+                ssock client;
+                if (0 != connect_client(&client, port))
+                    return;
+
+                for (int r = 0; r < rounds; ++r)
+                {
+                    uint32_t val = 0;
+                    uint32_t req = c * 1000 + r;
+                    if (VCBLOCKCHAIN_STATUS_SUCCESS == ssock_write_uint32(&client, req) && VCBLOCKCHAIN_STATUS_SUCCESS == ssock_read_uint32(&client, &val) && req + 1 == val)
+                    {
+                        ++ok;
+                    }
+                }
+
+                dispose((disposable_t*)&client);
+            });
+        }
+
+        for (auto& t : threads)
+            t.join();
+
+        EXPECT_EQ(clients * rounds, ok.load());
+    }
+
+    size_t total_requests()
+    {
+        size_t total = 0;
+        for (auto& c : requests)
+            total += c;
+
+        return total;
+    }
+
+    allocator_options_t alloc_opts;
+    ssock_server_options options;
+    atomic<size_t> requests[4];
+};
+
+/**
+ * Test that ssock_server_init does runtime parameter checks.
+ */
+TEST_F(test_ssock_server, parameter_checks)
+{
+    ssock_server server;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_server_init(nullptr, &alloc_opts, &options));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_server_init(&server, nullptr, &options));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_server_init(&server, &alloc_opts, nullptr));
+
+    options.handler = nullptr;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_server_init(&server, &alloc_opts, &options));
+
+    options.handler = &echo_handler;
+    options.mode = 0x7F;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_server_init(&server, &alloc_opts, &options));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, ssock_server_start(nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, ssock_server_stop(nullptr));
+}
+
+/**
+ * Test that reuseport reactors serve many concurrent clients.
+ */
+TEST_F(test_ssock_server, reuseport)
+{
+    ssock_server server;
+
+    options.mode = SSOCK_SERVER_MODE_REUSEPORT;
+    options.pin_threads = 1;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_NE(0, server.port);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    /* a running server can't be started again. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, ssock_server_start(&server));
+
+    run_clients(server.port, 32, 10);
+    EXPECT_EQ(320U, total_requests());
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_stop(&server));
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that reactors sharing one listen socket serve many concurrent clients.
+ */
+TEST_F(test_ssock_server, shared_accept)
+{
+    ssock_server server;
+
+    options.mode = SSOCK_SERVER_MODE_SHARED_ACCEPT;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    run_clients(server.port, 32, 10);
+    EXPECT_EQ(320U, total_requests());
+
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a server can be stopped with open connections, and restarted.
+ */
+TEST_F(test_ssock_server, stop_with_open_connections)
+{
+    ssock_server server;
+    ssock client;
+    uint32_t val = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&client, server.port));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&client, 41));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&client, &val));
+    EXPECT_EQ(42U, val);
+
+    /* stopping closes the connection. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_stop(&server));
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&client, &val));
+    dispose((disposable_t*)&client);
+
+    /* the listen sockets are still bound, so the server can restart. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+    run_clients(server.port, 4, 2);
+
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that idle connections are closed, while busy connections stay open.
+ */
+TEST_F(test_ssock_server, idle_timeout)
+{
+    ssock_server server;
+    ssock idle, busy;
+    uint32_t val = 0;
+
+    options.reactors = 1;
+    options.idle_timeout_ms = 100;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&idle, server.port));
+    ASSERT_EQ(0, connect_client(&busy, server.port));
+
+    /* the busy client makes a request every 20ms for 300ms. */
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < 15; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&busy, i));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&busy, &val));
+        EXPECT_EQ(i + 1, val);
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+
+    /* meanwhile, the idle client was closed. */
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&idle, &val));
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(100));
+
+    /* once the busy client goes quiet, it is closed too. */
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&busy, &val));
+
+    dispose((disposable_t*)&idle);
+    dispose((disposable_t*)&busy);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a peer which stalls partway through a request does not stall the
+ * other connections on its reactor, and is answered once it finishes.
+ */
+TEST_F(test_ssock_server, partial_request)
+{
+    ssock_server server;
+    ssock slow, fast;
+    uint32_t val = 0;
+    uint8_t packet[9];
+    struct timeval tv = { 2, 0 };
+
+    options.reactors = 1;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&slow, server.port));
+    ASSERT_EQ(0, connect_client(&fast, server.port));
+
+    /* a stalled reactor fails this test instead of hanging it. */
+    ASSERT_EQ(0,
+        setsockopt((int)(long)fast.context, SOL_SOCKET, SO_RCVTIMEO, &tv,
+            sizeof(tv)));
+
+    /* the slow client sends the first three bytes of a uint32 packet. */
+    packet[0] = SSOCK_DATA_TYPE_UINT32;
+    uint32_t size = htonl(sizeof(uint32_t)), req = htonl(41);
+    memcpy(packet + 1, &size, sizeof(size));
+    memcpy(packet + 5, &req, sizeof(req));
+    size_t write_size = 3;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write(&slow, packet, &write_size));
+    this_thread::sleep_for(chrono::milliseconds(20));
+
+    /* the fast client is served meanwhile. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&fast, 7));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&fast, &val));
+    EXPECT_EQ(8U, val);
+
+    /* the rest of the slow request completes it. */
+    write_size = sizeof(packet) - 3;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write(&slow, packet + 3, &write_size));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&slow, &val));
+    EXPECT_EQ(42U, val);
+    EXPECT_EQ(2U, total_requests());
+
+    dispose((disposable_t*)&slow);
+    dispose((disposable_t*)&fast);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that requests sent back to back are each answered.
+ */
+TEST_F(test_ssock_server, pipelined_requests)
+{
+    ssock_server server;
+    ssock client;
+    uint32_t val = 0;
+
+    options.reactors = 1;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&client, server.port));
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&client, i));
+    }
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_uint32(&client, &val));
+        EXPECT_EQ(i + 1, val);
+    }
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a request larger than the max_request_size option closes the
+ * connection, while smaller requests span several reads.
+ */
+TEST_F(test_ssock_server, request_limit)
+{
+    ssock_server server;
+    ssock client;
+    uint32_t val = 0;
+    vector<uint8_t> small(3000, 0x5A), big(8192, 0xA5);
+
+    options.reactors = 1;
+    options.max_request_size = 4096;
+    options.handler = &size_handler;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&client, server.port));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&client, small.data(), small.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&client, &val));
+    EXPECT_EQ(small.size(), val);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&client, big.data(), big.size()));
+    EXPECT_NE(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&client, &val));
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a peer which doesn't read its responses does not stall the other
+ * connections on its reactor, and gets its queued responses in order once it
+ * reads them.
+ */
+TEST_F(test_ssock_server, slow_reader)
+{
+    ssock_server server;
+    ssock slow, fast;
+    uint32_t val = 0;
+    struct timeval tv = { 2, 0 };
+    const uint32_t response_size = 128 * 1024;
+
+    options.reactors = 1;
+    options.handler = &bulk_handler;
+    options.max_output_size = 16 * 1024 * 1024;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&slow, server.port));
+    ASSERT_EQ(0, connect_client(&fast, server.port));
+
+    /* a stalled reactor fails this test instead of hanging it. */
+    ASSERT_EQ(0,
+        setsockopt((int)(long)fast.context, SOL_SOCKET, SO_RCVTIMEO, &tv,
+            sizeof(tv)));
+
+    /* the slow client asks for more than the socket buffers hold. */
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_uint32(&slow, response_size + i));
+    }
+    this_thread::sleep_for(chrono::milliseconds(50));
+
+    /* the fast client is served meanwhile. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&fast, 7));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&fast, &val));
+    EXPECT_EQ(8U, val);
+
+    /* the slow client gets every response, in order. */
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        void* data = nullptr;
+        uint32_t size = 0;
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_data(&slow, &alloc_opts, &data, &size));
+        EXPECT_EQ(response_size + i, size);
+        EXPECT_EQ((uint8_t)(response_size + i), ((uint8_t*)data)[size - 1]);
+        release(&alloc_opts, data);
+    }
+
+    dispose((disposable_t*)&slow);
+    dispose((disposable_t*)&fast);
+    dispose((disposable_t*)&server);
+}
+
+/**
+ * Test that a peer whose unsent output outgrows the max_output_size option is
+ * closed.
+ */
+TEST_F(test_ssock_server, output_limit)
+{
+    ssock_server server;
+    ssock client;
+    struct timeval tv = { 2, 0 };
+    const uint32_t response_size = 128 * 1024;
+    vector<uint8_t> requests(256 * 9);
+
+    options.reactors = 1;
+    options.handler = &bulk_handler;
+    options.max_output_size = 256 * 1024;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_server_init(&server, &alloc_opts, &options));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_server_start(&server));
+
+    ASSERT_EQ(0, connect_client(&client, server.port));
+    ASSERT_EQ(0,
+        setsockopt((int)(long)client.context, SOL_SOCKET, SO_RCVTIMEO, &tv,
+            sizeof(tv)));
+
+    /* send every request at once. */
+    uint32_t size = htonl(sizeof(uint32_t)), req = htonl(response_size);
+    for (size_t i = 0; i < requests.size(); i += 9)
+    {
+        requests[i] = SSOCK_DATA_TYPE_UINT32;
+        memcpy(&requests[i + 1], &size, sizeof(size));
+        memcpy(&requests[i + 5], &req, sizeof(req));
+    }
+    size_t write_size = requests.size();
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write(&client, requests.data(), &write_size));
+
+    /* without reading, wait for the server to stop answering; the socket
+     * buffers fill long before every response is written. */
+    size_t handled = 0;
+    for (int i = 0; i < 100 && (0 == handled || handled != total_requests()); ++i)
+    {
+        handled = total_requests();
+        this_thread::sleep_for(chrono::milliseconds(50));
+    }
+    EXPECT_LT(handled, 256U);
+
+    /* the responses end early, once the connection is dropped. */
+    uint32_t received = 0;
+    while (received < 256)
+    {
+        void* data = nullptr;
+        uint32_t size = 0;
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != ssock_read_data(&client, &alloc_opts, &data, &size))
+        {
+            break;
+        }
+
+        release(&alloc_opts, data);
+        ++received;
+    }
+    EXPECT_LT(received, 256U);
+
+    dispose((disposable_t*)&client);
+    dispose((disposable_t*)&server);
+}
@@ -0,0 +1,320 @@
+/**
+ * \file test/signature_batch/test_signature_batch.cpp
+ *
+ * Unit tests for batch signature verification.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vcblockchain/signature_batch.h>
+#include <vccert/builder.h>
+#include <vccert/fields.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+static const uint8_t SIGNER_ID[16] = {
+    0x7c, 0x1f, 0x0a, 0x53, 0x28, 0x9d, 0x4e, 0x01,
+    0xb6, 0x33, 0x70, 0x5e, 0x19, 0xc4, 0x8a, 0x62 };
+
+class test_signature_batch : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_digital_signature_init(&suite, &sign));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature_private_key(
+                &suite, &private_key));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature_public_key(
+                &suite, &public_key));
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_digital_signature_keypair_create(
+                &sign, &private_key, &public_key));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_options_init(&builder_opts, &alloc_opts, &suite));
+        ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_parser_options_simple_init(
+                &parser_opts, &alloc_opts, &suite));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            thread_pool_init(&pool, &alloc_opts, 4));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&pool);
+        dispose((disposable_t*)&parser_opts);
+        dispose((disposable_t*)&builder_opts);
+        dispose((disposable_t*)&public_key);
+        dispose((disposable_t*)&private_key);
+        dispose((disposable_t*)&sign);
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Build a certificate signed over every field before its
+     * signature.
+     */
+    vector<uint8_t> make_certificate(uint64_t sequence)
+    {
+        vccert_builder_context_t builder;
+        vccrypt_buffer_t signature;
+        size_t size;
+
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_init(&builder_opts, &builder, 1024));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_uint64(
+                &builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, sequence));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_buffer(
+                &builder, VCCERT_FIELD_TYPE_SIGNER_ID, SIGNER_ID,
+                sizeof(SIGNER_ID)));
+
+        const uint8_t* cert = vccert_builder_emit(&builder, &size);
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_signature(&suite, &signature));
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_digital_signature_sign(
+                &sign, &signature, &private_key, cert, size));
+        EXPECT_EQ(VCCERT_STATUS_SUCCESS,
+            vccert_builder_add_short_buffer(
+                &builder, VCCERT_FIELD_TYPE_SIGNATURE,
+                (const uint8_t*)signature.data, signature.size));
+
+        cert = vccert_builder_emit(&builder, &size);
+        vector<uint8_t> out(cert, cert + size);
+        dispose((disposable_t*)&signature);
+        dispose((disposable_t*)&builder);
+
+        return out;
+    }
+
+    vector<vector<uint8_t>> make_certificates(size_t count)
+    {
+        vector<vector<uint8_t>> certs;
+        for (size_t i = 0; i < count; ++i)
+        {
+            certs.push_back(make_certificate(i));
+        }
+
+        return certs;
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+    vccrypt_digital_signature_context_t sign;
+    vccrypt_buffer_t private_key;
+    vccrypt_buffer_t public_key;
+    vccert_builder_options_t builder_opts;
+    vccert_parser_options_t parser_opts;
+    thread_pool pool;
+};
+
+/**
+ * Test that the batch functions check their parameters.
+ */
+TEST_F(test_signature_batch, parameter_checks)
+{
+    signature_batch batch;
+    size_t failed_index;
+    uint8_t signature[64] = { 0 };
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_init(
+            nullptr, &alloc_opts, &suite, &parser_opts, &pool, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_init(&batch, nullptr, &suite, &parser_opts, &pool, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_init(
+            &batch, &alloc_opts, nullptr, &parser_opts, &pool, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_init(&batch, &alloc_opts, &suite, nullptr, &pool, 0));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_init(
+            &batch, &alloc_opts, &suite, &parser_opts, &pool, 0));
+    EXPECT_EQ((size_t)SIGNATURE_BATCH_DEFAULT_CHUNK_SIZE, batch.chunk_size);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_add(nullptr, signature, 1, signature, &public_key));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_add(&batch, nullptr, 1, signature, &public_key));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_add(&batch, signature, 1, nullptr, &public_key));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_add(&batch, signature, 1, signature, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_add_certificate(
+            &batch, nullptr, 0, &public_key));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_verify(nullptr, &failed_index));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        signature_batch_verify(&batch, nullptr));
+
+    /* an empty batch verifies. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_verify(&batch, &failed_index));
+
+    dispose((disposable_t*)&batch);
+}
+
+/**
+ * Test that a batch of valid certificates verifies, with and without a pool,
+ * and that the batch grows past its initial capacity.
+ */
+TEST_F(test_signature_batch, valid_certificates)
+{
+    signature_batch pooled, inline_batch;
+    size_t failed_index = 0;
+    auto certs = make_certificates(3 * SIGNATURE_BATCH_INITIAL_CAPACITY);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_init(
+            &pooled, &alloc_opts, &suite, &parser_opts, &pool, 8));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_init(
+            &inline_batch, &alloc_opts, &suite, &parser_opts, nullptr, 0));
+
+    for (const auto& cert : certs)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            signature_batch_add_certificate(
+                &pooled, cert.data(), cert.size(), &public_key));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            signature_batch_add_certificate(
+                &inline_batch, cert.data(), cert.size(), &public_key));
+    }
+
+    EXPECT_EQ(certs.size(), pooled.count);
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_verify(&pooled, &failed_index));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_verify(&inline_batch, &failed_index));
+
+    /* clearing keeps the storage for the next batch. */
+    signature_batch_entry* entries = pooled.entries;
+    signature_batch_clear(&pooled);
+    EXPECT_EQ(0U, pooled.count);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_add_certificate(
+            &pooled, certs[0].data(), certs[0].size(), &public_key));
+    EXPECT_EQ(entries, pooled.entries);
+
+    dispose((disposable_t*)&inline_batch);
+    dispose((disposable_t*)&pooled);
+}
+
+/**
+ * Test that the lowest failing signature is identified, however the chunks
+ * are scheduled.
+ */
+TEST_F(test_signature_batch, lowest_failure_reported)
+{
+    signature_batch batch;
+    vccrypt_buffer_t other_private, other_public;
+    auto certs = make_certificates(150);
+
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_buffer_init_for_signature_private_key(
+            &suite, &other_private));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_buffer_init_for_signature_public_key(
+            &suite, &other_public));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_digital_signature_keypair_create(
+            &sign, &other_private, &other_public));
+
+    /* tamper with two certificates. */
+    certs[120][0] ^= 0x01;
+    certs[97][certs[97].size() - 1] ^= 0x80;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_init(
+            &batch, &alloc_opts, &suite, &parser_opts, &pool, 5));
+
+    for (size_t i = 0; i < certs.size(); ++i)
+    {
+        /* one certificate is checked against the wrong signer. */
+        const vccrypt_buffer_t* key = 131 == i ? &other_public : &public_key;
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            signature_batch_add_certificate(
+                &batch, certs[i].data(), certs[i].size(), key));
+    }
+
+    for (int round = 0; round < 20; ++round)
+    {
+        size_t failed_index = 0;
+        EXPECT_EQ(VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_INVALID,
+            signature_batch_verify(&batch, &failed_index));
+        EXPECT_EQ(97U, failed_index);
+    }
+
+    dispose((disposable_t*)&batch);
+    dispose((disposable_t*)&other_public);
+    dispose((disposable_t*)&other_private);
+}
+
+/**
+ * Test that a certificate without a usable signature is rejected when added.
+ */
+TEST_F(test_signature_batch, malformed_certificate)
+{
+    signature_batch batch;
+    vccert_builder_context_t builder;
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        signature_batch_init(
+            &batch, &alloc_opts, &suite, &parser_opts, nullptr, 0));
+
+    /* no signature field. */
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_builder_init(&builder_opts, &builder, 256));
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_builder_add_short_uint64(
+            &builder, VCCERT_FIELD_TYPE_BLOCK_HEIGHT, 1));
+    const uint8_t* cert = vccert_builder_emit(&builder, &size);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED,
+        signature_batch_add_certificate(&batch, cert, size, &public_key));
+
+    /* a signature of the wrong size. */
+    ASSERT_EQ(VCCERT_STATUS_SUCCESS,
+        vccert_builder_add_short_buffer(
+            &builder, VCCERT_FIELD_TYPE_SIGNATURE, SIGNER_ID,
+            sizeof(SIGNER_ID)));
+    cert = vccert_builder_emit(&builder, &size);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED,
+        signature_batch_add_certificate(&batch, cert, size, &public_key));
+
+    /* a truncated certificate. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED,
+        signature_batch_add_certificate(&batch, cert, size - 1, &public_key));
+
+    /* a field appended after a valid signature isn't covered by it. */
+    auto appended = make_certificate(1);
+    const uint8_t extra[] = {
+        (uint8_t)(VCCERT_FIELD_TYPE_BLOCK_HEIGHT >> 8),
+        (uint8_t)(VCCERT_FIELD_TYPE_BLOCK_HEIGHT & 0xFF),
+        0x00, 0x08, 0, 0, 0, 0, 0, 0, 0, 9 };
+    appended.insert(appended.end(), extra, extra + sizeof(extra));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SIGNATURE_BATCH_MALFORMED,
+        signature_batch_add_certificate(
+            &batch, appended.data(), appended.size(), &public_key));
+
+    EXPECT_EQ(0U, batch.count);
+
+    dispose((disposable_t*)&builder);
+    dispose((disposable_t*)&batch);
+}
@@ -7,6 +7,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 
 #include "dummy_ssock.h"
 
@@ -53,6 +54,7 @@ int dummy_ssock_init(
     ssock* sock, std::function<int(ssock*, void*, size_t*)> onread,
     std::function<int(ssock*, const void*, size_t*)> onwrite)
 {
+    memset(sock, 0, sizeof(ssock));
     sock->hdr.dispose = &dummy_ssock_dispose;
     sock->read = &dummy_ssock_read;
     sock->write = &dummy_ssock_write;
@@ -64,6 +66,43 @@ int dummy_ssock_init(
     return VCBLOCKCHAIN_STATUS_SUCCESS;
 }
 
+/**
+ * \brief Initialize a dummy ssock instance over an in-memory byte stream.
+ *
+ * \param sock      The socket instance to initialize.
+ * \param stream    The byte stream, which must outlive the socket.
+ * \param offset    The read offset, which must outlive the socket.
+ * \param max_read  The maximum number of bytes returned per read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+int dummy_stream_ssock_init(
+    ssock* sock, std::vector<uint8_t>& stream, size_t& offset,
+    size_t max_read)
+{
+    return
+        dummy_ssock_init(
+            sock,
+            [&stream, &offset, max_read](ssock*, void* b, size_t* sz) -> int {
+                size_t avail = stream.size() - offset;
+                size_t n = min(min(*sz, avail), max_read);
+
+                memcpy(b, stream.data() + offset, n);
+                offset += n;
+                *sz = n;
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&stream](ssock*, const void* b, size_t* sz) -> int {
+                const uint8_t* in = (const uint8_t*)b;
+                copy(in, in + *sz, back_inserter(stream));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            });
+}
+
 /**
  * \brief Read callback for dummy sock.
  */
@@ -13,6 +13,7 @@
 #error This is a C++ only header.
 #endif /*__cplusplus*/
 
+#include <cstdint>
 #include <functional>
 #include <vcblockchain/ssock.h>
 #include <vector>
@@ -32,6 +33,26 @@ int dummy_ssock_init(
     ssock* sock, std::function<int(ssock*, void*, size_t*)> onread,
     std::function<int(ssock*, const void*, size_t*)> onwrite);
 
+/**
+ * \brief Initialize a dummy ssock instance over an in-memory byte stream.
+ *
+ * Writes are appended to the stream, and reads consume it from the given
+ * offset, returning at most max_read bytes per read.  Reads at the end of the
+ * stream return zero bytes.
+ *
+ * \param sock      The socket instance to initialize.
+ * \param stream    The byte stream, which must outlive the socket.
+ * \param offset    The read offset, which must outlive the socket.
+ * \param max_read  The maximum number of bytes returned per read.
+ *
+ * \returns a status code indicating success or failure.
+ *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.
+ *      - a non-zero error code on failure.
+ */
+int dummy_stream_ssock_init(
+    ssock* sock, std::vector<uint8_t>& stream, size_t& offset,
+    size_t max_read = SIZE_MAX);
+
 /**
  * \brief Helper structure for checking write parameters from the dummy sock.
  */
@@ -0,0 +1,179 @@
+/**
+ * \file test/ssock/test_ssock_buffered_filter_init.cpp
+ *
+ * Unit tests for ssock_buffered_filter_init.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that ssock_buffered_filter_init does runtime parameter checks.
+ */
+TEST(test_ssock_buffered_filter_init, parameter_checks)
+{
+    ssock inner, sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+
+    malloc_allocator_options_init(&alloc_opts);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_buffered_filter_init(nullptr, &inner, &alloc_opts, 16, 16));
+
+    /* call with invalid inner socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_buffered_filter_init(&sock, nullptr, &alloc_opts, 16, 16));
+
+    /* call with invalid allocator. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_buffered_filter_init(&sock, &inner, nullptr, 16, 16));
+
+    /* clean up */
+    dispose((disposable_t*)&inner);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that small writes are coalesced until flushed, in a filter chain with
+ * a counter below the buffer.
+ */
+TEST(test_ssock_buffered_filter_init, coalesced_writes)
+{
+    ssock inner, counted, sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    ssock_stats stats;
+    char* str = nullptr;
+    uint64_t val = 0;
+
+    malloc_allocator_options_init(&alloc_opts);
+    memset(&stats, 0, sizeof(stats));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_stats_filter_init(&counted, &inner, &stats));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_buffered_filter_init(&sock, &counted, &alloc_opts, 64, 64));
+
+    /* small writes are held in the buffer. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_string(&sock, "abc"));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint64(&sock, 99));
+    EXPECT_EQ(0U, stats.write_calls);
+    EXPECT_EQ(0U, stream.size());
+
+    /* a flush writes them out in a single call. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_flush(&sock));
+    EXPECT_EQ(1U, stats.write_calls);
+    EXPECT_EQ(8U + 13U, stream.size());
+
+    /* the packets read back through the buffer with a single read. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_string(&sock, &alloc_opts, &str));
+    EXPECT_STREQ("abc", str);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint64(&sock, &val));
+    EXPECT_EQ(99U, val);
+    EXPECT_EQ(1U, stats.read_calls);
+
+    release(&alloc_opts, str);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that large writes and reads bypass the buffer, and that reads are
+ * satisfied in full over short reads from the inner socket.
+ */
+TEST(test_ssock_buffered_filter_init, large_transfers)
+{
+    ssock inner, sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream, expected;
+    size_t offset = 0;
+    void* data = nullptr;
+    uint32_t size = 0;
+    uint8_t val = 0;
+
+    malloc_allocator_options_init(&alloc_opts);
+
+    /* the inner socket returns at most 3 bytes per read. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset, 3));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_buffered_filter_init(&sock, &inner, &alloc_opts, 16, 16));
+
+    for (int i = 0; i < 100; ++i)
+        expected.push_back((uint8_t)i);
+
+    /* a buffered write followed by a large write keeps its order. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint8(&sock, 42));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_flush(&sock));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint8(&sock, &val));
+    EXPECT_EQ(42, val);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data(&sock, &alloc_opts, &data, &size));
+    ASSERT_EQ(expected.size(), size);
+    EXPECT_EQ(0, memcmp(expected.data(), data, size));
+    EXPECT_EQ(stream.size(), offset);
+
+    release(&alloc_opts, data);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that a failed allocation leaves the filter cleared and the inner socket
+ * with the caller.
+ */
+TEST(test_ssock_buffered_filter_init, out_of_memory)
+{
+    ssock inner, sock;
+    allocator_options_t alloc_opts, failing_opts;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    size_t size = 5;
+
+    malloc_allocator_options_init(&alloc_opts);
+    memcpy(&failing_opts, &alloc_opts, sizeof(failing_opts));
+    failing_opts.allocator_allocate =
+        [](void*, size_t) -> void* { return nullptr; };
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    memset(&sock, 0xFF, sizeof(sock));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY,
+        ssock_buffered_filter_init(&sock, &inner, &failing_opts, 16, 16));
+    EXPECT_EQ(nullptr, sock.hdr.dispose);
+    EXPECT_EQ(nullptr, sock.inner);
+    EXPECT_EQ(nullptr, sock.context);
+
+    /* the inner socket is still usable and still ours to dispose. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write(&inner, "hello", &size));
+    EXPECT_EQ(5U, stream.size());
+
+    /* clean up */
+    dispose((disposable_t*)&inner);
+    dispose((disposable_t*)&alloc_opts);
+}
@@ -0,0 +1,308 @@
+/**
+ * \file test/ssock/test_ssock_coro.cpp
+ *
+ * Unit tests for the C++20 coroutine ssock wrapper.  These tests are only
+ * built when the cpp20_coroutines option is enabled.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#if defined(__cpp_impl_coroutine)
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/socket.h>
+#include <vcblockchain/ssock_coro.hpp>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+using namespace vcblockchain;
+
+namespace {
+
+struct coro_request
+{
+    uint64_t id;
+    int32_t delta;
+    string name;
+};
+
+}
+
+namespace vcblockchain {
+
+template <>
+struct ssock_fields<coro_request>
+{
+    static auto get()
+    {
+        return make_tuple(
+            &coro_request::id, &coro_request::delta, &coro_request::name);
+    }
+};
+
+}
+
+class test_ssock_coro : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        ASSERT_TRUE(reactor.valid());
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    void make_pair(int* sv)
+    {
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    }
+
+    /**
+     * \brief Echo requests until the peer disconnects.
+     */
+    ssock_task<void> server(int sd)
+    {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        coro_request req;
+
+        while (VCBLOCKCHAIN_STATUS_SUCCESS == co_await sock.read(req))
+        {
+            req.delta += 1;
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != co_await sock.write(req))
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * \brief Send a few requests and check each echo.
+     */
+    ssock_task<void> client(int sd, uint64_t id)
+    {
+        ssock_async sock(reactor, sd, &alloc_opts);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            coro_request req{ id, i, "session-" + to_string(id) };
+            coro_request resp;
+
+            if (VCBLOCKCHAIN_STATUS_SUCCESS != co_await sock.write(req)
+             || VCBLOCKCHAIN_STATUS_SUCCESS != co_await sock.read(resp))
+            {
+                co_return;
+            }
+
+            if (resp.id == id && resp.delta == i + 1 && resp.name == req.name)
+            {
+                ++echoes;
+            }
+        }
+    }
+
+    allocator_options_t alloc_opts;
+    ssock_reactor reactor;
+    int echoes = 0;
+};
+
+/**
+ * Test that many sessions run concurrently on one reactor thread.
+ */
+TEST_F(test_ssock_coro, many_sessions)
+{
+    const int sessions = 200;
+
+    for (int i = 0; i < sessions; ++i)
+    {
+        int sv[2];
+        make_pair(sv);
+
+        reactor.spawn(server(sv[0]));
+        reactor.spawn(client(sv[1], i));
+    }
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reactor.run());
+    EXPECT_EQ(3 * sessions, echoes);
+}
+
+/**
+ * Test that a payload larger than the socket buffer is written and read
+ * concurrently, with both sides parking on the reactor.
+ */
+TEST_F(test_ssock_coro, large_payload)
+{
+    int sv[2];
+    vector<uint8_t> sent(4 * 1024 * 1024), received;
+    int write_status = -1, read_status = -1;
+
+    for (size_t i = 0; i < sent.size(); ++i)
+        sent[i] = (uint8_t)(i * 31 + (i >> 12));
+
+    make_pair(sv);
+
+    auto writer = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        write_status = co_await sock.write(sent);
+    };
+
+    auto reader = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        read_status = co_await sock.read(received);
+    };
+
+    reactor.spawn(writer(sv[0]));
+    reactor.spawn(reader(sv[1]));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reactor.run());
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, write_status);
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, read_status);
+    EXPECT_EQ(sent, received);
+}
+
+/**
+ * Test that packets written by the blocking C API are read by the coroutine
+ * API.
+ */
+TEST_F(test_ssock_coro, c_api_interop)
+{
+    int sv[2];
+    ssock peer;
+    uint8_t payload[] = { 1, 2, 3, 4, 5 };
+    uint64_t u64 = 0;
+    string str;
+    ssock_buffer data;
+    int status = -1;
+
+    make_pair(sv);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&peer, sv[0]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint64(&peer, 77));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_string(&peer, "abc"));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&peer, payload, sizeof(payload)));
+
+    auto reader = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        status = co_await sock.read(u64);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status)
+            status = co_await sock.read(str);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == status)
+            status = co_await sock.read(data);
+    };
+
+    reactor.spawn(reader(sv[1]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reactor.run());
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, status);
+    EXPECT_EQ(77U, u64);
+    EXPECT_EQ("abc", str);
+    ASSERT_EQ(sizeof(payload), data.size());
+    EXPECT_EQ(0, memcmp(payload, data.data(), data.size()));
+
+    dispose((disposable_t*)&peer);
+}
+
+/**
+ * Test that negotiated compression and the read policy apply to coroutine
+ * sockets through their codec.
+ */
+TEST_F(test_ssock_coro, codec_settings)
+{
+    int sv[2];
+    vector<uint8_t> sent(100000), received;
+    int status = -1, limited = -1;
+
+    for (size_t i = 0; i < sent.size(); ++i)
+        sent[i] = (uint8_t)("artifact"[i % 8]);
+
+    make_pair(sv);
+
+    auto writer = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        sock.codec()->compression.codec = SSOCK_COMPRESSION_LZ;
+        sock.codec()->compression.alloc_opts = &alloc_opts;
+        co_await sock.write(sent);
+        co_await sock.write(sent);
+    };
+
+    auto reader = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        sock.codec()->compression.codec = SSOCK_COMPRESSION_LZ;
+        sock.codec()->compression.alloc_opts = &alloc_opts;
+        status = co_await sock.read(received);
+
+        /* the second packet decompresses past the policy limit. */
+        sock.codec()->read_policy.max_data_size = 1000;
+        limited = co_await sock.read(received);
+    };
+
+    reactor.spawn(writer(sv[0]));
+    reactor.spawn(reader(sv[1]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reactor.run());
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, status);
+    EXPECT_EQ(sent, received);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE, limited);
+}
+
+/**
+ * Test that a zeroed read policy applies the default string size limit before
+ * any of the payload arrives.
+ */
+TEST_F(test_ssock_coro, default_string_limit)
+{
+    int sv[2];
+    string val;
+    int status = -1;
+
+    make_pair(sv);
+
+    /* claim a string one byte over the default limit, but send no payload. */
+    const uint32_t size = SSOCK_DEFAULT_MAX_STRING_SIZE + 1;
+    const uint8_t header[SSOCK_PACKET_HEADER_SIZE] = {
+        SSOCK_DATA_TYPE_STRING, (uint8_t)(size >> 24), (uint8_t)(size >> 16),
+        (uint8_t)(size >> 8), (uint8_t)size };
+    ASSERT_EQ((ssize_t)sizeof(header), write(sv[0], header, sizeof(header)));
+
+    auto reader = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        status = co_await sock.read(val);
+    };
+
+    reactor.spawn(reader(sv[1]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reactor.run());
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE, status);
+
+    close(sv[0]);
+}
+
+/**
+ * Test that a read fails when the peer disconnects.
+ */
+TEST_F(test_ssock_coro, peer_disconnect)
+{
+    int sv[2];
+    uint32_t val = 0;
+    int status = -1;
+
+    make_pair(sv);
+    close(sv[0]);
+
+    auto reader = [&](int sd) -> ssock_task<void> {
+        ssock_async sock(reactor, sd, &alloc_opts);
+        status = co_await sock.read(val);
+    };
+
+    reactor.spawn(reader(sv[1]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reactor.run());
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ, status);
+}
+
+#endif /*__cpp_impl_coroutine*/
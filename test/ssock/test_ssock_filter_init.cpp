@@ -0,0 +1,83 @@
+/**
+ * \file test/ssock/test_ssock_filter_init.cpp
+ *
+ * Unit tests for ssock_filter_init and ssock_flush.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that ssock_filter_init does runtime parameter checks.
+ */
+TEST(test_ssock_filter_init, parameter_checks)
+{
+    ssock inner, sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_filter_init(nullptr, &inner));
+
+    /* call with invalid inner socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_filter_init(&sock, nullptr));
+
+    /* a socket can't wrap itself. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_filter_init(&inner, &inner));
+
+    /* flush with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, ssock_flush(nullptr));
+
+    /* clean up */
+    dispose((disposable_t*)&inner);
+}
+
+/**
+ * Test that a pass-through filter forwards reads, writes, and flushes.
+ */
+TEST(test_ssock_filter_init, pass_through)
+{
+    ssock inner, sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    uint64_t val = 0;
+    ssock_read_policy policy;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    memset(&policy, 0, sizeof(policy));
+    policy.max_data_size = 1234;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&inner, &policy));
+
+    /* an unbuffered socket has nothing to flush. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_flush(&inner));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_filter_init(&sock, &inner));
+
+    /* the read policy is inherited from the inner socket. */
+    EXPECT_EQ(1234U, sock.read_policy.max_data_size);
+
+    /* writes and reads pass through. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint64(&sock, 77));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_flush(&sock));
+    EXPECT_EQ(13U, stream.size());
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint64(&sock, &val));
+    EXPECT_EQ(77U, val);
+
+    /* disposing the filter disposes the inner socket. */
+    dispose((disposable_t*)&sock);
+}
@@ -0,0 +1,131 @@
+/**
+ * \file test/ssock/test_ssock_hash_filter_init.cpp
+ *
+ * Unit tests for ssock_hash_filter_init.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+class test_ssock_hash_filter_init : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        vccrypt_suite_register_velo_v1();
+
+        malloc_allocator_options_init(&alloc_opts);
+
+        ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_options_init(
+                &suite, &alloc_opts, VCCRYPT_SUITE_VELO_V1));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&suite);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Finalize a hash into a vector.
+     */
+    vector<uint8_t> finalize(vccrypt_hash_context_t* hash)
+    {
+        vccrypt_buffer_t buf;
+        vector<uint8_t> out;
+
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS,
+            vccrypt_suite_buffer_init_for_hash(&suite, &buf));
+        EXPECT_EQ(VCCRYPT_STATUS_SUCCESS, vccrypt_hash_finalize(hash, &buf));
+
+        const uint8_t* in = (const uint8_t*)buf.data;
+        out.assign(in, in + buf.size);
+        dispose((disposable_t*)&buf);
+
+        return out;
+    }
+
+    allocator_options_t alloc_opts;
+    vccrypt_suite_options_t suite;
+};
+
+/**
+ * Test that ssock_hash_filter_init does runtime parameter checks.
+ */
+TEST_F(test_ssock_hash_filter_init, parameter_checks)
+{
+    ssock inner, sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_hash_filter_init(nullptr, &inner, &alloc_opts, nullptr, nullptr));
+
+    /* call with invalid inner socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_hash_filter_init(&sock, nullptr, &alloc_opts, nullptr, nullptr));
+
+    /* call with invalid allocator. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_hash_filter_init(&sock, &inner, nullptr, nullptr, nullptr));
+
+    /* clean up */
+    dispose((disposable_t*)&inner);
+}
+
+/**
+ * Test that the running hashes match a hash of the transcript.
+ */
+TEST_F(test_ssock_hash_filter_init, transcript)
+{
+    ssock inner, sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    vccrypt_hash_context_t read_hash, write_hash, expected_hash;
+    uint32_t val = 0;
+
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_hash_init(&suite, &read_hash));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_hash_init(&suite, &write_hash));
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_suite_hash_init(&suite, &expected_hash));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_hash_filter_init(
+            &sock, &inner, &alloc_opts, &read_hash, &write_hash));
+
+    /* write and read back a few packets. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&sock, 17));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&sock, 18));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&sock, &val));
+    EXPECT_EQ(17U, val);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&sock, &val));
+    EXPECT_EQ(18U, val);
+
+    /* both hashes match a hash of the whole stream. */
+    ASSERT_EQ(VCCRYPT_STATUS_SUCCESS,
+        vccrypt_hash_digest(&expected_hash, stream.data(), stream.size()));
+    vector<uint8_t> expected = finalize(&expected_hash);
+    EXPECT_EQ(expected, finalize(&write_hash));
+    EXPECT_EQ(expected, finalize(&read_hash));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&read_hash);
+    dispose((disposable_t*)&write_hash);
+    dispose((disposable_t*)&expected_hash);
+}
@@ -0,0 +1,258 @@
+/**
+ * \file test/ssock/test_ssock_hpp.cpp
+ *
+ * Unit tests for the typed C++ ssock wrapper.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vcblockchain/ssock.hpp>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+using namespace vcblockchain;
+
+namespace {
+
+struct test_header
+{
+    uint8_t version;
+    int32_t flags;
+};
+
+struct test_message
+{
+    test_header header;
+    uint64_t offset;
+    int64_t delta;
+    uint32_t count;
+    int8_t sign;
+    string id;
+    vector<uint8_t> payload;
+};
+
+}
+
+namespace vcblockchain {
+
+template <>
+struct ssock_fields<test_header>
+{
+    static auto get()
+    {
+        return make_tuple(&test_header::version, &test_header::flags);
+    }
+};
+
+template <>
+struct ssock_fields<test_message>
+{
+    static auto get()
+    {
+        return make_tuple(
+            &test_message::header, &test_message::offset,
+            &test_message::delta, &test_message::count, &test_message::sign,
+            &test_message::id, &test_message::payload);
+    }
+};
+
+}
+
+class test_ssock_hpp : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        memset(&stats, 0, sizeof(stats));
+        offset = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            dummy_stream_ssock_init(&inner, stream, offset));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_stats_filter_init(&sock, &inner, &stats));
+
+        msg.header.version = 3;
+        msg.header.flags = -17;
+        msg.offset = 0x0102030405060708ULL;
+        msg.delta = -123456789012LL;
+        msg.count = 0xDEADBEEF;
+        msg.sign = -1;
+        msg.id = "artifact";
+        msg.payload = { 0x00, 0x01, 0xFE, 0xFF };
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&sock);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    static void expect_equal(const test_message& a, const test_message& b)
+    {
+        EXPECT_EQ(a.header.version, b.header.version);
+        EXPECT_EQ(a.header.flags, b.header.flags);
+        EXPECT_EQ(a.offset, b.offset);
+        EXPECT_EQ(a.delta, b.delta);
+        EXPECT_EQ(a.count, b.count);
+        EXPECT_EQ(a.sign, b.sign);
+        EXPECT_EQ(a.id, b.id);
+        EXPECT_EQ(a.payload, b.payload);
+    }
+
+    allocator_options_t alloc_opts;
+    ssock inner, sock;
+    ssock_stats stats;
+    vector<uint8_t> stream;
+    size_t offset;
+    test_message msg;
+};
+
+/**
+ * Test that the memory writer produces the same bytes as the C API.
+ */
+TEST_F(test_ssock_hpp, memory_writer_matches_c_api)
+{
+    ssock_memory_writer writer;
+    ssock_stream s(&sock, &alloc_opts);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write(msg));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s.write(msg));
+
+    EXPECT_EQ(stream, writer.buffer());
+
+    /* the C API reads each field back. */
+    uint8_t version = 0;
+    int32_t flags = 0;
+    uint64_t off = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint8(&sock, &version));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_int32(&sock, &flags));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint64(&sock, &off));
+    EXPECT_EQ(msg.header.version, version);
+    EXPECT_EQ(msg.header.flags, flags);
+    EXPECT_EQ(msg.offset, off);
+}
+
+/**
+ * Test that a struct can be written and read one field at a time.
+ */
+TEST_F(test_ssock_hpp, stream_round_trip)
+{
+    ssock_stream s(&sock, &alloc_opts);
+    test_message out;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s.write(msg));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s.read(out));
+
+    expect_equal(msg, out);
+    EXPECT_EQ(stream.size(), offset);
+}
+
+/**
+ * Test that a string holding a NUL is written in full.
+ */
+TEST_F(test_ssock_hpp, stream_string_with_nul)
+{
+    ssock_memory_writer writer;
+    ssock_stream s(&sock, &alloc_opts);
+    string val("ab\0cd", 5);
+    string out;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write(val));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s.write(val));
+
+    /* the whole string is on the wire, encoded as the C API encodes it. */
+    EXPECT_EQ(writer.buffer(), stream);
+
+    ssock_memory_reader reader(stream.data(), stream.size());
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, reader.read(out));
+    EXPECT_EQ(val, out);
+}
+
+/**
+ * Test that a message is sent as one data packet with one write, and read back
+ * with the memory reader.
+ */
+TEST_F(test_ssock_hpp, message_round_trip)
+{
+    test_message out;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_message(&sock, msg));
+    EXPECT_EQ(1U, stats.write_calls);
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, stream[0]);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_message(&sock, &alloc_opts, out));
+
+    expect_equal(msg, out);
+}
+
+/**
+ * Test that the memory reader checks types, sizes, and bounds.
+ */
+TEST_F(test_ssock_hpp, memory_reader_errors)
+{
+    ssock_memory_writer writer;
+    uint32_t u32 = 0;
+    uint64_t u64 = 0;
+    string str;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write(string("hello")));
+    vector<uint8_t> buf = writer.buffer();
+
+    /* the wrong type is rejected. */
+    ssock_memory_reader wrong_type(buf.data(), buf.size());
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        wrong_type.read(u32));
+
+    /* a truncated buffer is rejected. */
+    ssock_memory_reader truncated(buf.data(), buf.size() - 1);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ, truncated.read(str));
+
+    /* a mismatched integer size is rejected. */
+    writer.clear();
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write((uint32_t)5));
+    buf = writer.buffer();
+    buf[0] = SSOCK_DATA_TYPE_UINT64;
+    ssock_memory_reader wrong_size(buf.data(), buf.size());
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        wrong_size.read(u64));
+}
+
+/**
+ * Test that a trailing value in a message is rejected.
+ */
+TEST_F(test_ssock_hpp, message_trailing_data)
+{
+    ssock_memory_writer writer;
+    test_header hdr;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write(msg.header));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.write((uint8_t)1));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, writer.send(&sock));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        ssock_read_message(&sock, &alloc_opts, hdr));
+}
+
+/**
+ * Test that ssock_buffer owns and releases a buffer read from a socket.
+ */
+TEST_F(test_ssock_hpp, buffer_ownership)
+{
+    ssock_stream s(&sock, &alloc_opts);
+    ssock_buffer buf;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s.write(msg.payload));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, s.read(buf));
+    ASSERT_EQ(msg.payload.size(), buf.size());
+    EXPECT_EQ(0, memcmp(msg.payload.data(), buf.data(), buf.size()));
+
+    /* ownership moves with the buffer. */
+    ssock_buffer moved(std::move(buf));
+    EXPECT_EQ(nullptr, buf.data());
+    EXPECT_EQ(msg.payload.size(), moved.size());
+}
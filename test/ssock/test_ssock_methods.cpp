@@ -6,9 +6,15 @@
  * \copyright 2020 Velo Payments, Inc.  All rights reserved.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <gtest/gtest.h>
+#include <list>
+#include <memory>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <thread>
 #include <vcblockchain/ssock.h>
 
 #include "dummy_ssock.h"
@@ -118,3 +124,132 @@ TEST(test_ssock_methods, posix_socket)
     dispose((disposable_t*)&lhs);
     dispose((disposable_t*)&rhs);
 }
+
+/**
+ * Test that a gathered write on a POSIX socket arrives as one byte stream.
+ */
+TEST(test_ssock_methods, posix_socket_writev)
+{
+    int sv[2];
+    ssock lhs, rhs;
+    const char* parts[] = { "alpha", "", "beta", "gamma" };
+    ssock_iovec iov[4];
+
+    /* build a socket pair. */
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&lhs, sv[0]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&rhs, sv[1]));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        iov[i].base = parts[i];
+        iov[i].size = strlen(parts[i]);
+    }
+
+    /* write all parts with a single gathered write. */
+    size_t write_bytes = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_writev(&lhs, iov, 4, &write_bytes));
+    EXPECT_EQ(14U, write_bytes);
+
+    /* read them back. */
+    char buf[15] = { 0 };
+    size_t read_bytes = 14;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read(&rhs, buf, &read_bytes));
+    EXPECT_EQ(14U, read_bytes);
+    EXPECT_STREQ("alphabetagamma", buf);
+
+    /* clean up. */
+    dispose((disposable_t*)&lhs);
+    dispose((disposable_t*)&rhs);
+}
+
+/**
+ * Test that a gathered write falls back to writing each buffer in turn, and
+ * stops at a short write.
+ */
+TEST(test_ssock_methods, writev_fallback)
+{
+    ssock sock;
+    list<shared_ptr<ssock_write_params>> write_calls;
+    const char* parts[] = { "abc", "defg", "hi" };
+    ssock_iovec iov[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        iov[i].base = parts[i];
+        iov[i].size = strlen(parts[i]);
+    }
+
+    /* the dummy socket writes at most three bytes per call. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+            },
+            [&](ssock* s, const void* b, size_t* sz) -> int {
+                *sz = min(*sz, (size_t)3);
+                write_calls.push_back(
+                    make_shared<ssock_write_params>(s, b, *sz));
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    /* parameter checks. */
+    size_t write_bytes = 0;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_writev(nullptr, iov, 3, &write_bytes));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_writev(&sock, nullptr, 3, &write_bytes));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_writev(&sock, iov, 3, nullptr));
+
+    /* the second buffer is written short, so the third is not written. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_writev(&sock, iov, 3, &write_bytes));
+    EXPECT_EQ(6U, write_bytes);
+    EXPECT_EQ(2U, write_calls.size());
+
+    /* clean up. */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that shutting down a POSIX socket wakes a blocked read, which reports
+ * end of stream.
+ */
+TEST(test_ssock_methods, posix_socket_shutdown)
+{
+    int sv[2];
+    ssock lhs, rhs;
+    uint8_t byte = 0;
+    size_t read_bytes = 0;
+    int read_status = -1;
+
+    /* build a socket pair. */
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&lhs, sv[0]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&rhs, sv[1]));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, ssock_shutdown(nullptr));
+
+    /* the peer never writes, so this read blocks until shutdown. */
+    thread reader([&]() {
+        read_bytes = sizeof(byte);
+        read_status = ssock_read(&rhs, &byte, &read_bytes);
+    });
+
+    this_thread::sleep_for(chrono::milliseconds(20));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_shutdown(&rhs));
+    reader.join();
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, read_status);
+    EXPECT_EQ(0U, read_bytes);
+
+    /* shutting down again is harmless. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_shutdown(&rhs));
+
+    /* clean up. */
+    dispose((disposable_t*)&lhs);
+    dispose((disposable_t*)&rhs);
+}
@@ -0,0 +1,288 @@
+/**
+ * \file test/ssock/test_ssock_negotiate_compression.cpp
+ *
+ * Unit tests for ssock_negotiate_compression and compressed data packets.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+class test_ssock_negotiate_compression : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        memset(&stats, 0, sizeof(stats));
+        offset = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            dummy_stream_ssock_init(&inner, stream, offset));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_stats_filter_init(&sock, &inner, &stats));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&sock);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Negotiate compression against our own offer, echoed back by the
+     * loopback stream.
+     */
+    void enable()
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_negotiate_compression(
+                &sock, &alloc_opts, SSOCK_COMPRESSION_LZ, 0));
+        ASSERT_EQ(SSOCK_COMPRESSION_LZ, sock.compression.codec);
+    }
+
+    /**
+     * \brief Build a compressible payload, like a run of certificate fields.
+     */
+    static vector<uint8_t> compressible(size_t size)
+    {
+        vector<uint8_t> out;
+        const char* fields[] = { "artifact_id", "transaction_type",
+                                 "previous_block", "signer" };
+
+        for (size_t i = 0; out.size() < size; ++i)
+        {
+            const char* f = fields[i % 4];
+            out.insert(out.end(), f, f + strlen(f));
+            out.push_back((uint8_t)(i & 0x3));
+        }
+
+        out.resize(size);
+        return out;
+    }
+
+    allocator_options_t alloc_opts;
+    ssock inner, sock;
+    ssock_stats stats;
+    vector<uint8_t> stream;
+    size_t offset;
+};
+
+/**
+ * Test that ssock_negotiate_compression does runtime parameter checks.
+ */
+TEST_F(test_ssock_negotiate_compression, parameter_checks)
+{
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_negotiate_compression(
+            nullptr, &alloc_opts, SSOCK_COMPRESSION_LZ, 0));
+
+    /* offering compression requires an allocator. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_negotiate_compression(&sock, nullptr, SSOCK_COMPRESSION_LZ, 0));
+
+    /* declining compression does not. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_negotiate_compression(&sock, nullptr, SSOCK_COMPRESSION_NONE, 0));
+    EXPECT_EQ(SSOCK_COMPRESSION_NONE, sock.compression.codec);
+}
+
+/**
+ * Test that compression is only enabled when both peers offer it.
+ */
+TEST_F(test_ssock_negotiate_compression, peer_declines)
+{
+    /* the peer's offer is already in the stream, declining compression. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_uint8(&inner, SSOCK_COMPRESSION_NONE));
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_negotiate_compression(
+            &sock, &alloc_opts, SSOCK_COMPRESSION_LZ, 0));
+    EXPECT_EQ(SSOCK_COMPRESSION_NONE, sock.compression.codec);
+}
+
+/**
+ * Test that a compressible payload is sent compressed and read back intact.
+ */
+TEST_F(test_ssock_negotiate_compression, round_trip)
+{
+    vector<uint8_t> expected = compressible(100000);
+    void* val = nullptr;
+    uint32_t size = 0;
+
+    enable();
+    size_t start = stream.size();
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+
+    /* the packet is compressed, and sent in a single write. */
+    EXPECT_EQ(SSOCK_DATA_TYPE_COMPRESSED_DATA_PACKET, stream[start]);
+    EXPECT_LT(stream.size() - start, expected.size() / 4);
+    EXPECT_EQ(1U, stats.compressed_packets);
+    EXPECT_EQ(expected.size(), stats.compress_bytes_in);
+    EXPECT_EQ(stream.size() - start - 9, stats.compress_bytes_out);
+
+    /* the reader decompresses it transparently. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data(&sock, &alloc_opts, &val, &size));
+    ASSERT_EQ(expected.size(), size);
+    EXPECT_EQ(0, memcmp(expected.data(), val, size));
+    EXPECT_EQ(stats.compress_bytes_out, stats.decompress_bytes_in);
+    EXPECT_EQ(expected.size(), stats.decompress_bytes_out);
+
+    release(&alloc_opts, val);
+}
+
+/**
+ * Test that small and incompressible payloads are sent uncompressed.
+ */
+TEST_F(test_ssock_negotiate_compression, skipped)
+{
+    vector<uint8_t> small = compressible(100);
+    vector<uint8_t> noise;
+    ssock_value any;
+
+    uint32_t x = 12345;
+    for (int i = 0; i < 4096; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        noise.push_back((uint8_t)(x >> 24));
+    }
+
+    enable();
+    size_t start = stream.size();
+
+    /* below the threshold. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, small.data(), small.size()));
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, stream[start]);
+
+    /* incompressible. */
+    start = stream.size();
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, noise.data(), noise.size()));
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, stream[start]);
+    EXPECT_EQ(0U, stats.compressed_packets);
+
+    /* both read back through read_any. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &any));
+    EXPECT_EQ(small.size(), any.size);
+    release(&alloc_opts, any.val.data_val);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &any));
+    ASSERT_EQ(noise.size(), any.size);
+    EXPECT_EQ(0, memcmp(noise.data(), any.val.data_val, any.size));
+    release(&alloc_opts, any.val.data_val);
+}
+
+/**
+ * Test that read_any reports a compressed packet as a data packet.
+ */
+TEST_F(test_ssock_negotiate_compression, read_any)
+{
+    vector<uint8_t> expected = compressible(5000);
+    ssock_value any;
+
+    enable();
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &any));
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, any.type);
+    ASSERT_EQ(expected.size(), any.size);
+    EXPECT_EQ(0, memcmp(expected.data(), any.val.data_val, any.size));
+
+    release(&alloc_opts, any.val.data_val);
+}
+
+/**
+ * Test that compressed packets are rejected unless negotiated, and that the
+ * read policy bounds the decompressed size.
+ */
+TEST_F(test_ssock_negotiate_compression, rejected)
+{
+    vector<uint8_t> expected = compressible(5000);
+    ssock_read_policy policy;
+    void* val = nullptr;
+    uint32_t size = 0;
+
+    enable();
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+
+    /* the decompressed size exceeds the read policy. */
+    memset(&policy, 0, sizeof(policy));
+    policy.max_data_size = 4000;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&sock, &policy));
+    val = &size;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        ssock_read_data(&sock, &alloc_opts, &val, &size));
+    EXPECT_EQ(nullptr, val);
+
+    /* a reader which did not negotiate compression rejects the packet. */
+    ssock plain;
+    size_t plain_offset = stream.size();
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&plain, stream, plain_offset));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+    val = &size;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        ssock_read_data(&plain, &alloc_opts, &val, &size));
+    EXPECT_EQ(nullptr, val);
+
+    dispose((disposable_t*)&plain);
+}
+
+/**
+ * Test that corrupted compressed packets fail cleanly.
+ */
+TEST_F(test_ssock_negotiate_compression, corrupted)
+{
+    vector<uint8_t> expected = compressible(3000);
+
+    enable();
+    size_t start = stream.size();
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+    vector<uint8_t> packet(stream.begin() + start, stream.end());
+
+    /* corrupt each byte of the payload in turn. */
+    for (size_t i = 9; i < packet.size(); ++i)
+    {
+        void* val = &stream;
+        uint32_t size = 0;
+
+        stream = packet;
+        stream[i] ^= 0x5A;
+        offset = 0;
+
+        int retval = ssock_read_data(&sock, &alloc_opts, &val, &size);
+        if (VCBLOCKCHAIN_STATUS_SUCCESS == retval)
+        {
+            /* a literal byte was changed; the size is still intact. */
+            EXPECT_EQ(expected.size(), size);
+            release(&alloc_opts, val);
+        }
+        else
+        {
+            EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_DECOMPRESS, retval);
+            EXPECT_EQ(nullptr, val);
+        }
+    }
+}
@@ -0,0 +1,292 @@
+/**
+ * \file test/ssock/test_ssock_prefetch_filter_init.cpp
+ *
+ * Unit tests for ssock_prefetch_filter_init.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+class test_ssock_prefetch_filter_init : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    /**
+     * \brief Wait for a counter to reach a value, giving up after a second.
+     */
+    static void wait_for(const atomic<size_t>& counter, size_t value)
+    {
+        for (int i = 0; i < 1000 && counter.load() < value; ++i)
+            this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    allocator_options_t alloc_opts;
+};
+
+/**
+ * Test that ssock_prefetch_filter_init does runtime parameter checks.
+ */
+TEST_F(test_ssock_prefetch_filter_init, parameter_checks)
+{
+    ssock sock, inner;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_prefetch_filter_init(nullptr, &inner, &alloc_opts, 2, 64));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_prefetch_filter_init(&sock, nullptr, &alloc_opts, 2, 64));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_prefetch_filter_init(&sock, &inner, nullptr, 2, 64));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 1, 64));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 2, 0));
+
+    dispose((disposable_t*)&inner);
+}
+
+/**
+ * Test that packets which straddle slots are read back intact, followed by end
+ * of stream.
+ */
+TEST_F(test_ssock_prefetch_filter_init, packets_across_slots)
+{
+    ssock writer, inner, sock;
+    vector<uint8_t> stream;
+    size_t write_offset = 0, read_offset = 0;
+    const uint32_t count = 200;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&writer, stream, write_offset));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        vector<uint8_t> payload(1 + i % 150, (uint8_t)i);
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_data(&writer, payload.data(), payload.size()));
+    }
+
+    dispose((disposable_t*)&writer);
+
+    /* reads from the stream are smaller than the slots. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, read_offset, 40));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 4, 64));
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        void* val = nullptr;
+        uint32_t size = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_data(&sock, &alloc_opts, &val, &size));
+        ASSERT_EQ(1 + i % 150, size);
+        vector<uint8_t> expected(size, (uint8_t)i);
+        EXPECT_EQ(0, memcmp(expected.data(), val, size));
+        release(&alloc_opts, val);
+    }
+
+    /* end of stream is reported as a short read. */
+    uint8_t byte;
+    size_t size = sizeof(byte);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read(&sock, &byte, &size));
+    EXPECT_EQ(0U, size);
+
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that the I/O thread reads ahead without a reader, but no further than
+ * the number of slots.
+ */
+TEST_F(test_ssock_prefetch_filter_init, bounded_read_ahead)
+{
+    ssock inner, sock;
+    atomic<size_t> reads(0);
+    uint8_t buf[11];
+    size_t size;
+
+    /* an endless stream, ten bytes at a time. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(&inner,
+            [&](ssock*, void* b, size_t* sz) -> int {
+                *sz = min(*sz, (size_t)10);
+                memset(b, (int)reads.load(), *sz);
+                ++reads;
+                return VCBLOCKCHAIN_STATUS_SUCCESS; },
+            [](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_ERROR_SSOCK_WRITE; }));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 3, 64));
+
+    /* every slot fills before anything is read. */
+    wait_for(reads, 3);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    EXPECT_EQ(3U, reads.load());
+
+    /* draining the first slot frees it for the I/O thread. */
+    size = sizeof(buf);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read(&sock, buf, &size));
+    ASSERT_EQ(sizeof(buf), size);
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(1, buf[10]);
+
+    wait_for(reads, 4);
+    EXPECT_EQ(4U, reads.load());
+
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that a read error is reported after the data that preceded it.
+ */
+TEST_F(test_ssock_prefetch_filter_init, error_after_data)
+{
+    ssock inner, sock;
+    atomic<size_t> reads(0);
+    uint8_t buf[16];
+    size_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(&inner,
+            [&](ssock*, void* b, size_t* sz) -> int {
+                if (reads++ > 0)
+                    return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+                *sz = 5;
+                memset(b, 0x5A, *sz);
+                return VCBLOCKCHAIN_STATUS_SUCCESS; },
+            [](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_ERROR_SSOCK_WRITE; }));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 2, 64));
+
+    size = sizeof(buf);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read(&sock, buf, &size));
+    ASSERT_EQ(5U, size);
+    EXPECT_EQ(0x5A, buf[4]);
+
+    size = sizeof(buf);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ, ssock_read(&sock, buf, &size));
+
+    /* the error is sticky. */
+    size = sizeof(buf);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ, ssock_read(&sock, buf, &size));
+
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that a POSIX socket can be read ahead while a peer thread writes and
+ * the reader writes replies through the same instance.
+ */
+TEST_F(test_ssock_prefetch_filter_init, posix_socket)
+{
+    int sv[2];
+    ssock peer, inner, sock;
+    const uint32_t count = 500;
+    vector<uint8_t> payload(4096);
+    atomic<uint32_t> acks(0);
+
+    for (size_t i = 0; i < payload.size(); ++i)
+        payload[i] = (uint8_t)(i * 7);
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&peer, sv[0]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&inner, sv[1]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 4, 16384));
+
+    /* the peer sends and receives acks on separate threads. */
+    thread sender([&]() {
+        vector<uint8_t> packet(payload);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            packet[0] = (uint8_t)i;
+            EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                ssock_write_data(&peer, packet.data(), packet.size()));
+        }
+    });
+
+    thread acker([&]() {
+        uint32_t ack = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (VCBLOCKCHAIN_STATUS_SUCCESS == ssock_read_uint32(&peer, &ack) && ack == i)
+                ++acks;
+        }
+    });
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        void* val = nullptr;
+        uint32_t size = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_data(&sock, &alloc_opts, &val, &size));
+        ASSERT_EQ(payload.size(), size);
+        EXPECT_EQ((uint8_t)i, ((uint8_t*)val)[0]);
+        EXPECT_EQ(0, memcmp(payload.data() + 1, (uint8_t*)val + 1, size - 1));
+        release(&alloc_opts, val);
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&sock, i));
+    }
+
+    sender.join();
+    acker.join();
+    EXPECT_EQ(count, acks.load());
+
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&peer);
+}
+
+/**
+ * Test that disposing the filter stops an I/O thread blocked reading a quiet
+ * POSIX socket, and that the peer then sees end of stream.
+ */
+TEST_F(test_ssock_prefetch_filter_init, dispose_while_blocked)
+{
+    int sv[2];
+    ssock peer, inner, sock;
+    uint8_t byte = 0;
+    size_t size;
+
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sv));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&peer, sv[0]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_init_from_posix(&inner, sv[1]));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_prefetch_filter_init(&sock, &inner, &alloc_opts, 2, 64));
+
+    /* let the I/O thread block on the inner read. */
+    this_thread::sleep_for(chrono::milliseconds(20));
+    dispose((disposable_t*)&sock);
+
+    size = sizeof(byte);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read(&peer, &byte, &size));
+    EXPECT_EQ(0U, size);
+
+    dispose((disposable_t*)&peer);
+}
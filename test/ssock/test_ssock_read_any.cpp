@@ -0,0 +1,215 @@
+/**
+ * \file test/ssock/test_ssock_read_any.cpp
+ *
+ * Unit tests for ssock_read_any.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that ssock_read_any does runtime parameter checks.
+ */
+TEST(test_ssock_read_any, parameter_checks)
+{
+    ssock sock;
+    allocator_options_t alloc_opts;
+
+    /* create malloc allocator. */
+    malloc_allocator_options_init(&alloc_opts);
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    ssock_value val;
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_any(nullptr, &alloc_opts, &val));
+
+    /* call with invalid alloc_opts. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_any(&sock, nullptr, &val));
+
+    /* call with invalid value pointer. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_any(&sock, &alloc_opts, nullptr));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that ssock_read_any decodes a stream of mixed packet types.
+ */
+TEST(test_ssock_read_any, mixed_stream)
+{
+    ssock sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    allocator_options_t alloc_opts;
+
+    /* create malloc allocator. */
+    malloc_allocator_options_init(&alloc_opts);
+
+    /* build a dummy socket that writes to and reads from a byte stream. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void* b, size_t* sz) -> int {
+                if (*sz > stream.size() - offset)
+                    return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+
+                memcpy(b, &stream[offset], *sz);
+                offset += *sz;
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void* b, size_t* sz) -> int {
+                const uint8_t* in = (const uint8_t*)b;
+                copy(in, in + *sz, back_inserter(stream));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    const char* EXPECTED_STRING = "mixed";
+    const uint8_t EXPECTED_DATA[] = { 0x01, 0x02, 0x03 };
+
+    /* write one packet of each type. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint8(&sock, 7));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_int8(&sock, -7));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&sock, 70000));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_int32(&sock, -70000));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_uint64(&sock, 7000000000ULL));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_int64(&sock, -7000000000LL));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_string(&sock, EXPECTED_STRING));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, EXPECTED_DATA, sizeof(EXPECTED_DATA)));
+
+    ssock_value val;
+
+    /* uint8. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_UINT8, val.type);
+    EXPECT_EQ(7U, val.val.uint8_val);
+
+    /* int8. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_INT8, val.type);
+    EXPECT_EQ(-7, val.val.int8_val);
+
+    /* uint32. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_UINT32, val.type);
+    EXPECT_EQ(70000U, val.val.uint32_val);
+
+    /* int32. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_INT32, val.type);
+    EXPECT_EQ(-70000, val.val.int32_val);
+
+    /* uint64. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_UINT64, val.type);
+    EXPECT_EQ(7000000000ULL, val.val.uint64_val);
+
+    /* int64. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_INT64, val.type);
+    EXPECT_EQ(-7000000000LL, val.val.int64_val);
+
+    /* string. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_STRING, val.type);
+    EXPECT_EQ(strlen(EXPECTED_STRING), val.size);
+    ASSERT_NE(nullptr, val.val.string_val);
+    EXPECT_STREQ(EXPECTED_STRING, val.val.string_val);
+    release(&alloc_opts, val.val.string_val);
+
+    /* data. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &val));
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, val.type);
+    ASSERT_EQ(sizeof(EXPECTED_DATA), val.size);
+    ASSERT_NE(nullptr, val.val.data_val);
+    EXPECT_EQ(0, memcmp(EXPECTED_DATA, val.val.data_val, val.size));
+    release(&alloc_opts, val.val.data_val);
+
+    /* the whole stream was consumed. */
+    EXPECT_EQ(stream.size(), offset);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that ssock_read_any rejects packet types it can't decode.
+ */
+TEST(test_ssock_read_any, unexpected_type)
+{
+    ssock sock;
+    uint8_t type = SSOCK_DATA_TYPE_AUTHED_PACKET;
+    allocator_options_t alloc_opts;
+
+    /* create malloc allocator. */
+    malloc_allocator_options_init(&alloc_opts);
+
+    /* build a dummy socket that only returns the type byte. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void* b, size_t* sz) -> int {
+                if (*sz != sizeof(type))
+                    return VCBLOCKCHAIN_ERROR_SSOCK_READ;
+
+                memcpy(b, &type, sizeof(type));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    ssock_value val;
+
+    /* authed packets can't be decoded without a secret. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        ssock_read_any(&sock, &alloc_opts, &val));
+
+    /* unknown packet types are rejected. */
+    type = 0x77;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        ssock_read_any(&sock, &alloc_opts, &val));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
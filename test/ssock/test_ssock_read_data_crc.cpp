@@ -0,0 +1,141 @@
+/**
+ * \file test/ssock/test_ssock_read_data_crc.cpp
+ *
+ * Unit tests for ssock_write_data_crc and ssock_read_data_crc.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+class test_ssock_read_data_crc : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        memset(&stats, 0, sizeof(stats));
+        offset = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            dummy_stream_ssock_init(&inner, stream, offset));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_stats_filter_init(&sock, &inner, &stats));
+
+        for (int i = 0; i < 1000; ++i)
+            payload.push_back((uint8_t)(i * 13));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&sock);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+    ssock inner, sock;
+    ssock_stats stats;
+    vector<uint8_t> stream, payload;
+    size_t offset;
+};
+
+/**
+ * Test that ssock_write_data_crc and ssock_read_data_crc do runtime parameter
+ * checks.
+ */
+TEST_F(test_ssock_read_data_crc, parameter_checks)
+{
+    void* val = nullptr;
+    uint32_t size = 0;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_data_crc(nullptr, payload.data(), payload.size()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_data_crc(&sock, nullptr, payload.size()));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_crc(nullptr, &alloc_opts, &val, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_crc(&sock, nullptr, &val, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_crc(&sock, &alloc_opts, nullptr, &size));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_crc(&sock, &alloc_opts, &val, nullptr));
+}
+
+/**
+ * Test that a checksummed packet is written in one call and read back.
+ */
+TEST_F(test_ssock_read_data_crc, round_trip)
+{
+    void* val = nullptr;
+    uint32_t size = 0;
+    ssock_value any;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_crc(&sock, payload.data(), payload.size()));
+    EXPECT_EQ(1U, stats.write_calls);
+    EXPECT_EQ(SSOCK_PACKET_HEADER_SIZE + payload.size() + SSOCK_CRC_SIZE,
+        stream.size());
+    EXPECT_EQ(SSOCK_DATA_TYPE_CRC_DATA_PACKET, stream[0]);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data_crc(&sock, &alloc_opts, &val, &size));
+    ASSERT_EQ(payload.size(), size);
+    EXPECT_EQ(0, memcmp(payload.data(), val, size));
+    EXPECT_EQ(stream.size(), offset);
+    release(&alloc_opts, val);
+
+    /* read_any verifies the packet and reports it as a data packet. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_crc(&sock, payload.data(), payload.size()));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_any(&sock, &alloc_opts, &any));
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_PACKET, any.type);
+    ASSERT_EQ(payload.size(), any.size);
+    EXPECT_EQ(0, memcmp(payload.data(), any.val.data_val, any.size));
+    release(&alloc_opts, any.val.data_val);
+}
+
+/**
+ * Test that a plain data packet is rejected by ssock_read_data_crc.
+ */
+TEST_F(test_ssock_read_data_crc, unexpected_type)
+{
+    void* val = nullptr;
+    uint32_t size = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, payload.data(), payload.size()));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        ssock_read_data_crc(&sock, &alloc_opts, &val, &size));
+}
+
+/**
+ * Test that corruption anywhere in the payload or checksum is detected.
+ */
+TEST_F(test_ssock_read_data_crc, corrupted)
+{
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_crc(&sock, payload.data(), payload.size()));
+    vector<uint8_t> packet = stream;
+
+    for (size_t i = SSOCK_PACKET_HEADER_SIZE; i < packet.size(); i += 7)
+    {
+        void* val = nullptr;
+        uint32_t size = 0;
+
+        stream = packet;
+        stream[i] ^= 0x01;
+        offset = 0;
+
+        EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_CHECKSUM,
+            ssock_read_data_crc(&sock, &alloc_opts, &val, &size));
+        EXPECT_EQ(nullptr, val);
+    }
+}
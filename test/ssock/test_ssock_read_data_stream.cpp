@@ -0,0 +1,228 @@
+/**
+ * \file test/ssock/test_ssock_read_data_stream.cpp
+ *
+ * Unit tests for ssock_read_data_stream.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * \brief Chunk callback that appends each chunk to a vector.
+ */
+static int append_chunk(void* context, const void* chunk, size_t size)
+{
+    auto out = (vector<uint8_t>*)context;
+    const uint8_t* in = (const uint8_t*)chunk;
+
+    copy(in, in + size, back_inserter(*out));
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Chunk callback that aborts the read.
+ */
+static int abort_chunk(void*, const void*, size_t)
+{
+    return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;
+}
+
+/**
+ * \brief Build a dummy socket over a byte stream which returns at most
+ * max_read bytes per read.
+ */
+static int stream_ssock_init(
+    ssock* sock, vector<uint8_t>& stream, size_t& offset, size_t max_read)
+{
+    return
+        dummy_ssock_init(
+            sock,
+            [&stream, &offset, max_read](ssock*, void* b, size_t* sz) -> int {
+                size_t avail = stream.size() - offset;
+                size_t n = min(min(*sz, avail), max_read);
+
+                memcpy(b, stream.data() + offset, n);
+                offset += n;
+                *sz = n;
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&stream](ssock*, const void* b, size_t* sz) -> int {
+                const uint8_t* in = (const uint8_t*)b;
+                copy(in, in + *sz, back_inserter(stream));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            });
+}
+
+/**
+ * Test that ssock_read_data_stream does runtime parameter checks.
+ */
+TEST(test_ssock_read_data_stream, parameter_checks)
+{
+    ssock sock;
+    vector<uint8_t> stream, out;
+    size_t offset = 0;
+    uint8_t buf[16];
+    uint64_t size;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 1024));
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_stream(
+            nullptr, buf, sizeof(buf), &append_chunk, &out, &size));
+
+    /* call with invalid buffer. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_stream(
+            &sock, nullptr, sizeof(buf), &append_chunk, &out, &size));
+
+    /* call with an empty buffer. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_stream(&sock, buf, 0, &append_chunk, &out, &size));
+
+    /* call with invalid callback. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_stream(
+            &sock, buf, sizeof(buf), nullptr, &out, &size));
+
+    /* call with invalid size pointer. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_data_stream(
+            &sock, buf, sizeof(buf), &append_chunk, &out, nullptr));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that a data packet is delivered in chunks bounded by the buffer size.
+ */
+TEST(test_ssock_read_data_stream, data_packet)
+{
+    ssock sock;
+    vector<uint8_t> stream, out, expected;
+    size_t offset = 0;
+    uint8_t buf[16];
+    uint64_t size = 0;
+
+    /* short reads of at most 7 bytes. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 7));
+
+    for (int i = 0; i < 100; ++i)
+        expected.push_back((uint8_t)i);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+
+    /* reading the packet as a stream should succeed. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data_stream(
+            &sock, buf, sizeof(buf), &append_chunk, &out, &size));
+
+    /* the payload should match. */
+    EXPECT_EQ(expected.size(), size);
+    EXPECT_EQ(expected, out);
+    EXPECT_EQ(stream.size(), offset);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that a data stream packet is delivered across all chunks.
+ */
+TEST(test_ssock_read_data_stream, data_stream_packet)
+{
+    ssock sock;
+    vector<uint8_t> stream, out, expected;
+    size_t offset = 0;
+    uint8_t buf[4];
+    uint64_t size = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 1024));
+
+    for (int i = 0; i < 30; ++i)
+        expected.push_back((uint8_t)(i * 3));
+
+    /* write the payload in three uneven chunks. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_begin(&sock));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_chunk(&sock, expected.data(), 11));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_chunk(&sock, expected.data() + 11, 1));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_chunk(&sock, expected.data() + 12, 18));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_end(&sock));
+
+    /* write a trailing packet, which must not be consumed. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint8(&sock, 9));
+
+    /* reading the stream should succeed. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data_stream(
+            &sock, buf, sizeof(buf), &append_chunk, &out, &size));
+
+    /* the payload should match. */
+    EXPECT_EQ(expected.size(), size);
+    EXPECT_EQ(expected, out);
+
+    /* the trailing packet should still be readable. */
+    uint8_t val = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint8(&sock, &val));
+    EXPECT_EQ(9, val);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that the callback can abort the read, and that a truncated stream fails.
+ */
+TEST(test_ssock_read_data_stream, abort_and_truncate)
+{
+    ssock sock;
+    vector<uint8_t> stream, out;
+    size_t offset = 0;
+    uint8_t buf[8];
+    uint64_t size = 0;
+    const uint8_t payload[] = { 1, 2, 3 };
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 1024));
+
+    /* the callback's status is returned. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, payload, sizeof(payload)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY,
+        ssock_read_data_stream(
+            &sock, buf, sizeof(buf), &abort_chunk, nullptr, &size));
+
+    /* a stream without a terminator fails when the bytes run out. */
+    stream.clear();
+    offset = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_begin(&sock));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_chunk(&sock, payload, sizeof(payload)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ,
+        ssock_read_data_stream(
+            &sock, buf, sizeof(buf), &append_chunk, &out, &size));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
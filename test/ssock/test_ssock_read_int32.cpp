@@ -0,0 +1,168 @@
+/**
+ * \file test/ssock/test_ssock_read_int32.cpp
+ *
+ * Unit tests for ssock_read_int32.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <list>
+#include <memory>
+#include <vcblockchain/byteswap.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that ssock_read_int32 does runtime parameter checks.
+ */
+TEST(test_ssock_read_int32, parameter_checks)
+{
+    ssock sock;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    int32_t val = 0;
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_int32(nullptr, &val));
+
+    /* call with invalid value pointer. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_read_int32(&sock, nullptr));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that ssock_read_int32 reads a value packet as expected.
+ */
+TEST(test_ssock_read_int32, happy_path)
+{
+    ssock sock;
+    list<shared_ptr<vector<uint8_t>>> io_buf;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void* b, size_t* sz) -> int {
+                shared_ptr<vector<uint8_t>> buf = io_buf.front();
+                io_buf.pop_front();
+
+                if (*sz != buf->size())
+                    return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+
+                copy(buf->begin(), buf->end(), (uint8_t*)b);
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    int32_t EXPECTED_VAL = -2;
+
+    /* create a buffer for the type. */
+    auto b1 = make_shared<vector<uint8_t>>();
+    b1->push_back(SSOCK_DATA_TYPE_INT32);
+    io_buf.push_back(b1);
+
+    /* create a buffer for the size. */
+    auto b2 = make_shared<vector<uint8_t>>();
+    b2->push_back(0);
+    b2->push_back(0);
+    b2->push_back(0);
+    b2->push_back(4);
+    io_buf.push_back(b2);
+
+    /* create a buffer for the value. */
+    auto b3 = make_shared<vector<uint8_t>>();
+    b3->push_back(0xFF);
+    b3->push_back(0xFF);
+    b3->push_back(0xFF);
+    b3->push_back(0xFE);
+    io_buf.push_back(b3);
+
+    int32_t val = 0;
+
+    /* reading a value packet should succeed. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_int32(&sock, &val));
+
+    /* the int32_t value should be equal to our expected value. */
+    EXPECT_EQ(EXPECTED_VAL, val);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that ssock_read_int32 rejects an unexpected type or size.
+ */
+TEST(test_ssock_read_int32, bad_type_and_size)
+{
+    ssock sock;
+    list<shared_ptr<vector<uint8_t>>> io_buf;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void* b, size_t* sz) -> int {
+                shared_ptr<vector<uint8_t>> buf = io_buf.front();
+                io_buf.pop_front();
+
+                if (*sz != buf->size())
+                    return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+
+                copy(buf->begin(), buf->end(), (uint8_t*)b);
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    /* a packet with the wrong type; nothing past the type is read. */
+    auto b1 = make_shared<vector<uint8_t>>(1, SSOCK_DATA_TYPE_UINT32);
+    io_buf.push_back(b1);
+
+    /* a packet with the wrong size; nothing past the size is read. */
+    auto b2 = make_shared<vector<uint8_t>>(1, SSOCK_DATA_TYPE_INT32);
+    io_buf.push_back(b2);
+    auto b3 = make_shared<vector<uint8_t>>(4, 0);
+    (*b3)[3] = 8;
+    io_buf.push_back(b3);
+
+    int32_t val = 0;
+
+    /* the wrong type should be rejected. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE,
+        ssock_read_int32(&sock, &val));
+
+    /* the wrong size should be rejected. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        ssock_read_int32(&sock, &val));
+
+    /* every buffer was read, and no more. */
+    EXPECT_TRUE(io_buf.empty());
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
@@ -0,0 +1,257 @@
+/**
+ * \file test/ssock/test_ssock_set_read_policy.cpp
+ *
+ * Unit tests for ssock_set_read_policy.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * \brief Build a dummy socket over a byte stream which returns at most
+ * max_read bytes per read, and counts the number of reads.
+ */
+static int stream_ssock_init(
+    ssock* sock, vector<uint8_t>& stream, size_t& offset, size_t max_read,
+    int& reads)
+{
+    return
+        dummy_ssock_init(
+            sock,
+            [&stream, &offset, &reads, max_read](
+                ssock*, void* b, size_t* sz) -> int {
+                size_t avail = stream.size() - offset;
+                size_t n = min(min(*sz, avail), max_read);
+
+                memcpy(b, stream.data() + offset, n);
+                offset += n;
+                *sz = n;
+                ++reads;
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&stream](ssock*, const void* b, size_t* sz) -> int {
+                const uint8_t* in = (const uint8_t*)b;
+                copy(in, in + *sz, back_inserter(stream));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            });
+}
+
+/**
+ * Test that ssock_set_read_policy does runtime parameter checks.
+ */
+TEST(test_ssock_set_read_policy, parameter_checks)
+{
+    ssock sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    int reads = 0;
+    ssock_read_policy policy;
+
+    memset(&policy, 0, sizeof(policy));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 1024, reads));
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_set_read_policy(nullptr, &policy));
+
+    /* call with invalid policy. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_set_read_policy(&sock, nullptr));
+
+    /* call with an invalid allocation mode. */
+    policy.alloc_mode = 0x7F;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_set_read_policy(&sock, &policy));
+
+    /* a valid policy is accepted. */
+    policy.alloc_mode = SSOCK_READ_ALLOC_GROW;
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&sock, &policy));
+    EXPECT_EQ(SSOCK_READ_ALLOC_GROW, sock.read_policy.alloc_mode);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that an oversized data packet is rejected before the payload is read.
+ */
+TEST(test_ssock_set_read_policy, max_data_size)
+{
+    ssock sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    int reads = 0;
+    ssock_read_policy policy;
+    void* val = nullptr;
+    uint32_t size = 0;
+    uint8_t payload[32];
+
+    malloc_allocator_options_init(&alloc_opts);
+    memset(payload, 0x5A, sizeof(payload));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 1024, reads));
+
+    memset(&policy, 0, sizeof(policy));
+    policy.max_data_size = 16;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&sock, &policy));
+
+    /* a packet at the limit is accepted. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, payload, 16));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data(&sock, &alloc_opts, &val, &size));
+    EXPECT_EQ(16U, size);
+    EXPECT_EQ(0, memcmp(payload, val, size));
+    release(&alloc_opts, val);
+
+    /* a packet over the limit is rejected without reading the payload. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, payload, sizeof(payload)));
+    size_t before = offset;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        ssock_read_data(&sock, &alloc_opts, &val, &size));
+    EXPECT_EQ(before + SSOCK_PACKET_HEADER_SIZE, offset);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that the string limit is taken from the read policy.
+ */
+TEST(test_ssock_set_read_policy, max_string_size)
+{
+    ssock sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    int reads = 0;
+    ssock_read_policy policy;
+    char* val = nullptr;
+
+    malloc_allocator_options_init(&alloc_opts);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 1024, reads));
+
+    memset(&policy, 0, sizeof(policy));
+    policy.max_string_size = 5;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&sock, &policy));
+
+    /* a string at the limit is accepted. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_string(&sock, "hello"));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_string(&sock, &alloc_opts, &val));
+    EXPECT_STREQ("hello", val);
+    release(&alloc_opts, val);
+
+    /* a string over the limit is rejected. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_string(&sock, "hello!"));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE,
+        ssock_read_string(&sock, &alloc_opts, &val));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that grow mode reads a large payload across many short reads.
+ */
+TEST(test_ssock_set_read_policy, grow_mode)
+{
+    ssock sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream, expected;
+    size_t offset = 0;
+    int reads = 0;
+    ssock_read_policy policy;
+    void* val = nullptr;
+    uint32_t size = 0;
+
+    malloc_allocator_options_init(&alloc_opts);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 4096, reads));
+
+    memset(&policy, 0, sizeof(policy));
+    policy.alloc_mode = SSOCK_READ_ALLOC_GROW;
+    policy.grow_initial_size = 1000;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&sock, &policy));
+
+    for (int i = 0; i < 200000; ++i)
+        expected.push_back((uint8_t)(i * 7));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data(&sock, expected.data(), expected.size()));
+
+    /* the payload is read in full. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_read_data(&sock, &alloc_opts, &val, &size));
+    ASSERT_EQ(expected.size(), size);
+    EXPECT_EQ(0, memcmp(expected.data(), val, size));
+    EXPECT_EQ(stream.size(), offset);
+
+    release(&alloc_opts, val);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that a claimed payload which is never sent fails in grow mode.
+ */
+TEST(test_ssock_set_read_policy, grow_mode_truncated)
+{
+    ssock sock;
+    allocator_options_t alloc_opts;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    int reads = 0;
+    ssock_read_policy policy;
+    void* val = nullptr;
+    uint32_t size = 0;
+
+    malloc_allocator_options_init(&alloc_opts);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        stream_ssock_init(&sock, stream, offset, 4096, reads));
+
+    memset(&policy, 0, sizeof(policy));
+    policy.alloc_mode = SSOCK_READ_ALLOC_GROW;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_set_read_policy(&sock, &policy));
+
+    /* claim a 1 GB payload, but only send a few bytes of it. */
+    uint8_t header[] = { SSOCK_DATA_TYPE_DATA_PACKET, 0x40, 0x00, 0x00, 0x00,
+                         0x01, 0x02, 0x03 };
+    stream.insert(stream.end(), header, header + sizeof(header));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_READ,
+        ssock_read_data(&sock, &alloc_opts, &val, &size));
+    EXPECT_EQ(nullptr, val);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
@@ -0,0 +1,79 @@
+/**
+ * \file test/ssock/test_ssock_stats_filter_init.cpp
+ *
+ * Unit tests for ssock_stats_filter_init.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that ssock_stats_filter_init does runtime parameter checks.
+ */
+TEST(test_ssock_stats_filter_init, parameter_checks)
+{
+    ssock inner, sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    ssock_stats stats;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_stats_filter_init(nullptr, &inner, &stats));
+
+    /* call with invalid inner socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_stats_filter_init(&sock, nullptr, &stats));
+
+    /* call with invalid stats. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_stats_filter_init(&sock, &inner, nullptr));
+
+    /* clean up */
+    dispose((disposable_t*)&inner);
+}
+
+/**
+ * Test that reads and writes are counted.
+ */
+TEST(test_ssock_stats_filter_init, counts)
+{
+    ssock inner, sock;
+    vector<uint8_t> stream;
+    size_t offset = 0;
+    ssock_stats stats;
+    uint32_t val = 0;
+
+    memset(&stats, 0, sizeof(stats));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_stream_ssock_init(&inner, stream, offset));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_stats_filter_init(&sock, &inner, &stats));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_uint32(&sock, 5));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_write_string(&sock, "abc"));
+
+    /* a uint32 packet is one write; a string packet is three. */
+    EXPECT_EQ(4U, stats.write_calls);
+    EXPECT_EQ(stream.size(), stats.bytes_written);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&sock, &val));
+    EXPECT_EQ(5U, val);
+
+    /* the type, size and value of a uint32 packet are read separately. */
+    EXPECT_EQ(3U, stats.read_calls);
+    EXPECT_EQ(9U, stats.bytes_read);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
@@ -0,0 +1,114 @@
+/**
+ * \file test/ssock/test_ssock_write_data_stream.cpp
+ *
+ * Unit tests for ssock_write_data_stream_begin, ssock_write_data_stream_chunk,
+ * and ssock_write_data_stream_end.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vcblockchain/byteswap.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that the data stream writers do runtime parameter checks.
+ */
+TEST(test_ssock_write_data_stream, parameter_checks)
+{
+    ssock sock;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    int val = 10;
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_data_stream_begin(nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_data_stream_chunk(nullptr, &val, sizeof(val)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_data_stream_end(nullptr));
+
+    /* call with invalid val pointer. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_data_stream_chunk(&sock, nullptr, sizeof(val)));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that a data stream is written as a type, sized chunks, and an empty
+ * terminating chunk.
+ */
+TEST(test_ssock_write_data_stream, happy_path)
+{
+    ssock sock;
+    vector<shared_ptr<ssock_write_params>> write_calls;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock* sock, const void* val, size_t* size) -> int {
+                write_calls.push_back(
+                    make_shared<ssock_write_params>(
+                        sock, val, *size));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    const uint8_t chunk[] = { 1, 2, 3, 4, 5 };
+
+    /* write a stream with one chunk and an empty chunk. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_begin(&sock));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_chunk(&sock, chunk, sizeof(chunk)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_chunk(&sock, chunk, 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_data_stream_end(&sock));
+
+    /* the empty chunk is skipped, so there are four writes. */
+    ASSERT_EQ(4U, write_calls.size());
+
+    /* the first buffer contains the data type. */
+    ASSERT_EQ(sizeof(uint8_t), write_calls[0]->buf.size());
+    EXPECT_EQ(SSOCK_DATA_TYPE_DATA_STREAM, write_calls[0]->buf[0]);
+
+    /* the second buffer contains the chunk size. */
+    ASSERT_EQ(sizeof(uint32_t), write_calls[1]->buf.size());
+    uint32_t net_size;
+    memcpy(&net_size, &write_calls[1]->buf[0], sizeof(net_size));
+    EXPECT_EQ(sizeof(chunk), (size_t)ntohl(net_size));
+
+    /* the third buffer contains the chunk. */
+    ASSERT_EQ(sizeof(chunk), write_calls[2]->buf.size());
+    EXPECT_EQ(0, memcmp(chunk, &write_calls[2]->buf[0], sizeof(chunk)));
+
+    /* the fourth buffer contains the terminating size. */
+    ASSERT_EQ(sizeof(uint32_t), write_calls[3]->buf.size());
+    memcpy(&net_size, &write_calls[3]->buf[0], sizeof(net_size));
+    EXPECT_EQ(0U, net_size);
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
@@ -0,0 +1,101 @@
+/**
+ * \file test/ssock/test_ssock_write_int32.cpp
+ *
+ * Unit tests for ssock_write_int32.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vcblockchain/byteswap.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+/**
+ * Test that ssock_write_int32 does runtime parameter checks.
+ */
+TEST(test_ssock_write_int32, parameter_checks)
+{
+    ssock sock;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock*, const void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    int32_t val = 1017;
+
+    /* call with invalid socket. */
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_int32(nullptr, val));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
+
+/**
+ * Test that ssock_write_int32 writes an int32 value packet as expected.
+ */
+TEST(test_ssock_write_int32, happy_path)
+{
+    ssock sock;
+    vector<shared_ptr<ssock_write_params>> write_calls;
+
+    /* build a simple dummy socket. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(
+            &sock,
+            [&](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            },
+            [&](ssock* sock, const void* val, size_t* size) -> int {
+                write_calls.push_back(
+                    make_shared<ssock_write_params>(
+                        sock, val, *size));
+
+                return VCBLOCKCHAIN_STATUS_SUCCESS;
+            }));
+
+    int32_t val = -12345678;
+
+    /* writing an int32 value packet should succeed. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_int32(&sock, val));
+
+    /* the internal write method should have been called once. */
+    ASSERT_EQ(1U, write_calls.size());
+
+    /* the socket is the first argument. */
+    EXPECT_EQ(&sock, write_calls[0]->sock);
+
+    /* the buffer contains the type, size, and value. */
+    ASSERT_EQ(SSOCK_PACKET_HEADER_SIZE + sizeof(val),
+        write_calls[0]->buf.size());
+
+    /* the first byte is the data type. */
+    EXPECT_EQ(SSOCK_DATA_TYPE_INT32, write_calls[0]->buf[0]);
+
+    /* the next four bytes are the size. */
+    uint32_t net_size;
+    memcpy(&net_size, &write_calls[0]->buf[1], sizeof(net_size));
+    EXPECT_EQ(sizeof(val), (size_t)ntohl(net_size));
+
+    /* the remaining bytes are the value, in network byte order. */
+    int32_t net_v2;
+    memcpy(&net_v2, &write_calls[0]->buf[SSOCK_PACKET_HEADER_SIZE],
+        sizeof(net_v2));
+    EXPECT_EQ(val, ntohl(net_v2));
+
+    /* clean up */
+    dispose((disposable_t*)&sock);
+}
@@ -78,7 +78,7 @@ TEST(test_ssock_write_int8, happy_path)
 
     /* the first buffer contains the data type. */
     ASSERT_EQ(sizeof(uint8_t), write_calls[0]->buf.size());
-    EXPECT_EQ(SSOCK_DATA_TYPE_UINT8, write_calls[0]->buf[0]);
+    EXPECT_EQ(SSOCK_DATA_TYPE_INT8, write_calls[0]->buf[0]);
 
     /* the second buffer contains the size. */
     ASSERT_EQ(sizeof(uint32_t), write_calls[1]->buf.size());
@@ -0,0 +1,500 @@
+/**
+ * \file test/ssock/test_ssock_write_queue.cpp
+ *
+ * Unit tests for the ssock write queue.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vcblockchain/ssock_write_queue.h>
+#include <vpr/allocator/malloc_allocator.h>
+
+#include "dummy_ssock.h"
+
+using namespace std;
+
+class test_ssock_write_queue : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+        memset(&stats, 0, sizeof(stats));
+        offset = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            dummy_stream_ssock_init(&inner, stream, offset));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_stats_filter_init(&sock, &inner, &stats));
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_queue_init(&queue, &alloc_opts, &sock));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&queue);
+        dispose((disposable_t*)&sock);
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+    ssock inner, sock;
+    ssock_stats stats;
+    ssock_write_queue queue;
+    vector<uint8_t> stream;
+    size_t offset;
+};
+
+/**
+ * Test that the write queue functions do runtime parameter checks.
+ */
+TEST_F(test_ssock_write_queue, parameter_checks)
+{
+    ssock_write_queue q;
+    uint8_t byte = 0;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_init(nullptr, &alloc_opts, &sock));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_init(&q, nullptr, &sock));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_init(&q, &alloc_opts, nullptr));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_enqueue(nullptr, &byte, 1));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_enqueue(&queue, nullptr, 1));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_enqueue(&queue, &byte, 0));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_enqueue_data(nullptr, &byte, 1));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_enqueue_data(&queue, nullptr, 1));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_flush(nullptr, nullptr));
+}
+
+/**
+ * Test that queued frames are written in order with gathered writes.
+ */
+TEST_F(test_ssock_write_queue, single_producer)
+{
+    const uint32_t count = 100;
+    size_t frames = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_queue_enqueue_data(&queue, &i, sizeof(i)));
+    }
+
+    /* nothing is written until the queue is flushed. */
+    EXPECT_EQ(0U, stream.size());
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_flush(&queue, &frames));
+    EXPECT_EQ(count, frames);
+
+    /* 100 frames take two batches. */
+    EXPECT_EQ(2U, stats.write_calls);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        void* val = nullptr;
+        uint32_t size = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_data(&sock, &alloc_opts, &val, &size));
+        ASSERT_EQ(sizeof(i), size);
+        EXPECT_EQ(0, memcmp(&i, val, size));
+        release(&alloc_opts, val);
+    }
+
+    /* an empty queue flushes nothing. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_flush(&queue, &frames));
+    EXPECT_EQ(0U, frames);
+}
+
+/**
+ * Test that a raw frame is written exactly as enqueued.
+ */
+TEST_F(test_ssock_write_queue, raw_frame)
+{
+    const uint8_t frame[] = {
+        SSOCK_DATA_TYPE_UINT32, 0x00, 0x00, 0x00, 0x04,
+        0x01, 0x02, 0x03, 0x04 };
+    uint32_t val = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_flush(&queue, nullptr));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, ssock_read_uint32(&sock, &val));
+    EXPECT_EQ(0x01020304U, val);
+}
+
+/**
+ * Test that frames from many producers are never interleaved, and that each
+ * producer's frames are written in order.
+ */
+TEST_F(test_ssock_write_queue, many_producers)
+{
+    const uint32_t producers = 8;
+    const uint32_t per_producer = 2000;
+    atomic<uint32_t> running(producers);
+    size_t total = 0;
+    vector<thread> threads;
+
+    for (uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p]() {
+            for (uint32_t seq = 0; seq < per_producer; ++seq)
+            {
+                /* vary the size so that frames straddle batch boundaries. */
+                uint32_t msg[16] = { p, seq };
+                uint32_t size = (2 + seq % 15) * sizeof(uint32_t);
+                EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    ssock_write_queue_enqueue_data(&queue, msg, size));
+            }
+
+            --running;
+        });
+    }
+
+    /* this thread is the single flusher. */
+    for (;;)
+    {
+        uint8_t done = (0 == running.load());
+        size_t frames = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_queue_flush(&queue, &frames));
+        total += frames;
+
+        if (done && 0 == frames)
+            break;
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    ASSERT_EQ((size_t)producers * per_producer, total);
+
+    /* gathering means fewer writes than frames. */
+    EXPECT_LT(stats.write_calls, total);
+
+    vector<uint32_t> next(producers, 0);
+    for (size_t i = 0; i < total; ++i)
+    {
+        void* val = nullptr;
+        uint32_t size = 0;
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_read_data(&sock, &alloc_opts, &val, &size));
+
+        uint32_t msg[16];
+        memcpy(msg, val, size);
+        release(&alloc_opts, val);
+
+        ASSERT_LT(msg[0], producers);
+        ASSERT_EQ(next[msg[0]], msg[1]);
+        ASSERT_EQ((2 + msg[1] % 15) * sizeof(uint32_t), size);
+        ++next[msg[0]];
+    }
+
+    EXPECT_EQ(stream.size(), offset);
+}
+
+/**
+ * Test that the flusher resumes after short writes.
+ */
+TEST(test_ssock_write_queue_writes, short_writes)
+{
+    allocator_options_t alloc_opts;
+    ssock sock;
+    ssock_write_queue queue;
+    vector<uint8_t> written;
+
+    malloc_allocator_options_init(&alloc_opts);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(&sock,
+            [](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_ERROR_SSOCK_READ; },
+            [&](ssock*, const void* buf, size_t* size) -> int {
+                /* accept at most three bytes at a time. */
+                *size = min(*size, (size_t)3);
+                const uint8_t* bbuf = (const uint8_t*)buf;
+                written.insert(written.end(), bbuf, bbuf + *size);
+                return VCBLOCKCHAIN_STATUS_SUCCESS; }));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_init(&queue, &alloc_opts, &sock));
+
+    const uint8_t a[] = { 1, 2, 3, 4, 5, 6, 7 };
+    const uint8_t b[] = { 8, 9 };
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, a, sizeof(a)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, b, sizeof(b)));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_flush(&queue, nullptr));
+
+    vector<uint8_t> expected = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(expected, written);
+
+    dispose((disposable_t*)&queue);
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that a failed write is reported, and that unsent frames are released
+ * when the queue is disposed.
+ */
+TEST(test_ssock_write_queue_writes, write_failure)
+{
+    allocator_options_t alloc_opts;
+    ssock sock;
+    ssock_write_queue queue;
+    const uint8_t frame[] = { 1, 2, 3 };
+    size_t frames = 1;
+
+    malloc_allocator_options_init(&alloc_opts);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        dummy_ssock_init(&sock,
+            [](ssock*, void*, size_t*) -> int {
+                return VCBLOCKCHAIN_ERROR_SSOCK_READ; },
+            [](ssock*, const void*, size_t* size) -> int {
+                *size = 0;
+                return VCBLOCKCHAIN_STATUS_SUCCESS; }));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_init(&queue, &alloc_opts, &sock));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_WRITE,
+        ssock_write_queue_flush(&queue, &frames));
+    EXPECT_EQ(0U, frames);
+
+    /* this frame is never written; dispose releases it. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+
+    dispose((disposable_t*)&queue);
+    dispose((disposable_t*)&sock);
+    dispose((disposable_t*)&alloc_opts);
+}
+
+/**
+ * Test that ssock_write_queue_set_flow_control does runtime parameter checks.
+ */
+TEST_F(test_ssock_write_queue, flow_control_parameter_checks)
+{
+    ssock_write_queue_flow_options flow;
+    memset(&flow, 0, sizeof(flow));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_set_flow_control(nullptr, &flow));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_set_flow_control(&queue, nullptr));
+
+    /* the low watermark can't be above the high watermark. */
+    flow.high_watermark = 10;
+    flow.low_watermark = 11;
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        ssock_write_queue_set_flow_control(&queue, &flow));
+}
+
+/**
+ * Test that the queue becomes unwritable at the high watermark, pushes back on
+ * producers, and becomes writable again at the low watermark.
+ */
+TEST_F(test_ssock_write_queue, watermarks)
+{
+    ssock_write_queue_flow_options flow;
+    vector<int> events;
+    const uint8_t frame[10] = { 0 };
+
+    memset(&flow, 0, sizeof(flow));
+    flow.high_watermark = 100;
+    flow.low_watermark = 20;
+    flow.on_event = [](ssock_write_queue*, int event, void* ctx) {
+        ((vector<int>*)ctx)->push_back(event); };
+    flow.context = &events;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_set_flow_control(&queue, &flow));
+
+    /* ten frames reach the high watermark. */
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    }
+
+    EXPECT_EQ(100U, queue.queued_bytes);
+    EXPECT_EQ(vector<int>({ SSOCK_WRITE_QUEUE_EVENT_UNWRITABLE }), events);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL,
+        ssock_write_queue_enqueue_data(&queue, frame, sizeof(frame)));
+
+    /* draining the queue makes it writable again. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_flush(&queue, nullptr));
+    EXPECT_EQ(0U, queue.queued_bytes);
+    EXPECT_EQ(100U, stream.size());
+    EXPECT_EQ(
+        vector<int>({
+            SSOCK_WRITE_QUEUE_EVENT_UNWRITABLE,
+            SSOCK_WRITE_QUEUE_EVENT_WRITABLE }),
+        events);
+
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+}
+
+/**
+ * Test that a producer blocks on an unwritable queue until the flusher drains
+ * it, or until the block timeout passes.
+ */
+TEST_F(test_ssock_write_queue, block_with_deadline)
+{
+    ssock_write_queue_flow_options flow;
+    const uint8_t frame[50] = { 0 };
+    atomic<int> status(-1);
+
+    memset(&flow, 0, sizeof(flow));
+    flow.high_watermark = 50;
+    flow.block_timeout_ms = 5000;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_set_flow_control(&queue, &flow));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+
+    thread producer([&]() {
+        status = ssock_write_queue_enqueue(&queue, frame, sizeof(frame));
+    });
+
+    /* the producer is parked until the flush. */
+    this_thread::sleep_for(chrono::milliseconds(20));
+    EXPECT_EQ(-1, status.load());
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_flush(&queue, nullptr));
+    producer.join();
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, status.load());
+
+    /* without a flush, the producer gives up at the deadline. */
+    queue.flow.block_timeout_ms = 10;
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(10));
+}
+
+/**
+ * Test that a peer which stays unwritable past the slow consumer timeout is
+ * shed, and its queued frames discarded.
+ */
+TEST_F(test_ssock_write_queue, slow_consumer)
+{
+    ssock_write_queue_flow_options flow;
+    vector<int> events;
+    const uint8_t frame[64] = { 0 };
+
+    memset(&flow, 0, sizeof(flow));
+    flow.high_watermark = 64;
+    flow.slow_consumer_ms = 10;
+    flow.on_event = [](ssock_write_queue*, int event, void* ctx) {
+        ((vector<int>*)ctx)->push_back(event); };
+    flow.context = &events;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_set_flow_control(&queue, &flow));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_WRITE_QUEUE_FULL,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+
+    this_thread::sleep_for(chrono::milliseconds(20));
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER,
+        ssock_write_queue_enqueue(&queue, frame, sizeof(frame)));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_SSOCK_SLOW_CONSUMER,
+        ssock_write_queue_flush(&queue, nullptr));
+
+    /* nothing was written, and the queue holds nothing. */
+    EXPECT_EQ(0U, stream.size());
+    EXPECT_EQ(0U, queue.queued_bytes);
+    EXPECT_EQ(
+        vector<int>({
+            SSOCK_WRITE_QUEUE_EVENT_UNWRITABLE,
+            SSOCK_WRITE_QUEUE_EVENT_SLOW_CONSUMER }),
+        events);
+}
+
+/**
+ * Test that bounded producers keep up with a fast flusher, and that the queue
+ * stays near its high watermark.
+ */
+TEST_F(test_ssock_write_queue, bounded_many_producers)
+{
+    ssock_write_queue_flow_options flow;
+    const uint32_t producers = 4;
+    const uint32_t per_producer = 5000;
+    const size_t frame_size = SSOCK_PACKET_HEADER_SIZE + 64;
+    atomic<uint32_t> running(producers);
+    size_t total = 0, peak = 0;
+    vector<thread> threads;
+
+    memset(&flow, 0, sizeof(flow));
+    flow.high_watermark = 4096;
+    flow.low_watermark = 1024;
+    flow.block_timeout_ms = 10000;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        ssock_write_queue_set_flow_control(&queue, &flow));
+
+    for (uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&]() {
+            uint8_t msg[64] = { 0 };
+            for (uint32_t seq = 0; seq < per_producer; ++seq)
+            {
+                EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                    ssock_write_queue_enqueue_data(&queue, msg, sizeof(msg)));
+            }
+
+            --running;
+        });
+    }
+
+    for (;;)
+    {
+        uint8_t done = (0 == running.load());
+        size_t frames = 0;
+
+        peak = max(peak,
+            __atomic_load_n(&queue.queued_bytes, __ATOMIC_ACQUIRE));
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            ssock_write_queue_flush(&queue, &frames));
+        total += frames;
+
+        if (done && 0 == frames)
+            break;
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT_EQ((size_t)producers * per_producer, total);
+    EXPECT_LE(peak, flow.high_watermark + producers * frame_size);
+}
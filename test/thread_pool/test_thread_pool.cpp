@@ -0,0 +1,274 @@
+/**
+ * \file test/thread_pool/test_thread_pool.cpp
+ *
+ * Unit tests for the work-stealing thread pool.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <vcblockchain/thread_pool.h>
+#include <vector>
+#include <vpr/allocator/malloc_allocator.h>
+
+using namespace std;
+
+namespace {
+
+/**
+ * \brief Shared state for the counting tasks.
+ */
+struct counter
+{
+    thread_pool* pool;
+    thread_pool_latch* latch;
+    size_t total;
+    size_t children;
+};
+
+void count_task(void* context)
+{
+    counter* c = (counter*)context;
+    __atomic_add_fetch(&c->total, 1, __ATOMIC_RELAXED);
+    thread_pool_latch_count_down(c->latch);
+}
+
+void spawning_task(void* context)
+{
+    counter* c = (counter*)context;
+
+    /* subtasks go to this worker's own deque. */
+    for (size_t i = 0; i < c->children; ++i)
+    {
+        if (VCBLOCKCHAIN_STATUS_SUCCESS != thread_pool_submit(c->pool, &count_task, c))
+        {
+            count_task(c);
+        }
+    }
+
+    thread_pool_latch_count_down(c->latch);
+}
+
+/**
+ * \brief The items of a scan: non-zero items fail.  Every item checked is
+ * counted.
+ */
+struct scan_items
+{
+    vector<uint8_t> failing;
+    size_t checked;
+};
+
+void scan_check(thread_pool_scan* scan, size_t begin, size_t end)
+{
+    scan_items* items = (scan_items*)scan->context;
+
+    for (size_t i = begin; i < end && !thread_pool_scan_skip(scan, i); ++i)
+    {
+        __atomic_add_fetch(&items->checked, 1, __ATOMIC_RELAXED);
+        if (items->failing[i])
+        {
+            thread_pool_scan_fail(scan, i);
+            break;
+        }
+    }
+}
+
+}
+
+class test_thread_pool : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        malloc_allocator_options_init(&alloc_opts);
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&alloc_opts);
+    }
+
+    allocator_options_t alloc_opts;
+};
+
+/**
+ * Test that the pool and latch functions check their parameters.
+ */
+TEST_F(test_thread_pool, parameter_checks)
+{
+    thread_pool pool;
+    thread_pool_latch latch;
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        thread_pool_init(nullptr, &alloc_opts, 1));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        thread_pool_init(&pool, nullptr, 1));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        thread_pool_latch_init(nullptr, 1));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_init(&pool, &alloc_opts, 2));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        thread_pool_submit(nullptr, &count_task, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        thread_pool_submit(&pool, nullptr, nullptr));
+    dispose((disposable_t*)&pool);
+
+    /* a latch at zero is already open. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, thread_pool_latch_init(&latch, 0));
+    thread_pool_wait(nullptr, &latch);
+    thread_pool_latch_dispose(&latch);
+}
+
+/**
+ * Test that a default pool runs every task submitted to it.
+ */
+TEST_F(test_thread_pool, runs_all_tasks)
+{
+    thread_pool pool;
+    thread_pool_latch latch;
+    const size_t TASKS = 10000;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_init(&pool, &alloc_opts, 0));
+    EXPECT_LT(0U, pool.worker_count);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_latch_init(&latch, TASKS));
+
+    counter c = { &pool, &latch, 0, 0 };
+    for (size_t i = 0; i < TASKS; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            thread_pool_submit(&pool, &count_task, &c));
+    }
+
+    thread_pool_wait(&pool, &latch);
+    EXPECT_EQ(TASKS, __atomic_load_n(&c.total, __ATOMIC_RELAXED));
+
+    thread_pool_latch_dispose(&latch);
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Test that tasks queued by other tasks are run, and stolen by idle workers.
+ */
+TEST_F(test_thread_pool, nested_tasks)
+{
+    thread_pool pool;
+    thread_pool_latch latch;
+    const size_t PARENTS = 16;
+    const size_t CHILDREN = 200;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_init(&pool, &alloc_opts, 4));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_latch_init(&latch, PARENTS * (CHILDREN + 1)));
+
+    counter c = { &pool, &latch, 0, CHILDREN };
+    for (size_t i = 0; i < PARENTS; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            thread_pool_submit(&pool, &spawning_task, &c));
+    }
+
+    thread_pool_wait(&pool, &latch);
+    EXPECT_EQ(PARENTS * CHILDREN, __atomic_load_n(&c.total, __ATOMIC_RELAXED));
+
+    thread_pool_latch_dispose(&latch);
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Test that disposing of a pool with queued tasks stops its workers.
+ */
+TEST_F(test_thread_pool, dispose_with_queued_tasks)
+{
+    thread_pool pool;
+    thread_pool_latch latch;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_init(&pool, &alloc_opts, 1));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_latch_init(&latch, 1000));
+
+    counter c = { &pool, &latch, 0, 0 };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            thread_pool_submit(&pool, &count_task, &c));
+    }
+
+    dispose((disposable_t*)&pool);
+    EXPECT_GE(1000U, __atomic_load_n(&c.total, __ATOMIC_RELAXED));
+
+    thread_pool_latch_dispose(&latch);
+}
+
+/**
+ * Test that a scan on the pool reports the lowest failing index.
+ */
+TEST_F(test_thread_pool, scan_lowest_failure)
+{
+    thread_pool pool;
+    thread_pool_scan scan;
+    scan_items items = { vector<uint8_t>(1000, 0), 0 };
+
+    items.failing[701] = 1;
+    items.failing[302] = 1;
+    items.failing[999] = 1;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_init(&pool, &alloc_opts, 4));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        thread_pool_scan_start(
+            &scan, &pool, &alloc_opts, 1000, 0, &scan_check, &items));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_scan_start(
+            &scan, &pool, &alloc_opts, 1000, 7, &scan_check, &items));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, thread_pool_scan_finish(&scan));
+    EXPECT_EQ(302U, scan.first_failure);
+
+    /* with no failures, every item is checked. */
+    items.failing.assign(1000, 0);
+    items.checked = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_scan_start(
+            &scan, &pool, &alloc_opts, 1000, 7, &scan_check, &items));
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, thread_pool_scan_finish(&scan));
+    EXPECT_EQ(SIZE_MAX, scan.first_failure);
+    EXPECT_EQ(1000U, items.checked);
+
+    dispose((disposable_t*)&pool);
+}
+
+/**
+ * Test that a scan without a pool runs when finished, and that a cancelled
+ * scan skips its items and reports the first status it was cancelled with.
+ */
+TEST_F(test_thread_pool, scan_inline_and_cancel)
+{
+    thread_pool_scan scan;
+    scan_items items = { vector<uint8_t>(100, 0), 0 };
+
+    items.failing[40] = 1;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_scan_start(
+            &scan, nullptr, &alloc_opts, 100, 7, &scan_check, &items));
+    EXPECT_EQ(0U, items.checked);
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, thread_pool_scan_finish(&scan));
+    EXPECT_EQ(40U, scan.first_failure);
+    EXPECT_EQ(41U, items.checked);
+
+    items.checked = 0;
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        thread_pool_scan_start(
+            &scan, nullptr, &alloc_opts, 100, 7, &scan_check, &items));
+    thread_pool_scan_cancel(&scan, VCBLOCKCHAIN_ERROR_BLOCK_INVALID);
+    thread_pool_scan_cancel(&scan, VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY);
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_BLOCK_INVALID,
+        thread_pool_scan_finish(&scan));
+    EXPECT_EQ(SIZE_MAX, scan.first_failure);
+    EXPECT_EQ(0U, items.checked);
+}
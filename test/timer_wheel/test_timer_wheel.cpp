@@ -0,0 +1,349 @@
+/**
+ * \file test/timer_wheel/test_timer_wheel.cpp
+ *
+ * Unit tests for the hierarchical timer wheel.
+ *
+ * \copyright 2020 Velo Payments, Inc.  All rights reserved.
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vcblockchain/timer_wheel.h>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+/**
+ * \brief A timer which records the wheel tick at which it fired.
+ */
+struct test_timer
+{
+    timer_wheel_timer timer;
+    uint64_t fired_at;
+    int fire_count;
+};
+
+void record_fire(timer_wheel* wheel, timer_wheel_timer*, void* context)
+{
+    test_timer* t = (test_timer*)context;
+    t->fired_at = wheel->current;
+    ++t->fire_count;
+}
+
+}
+
+class test_timer_wheel : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            timer_wheel_init(&wheel, 10, 1000));
+    }
+
+    void TearDown() override
+    {
+        dispose((disposable_t*)&wheel);
+    }
+
+    void init_timer(test_timer* t)
+    {
+        t->fired_at = 0;
+        t->fire_count = 0;
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            timer_wheel_timer_init(&t->timer, &record_fire, t));
+    }
+
+    timer_wheel wheel;
+};
+
+/**
+ * Test that the timer wheel functions do runtime parameter checks.
+ */
+TEST_F(test_timer_wheel, parameter_checks)
+{
+    timer_wheel w;
+    test_timer t;
+    uint64_t timeout;
+
+    init_timer(&t);
+
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, timer_wheel_init(nullptr, 10, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, timer_wheel_init(&w, 0, 0));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_timer_init(nullptr, &record_fire, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_timer_init(&t.timer, nullptr, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_schedule(nullptr, &t.timer, 10));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_schedule(&wheel, nullptr, 10));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG, timer_wheel_cancel(nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_advance(nullptr, 0, nullptr));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_next_timeout(nullptr, 0, &timeout));
+    EXPECT_EQ(VCBLOCKCHAIN_ERROR_INVALID_ARG,
+        timer_wheel_next_timeout(&wheel, 0, nullptr));
+}
+
+/**
+ * Test that a timer fires at its deadline, rounded up to the tick, and never
+ * early.
+ */
+TEST_F(test_timer_wheel, fires_at_deadline)
+{
+    test_timer t;
+    size_t fired = 0;
+
+    init_timer(&t);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &t.timer, 25));
+    EXPECT_EQ(1U, wheel.count);
+
+    /* 25ms rounds up to three ticks. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_advance(&wheel, 1029, &fired));
+    EXPECT_EQ(0U, fired);
+    EXPECT_EQ(0, t.fire_count);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_advance(&wheel, 1030, &fired));
+    EXPECT_EQ(1U, fired);
+    EXPECT_EQ(1, t.fire_count);
+    EXPECT_EQ(3U, t.fired_at);
+    EXPECT_EQ(0U, wheel.count);
+}
+
+/**
+ * Test that canceled and rescheduled timers fire only at their new deadline.
+ */
+TEST_F(test_timer_wheel, cancel_and_reschedule)
+{
+    test_timer a, b;
+
+    init_timer(&a);
+    init_timer(&b);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &a.timer, 50));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &b.timer, 50));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, timer_wheel_cancel(&a.timer));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, timer_wheel_cancel(&a.timer));
+    EXPECT_EQ(1U, wheel.count);
+
+    /* rescheduling a pending timer moves it. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_advance(&wheel, 1030, nullptr));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &b.timer, 50));
+    EXPECT_EQ(1U, wheel.count);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_advance(&wheel, 1070, nullptr));
+    EXPECT_EQ(0, b.fire_count);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_advance(&wheel, 1080, nullptr));
+    EXPECT_EQ(0, a.fire_count);
+    EXPECT_EQ(1, b.fire_count);
+    EXPECT_EQ(8U, b.fired_at);
+}
+
+/**
+ * Test that timers on every level, and beyond the top level, cascade down and
+ * fire on their exact tick.
+ */
+TEST_F(test_timer_wheel, cascades)
+{
+    const uint64_t ticks[] = {
+        1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300000,
+        16777215, 16777216, 20000000 };
+    const size_t count = sizeof(ticks) / sizeof(ticks[0]);
+    vector<test_timer> timers(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        init_timer(&timers[i]);
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            timer_wheel_schedule(&wheel, &timers[i].timer, ticks[i] * 10));
+    }
+
+    /* the wheel is advanced in uneven steps. */
+    for (uint64_t now = 1000; wheel.count > 0; now += 7777)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            timer_wheel_advance(&wheel, now, nullptr));
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(1, timers[i].fire_count);
+        EXPECT_EQ(ticks[i], timers[i].fired_at);
+    }
+}
+
+/**
+ * Test that a callback can reschedule its own timer, as a keepalive would.
+ */
+TEST_F(test_timer_wheel, periodic_timer)
+{
+    struct periodic
+    {
+        timer_wheel_timer timer;
+        vector<uint64_t> ticks;
+    } p;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_timer_init(&p.timer,
+            [](timer_wheel* w, timer_wheel_timer* t, void* ctx) {
+                periodic* pp = (periodic*)ctx;
+                pp->ticks.push_back(w->current);
+                if (pp->ticks.size() < 5)
+                    timer_wheel_schedule(w, t, 200);
+            },
+            &p));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &p.timer, 200));
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_advance(&wheel, 1000 + 10000, nullptr));
+
+    EXPECT_EQ(vector<uint64_t>({ 20, 40, 60, 80, 100 }), p.ticks);
+}
+
+/**
+ * Test that the next timeout never overshoots the next expiry.
+ */
+TEST_F(test_timer_wheel, next_timeout)
+{
+    test_timer near, far;
+    uint64_t timeout = 0;
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_next_timeout(&wheel, 1000, &timeout));
+    EXPECT_EQ(TIMER_WHEEL_NO_TIMEOUT, timeout);
+
+    /* a level 0 timer gives an exact timeout. */
+    init_timer(&near);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &near.timer, 100));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_next_timeout(&wheel, 1004, &timeout));
+    EXPECT_EQ(96U, timeout);
+
+    /* a higher level timer gives the time to the next cascade. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, timer_wheel_cancel(&near.timer));
+    init_timer(&far);
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &far.timer, 100000));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_next_timeout(&wheel, 1000, &timeout));
+    EXPECT_EQ(640U, timeout);
+
+    /* an overdue wheel asks to be advanced at once. */
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_next_timeout(&wheel, 5000, &timeout));
+    EXPECT_EQ(0U, timeout);
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, timer_wheel_cancel(&far.timer));
+}
+
+/**
+ * Test many random timers, cancels, and reschedules against their expected
+ * expiry ticks.
+ */
+TEST_F(test_timer_wheel, randomized)
+{
+    const size_t count = 5000;
+    vector<test_timer> timers(count);
+    vector<uint64_t> expected(count, 0);
+    mt19937_64 rng(42);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        init_timer(&timers[i]);
+    }
+
+    for (int round = 0; round < 20; ++round)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            switch (rng() % 4)
+            {
+                case 0:
+                case 1:
+                {
+                    uint64_t delay = rng() % 500000;
+                    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                        timer_wheel_schedule(&wheel, &timers[i].timer, delay));
+                    uint64_t ticks = delay / 10 + ((delay % 10 || !delay) ? 1 : 0);
+                    expected[i] = wheel.current + ticks;
+                    break;
+                }
+
+                case 2:
+                    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+                        timer_wheel_cancel(&timers[i].timer));
+                    expected[i] = 0;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            timer_wheel_advance(
+                &wheel, 1000 + (wheel.current + rng() % 20000) * 10, nullptr));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (timers[i].fire_count > 0)
+            {
+                ASSERT_EQ(1, timers[i].fire_count);
+                ASSERT_EQ(expected[i], timers[i].fired_at);
+                timers[i].fire_count = 0;
+                expected[i] = 0;
+            }
+            else if (0 != expected[i])
+            {
+                ASSERT_GT(expected[i], wheel.current);
+            }
+        }
+    }
+
+    /* the timers go away before the wheel does. */
+    for (size_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+            timer_wheel_cancel(&timers[i].timer));
+    }
+
+    EXPECT_EQ(0U, wheel.count);
+}
+
+/**
+ * Test that disposing a wheel cancels its timers without firing them.
+ */
+TEST(test_timer_wheel_dispose, cancels_pending)
+{
+    timer_wheel wheel;
+    test_timer t = {};
+
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, timer_wheel_init(&wheel, 1, 0));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_timer_init(&t.timer, &record_fire, &t));
+    ASSERT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS,
+        timer_wheel_schedule(&wheel, &t.timer, 5));
+
+    dispose((disposable_t*)&wheel);
+
+    EXPECT_EQ(nullptr, t.timer.wheel);
+    EXPECT_EQ(0, t.fire_count);
+
+    /* the timer can be canceled safely after the wheel is gone. */
+    EXPECT_EQ(VCBLOCKCHAIN_STATUS_SUCCESS, timer_wheel_cancel(&t.timer));
+}
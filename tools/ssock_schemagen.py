@@ -0,0 +1,663 @@
+#!/usr/bin/env python3
+"""
+Generate C encode / decode functions for ssock protocol messages.
+
+Usage: ssock_schemagen.py SCHEMA OUTDIR
+
+For a schema file NAME.ssock, this writes NAME.h and NAME.c to OUTDIR.
+
+The schema format is a list of messages, each a list of typed fields:
+
+    # comments run to the end of the line.
+    message block_request {
+        uint64 offset;
+        string artifact_id;
+        data   payload;
+    }
+
+Field types are uint8, int8, uint32, int32, uint64, int64, string, data, or
+the name of a message declared earlier in the same schema, which is encoded
+inline.  Each field is encoded exactly as the matching ssock_write_* function
+would encode it, so a message is wire compatible with hand-written code.  A
+whole message is sent as the payload of one data packet.
+
+For each message M, the generated code provides:
+
+    size_t M_encoded_size(const M* msg);
+    int M_encode(const M* msg, void* buf, size_t size);
+    int M_decode(M* msg, const void* buf, size_t size);
+    int M_write(ssock* sock, allocator_options_t* alloc_opts, const M* msg);
+    int M_read(
+        ssock* sock, allocator_options_t* alloc_opts, M* msg, void** frame);
+
+String and data fields are (pointer, size) views.  Decoded views point into
+the received frame, so decoding never allocates; the frame must outlive them.
+
+Copyright 2020 Velo Payments, Inc.  All rights reserved.
+"""
+
+import os
+import re
+import sys
+
+# type name -> (C type, ssock data type, encoded value size)
+SCALARS = {
+    'uint8': ('uint8_t', 'SSOCK_DATA_TYPE_UINT8', 1),
+    'int8': ('int8_t', 'SSOCK_DATA_TYPE_INT8', 1),
+    'uint32': ('uint32_t', 'SSOCK_DATA_TYPE_UINT32', 4),
+    'int32': ('int32_t', 'SSOCK_DATA_TYPE_INT32', 4),
+    'uint64': ('uint64_t', 'SSOCK_DATA_TYPE_UINT64', 8),
+    'int64': ('int64_t', 'SSOCK_DATA_TYPE_INT64', 8),
+}
+
+# type name -> (C pointer type, ssock data type)
+VIEWS = {
+    'string': ('const char*', 'SSOCK_DATA_TYPE_STRING'),
+    'data': ('const void*', 'SSOCK_DATA_TYPE_DATA_PACKET'),
+}
+
+# messages at or below this size are encoded on the stack.
+STACK_FRAME_SIZE = 512
+
+IDENT = re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+TOKEN = re.compile(r'[A-Za-z_][A-Za-z0-9_]*|[{};]|\S')
+
+
+class SchemaError(Exception):
+    pass
+
+
+def tokenize(text, path):
+    """Split a schema into (token, line) pairs, dropping comments."""
+    tokens = []
+    for lineno, line in enumerate(text.splitlines(), 1):
+        line = re.sub(r'(#|//).*$', '', line)
+        for tok in TOKEN.findall(line):
+            tokens.append((tok, lineno))
+    return tokens
+
+
+def parse(text, path):
+    """Parse a schema into an ordered list of (name, [(type, field)])."""
+    tokens = tokenize(text, path)
+    messages = []
+    names = set()
+    pos = 0
+
+    def error(msg, lineno):
+        raise SchemaError('%s:%d: error: %s' % (path, lineno, msg))
+
+    def expect(what):
+        nonlocal pos
+        if pos >= len(tokens):
+            last = tokens[-1][1] if tokens else 1
+            error('expected %s at end of file' % what, last)
+        tok, lineno = tokens[pos]
+        pos += 1
+        if what == 'identifier':
+            if not IDENT.match(tok):
+                error('expected identifier, found "%s"' % tok, lineno)
+        elif tok != what:
+            error('expected "%s", found "%s"' % (what, tok), lineno)
+        return tok, lineno
+
+    while pos < len(tokens):
+        expect('message')
+        name, lineno = expect('identifier')
+        if name in names or name in SCALARS or name in VIEWS:
+            error('duplicate message name "%s"' % name, lineno)
+        expect('{')
+
+        fields = []
+        field_names = set()
+        while pos < len(tokens) and tokens[pos][0] != '}':
+            ftype, lineno = expect('identifier')
+            if ftype not in SCALARS and ftype not in VIEWS \
+                    and ftype not in names:
+                error('unknown type "%s"' % ftype, lineno)
+            fname, lineno = expect('identifier')
+            if fname in field_names:
+                error('duplicate field name "%s"' % fname, lineno)
+            expect(';')
+            field_names.add(fname)
+            fields.append((ftype, fname))
+
+        _, lineno = expect('}')
+        if not fields:
+            error('message "%s" has no fields' % name, lineno)
+
+        names.add(name)
+        messages.append((name, fields))
+
+    return messages
+
+
+def emit_header(base, messages):
+    guard = 'VCBLOCKCHAIN_SCHEMA_%s_HEADER_GUARD' % base.upper()
+    out = []
+    w = out.append
+
+    w('/**')
+    w(' * \\file %s.h' % base)
+    w(' *')
+    w(' * \\brief Generated by ssock_schemagen.py from %s.ssock.  Do not edit.'
+      % base)
+    w(' */')
+    w('')
+    w('#ifndef %s' % guard)
+    w('#define %s' % guard)
+    w('')
+    w('#include <stddef.h>')
+    w('#include <stdint.h>')
+    w('#include <vcblockchain/ssock.h>')
+    w('#include <vpr/allocator.h>')
+    w('')
+    w('/* make this header C++ friendly. */')
+    w('#ifdef __cplusplus')
+    w('extern "C" {')
+    w('#endif /*__cplusplus*/')
+
+    for name, fields in messages:
+        w('')
+        w('/**')
+        w(' * \\brief The %s message.' % name)
+        w(' */')
+        w('typedef struct %s' % name)
+        w('{')
+        for ftype, fname in fields:
+            if ftype in SCALARS:
+                w('    %s %s;' % (SCALARS[ftype][0], fname))
+            elif ftype in VIEWS:
+                w('    %s %s;' % (VIEWS[ftype][0], fname))
+                w('    uint32_t %s_size;' % fname)
+            else:
+                w('    %s %s;' % (ftype, fname))
+        w('} %s;' % name)
+        w('')
+        w('/**')
+        w(' * \\brief Compute the exact encoded size of a %s message.' % name)
+        w(' */')
+        w('size_t %s_encoded_size(const %s* msg);' % (name, name))
+        w('')
+        w('/**')
+        w(' * \\brief Encode a %s message into a buffer of at least' % name)
+        w(' * %s_encoded_size() bytes.' % name)
+        w(' *')
+        w(' * \\returns a status code indicating success or failure.')
+        w(' *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.')
+        w(' *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if the buffer is too small.')
+        w(' */')
+        w('int %s_encode(const %s* msg, void* buf, size_t size);'
+          % (name, name))
+        w('')
+        w('/**')
+        w(' * \\brief Decode a %s message from a received frame.' % name)
+        w(' *')
+        w(' * String and data fields point into the frame.')
+        w(' *')
+        w(' * \\returns a status code indicating success or failure.')
+        w(' *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.')
+        w(' *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check')
+        w(' *        failed.')
+        w(' *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE if a')
+        w(' *        field has the wrong type.')
+        w(' *      - VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE if a')
+        w(' *        field has the wrong size, or the frame is truncated or has')
+        w(' *        trailing bytes.')
+        w(' */')
+        w('int %s_decode(%s* msg, const void* buf, size_t size);'
+          % (name, name))
+        w('')
+        w('/**')
+        w(' * \\brief Write a %s message as a single data packet.' % name)
+        w(' *')
+        w(' * \\returns a status code indicating success or failure.')
+        w(' *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.')
+        w(' *      - VCBLOCKCHAIN_ERROR_INVALID_ARG if a runtime argument check')
+        w(' *        failed.')
+        w(' *      - VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY if the frame could not be')
+        w(' *        allocated.')
+        w(' *      - the status of \\ref ssock_write_data on failure.')
+        w(' */')
+        w('int %s_write(' % name)
+        w('    ssock* sock, allocator_options_t* alloc_opts, const %s* msg);'
+          % name)
+        w('')
+        w('/**')
+        w(' * \\brief Read and decode a %s message.' % name)
+        w(' *')
+        w(' * On success, *frame holds the received frame, which the decoded')
+        w(' * message refers to.  The caller releases it with \\ref release()')
+        w(' * when done with the message.')
+        w(' *')
+        w(' * \\returns a status code indicating success or failure.')
+        w(' *      - VCBLOCKCHAIN_STATUS_SUCCESS on success.')
+        w(' *      - the status of \\ref ssock_read_data or %s_decode().' % name)
+        w(' */')
+        w('int %s_read(' % name)
+        w('    ssock* sock, allocator_options_t* alloc_opts, %s* msg,' % name)
+        w('    void** frame);')
+
+    w('')
+    w('/* make this header C++ friendly. */')
+    w('#ifdef __cplusplus')
+    w('}')
+    w('#endif /*__cplusplus*/')
+    w('')
+    w('#endif /*%s*/' % guard)
+
+    return '\n'.join(out) + '\n'
+
+
+RUNTIME = r'''
+/**
+ * \brief Write a value header.
+ */
+static inline uint8_t* schema_put_header(
+    uint8_t* out, uint8_t type, uint32_t size)
+{
+    out[0] = type;
+    out[1] = (uint8_t)(size >> 24);
+    out[2] = (uint8_t)(size >> 16);
+    out[3] = (uint8_t)(size >> 8);
+    out[4] = (uint8_t)size;
+
+    return out + SSOCK_PACKET_HEADER_SIZE;
+}
+
+/**
+ * \brief Write an integer value in network byte order.
+ */
+static inline uint8_t* schema_put_int(
+    uint8_t* out, uint8_t type, uint64_t val, uint32_t size)
+{
+    out = schema_put_header(out, type, size);
+
+    for (uint32_t i = size; i > 0; --i)
+    {
+        *out++ = (uint8_t)(val >> (8 * (i - 1)));
+    }
+
+    return out;
+}
+
+/**
+ * \brief Write a string or data value.
+ */
+static inline uint8_t* schema_put_bytes(
+    uint8_t* out, uint8_t type, const void* val, uint32_t size)
+{
+    out = schema_put_header(out, type, size);
+    if (size > 0)
+    {
+        memcpy(out, val, size);
+    }
+
+    return out + size;
+}
+
+/**
+ * \brief Read a value header, checking its type and that its value fits.
+ */
+static inline int schema_get_header(
+    const uint8_t** pos, const uint8_t* end, uint8_t type, uint32_t* size)
+{
+    const uint8_t* in = *pos;
+
+    if ((size_t)(end - in) < SSOCK_PACKET_HEADER_SIZE)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    if (type != in[0])
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_TYPE;
+    }
+
+    *size = ((uint32_t)in[1] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 8) | (uint32_t)in[4];
+    in += SSOCK_PACKET_HEADER_SIZE;
+
+    if (*size > (size_t)(end - in))
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    *pos = in;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read an integer value of the given size in network byte order.
+ */
+static inline int schema_get_int(
+    const uint8_t** pos, const uint8_t* end, uint8_t type, uint64_t* val,
+    uint32_t expected_size)
+{
+    uint32_t size = 0U;
+
+    int retval = schema_get_header(pos, end, type, &size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    if (expected_size != size)
+    {
+        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;
+    }
+
+    *val = 0U;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        *val = (*val << 8) | (*pos)[i];
+    }
+
+    *pos += size;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+
+/**
+ * \brief Read a string or data value as a view into the frame.
+ */
+static inline int schema_get_bytes(
+    const uint8_t** pos, const uint8_t* end, uint8_t type, const void** val,
+    uint32_t* size)
+{
+    int retval = schema_get_header(pos, end, type, size);
+    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)
+    {
+        return retval;
+    }
+
+    *val = *pos;
+    *pos += *size;
+
+    return VCBLOCKCHAIN_STATUS_SUCCESS;
+}
+'''
+
+
+def emit_source(base, messages):
+    out = []
+    w = out.append
+
+    w('/**')
+    w(' * \\file %s.c' % base)
+    w(' *')
+    w(' * \\brief Generated by ssock_schemagen.py from %s.ssock.  Do not edit.'
+      % base)
+    w(' */')
+    w('')
+    w('#include <string.h>')
+    w('#include <vcblockchain/error_codes.h>')
+    w('#include <vcblockchain/ssock.h>')
+    w('')
+    w('#include "%s.h"' % base)
+    w('')
+    w('/* messages at or below this size are encoded on the stack. */')
+    w('#define SCHEMA_STACK_FRAME_SIZE %d' % STACK_FRAME_SIZE)
+    w(RUNTIME.rstrip('\n'))
+
+    for name, fields in messages:
+        # encoded size.
+        w('')
+        w('/**')
+        w(' * \\brief Compute the exact encoded size of a %s message.' % name)
+        w(' */')
+        w('size_t %s_encoded_size(const %s* msg)' % (name, name))
+        w('{')
+        fixed = 0
+        dynamic = []
+        for ftype, fname in fields:
+            if ftype in SCALARS:
+                fixed += 5 + SCALARS[ftype][2]
+            elif ftype in VIEWS:
+                fixed += 5
+                dynamic.append('(size_t)msg->%s_size' % fname)
+            else:
+                dynamic.append('%s_encoded_size(&msg->%s)' % (ftype, fname))
+        expr = ' + '.join([str(fixed)] + dynamic)
+        if not dynamic:
+            w('    (void)msg;')
+            w('')
+        w('    return %s;' % expr)
+        w('}')
+
+        # field encoder.
+        w('')
+        w('/**')
+        w(' * \\brief Encode the fields of a %s message, returning the end of'
+          % name)
+        w(' * the encoded fields.')
+        w(' */')
+        w('static uint8_t* %s_encode_fields(const %s* msg, uint8_t* out)'
+          % (name, name))
+        w('{')
+        for ftype, fname in fields:
+            if ftype in SCALARS:
+                ctype, dtype, width = SCALARS[ftype]
+                uint = 'uint%d_t' % (width * 8)
+                w('    out = schema_put_int(out, %s, (%s)msg->%s, %d);'
+                  % (dtype, uint, fname, width))
+            elif ftype in VIEWS:
+                w('    out = schema_put_bytes(out, %s, msg->%s, msg->%s_size);'
+                  % (VIEWS[ftype][1], fname, fname))
+            else:
+                w('    out = %s_encode_fields(&msg->%s, out);' % (ftype, fname))
+        w('')
+        w('    return out;')
+        w('}')
+
+        # field decoder.
+        w('')
+        w('/**')
+        w(' * \\brief Decode the fields of a %s message in one pass.' % name)
+        w(' */')
+        w('static int %s_decode_fields(' % name)
+        w('    %s* msg, const uint8_t** pos, const uint8_t* end)' % name)
+        w('{')
+        w('    int retval;')
+        if any(f in SCALARS for f, _ in fields):
+            w('    uint64_t val = 0U;')
+        if any(f in VIEWS for f, _ in fields):
+            w('    const void* view = NULL;')
+        for ftype, fname in fields:
+            w('')
+            if ftype in SCALARS:
+                ctype, dtype, width = SCALARS[ftype]
+                w('    retval = schema_get_int(pos, end, %s, &val, %d);'
+                  % (dtype, width))
+                if ctype.startswith('uint'):
+                    assign = '    msg->%s = (%s)val;' % (fname, ctype)
+                else:
+                    assign = '    msg->%s = (%s)(uint%d_t)val;' % (
+                        fname, ctype, width * 8)
+            elif ftype in VIEWS:
+                w('    retval =')
+                w('        schema_get_bytes(')
+                w('            pos, end, %s, &view, &msg->%s_size);'
+                  % (VIEWS[ftype][1], fname))
+                assign = '    msg->%s = (%s)view;' % (fname, VIEWS[ftype][0])
+            else:
+                w('    retval = %s_decode_fields(&msg->%s, pos, end);'
+                  % (ftype, fname))
+                assign = None
+            w('    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)')
+            w('    {')
+            w('        return retval;')
+            w('    }')
+            if assign:
+                w(assign)
+        w('')
+        w('    return VCBLOCKCHAIN_STATUS_SUCCESS;')
+        w('}')
+
+        # public encode.
+        w('')
+        w('/**')
+        w(' * \\brief Encode a %s message into a buffer of at least' % name)
+        w(' * %s_encoded_size() bytes.' % name)
+        w(' */')
+        w('int %s_encode(const %s* msg, void* buf, size_t size)' % (name, name))
+        w('{')
+        w('    /* runtime parameter checks. */')
+        w('    if (NULL == msg || NULL == buf || size < %s_encoded_size(msg))'
+          % name)
+        w('    {')
+        w('        return VCBLOCKCHAIN_ERROR_INVALID_ARG;')
+        w('    }')
+        w('')
+        w('    %s_encode_fields(msg, (uint8_t*)buf);' % name)
+        w('')
+        w('    /* success. */')
+        w('    return VCBLOCKCHAIN_STATUS_SUCCESS;')
+        w('}')
+
+        # public decode.
+        w('')
+        w('/**')
+        w(' * \\brief Decode a %s message from a received frame.' % name)
+        w(' */')
+        w('int %s_decode(%s* msg, const void* buf, size_t size)' % (name, name))
+        w('{')
+        w('    /* runtime parameter checks. */')
+        w('    if (NULL == msg || (NULL == buf && size > 0))')
+        w('    {')
+        w('        return VCBLOCKCHAIN_ERROR_INVALID_ARG;')
+        w('    }')
+        w('')
+        w('    const uint8_t* pos = (const uint8_t*)buf;')
+        w('    const uint8_t* end = pos + size;')
+        w('')
+        w('    int retval = %s_decode_fields(msg, &pos, end);' % name)
+        w('    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)')
+        w('    {')
+        w('        return retval;')
+        w('    }')
+        w('')
+        w('    /* the frame must hold exactly one message. */')
+        w('    if (pos != end)')
+        w('    {')
+        w('        return VCBLOCKCHAIN_ERROR_SSOCK_READ_UNEXPECTED_DATA_SIZE;')
+        w('    }')
+        w('')
+        w('    /* success. */')
+        w('    return VCBLOCKCHAIN_STATUS_SUCCESS;')
+        w('}')
+
+        # public write.
+        w('')
+        w('/**')
+        w(' * \\brief Write a %s message as a single data packet.' % name)
+        w(' */')
+        w('int %s_write(' % name)
+        w('    ssock* sock, allocator_options_t* alloc_opts, const %s* msg)'
+          % name)
+        w('{')
+        w('    int retval;')
+        w('    uint8_t local[SCHEMA_STACK_FRAME_SIZE];')
+        w('    uint8_t* buf = local;')
+        w('')
+        w('    /* runtime parameter checks. */')
+        w('    if (NULL == sock || NULL == alloc_opts || NULL == msg)')
+        w('    {')
+        w('        return VCBLOCKCHAIN_ERROR_INVALID_ARG;')
+        w('    }')
+        w('')
+        w('    /* the whole message must fit in one data packet. */')
+        w('    size_t size = %s_encoded_size(msg);' % name)
+        w('    if (size > UINT32_MAX)')
+        w('    {')
+        w('        return VCBLOCKCHAIN_ERROR_INVALID_ARG;')
+        w('    }')
+        w('')
+        w('    /* only large messages need a heap frame. */')
+        w('    if (size > sizeof(local))')
+        w('    {')
+        w('        buf = (uint8_t*)allocate(alloc_opts, size);')
+        w('        if (NULL == buf)')
+        w('        {')
+        w('            return VCBLOCKCHAIN_ERROR_OUT_OF_MEMORY;')
+        w('        }')
+        w('    }')
+        w('')
+        w('    /* encode the message and send it in one write. */')
+        w('    %s_encode_fields(msg, buf);' % name)
+        w('    retval = ssock_write_data(sock, buf, (uint32_t)size);')
+        w('')
+        w('    if (buf != local)')
+        w('    {')
+        w('        release(alloc_opts, buf);')
+        w('    }')
+        w('')
+        w('    return retval;')
+        w('}')
+
+        # public read.
+        w('')
+        w('/**')
+        w(' * \\brief Read and decode a %s message.' % name)
+        w(' */')
+        w('int %s_read(' % name)
+        w('    ssock* sock, allocator_options_t* alloc_opts, %s* msg,' % name)
+        w('    void** frame)')
+        w('{')
+        w('    uint32_t size = 0U;')
+        w('')
+        w('    /* runtime parameter checks. */')
+        w('    if (NULL == sock || NULL == alloc_opts || NULL == msg || NULL == frame)')
+        w('    {')
+        w('        return VCBLOCKCHAIN_ERROR_INVALID_ARG;')
+        w('    }')
+        w('')
+        w('    int retval = ssock_read_data(sock, alloc_opts, frame, &size);')
+        w('    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)')
+        w('    {')
+        w('        return retval;')
+        w('    }')
+        w('')
+        w('    retval = %s_decode(msg, *frame, size);' % name)
+        w('    if (VCBLOCKCHAIN_STATUS_SUCCESS != retval)')
+        w('    {')
+        w('        release(alloc_opts, *frame);')
+        w('        *frame = NULL;')
+        w('    }')
+        w('')
+        w('    return retval;')
+        w('}')
+
+    return '\n'.join(out) + '\n'
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write('usage: %s SCHEMA OUTDIR\n' % argv[0])
+        return 2
+
+    path, outdir = argv[1], argv[2]
+    base = os.path.splitext(os.path.basename(path))[0]
+    if not IDENT.match(base):
+        sys.stderr.write('%s: schema name must be a C identifier\n' % path)
+        return 1
+
+    with open(path) as f:
+        text = f.read()
+
+    try:
+        messages = parse(text, path)
+    except SchemaError as e:
+        sys.stderr.write('%s\n' % e)
+        return 1
+
+    with open(os.path.join(outdir, base + '.h'), 'w') as f:
+        f.write(emit_header(base, messages))
+    with open(os.path.join(outdir, base + '.c'), 'w') as f:
+        f.write(emit_source(base, messages))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))